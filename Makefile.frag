@@ -12,6 +12,7 @@ else
         VALKEY_GLIDE_SHARED_LIBADD = valkey-glide/ffi/target/release/libglide_ffi.a -lresolv -lprotobuf-c
     endif
 endif
+VALKEY_GLIDE_SHARED_LIBADD += $(VALKEY_GLIDE_COMPRESSION_LIBS)
 INCLUDES += -Iinclude
 PROTOC = protoc
 PROTOC_C_PLUGIN := protoc-c
@@ -70,6 +71,26 @@ valkey_glide_cluster_arginfo.h: valkey_glide_cluster.stub.php
 	@echo "Generating arginfo from valkey_glide_cluster.stub.php"
 	$(PHP_EXECUTABLE) build/gen_stub.php --no-legacy-arginfo valkey_glide_cluster.stub.php
 
+valkey_glide_async_arginfo.h: valkey_glide_async.stub.php
+	@echo "Generating arginfo from valkey_glide_async.stub.php"
+	$(PHP_EXECUTABLE) build/gen_stub.php --no-legacy-arginfo valkey_glide_async.stub.php
+
+valkey_glide_script_arginfo.h: valkey_glide_script.stub.php
+	@echo "Generating arginfo from valkey_glide_script.stub.php"
+	$(PHP_EXECUTABLE) build/gen_stub.php --no-legacy-arginfo valkey_glide_script.stub.php
+
+valkey_glide_batch_template_arginfo.h: valkey_glide_batch_template.stub.php
+	@echo "Generating arginfo from valkey_glide_batch_template.stub.php"
+	$(PHP_EXECUTABLE) build/gen_stub.php --no-legacy-arginfo valkey_glide_batch_template.stub.php
+
+valkey_glide_result_arginfo.h: valkey_glide_result.stub.php
+	@echo "Generating arginfo from valkey_glide_result.stub.php"
+	$(PHP_EXECUTABLE) build/gen_stub.php --no-legacy-arginfo valkey_glide_result.stub.php
+
+valkey_glide_route_arginfo.h: valkey_glide_route.stub.php
+	@echo "Generating arginfo from valkey_glide_route.stub.php"
+	$(PHP_EXECUTABLE) build/gen_stub.php --no-legacy-arginfo valkey_glide_route.stub.php
+
 cluster_scan_cursor_arginfo.h: cluster_scan_cursor.stub.php
 	@echo "Generating arginfo from cluster_scan_cursor.stub.php"
 	$(PHP_EXECUTABLE) build/gen_stub.php --no-legacy-arginfo cluster_scan_cursor.stub.php
@@ -78,13 +99,17 @@ tests/client_constructor_mock_arginfo.h: tests/client_constructor_mock.stub.php
 	@echo "Generating arginfo from tests/client_constructor_mock_arginfo.stub.php"
 	$(PHP_EXECUTABLE) build/gen_stub.php --no-legacy-arginfo tests/client_constructor_mock.stub.php
 
-ARGINFO_HEADERS = valkey_glide_arginfo.h valkey_glide_cluster_arginfo.h cluster_scan_cursor_arginfo.h logger_arginfo.h tests/client_constructor_mock_arginfo.h
+tests/response_decoder_bench_arginfo.h: tests/response_decoder_bench.stub.php
+	@echo "Generating arginfo from tests/response_decoder_bench.stub.php"
+	$(PHP_EXECUTABLE) build/gen_stub.php --no-legacy-arginfo tests/response_decoder_bench.stub.php
+
+ARGINFO_HEADERS = valkey_glide_arginfo.h valkey_glide_cluster_arginfo.h valkey_glide_async_arginfo.h valkey_glide_batch_template_arginfo.h valkey_glide_script_arginfo.h valkey_glide_result_arginfo.h valkey_glide_route_arginfo.h cluster_scan_cursor_arginfo.h logger_arginfo.h tests/client_constructor_mock_arginfo.h tests/response_decoder_bench_arginfo.h
 
 all: $(ARGINFO_HEADERS)
 
 .PHONY: build-modules-pre
 
-build-modules-pre: valkey_glide_arginfo.h valkey_glide_cluster_arginfo.h cluster_scan_cursor_arginfo.h logger_arginfo.h tests/client_constructor_mock_arginfo.h
+build-modules-pre: valkey_glide_arginfo.h valkey_glide_cluster_arginfo.h valkey_glide_async_arginfo.h valkey_glide_batch_template_arginfo.h valkey_glide_script_arginfo.h valkey_glide_result_arginfo.h valkey_glide_route_arginfo.h cluster_scan_cursor_arginfo.h logger_arginfo.h tests/client_constructor_mock_arginfo.h tests/response_decoder_bench_arginfo.h
 	@$(MAKE) generate-proto
 	@$(MAKE) generate-bindings
 
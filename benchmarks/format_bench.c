@@ -0,0 +1,158 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Number Formatting Benchmark                             |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+/*
+ * Number formatting for command arguments, before and after valkey_glide_format.c, on the
+ * numbers of ZADD (scores), GEOADD (coordinates) and option arguments (counts, TTLs).
+ *
+ * "snprintf" is the previous code: snprintf() into a stack buffer, then a heap copy that is
+ * freed once the command was sent ("%.6g" for command_response.c, "%.17g" for the core
+ * commands). "format" writes into a bump buffer, the way the preparers now write into the
+ * argument arena. Also counts the values each formatter does not read back exactly.
+ *
+ *   cc -O2 -I. benchmarks/format_bench.c valkey_glide_format.c -lm -o format_bench
+ *   ./format_bench [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "valkey_glide_format.h"
+
+#define BATCH 1024
+
+typedef enum { WORKLOAD_ZADD, WORKLOAD_GEOADD, WORKLOAD_LONG } workload;
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void fill(workload kind, double* doubles, int64_t* longs) {
+    for (int i = 0; i < BATCH; i++) {
+        uint64_t r = next_random();
+
+        switch (kind) {
+            case WORKLOAD_ZADD:
+                /* Whole scores (ranks, timestamps) and scores with a few decimals */
+                doubles[i] = (r & 1) ? (double) (r % 10000000) : (double) (r % 1000000) / 100.0;
+                break;
+            case WORKLOAD_GEOADD:
+                /* Longitudes and latitudes with six decimals */
+                doubles[i] = (r & 1) ? (double) (int64_t) (r % 360000001) / 1e6 - 180.0
+                                     : (double) (int64_t) (r % 170000001) / 1e6 - 85.0;
+                break;
+            case WORKLOAD_LONG:
+                longs[i] = (int64_t) (r % 100000);
+                break;
+        }
+    }
+}
+
+static size_t copy_snprintf(workload kind, const char* format, double d, int64_t l) {
+    char   buffer[64];
+    size_t len = kind == WORKLOAD_LONG ? (size_t) snprintf(buffer, sizeof(buffer), "%ld", (long) l)
+                                       : (size_t) snprintf(buffer, sizeof(buffer), format, d);
+    char*  copy = malloc(len + 1);
+
+    memcpy(copy, buffer, len + 1);
+    free(copy);
+    return len;
+}
+
+static void run(const char* name, workload kind, long iterations) {
+    static char arena[BATCH * VALKEY_GLIDE_FORMAT_DOUBLE_SIZE];
+    double      doubles[BATCH];
+    int64_t     longs[BATCH];
+    const char* formats[] = {"%.6g", "%.17g"};
+    double      start, elapsed[3] = {0, 0, 0};
+    long        inexact[3] = {0, 0, 0};
+
+    /* Keeps the formatting from being optimized out */
+    static volatile size_t sink;
+
+    for (long done = 0; done < iterations; done += BATCH) {
+        fill(kind, doubles, longs);
+
+        for (int f = 0; f < (kind == WORKLOAD_LONG ? 1 : 2); f++) {
+            start = now_ns();
+            for (int i = 0; i < BATCH; i++) {
+                sink += copy_snprintf(kind, formats[f], doubles[i], longs[i]);
+            }
+            elapsed[f] += now_ns() - start;
+        }
+
+        start = now_ns();
+        for (int i = 0, pos = 0; i < BATCH; i++) {
+            char* out = arena + pos;
+
+            pos += kind == WORKLOAD_LONG ? valkey_glide_format_long(longs[i], out) + 1
+                                         : valkey_glide_format_double(doubles[i], out) + 1;
+        }
+        elapsed[2] += now_ns() - start;
+        sink += (size_t) arena[0];
+
+        if (kind != WORKLOAD_LONG) {
+            for (int i = 0; i < BATCH; i++) {
+                char buffer[64];
+
+                snprintf(buffer, sizeof(buffer), "%.6g", doubles[i]);
+                inexact[0] += strtod(buffer, NULL) != doubles[i];
+                snprintf(buffer, sizeof(buffer), "%.17g", doubles[i]);
+                inexact[1] += strtod(buffer, NULL) != doubles[i];
+                valkey_glide_format_double(doubles[i], buffer);
+                inexact[2] += strtod(buffer, NULL) != doubles[i];
+            }
+        }
+    }
+
+    if (kind == WORKLOAD_LONG) {
+        printf("%-8s snprintf %%ld   %6.1f ns/op\n", name, elapsed[0] / iterations);
+    } else {
+        printf("%-8s snprintf %%.6g  %6.1f ns/op  %ld inexact\n",
+               name,
+               elapsed[0] / iterations,
+               inexact[0]);
+        printf("%-8s snprintf %%.17g %6.1f ns/op  %ld inexact\n",
+               name,
+               elapsed[1] / iterations,
+               inexact[1]);
+    }
+    printf("%-8s format         %6.1f ns/op  %ld inexact\n",
+           name,
+           elapsed[2] / iterations,
+           inexact[2]);
+}
+
+int main(int argc, char** argv) {
+    long iterations = argc > 1 ? atol(argv[1]) : 4 * 1024 * 1024;
+
+    iterations = (iterations + BATCH - 1) / BATCH * BATCH;
+    run("ZADD", WORKLOAD_ZADD, iterations);
+    run("GEOADD", WORKLOAD_GEOADD, iterations);
+    run("long", WORKLOAD_LONG, iterations);
+    return 0;
+}
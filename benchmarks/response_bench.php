@@ -0,0 +1,31 @@
+<?php
+
+/*
+ * Reply conversion, before and after the arrays were presized, on synthetic LRANGE (Array),
+ * SMEMBERS (Sets) and HGETALL (Map) replies of 10, 1k and 100k elements. Needs no server: the
+ * replies are built by ResponseDecoderBench, which the extension registers for the tests.
+ *
+ *   php -d extension=modules/valkey_glide.so benchmarks/response_bench.php [seconds]
+ */
+
+$seconds = (float) ($argv[1] ?? 1.0);
+
+printf("%-6s %8s %14s %14s %8s\n", 'shape', 'elements', 'before ns', 'after ns', 'speedup');
+
+foreach (['array', 'set', 'map'] as $shape) {
+    foreach ([10, 1000, 100000] as $elements) {
+        // About $seconds per converter, from a short calibration run
+        $probe = ResponseDecoderBench::run($shape, $elements, 10);
+        $iterations = max(10, (int) ($seconds * 1e9 / max($probe['before'], 1)));
+
+        $result = ResponseDecoderBench::run($shape, $elements, $iterations);
+        printf(
+            "%-6s %8d %14.1f %14.1f %7.2fx\n",
+            $shape,
+            $elements,
+            $result['before'],
+            $result['after'],
+            $result['before'] / $result['after']
+        );
+    }
+}
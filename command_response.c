@@ -19,247 +19,41 @@
 #include "include/glide/command_request.pb-c.h"
 #include "include/glide/response.pb-c.h"
 #include "include/glide_bindings.h"
+#include "valkey_glide_batch.h"
 #include "valkey_glide_commands_common.h"
-
-/* Parse a cluster route from a zval parameter */
-typedef struct {
-    enum {
-        ROUTE_TYPE_KEY,       /* Route by key */
-        ROUTE_TYPE_HOST_PORT, /* Route by host:port */
-        ROUTE_TYPE_SIMPLE     /* Simple route: "randomNode", "allPrimaries", "allNodes" */
-    } type;
-
-    union {
-        struct {
-            char*  key;
-            size_t key_len;
-            int    key_allocated; /* Flag to indicate if key was dynamically allocated */
-        } key_route;
-
-        struct {
-            char* host;
-            int   port;
-        } host_port_route;
-
-        int simple_route_type; /* Using SimpleRoutes_C enum values */
-    } data;
-} cluster_route_t;
-
-/* Parse a cluster route parameter from a zval */
-int parse_cluster_route(zval* route_zval, cluster_route_t* route) {
-    /* Default to route by key */
-    route->type                         = ROUTE_TYPE_KEY;
-    route->data.key_route.key_allocated = 0;
-
-    if (Z_TYPE_P(route_zval) == IS_STRING) {
-        char*  route_str = Z_STRVAL_P(route_zval);
-        size_t route_len = Z_STRLEN_P(route_zval);
-
-        /* Check for special routing keywords */
-        if (route_len == 10 && strncasecmp(route_str, "randomNode", 10) == 0) {
-            route->type = ROUTE_TYPE_SIMPLE;
-            route->data.simple_route_type =
-                COMMAND_REQUEST__SIMPLE_ROUTES__Random; /* SimpleRoutes_Random */
-            return 1;
-        } else if (route_len == 12 && strncasecmp(route_str, "allPrimaries", 12) == 0) {
-            route->type                   = ROUTE_TYPE_SIMPLE;
-            route->data.simple_route_type = COMMAND_REQUEST__SIMPLE_ROUTES__AllPrimaries;
-            return 1;
-        } else if (route_len == 8 && strncasecmp(route_str, "allNodes", 8) == 0) {
-            route->type                   = ROUTE_TYPE_SIMPLE;
-            route->data.simple_route_type = COMMAND_REQUEST__SIMPLE_ROUTES__AllNodes;
-            return 1;
-        }
-
-        /* String parameter - use as key */
-        route->type                   = ROUTE_TYPE_KEY;
-        route->data.key_route.key     = route_str;
-        route->data.key_route.key_len = route_len;
-        return 1;
-    } else if (Z_TYPE_P(route_zval) == IS_ARRAY) {
-        HashTable* route_ht = Z_ARRVAL_P(route_zval);
-        zval *     type_zv = NULL, *key_zv = NULL, *host_zv = NULL, *port_zv = NULL;
-
-        /* Check if we have a type-based routing config */
-        type_zv = zend_hash_str_find(route_ht, "type", sizeof("type") - 1);
-        if (type_zv && Z_TYPE_P(type_zv) == IS_STRING) {
-            /* Type-based routing */
-            char* type_str = Z_STRVAL_P(type_zv);
-
-            if (strcasecmp(type_str, "primarySlotKey") == 0 ||
-                strcasecmp(type_str, "slotKey") == 0) {
-                /* Slot key routing */
-                key_zv = zend_hash_str_find(route_ht, "key", sizeof("key") - 1);
-                if (key_zv && (Z_TYPE_P(key_zv) == IS_STRING || Z_TYPE_P(key_zv) == IS_LONG)) {
-                    route->type                         = ROUTE_TYPE_KEY;
-                    route->data.key_route.key_allocated = 0; /* Initialize flag */
-
-                    if (Z_TYPE_P(key_zv) == IS_STRING) {
-                        /* String key - use directly */
-                        route->data.key_route.key     = Z_STRVAL_P(key_zv);
-                        route->data.key_route.key_len = Z_STRLEN_P(key_zv);
-                    } else if (Z_TYPE_P(key_zv) == IS_LONG) {
-                        /* Integer key - convert to string */
-                        route->data.key_route.key =
-                            long_to_string(Z_LVAL_P(key_zv), &route->data.key_route.key_len);
-                        if (!route->data.key_route.key) {
-                            return 0; /* Memory allocation failed */
-                        }
-                        route->data.key_route.key_allocated = 1; /* Mark as allocated */
-                    }
-                    return 1;
-                }
-            } else if (strcasecmp(type_str, "routeByAddress") == 0) {
-                /* Route by address */
-                host_zv = zend_hash_str_find(route_ht, "host", sizeof("host") - 1);
-                port_zv = zend_hash_str_find(route_ht, "port", sizeof("port") - 1);
-
-                if (host_zv && port_zv && Z_TYPE_P(host_zv) == IS_STRING) {
-                    route->type                      = ROUTE_TYPE_HOST_PORT;
-                    route->data.host_port_route.host = Z_STRVAL_P(host_zv);
-
-                    /* Get port from array */
-                    if (Z_TYPE_P(port_zv) == IS_LONG) {
-                        route->data.host_port_route.port = Z_LVAL_P(port_zv);
-                    } else {
-                        zval temp;
-                        ZVAL_COPY(&temp, port_zv);
-                        convert_to_long(&temp);
-                        route->data.host_port_route.port = Z_LVAL(temp);
-                        zval_dtor(&temp);
-                    }
-                    return 1;
-                }
-            }
-
-            return 0; /* Invalid type-based routing */
-        }
-
-        /* Try direct host/port keys */
-        host_zv = zend_hash_str_find(route_ht, "host", sizeof("host") - 1);
-        port_zv = zend_hash_str_find(route_ht, "port", sizeof("port") - 1);
-
-        if (!host_zv || !port_zv) {
-            /* Try numeric keys (indexed array approach) */
-            host_zv = zend_hash_index_find(route_ht, 0);
-            port_zv = zend_hash_index_find(route_ht, 1);
-        }
-
-        if (host_zv && port_zv && Z_TYPE_P(host_zv) == IS_STRING) {
-            /* Set route type to host:port */
-            route->type = ROUTE_TYPE_HOST_PORT;
-
-            /* Get host from array */
-            route->data.host_port_route.host = Z_STRVAL_P(host_zv);
-
-            /* Get port from array */
-            if (Z_TYPE_P(port_zv) == IS_LONG) {
-                route->data.host_port_route.port = Z_LVAL_P(port_zv);
-            } else {
-                zval temp;
-                ZVAL_COPY(&temp, port_zv);
-                convert_to_long(&temp);
-                route->data.host_port_route.port = Z_LVAL(temp);
-                zval_dtor(&temp);
-            }
-
-            return 1;
+#include "valkey_glide_errors.h"
+#include "valkey_glide_format.h"
+#include "valkey_glide_options.h"
+#include "valkey_glide_route.h"
+#include "zend_exceptions.h"
+
+/* CRC16-CCITT (XMODEM), the checksum cluster key slots are derived from */
+static uint16_t crc16_xmodem(const char* buf, size_t len) {
+    uint16_t crc = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t) ((unsigned char) buf[i]) << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t) ((crc << 1) ^ 0x1021) : (uint16_t) (crc << 1);
         }
     }
-
-    /* Could not parse route properly */
-    return 0;
+    return crc;
 }
 
-/* Create serialized route bytes from a cluster_route_t structure */
-uint8_t* create_route_bytes_from_route(cluster_route_t* route, size_t* route_bytes_len) {
-    /* Initialize route structure */
-    CommandRequest__Routes routes      = COMMAND_REQUEST__ROUTES__INIT;
-    uint8_t*               route_bytes = NULL;
-
-    /* Validate input parameters */
-    if (!route || !route_bytes_len) {
-        if (route_bytes_len)
-            *route_bytes_len = 0;
-        return NULL;
-    }
-
-    /* Declare protobuf structures outside switch to keep them in scope */
-    CommandRequest__SlotKeyRoute   slot_key_route   = COMMAND_REQUEST__SLOT_KEY_ROUTE__INIT;
-    CommandRequest__ByAddressRoute by_address_route = COMMAND_REQUEST__BY_ADDRESS_ROUTE__INIT;
-    CommandRequest__SimpleRoutes   simple_route;
-
-    switch (route->type) {
-        case ROUTE_TYPE_KEY:
-            /* Validate key data */
-            if (!route->data.key_route.key || route->data.key_route.key_len == 0) {
-                printf("Error: Invalid key data for route\n");
-                *route_bytes_len = 0;
-                return NULL;
-            }
-
-            /* Configure slot key route */
-            slot_key_route.slot_type = COMMAND_REQUEST__SLOT_TYPES__Primary;
-            slot_key_route.slot_key  = route->data.key_route.key;
-
-            routes.value_case     = COMMAND_REQUEST__ROUTES__VALUE_SLOT_KEY_ROUTE;
-            routes.slot_key_route = &slot_key_route;
-            break;
-
-        case ROUTE_TYPE_HOST_PORT:
-            // printf("Creating route by address: %s:%d\n",
-            //       route->data.host_port_route.host, route->data.host_port_route.port);
-            /* Configure by address route */
-            by_address_route.host = route->data.host_port_route.host;
-            by_address_route.port = route->data.host_port_route.port;
-
-            routes.value_case       = COMMAND_REQUEST__ROUTES__VALUE_BY_ADDRESS_ROUTE;
-            routes.by_address_route = &by_address_route;
-            break;
-
-        case ROUTE_TYPE_SIMPLE:
-            // printf("Creating simple route type: %d\n", route->data.simple_route_type);
-            /* Configure simple route */
-            simple_route = route->data.simple_route_type;
-
-            routes.value_case    = COMMAND_REQUEST__ROUTES__VALUE_SIMPLE_ROUTES;
-            routes.simple_routes = simple_route;
-            break;
-
-        default:
-            /* Unknown route type */
-            printf("Error: Unknown route type: %d\n", route->type);
-            *route_bytes_len = 0;
-            return NULL;
-    }
-
-    /* Get serialized size and allocate buffer */
-    *route_bytes_len = command_request__routes__get_packed_size(&routes);
-    if (*route_bytes_len == 0) {
-        printf("Error: Failed to get packed size for route\n");
-        return NULL;
-    }
-
-    route_bytes = (uint8_t*) emalloc(*route_bytes_len);
+/* Compute the cluster slot of a key (or shard channel), honouring {hash tags} */
+uint16_t valkey_glide_key_slot(const char* key, size_t key_len) {
+    const char* open = memchr(key, '{', key_len);
 
-    if (!route_bytes) {
-        printf("Error: Failed to allocate memory for route bytes\n");
-        *route_bytes_len = 0;
-        return NULL;
-    }
+    if (open) {
+        size_t      offset = open - key + 1;
+        const char* close  = memchr(open + 1, '}', key_len - offset);
 
-    /* Serialize the routes */
-    size_t packed_size = command_request__routes__pack(&routes, route_bytes);
-    if (packed_size != *route_bytes_len) {
-        printf(
-            "Error: Packed size mismatch: expected %zu, got %zu\n", *route_bytes_len, packed_size);
-        efree(route_bytes);
-        *route_bytes_len = 0;
-        return NULL;
+        /* Only a non-empty tag counts, "{}" hashes the whole key */
+        if (close && close > open + 1) {
+            return crc16_xmodem(open + 1, close - open - 1) & (VALKEY_GLIDE_CLUSTER_SLOTS - 1);
+        }
     }
-
-    // printf("Successfully created route bytes: %zu bytes\n", *route_bytes_len);
-    return route_bytes;
+    return crc16_xmodem(key, key_len) & (VALKEY_GLIDE_CLUSTER_SLOTS - 1);
 }
 
 /* Execute a command and handle common error checking */
@@ -269,61 +63,30 @@ CommandResult* execute_command_with_route(const void*          glide_client,
                                           const uintptr_t*     args,
                                           const unsigned long* args_len,
                                           zval*                arg_route) {
-    /* Check if client is valid */
-    if (!glide_client) {
-        printf("Error: glide_client is NULL\n");
-        return NULL;
-    }
-
-    /* Validate route parameter */
-    if (!arg_route) {
-        printf("Error: arg_route is NULL\n");
-        return NULL;
-    }
+    static const char invalid_route[] = "Invalid route";
 
-    /* Parse the route from the first parameter */
-    cluster_route_t route;
-    memset(&route, 0, sizeof(cluster_route_t));
-    if (!parse_cluster_route(arg_route, &route)) {
-        /* Failed to parse the route */
-        printf("Error: Failed to parse cluster route\n");
+    /* Check if client is valid */
+    if (!glide_client || !arg_route || (arg_count > 0 && (!args || !args_len))) {
         return NULL;
     }
 
-    /* Create serialized route bytes */
-    size_t   route_bytes_len = 0;
-    uint8_t* route_bytes     = create_route_bytes_from_route(&route, &route_bytes_len);
+    /* Packed route, shared unless it had to be packed for this command */
+    size_t         route_bytes_len = 0;
+    uint8_t*       owned_bytes     = NULL;
+    const uint8_t* route_bytes =
+        valkey_glide_route_bytes(arg_route, &route_bytes_len, &owned_bytes);
     if (!route_bytes) {
-        printf("Error: Failed to create route bytes\n");
-        /* Free dynamically allocated key if needed before returning */
-        if (route.type == ROUTE_TYPE_KEY && route.data.key_route.key_allocated) {
-            efree(route.data.key_route.key);
-        }
-        return NULL;
-    }
-
-    /* Validate all parameters before FFI call */
-    if (!glide_client) {
-        printf("ERROR: glide_client is NULL\n");
+        valkey_glide_set_last_error(invalid_route, sizeof(invalid_route) - 1);
         return NULL;
     }
 
-    if (arg_count > 0) {
-        if (!args) {
-            printf("ERROR: args is NULL but arg_count is %lu\n", arg_count);
-            return NULL;
-        }
-        if (!args_len) {
-            printf("ERROR: args_len is NULL but arg_count is %lu\n", arg_count);
-            return NULL;
-        }
-    }
-
-    if (route_bytes_len > 0) {
-        if (!route_bytes) {
-            printf("ERROR: route_bytes is NULL but route_bytes_len is %zu\n", route_bytes_len);
-            return NULL;
+    /* In a cluster pipeline the command is buffered with its route, not sent */
+    if (valkey_glide_batch_record_routed(
+            command_type, arg_count, args, args_len, route_bytes, route_bytes_len)) {
+        if (owned_bytes) {
+            efree(owned_bytes);
         }
+        return NULL;
     }
 
     /* Execute the command */
@@ -338,26 +101,13 @@ CommandResult* execute_command_with_route(const void*          glide_client,
                                     0                /* span pointer */
     );
 
-    /* Free route bytes */
-    if (route_bytes) {
-        efree(route_bytes);
-    }
-
-    /* Free dynamically allocated key if needed */
-    if (route.type == ROUTE_TYPE_KEY && route.data.key_route.key_allocated) {
-        efree(route.data.key_route.key);
+    if (owned_bytes) {
+        efree(owned_bytes);
     }
 
-    /* Validate result before returning */
-    if (!result) {
-        printf("Error: Command execution returned NULL result\n");
-    } else if (result->command_error) {
-        printf("Error: Command execution failed: %s\n",
-               result->command_error->command_error_message
-                   ? result->command_error->command_error_message
-                   : "Unknown error");
+    if (result && result->command_error) {
+        valkey_glide_command_error(result->command_error);
     }
-
     return result;
 }
 
@@ -372,6 +122,11 @@ CommandResult* execute_command(const void*          glide_client,
         return NULL;
     }
 
+    /* After multi()/pipeline() the command is buffered for exec(), not sent */
+    if (valkey_glide_batch_record(command_type, arg_count, args, args_len)) {
+        return NULL;
+    }
+
     /* Execute the command */
     CommandResult* result = command(glide_client,
                                     0,            /* channel */
@@ -384,6 +139,9 @@ CommandResult* execute_command(const void*          glide_client,
                                     0             /* span pointer */
     );
 
+    if (result && result->command_error) {
+        valkey_glide_command_error(result->command_error);
+    }
     return result;
 }
 
@@ -394,12 +152,8 @@ long handle_int_response(CommandResult* result, long* output_value) {
         return 0; /* False - failure */
     }
 
-    /* Check if there was an error */
+    /* Check if there was an error, recorded when the command returned */
     if (result->command_error) {
-        printf("%s:%d - Error executing command: %s\n",
-               __FILE__,
-               __LINE__,
-               result->command_error->command_error_message);
         free_command_result(result);
         return 0; /* False - failure */
     }
@@ -411,9 +165,6 @@ long handle_int_response(CommandResult* result, long* output_value) {
         /* Free the result */
         free_command_result(result);
         return 1; /* True - success */
-    } else {
-        // printf("%s:%d - Unexpected response type for integer command\n", __FILE__, __LINE__);
-        assert(0); /* This should never happen */
     }
 
     /* Unexpected response type */
@@ -428,12 +179,8 @@ int handle_string_response(CommandResult* result, char** output, size_t* output_
         return -1;
     }
 
-    /* Check if there was an error */
+    /* Check if there was an error, recorded when the command returned */
     if (result->command_error) {
-        printf("%s:%d - Error executing command: %s\n",
-               __FILE__,
-               __LINE__,
-               result->command_error->command_error_message);
         free_command_result(result);
         return -1;
     }
@@ -497,12 +244,8 @@ int handle_bool_response(CommandResult* result) {
         return -1;
     }
 
-    /* Check if there was an error */
+    /* Check if there was an error, recorded when the command returned */
     if (result->command_error) {
-        printf("%s:%d - Error executing command: %s\n",
-               __FILE__,
-               __LINE__,
-               result->command_error->command_error_message);
         free_command_result(result);
         return -1;
     }
@@ -526,12 +269,8 @@ int handle_ok_response(CommandResult* result) {
         return -1;
     }
 
-    /* Check if there was an error */
+    /* Check if there was an error, recorded when the command returned */
     if (result->command_error) {
-        printf("%s:%d - Error executing command: %s\n",
-               __FILE__,
-               __LINE__,
-               result->command_error->command_error_message);
         free_command_result(result);
         return -1;
     }
@@ -548,231 +287,400 @@ int handle_ok_response(CommandResult* result) {
     return ret_val;
 }
 
-/* Helper function to convert a CommandResponse to a PHP value
- * use_associative_array:
- * - 0: regular array processing
- * - 1: convert Map elements to associative array format (for ZMPOP/sorted sets)
+/*
+ * Reply conversion.
+ *
+ * Iterative: the arrays still being filled are frames on an explicit stack, and each element is
+ * converted straight into its slot of the parent array. A reply nested deeper than
+ * VALKEY_GLIDE_RESPONSE_MAX_DEPTH, with more than VALKEY_GLIDE_RESPONSE_MAX_ELEMENTS elements,
+ * or whose PHP value would not fit under memory_limit is dropped with a ValkeyGlideException
+ * before it is built, rather than ending the worker with a fatal error halfway through.
  */
-int command_response_to_zval(CommandResponse* response,
-                             zval*            output,
-                             int              use_associative_array,
-                             bool             use_false_if_null) {
-    if (!response) {
-        ZVAL_NULL(output);
-        return 0;
+
+typedef struct _response_frame {
+    CommandResponse* response; /* Array, Map or Sets being converted */
+    HashTable*       ht;
+    int64_t          next;  /* Next element of response */
+    int              mode;  /* use_associative_array for the elements */
+    uint32_t         depth; /* Of the elements */
+} response_frame;
+
+typedef struct _response_converter {
+    const valkey_glide_options_t* options;
+    bool                          false_if_null;
+    bool                          values; /* Unserialize the members and values of a shape */
+    const char*                   error; /* Limit that was hit */
+    uint64_t                      elements;
+    size_t                        bytes;  /* Estimated size of the PHP value */
+    size_t                        budget; /* Memory left under memory_limit */
+    response_frame*               stack;
+    uint32_t                      top;
+    uint32_t                      capacity;
+    response_frame                inline_stack[32];
+} response_converter;
+
+static void response_converter_init(response_converter* conv, bool false_if_null) {
+    zend_long limit = PG(memory_limit);
+    size_t    used  = zend_memory_usage(false);
+
+    conv->options       = valkey_glide_current_options();
+    conv->false_if_null = false_if_null;
+    conv->values        = false;
+    conv->error         = NULL;
+    conv->elements      = 0;
+    conv->bytes         = 0;
+    conv->budget        = limit <= 0 ? SIZE_MAX : (size_t) limit > used ? (size_t) limit - used : 0;
+    conv->stack         = conv->inline_stack;
+    conv->top           = 0;
+    conv->capacity      = sizeof(conv->inline_stack) / sizeof(conv->inline_stack[0]);
+}
+
+static void response_converter_free(response_converter* conv) {
+    if (conv->stack != conv->inline_stack) {
+        efree(conv->stack);
+    }
+}
+
+/* Count size bytes against the memory budget */
+static inline bool response_charge(response_converter* conv, size_t size) {
+    conv->bytes += size;
+    if (conv->bytes > conv->budget) {
+        conv->error = "does not fit in memory_limit";
+        return false;
+    }
+    return true;
+}
+
+static inline bool response_string(response_converter* conv,
+                                   const char*         str,
+                                   size_t              len,
+                                   zval*               out) {
+    if (!response_charge(conv, _ZSTR_STRUCT_SIZE(len))) {
+        return false;
+    }
+    ZVAL_STRINGL_FAST(out, str, len);
+    return true;
+}
+
+/* Give out an array for count elements, with room for size entries */
+static bool response_array(response_converter* conv,
+                           zval*               out,
+                           int64_t             count,
+                           int64_t             size,
+                           bool                packed,
+                           uint32_t            depth) {
+#if PHP_VERSION_ID >= 80200
+    size_t entry = packed ? sizeof(zval) : sizeof(Bucket);
+#else
+    size_t entry = sizeof(Bucket);
+#endif
+
+    if (depth >= VALKEY_GLIDE_RESPONSE_MAX_DEPTH) {
+        conv->error = "is nested too deeply";
+        return false;
+    }
+    conv->elements += count;
+    if (conv->elements > VALKEY_GLIDE_RESPONSE_MAX_ELEMENTS) {
+        conv->error = "has too many elements";
+        return false;
+    }
+    if (!response_charge(conv, sizeof(zend_array) + size * entry)) {
+        return false;
+    }
+
+    array_init_size(out, (uint32_t) size);
+    if (packed && count > 0) {
+        zend_hash_real_init_packed(Z_ARRVAL_P(out));
     }
+    return true;
+}
+
+/* Give out an array for the count elements of response, with room for size entries, and a
+ * frame to fill it */
+static bool response_push(response_converter* conv,
+                          CommandResponse*    response,
+                          zval*               out,
+                          int64_t             count,
+                          int64_t             size,
+                          bool                packed,
+                          int                 mode,
+                          uint32_t            depth) {
+    if (!response_array(conv, out, count, size, packed, depth)) {
+        return false;
+    }
+    if (count <= 0) {
+        return true;
+    }
+
+    if (conv->top == conv->capacity) {
+        response_frame* stack = safe_emalloc(conv->capacity * 2, sizeof(response_frame), 0);
+
+        memcpy(stack, conv->stack, conv->top * sizeof(response_frame));
+        response_converter_free(conv);
+        conv->stack = stack;
+        conv->capacity *= 2;
+    }
+    conv->stack[conv->top].response = response;
+    conv->stack[conv->top].ht       = Z_ARRVAL_P(out);
+    conv->stack[conv->top].next     = 0;
+    conv->stack[conv->top].mode     = mode;
+    conv->stack[conv->top].depth    = depth + 1;
+    conv->top++;
+    return true;
+}
+
+/* Convert response into out: scalars right away, Array, Map and Sets get their array and a
+ * frame. out is a valid zval afterwards even on failure. */
+static bool response_open(
+    response_converter* conv, CommandResponse* response, zval* out, int mode, uint32_t depth) {
+    ZVAL_NULL(out);
 
     switch (response->response_type) {
         case Null:
-            // printf("%s:%d - CommandResponse is NULL\n", __FILE__, __LINE__);
-            if (use_false_if_null) {
-                // printf("%s:%d - CommandResponse is converted to false\n", __FILE__, __LINE__);
-                ZVAL_FALSE(output);
-            } else {
-                ZVAL_NULL(output);
+            if (conv->false_if_null && !(conv->options && conv->options->null_multibulk_as_null)) {
+                ZVAL_FALSE(out);
             }
-
-            return 0;
+            return true;
         case Int:
-            // printf("%s:%d - CommandResponse is Int: %ld\n", __FILE__, __LINE__,
-            // response->int_value);
-            ZVAL_LONG(output, response->int_value);
-            return 1;
+            ZVAL_LONG(out, response->int_value);
+            return true;
         case Float:
-            // printf("%s:%d - CommandResponse is Float: %f\n", __FILE__, __LINE__,
-            // response->float_value);
-            ZVAL_DOUBLE(output, response->float_value);
-            ////printf("%s:%d - Converted CommandResponse to double: %f\n", __FILE__, __LINE__,
-            /// Z_DVAL_P(output));
-            return 1;
+            ZVAL_DOUBLE(out, response->float_value);
+            return true;
         case Bool:
-            ////printf("%s:%d - CommandResponse is Bool: %d\n", __FILE__, __LINE__,
-            /// response->bool_value);
-            ZVAL_BOOL(output, response->bool_value);
-            return 1;
+            ZVAL_BOOL(out, response->bool_value);
+            return true;
+        case Ok:
+            ZVAL_TRUE(out);
+            return true;
         case String:
-            // printf("%s:%d - CommandResponse is String with length: %ld string = %s\n", __FILE__,
-            // __LINE__, response->string_value_len, response->string_value);
-            ZVAL_STRINGL(output, response->string_value, response->string_value_len);
-            return 1;
+            return response_string(conv, response->string_value, response->string_value_len, out);
         case Array:
-            //  printf("%s:%d - CommandResponse is Array with length: %ld, use_associative_array =
-            //  %d\n", __FILE__, __LINE__, response->array_value_len, use_associative_array);
-            array_init(output);
-            if (use_associative_array == COMMAND_RESPONSE_SCAN_ASSOSIATIVE_ARRAY) {
-                for (int64_t i = 0; i + 1 < response->array_value_len; i += 2) {
-                    zval field, value;
-
-                    command_response_to_zval(&response->array_value[i],
-                                             &field,
-                                             COMMAND_RESPONSE_NOT_ASSOSIATIVE,
-                                             use_false_if_null);
-                    command_response_to_zval(&response->array_value[i + 1],
-                                             &value,
-                                             COMMAND_RESPONSE_NOT_ASSOSIATIVE,
-                                             use_false_if_null);
-
-                    if (Z_TYPE(field) == IS_STRING) {
-                        add_assoc_zval(output, Z_STRVAL(field), &value);
-                        zval_dtor(&field);
-                    } else {
-                        zval_dtor(&field);
-                        zval_dtor(&value);
-                    }
-                }
-            } else if (response->array_value_len == 2 &&
-                       use_associative_array == COMMAND_RESPONSE_STREAM_ARRAY_ASSOCIATIVE) {
-                zval field, value;
-                // printf("%s:%d - response->array_value[0]->command_response_type = %d,
-                // response->array_value[1]->command_response_type = %d\n",
-                //       __FILE__, __LINE__, response->array_value[0].response_type,
-                //       response->array_value[1].response_type);
-                command_response_to_zval(
-                    &response->array_value[0], &field, use_associative_array, use_false_if_null);
-                command_response_to_zval(
-                    &response->array_value[1], &value, use_associative_array, use_false_if_null);
-                // printf("%s:%d - DEBUG: Adding field \n", __FILE__, __LINE__);
-                // php_var_dump(&field, 2);
-                // printf("%s:%d - DEBUG: Adding value \n", __FILE__, __LINE__);
-                // php_var_dump(&value, 2);
-
-                if (Z_TYPE(field) == IS_STRING) {
-                    // printf("%s:%d - DEBUG: Adding field %s with value %s\n", __FILE__, __LINE__,
-                    // Z_STRVAL(field), Z_STRVAL(value));
-                    add_assoc_zval(output, Z_STRVAL(field), &value);
-                    zval_dtor(&field);
-                } else if (Z_TYPE(value) == IS_ARRAY && Z_TYPE(field) == IS_ARRAY) {
-                    {
-                        // Iterate through the field array and add each key-value pair to output
-                        HashTable*   field_ht = Z_ARRVAL(field);
-                        zend_string* key;
-                        zval*        val;
-                        ZEND_HASH_FOREACH_STR_KEY_VAL(field_ht, key, val) {
-                            zval copy;
-                            ZVAL_COPY(&copy, val);
-                            add_assoc_str(output, ZSTR_VAL(key), Z_STR(copy));
-                        }
-                        ZEND_HASH_FOREACH_END();
-                    }
-
-                    // Do the same for the value array
-
-                    {
-                        HashTable*   value_ht = Z_ARRVAL(value);
-                        zend_string* key;
-                        zval*        val;
-                        ZEND_HASH_FOREACH_STR_KEY_VAL(value_ht, key, val) {
-                            zval copy;
-                            ZVAL_COPY(&copy, val);
-                            add_assoc_str(output, ZSTR_VAL(key), Z_STR(copy));
-                        }
-                        ZEND_HASH_FOREACH_END();
-                    }
-                } else {
-                    zval_dtor(&field);
-                    zval_dtor(&value);
-                }
-                // php_var_dump(output, 2);
-            } else {
-                for (int64_t i = 0; i < response->array_value_len; i++) {
-                    zval value;
-
-                    command_response_to_zval(&response->array_value[i],
-                                             &value,
-                                             use_associative_array,
-                                             use_false_if_null);
-                    // printf("%s:%d - DEBUG: Adding array value %d\n", __FILE__, __LINE__, i);
-                    //   php_var_dump(&value, 2); // No need to modify this as it's not printf
-
-                    add_next_index_zval(output, &value);
-                    // printf("%s:%d - DEBUG: Added array value %d\n", __FILE__, __LINE__, i);
-                    // php_var_dump(output, 2); // No need to modify this as it's not printf
-                }
+            if (mode == COMMAND_RESPONSE_SCAN_ASSOSIATIVE_ARRAY) {
+                return response_push(conv,
+                                     response,
+                                     out,
+                                     response->array_value_len,
+                                     response->array_value_len / 2,
+                                     false,
+                                     mode,
+                                     depth);
             }
-            // printf("%s:%d - DEBUG: Finished processing array response\n", __FILE__, __LINE__);
-            return 1;
-
+            return response_push(conv,
+                                 response,
+                                 out,
+                                 response->array_value_len,
+                                 response->array_value_len,
+                                 true,
+                                 mode,
+                                 depth);
         case Map:
-            // printf("%s:%d - CommandResponse is Map with length: %ld\n", __FILE__, __LINE__,
-            // response->array_value_len);
-            array_init(output);
-
-            // Special handling for FUNCTION command - skip server address wrapper
-            if (use_associative_array == COMMAND_RESPONSE_ASSOSIATIVE_ARRAY_MAP_FUNCTION &&
+            // FUNCTION replies: skip the wrapper keyed by the server address (contains ":")
+            if (mode == COMMAND_RESPONSE_ASSOSIATIVE_ARRAY_MAP_FUNCTION &&
                 response->array_value_len == 1) {
                 CommandResponse* element = &response->array_value[0];
-                // Remove the first field of server address (contains ":")
-                if (element->map_key != NULL && element->map_key->response_type == String) {
-                    char* key_str = element->map_key->string_value;
-                    if (strchr(key_str, ':') != NULL) {
-                        // Skip the server key and process only the value
-                        if (element->map_value != NULL) {
-                            return command_response_to_zval(element->map_value,
-                                                            output,
-                                                            use_associative_array,
-                                                            use_false_if_null);
-                        }
-                    }
+
+                if (element->map_key && element->map_key->response_type == String &&
+                    memchr(element->map_key->string_value,
+                           ':',
+                           element->map_key->string_value_len) &&
+                    element->map_value) {
+                    return response_open(conv, element->map_value, out, mode, depth);
                 }
             }
+            return response_push(conv,
+                                 response,
+                                 out,
+                                 response->array_value_len,
+                                 mode != COMMAND_RESPONSE_NOT_ASSOSIATIVE
+                                     ? response->array_value_len
+                                     : response->array_value_len * 2,
+                                 false,
+                                 mode,
+                                 depth);
+        case Sets:
+            return response_push(conv,
+                                 response,
+                                 out,
+                                 response->sets_value_len,
+                                 response->sets_value_len,
+                                 true,
+                                 mode,
+                                 depth);
+        default:
+            return true;
+    }
+}
 
-            // Normal Map processing
-            for (int i = 0; i < response->array_value_len; i++) {
-                zval             key, value;
-                CommandResponse* element = &response->array_value[i];
+/* Next slot of a packed or list-like array, NULL until the element is converted into it */
+static inline zval* response_append(HashTable* ht) {
+    zval null;
 
-                // Process the key
-                if (element->map_key != NULL) {
-                    command_response_to_zval(
-                        element->map_key, &key, use_associative_array, use_false_if_null);
-                } else {
-                    ZVAL_NULL(&key);
-                }
+    ZVAL_NULL(&null);
+    return zend_hash_next_index_insert_new(ht, &null);
+}
 
-                // Process the value
-                if (element->map_value != NULL) {
-                    // printf("%s:%d - DEBUG: Processing map value %d\n", __FILE__, __LINE__, i);
-                    command_response_to_zval(
-                        element->map_value, &value, use_associative_array, use_false_if_null);
-                    // printf("%s:%d - DEBUG: Map value %d processed\n", __FILE__, __LINE__, i);
-                } else {
-                    ZVAL_NULL(&value);
-                }
+/* Slot under a string key of the reply, binary safe and with symtable semantics */
+static inline zval* response_slot(response_converter* conv, HashTable* ht, CommandResponse* key) {
+    zend_string* name;
+    zval*        slot;
+    zval         null;
 
-                if (use_associative_array != COMMAND_RESPONSE_NOT_ASSOSIATIVE &&
-                    Z_TYPE(key) == IS_STRING) {
-                    // printf("%s:%d - DEBUG: Adding key %s \n", __FILE__, __LINE__, Z_STRVAL(key));
-                    // php_var_dump(&value, 2); // No need to modify this as it's not printf
-                    add_assoc_zval(output, Z_STRVAL(key), &value);
-                    zval_dtor(&key);  // Clean up the key since we're using it as an index
-                } else {
-                    // Add the key as a separate array element (original behavior)
-                    add_next_index_zval(output, &key);
-                    // Add the value as the next array element
-                    add_next_index_zval(output, &value);
+    if (!response_charge(conv, _ZSTR_STRUCT_SIZE(key->string_value_len))) {
+        return NULL;
+    }
+    name = zend_string_init(key->string_value, key->string_value_len, 0);
+    ZVAL_NULL(&null);
+    slot = zend_symtable_update(ht, name, &null);
+    zend_string_release(name);
+    return slot;
+}
+
+/* Convert one element of the frame on top of the stack, or pop the frame once it is full */
+static bool response_step(response_converter* conv) {
+    response_frame*  frame    = &conv->stack[conv->top - 1];
+    CommandResponse* response = frame->response;
+    HashTable*       ht       = frame->ht;
+    int64_t          i        = frame->next;
+    int              mode     = frame->mode;
+    uint32_t         depth    = frame->depth;
+    CommandResponse* element;
+    zval*            slot;
+
+    /* frame is not used past here: converting an element can grow the stack */
+    switch (response->response_type) {
+        case Sets:
+            if (i >= response->sets_value_len) {
+                break;
+            }
+            frame->next++;
+            element = &response->sets_value[i];
+            if (element->response_type != String) {
+                return true;
+            }
+            return response_string(
+                conv, element->string_value, element->string_value_len, response_append(ht));
+
+        case Array:
+            if (mode == COMMAND_RESPONSE_SCAN_ASSOSIATIVE_ARRAY) {
+                /* [field, value, ...] pairs, pairs without a string field are dropped */
+                if (i + 1 >= response->array_value_len) {
+                    break;
+                }
+                frame->next += 2;
+                element = &response->array_value[i];
+                if (element->response_type != String) {
+                    return true;
+                }
+                if (!(slot = response_slot(conv, ht, element))) {
+                    return false;
                 }
+                return response_open(conv,
+                                     &response->array_value[i + 1],
+                                     slot,
+                                     COMMAND_RESPONSE_NOT_ASSOSIATIVE,
+                                     depth);
             }
-            // php_var_dump(output, 2); // No need to modify this as it's not printf
-            return 1;
+            if (i >= response->array_value_len) {
+                break;
+            }
+            frame->next++;
+            element = &response->array_value[i];
+            if (element->response_type == String) {
+                return response_string(
+                    conv, element->string_value, element->string_value_len, response_append(ht));
+            }
+            return response_open(conv, element, response_append(ht), mode, depth);
 
-        case Sets:
-            array_init(output);
-            for (int i = 0; i < response->sets_value_len; i++) {
-                zval             value;
-                CommandResponse* set_item = &response->sets_value[i];
-
-                if (set_item->response_type == String) {
-                    ZVAL_STRINGL(&value, set_item->string_value, set_item->string_value_len);
-                    add_next_index_zval(output, &value);
+        case Map:
+            if (i >= response->array_value_len) {
+                break;
+            }
+            frame->next++;
+            element = &response->array_value[i];
+            if (mode != COMMAND_RESPONSE_NOT_ASSOSIATIVE && element->map_key &&
+                element->map_key->response_type == String) {
+                if (!(slot = response_slot(conv, ht, element->map_key))) {
+                    return false;
+                }
+            } else {
+                /* The key as an element of its own, then the value */
+                slot = response_append(ht);
+                if (element->map_key &&
+                    !response_open(conv, element->map_key, slot, mode, depth)) {
+                    return false;
                 }
+                slot = response_append(ht);
             }
-            return 1;
+            return !element->map_value ||
+                   response_open(conv, element->map_value, slot, mode, depth);
+
+        default:
+            break;
+    }
+
+    conv->top--;
+    return true;
+}
+
+/* Convert response into out, using the stack above its current top */
+static bool response_convert(
+    response_converter* conv, CommandResponse* response, zval* out, int mode, uint32_t depth) {
+    uint32_t base = conv->top;
+
+    if (!response_open(conv, response, out, mode, depth)) {
+        return false;
+    }
+    while (conv->top > base) {
+        if (!response_step(conv)) {
+            conv->top = base;
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Helper function to convert a CommandResponse to a PHP value
+ * use_associative_array:
+ * - 0: regular array processing
+ * - 1: convert Map elements to associative array format (for ZMPOP/sorted sets)
+ */
+int command_response_to_zval(CommandResponse* response,
+                             zval*            output,
+                             int              use_associative_array,
+                             bool             use_false_if_null) {
+    response_converter conv;
+    bool               converted;
+
+    if (!response) {
+        ZVAL_NULL(output);
+        return 0;
+    }
+
+    response_converter_init(&conv, use_false_if_null);
+    converted = response_convert(&conv, response, output, use_associative_array, 0);
+    response_converter_free(&conv);
+
+    if (!converted) {
+        zval_ptr_dtor(output);
+        ZVAL_NULL(output);
+        zend_throw_exception_ex(get_valkey_glide_exception_ce(), 0, "Reply %s", conv.error);
+        return 0;
+    }
+
+    switch (response->response_type) {
+        case Null:
+            return 0;
+        case Int:
+        case Float:
+        case Bool:
+        case String:
+        case Array:
+        case Map:
+        case Sets:
         case Ok:
-            // ZVAL_STRING(output, "OK");
-            ZVAL_BOOL(output, true);
             return 1;
         default:
-            ZVAL_NULL(output);
             return -1;
     }
 }
@@ -784,12 +692,8 @@ int handle_array_response(CommandResult* result, zval* output) {
         return -1;
     }
 
-    /* Check if there was an error */
+    /* Check if there was an error, recorded when the command returned */
     if (result->command_error) {
-        printf("%s:%d - Error executing command: %s\n",
-               __FILE__,
-               __LINE__,
-               result->command_error->command_error_message);
         free_command_result(result);
         return -1;
     }
@@ -821,12 +725,8 @@ int handle_map_response(CommandResult* result, zval* output) {
         return -1;
     }
 
-    /* Check if there was an error */
+    /* Check if there was an error, recorded when the command returned */
     if (result->command_error) {
-        printf("%s:%d - Error executing command: %s\n",
-               __FILE__,
-               __LINE__,
-               result->command_error->command_error_message);
         free_command_result(result);
         return -1;
     }
@@ -858,12 +758,8 @@ int handle_set_response(CommandResult* result, zval* output) {
         return -1;
     }
 
-    /* Check if there was an error */
+    /* Check if there was an error, recorded when the command returned */
     if (result->command_error) {
-        printf("%s:%d - Error executing command: %s\n",
-               __FILE__,
-               __LINE__,
-               result->command_error->command_error_message);
         free_command_result(result);
         return -1;
     }
@@ -890,135 +786,572 @@ int handle_set_response(CommandResult* result, zval* output) {
 
 /* Convert a long value to a string */
 char* long_to_string(long value, size_t* len) {
-    char buffer[32];
-    *len      = snprintf(buffer, sizeof(buffer), "%ld", value);
-    char* str = (char*) emalloc(*len + 1);
-    if (str) {
-        memcpy(str, buffer, *len);
-        str[*len] = '\0';
-    }
+    char* str = emalloc(VALKEY_GLIDE_FORMAT_LONG_SIZE);
+
+    *len = valkey_glide_format_long(value, str);
     return str;
 }
 
-/* Convert a double value to a string */
+/* Convert a double value to a string, with the shortest digits that read back exactly */
 char* double_to_string(double value, size_t* len) {
-    char buffer[64];
-    /* Use %.6g format to get a more user-friendly representation */
-    *len      = snprintf(buffer, sizeof(buffer), "%.6g", value);
-    char* str = (char*) emalloc(*len + 1);
-    if (str) {
-        memcpy(str, buffer, *len);
-        str[*len] = '\0';
-    }
+    char* str = emalloc(VALKEY_GLIDE_FORMAT_DOUBLE_SIZE);
+
+    *len = valkey_glide_format_double(value, str);
     return str;
 }
-/* Helper function to convert a CommandResponse to a PHP stream format
- * This is specifically for XRANGE/XREVRANGE commands that return stream entries
- * We need to handle both Array and Map response types
- * The output should be: ["stream_id" => ["field1" => "value1", "field2" => "value2", ...]]
+/*
+ * Reply shapes.
+ *
+ * Decoders for the replies that PHP gets in another shape than they come in: WITHSCORES
+ * members, HRANDFIELD WITHVALUES fields, stream entries, popped members and GEO tuples. Each
+ * builds the final array while it walks the reply, on top of the converter above and under its
+ * limits; the members, fields and values themselves are converted by it, and unserialized on
+ * the way for command_response_to_values_zval(). The shapes only go a level or two deep, so
+ * they recurse, bounded by VALKEY_GLIDE_RESPONSE_MAX_DEPTH.
  */
-int command_response_to_stream_zval(CommandResponse* response, zval* output) {
-    // printf("%s:%d - ------------------------------------------------\n", __FILE__, __LINE__);
-    if (!response) {
-        // printf("%s:%d - DEBUG: Response is NULL\n", __FILE__, __LINE__);
-        ZVAL_NULL(output);
-        return 0;
-    }
-    array_init(output);
 
-    /* Handle different response types */
-    // printf("%s:%d - DEBUG: Processing command response of type %d\n", __FILE__, __LINE__,
-    // response->response_type);
+/* A reply number as a float: scores, distances and coordinates come as bulk strings in RESP2 */
+static double shape_double(CommandResponse* response) {
+    char   buffer[64];
+    size_t len;
+
     switch (response->response_type) {
-        case Map:
-            /* Process map response where keys are stream IDs and values are field-value pairs */
-            for (int i = 0; i < response->array_value_len; i++) {
-                CommandResponse* element = &response->array_value[i];
+        case Float:
+            return response->float_value;
+        case Int:
+            return (double) response->int_value;
+        case String:
+            len = MIN(response->string_value_len, sizeof(buffer) - 1);
+            memcpy(buffer, response->string_value, len);
+            buffer[len] = '\0';
+            if (!strcasecmp(buffer, "inf") || !strcasecmp(buffer, "+inf")) {
+                return ZEND_INFINITY;
+            }
+            if (!strcasecmp(buffer, "-inf")) {
+                return -ZEND_INFINITY;
+            }
+            return zend_strtod(buffer, NULL);
+        default:
+            return 0.0;
+    }
+}
 
-                /* Skip if we don't have both key and value */
-                if (!element->map_key || !element->map_value) {
-                    continue;
-                }
+/* Whether response is a list of [a, b] pairs rather than a list of values */
+static bool shape_has_pairs(CommandResponse* response) {
+    return response->response_type == Array && response->array_value_len > 0 &&
+           response->array_value[0].response_type == Array &&
+           response->array_value[0].array_value_len == 2;
+}
 
-                /* Extract stream ID from key */
-                if (element->map_key->response_type != String) {
-                    continue;
-                }
+/* What the pairs of a shape are */
+typedef enum {
+    SHAPE_PAIR_VALUE,  /* field => value, the value a stored one */
+    SHAPE_PAIR_SCORE,  /* member => score, the score as a float */
+    SHAPE_PAIR_MEMBER, /* member => score, the score as it comes */
+} shape_pair_kind;
+
+/* A stored value of the reply, unserialized when the converter decodes values */
+static bool shape_value(response_converter* conv,
+                        CommandResponse*    response,
+                        zval*               out,
+                        uint32_t            depth) {
+    if (!conv->values || response->response_type != String) {
+        return response_convert(conv, response, out, COMMAND_RESPONSE_NOT_ASSOSIATIVE, depth);
+    }
+    if (!response_charge(conv, _ZSTR_STRUCT_SIZE(response->string_value_len))) {
+        return false;
+    }
+    valkey_glide_unserialize(
+        conv->options, response->string_value, response->string_value_len, out);
+    return true;
+}
 
-                char*  stream_id     = element->map_key->string_value;
-                size_t stream_id_len = element->map_key->string_value_len;
-                // printf("%s:%d - NEW STREAM ID: %.*s\n", __FILE__, __LINE__, (int)stream_id_len,
-                // stream_id);
-
-                /* Create associative array for field-value pairs */
-                zval field_array;
-                array_init(&field_array);
-                // printf("%s:%d - DEBUG: Processing stream ID: %.*s,
-                // element->map_value->response_type = %d\n", __FILE__, __LINE__,
-                // (int)stream_id_len, stream_id, element->map_value->response_type);
-                /* Process nested field-value pairs - add safety check */
-                if (element->map_value->response_type == Array) {
-                    /* Safe version that checks array bounds */
-                    if (element->map_value->array_value_len > 0) {
-                        // printf("%s:%d - DEBUG: Processing Array response for stream ID: %.*s,
-                        // array_value_len = %ld\n", __FILE__, __LINE__, (int)stream_id_len,
-                        // stream_id, element->map_value->array_value_len);
-                        CommandResponse* field_resp1 = &element->map_value->array_value[0];
-
-                        if (field_resp1->response_type == Array &&
-                            field_resp1->array_value_len == 2) {
-                            zval field, value;
-                            command_response_to_zval(&field_resp1->array_value[0],
-                                                     &field,
-                                                     COMMAND_RESPONSE_NOT_ASSOSIATIVE,
-                                                     false);
-                            command_response_to_zval(&field_resp1->array_value[1],
-                                                     &value,
-                                                     COMMAND_RESPONSE_NOT_ASSOSIATIVE,
-                                                     false);
-
-                            if (Z_TYPE(field) == IS_STRING) {
-                                // printf("%s:%d - DEBUG: Adding field %s with value %s\n",
-                                // __FILE__, __LINE__, Z_STRVAL(field), Z_STRVAL(value));
-                                add_assoc_zval(&field_array, Z_STRVAL(field), &value);
-                                zval_dtor(&field);
-                            } else {
-                                zval_dtor(&field);
-                                zval_dtor(&value);
-                            }
-                        }
-                    }
-                    /* Add the stream entry to the output array */
-                    add_assoc_zval_ex(output, stream_id, stream_id_len, &field_array);
-                } else if (element->map_value->response_type == Map) {
-                    CommandResponse* map = element->map_value;
-                    // printf("%s:%d - DEBUG: Processing Map response for stream ID: %.*s,
-                    // map->array_value_len = %ld\n", __FILE__, __LINE__, (int)stream_id_len,
-                    // stream_id, map->array_value_len); printf("%s:%d - DEBUG: Map response type =
-                    // %d\n", __FILE__, __LINE__, map->response_type);
-                    zval output1;
-                    command_response_to_zval(
-                        map, &output1, COMMAND_RESPONSE_STREAM_ARRAY_ASSOCIATIVE, false);
-                    add_assoc_zval_ex(output, stream_id, stream_id_len, &output1);
-                } else {
-                    // printf("%s:%d - DEBUG: Unexpected response type for stream fields: %d\n",
-                    // __FILE__, __LINE__, element->map_value->response_type);
+/* Slot under a member of the reply. When the converter decodes values the member is
+ * unserialized first, and kept as it came if it is not a string or an integer. */
+static zval* shape_member_slot(response_converter* conv, HashTable* ht, CommandResponse* key) {
+    zval  member;
+    zval  null;
+    zval* slot;
+
+    if (!conv->values) {
+        return response_slot(conv, ht, key);
+    }
+    if (!response_charge(conv, _ZSTR_STRUCT_SIZE(key->string_value_len))) {
+        return NULL;
+    }
+    valkey_glide_unserialize(conv->options, key->string_value, key->string_value_len, &member);
+
+    ZVAL_NULL(&null);
+    if (Z_TYPE(member) == IS_STRING) {
+        slot = zend_symtable_update(ht, Z_STR(member), &null);
+    } else if (Z_TYPE(member) == IS_LONG) {
+        slot = zend_hash_index_update(ht, Z_LVAL(member), &null);
+    } else {
+        slot = zend_symtable_str_update(ht, key->string_value, key->string_value_len, &null);
+    }
+    zval_ptr_dtor(&member);
+    return slot;
+}
+
+/* Members without their scores: a list of them, or a single one (ZRANDMEMBER without a count),
+ * and the other lists of stored values */
+static bool shape_values(response_converter* conv,
+                         CommandResponse*    response,
+                         zval*               out,
+                         uint32_t            depth) {
+    CommandResponse* elements;
+    int64_t          count;
+    HashTable*       ht;
+
+    if (response->response_type == Array) {
+        elements = response->array_value;
+        count    = response->array_value_len;
+    } else if (response->response_type == Sets) {
+        elements = response->sets_value;
+        count    = response->sets_value_len;
+    } else {
+        return shape_value(conv, response, out, depth);
+    }
+
+    if (!response_array(conv, out, count, count, true, depth)) {
+        return false;
+    }
+    ht = Z_ARRVAL_P(out);
+
+    for (int64_t i = 0; i < count; i++) {
+        if (!shape_value(conv, &elements[i], response_append(ht), depth + 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Add key => value to ht as kind says. Pairs whose key is not a string or an integer are
+ * dropped. */
+static bool shape_pair(response_converter* conv,
+                       HashTable*          ht,
+                       CommandResponse*    key,
+                       CommandResponse*    value,
+                       shape_pair_kind     kind,
+                       uint32_t            depth) {
+    zval* slot;
+    zval  null;
+
+    if (key->response_type == String) {
+        slot = kind == SHAPE_PAIR_VALUE ? response_slot(conv, ht, key)
+                                        : shape_member_slot(conv, ht, key);
+        if (!slot) {
+            return false;
+        }
+    } else if (key->response_type == Int) {
+        ZVAL_NULL(&null);
+        slot = zend_hash_index_update(ht, key->int_value, &null);
+    } else {
+        return true;
+    }
+
+    switch (kind) {
+        case SHAPE_PAIR_SCORE:
+            ZVAL_DOUBLE(slot, shape_double(value));
+            return true;
+        case SHAPE_PAIR_MEMBER:
+            return response_convert(conv, value, slot, COMMAND_RESPONSE_NOT_ASSOSIATIVE, depth);
+        default:
+            return shape_value(conv, value, slot, depth);
+    }
+}
+
+/* [key => value] from a Map, from [[key, value], ...], or from [key, value, ...] when flat */
+static bool shape_assoc(response_converter* conv,
+                        CommandResponse*    response,
+                        zval*               out,
+                        bool                flat,
+                        shape_pair_kind     kind,
+                        uint32_t            depth) {
+    int64_t          count = response->array_value_len;
+    CommandResponse* element;
+    HashTable*       ht;
+
+    if (!response_array(conv, out, count, flat ? count / 2 : count, false, depth)) {
+        return false;
+    }
+    ht = Z_ARRVAL_P(out);
+
+    if (response->response_type == Map) {
+        for (int64_t i = 0; i < count; i++) {
+            element = &response->array_value[i];
+            if (element->map_key && element->map_value &&
+                !shape_pair(conv, ht, element->map_key, element->map_value, kind, depth + 1)) {
+                return false;
+            }
+        }
+    } else if (flat) {
+        for (int64_t i = 0; i + 1 < count; i += 2) {
+            if (!shape_pair(conv,
+                            ht,
+                            &response->array_value[i],
+                            &response->array_value[i + 1],
+                            kind,
+                            depth + 1)) {
+                return false;
+            }
+        }
+    } else {
+        for (int64_t i = 0; i < count; i++) {
+            element = &response->array_value[i];
+            if (element->response_type == Array && element->array_value_len == 2 &&
+                !shape_pair(conv,
+                            ht,
+                            &element->array_value[0],
+                            &element->array_value[1],
+                            kind,
+                            depth + 1)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/* [id => [field => value]] from {id: fields} or [[id, fields], ...], fields being pairs or flat.
+ * XREAD and XREADGROUP nest the entries in {stream: {id: fields}}. Entries without fields (a nil
+ * for one that was deleted) are left out. */
+static bool shape_stream(response_converter* conv,
+                         CommandResponse*    response,
+                         zval*               out,
+                         uint32_t            depth) {
+    int64_t          count = response->array_value_len;
+    CommandResponse *element, *key, *value;
+    HashTable*       ht;
+    zval*            slot;
+    bool             converted;
+
+    if (!response_array(conv, out, count, count, false, depth)) {
+        return false;
+    }
+    ht = Z_ARRVAL_P(out);
+
+    for (int64_t i = 0; i < count; i++) {
+        element = &response->array_value[i];
+        if (response->response_type == Map) {
+            key   = element->map_key;
+            value = element->map_value;
+        } else if (element->response_type == Array && element->array_value_len == 2) {
+            key   = &element->array_value[0];
+            value = &element->array_value[1];
+        } else {
+            continue;
+        }
+        if (!key || !value || key->response_type != String ||
+            (value->response_type != Map && value->response_type != Array)) {
+            continue;
+        }
+
+        if (!(slot = response_slot(conv, ht, key))) {
+            return false;
+        }
+        if (value->response_type == Map) {
+            converted = shape_stream(conv, value, slot, depth + 1);
+        } else {
+            converted = shape_assoc(
+                conv, value, slot, !shape_has_pairs(value), SHAPE_PAIR_VALUE, depth + 1);
+        }
+        if (!converted) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* A GEO tuple: [dist, hash, [lon, lat]] or [lon, lat], bulk string numbers as floats */
+static bool shape_geo_tuple(response_converter* conv,
+                            CommandResponse*    response,
+                            zval*               out,
+                            uint32_t            depth) {
+    int64_t          count = response->array_value_len;
+    CommandResponse* element;
+    HashTable*       ht;
+    zval*            slot;
+
+    if (!response_array(conv, out, count, count, true, depth)) {
+        return false;
+    }
+    ht = Z_ARRVAL_P(out);
+
+    for (int64_t i = 0; i < count; i++) {
+        element = &response->array_value[i];
+        slot    = response_append(ht);
+        switch (element->response_type) {
+            case String:
+            case Float:
+                ZVAL_DOUBLE(slot, shape_double(element));
+                break;
+            case Int:
+                /* The geohash */
+                ZVAL_LONG(slot, element->int_value);
+                break;
+            case Array:
+                if (!shape_geo_tuple(conv, element, slot, depth + 1)) {
+                    return false;
                 }
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+/* GEOPOS [[lon, lat] or nil, ...] to a list of positions, and GEOSEARCH WITH*
+ * [[member, [dist, hash, [lon, lat]]], ...] to [member => [dist, hash, [lon, lat]]]. Members
+ * without WITH* stay a list. */
+static bool shape_geo(response_converter* conv,
+                      CommandResponse*    response,
+                      zval*               out,
+                      uint32_t            depth) {
+    int64_t          count = response->array_value_len;
+    CommandResponse* element;
+    HashTable*       ht;
+    zval*            slot;
+    bool             converted;
+
+    if (!response_array(conv, out, count, count, false, depth)) {
+        return false;
+    }
+    ht = Z_ARRVAL_P(out);
+
+    for (int64_t i = 0; i < count; i++) {
+        element = &response->array_value[i];
+        if (element->response_type == Array && element->array_value_len == 2 &&
+            element->array_value[0].response_type == String &&
+            element->array_value[1].response_type == Array) {
+            if (!(slot = response_slot(conv, ht, &element->array_value[0]))) {
+                return false;
+            }
+            converted = shape_geo_tuple(conv, &element->array_value[1], slot, depth + 1);
+        } else if (element->response_type == Array) {
+            converted = shape_geo_tuple(conv, element, response_append(ht), depth + 1);
+        } else {
+            converted = response_convert(
+                conv, element, response_append(ht), COMMAND_RESPONSE_NOT_ASSOSIATIVE, depth + 1);
+        }
+        if (!converted) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* ZMPOP [key, members] to [key, [member => score]], and BZPOPMIN [key, member, score] with the
+ * score as a string */
+static bool shape_popped(response_converter* conv,
+                         CommandResponse*    response,
+                         zval*               out,
+                         uint32_t            depth) {
+    int64_t          count = response->array_value_len;
+    CommandResponse* element;
+    HashTable*       ht;
+    zval*            slot;
+    bool             converted;
+
+    if (!response_array(conv, out, count, count, true, depth)) {
+        return false;
+    }
+    ht = Z_ARRVAL_P(out);
+
+    for (int64_t i = 0; i < count; i++) {
+        element = &response->array_value[i];
+        slot    = response_append(ht);
+        if (i != 1) {
+            converted = response_convert(
+                conv, element, slot, COMMAND_RESPONSE_NOT_ASSOSIATIVE, depth + 1);
+            if (i == 2 && (Z_TYPE_P(slot) == IS_LONG || Z_TYPE_P(slot) == IS_DOUBLE)) {
+                convert_to_string(slot);
+            }
+        } else if (element->response_type == Map || element->response_type == Array) {
+            converted = shape_assoc(conv,
+                                    element,
+                                    slot,
+                                    element->response_type == Array && !shape_has_pairs(element),
+                                    SHAPE_PAIR_SCORE,
+                                    depth + 1);
+        } else {
+            converted = shape_value(conv, element, slot, depth + 1);
+        }
+        if (!converted) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Convert response into out in the given shape, or as it is when it does not have it */
+static bool shape_convert(response_converter* conv,
+                          CommandResponse*    response,
+                          response_shape      shape,
+                          zval*               out) {
+    bool map = response->response_type == Map;
+
+    ZVAL_NULL(out);
+    switch (shape) {
+        case RESPONSE_SHAPE_PAIRS:
+            if (map || shape_has_pairs(response)) {
+                return shape_assoc(conv, response, out, false, SHAPE_PAIR_VALUE, 0);
             }
             break;
-        case Null:
-            /* If the response is Null, set output to NULL */
-            // printf("%s:%d - DEBUG: Response is Null\n", __FILE__, __LINE__);
-            array_init(output);
+        case RESPONSE_SHAPE_SCORES:
+            if (map || shape_has_pairs(response)) {
+                return shape_assoc(conv, response, out, false, SHAPE_PAIR_SCORE, 0);
+            }
+            return shape_values(conv, response, out, 0);
+        case RESPONSE_SHAPE_FLAT_PAIRS:
+        case RESPONSE_SHAPE_FLAT_SCORES:
+        case RESPONSE_SHAPE_FLAT_MEMBERS:
+            if (map || response->response_type == Array) {
+                return shape_assoc(conv,
+                                   response,
+                                   out,
+                                   true,
+                                   shape == RESPONSE_SHAPE_FLAT_PAIRS    ? SHAPE_PAIR_VALUE
+                                   : shape == RESPONSE_SHAPE_FLAT_SCORES ? SHAPE_PAIR_SCORE
+                                                                         : SHAPE_PAIR_MEMBER,
+                                   0);
+            }
+            break;
+        case RESPONSE_SHAPE_VALUES:
+            return shape_values(conv, response, out, 0);
+        case RESPONSE_SHAPE_POPPED:
+            if (response->response_type == Array) {
+                return shape_popped(conv, response, out, 0);
+            }
+            break;
+        case RESPONSE_SHAPE_STREAM:
+            if (map || shape_has_pairs(response)) {
+                return shape_stream(conv, response, out, 0);
+            }
+            break;
+        case RESPONSE_SHAPE_GEO:
+            if (response->response_type == Array) {
+                return shape_geo(conv, response, out, 0);
+            }
+            break;
+        default:
             break;
+    }
+    return response_convert(conv, response, out, COMMAND_RESPONSE_NOT_ASSOSIATIVE, 0);
+}
 
+response_shape command_response_shape(enum RequestType type) {
+    switch (type) {
+        case ZRange:
+        case ZRangeByScore:
+        case ZRevRangeByScore:
+        case ZRangeByLex:
+        case ZRandMember:
+        case ZPopMin:
+        case ZPopMax:
+        case ZUnion:
+        case ZInter:
+        case ZDiff:
+            return RESPONSE_SHAPE_SCORES;
+        case ZMPop:
+        case BZMPop:
+        case BZPopMin:
+        case BZPopMax:
+            return RESPONSE_SHAPE_POPPED;
+        case HRandField:
+            return RESPONSE_SHAPE_PAIRS;
+        case XRange:
+        case XRevRange:
+        case XRead:
+        case XReadGroup:
+        case XClaim:
+            return RESPONSE_SHAPE_STREAM;
+        case GeoPos:
+        case GeoSearch:
+            return RESPONSE_SHAPE_GEO;
         default:
-            zval_dtor(output); /* Clean up the initialized array */
-            ZVAL_NULL(output);
+            return RESPONSE_SHAPE_NONE;
+    }
+}
+
+static int shape_to_zval(CommandResponse* response,
+                         response_shape   shape,
+                         zval*            output,
+                         bool             use_false_if_null,
+                         bool             values) {
+    response_converter conv;
+    bool               converted;
+
+    if (!response) {
+        ZVAL_NULL(output);
+        return 0;
+    }
+
+    response_converter_init(&conv, use_false_if_null);
+    conv.values = values && valkey_glide_options_encode_values(conv.options);
+    if (shape == RESPONSE_SHAPE_NONE && conv.values) {
+        /* A stored value, or a list of them */
+        shape = RESPONSE_SHAPE_VALUES;
+    }
+    if (shape == RESPONSE_SHAPE_NONE) {
+        converted = response_convert(&conv, response, output, COMMAND_RESPONSE_NOT_ASSOSIATIVE, 0);
+    } else {
+        converted = shape_convert(&conv, response, shape, output);
+    }
+    response_converter_free(&conv);
+
+    if (!converted) {
+        zval_ptr_dtor(output);
+        ZVAL_NULL(output);
+        zend_throw_exception_ex(get_valkey_glide_exception_ce(), 0, "Reply %s", conv.error);
+        return 0;
+    }
+    switch (response->response_type) {
+        case Null:
             return 0;
+        case Int:
+        case Float:
+        case Bool:
+        case String:
+        case Array:
+        case Map:
+        case Sets:
+        case Ok:
+            return 1;
+        default:
+            return -1;
     }
+}
 
-    return 1;
+int command_response_to_shape_zval(CommandResponse* response,
+                                   response_shape   shape,
+                                   zval*            output,
+                                   bool             use_false_if_null) {
+    return shape_to_zval(response, shape, output, use_false_if_null, false);
+}
+
+int command_response_to_values_zval(CommandResponse* response,
+                                    response_shape   shape,
+                                    zval*            output,
+                                    bool             use_false_if_null) {
+    return shape_to_zval(response, shape, output, use_false_if_null, true);
+}
+
+/* Convert stream entries to ["stream_id" => ["field1" => "value1", ...]], or a null reply to an
+ * empty array, the values unserialized. Returns 0 with a null output for replies that are not
+ * entries. */
+int command_response_to_stream_zval(CommandResponse* response, zval* output) {
+    if (!response || (response->response_type != Map && response->response_type != Array &&
+                      response->response_type != Null)) {
+        ZVAL_NULL(output);
+        return 0;
+    }
+    if (response->response_type == Null) {
+        array_init(output);
+        return 1;
+    }
+    return command_response_to_values_zval(response, RESPONSE_SHAPE_STREAM, output, false);
 }
 
 /**
@@ -1076,17 +1409,3 @@ char* zval_to_string_safe(zval* z, size_t* len, int* need_free) {
 
     return str;
 }
-
-/**
- * Free array of allocated strings
- */
-void free_allocated_strings(char** strings, int count) {
-    if (!strings)
-        return;
-
-    for (int i = 0; i < count; i++) {
-        if (strings[i]) {
-            efree(strings[i]);
-        }
-    }
-}
@@ -27,8 +27,6 @@
 enum CommandResponseToZvalFlags {
     COMMAND_RESPONSE_NOT_ASSOSIATIVE       = 0,
     COMMAND_RESPONSE_ASSOSIATIVE_ARRAY_MAP = 1,  // Use associative array format for Map elements
-    COMMAND_RESPONSE_STREAM_ARRAY_ASSOCIATIVE =
-        2,  // Use associative array format for stream entries
     COMMAND_RESPONSE_SCAN_ASSOSIATIVE_ARRAY = 3,
     COMMAND_RESPONSE_ASSOSIATIVE_ARRAY_MAP_FUNCTION =
         4  // Use associative array format for FUNCTION command responses
@@ -44,6 +42,15 @@ CommandResult* execute_command(const void*          glide_client,
                                const uintptr_t*     args,
                                const unsigned long* args_len);
 
+/* Number of hash slots in a cluster */
+#define VALKEY_GLIDE_CLUSTER_SLOTS 16384
+
+/*
+ * Compute the cluster hash slot of a key or shard channel name, using only the hash tag when
+ * the name contains a non-empty {...} section.
+ */
+uint16_t valkey_glide_key_slot(const char* key, size_t key_len);
+
 CommandResult* execute_command_with_route(const void*          glide_client,
                                           enum RequestType     command_type,
                                           unsigned long        arg_count,
@@ -106,9 +113,16 @@ int handle_map_response(CommandResult* result, zval* output);
  */
 int handle_set_response(CommandResult* result, zval* output);
 
+/* Limits of a reply conversion, past which command_response_to_zval() throws */
+#define VALKEY_GLIDE_RESPONSE_MAX_DEPTH 128
+#define VALKEY_GLIDE_RESPONSE_MAX_ELEMENTS (16 * 1024 * 1024)
+
 /*
  * Helper function to convert a CommandResponse to a PHP value
  * Returns 1 on success, 0 if null, -1 on error
+ * A reply nested deeper than VALKEY_GLIDE_RESPONSE_MAX_DEPTH, with more elements than
+ * VALKEY_GLIDE_RESPONSE_MAX_ELEMENTS or too large for memory_limit throws a ValkeyGlideException
+ * and returns 0
  * The output parameter is set to the PHP value
  * use_associative_array:
  * - 0: regular array processing
@@ -137,10 +151,57 @@ char* double_to_string(double value, size_t* len);
  * Helper function to convert a CommandResponse to a PHP stream format
  * This is specifically for XRANGE/XREVRANGE commands that return stream entries
  * Returns 1 on success, 0 if null, -1 on error
- * The output parameter is set to a PHP associative array with stream IDs as keys
+ * The output parameter is set to a PHP associative array with stream IDs as keys, the field
+ * values unserialized as the client's OPT_SERIALIZER and OPT_COMPRESSION say
  */
 int command_response_to_stream_zval(CommandResponse* response, zval* output);
 
+/*
+ * Shapes of replies that are reshaped on their way to PHP.
+ * The decoder of a shape builds the final PHP value in the same pass that converts the reply,
+ * rather than converting it as it came and rebuilding the array afterwards. A reply that does
+ * not have the shape (a plain list of members without WITHSCORES, a null, ...) is converted as
+ * command_response_to_zval() would.
+ */
+typedef enum {
+    RESPONSE_SHAPE_NONE = 0,
+    RESPONSE_SHAPE_PAIRS,        /* {k: v} or [[k, v], ...] to [k => v] */
+    RESPONSE_SHAPE_FLAT_PAIRS,   /* [k, v, k, v, ...] to [k => v] */
+    RESPONSE_SHAPE_SCORES,       /* As PAIRS, with the values as floats (WITHSCORES) */
+    RESPONSE_SHAPE_FLAT_SCORES,  /* As FLAT_PAIRS, with the values as floats */
+    RESPONSE_SHAPE_FLAT_MEMBERS, /* As FLAT_PAIRS, with the keys as members (ZSCAN) */
+    RESPONSE_SHAPE_STREAM,       /* Entries to [id => [field => value]], per stream for XREAD */
+    RESPONSE_SHAPE_GEO,          /* GEOPOS and GEOSEARCH WITH* tuples, numbers as floats */
+    RESPONSE_SHAPE_VALUES,       /* A list of stored values, or a single one */
+    RESPONSE_SHAPE_POPPED        /* ZMPOP [key, [member => score]], BZPOPMIN [key, member, score] */
+} response_shape;
+
+/*
+ * The shape command replies to type are given in, RESPONSE_SHAPE_NONE for replies that are
+ * returned as they come
+ */
+response_shape command_response_shape(enum RequestType type);
+
+/*
+ * Convert a CommandResponse to a PHP value of the given shape
+ * Returns as command_response_to_zval(), and throws on the same limits
+ */
+int command_response_to_shape_zval(CommandResponse* response,
+                                   response_shape   shape,
+                                   zval*            output,
+                                   bool             use_false_if_null);
+
+/*
+ * As command_response_to_shape_zval(), with the stored values of the reply unserialized and
+ * decompressed as the client's OPT_SERIALIZER and OPT_COMPRESSION say: the members of the
+ * sorted set shapes (also the keys of member => score), the values of field => value pairs,
+ * and the elements of RESPONSE_SHAPE_NONE and RESPONSE_SHAPE_VALUES replies.
+ */
+int command_response_to_values_zval(CommandResponse* response,
+                                    response_shape   shape,
+                                    zval*            output,
+                                    bool             use_false_if_null);
+
 /* Utility functions */
 /**
  * Safe zval to string conversion with memory management
@@ -149,6 +210,5 @@ int command_response_to_stream_zval(CommandResponse* response, zval* output);
  */
 
 char* zval_to_string_safe(zval* z, size_t* len, int* need_free);
-void  free_allocated_strings(char** strings, int count);
 
 #endif /* COMMAND_RESPONSE_H */
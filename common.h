@@ -43,6 +43,27 @@
 #define MULTI 1
 #define PIPELINE 2
 
+/* setOption()/getOption() options, numbered as in phpredis */
+#define VALKEY_GLIDE_OPT_SERIALIZER 1
+#define VALKEY_GLIDE_OPT_PREFIX 2
+#define VALKEY_GLIDE_OPT_COMPRESSION 7
+#define VALKEY_GLIDE_OPT_COMPRESSION_LEVEL 9
+#define VALKEY_GLIDE_OPT_NULL_MULTIBULK_AS_NULL 10
+#define VALKEY_GLIDE_OPT_COMPRESSION_MIN_SIZE 100 /* Not a phpredis option */
+#define VALKEY_GLIDE_OPT_LAZY_RESULTS 101         /* Not a phpredis option */
+
+/* Value serializers */
+#define VALKEY_GLIDE_SERIALIZER_NONE 0
+#define VALKEY_GLIDE_SERIALIZER_PHP 1
+#define VALKEY_GLIDE_SERIALIZER_IGBINARY 2
+#define VALKEY_GLIDE_SERIALIZER_MSGPACK 3
+#define VALKEY_GLIDE_SERIALIZER_JSON 4
+
+/* Value compression algorithms, numbered as in phpredis (which also has LZF = 1) */
+#define VALKEY_GLIDE_COMPRESSION_NONE 0
+#define VALKEY_GLIDE_COMPRESSION_ZSTD 2
+#define VALKEY_GLIDE_COMPRESSION_LZ4 3
+
 /* ValkeyGlide Configuration Enums */
 typedef enum {
     VALKEY_GLIDE_READ_FROM_PRIMARY                          = 0,
@@ -87,9 +108,20 @@ typedef struct {
     bool use_insecure_tls; /* false if not set */
 } valkey_glide_tls_advanced_configuration_t;
 
+typedef struct {
+    zend_long  max_memory; /* In bytes */
+    bool       lfu;        /* Evict the least frequently used entries instead of the oldest */
+    bool       bcast;      /* CLIENT TRACKING BCAST instead of tracking the keys read */
+    HashTable* prefixes;   /* BCAST prefixes, NULL for every key; borrowed from the ctor args */
+} valkey_glide_cache_configuration_t;
+
 typedef struct {
     int                                        connection_timeout; /* In milliseconds. */
     valkey_glide_tls_advanced_configuration_t* tls_config;         /* NULL if not set */
+    HashTable* pubsub_subscriptions; /* NULL if not set, borrowed from the constructor args */
+    zend_long  pubsub_buffer_size;   /* 0 if not set */
+    valkey_glide_cache_configuration_t* client_side_cache; /* NULL if not set */
+    zend_long shared_cache_ttl; /* Shared GET cache TTL in milliseconds, 0 if not set */
 } valkey_glide_advanced_base_client_configuration_t;
 
 typedef struct {
@@ -109,6 +141,8 @@ typedef struct {
     char*                                              client_az;       /* NULL if not set */
     valkey_glide_advanced_base_client_configuration_t* advanced_config; /* NULL if not set */
     bool                                               lazy_connect;    /* false if not set */
+    char*                                              persistent_id;   /* NULL if not pooled */
+    size_t                                             persistent_id_len;
 } valkey_glide_base_client_configuration_t;
 
 typedef struct {
@@ -147,6 +181,8 @@ typedef struct {
     zval*     advanced_config;
     zend_bool lazy_connect;
     zend_bool lazy_connect_is_null;
+    char*     persistent_id;
+    size_t    persistent_id_len;
 } valkey_glide_php_common_constructor_params_t;
 
 void valkey_glide_init_common_constructor_params(
@@ -166,16 +202,90 @@ void valkey_glide_cleanup_client_config(valkey_glide_base_client_configuration_t
 /* Batch command structure for buffering commands - FFI aligned */
 struct batch_command {
     enum RequestType request_type;
-    uint8_t**        args;        /* FFI expects uint8_t** */
-    uintptr_t*       arg_lengths; /* FFI expects uintptr_t* */
-    uintptr_t        arg_count;   /* FFI expects uintptr_t */
-    char*            key;         /* Optional key for the command */
-    size_t           key_len;
-    void*            route_info; /* Optional routing info for cluster mode */
+    size_t           first_arg;    /* Index of its first argument in the batch arena */
+    uintptr_t        arg_count;    /* FFI expects uintptr_t */
+    size_t           route_offset; /* Packed route in the bytes of the arena, for cluster mode */
+    size_t           route_len;    /* 0 when the command is routed by its keys */
+
+    /* Reply conversion of the method that buffered it, and the argument its reply is keyed by
+     * (the HMGET fields), IS_UNDEF if none */
+    const struct valkey_glide_batch_method* method;
+    zval                                    reply_keys;
+};
+
+/* Arguments of the buffered commands: one byte buffer and an offset per argument, kept with
+ * their capacity from one batch to the next */
+struct batch_arena {
+    char*                  bytes;
+    size_t                 bytes_len;
+    size_t                 bytes_capacity;
+    size_t*                offsets;      /* Offset of each argument in bytes */
+    uintptr_t*             lengths;      /* FFI expects uintptr_t* */
+    const uint8_t**        args;         /* Pointers into bytes, resolved by exec() */
+    size_t                 arg_count;
+    size_t                 arg_capacity;
+    struct CmdInfo*        cmd_infos;    /* Built once per exec(), command_capacity long */
+    const struct CmdInfo** cmd_info_ptrs;
+    size_t                 keyed_count;  /* Buffered commands with reply_keys set */
+    size_t                 routed_count; /* Buffered commands with a route of their own */
 };
 
+/* Options of the next exec(), given to pipeline() or exec() */
+struct batch_options {
+    bool     raise_on_error;
+    bool     retry_server_error;
+    bool     retry_connection_error;
+    uint32_t timeout; /* Milliseconds, 0 for the request timeout of the client */
+};
+
+/* Client options set with setOption() */
 typedef struct {
-    const void* glide_client; /* Valkey Glide client pointer */
+    int          serializer; /* VALKEY_GLIDE_SERIALIZER_* */
+    zend_string* prefix;     /* Prepended to every key, NULL if not set */
+    bool         null_multibulk_as_null;
+    int          compression;          /* VALKEY_GLIDE_COMPRESSION_* */
+    int          compression_level;    /* 0 for the default of the algorithm */
+    zend_long    compression_min_size; /* Shorter values are stored as they are */
+    zend_long    lazy_results;         /* Replies this long are lazy, 0 for never */
+} valkey_glide_options_t;
+
+typedef struct {
+    const void* glide_client;  /* Valkey Glide client pointer */
+    bool        is_persistent; /* glide_client is borrowed from the persistent pool */
+
+    /* Pool glide_client goes back to when the object is freed, when is_persistent */
+    struct valkey_glide_pool_entry* pool_entry;
+
+    /* Connection state a pooled client is reset to before it is lent again */
+    zend_long database;          /* Database of the connection request */
+    zend_long selected_database; /* Database chosen with select(), database until then */
+    bool      watching;          /* WATCH sent since the last UNWATCH */
+
+    /* Serialized connection request, kept to open secondary (async) connections */
+    uint8_t* connection_request;
+    size_t   connection_request_len;
+    int      inflight_requests_limit; /* -1 if not set */
+
+    /* Async client state, created on the first call to async() */
+    struct valkey_glide_async_context* async_ctx;
+
+    /* Pub/Sub message buffer, owned by the client registry (kept with a pooled client) */
+    struct valkey_glide_pubsub_state* pubsub;
+
+    /* Client-side cache of read command replies, NULL unless enabled */
+    struct valkey_glide_cache* cache;
+
+    /* Packed by-address routes, NULL until a command is routed by address */
+    struct valkey_glide_route_cache* route_cache;
+
+    /* Shared GET cache, used when shared_cache_ttl is not 0 */
+    uint64_t  shared_cache_ns; /* Namespace of the connection settings */
+    zend_long shared_cache_ttl;
+
+    valkey_glide_options_t options;
+
+    /* Message of the last failed command, for getLastError(); NULL if none */
+    zend_string* last_error;
 
     /* Batch mode tracking */
     bool is_in_batch_mode;
@@ -185,6 +295,11 @@ typedef struct {
     struct batch_command* buffered_commands;
     size_t                command_count;
     size_t                command_capacity;
+    struct batch_arena    batch_arena;
+    struct batch_options  batch_options;
+
+    /* Method of the batch table whose handler is running, NULL when not recording */
+    const struct valkey_glide_batch_method* batch_method;
 
     zend_object std;
 } valkey_glide_object;
@@ -211,6 +326,8 @@ PHP_MINFO_FUNCTION(redis);
 
 zend_class_entry* get_valkey_glide_ce(void);
 zend_class_entry* get_valkey_glide_exception_ce(void);
+zend_class_entry* get_valkey_glide_timeout_exception_ce(void);
+zend_class_entry* get_valkey_glide_connection_exception_ce(void);
 
 zend_class_entry* get_valkey_glide_cluster_ce(void);
 zend_class_entry* get_valkey_glide_cluster_exception_ce(void);
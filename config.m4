@@ -4,6 +4,18 @@ PHP_ARG_ENABLE(valkey_glide, whether to enable Valkey Glide support,
 PHP_ARG_ENABLE(valkey_glide_asan, whether to enable AddressSanitizer for Valkey Glide,
 [  --enable-valkey-glide-asan   Enable AddressSanitizer for debugging (requires clang/gcc with ASAN support)], no, no)
 
+PHP_ARG_ENABLE(valkey_glide_igbinary, whether to enable the igbinary serializer for Valkey Glide,
+[  --enable-valkey-glide-igbinary   Enable ValkeyGlide::SERIALIZER_IGBINARY (requires the igbinary extension)], no, no)
+
+PHP_ARG_ENABLE(valkey_glide_msgpack, whether to enable the msgpack serializer for Valkey Glide,
+[  --enable-valkey-glide-msgpack   Enable ValkeyGlide::SERIALIZER_MSGPACK (requires the msgpack extension)], no, no)
+
+PHP_ARG_ENABLE(valkey_glide_lz4, whether to enable LZ4 compression for Valkey Glide,
+[  --enable-valkey-glide-lz4   Enable ValkeyGlide::COMPRESSION_LZ4 (requires liblz4)], no, no)
+
+PHP_ARG_ENABLE(valkey_glide_zstd, whether to enable Zstandard compression for Valkey Glide,
+[  --enable-valkey-glide-zstd   Enable ValkeyGlide::COMPRESSION_ZSTD (requires libzstd)], no, no)
+
 if test "$PHP_VALKEY_GLIDE" != "no"; then
 
   dnl Check if ASAN is enabled
@@ -44,6 +56,30 @@ if test "$PHP_VALKEY_GLIDE" != "no"; then
     PHP_VALKEY_GLIDE_LDFLAGS=""
   fi
 
+  dnl Optional serializers, provided by other extensions
+  if test "$PHP_VALKEY_GLIDE_IGBINARY" = "yes"; then
+    AC_DEFINE([HAVE_VALKEY_GLIDE_IGBINARY], [1], [Define if the igbinary serializer is enabled])
+  fi
+  if test "$PHP_VALKEY_GLIDE_MSGPACK" = "yes"; then
+    AC_DEFINE([HAVE_VALKEY_GLIDE_MSGPACK], [1], [Define if the msgpack serializer is enabled])
+  fi
+
+  dnl Optional compression libraries, linked through Makefile.frag
+  VALKEY_GLIDE_COMPRESSION_LIBS=""
+  if test "$PHP_VALKEY_GLIDE_LZ4" = "yes"; then
+    AC_CHECK_HEADER([lz4hc.h], [], [AC_MSG_ERROR([lz4hc.h not found, install liblz4])])
+    AC_CHECK_LIB([lz4], [LZ4_compress_HC], [], [AC_MSG_ERROR([liblz4 not found])])
+    AC_DEFINE([HAVE_VALKEY_GLIDE_LZ4], [1], [Define if LZ4 compression is enabled])
+    VALKEY_GLIDE_COMPRESSION_LIBS="$VALKEY_GLIDE_COMPRESSION_LIBS -llz4"
+  fi
+  if test "$PHP_VALKEY_GLIDE_ZSTD" = "yes"; then
+    AC_CHECK_HEADER([zstd.h], [], [AC_MSG_ERROR([zstd.h not found, install libzstd])])
+    AC_CHECK_LIB([zstd], [ZSTD_getFrameContentSize], [], [AC_MSG_ERROR([libzstd not found])])
+    AC_DEFINE([HAVE_VALKEY_GLIDE_ZSTD], [1], [Define if Zstandard compression is enabled])
+    VALKEY_GLIDE_COMPRESSION_LIBS="$VALKEY_GLIDE_COMPRESSION_LIBS -lzstd"
+  fi
+  PHP_SUBST(VALKEY_GLIDE_COMPRESSION_LIBS)
+
   dnl Apply the flags to the extension
   if test -n "$PHP_VALKEY_GLIDE_CFLAGS"; then
     CFLAGS="$CFLAGS $PHP_VALKEY_GLIDE_CFLAGS"
@@ -52,10 +88,17 @@ if test "$PHP_VALKEY_GLIDE" != "no"; then
     LDFLAGS="$LDFLAGS $PHP_VALKEY_GLIDE_LDFLAGS"
   fi
   PHP_NEW_EXTENSION(valkey_glide,
-    valkey_glide.c valkey_glide_cluster.c cluster_scan_cursor.c command_response.c logger.c valkey_glide_commands.c valkey_glide_commands_2.c valkey_glide_commands_3.c valkey_glide_core_commands.c valkey_glide_core_common.c valkey_glide_expire_commands.c valkey_glide_geo_commands.c valkey_glide_geo_common.c valkey_glide_hash_common.c valkey_glide_list_common.c valkey_glide_s_common.c valkey_glide_str_commands.c valkey_glide_x_commands.c valkey_glide_x_common.c valkey_glide_z.c valkey_glide_z_common.c valkey_z_php_methods.c src/command_request.pb-c.c src/connection_request.pb-c.c src/response.pb-c.c tests/client_constructor_mock.c,
+    valkey_glide.c valkey_glide_arena.c valkey_glide_args.c valkey_glide_cluster.c cluster_scan_cursor.c command_response.c logger.c valkey_glide_commands.c valkey_glide_commands_2.c valkey_glide_commands_3.c valkey_glide_compression.c valkey_glide_core_commands.c valkey_glide_core_common.c valkey_glide_errors.c valkey_glide_options.c valkey_glide_pool.c valkey_glide_async.c valkey_glide_batch.c valkey_glide_batch_template.c valkey_glide_cache.c valkey_glide_pubsub.c valkey_glide_result.c valkey_glide_route.c valkey_glide_script.c valkey_glide_shm_cache.c valkey_glide_expire_commands.c valkey_glide_format.c valkey_glide_geo_commands.c valkey_glide_geo_common.c valkey_glide_hash_common.c valkey_glide_list_common.c valkey_glide_s_common.c valkey_glide_str_commands.c valkey_glide_x_commands.c valkey_glide_x_common.c valkey_glide_z.c valkey_glide_z_common.c valkey_z_php_methods.c src/command_request.pb-c.c src/connection_request.pb-c.c src/response.pb-c.c tests/client_constructor_mock.c tests/response_decoder_bench.c,
     $ext_shared)
 
-  EXTRA_DIST="$EXTRA_DIST valkey_glide.stub.php valkey_glide_cluster.stub.php logger.stub.php"
+  if test "$PHP_VALKEY_GLIDE_IGBINARY" = "yes"; then
+    PHP_ADD_EXTENSION_DEP(valkey_glide, igbinary)
+  fi
+  if test "$PHP_VALKEY_GLIDE_MSGPACK" = "yes"; then
+    PHP_ADD_EXTENSION_DEP(valkey_glide, msgpack)
+  fi
+
+  EXTRA_DIST="$EXTRA_DIST valkey_glide.stub.php valkey_glide_cluster.stub.php valkey_glide_async.stub.php valkey_glide_batch_template.stub.php valkey_glide_result.stub.php valkey_glide_route.stub.php valkey_glide_script.stub.php logger.stub.php"
   AC_SUBST(EXTRA_DIST)
 fi
 
@@ -300,6 +300,50 @@ class ConnectionRequestTest extends \TestSuite
         $this->assertEquals(999, $request->getConnectionTimeout());
     }
 
+    public function testStandaloneInflightRequestsLimit() {
+        $request = ClientConstructorMock::simulate_standalone_constructor(
+            addresses: [['host' => 'localhost', 'port' => 8080]],
+            advanced_config: ['inflight_requests_limit' => 250]);
+
+        $this->assertEquals(250, $request->getInflightRequestsLimit());
+    }
+
+    public function testClusterInflightRequestsLimit() {
+        $request = ClientConstructorMock::simulate_cluster_constructor(
+            addresses: [['host' => 'localhost', 'port' => 8080]],
+            advanced_config: ['inflight_requests_limit' => 250]);
+
+        $this->assertEquals(250, $request->getInflightRequestsLimit());
+    }
+
+    public function testStandalonePubSubSubscriptions() {
+        $request = ClientConstructorMock::simulate_standalone_constructor(
+            addresses: [['host' => 'localhost', 'port' => 8080]],
+            advanced_config: ['pubsub_subscriptions' => ['channels' => ['news', 'alerts'],
+                                                          'patterns' => ['user.*']]]);
+
+        $subscriptions = $request->getPubsubSubscriptions()->getChannelsOrPatternsByType();
+        $this->assertEquals(2, count($subscriptions));
+        $this->assertEquals(['news', 'alerts'], iterator_to_array(
+            $subscriptions[\Connection_request\PubSubChannelType::Exact]->getChannelsOrPatterns()));
+        $this->assertEquals(['user.*'], iterator_to_array(
+            $subscriptions[\Connection_request\PubSubChannelType::Pattern]->getChannelsOrPatterns()));
+    }
+
+    public function testClusterPubSubSubscriptions() {
+        $request = ClientConstructorMock::simulate_cluster_constructor(
+            addresses: [['host' => 'localhost', 'port' => 8080]],
+            advanced_config: ['pubsub_subscriptions' => ['channels' => ['news'],
+                                                          'sharded' => ['orders']]]);
+
+        $subscriptions = $request->getPubsubSubscriptions()->getChannelsOrPatternsByType();
+        $this->assertEquals(2, count($subscriptions));
+        $this->assertEquals(['news'], iterator_to_array(
+            $subscriptions[\Connection_request\PubSubChannelType::Exact]->getChannelsOrPatterns()));
+        $this->assertEquals(['orders'], iterator_to_array(
+            $subscriptions[\Connection_request\PubSubChannelType::Sharded]->getChannelsOrPatterns()));
+    }
+
     public function testStandaloneInsecureTls() {
         $request = ClientConstructorMock::simulate_standalone_constructor(
             addresses: [['host' => 'localhost', 'port' => 8080]],
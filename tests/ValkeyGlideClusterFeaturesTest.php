@@ -618,4 +618,151 @@ class ValkeyGlideClusterFeaturesTest extends ValkeyGlideClusterBaseTest
             echo "WARNING: Significant memory growth detected: " . round($memoryGrowth / 1024 / 1024, 2) . " MB\n";
         }
     }
+
+    public function testShardedPubSub()
+    {
+        $subscriber = $this->newInstance();
+        $publisher = $this->newInstance();
+
+        // Channels spread over different slots, two of them sharing a hash tag
+        $id = uniqid();
+        $channels = ["orders-$id", "users-$id", "{shard-$id}a", "{shard-$id}b"];
+
+        $this->assertEquals([], $subscriber->getMessages());
+        $this->assertTrue($subscriber->ssubscribe($channels));
+
+        foreach ($channels as $channel) {
+            $this->assertEquals(1, $publisher->spublish($channel, "to $channel"));
+        }
+
+        // Messages from every shard end up in the same buffer
+        $messages = [];
+        $deadline = microtime(true) + 5;
+        while (count($messages) < count($channels) && microtime(true) < $deadline) {
+            $messages = array_merge($messages, $subscriber->getMessages(100, 0.5));
+        }
+        $this->assertEquals(count($channels), count($messages));
+
+        $by_channel = [];
+        foreach ($messages as $message) {
+            $this->assertEquals('smessage', $message['kind']);
+            $this->assertEquals("to {$message['channel']}", $message['message']);
+            $this->assertTrue($message['slot'] >= 0 && $message['slot'] < 16384);
+            $by_channel[$message['channel']] = $message;
+        }
+        $this->assertEquals($by_channel["{shard-$id}a"]['slot'], $by_channel["{shard-$id}b"]['slot']);
+
+        // Unsubscribing from everything reaches every shard
+        $this->assertTrue($subscriber->sunsubscribe());
+        foreach ($channels as $channel) {
+            $this->assertEquals(0, $publisher->spublish($channel, 'late'));
+        }
+        $this->assertEquals([], $subscriber->getMessages(100, 0.2));
+
+        $subscriber->close();
+        $publisher->close();
+    }
+
+    public function testScriptNoScriptFallback()
+    {
+        $valkey_glide = $this->newInstance();
+        $script = new ValkeyGlideScript("return redis.call('incr', KEYS[1])");
+        $id = uniqid();
+        $keys = ["script-a-$id", "script-b-$id", "script-c-$id", "script-d-$id"];
+
+        // Every node misses once, after which the script is loaded everywhere
+        $this->assertTrue($valkey_glide->script('allNodes', 'flush'));
+        foreach ($keys as $key) {
+            $this->assertEquals(1, $script->run($valkey_glide, [$key]));
+        }
+        $this->assertEquals([true], $valkey_glide->script('allNodes', 'exists', $script->getSha1()));
+
+        foreach ($keys as $key) {
+            $this->assertEquals(2, $valkey_glide->evalsha($script->getSha1(), [$key], 1));
+        }
+
+        $valkey_glide->del($keys);
+        $valkey_glide->close();
+    }
+
+    public function testRouteObject()
+    {
+        $valkey_glide = $this->newInstance();
+        $key = 'route-' . uniqid();
+
+        // Built once, then passed wherever a route is taken
+        $by_key = new ValkeyGlideRoute(['type' => 'primarySlotKey', 'key' => $key]);
+        $by_address = new ValkeyGlideRoute(['127.0.0.1', 7001]);
+        for ($i = 0; $i < 3; $i++) {
+            $this->assertTrue($valkey_glide->ping($by_key));
+            $this->assertEquals('BEEP', $valkey_glide->ping($by_address, 'BEEP'));
+        }
+        $this->assertEquals($valkey_glide->dbSize('allPrimaries'),
+                            $valkey_glide->dbSize(new ValkeyGlideRoute('allPrimaries')));
+
+        // By-address arrays are packed once per client, the answer does not change
+        for ($i = 0; $i < 3; $i++) {
+            $this->assertEquals('BEEP', $valkey_glide->ping(['host' => '127.0.0.1', 'port' => 7001], 'BEEP'));
+        }
+
+        $this->assertThrowsMatch([], function ($route) { new ValkeyGlideRoute($route); }, '/Invalid route/');
+        $this->assertThrowsMatch('', function ($route) { new ValkeyGlideRoute($route); }, '/Invalid route/');
+        $this->assertThrowsMatch(['type' => 'routeByAddress'], function ($route) {
+            new ValkeyGlideRoute($route);
+        }, '/Invalid route/');
+
+        $valkey_glide->close();
+    }
+
+    public function testCrossSlotPipeline()
+    {
+        $valkey_glide = $this->newInstance();
+        $key = 'cross-slot-' . uniqid();
+
+        // Keys of many slots in one pipeline, replies in the order of the commands
+        $batch = $valkey_glide->pipeline();
+        for ($i = 0; $i < 300; $i++) {
+            $batch->set("$key-$i", "v$i");
+        }
+        for ($i = 0; $i < 300; $i++) {
+            $batch->get("$key-$i");
+        }
+        $ret = $batch->exec();
+        $this->assertEquals(600, count($ret));
+        for ($i = 0; $i < 300; $i++) {
+            $this->assertTrue($ret[$i]);
+            $this->assertEquals("v$i", $ret[300 + $i]);
+        }
+
+        // Commands with a route of their own stay in their place
+        $ret = $valkey_glide->pipeline()
+            ->get("$key-0")
+            ->echo(['127.0.0.1', 7001], 'by-address')
+            ->get("$key-1")
+            ->echo(new ValkeyGlideRoute(['type' => 'primarySlotKey', 'key' => $key]), 'by-key')
+            ->exec();
+        $this->assertEquals(['v0', 'by-address', 'v1', 'by-key'], $ret);
+
+        // A routed command that fails is false in its place, its error kept
+        $valkey_glide->clearLastError();
+        $ret = $valkey_glide->pipeline()
+            ->get("$key-0")
+            ->echo(['127.0.0.1', 1], 'unknown-node')
+            ->get("$key-1")
+            ->exec();
+        $this->assertEquals(['v0', false, 'v1'], $ret);
+        $this->assertIsString($valkey_glide->getLastError());
+
+        // The options of the batch apply to the routed commands as well
+        $ret = $valkey_glide->pipeline(['timeout' => 5000, 'retry_connection_error' => true])
+            ->get("$key-0")
+            ->echo(['127.0.0.1', 7001], 'with-options')
+            ->exec();
+        $this->assertEquals(['v0', 'with-options'], $ret);
+
+        for ($i = 0; $i < 300; $i++) {
+            $valkey_glide->del("$key-$i");
+        }
+        $valkey_glide->close();
+    }
 }
@@ -613,7 +613,6 @@ class ValkeyGlideClusterTest extends ValkeyGlideTest
      * we can direct it to a given node */
     public function testScript()
     {
-        $this->markTestSkipped();
         $key = uniqid() . '-' . rand(1, 1000);
 
         // Flush any scripts we have
@@ -646,7 +645,6 @@ class ValkeyGlideClusterTest extends ValkeyGlideTest
      * direct the command at */
     public function testEvalSHA()
     {
-        $this->markTestSkipped();
         $key = uniqid() . '-' . rand(1, 1000);
 
         // Flush any loaded scripts
@@ -669,7 +667,6 @@ class ValkeyGlideClusterTest extends ValkeyGlideTest
 
     public function testEvalBulkResponse()
     {
-        $this->markTestSkipped();
         $key1 = uniqid() . '-' . rand(1, 1000) . '{hash}';
         $key2 = uniqid() . '-' . rand(1, 1000) . '{hash}';
 
@@ -706,7 +703,6 @@ class ValkeyGlideClusterTest extends ValkeyGlideTest
 
     public function testEvalBulkEmptyResponse()
     {
-        $this->markTestSkipped();
         $key1 = uniqid() . '-' . rand(1, 1000) . '{hash}';
         $key2 = uniqid() . '-' . rand(1, 1000) . '{hash}';
 
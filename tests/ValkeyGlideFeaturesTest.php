@@ -895,4 +895,1151 @@ class ValkeyGlideFeaturesTest extends ValkeyGlideBaseTest
             echo "WARNING: Significant memory growth detected: " . round($memoryGrowth / 1024 / 1024, 2) . " MB\n";
         }
     }
+
+    public function testPersistentClientPool()
+    {
+        $addresses = [
+            ['host' => $this->getHost(), 'port' => $this->getPort()]
+        ];
+        $advancedConfig = $this->getTLS() ? ['tls_config' => ['use_insecure_tls' => true]] : null;
+        $persistentId = 'pool-test-' . uniqid();
+
+        $before = ValkeyGlide::getPersistentPoolStats();
+
+        // The first client with a new persistent_id misses the pool and creates the connection
+        $first = new ValkeyGlide($addresses, $this->getTLS(), advanced_config: $advancedConfig, persistent_id: $persistentId);
+        $this->assertTrue($first->ping());
+        $first->close();
+        unset($first);
+
+        $stats = ValkeyGlide::getPersistentPoolStats();
+        $this->assertEquals($before['misses'] + 1, $stats['misses']);
+        $this->assertEquals($before['hits'], $stats['hits']);
+        $this->assertEquals($before['connections'] + 1, $stats['connections']);
+
+        // Same persistent_id and configuration reuses the pooled connection
+        $second = new ValkeyGlide($addresses, $this->getTLS(), advanced_config: $advancedConfig, persistent_id: $persistentId);
+        $this->assertTrue($second->ping());
+
+        $stats = ValkeyGlide::getPersistentPoolStats();
+        $this->assertEquals($before['hits'] + 1, $stats['hits']);
+        $this->assertEquals($before['connections'] + 1, $stats['connections']);
+
+        // A different configuration under the same persistent_id gets its own connection
+        $third = new ValkeyGlide($addresses, $this->getTLS(), database_id: 1, advanced_config: $advancedConfig, persistent_id: $persistentId);
+        $this->assertTrue($third->ping());
+
+        $stats = ValkeyGlide::getPersistentPoolStats();
+        $this->assertEquals($before['misses'] + 2, $stats['misses']);
+        $this->assertEquals($before['connections'] + 2, $stats['connections']);
+    }
+
+    public function testAsyncCommands()
+    {
+        $addresses = [
+            ['host' => $this->getHost(), 'port' => $this->getPort()]
+        ];
+        $advancedConfig = ['inflight_requests_limit' => 8];
+        if ($this->getTLS()) {
+            $advancedConfig['tls_config'] = ['use_insecure_tls' => true];
+        }
+        $valkey_glide = new ValkeyGlide($addresses, $this->getTLS(), advanced_config: $advancedConfig);
+        $valkey_glide->del('{async}hash', '{async}counter');
+        $async = $valkey_glide->async();
+
+        // More commands than the inflight limit, the proxy applies backpressure
+        $futures = [];
+        for ($i = 0; $i < 32; $i++) {
+            $futures["key$i"] = $async->set("{async}key$i", "value$i");
+        }
+        $this->assertTrue($futures['key0'] instanceof ValkeyGlideFuture);
+
+        $results = ValkeyGlide::awaitAll($futures);
+        $this->assertEquals(array_keys($futures), array_keys($results));
+        foreach ($results as $result) {
+            $this->assertTrue($result);
+        }
+
+        $get = $async->get('{async}key7');
+        $this->assertEquals('value7', $get->get());
+        $this->assertTrue($get->isReady());
+        $this->assertNull($get->getError());
+
+        // Missing keys resolve to false, like the synchronous API
+        $this->assertFalse($async->get('{async}missing-' . uniqid())->get());
+
+        // Arguments and replies as the synchronous methods take and return them
+        $this->assertEquals(2, $async->hset('{async}hash', ['f1' => 'v1', 'f2' => 'v2'])->get());
+        $this->assertEquals(['f1' => 'v1', 'f2' => 'v2'], $async->hGetAll('{async}hash')->get());
+        $this->assertEquals(['f2' => 'v2', 'f3' => false], $async->hMGet('{async}hash', ['f2', 'f3'])->get());
+        $this->assertTrue($async->hExists('{async}hash', 'f1')->get());
+        $this->assertEquals(ValkeyGlide::VALKEY_GLIDE_HASH, $async->type('{async}hash')->get());
+
+        // With the key prefix and the serializer of the client
+        $valkey_glide->setOption(ValkeyGlide::OPT_PREFIX, '{async}prefixed:');
+        $valkey_glide->setOption(ValkeyGlide::OPT_SERIALIZER, ValkeyGlide::SERIALIZER_PHP);
+        $this->assertTrue($async->set('value', ['a' => 1])->get());
+        $this->assertEquals(['a' => 1], $async->get('value')->get());
+        $this->assertEquals(['a' => 1], $valkey_glide->get('value'));
+        $this->assertEquals(1, $async->del('value')->get());
+        $valkey_glide->setOption(ValkeyGlide::OPT_SERIALIZER, ValkeyGlide::SERIALIZER_NONE);
+        $valkey_glide->setOption(ValkeyGlide::OPT_PREFIX, '');
+
+        // Methods that cannot be buffered in a pipeline are not sent asynchronously
+        try {
+            $async->subscribe(['channel']);
+            $this->fail('subscribe() was sent asynchronously');
+        } catch (ValkeyGlideException $e) {
+            $this->assertStringContains('asynchronously', $e->getMessage());
+        }
+
+        // Server errors are reported through the future
+        $this->assertEquals(1, $async->incr('{async}counter')->get());
+        $failed = $async->lpush('{async}counter', 'x');
+        $this->assertFalse($failed->get());
+        $this->assertTrue(is_string($failed->getError()));
+
+        $valkey_glide->del('{async}hash', '{async}counter');
+        $valkey_glide->close();
+    }
+
+    public function testFiberAwareFutures()
+    {
+        if (PHP_VERSION_ID < 80100) {
+            $this->markTestSkipped();
+        }
+
+        $addresses = [
+            ['host' => $this->getHost(), 'port' => $this->getPort()]
+        ];
+        $advancedConfig = $this->getTLS() ? ['tls_config' => ['use_insecure_tls' => true]] : null;
+        $valkey_glide = new ValkeyGlide($addresses, $this->getTLS(), advanced_config: $advancedConfig);
+        $valkey_glide->set('{fiber}key', 'value');
+        $async = $valkey_glide->async();
+        $stream = ValkeyGlide::getEventStream();
+
+        // Each Fiber suspends in get() instead of blocking the process
+        $results = [];
+        $fibers = [];
+        for ($i = 0; $i < 10; $i++) {
+            $fibers[$i] = new Fiber(function () use ($async, &$results, $i) {
+                $results[$i] = $async->get('{fiber}key')->get();
+            });
+            $fibers[$i]->start();
+        }
+
+        $deadline = microtime(true) + 5;
+        while (count($results) < count($fibers) && microtime(true) < $deadline) {
+            $read = [$stream];
+            $write = $except = null;
+            if (stream_select($read, $write, $except, 0, 100000) > 0) {
+                ValkeyGlide::poll();
+            }
+        }
+
+        $this->assertEquals(count($fibers), count($results));
+        foreach ($results as $result) {
+            $this->assertEquals('value', $result);
+        }
+        foreach ($fibers as $fiber) {
+            $this->assertTrue($fiber->isTerminated());
+        }
+
+        $valkey_glide->del('{fiber}key');
+        $valkey_glide->close();
+    }
+
+    public function testFiberAwareBackpressure()
+    {
+        if (PHP_VERSION_ID < 80100) {
+            $this->markTestSkipped();
+        }
+
+        $addresses = [
+            ['host' => $this->getHost(), 'port' => $this->getPort()]
+        ];
+        $advancedConfig = ['inflight_requests_limit' => 2];
+        if ($this->getTLS()) {
+            $advancedConfig['tls_config'] = ['use_insecure_tls' => true];
+        }
+        $valkey_glide = new ValkeyGlide($addresses, $this->getTLS(), advanced_config: $advancedConfig);
+        $valkey_glide->del('{fiber}list');
+        $async = $valkey_glide->async();
+        $stream = ValkeyGlide::getEventStream();
+
+        // Both slots held until the list gets elements
+        $pops = [$async->blpop('{fiber}list', 5), $async->blpop('{fiber}list', 5)];
+
+        // The Fiber suspends in the call instead of blocking the process
+        $result = null;
+        $fiber = new Fiber(function () use ($async, &$result) {
+            $result = $async->set('{fiber}key', 'value')->get();
+        });
+        $fiber->start();
+        $this->assertTrue($fiber->isSuspended());
+
+        // The synchronous connection of the client is not limited
+        $this->assertEquals(2, $valkey_glide->rpush('{fiber}list', 'a', 'b'));
+
+        $deadline = microtime(true) + 5;
+        while (!$fiber->isTerminated() && microtime(true) < $deadline) {
+            $read = [$stream];
+            $write = $except = null;
+            if (stream_select($read, $write, $except, 0, 100000) > 0) {
+                ValkeyGlide::poll();
+            }
+        }
+
+        $this->assertTrue($fiber->isTerminated());
+        $this->assertTrue($result);
+        foreach ($pops as $pop) {
+            $this->assertIsArray($pop->get());
+        }
+
+        $valkey_glide->del('{fiber}key', '{fiber}list');
+        $valkey_glide->close();
+    }
+
+    public function testPubSubMessageBuffer()
+    {
+        $addresses = [
+            ['host' => $this->getHost(), 'port' => $this->getPort()]
+        ];
+        $channel = 'pubsub-' . uniqid();
+        $advancedConfig = $this->getTLS() ? ['tls_config' => ['use_insecure_tls' => true]] : [];
+        $publisher = new ValkeyGlide($addresses, $this->getTLS(), advanced_config: $advancedConfig);
+
+        $advancedConfig['pubsub_subscriptions'] = ['channels' => [$channel]];
+        $subscriber = new ValkeyGlide($addresses, $this->getTLS(), advanced_config: $advancedConfig);
+
+        // Nothing published yet
+        $this->assertEquals([], $subscriber->getMessages());
+
+        // Connect-time subscription
+        for ($i = 0; $i < 10; $i++) {
+            $this->assertEquals(1, $publisher->publish($channel, "msg$i"));
+        }
+        $messages = [];
+        $deadline = microtime(true) + 5;
+        while (count($messages) < 10 && microtime(true) < $deadline) {
+            $messages = array_merge($messages, $subscriber->getMessages(4, 0.5));
+        }
+        $this->assertEquals(10, count($messages));
+        $this->assertEquals(['kind' => 'message', 'channel' => $channel, 'message' => 'msg0'], $messages[0]);
+        $this->assertEquals('msg9', $messages[9]['message']);
+
+        // Dynamic pattern subscription
+        $this->assertTrue($subscriber->psubscribe(["$channel.*"]));
+        $publisher->publish("$channel.sub", 'hello');
+        $messages = $subscriber->getMessages(10, 2.0);
+        $this->assertEquals(1, count($messages));
+        $this->assertEquals('pmessage', $messages[0]['kind']);
+        $this->assertEquals("$channel.*", $messages[0]['pattern']);
+        $this->assertEquals('hello', $messages[0]['message']);
+
+        $this->assertEquals([$channel => 1], $publisher->pubsub('numsub', [$channel]));
+
+        $this->assertTrue($subscriber->unsubscribe());
+        $this->assertTrue($subscriber->punsubscribe());
+        $subscriber->close();
+        $publisher->close();
+    }
+
+    public function testScriptNoScriptFallback()
+    {
+        $valkey_glide = $this->newInstance();
+        $code = "return {KEYS[1], ARGV[1], '" . uniqid() . "'}";
+        $script = new ValkeyGlideScript($code);
+
+        $this->assertEquals(sha1($code), $script->getSha1());
+        $this->assertEquals($code, $script->getCode());
+
+        // Not loaded yet: EVALSHA misses and the body is sent once
+        $this->assertTrue($valkey_glide->script('flush'));
+        $result = $script->run($valkey_glide, ['key'], ['arg']);
+        $this->assertEquals(['key', 'arg'], array_slice($result, 0, 2));
+        $this->assertEquals([true], $valkey_glide->script('exists', $script->getSha1()));
+
+        // A flushed server is transparently reloaded, by object, body or SHA1
+        $this->assertTrue($valkey_glide->script('flush'));
+        $this->assertEquals($result, $valkey_glide->evalsha($script->getSha1(), ['key', 'arg'], 1));
+        $this->assertTrue($valkey_glide->script('flush'));
+        $this->assertEquals($result, $valkey_glide->eval($code, ['key', 'arg'], 1));
+        $this->assertEquals($result, $script->run($valkey_glide, ['key'], ['arg']));
+
+        // SHA1s this process never saw the body of still fail
+        $this->assertFalse($valkey_glide->evalsha(sha1(uniqid())));
+
+        $valkey_glide->close();
+    }
+
+    public function testClientSideCache()
+    {
+        $addresses = [
+            ['host' => $this->getHost(), 'port' => $this->getPort()]
+        ];
+        $advancedConfig = $this->getTLS() ? ['tls_config' => ['use_insecure_tls' => true]] : [];
+        $writer = new ValkeyGlide($addresses, $this->getTLS(), advanced_config: $advancedConfig);
+
+        $advancedConfig['client_side_cache'] = ['max_memory' => 1024 * 1024];
+        $reader = new ValkeyGlide($addresses, $this->getTLS(), advanced_config: $advancedConfig);
+
+        $this->assertFalse($writer->getCacheStats());
+
+        $key = 'csc-' . uniqid();
+        $writer->set($key, 'v1');
+        $writer->hSet("$key-hash", 'field', 'value');
+
+        // Second read is served locally
+        $this->assertEquals('v1', $reader->get($key));
+        $this->assertEquals('v1', $reader->get($key));
+        $this->assertEquals(['field' => 'value'], $reader->hGetAll("$key-hash"));
+        $this->assertEquals(['field' => 'value'], $reader->hGetAll("$key-hash"));
+        $stats = $reader->getCacheStats();
+        $this->assertEquals(2, $stats['hits']);
+        $this->assertEquals(2, $stats['misses']);
+        $this->assertEquals(2, $stats['entries']);
+
+        // Cached replies are not affected by changes to what the caller got
+        $hash = $reader->hGetAll("$key-hash");
+        $hash['field'] = 'changed';
+        $this->assertEquals(['field' => 'value'], $reader->hGetAll("$key-hash"));
+
+        // A write from another connection invalidates the entry
+        $writer->set($key, 'v2');
+        $deadline = microtime(true) + 5;
+        while ($reader->get($key) !== 'v2' && microtime(true) < $deadline) {
+            usleep(10000);
+        }
+        $this->assertEquals('v2', $reader->get($key));
+        $this->assertGT(0, $reader->getCacheStats()['invalidations']);
+
+        // A write of the client itself is seen by its next read
+        $this->assertTrue($reader->set($key, 'v3'));
+        $this->assertEquals('v3', $reader->get($key));
+        $this->assertEquals(0, $reader->hSet("$key-hash", 'field', 'other'));
+        $this->assertEquals(['field' => 'other'], $reader->hGetAll("$key-hash"));
+        $this->assertEquals(1, $reader->del($key));
+        $this->assertFalse($reader->get($key));
+
+        // The memory cap is enforced
+        $value = str_repeat('x', 64 * 1024);
+        for ($i = 0; $i < 32; $i++) {
+            $writer->set("$key-$i", $value);
+            $this->assertEquals($value, $reader->get("$key-$i"));
+        }
+        $stats = $reader->getCacheStats();
+        $this->assertLTE($stats['max_memory'], $stats['memory']);
+        $this->assertGT(0, $stats['evictions']);
+
+        $keys = ["$key-hash", $key];
+        for ($i = 0; $i < 32; $i++) {
+            $keys[] = "$key-$i";
+        }
+        $writer->del($keys);
+        $reader->close();
+        $writer->close();
+    }
+
+    public function testSharedCache()
+    {
+        if (!ini_get('valkey_glide.shared_cache_size')) {
+            $this->markTestSkipped('valkey_glide.shared_cache_size is not set');
+        }
+
+        $addresses = [
+            ['host' => $this->getHost(), 'port' => $this->getPort()]
+        ];
+        $advancedConfig = $this->getTLS() ? ['tls_config' => ['use_insecure_tls' => true]] : [];
+        $writer = new ValkeyGlide($addresses, $this->getTLS(), advanced_config: $advancedConfig);
+
+        $advancedConfig['shared_cache'] = 200;
+        $first = new ValkeyGlide($addresses, $this->getTLS(), advanced_config: $advancedConfig);
+        $second = new ValkeyGlide($addresses, $this->getTLS(), advanced_config: $advancedConfig);
+
+        $key = 'shm-' . uniqid();
+        $writer->set($key, 'v1');
+
+        // What one client fetched is served to the other from the shared segment
+        $this->assertEquals('v1', $first->get($key));
+        $hits = $second->getCacheStats()['shared']['hits'];
+        $this->assertEquals('v1', $second->get($key));
+        $stats = $second->getCacheStats()['shared'];
+        $this->assertEquals($hits + 1, $stats['hits']);
+        $this->assertEquals(200, $stats['ttl']);
+        $this->assertGT(0, $stats['slots']);
+
+        // Writes are only seen once the entry expires
+        $writer->set($key, 'v2');
+        $this->assertEquals('v1', $second->get($key));
+        usleep(300000);
+        $this->assertEquals('v2', $second->get($key));
+
+        // Missing keys are never cached
+        $writer->del($key);
+        usleep(300000);
+        $this->assertFalse($first->get($key));
+        $writer->set($key, 'v3');
+        $this->assertEquals('v3', $first->get($key));
+
+        // Another database does not see the entries of the connection's one
+        $this->assertTrue($second->select(2));
+        $this->assertFalse($second->get($key));
+        $this->assertTrue($second->set($key, 'db2'));
+        $this->assertEquals('db2', $second->get($key));
+        $this->assertEquals('v3', $first->get($key));
+        $this->assertEquals(1, $second->del($key));
+        $this->assertTrue($second->select(0));
+
+        $writer->del($key);
+        $first->close();
+        $second->close();
+        $writer->close();
+    }
+
+    public function testOptions()
+    {
+        $valkey_glide = $this->newInstance();
+        $key = 'opt-' . uniqid();
+
+        $this->assertEquals(ValkeyGlide::SERIALIZER_NONE, $valkey_glide->getOption(ValkeyGlide::OPT_SERIALIZER));
+        $this->assertNull($valkey_glide->getOption(ValkeyGlide::OPT_PREFIX));
+        $this->assertFalse($valkey_glide->getOption(ValkeyGlide::OPT_NULL_MULTIBULK_AS_NULL));
+
+        // Values round-trip through the serializer
+        $value = ['a' => 1, 'b' => [true, 2.5, null]];
+        foreach ([ValkeyGlide::SERIALIZER_PHP, ValkeyGlide::SERIALIZER_JSON] as $serializer) {
+            $this->assertTrue($valkey_glide->setOption(ValkeyGlide::OPT_SERIALIZER, $serializer));
+            $this->assertEquals($serializer, $valkey_glide->getOption(ValkeyGlide::OPT_SERIALIZER));
+
+            $this->assertTrue($valkey_glide->set($key, $value));
+            $this->assertEquals($value, $valkey_glide->get($key));
+            $this->assertEquals([$value, false], $valkey_glide->mGet([$key, "$key-missing"]));
+
+            $valkey_glide->hSet("$key-hash", 'field', $value);
+            $this->assertEquals($value, $valkey_glide->hGet("$key-hash", 'field'));
+            $this->assertEquals(['field' => $value], $valkey_glide->hGetAll("$key-hash"));
+
+            $valkey_glide->del("$key-set");
+            $this->assertEquals(1, $valkey_glide->sAdd("$key-set", $value));
+            $this->assertEquals([$value], $valkey_glide->sMembers("$key-set"));
+            $this->assertEquals([$value], $valkey_glide->sInter("$key-set"));
+            $this->assertEquals([$value], $valkey_glide->sRandMember("$key-set", 1));
+            $this->assertEquals([[$value]], $valkey_glide->multi()->sMembers("$key-set")->exec());
+            $this->assertEquals($value, $valkey_glide->sPop("$key-set"));
+
+            $valkey_glide->del("$key-stream");
+            $id = $valkey_glide->xAdd("$key-stream", '*', ['field' => $value]);
+            $this->assertEquals([$id => ['field' => $value]], $valkey_glide->xRange("$key-stream", $id, $id));
+            $this->assertEquals(
+                ["$key-stream" => [$id => ['field' => $value]]],
+                $valkey_glide->xRead(["$key-stream" => '0-0'])
+            );
+            $this->assertEquals(
+                [[$id => ['field' => $value]]],
+                $valkey_glide->multi()->xRange("$key-stream", $id, $id)->exec()
+            );
+        }
+
+        // Unknown serializers are rejected and leave the option as it was
+        $this->assertFalse($valkey_glide->setOption(ValkeyGlide::OPT_SERIALIZER, 99));
+        $this->assertEquals(ValkeyGlide::SERIALIZER_JSON, $valkey_glide->getOption(ValkeyGlide::OPT_SERIALIZER));
+
+        $this->assertTrue($valkey_glide->setOption(ValkeyGlide::OPT_SERIALIZER, ValkeyGlide::SERIALIZER_NONE));
+        $this->assertEquals(json_encode($value), $valkey_glide->get($key));
+        $valkey_glide->del($key, "$key-hash", "$key-set", "$key-stream");
+
+        // Keys are prefixed on the way out, values are left alone
+        $this->assertTrue($valkey_glide->setOption(ValkeyGlide::OPT_PREFIX, 'app:'));
+        $this->assertEquals('app:', $valkey_glide->getOption(ValkeyGlide::OPT_PREFIX));
+        $this->assertTrue($valkey_glide->set($key, 'value'));
+        $this->assertEquals('value', $valkey_glide->get($key));
+        $this->assertEquals(1, $valkey_glide->exists($key));
+        $this->assertTrue($valkey_glide->setOption(ValkeyGlide::OPT_PREFIX, ''));
+        $this->assertNull($valkey_glide->getOption(ValkeyGlide::OPT_PREFIX));
+        $this->assertFalse($valkey_glide->get($key));
+        $this->assertEquals('value', $valkey_glide->get("app:$key"));
+        $valkey_glide->del("app:$key");
+
+        $this->assertTrue($valkey_glide->setOption(ValkeyGlide::OPT_NULL_MULTIBULK_AS_NULL, true));
+        $this->assertTrue($valkey_glide->getOption(ValkeyGlide::OPT_NULL_MULTIBULK_AS_NULL));
+
+        $valkey_glide->close();
+    }
+
+    public function testCompression()
+    {
+        $valkey_glide = $this->newInstance();
+        $raw = $this->newInstance();
+        $key = 'compression-' . uniqid();
+
+        $this->assertEquals(ValkeyGlide::COMPRESSION_NONE, $valkey_glide->getOption(ValkeyGlide::OPT_COMPRESSION));
+        $this->assertEquals(256, $valkey_glide->getOption(ValkeyGlide::OPT_COMPRESSION_MIN_SIZE));
+        $this->assertFalse($valkey_glide->setOption(ValkeyGlide::OPT_COMPRESSION, 99));
+
+        $tested = false;
+        foreach ([ValkeyGlide::COMPRESSION_LZ4, ValkeyGlide::COMPRESSION_ZSTD] as $compression) {
+            if (!$valkey_glide->setOption(ValkeyGlide::OPT_COMPRESSION, $compression)) {
+                continue;
+            }
+            $tested = true;
+
+            // Values written before compression was turned on are read as they are
+            $plain = str_repeat('plain ', 100);
+            $raw->set($key, $plain);
+            $this->assertEquals($plain, $valkey_glide->get($key));
+
+            // Long values are stored compressed, behind the header
+            $value = str_repeat('compressible ', 1000);
+            $this->assertTrue($valkey_glide->set($key, $value));
+            $stored = $raw->get($key);
+            $this->assertEquals("\xFEVG", substr($stored, 0, 3));
+            $this->assertLT(strlen($value), strlen($stored));
+            $this->assertEquals($value, $valkey_glide->get($key));
+
+            // Short values are not
+            $this->assertTrue($valkey_glide->set($key, 'short'));
+            $this->assertEquals('short', $raw->get($key));
+
+            $valkey_glide->del("$key-list");
+            $this->assertEquals(2, $valkey_glide->rPush("$key-list", $value, 'short'));
+            $this->assertEquals([$value, 'short'], $valkey_glide->lRange("$key-list", 0, -1));
+            $this->assertEquals($value, $valkey_glide->lPop("$key-list"));
+
+            // Compression applies after the serializer
+            $this->assertTrue($valkey_glide->setOption(ValkeyGlide::OPT_SERIALIZER, ValkeyGlide::SERIALIZER_PHP));
+            $array = array_fill(0, 200, 'item');
+            $this->assertTrue($valkey_glide->set($key, $array));
+            $this->assertEquals("\xFEVG", substr($raw->get($key), 0, 3));
+            $this->assertEquals($array, $valkey_glide->get($key));
+            $this->assertTrue($valkey_glide->setOption(ValkeyGlide::OPT_SERIALIZER, ValkeyGlide::SERIALIZER_NONE));
+        }
+
+        if (!$tested) {
+            $this->markTestSkipped('Built without LZ4 and Zstandard support');
+        }
+
+        $this->assertTrue($valkey_glide->setOption(ValkeyGlide::OPT_COMPRESSION_LEVEL, 3));
+        $this->assertEquals(3, $valkey_glide->getOption(ValkeyGlide::OPT_COMPRESSION_LEVEL));
+        $this->assertTrue($valkey_glide->setOption(ValkeyGlide::OPT_COMPRESSION_MIN_SIZE, 0));
+        $this->assertEquals(0, $valkey_glide->getOption(ValkeyGlide::OPT_COMPRESSION_MIN_SIZE));
+
+        $valkey_glide->del($key, "$key-list");
+        $raw->close();
+        $valkey_glide->close();
+    }
+
+    public function testSortedSetSerializer()
+    {
+        $valkey_glide = $this->newInstance();
+        $key = 'zset-serializer-' . uniqid();
+        $array = ['b' => 2];
+
+        $this->assertTrue($valkey_glide->setOption(ValkeyGlide::OPT_SERIALIZER, ValkeyGlide::SERIALIZER_PHP));
+        $this->assertEquals(1, $valkey_glide->zAdd($key, 1, 'a'));
+        $this->assertEquals(1, $valkey_glide->zAdd($key, 2, $array));
+        $this->assertEquals(1, $valkey_glide->zAdd($key, 3, 42));
+        $this->assertEquals(1.0, $valkey_glide->zScore($key, 'a'));
+
+        // Members come back as they were added, and key member => score when they can be keys
+        $this->assertEquals(['a', $array, 42], $valkey_glide->zRange($key, 0, -1));
+        $this->assertEquals(
+            ['a' => 1.0, serialize($array) => 2.0, 42 => 3.0],
+            $valkey_glide->zRange($key, 0, -1, true)
+        );
+        $this->assertEquals(['a', $array], $valkey_glide->zRangeByScore($key, 0, 2));
+        $this->assertEquals([42 => 3.0], $valkey_glide->zPopMax($key));
+        $this->assertEquals([$key, ['a' => 1.0]], $valkey_glide->zmpop([$key], 'MIN'));
+        $this->assertEquals([$key, $array, '2'], $valkey_glide->bzPopMin([$key], 1));
+
+        // The same in a batch
+        $valkey_glide->zAdd($key, 1, 'a', 2, $array);
+        $replies = $valkey_glide->multi()
+            ->zRange($key, 0, -1)
+            ->zRange($key, 0, -1, true)
+            ->zPopMin($key)
+            ->exec();
+        $this->assertEquals(
+            [['a', $array], ['a' => 1.0, serialize($array) => 2.0], ['a' => 1.0]],
+            $replies
+        );
+
+        $this->assertTrue($valkey_glide->setOption(ValkeyGlide::OPT_SERIALIZER, ValkeyGlide::SERIALIZER_NONE));
+        $valkey_glide->del($key);
+        $valkey_glide->close();
+    }
+
+    public function testLargeArgumentVectors()
+    {
+        $valkey_glide = $this->newInstance();
+        $key = 'arena-' . uniqid();
+
+        // Argument vectors past the stack buffer of the command scope continue in heap chunks
+        $zadd = [];
+        $fields = [];
+        $members = [];
+        for ($i = 0; $i < 2000; $i++) {
+            array_push($zadd, $i, "member-$i");
+            $fields["field-$i"] = $i;
+            $members[] = "member-$i";
+        }
+
+        $this->assertEquals(2000, $valkey_glide->zAdd("$key-z", ...$zadd));
+        $this->assertEquals(1999.0, $valkey_glide->zScore("$key-z", 'member-1999'));
+        $this->assertTrue($valkey_glide->hMSet("$key-h", $fields));
+        $this->assertEquals('1999', $valkey_glide->hGet("$key-h", 'field-1999'));
+        $this->assertEquals(2000, $valkey_glide->sAdd("$key-s", ...$members));
+        $this->assertEquals(2000, $valkey_glide->rPush("$key-l", ...$members));
+        $this->assertEquals(['member-0', 'member-1'], $valkey_glide->lRange("$key-l", 0, 1));
+
+        // The chunks are reused by the commands that follow
+        for ($i = 0; $i < 100; $i++) {
+            $this->assertEquals(0, $valkey_glide->zAdd("$key-z", ...$zadd));
+        }
+        $this->assertEquals(2000, $valkey_glide->zCard("$key-z"));
+
+        $valkey_glide->del("$key-z", "$key-h", "$key-s", "$key-l");
+        $valkey_glide->close();
+    }
+
+    public function testNumberArgumentPrecision()
+    {
+        $valkey_glide = $this->newInstance();
+        $key = 'format-' . uniqid();
+
+        // Doubles reach the server with every digit that matters, and no more
+        foreach ([1.2345678901, 0.1, -2.5e-7, 1e21, 12345678.5] as $score) {
+            $this->assertEquals(1, $valkey_glide->zAdd("$key-z", $score, "member"));
+            $this->assertEquals($score, $valkey_glide->zScore("$key-z", 'member'));
+            $valkey_glide->del("$key-z");
+        }
+
+        // Within the geohash resolution, which six significant digits were not
+        $this->assertEquals(1, $valkey_glide->geoAdd("$key-g", 13.361389, 38.115556, 'Palermo'));
+        $position = $valkey_glide->geoPos("$key-g", 'Palermo')[0];
+        $this->assertBetween((float) $position[0], 13.361379, 13.361399);
+        $this->assertBetween((float) $position[1], 38.115546, 38.115566);
+
+        $valkey_glide->set("$key-f", 0);
+        $this->assertEquals(1.0000001, $valkey_glide->incrByFloat("$key-f", 1.0000001));
+        $this->assertEquals('1.0000001', $valkey_glide->get("$key-f"));
+
+        $valkey_glide->del("$key-z", "$key-g", "$key-f");
+        $valkey_glide->close();
+    }
+
+    public function testArgumentConversion()
+    {
+        $valkey_glide = $this->newInstance();
+        $key = 'args-' . uniqid();
+        $member = new class {
+            public function __toString(): string
+            {
+                return 'object';
+            }
+        };
+
+        // Members keep the string PHP gives them, whatever their type
+        $this->assertEquals(5, $valkey_glide->sAdd("$key-s", 'string', 42, 1.5, 1e25, $member));
+        $members = $valkey_glide->sMembers("$key-s");
+        sort($members);
+        $this->assertEquals(['1.0E+25', '1.5', '42', 'object', 'string'], $members);
+
+        // Keys get the prefix on every path, the multi-key and the ZMPOP ones included
+        $this->assertTrue($valkey_glide->setOption(ValkeyGlide::OPT_PREFIX, "$key:"));
+        $valkey_glide->sAdd('a', 'x', 'y');
+        $valkey_glide->sAdd('b', 'y', 'z');
+        $this->assertEquals(1, $valkey_glide->sInterCard(['a', 'b']));
+        $this->assertEquals(1, $valkey_glide->sInterStore('c', 'a', 'b'));
+        $this->assertTrue($valkey_glide->sMove('a', 'c', 'x'));
+        $valkey_glide->zAdd('z', 1, 'one', 2, 'two');
+        $this->assertEquals(["$key:z", ['one' => 1.0]], $valkey_glide->zmpop(['z'], 'MIN'));
+        $this->assertTrue($valkey_glide->setOption(ValkeyGlide::OPT_PREFIX, ''));
+        $members = $valkey_glide->sMembers("$key:c");
+        sort($members);
+        $this->assertEquals(['x', 'y'], $members);
+
+        $valkey_glide->del("$key-s", "$key:a", "$key:b", "$key:c", "$key:z");
+        $valkey_glide->close();
+    }
+
+    public function testLargeReplies()
+    {
+        $valkey_glide = $this->newInstance();
+        $key = 'reply-' . uniqid();
+        $items = [];
+        $fields = [];
+        for ($i = 0; $i < 5000; $i++) {
+            $items[] = $i % 10 == 0 ? '' : "item-$i";
+            $fields["field-$i"] = "value-$i";
+        }
+
+        // Presized arrays come back complete and in order, empty strings included
+        $this->assertEquals(5000, $valkey_glide->rPush("$key-l", ...$items));
+        $this->assertEquals($items, $valkey_glide->lRange("$key-l", 0, -1));
+        $this->assertEquals([], $valkey_glide->lRange("$key-missing", 0, -1));
+
+        $members = array_values(array_unique($items));
+        $this->assertEquals(count($members), $valkey_glide->sAdd("$key-s", ...$members));
+        $reply = $valkey_glide->sMembers("$key-s");
+        sort($reply);
+        sort($members);
+        $this->assertEquals($members, $reply);
+
+        $this->assertTrue($valkey_glide->hMSet("$key-h", $fields));
+        $reply = $valkey_glide->hGetAll("$key-h");
+        ksort($reply);
+        ksort($fields);
+        $this->assertEquals($fields, $reply);
+
+        $valkey_glide->del("$key-l", "$key-s", "$key-h");
+        $valkey_glide->close();
+    }
+
+    public function testBinaryReplyKeys()
+    {
+        $valkey_glide = $this->newInstance();
+        $key = 'binkeys-' . uniqid();
+
+        // Fields and members with NUL bytes are keys of their own, not cut at the NUL
+        $valkey_glide->hSet("$key-h", "field\0one", 'a');
+        $valkey_glide->hSet("$key-h", "field\0two", 'b');
+        $valkey_glide->hSet("$key-h", '42', 'c');
+        $reply = $valkey_glide->hGetAll("$key-h");
+        ksort($reply);
+        $this->assertEquals([42 => 'c', "field\0one" => 'a', "field\0two" => 'b'], $reply);
+        $this->assertSame('c', $reply[42]);
+
+        $valkey_glide->zAdd("$key-z", 1, "member\0one", 2, "member\0two");
+        $this->assertEquals(
+            ["member\0one" => 1.0, "member\0two" => 2.0],
+            $valkey_glide->zRange("$key-z", 0, -1, ['withscores' => true])
+        );
+
+        $valkey_glide->del("$key-h", "$key-z");
+        $valkey_glide->close();
+    }
+
+    public function testReplyLimits()
+    {
+        $valkey_glide = $this->newInstance();
+        $key = 'limits-' . uniqid();
+        $nest = 'local t = {} local cur = t for i = 1, tonumber(ARGV[1]) do '
+            . 'local n = {} cur[1] = n cur = n end cur[1] = "leaf" return t';
+
+        // Deep replies are converted without recursion, up to the depth limit
+        $reply = $valkey_glide->eval($nest, [100]);
+        for ($depth = 0; is_array($reply); $depth++) {
+            $reply = $reply[0];
+        }
+        $this->assertEquals(101, $depth);
+        $this->assertEquals('leaf', $reply);
+
+        $this->assertThrowsMatch($valkey_glide, function ($client) use ($nest) {
+            $client->eval($nest, [300]);
+        }, '/nested too deeply/');
+
+        // A reply that cannot fit in memory_limit is refused before it is built
+        $chunk = array_fill(0, 1000, str_repeat('x', 200));
+        for ($i = 0; $i < 100; $i++) {
+            $valkey_glide->rPush("$key-l", ...$chunk);
+        }
+        $limit = ini_get('memory_limit');
+        ini_set('memory_limit', (string) (memory_get_usage() + 8 * 1024 * 1024));
+        $this->assertThrowsMatch($valkey_glide, function ($client) use ($key) {
+            $client->lRange("$key-l", 0, -1);
+        }, '/memory_limit/');
+        ini_set('memory_limit', $limit);
+
+        // The client is still usable afterwards
+        $this->assertEquals(100000, $valkey_glide->lLen("$key-l"));
+        $this->assertEquals(10, count($valkey_glide->lRange("$key-l", 0, 9)));
+
+        $valkey_glide->del("$key-l");
+        $valkey_glide->close();
+    }
+
+    public function testLazyResults()
+    {
+        $valkey_glide = $this->newInstance();
+        $key = 'lazy-' . uniqid();
+        $items = array_map(fn($i) => "item-$i", range(0, 999));
+        $valkey_glide->rPush("$key-l", ...$items);
+        $valkey_glide->sAdd("$key-s", ...$items);
+
+        $this->assertEquals(0, $valkey_glide->getOption(ValkeyGlide::OPT_LAZY_RESULTS));
+        $this->assertTrue($valkey_glide->setOption(ValkeyGlide::OPT_LAZY_RESULTS, 100));
+        $this->assertEquals(100, $valkey_glide->getOption(ValkeyGlide::OPT_LAZY_RESULTS));
+
+        // Shorter replies are still arrays
+        $this->assertEquals(['item-0', 'item-1'], $valkey_glide->lRange("$key-l", 0, 1));
+
+        $result = $valkey_glide->lRange("$key-l", 0, -1);
+        $this->assertIsObject($result, ValkeyGlideResult::class);
+        $this->assertEquals(1000, count($result));
+        $this->assertEquals('item-0', $result[0]);
+        $this->assertEquals('item-999', $result['999']);
+        $this->assertTrue(isset($result[500]));
+        $this->assertFalse(isset($result[1000]));
+        $this->assertFalse(isset($result['x']));
+
+        $seen = [];
+        foreach ($result as $i => $item) {
+            $seen[$i] = $item;
+        }
+        $this->assertEquals($items, $seen);
+        $this->assertEquals($items, iterator_to_array($result->getIterator()));
+        $this->assertEquals($items, $result->toArray());
+
+        try {
+            $result[0] = 'changed';
+            $this->fail('A ValkeyGlideResult cannot be written');
+        } catch (Error $e) {
+            $this->assertEquals('item-0', $result[0]);
+        }
+
+        $members = $valkey_glide->sMembers("$key-s");
+        $this->assertIsObject($members, ValkeyGlideResult::class);
+        $this->assertEqualsCanonicalizing($items, $members);
+
+        // The result outlives the client, and decodes with the serializer it was read with
+        $valkey_glide->setOption(ValkeyGlide::OPT_SERIALIZER, ValkeyGlide::SERIALIZER_PHP);
+        $keys = [];
+        foreach (range(0, 199) as $i) {
+            $keys[] = "$key-v$i";
+            $valkey_glide->set("$key-v$i", ['n' => $i]);
+        }
+        $values = $valkey_glide->mGet($keys);
+        $this->assertIsObject($values, ValkeyGlideResult::class);
+        $valkey_glide->setOption(ValkeyGlide::OPT_SERIALIZER, ValkeyGlide::SERIALIZER_NONE);
+        $valkey_glide->setOption(ValkeyGlide::OPT_LAZY_RESULTS, 0);
+        $valkey_glide->del("$key-l", "$key-s", ...$keys);
+        $valkey_glide->close();
+
+        $this->assertEquals(['n' => 199], $values[199]);
+        $this->assertEquals(200, count($values->toArray()));
+    }
+
+    public function testReplyShapes()
+    {
+        $valkey_glide = $this->newInstance();
+        $key = 'shapes-' . uniqid();
+        $valkey_glide->zAdd("$key-z", 1.5, 'a', 2, 'b');
+        $valkey_glide->hSet("$key-h", 'f', 'v');
+        $id = $valkey_glide->xAdd("$key-x", '*', ['f1' => 'v1', 'f2' => 'v2']);
+
+        $this->assertEquals(['a' => 1.5, 'b' => 2.0],
+                            $valkey_glide->zRandMember("$key-z", ['count' => 2, 'withscores' => true]));
+        $this->assertEquals(['f' => 'v'],
+                            $valkey_glide->hRandField("$key-h", ['count' => 1, 'withvalues' => true]));
+
+        // Entries keep all of their fields
+        $this->assertEquals([$id => ['f1' => 'v1', 'f2' => 'v2']], $valkey_glide->xRange("$key-x", '-', '+'));
+
+        // Batch replies have the shape the command has on its own
+        $ret = $valkey_glide->multi(ValkeyGlide::PIPELINE)
+            ->zRange("$key-z", 0, -1, ['withscores' => true])
+            ->zRange("$key-z", 0, -1)
+            ->xRange("$key-x", '-', '+')
+            ->exec();
+        $this->assertEquals([['a' => 1.5, 'b' => 2.0], ['a', 'b'], [$id => ['f1' => 'v1', 'f2' => 'v2']]], $ret);
+
+        $valkey_glide->del("$key-z", "$key-h", "$key-x");
+        $valkey_glide->close();
+    }
+
+    public function testLastError()
+    {
+        $valkey_glide = $this->newInstance();
+        $key = 'last-error-' . uniqid();
+        $valkey_glide->set($key, 'string');
+
+        $this->assertNull($valkey_glide->getLastError());
+        $this->assertFalse($valkey_glide->lPush($key, 'x'));
+        $this->assertStringContains('WRONGTYPE', $valkey_glide->getLastError());
+
+        // Kept until cleared, not by the next command that succeeds
+        $this->assertEquals('string', $valkey_glide->get($key));
+        $this->assertStringContains('WRONGTYPE', $valkey_glide->getLastError());
+        $this->assertTrue($valkey_glide->clearLastError());
+        $this->assertNull($valkey_glide->getLastError());
+
+        // Errors that are not a reply of the server throw, as typed exceptions
+        $this->assertTrue(is_subclass_of(ValkeyGlideTimeoutException::class, ValkeyGlideException::class));
+        $this->assertTrue(is_subclass_of(ValkeyGlideConnectionException::class, ValkeyGlideException::class));
+        $this->assertTrue(is_subclass_of(ValkeyGlideException::class, RuntimeException::class));
+
+        $valkey_glide->del($key);
+        $valkey_glide->close();
+    }
+
+    public function testBatchReplyShapes()
+    {
+        $valkey_glide = $this->newInstance();
+        $key = 'batch-shapes-' . uniqid();
+
+        // Every command is buffered, and returns the client for chaining
+        $batch = $valkey_glide->multi(ValkeyGlide::PIPELINE);
+        $this->assertEquals($batch, $batch->hSet("$key-h", 'f1', 'v1', 'f2', 'v2'));
+        $ret = $batch
+            ->hExists("$key-h", 'f1')
+            ->hMget("$key-h", ['f1', 'missing'])
+            ->hGetAll("$key-h")
+            ->type("$key-h")
+            ->zAdd("$key-z", 1.5, 'a')
+            ->zScore("$key-z", 'a')
+            ->expire("$key-h", 100)
+            ->get("$key-missing")
+            ->incrByFloat("$key-f", 1.5)
+            ->exec();
+
+        // Each reply has the shape the method returns outside of a batch
+        $this->assertEquals([
+            2,
+            true,
+            ['f1' => 'v1', 'missing' => false],
+            ['f1' => 'v1', 'f2' => 'v2'],
+            ValkeyGlide::VALKEY_GLIDE_HASH,
+            1,
+            1.5,
+            true,
+            false,
+            1.5,
+        ], $ret);
+        $this->assertEquals($ret[1], $valkey_glide->hExists("$key-h", 'f1'));
+        $this->assertEquals($ret[2], $valkey_glide->hMget("$key-h", ['f1', 'missing']));
+        $this->assertEquals($ret[4], $valkey_glide->type("$key-h"));
+
+        // Transactions too, and discard() drops what was buffered
+        $ret = $valkey_glide->multi()->sIsMember("$key-s", 'x')->type("$key-s")->exec();
+        $this->assertEquals([false, ValkeyGlide::VALKEY_GLIDE_NOT_FOUND], $ret);
+        $this->assertTrue($valkey_glide->multi()->set("$key-d", 'x')->discard());
+        $this->assertFalse($valkey_glide->get("$key-d"));
+
+        $valkey_glide->del("$key-h", "$key-z", "$key-f");
+        $valkey_glide->close();
+    }
+
+    public function testBatchServerAndScriptCommands()
+    {
+        $valkey_glide = $this->newInstance();
+        $key = 'batch-server-' . uniqid();
+        $script = "return redis.call('GET', KEYS[1])";
+
+        $valkey_glide->set($key, 'v');
+        $valkey_glide->rPush("$key-l", 3, 1, 2);
+
+        // Buffered like the data commands, with the reply each method returns on its own
+        $ret = $valkey_glide->multi(ValkeyGlide::PIPELINE)
+            ->ping()
+            ->ping('hello')
+            ->eval($script, [$key], 1)
+            ->evalsha(sha1($script), [$key], 1)
+            ->sort("$key-l")
+            ->object('encoding', $key)
+            ->config('GET', 'maxmemory-policy')
+            ->info('server')
+            ->client('list')
+            ->rawcommand('GET', $key)
+            ->wait(0, 0)
+            ->exec();
+
+        $this->assertEquals(11, count($ret));
+        $this->assertTrue($ret[0]);
+        $this->assertEquals('hello', $ret[1]);
+        $this->assertEquals('v', $ret[2]);
+        $this->assertEquals('v', $ret[3]);
+        $this->assertEquals(['1', '2', '3'], $ret[4]);
+        $this->assertEquals($valkey_glide->object('encoding', $key), $ret[5]);
+        $this->assertArrayKey($ret[6], 'maxmemory-policy');
+        $this->assertArrayKey($ret[7], 'redis_version');
+        $this->assertIsArray($ret[8][0]);
+        $this->assertArrayKey($ret[8][0], 'addr');
+        $this->assertEquals('v', $ret[9]);
+        $this->assertEquals(0, $ret[10]);
+
+        // CLIENT REPLY would leave the batch without its replies
+        $valkey_glide->multi(ValkeyGlide::PIPELINE);
+        try {
+            $valkey_glide->client('reply', 'off');
+            $this->fail('CLIENT REPLY was buffered');
+        } catch (ValkeyGlideException $e) {
+            $this->assertStringContains('CLIENT REPLY', $e->getMessage());
+        }
+        $valkey_glide->discard();
+
+        $valkey_glide->del($key, "$key-l");
+        $valkey_glide->close();
+    }
+
+    public function testLargePipelineReusesArena()
+    {
+        $valkey_glide = $this->newInstance();
+        $key = 'batch-arena-' . uniqid();
+
+        // The second batch reuses what the first one grew, and sees none of its arguments
+        for ($round = 0; $round < 2; $round++) {
+            $batch = $valkey_glide->multi(ValkeyGlide::PIPELINE);
+            for ($i = 0; $i < 10000; $i++) {
+                $batch->set("$key-$i", str_repeat(chr(65 + $round), $i % 64));
+            }
+            $batch->get("$key-9999");
+            $ret = $batch->exec();
+
+            $this->assertEquals(10001, count($ret));
+            $this->assertTrue($ret[0]);
+            $this->assertEquals(str_repeat(chr(65 + $round), 9999 % 64), $ret[10000]);
+        }
+
+        for ($i = 0; $i < 10000; $i += 1000) {
+            $valkey_glide->del(...array_map(fn($j) => "$key-$j", range($i, $i + 999)));
+        }
+        $valkey_glide->close();
+    }
+
+    public function testBatchOptions()
+    {
+        $valkey_glide = $this->newInstance();
+        $key = 'batch-options-' . uniqid();
+
+        $ret = $valkey_glide->pipeline(['timeout' => 30000, 'retry_connection_error' => true])
+            ->set($key, 'string')
+            ->get($key)
+            ->exec(['retry_server_error' => true]);
+        $this->assertEquals([true, 'string'], $ret);
+
+        // Options of exec() apply to transactions too, without the retries
+        $ret = $valkey_glide->multi()->get($key)->exec(['timeout' => 1000]);
+        $this->assertEquals(['string'], $ret);
+
+        // The first error reply fails the batch as a whole
+        $valkey_glide->clearLastError();
+        $ret = $valkey_glide->pipeline(['raise_on_error' => true])
+            ->lPush($key, 'x')
+            ->get($key)
+            ->exec();
+        $this->assertFalse($ret);
+        $this->assertStringContains('WRONGTYPE', $valkey_glide->getLastError());
+
+        // Invalid options leave the batch buffered
+        $valkey_glide->pipeline()->get($key);
+        foreach ([['timeout' => -1], ['timeout' => '10'], ['retries' => 3], [true]] as $options) {
+            try {
+                $valkey_glide->exec($options);
+                $this->assertFalse(true, 'exec() accepted ' . json_encode($options));
+            } catch (ValueError $e) {
+                $this->assertStringContains('exec()', $e->getMessage());
+            }
+        }
+        $this->assertEquals(['string'], $valkey_glide->exec());
+
+        $valkey_glide->del($key);
+        $valkey_glide->close();
+    }
+
+    public function testPreparedBatch()
+    {
+        $valkey_glide = $this->newInstance();
+        $id = uniqid();
+
+        foreach (['a', 'b'] as $user) {
+            $valkey_glide->hSet("{u:$id-$user}:profile", 'name', "name-$user", 'why?', 'because');
+            $valkey_glide->zAdd("{u:$id-$user}:feed", 1, "post-$user-1", 2, "post-$user-2");
+        }
+
+        $tpl = $valkey_glide->prepareBatch(function ($b) {
+            $user = ValkeyGlideBatchTemplate::param(0);
+            $b->hGetAll("{u:$user}:profile");
+            $b->zRange("{u:$user}:feed", 0, 49);
+            $b->hGet("{u:$user}:profile", 'why?');
+        });
+        $this->assertTrue($tpl instanceof ValkeyGlideBatchTemplate);
+
+        // Preparing sends nothing and leaves the client out of batch mode
+        $this->assertEquals("name-a", $valkey_glide->hGet("{u:$id-a}:profile", 'name'));
+
+        foreach (['a', 'b'] as $user) {
+            $this->assertEquals([
+                ['name' => "name-$user", 'why?' => 'because'],
+                ["post-$user-1", "post-$user-2"],
+                'because',
+            ], $tpl->execute(["$id-$user"]));
+        }
+
+        $tpl = $valkey_glide->prepareBatch(function ($b) {
+            $first = ValkeyGlideBatchTemplate::param(0);
+            $second = ValkeyGlideBatchTemplate::param(1);
+            $b->exists("{u:$first}:profile", "{u:$second}:feed");
+        }, ValkeyGlide::MULTI);
+        $this->assertEquals([2], $tpl->execute(["$id-a", "$id-b"], ['timeout' => 1000]));
+
+        try {
+            $tpl->execute(["$id-a"]);
+            $this->assertFalse(true, 'execute() ran with a missing parameter');
+        } catch (ValueError $e) {
+            $this->assertStringContains('parameter 1', $e->getMessage());
+        }
+
+        // Placeholders are only replaced in the arguments sent as given
+        $valkey_glide->setOption(ValkeyGlide::OPT_SERIALIZER, ValkeyGlide::SERIALIZER_PHP);
+        try {
+            $valkey_glide->prepareBatch(function ($b) use ($id) {
+                $b->set("{u:$id-a}:name", ValkeyGlideBatchTemplate::param(0));
+            });
+            $this->assertFalse(true, 'prepareBatch() serialized a placeholder');
+        } catch (ValueError $e) {
+            $this->assertStringContains('serialized', $e->getMessage());
+        }
+        $valkey_glide->setOption(ValkeyGlide::OPT_SERIALIZER, ValkeyGlide::SERIALIZER_NONE);
+
+        try {
+            $valkey_glide->prepareBatch(function ($b) {
+            });
+            $this->assertFalse(true, 'prepareBatch() accepted an empty batch');
+        } catch (ValkeyGlideException $e) {
+            $this->assertStringContains('any command', $e->getMessage());
+        }
+
+        foreach (['a', 'b'] as $user) {
+            $valkey_glide->del("{u:$id-$user}:profile", "{u:$id-$user}:feed");
+        }
+        $valkey_glide->close();
+    }
+
+    public function testPersistentClientReset()
+    {
+        $addresses = [
+            ['host' => $this->getHost(), 'port' => $this->getPort()]
+        ];
+        $advancedConfig = $this->getTLS() ? ['tls_config' => ['use_insecure_tls' => true]] : null;
+        $persistentId = 'pool-reset-' . uniqid();
+        $key = 'pool-reset-' . uniqid();
+
+        $before = ValkeyGlide::getPersistentPoolStats();
+
+        // Clients alive at once never share a connection
+        $first = new ValkeyGlide($addresses, $this->getTLS(), advanced_config: $advancedConfig, persistent_id: $persistentId);
+        $second = new ValkeyGlide($addresses, $this->getTLS(), advanced_config: $advancedConfig, persistent_id: $persistentId);
+        $stats = ValkeyGlide::getPersistentPoolStats();
+        $this->assertEquals($before['misses'] + 2, $stats['misses']);
+
+        $this->assertTrue($first->watch($key));
+        $this->assertTrue($second->set($key, 'touched'));
+        $this->assertTrue($first->select(2));
+        $this->assertTrue($first->set($key, 'db2'));
+        unset($first);
+
+        // The connection comes back on its configured database, without the WATCH
+        $third = new ValkeyGlide($addresses, $this->getTLS(), advanced_config: $advancedConfig, persistent_id: $persistentId);
+        $stats = ValkeyGlide::getPersistentPoolStats();
+        $this->assertEquals($before['hits'] + 1, $stats['hits']);
+        $this->assertEquals('touched', $third->get($key));
+        $this->assertEquals([true], $third->multi()->set($key, 'db0')->exec());
+
+        $third->del($key);
+        $third->select(2);
+        $third->del($key);
+        $second->close();
+        $third->close();
+    }
 }
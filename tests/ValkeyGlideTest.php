@@ -109,7 +109,7 @@ class ValkeyGlideTest extends ValkeyGlideBaseTest
 
         $this->assertIsArray($ret, 1);
         $this->assertGT(-1, $ret[0] ?? -1);
-    }
+    }*/
 
     // Run some simple tests against the PUBSUB command.  This is problematic, as we
     // can't be sure what's going on in the instance, but we can do some things.
@@ -147,7 +147,7 @@ class ValkeyGlideTest extends ValkeyGlideBaseTest
         // Invalid calls
         $this->assertFalse(@$this->valkey_glide->pubsub('notacommand'));
         $this->assertFalse(@$this->valkey_glide->pubsub('numsub', 'not-an-array'));
-    }*/
+    }
 
     /* These test cases were generated randomly.  We're just trying to test
        that PhpValkeyGlide handles all combination of arguments correctly. */
@@ -5484,8 +5484,6 @@ class ValkeyGlideTest extends ValkeyGlideBaseTest
 
     public function testScript()
     {
-        //TODO
-        $this->markTestSkipped();
         if (version_compare($this->version, '2.5.0') < 0) {
             $this->markTestSkipped();
         }
@@ -5656,8 +5654,6 @@ class ValkeyGlideTest extends ValkeyGlideBaseTest
 
     public function testEvalSHA()
     {
-        //TODO
-        $this->markTestSkipped();
         if (version_compare($this->version, '2.5.0') < 0) {
             $this->markTestSkipped();
         }
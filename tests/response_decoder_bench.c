@@ -0,0 +1,197 @@
+/*
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+*/
+
+/*
+ * Reply conversion benchmark, used for testing only: converts a synthetic CommandResponse with
+ * command_response_to_zval() and with the element-by-element conversion it replaced, without a
+ * server. Run by benchmarks/response_bench.php.
+ */
+
+#include <time.h>
+
+#include "command_response.h"
+#include "php.h"
+#include "tests/response_decoder_bench_arginfo.h"
+
+zend_class_entry* response_decoder_bench_ce;
+
+void register_response_decoder_bench_class(void) {
+    response_decoder_bench_ce = register_class_ResponseDecoderBench();
+}
+
+typedef enum { BENCH_ARRAY, BENCH_SET, BENCH_MAP } bench_shape;
+
+static double bench_now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* A string of 8 to 23 bytes, the size of typical list items, members and field names */
+static void bench_string(CommandResponse* item, zend_long i, char** storage) {
+    item->response_type    = String;
+    item->string_value     = *storage;
+    item->string_value_len = snprintf(*storage, 32, "element:%0*ld", (int) (i % 16), (long) i);
+    *storage += 32;
+}
+
+/* The reply of LRANGE (Array), SMEMBERS (Sets) or HGETALL (Map) with count elements */
+static CommandResponse* bench_build(bench_shape shape, zend_long count, char** strings) {
+    CommandResponse* reply = ecalloc(1, sizeof(CommandResponse));
+    CommandResponse* items = ecalloc(count ? count : 1, sizeof(CommandResponse));
+    CommandResponse* pairs =
+        shape == BENCH_MAP && count > 0 ? ecalloc(count * 2, sizeof(CommandResponse)) : NULL;
+    char*            storage;
+
+    *strings = storage = emalloc((count * 2 + 1) * 32);
+    for (zend_long i = 0; i < count; i++) {
+        if (shape == BENCH_MAP) {
+            bench_string(&pairs[i * 2], i, &storage);
+            bench_string(&pairs[i * 2 + 1], count - i, &storage);
+            items[i].map_key   = &pairs[i * 2];
+            items[i].map_value = &pairs[i * 2 + 1];
+        } else {
+            bench_string(&items[i], i, &storage);
+        }
+    }
+
+    switch (shape) {
+        case BENCH_ARRAY:
+        case BENCH_MAP:
+            reply->response_type   = shape == BENCH_ARRAY ? Array : Map;
+            reply->array_value     = items;
+            reply->array_value_len = count;
+            break;
+        case BENCH_SET:
+            reply->response_type  = Sets;
+            reply->sets_value     = items;
+            reply->sets_value_len = count;
+            break;
+    }
+    return reply;
+}
+
+static void bench_free(bench_shape shape, CommandResponse* reply, char* strings) {
+    CommandResponse* items = shape == BENCH_SET ? reply->sets_value : reply->array_value;
+
+    if (shape == BENCH_MAP && reply->array_value_len > 0) {
+        efree(items[0].map_key);
+    }
+    efree(items);
+    efree(reply);
+    efree(strings);
+}
+
+/* The conversion before the arrays were presized: one call and one append per element, with
+ * the array growing as it goes */
+static void bench_convert_before(bench_shape shape, CommandResponse* reply, zval* output) {
+    array_init(output);
+    switch (shape) {
+        case BENCH_ARRAY:
+            for (int64_t i = 0; i < reply->array_value_len; i++) {
+                zval value;
+
+                command_response_to_zval(
+                    &reply->array_value[i], &value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false);
+                add_next_index_zval(output, &value);
+            }
+            break;
+        case BENCH_SET:
+            for (int i = 0; i < reply->sets_value_len; i++) {
+                CommandResponse* item = &reply->sets_value[i];
+                zval             value;
+
+                ZVAL_STRINGL(&value, item->string_value, item->string_value_len);
+                add_next_index_zval(output, &value);
+            }
+            break;
+        case BENCH_MAP:
+            for (int i = 0; i < reply->array_value_len; i++) {
+                zval key, value;
+
+                command_response_to_zval(reply->array_value[i].map_key,
+                                         &key,
+                                         COMMAND_RESPONSE_ASSOSIATIVE_ARRAY_MAP,
+                                         false);
+                command_response_to_zval(reply->array_value[i].map_value,
+                                         &value,
+                                         COMMAND_RESPONSE_ASSOSIATIVE_ARRAY_MAP,
+                                         false);
+                add_assoc_zval(output, Z_STRVAL(key), &value);
+                zval_dtor(&key);
+            }
+            break;
+    }
+}
+
+PHP_METHOD(ResponseDecoderBench, run) {
+    zend_string*     shape_name;
+    zend_long        count, iterations;
+    bench_shape      shape;
+    CommandResponse* reply;
+    char*            strings;
+    double           start, before, after;
+
+    ZEND_PARSE_PARAMETERS_START(3, 3)
+    Z_PARAM_STR(shape_name)
+    Z_PARAM_LONG(count)
+    Z_PARAM_LONG(iterations)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_THROWS());
+
+    if (zend_string_equals_literal(shape_name, "array")) {
+        shape = BENCH_ARRAY;
+    } else if (zend_string_equals_literal(shape_name, "set")) {
+        shape = BENCH_SET;
+    } else if (zend_string_equals_literal(shape_name, "map")) {
+        shape = BENCH_MAP;
+    } else {
+        zend_argument_value_error(1, "must be \"array\", \"set\" or \"map\"");
+        RETURN_THROWS();
+    }
+    if (count < 0 || iterations <= 0) {
+        zend_argument_value_error(count < 0 ? 2 : 3, "must be positive");
+        RETURN_THROWS();
+    }
+
+    reply = bench_build(shape, count, &strings);
+
+    start = bench_now_ns();
+    for (zend_long i = 0; i < iterations; i++) {
+        zval output;
+
+        bench_convert_before(shape, reply, &output);
+        zval_ptr_dtor(&output);
+    }
+    before = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    for (zend_long i = 0; i < iterations; i++) {
+        zval output;
+
+        command_response_to_zval(reply,
+                                 &output,
+                                 shape == BENCH_MAP ? COMMAND_RESPONSE_ASSOSIATIVE_ARRAY_MAP
+                                                    : COMMAND_RESPONSE_NOT_ASSOSIATIVE,
+                                 false);
+        zval_ptr_dtor(&output);
+    }
+    after = bench_now_ns() - start;
+
+    bench_free(shape, reply, strings);
+
+    array_init_size(return_value, 2);
+    add_assoc_double(return_value, "before", before / iterations);
+    add_assoc_double(return_value, "after", after / iterations);
+}
@@ -10,9 +10,22 @@
 #include "logger.h"          // Include logger functionality
 #include "logger_arginfo.h"  // Include logger functions arginfo
 #include "php_valkey_glide.h"
+#include "valkey_glide_arena.h"
 #include "valkey_glide_arginfo.h"          // Include generated arginfo header
+#include "valkey_glide_async.h"
+#include "valkey_glide_batch.h"
+#include "valkey_glide_batch_template.h"
+#include "valkey_glide_cache.h"
 #include "valkey_glide_cluster_arginfo.h"  // Include generated arginfo header
 #include "valkey_glide_commands_common.h"
+#include "valkey_glide_compression.h"
+#include "valkey_glide_options.h"
+#include "valkey_glide_pool.h"
+#include "valkey_glide_pubsub.h"
+#include "valkey_glide_result.h"
+#include "valkey_glide_route.h"
+#include "valkey_glide_script.h"
+#include "valkey_glide_shm_cache.h"
 
 /* Enum support includes - must be BEFORE arginfo includes */
 #if PHP_VERSION_ID >= 80100
@@ -33,9 +46,12 @@ extern int  parse_valkey_glide_client_configuration(zval*
 extern void free_valkey_glide_client_configuration(valkey_glide_client_configuration_t* config);
 
 void register_mock_constructor_class(void);
+void register_response_decoder_bench_class(void);
 
 zend_class_entry* valkey_glide_ce;
 zend_class_entry* valkey_glide_exception_ce;
+zend_class_entry* valkey_glide_timeout_exception_ce;
+zend_class_entry* valkey_glide_connection_exception_ce;
 
 zend_class_entry* valkey_glide_cluster_ce;
 
@@ -51,6 +67,14 @@ zend_class_entry* get_valkey_glide_exception_ce(void) {
     return valkey_glide_exception_ce;
 }
 
+zend_class_entry* get_valkey_glide_timeout_exception_ce(void) {
+    return valkey_glide_timeout_exception_ce;
+}
+
+zend_class_entry* get_valkey_glide_connection_exception_ce(void) {
+    return valkey_glide_connection_exception_ce;
+}
+
 zend_class_entry* get_valkey_glide_cluster_ce(void) {
     return valkey_glide_cluster_ce;
 }
@@ -70,6 +94,7 @@ zend_object* create_valkey_glide_object(zend_class_entry* ce) {
 
     zend_object_std_init(&valkey_glide->std, ce);
     object_properties_init(&valkey_glide->std, ce);
+    valkey_glide->options.compression_min_size = VALKEY_GLIDE_COMPRESSION_DEFAULT_MIN_SIZE;
 
     memcpy(&valkey_glide_object_handlers,
            zend_get_std_object_handlers(),
@@ -88,6 +113,7 @@ zend_object* create_valkey_glide_cluster_object(zend_class_entry* ce)  // TODO c
 
     zend_object_std_init(&valkey_glide->std, ce);
     object_properties_init(&valkey_glide->std, ce);
+    valkey_glide->options.compression_min_size = VALKEY_GLIDE_COMPRESSION_DEFAULT_MIN_SIZE;
 
     memcpy(&valkey_glide_cluster_object_handlers,
            zend_get_std_object_handlers(),
@@ -115,6 +141,8 @@ void valkey_glide_init_common_constructor_params(
     params->advanced_config         = NULL;
     params->lazy_connect            = 0;
     params->lazy_connect_is_null    = 1;
+    params->persistent_id           = NULL;
+    params->persistent_id_len       = 0;
 }
 
 void valkey_glide_build_client_config_base(valkey_glide_php_common_constructor_params_t* params,
@@ -126,8 +154,8 @@ void valkey_glide_build_client_config_base(valkey_glide_php_common_constructor_p
         params->request_timeout_is_null ? -1 : params->request_timeout; /* -1 means not set */
     config->client_name = params->client_name ? params->client_name : NULL;
 
-    /* Set inflight requests limit to -1 (unset). A synchronous API does not need a request limit
-       since it is effectively one-request-at-a-time. */
+    /* Inflight requests limit is -1 (unset, core default) unless advanced_config sets it. It
+       bounds how many async requests a client keeps outstanding at once. */
     config->inflight_requests_limit = -1;
 
     /* Set client availability zone */
@@ -136,6 +164,10 @@ void valkey_glide_build_client_config_base(valkey_glide_php_common_constructor_p
     /* Set lazy connect option */
     config->lazy_connect = params->lazy_connect_is_null ? false : params->lazy_connect;
 
+    /* Clients with a persistent_id are borrowed from the process-wide pool */
+    config->persistent_id     = params->persistent_id;
+    config->persistent_id_len = params->persistent_id_len;
+
     /* Map read_from enum value to client's ReadFrom enum */
     switch (params->read_from) {
         case 1: /* PREFER_REPLICA */
@@ -289,6 +321,38 @@ void valkey_glide_build_client_config_base(valkey_glide_php_common_constructor_p
             config->advanced_config->connection_timeout = VALKEY_GLIDE_DEFAULT_CONNECTION_TIMEOUT;
         }
 
+        /* Check for inflight_requests_limit */
+        zval* inflight_val = zend_hash_str_find(advanced_ht, "inflight_requests_limit", 23);
+        if (inflight_val && Z_TYPE_P(inflight_val) == IS_LONG && Z_LVAL_P(inflight_val) > 0) {
+            config->inflight_requests_limit = Z_LVAL_P(inflight_val);
+        }
+
+        /* Check for connect-time Pub/Sub subscriptions */
+        zval* subscriptions_val = zend_hash_str_find(advanced_ht, "pubsub_subscriptions", 20);
+        if (subscriptions_val && Z_TYPE_P(subscriptions_val) == IS_ARRAY) {
+            config->advanced_config->pubsub_subscriptions = Z_ARRVAL_P(subscriptions_val);
+        }
+
+        /* Check for the Pub/Sub message buffer size */
+        zval* buffer_size_val = zend_hash_str_find(advanced_ht, "pubsub_buffer_size", 18);
+        if (buffer_size_val && Z_TYPE_P(buffer_size_val) == IS_LONG &&
+            Z_LVAL_P(buffer_size_val) > 0) {
+            config->advanced_config->pubsub_buffer_size = Z_LVAL_P(buffer_size_val);
+        }
+
+        /* Check for the client-side cache */
+        config->advanced_config->client_side_cache = valkey_glide_cache_parse_configuration(
+            zend_hash_str_find(advanced_ht, "client_side_cache", 17));
+
+        /* Check for the shared GET cache: true for the default TTL, or a TTL in milliseconds */
+        zval* shared_cache_val = zend_hash_str_find(advanced_ht, "shared_cache", 12);
+        if (shared_cache_val && Z_TYPE_P(shared_cache_val) == IS_TRUE) {
+            config->advanced_config->shared_cache_ttl = VALKEY_GLIDE_SHM_CACHE_DEFAULT_TTL;
+        } else if (shared_cache_val && Z_TYPE_P(shared_cache_val) == IS_LONG &&
+                   Z_LVAL_P(shared_cache_val) > 0) {
+            config->advanced_config->shared_cache_ttl = Z_LVAL_P(shared_cache_val);
+        }
+
         /* Check for TLS config */
         zval* tls_config_val = zend_hash_str_find(advanced_ht, "tls_config", 10);
         if (tls_config_val && Z_TYPE_P(tls_config_val) == IS_ARRAY) {
@@ -316,6 +380,11 @@ const zend_function_entry valkey_glide_cluster_methods[] = {
            arginfo_class_ValkeyGlideCluster___construct,
            ZEND_ACC_PUBLIC | ZEND_ACC_CTOR) PHP_FE_END};
 
+PHP_INI_BEGIN()
+/* Bytes of shared memory for the cross-worker GET cache, 0 to disable it */
+PHP_INI_ENTRY("valkey_glide.shared_cache_size", "0", PHP_INI_SYSTEM, NULL)
+PHP_INI_END()
+
 /**
  * PHP_MINIT_FUNCTION
  */
@@ -340,15 +409,99 @@ PHP_MINIT_FUNCTION(valkey_glide) {
     /* Register ClusterScanCursor class */
     register_cluster_scan_cursor_class();
 
+    /* Register ValkeyGlideAsync and ValkeyGlideFuture classes */
+    register_valkey_glide_async_classes();
+
+    /* Register ValkeyGlideScript class */
+    register_valkey_glide_script_class();
+
+    /* Register ValkeyGlideResult class */
+    register_valkey_glide_result_class();
+
+    /* Register ValkeyGlideRoute class */
+    register_valkey_glide_route_class();
+
+    /* Register ValkeyGlideBatchTemplate class */
+    register_valkey_glide_batch_template_class();
+
     /* Register mock constructor class used for testing only. */
     register_mock_constructor_class();
 
-    /* ValkeyGlideException class */
-    // TODO   valkey_glide_exception_ce =
-    // register_class_ValkeyGlideException(spl_ce_RuntimeException);
+    /* Register reply conversion benchmark class used for testing only. */
+    register_response_decoder_bench_class();
+
+    /* ValkeyGlideException class, and the errors of commands that did not reach a reply */
+    valkey_glide_exception_ce = register_class_ValkeyGlideException(spl_ce_RuntimeException);
+    valkey_glide_timeout_exception_ce =
+        register_class_ValkeyGlideTimeoutException(valkey_glide_exception_ce);
+    valkey_glide_connection_exception_ce =
+        register_class_ValkeyGlideConnectionException(valkey_glide_exception_ce);
     valkey_glide_ce->create_object         = create_valkey_glide_object;
     valkey_glide_cluster_ce->create_object = create_valkey_glide_cluster_object;
 
+    /* Serve the read commands from the client-side cache when it is enabled */
+    valkey_glide_cache_install(valkey_glide_ce);
+    valkey_glide_cache_install(valkey_glide_cluster_ce);
+
+    /* Buffer every command of the batch table after multi()/pipeline() */
+    valkey_glide_batch_install(valkey_glide_ce);
+    valkey_glide_batch_install(valkey_glide_cluster_ce);
+
+    /* Process-wide pool of persistent clients */
+    valkey_glide_pool_init();
+
+    /* Push message routing for Pub/Sub */
+    valkey_glide_pubsub_init();
+
+    /* SHA1 cache of the Lua scripts seen by this process */
+    valkey_glide_script_cache_init();
+
+    /* Map the shared GET cache before the SAPI forks its workers */
+    REGISTER_INI_ENTRIES();
+    valkey_glide_shm_cache_init(INI_INT("valkey_glide.shared_cache_size"));
+
+    return SUCCESS;
+}
+
+/**
+ * PHP_MSHUTDOWN_FUNCTION
+ */
+PHP_MSHUTDOWN_FUNCTION(valkey_glide) {
+    /* Close clients kept open by the persistent pool */
+    valkey_glide_pool_shutdown();
+
+    /* Release the message buffers of clients that were never closed */
+    valkey_glide_pubsub_shutdown();
+
+    /* Release the cached script bodies */
+    valkey_glide_script_cache_shutdown();
+
+    /* Close the async completion notification descriptor */
+    valkey_glide_async_shutdown();
+
+    /* Unmap the shared GET cache */
+    valkey_glide_shm_cache_shutdown();
+
+    /* Free the argument arena chunks kept between commands */
+    valkey_glide_arena_shutdown();
+
+    /* Free the lookup of the batch method handlers */
+    valkey_glide_batch_shutdown();
+    UNREGISTER_INI_ENTRIES();
+
+    return SUCCESS;
+}
+
+/**
+ * PHP_RSHUTDOWN_FUNCTION
+ */
+PHP_RSHUTDOWN_FUNCTION(valkey_glide) {
+    /* Drop Fibers left suspended on futures */
+    valkey_glide_async_request_shutdown();
+
+    /* Close the argument scopes a fatal error left open */
+    valkey_glide_arena_request_shutdown();
+
     return SUCCESS;
 }
 
@@ -357,9 +510,9 @@ zend_module_entry valkey_glide_module_entry = {STANDARD_MODULE_HEADER,
                                                "valkey_glide",
                                                ext_functions,
                                                PHP_MINIT(valkey_glide),
+                                               PHP_MSHUTDOWN(valkey_glide),
                                                NULL,
-                                               NULL,
-                                               NULL,
+                                               PHP_RSHUTDOWN(valkey_glide),
                                                NULL,
                                                PHP_VALKEY_GLIDE_VERSION,
                                                STANDARD_MODULE_PROPERTIES};
@@ -371,10 +524,35 @@ ZEND_GET_MODULE(valkey_glide)
 void free_valkey_glide_object(zend_object* object) {
     valkey_glide_object* valkey_glide = VALKEY_GLIDE_PHP_GET_OBJECT(valkey_glide_object, object);
 
-    /* Free the Valkey Glide client if it exists */
-    if (valkey_glide->glide_client) {
+    /* Close the async connection once its outstanding requests have completed */
+    if (valkey_glide->async_ctx) {
+        valkey_glide_async_context_free(valkey_glide->async_ctx);
+        valkey_glide->async_ctx = NULL;
+    }
+
+    valkey_glide_cache_free(valkey_glide->cache);
+    valkey_glide->cache = NULL;
+    valkey_glide_route_cache_free(valkey_glide->route_cache);
+    valkey_glide->route_cache = NULL;
+    valkey_glide_batch_free(valkey_glide);
+    valkey_glide_options_free(&valkey_glide->options);
+    if (valkey_glide->last_error) {
+        zend_string_release(valkey_glide->last_error);
+        valkey_glide->last_error = NULL;
+    }
+
+    /* Free the Valkey Glide client if it exists. Pooled clients stay open for later requests. */
+    if (valkey_glide->glide_client && valkey_glide->is_persistent) {
+        valkey_glide_pool_release(valkey_glide);
+    } else if (valkey_glide->glide_client) {
         close_glide_client(valkey_glide->glide_client);
-        valkey_glide->glide_client = NULL;
+    }
+    valkey_glide->glide_client = NULL;
+    valkey_glide->pubsub       = NULL;
+
+    if (valkey_glide->connection_request) {
+        efree(valkey_glide->connection_request);
+        valkey_glide->connection_request = NULL;
     }
 
     /* Clean up the standard object */
@@ -405,6 +583,10 @@ void valkey_glide_cleanup_client_config(valkey_glide_base_client_configuration_t
             efree(config->advanced_config->tls_config);
             config->advanced_config->tls_config = NULL;
         }
+        if (config->advanced_config->client_side_cache) {
+            efree(config->advanced_config->client_side_cache);
+            config->advanced_config->client_side_cache = NULL;
+        }
         efree(config->advanced_config);
         config->advanced_config = NULL;
     }
@@ -424,7 +606,7 @@ PHP_MINFO_FUNCTION(redis)
 /* {{{ proto ValkeyGlide ValkeyGlide::__construct(array $addresses, bool $use_tls, ?array
    $credentials, ValkeyGlideReadFrom $read_from, ?int $request_timeout, ?array $reconnect_strategy,
    ?int $database_id, ?string $client_name, ?int $inflight_requests_limit, ?string $client_az,
-   ?array $advanced_config, ?bool $lazy_connect) Public constructor */
+   ?array $advanced_config, ?bool $lazy_connect, ?string $persistent_id) Public constructor */
 PHP_METHOD(ValkeyGlide, __construct) {
     valkey_glide_php_common_constructor_params_t common_params;
     valkey_glide_init_common_constructor_params(&common_params);
@@ -432,7 +614,7 @@ PHP_METHOD(ValkeyGlide, __construct) {
     zend_bool            database_id_is_null = 1;
     valkey_glide_object* valkey_glide;
 
-    ZEND_PARSE_PARAMETERS_START(1, 11)
+    ZEND_PARSE_PARAMETERS_START(1, 12)
     Z_PARAM_ARRAY(common_params.addresses)
     Z_PARAM_OPTIONAL
     Z_PARAM_BOOL(common_params.use_tls)
@@ -445,6 +627,7 @@ PHP_METHOD(ValkeyGlide, __construct) {
     Z_PARAM_STRING_OR_NULL(common_params.client_az, common_params.client_az_len)
     Z_PARAM_ARRAY_OR_NULL(common_params.advanced_config)
     Z_PARAM_BOOL_OR_NULL(common_params.lazy_connect, common_params.lazy_connect_is_null)
+    Z_PARAM_STRING_OR_NULL(common_params.persistent_id, common_params.persistent_id_len)
     ZEND_PARSE_PARAMETERS_END_EX(RETURN_THROWS());
 
     valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, getThis());
@@ -477,18 +660,14 @@ PHP_METHOD(ValkeyGlide, __construct) {
     valkey_glide_build_client_config_base(&common_params, &client_config.base, false);
 
     /* Issue the connection request. */
-    const ConnectionResponse* conn_resp = create_glide_client(&client_config);
-
-    if (conn_resp->connection_error_message) {
-        VALKEY_LOG_ERROR("php_construct", conn_resp->connection_error_message);
-        zend_throw_exception(valkey_glide_exception_ce, conn_resp->connection_error_message, 0);
-    } else {
+    if (valkey_glide_connect(valkey_glide,
+                             &client_config.base,
+                             client_config.database_id,
+                             VALKEY_GLIDE_PERIODIC_CHECKS_DISABLED,
+                             false)) {
         VALKEY_LOG_INFO("php_construct", "ValkeyGlide client created successfully");
-        valkey_glide->glide_client = conn_resp->conn_ptr;
     }
 
-    free_connection_response((ConnectionResponse*) conn_resp);
-
     /* Clean up temporary configuration structures */
     valkey_glide_cleanup_client_config(&client_config.base);
 }
@@ -504,44 +683,86 @@ PHP_METHOD(ValkeyGlide, __destruct) {
 }
 /* }}} */
 
-/* {{{ proto boolean ValkeyGlide::close()
+/* {{{ proto array ValkeyGlide::getPersistentPoolStats()
  */
-PHP_METHOD(ValkeyGlide, close) {
-    /* TODO: Implement ValkeyGlide close */
-    RETURN_TRUE;
+PHP_METHOD(ValkeyGlide, getPersistentPoolStats) {
+    if (zend_parse_parameters_none() == FAILURE) {
+        RETURN_THROWS();
+    }
+
+    valkey_glide_pool_stats(return_value);
 }
 /* }}} */
 
-/* Basic method stubs - these need to be implemented with ValkeyGlide */
-PHP_METHOD(ValkeyGlide, pipeline) { /* TODO: Implement */
-}
-PHP_METHOD(ValkeyGlide, publish) { /* TODO: Implement */
-}
-PHP_METHOD(ValkeyGlide, psubscribe) { /* TODO: Implement */
-}
-PHP_METHOD(ValkeyGlide, ssubscribe) { /* TODO: Implement */
-}
-PHP_METHOD(ValkeyGlide, subscribe) { /* TODO: Implement */
-}
-PHP_METHOD(ValkeyGlide, unsubscribe) { /* TODO: Implement */
-}
-PHP_METHOD(ValkeyGlide, punsubscribe) { /* TODO: Implement */
-}
-PHP_METHOD(ValkeyGlide, sunsubscribe) { /* TODO: Implement */
-}
+/* {{{ proto ValkeyGlideAsync ValkeyGlide::async()
+ */
+PHP_METHOD(ValkeyGlide, async) {
+    if (zend_parse_parameters_none() == FAILURE) {
+        RETURN_THROWS();
+    }
 
-PHP_METHOD(ValkeyGlide, pubsub) { /* TODO: Implement */
+    valkey_glide_async_get_proxy(getThis(), return_value);
 }
-PHP_METHOD(ValkeyGlide, eval) { /* TODO: Implement */
+/* }}} */
+
+/* {{{ proto ValkeyGlideBatchTemplate ValkeyGlide::prepareBatch(callable builder [, int type]) */
+PHP_METHOD(ValkeyGlide, prepareBatch) {
+    zend_fcall_info       fci;
+    zend_fcall_info_cache fcc;
+    zend_long             type = PIPELINE;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+    Z_PARAM_FUNC(fci, fcc)
+    Z_PARAM_OPTIONAL
+    Z_PARAM_LONG(type)
+    ZEND_PARSE_PARAMETERS_END();
+
+    valkey_glide_batch_template_prepare(getThis(), &fci, &fcc, type, return_value);
 }
-PHP_METHOD(ValkeyGlide, eval_ro) { /* TODO: Implement */
+/* }}} */
+
+/* {{{ proto array ValkeyGlide::awaitAll(array $futures)
+ */
+PHP_METHOD(ValkeyGlide, awaitAll) {
+    HashTable* futures;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+    Z_PARAM_ARRAY_HT(futures)
+    ZEND_PARSE_PARAMETERS_END();
+
+    valkey_glide_async_await_all(futures, return_value);
 }
-PHP_METHOD(ValkeyGlide, evalsha) { /* TODO: Implement */
+/* }}} */
+
+/* {{{ proto resource ValkeyGlide::getEventStream()
+ */
+PHP_METHOD(ValkeyGlide, getEventStream) {
+    if (zend_parse_parameters_none() == FAILURE) {
+        RETURN_THROWS();
+    }
+
+    valkey_glide_async_get_event_stream(return_value);
 }
-PHP_METHOD(ValkeyGlide, evalsha_ro) { /* TODO: Implement */
+/* }}} */
+
+/* {{{ proto int ValkeyGlide::poll()
+ */
+PHP_METHOD(ValkeyGlide, poll) {
+    if (zend_parse_parameters_none() == FAILURE) {
+        RETURN_THROWS();
+    }
+
+    RETURN_LONG(valkey_glide_async_poll());
 }
-PHP_METHOD(ValkeyGlide, script) { /* TODO: Implement */
+/* }}} */
+
+/* {{{ proto boolean ValkeyGlide::close()
+ */
+PHP_METHOD(ValkeyGlide, close) {
+    /* TODO: Implement ValkeyGlide close */
+    RETURN_TRUE;
 }
+/* }}} */
 
 /* ============================================================================
  * Logger PHP Functions - Bridge between PHP stub and C implementation
@@ -218,6 +218,126 @@ class ValkeyGlide
      */
     public const PIPELINE = UNKNOWN;
 
+    /**
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_OPT_SERIALIZER
+     *
+     */
+    public const OPT_SERIALIZER = UNKNOWN;
+
+    /**
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_OPT_PREFIX
+     *
+     */
+    public const OPT_PREFIX = UNKNOWN;
+
+    /**
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_OPT_NULL_MULTIBULK_AS_NULL
+     *
+     */
+    public const OPT_NULL_MULTIBULK_AS_NULL = UNKNOWN;
+
+    /**
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_OPT_COMPRESSION
+     *
+     */
+    public const OPT_COMPRESSION = UNKNOWN;
+
+    /**
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_OPT_COMPRESSION_LEVEL
+     *
+     */
+    public const OPT_COMPRESSION_LEVEL = UNKNOWN;
+
+    /**
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_OPT_COMPRESSION_MIN_SIZE
+     *
+     */
+    public const OPT_COMPRESSION_MIN_SIZE = UNKNOWN;
+
+    /**
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_OPT_LAZY_RESULTS
+     *
+     */
+    public const OPT_LAZY_RESULTS = UNKNOWN;
+
+    /**
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_SERIALIZER_NONE
+     *
+     */
+    public const SERIALIZER_NONE = UNKNOWN;
+
+    /**
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_SERIALIZER_PHP
+     *
+     */
+    public const SERIALIZER_PHP = UNKNOWN;
+
+    /**
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_SERIALIZER_IGBINARY
+     *
+     */
+    public const SERIALIZER_IGBINARY = UNKNOWN;
+
+    /**
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_SERIALIZER_MSGPACK
+     *
+     */
+    public const SERIALIZER_MSGPACK = UNKNOWN;
+
+    /**
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_SERIALIZER_JSON
+     *
+     */
+    public const SERIALIZER_JSON = UNKNOWN;
+
+    /**
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_COMPRESSION_NONE
+     *
+     */
+    public const COMPRESSION_NONE = UNKNOWN;
+
+    /**
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_COMPRESSION_ZSTD
+     *
+     */
+    public const COMPRESSION_ZSTD = UNKNOWN;
+
+    /**
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_COMPRESSION_LZ4
+     *
+     */
+    public const COMPRESSION_LZ4 = UNKNOWN;
+
     /**
      * Create a new ValkeyGlide instance with the provided configuration.
      *
@@ -232,9 +352,31 @@ class ValkeyGlide
      * @param string|null $client_name          Client name identifier.
      * @param string|null $client_az            Client availability zone.
      * @param array|null $advanced_config       Advanced configuration ['connection_timeout' => 5000,
-     *                                          'tls_config' => ['use_insecure_tls' => false]].
+     *                                          'tls_config' => ['use_insecure_tls' => false],
+     *                                          'inflight_requests_limit' => 1000,
+     *                                          'pubsub_subscriptions' => ['channels' => [...],
+     *                                          'patterns' => [...], 'sharded' => [...]],
+     *                                          'pubsub_buffer_size' => 4096,
+     *                                          'client_side_cache' => ['max_memory' => 16777216,
+     *                                          'eviction' => 'lru'|'lfu', 'mode' => 'default'|'bcast',
+     *                                          'prefixes' => [...]],
+     *                                          'shared_cache' => true|1000].
      *                                          connection_timeout is in milliseconds.
+     *                                          pubsub_subscriptions are established at connect time
+     *                                          and restored after reconnects; see getMessages().
+     *                                          client_side_cache (or true for the defaults) caches
+     *                                          read replies in the client object, invalidated by the
+     *                                          server through CLIENT TRACKING; see getCacheStats().
+     *                                          shared_cache (true, or a TTL in milliseconds) serves
+     *                                          get() from memory shared by the php-fpm workers,
+     *                                          sized by the valkey_glide.shared_cache_size INI.
      * @param bool|null $lazy_connect           Whether to use lazy connection.
+     * @param string|null $persistent_id        When set, the underlying connection is kept open in a
+     *                                          process-wide pool and reused by later requests served by
+     *                                          the same worker that pass the same persistent_id and
+     *                                          an identical configuration. A connection is used by one
+     *                                          client at a time and is reset (database, WATCH,
+     *                                          subscriptions) before it is reused.
      */
     public function __construct(
         array $addresses,
@@ -247,9 +389,62 @@ class ValkeyGlide
         ?string $client_name = null,
         ?string $client_az = null,
         ?array $advanced_config = null,
-        ?bool $lazy_connect = null
+        ?bool $lazy_connect = null,
+        ?string $persistent_id = null
     );
 
+    /**
+     * Return the persistent client pool counters for this process.
+     *
+     * The pool is shared by ValkeyGlide and ValkeyGlideCluster.
+     *
+     * @return array ['hits' => int, 'misses' => int, 'connections' => int]
+     */
+    public static function getPersistentPoolStats(): array;
+
+    /**
+     * Return a proxy that sends commands without waiting for their replies.
+     *
+     * The first call opens a second connection with the same configuration. Each call on the
+     * proxy returns a ValkeyGlideFuture, so many commands can be in flight at once. At most
+     * advanced_config['inflight_requests_limit'] requests (1000 by default) are outstanding;
+     * beyond that, sending blocks until a reply arrives.
+     *
+     * @return ValkeyGlideAsync The async command proxy.
+     */
+    public function async(): ValkeyGlideAsync;
+
+    /**
+     * Wait for a set of futures and return their results.
+     *
+     * @param array $futures An array of ValkeyGlideFuture objects.
+     *
+     * @return array The results, under the same keys as $futures. Failed commands yield false.
+     */
+    public static function awaitAll(array $futures): array;
+
+    /**
+     * Return a stream that becomes readable whenever an async command completes.
+     *
+     * Calling ValkeyGlideFuture::get() inside a Fiber (PHP 8.1+) suspends that Fiber until
+     * the reply arrives instead of blocking the process. Register this stream with the event
+     * loop, e.g. `EventLoop::onReadable(ValkeyGlide::getEventStream(), fn() => ValkeyGlide::poll())`,
+     * so those Fibers are resumed. The notification is shared by all clients in the process.
+     *
+     * @return resource A read-only stream to watch for readability.
+     */
+    public static function getEventStream();
+
+    /**
+     * Resume the Fibers whose futures have completed.
+     *
+     * Must be called from outside the suspended Fibers, typically from the event loop
+     * callback watching getEventStream().
+     *
+     * @return int The number of Fibers resumed.
+     */
+    public static function poll(): int;
+
     public function __destruct();
 
 
@@ -572,15 +767,15 @@ class ValkeyGlide
     public function del(array|string $key, string ...$other_keys): ValkeyGlide|int|false;
 
     /**
-     * TODO Discard a transaction currently in progress.
+     * Discard a transaction currently in progress.
      *
      * @return ValkeyGlide|bool  True if we could discard the transaction.
      *
      * @example
-     * $valkey_glide->set('foo', 'bar');
+     * $valkey_glide->multi()->set('foo', 'bar');
      * $valkey_glide->discard();
      */
-    /* public function discard(): ValkeyGlide|bool;*/
+    public function discard(): ValkeyGlide|bool;
 
     /**
      * Dump ValkeyGlide' internal binary representation of a key.
@@ -618,6 +813,9 @@ class ValkeyGlide
     /**
      * Execute a LUA script on the valkey server.
      *
+     * The script is invoked by its SHA1 with EVALSHA; the body is only sent when the
+     * server answers NOSCRIPT.  See ValkeyGlideScript to also skip hashing the body.
+     *
      * @see https://valkey.io/commands/eval/
      *
      * @param string $script   A string containing the LUA script
@@ -629,7 +827,7 @@ class ValkeyGlide
      * @return mixed LUA scripts may return arbitrary data so this method can return
      *               strings, arrays, nested arrays, etc.
      */
-   /*TODO  public function eval(string $script, array $args = [], int $num_keys = 0): mixed;*/
+    public function eval(string $script, array $args = [], int $num_keys = 0): mixed;
 
     /**
      * This is simply the read-only variant of eval, meaning the underlying script
@@ -637,7 +835,7 @@ class ValkeyGlide
      *
      * @see ValkeyGlide::eval_ro()
      */
-    /* TODO public function eval_ro(string $script_sha, array $args = [], int $num_keys = 0): mixed; */
+    public function eval_ro(string $script, array $args = [], int $num_keys = 0): mixed;
 
     /**
      * Execute a LUA script on the server but instead of sending the script, send
@@ -646,7 +844,8 @@ class ValkeyGlide
      * @param string $script_sha The SHA1 hash of the lua code.  Note that the script
      *                           must already exist on the server, either having been
      *                           loaded with `SCRIPT LOAD` or having been executed directly
-     *                           with `EVAL` first.
+     *                           with `EVAL` first, unless this process has seen the
+     *                           script body, in which case it is sent on NOSCRIPT.
      * @param array  $args       Arguments to send to the script.
      * @param int    $num_keys   The number of arguments that are keys
      *
@@ -656,7 +855,7 @@ class ValkeyGlide
      * @see ValkeyGlide::eval();
      *
      */
-   /* TODO public function evalsha(string $sha1, array $args = [], int $num_keys = 0): mixed; */
+    public function evalsha(string $sha1, array $args = [], int $num_keys = 0): mixed;
 
     /**
      * This is simply the read-only variant of evalsha, meaning the underlying script
@@ -664,11 +863,23 @@ class ValkeyGlide
      *
      * @see ValkeyGlide::evalsha()
      */
-    /* TODO public function evalsha_ro(string $sha1, array $args = [], int $num_keys = 0): mixed; */
+    public function evalsha_ro(string $sha1, array $args = [], int $num_keys = 0): mixed;
 
     /**
      * Execute either a MULTI or PIPELINE block and return the array of replies.
      *
+     * @param array $options Options of this batch, over those given to pipeline():
+     *                       'timeout' => milliseconds to wait for the whole batch, in place of
+     *                                    the request timeout of the client (0 for that one),
+     *                       'retry_server_error' => retry the commands failing with a TRYAGAIN
+     *                                               or a similar error (pipelines only),
+     *                       'retry_connection_error' => send again the commands whose connection
+     *                                                   was lost, which may run them twice
+     *                                                   (pipelines only),
+     *                       'raise_on_error' => fail the whole batch on the first error reply:
+     *                                           false is returned and the error is kept for
+     *                                           getLastError().
+     *
      * @return ValkeyGlide|array|false The array of pipeline'd or multi replies or false on failure.
      *
      * @see https://valkey.io/commands/exec
@@ -683,8 +894,11 @@ class ValkeyGlide
      *              ->del('list')
      *              ->rpush('list', 'one', 'two', 'three')
      *              ->exec();
+     *
+     * @example
+     * $res = $valkey_glide->pipeline()->set('foo', 'bar')->exec(['timeout' => 30000]);
      */
-    /* TODO public function exec(): ValkeyGlide|array|false; */
+    public function exec(array $options = []): ValkeyGlide|array|false;
 
     /**
      * Test if one or more keys exist.
@@ -1685,7 +1899,7 @@ class ValkeyGlide
      * $valkey_glide->get('foo');
      * $valkey_glide->exec();
      */
-    /* TODO public function multi(int $value = ValkeyGlide::MULTI): bool|ValkeyGlide; */
+    public function multi(int $value = ValkeyGlide::MULTI): bool|ValkeyGlide;
 
     public function object(string $subcommand, string $key): ValkeyGlide|int|string|false;
 
@@ -1788,6 +2002,9 @@ class ValkeyGlide
      *
      * NOTE:  That this is shorthand for ValkeyGlide::multi(ValkeyGlide::PIPELINE)
      *
+     * @param array $options Options of the exec() of the pipeline, as for ValkeyGlide::exec().
+     *                       Those given to exec() override them.
+     *
      * @return ValkeyGlide The valkey object is returned, to facilitate method chaining.
      *
      * @example
@@ -1796,8 +2013,41 @@ class ValkeyGlide
      *       ->del('mylist')
      *       ->rpush('mylist', 'a', 'b', 'c')
      *       ->exec();
+     *
+     * @example
+     * // A nightly bulk load, with a long deadline and retries
+     * $valkey_glide->pipeline(['timeout' => 600000, 'retry_connection_error' => true]);
+     */
+    public function pipeline(array $options = []): bool|ValkeyGlide;
+
+    /**
+     * Prepare a batch once, to run it any number of times with different parameters.
+     *
+     * The builder is called with the client in batch mode and buffers the commands as after
+     * multi() or pipeline(). They are compiled into a template whose execute() only copies the
+     * parameters where ValkeyGlideBatchTemplate::param() placeholders were and sends the batch,
+     * skipping the method calls and the argument conversion. Methods that cannot be batched run
+     * at once.
+     *
+     * @param callable $builder A function taking the client and buffering the commands.
+     * @param int      $type    ValkeyGlide::PIPELINE, or ValkeyGlide::MULTI for a transaction.
+     *
+     * @return ValkeyGlideBatchTemplate The compiled batch.
+     *
+     * @throws ValkeyGlideException When the builder buffered no command, or when called inside
+     *                              multi() or pipeline().
+     *
+     * @see ValkeyGlideBatchTemplate::execute()
+     *
+     * @example
+     * $tpl = $valkey_glide->prepareBatch(function ($b) {
+     *     $user = ValkeyGlideBatchTemplate::param(0);
+     *     $b->hGetAll("{u:$user}:profile");
+     *     $b->zRange("{u:$user}:feed", 0, 49);
+     * });
+     * [$profile, $feed] = $tpl->execute(['123']);
      */
-   /* TODO  public function pipeline(): bool|ValkeyGlide; */
+    public function prepareBatch(callable $builder, int $type = ValkeyGlide::PIPELINE): ValkeyGlideBatchTemplate;
 
 
     /**
@@ -1816,18 +2066,16 @@ class ValkeyGlide
     /**
      * Subscribe to one or more glob-style patterns
      *
-     * @param array     $patterns One or more patterns to subscribe to.
-     * @param callable  $cb       A callback with the following prototype:
+     * Messages are buffered by the client and read with getMessages().
      *
-     *                            <code>
-     *                            function ($valkey_glide, $channel, $message) { }
-     *                            </code>
+     * @param array $patterns One or more patterns to subscribe to.
      *
      * @see https://valkey.io/commands/psubscribe
+     * @see ValkeyGlide::getMessages()
      *
      * @return bool True if we were subscribed.
      */
-    /* TODO public function psubscribe(array $patterns, callable $cb): bool; */
+    public function psubscribe(array $patterns): bool;
 
     /**
      * Get a keys time to live in milliseconds.
@@ -1854,11 +2102,39 @@ class ValkeyGlide
      * @param string $channel The channel to publish to.
      * @param string $message The message itself.
      *
-     * @return ValkeyGlide|int The number of subscribed clients to the given channel.
+     * @return ValkeyGlide|int|false The number of subscribed clients to the given channel.
      */
-   /* TODO  public function publish(string $channel, string $message): ValkeyGlide|int|false;*/
+    public function publish(string $channel, string $message): ValkeyGlide|int|false;
 
-    /* TODO public function pubsub(string $command, mixed $arg = null): mixed;*/
+    /**
+     * Publish a message to a shard channel
+     *
+     * @see https://valkey.io/commands/spublish
+     *
+     * @param string $channel The shard channel to publish to.
+     * @param string $message The message itself.
+     *
+     * @return ValkeyGlide|int|false The number of clients that received the message.
+     */
+    public function spublish(string $channel, string $message): ValkeyGlide|int|false;
+
+    /**
+     * Introspect the Pub/Sub system.
+     *
+     * @see https://valkey.io/commands/pubsub
+     *
+     * @param string $command One of 'channels', 'numsub', 'numpat', 'shardchannels' or
+     *                        'shardnumsub'.
+     * @param mixed  $arg     The pattern for 'channels'/'shardchannels', the array of channels
+     *                        for 'numsub'/'shardnumsub'.
+     *
+     * @return mixed An array of channels, an array of channel => subscriber count, or the number
+     *               of pattern subscriptions. False on failure.
+     *
+     * @example $valkey_glide->pubsub('channels', 'news.*');
+     * @example $valkey_glide->pubsub('numsub', ['news.tech', 'news.sport']);
+     */
+    public function pubsub(string $command, mixed $arg = null): mixed;
 
     /**
      * Unsubscribe from one or more channels by pattern
@@ -1867,11 +2143,12 @@ class ValkeyGlide
      * @see https://valkey.io/commands/subscribe
      * @see ValkeyGlide::subscribe()
      *
-     * @param array $patterns One or more glob-style patterns of channel names.
+     * @param array $patterns One or more glob-style patterns of channel names, or none to
+     *                        unsubscribe from every pattern.
      *
-     * @return ValkeyGlide|array|bool  The array of subscribed patterns or false on failure.
+     * @return bool True on success, false on failure.
      */
-   /* public function punsubscribe(array $patterns): ValkeyGlide|array|bool;*/
+    public function punsubscribe(array $patterns = []): bool;
 
     /**
      * Pop one or more elements from the end of a list.
@@ -2320,7 +2597,7 @@ class ValkeyGlide
      * @example $valkey_glide->script('load', 'return 1');
      * @example $valkey_glide->script('exists', sha1('return 1'));
      */
-    /* TODO public function script(string $command, mixed ...$args): mixed; */
+    public function script(string $command, mixed ...$args): mixed;
 
     /**
      * Select a specific ValkeyGlide database.
@@ -2565,33 +2842,16 @@ class ValkeyGlide
     /**
      * Subscribes the client to the specified shard channels.
      *
-     * @param array    $channels One or more channel names.
-     * @param callable $cb       The callback PhpValkeyGlide will invoke when we receive a message
-     *                           from one of the subscribed channels.
+     * Messages are buffered by the client and read with getMessages().
      *
-     * @return bool True on success, false on faiilure.  Note that this command will block the
-     *              client in a subscribe loop, waiting for messages to arrive.
-     *
-     * @see https://valkey.io/commands/ssubscribe
-     *
-     * @example
-     * $valkey_glide = new ValkeyGlide(['host' => 'localhost']);
+     * @param array $channels One or more channel names.
      *
-     * $valkey_glide->ssubscribe(['channel-1', 'channel-2'], function ($valkey_glide, $channel, $message) {
-     *     echo "[$channel]: $message\n";
+     * @return bool True on success, false on failure.
      *
-     *     // Unsubscribe from the message channel when we read 'quit'
-     *     if ($message == 'quit') {
-     *         echo "Unsubscribing from '$channel'\n";
-     *         $valkey_glide->sunsubscribe([$channel]);
-     *     }
-     * });
-     *
-     * // Once we read 'quit' from both channel-1 and channel-2 the subscribe loop will be
-     * // broken and this command will execute.
-     * echo "Subscribe loop ended\n";
+     * @see https://valkey.io/commands/ssubscribe
+     * @see ValkeyGlide::getMessages()
      */
-    /* TODO public function ssubscribe(array $channels, callable $cb): bool; */
+    public function ssubscribe(array $channels): bool;
 
     /**
      * Retrieve the length of a ValkeyGlide STRING key.
@@ -2610,57 +2870,151 @@ class ValkeyGlide
     /**
      * Subscribe to one or more ValkeyGlide pubsub channels.
      *
-     * @param array    $channels One or more channel names.
-     * @param callable $cb       The callback PhpValkeyGlide will invoke when we receive a message
-     *                           from one of the subscribed channels.
+     * Subscribing does not block: messages are buffered by the client as they arrive and read
+     * in batches with getMessages(). The client can keep sending other commands meanwhile.
      *
-     * @return bool True on success, false on faiilure.  Note that this command will block the
-     *              client in a subscribe loop, waiting for messages to arrive.
+     * @param array $channels One or more channel names.
+     *
+     * @return bool True on success, false on failure.
      *
      * @see https://valkey.io/commands/subscribe
+     * @see ValkeyGlide::getMessages()
      *
      * @example
-     * $valkey_glide = new ValkeyGlide(['host' => 'localhost']);
+     * $valkey_glide = new ValkeyGlide([['host' => 'localhost', 'port' => 6379]]);
      *
-     * $valkey_glide->subscribe(['channel-1', 'channel-2'], function ($valkey_glide, $channel, $message) {
-     *     echo "[$channel]: $message\n";
+     * $valkey_glide->subscribe(['channel-1', 'channel-2']);
      *
-     *     // Unsubscribe from the message channel when we read 'quit'
-     *     if ($message == 'quit') {
-     *         echo "Unsubscribing from '$channel'\n";
-     *         $valkey_glide->unsubscribe([$channel]);
+     * while (true) {
+     *     foreach ($valkey_glide->getMessages(100, 1.0) as $msg) {
+     *         echo "[{$msg['channel']}]: {$msg['message']}\n";
      *     }
-     * });
-     *
-     * // Once we read 'quit' from both channel-1 and channel-2 the subscribe loop will be
-     * // broken and this command will execute.
-     * echo "Subscribe loop ended\n";
+     * }
      */
-    /* TODO public function subscribe(array $channels, callable $cb): bool; */
+    public function subscribe(array $channels): bool;
 
     /**
      * Unsubscribes the client from the given shard channels,
      * or from all of them if none is given.
      *
      * @param array $channels One or more channels to unsubscribe from.
-     * @return ValkeyGlide|array|bool The array of unsubscribed channels.
+     * @return bool True on success, false on failure.
      *
      * @see https://valkey.io/commands/sunsubscribe
      * @see ValkeyGlide::ssubscribe()
+     */
+    public function sunsubscribe(array $channels = []): bool;
+
+    /**
+     * Read the Pub/Sub messages buffered since the last call.
+     *
+     * Messages for every subscription (connect-time or dynamic) are queued by the client in a
+     * bounded buffer (advanced_config['pubsub_buffer_size'], 4096 by default). When it is full,
+     * new messages are dropped and a warning is logged.
+     *
+     * @param int   $max     The maximum number of messages to return.
+     * @param float $timeout Seconds to wait for a message when none is buffered, 0 to return
+     *                       immediately.
+     *
+     * @return array|false A list of ['kind' => 'message'|'pmessage'|'smessage',
+     *                     'channel' => ..., 'message' => ...] entries, with an additional
+     *                     'pattern' for pmessage and the channel's hash 'slot' for smessage.
+     *                     False on failure.
      *
      * @example
-     * $valkey_glide->ssubscribe(['channel-1', 'channel-2'], function ($valkey_glide, $channel, $message) {
-     *     if ($message == 'quit') {
-     *         echo "$channel => 'quit' detected, unsubscribing!\n";
-     *         $valkey_glide->sunsubscribe([$channel]);
-     *     } else {
-     *         echo "$channel => $message\n";
-     *     }
-     * });
+     * $valkey_glide->subscribe(['news']);
+     * $messages = $valkey_glide->getMessages(1000, 0.5);
+     */
+    public function getMessages(int $max = 100, float $timeout = 0): array|false;
+
+    /**
+     * Report on the client-side cache.
+     *
+     * Read commands (get, hGet, hGetAll, sMembers, zRange...) are answered from the cache when
+     * advanced_config['client_side_cache'] is set. The server invalidates entries when their key
+     * changes, and a write of this client drops the entries of its keys when it returns; in
+     * 'bcast' mode only keys matching the configured prefixes are cached.
+     *
+     * With advanced_config['shared_cache'], get() replies are also kept for their TTL in a
+     * segment shared by all the worker processes. Entries expire early when a client of the
+     * worker with a client_side_cache receives an invalidation for their key. Entries are shared
+     * by the clients connected to the same database: after select() to another database, get()
+     * goes to the server, and select() empties the client-side cache.
+     *
+     * @return array|false ['entries', 'memory', 'max_memory', 'hits', 'misses', 'evictions',
+     *                     'invalidations', 'eviction'] for the client-side cache, and 'shared' =>
+     *                     ['slots', 'hits', 'misses', 'stores', 'ttl'] for the shared cache (hits,
+     *                     misses and stores of this process), or false if neither is enabled.
+     */
+    public function getCacheStats(): array|false;
+
+    /**
+     * Set a client option.
+     *
+     * OPT_SERIALIZER (a SERIALIZER_* constant) serializes the values written by set, setEx,
+     * pSetEx, setNx, getSet, mSet, hSet, hMSet, hSetNx, lPush, rPush, lPushx, rPushx and zAdd,
+     * and the members of the sorted set commands, and unserializes what get, mGet, getDel,
+     * getEx, hGet, hMGet, hVals, hGetAll, lPop, rPop, lRange, lIndex and lMove return. SERIALIZER_IGBINARY and SERIALIZER_MSGPACK are available when the
+     * extension was built with --enable-valkey-glide-igbinary / --enable-valkey-glide-msgpack.
+     *
+     * OPT_PREFIX prepends a string to every key; null or '' removes it.
+     *
+     * OPT_NULL_MULTIBULK_AS_NULL returns null rather than false for missing replies.
+     *
+     * OPT_COMPRESSION (a COMPRESSION_* constant) compresses those same values, after the
+     * serializer, when they are at least OPT_COMPRESSION_MIN_SIZE bytes long (256 by default). OPT_COMPRESSION_LEVEL picks the level, 0 for the default of
+     * the algorithm. Compressed values carry a small header, so the values written before the
+     * option was set are still read as they are. COMPRESSION_LZ4 and COMPRESSION_ZSTD are
+     * available when the extension was built with --enable-valkey-glide-lz4 /
+     * --enable-valkey-glide-zstd.
+     *
+     * OPT_LAZY_RESULTS (a number of elements, 0 to disable) returns list replies of at least
+     * that many elements as a ValkeyGlideResult, which converts an element when it is read.
+     *
+     * @param int   $option One of the OPT_* constants.
+     * @param mixed $value  The value of the option.
+     *
+     * @return bool True on success, false for an unknown option, serializer or compression.
+     *
+     * @example
+     * $valkey_glide->setOption(ValkeyGlide::OPT_SERIALIZER, ValkeyGlide::SERIALIZER_PHP);
+     * $valkey_glide->set('user', ['name' => 'Ada']);
+     */
+    public function setOption(int $option, mixed $value): bool;
+
+    /**
+     * Get a client option set with setOption().
+     *
+     * @param int $option One of the OPT_* constants.
      *
-     * echo "We've unsubscribed from both channels, exiting\n";
+     * @return mixed The value of the option, or false for an unknown option.
      */
-    /* TODO public function sunsubscribe(array $channels): ValkeyGlide|array|bool; */
+    public function getOption(int $option): mixed;
+
+    /**
+     * Get the error message of the last command that failed.
+     *
+     * Commands the server rejects (WRONGTYPE, NOSCRIPT, EXECABORT, ...) return false and keep
+     * their error here until clearLastError() is called; a later successful command does not
+     * clear it. Timeouts and lost connections throw a ValkeyGlideTimeoutException or a
+     * ValkeyGlideConnectionException, and are recorded here as well.
+     *
+     * @return string|null The message, or null if no command failed since the last
+     *                     clearLastError().
+     *
+     * @example
+     * if ($valkey_glide->lPush('a-string-key', 'x') === false) {
+     *     echo $valkey_glide->getLastError();
+     * }
+     */
+    public function getLastError(): ?string;
+
+    /**
+     * Forget the error of the last command that failed.
+     *
+     * @return bool Always true.
+     */
+    public function clearLastError(): bool;
 
 
     /**
@@ -2738,25 +3092,16 @@ class ValkeyGlide
     /**
      * Unsubscribe from one or more subscribed channels.
      *
-     * @param array $channels One or more channels to unsubscribe from.
-     * @return ValkeyGlide|array|bool The array of unsubscribed channels.
+     * @param array $channels One or more channels to unsubscribe from, or none to unsubscribe
+     *                        from every channel.
+     * @return bool True on success, false on failure.
      *
      * @see https://valkey.io/commands/unsubscribe
      * @see ValkeyGlide::subscribe()
      *
-     * @example
-     * $valkey_glide->subscribe(['channel-1', 'channel-2'], function ($valkey_glide, $channel, $message) {
-     *     if ($message == 'quit') {
-     *         echo "$channel => 'quit' detected, unsubscribing!\n";
-     *         $valkey_glide->unsubscribe([$channel]);
-     *     } else {
-     *         echo "$channel => $message\n";
-     *     }
-     * });
-     *
-     * echo "We've unsubscribed from both channels, exiting\n";
+     * @example $valkey_glide->unsubscribe(['channel-1']);
      */
-    /* TODO public function unsubscribe(array $channels): ValkeyGlide|array|bool; */
+    public function unsubscribe(array $channels = []): bool;
 
     /**
      * Remove any previously WATCH'ed keys in a transaction.
@@ -3832,3 +4177,19 @@ class ValkeyGlide
 class ValkeyGlideException extends RuntimeException
 {
 }
+
+/**
+ * A command that got no reply within the request timeout. The code is the error type of the
+ * client library.
+ */
+class ValkeyGlideTimeoutException extends ValkeyGlideException
+{
+}
+
+/**
+ * A command whose connection was lost before it got a reply. The code is the error type of the
+ * client library.
+ */
+class ValkeyGlideConnectionException extends ValkeyGlideException
+{
+}
@@ -0,0 +1,191 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Command Argument Arena                                  |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#include "valkey_glide_arena.h"
+
+#include "valkey_glide_format.h"
+
+struct _valkey_glide_arena_chunk {
+    valkey_glide_arena_chunk* next;
+    size_t                    size; /* Of data */
+    uint64_t                  data[];
+};
+
+/* The scopes and chunks belong to the thread running the commands, so a ZTS build keeps one
+ * set per thread */
+
+/* Innermost open scope */
+static ZEND_TLS valkey_glide_arena* arena_current = NULL;
+
+/* Chunks handed to the open scopes, the newest first, so a scope gives back the chunks above
+ * its mark when it is left */
+static ZEND_TLS valkey_glide_arena_chunk* arena_in_use = NULL;
+
+/* Chunks kept for later scopes, and their total size */
+static ZEND_TLS valkey_glide_arena_chunk* arena_spare      = NULL;
+static ZEND_TLS size_t                    arena_spare_size = 0;
+
+static inline bool arena_contains(const char* start, size_t size, const void* ptr) {
+    return (const char*) ptr >= start && (const char*) ptr < start + size;
+}
+
+static void arena_keep_chunk(valkey_glide_arena_chunk* chunk) {
+    if (arena_spare_size + chunk->size > VALKEY_GLIDE_ARENA_SPARE_LIMIT) {
+        pefree(chunk, 1);
+        return;
+    }
+    chunk->next = arena_spare;
+    arena_spare = chunk;
+    arena_spare_size += chunk->size;
+}
+
+/* Continue the current scope in a chunk with room for size bytes */
+static void arena_grow(valkey_glide_arena* arena, size_t size) {
+    valkey_glide_arena_chunk** link = &arena_spare;
+    valkey_glide_arena_chunk*  chunk;
+
+    while (*link && (*link)->size < size) {
+        link = &(*link)->next;
+    }
+    if (*link) {
+        chunk = *link;
+        *link = chunk->next;
+        arena_spare_size -= chunk->size;
+    } else {
+        size_t chunk_size = MAX(size, VALKEY_GLIDE_ARENA_CHUNK_SIZE);
+
+        /* Persistent, so the chunk can be kept for the commands of the next request */
+        chunk       = pemalloc(sizeof(valkey_glide_arena_chunk) + chunk_size, 1);
+        chunk->size = chunk_size;
+    }
+
+    chunk->next  = arena_in_use;
+    arena_in_use = chunk;
+    arena->pos   = (char*) chunk->data;
+    arena->end   = (char*) chunk->data + chunk->size;
+}
+
+void valkey_glide_arena_enter(valkey_glide_arena* arena) {
+    arena->pos    = (char*) arena->stack;
+    arena->end    = (char*) arena->stack + sizeof(arena->stack);
+    arena->mark   = arena_in_use;
+    arena->parent = arena_current;
+    arena_current = arena;
+}
+
+void valkey_glide_arena_leave(valkey_glide_arena* arena) {
+    while (arena_in_use && arena_in_use != arena->mark) {
+        valkey_glide_arena_chunk* chunk = arena_in_use;
+
+        arena_in_use = chunk->next;
+        arena_keep_chunk(chunk);
+    }
+    arena_current = arena->parent;
+}
+
+void* valkey_glide_arena_alloc(size_t size) {
+    valkey_glide_arena* arena = arena_current;
+    void*               ptr;
+
+    if (!arena) {
+        return emalloc(size);
+    }
+
+    size = ZEND_MM_ALIGNED_SIZE(size);
+    if ((size_t) (arena->end - arena->pos) < size) {
+        arena_grow(arena, size);
+    }
+    ptr = arena->pos;
+    arena->pos += size;
+    return ptr;
+}
+
+void* valkey_glide_arena_calloc(size_t count, size_t size) {
+    size_t total = zend_safe_address_guarded(count, size, 0);
+    void*  ptr   = valkey_glide_arena_alloc(total);
+
+    memset(ptr, 0, total);
+    return ptr;
+}
+
+void valkey_glide_arena_release(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+
+    /* Scope memory goes back when the scope is left */
+    for (valkey_glide_arena* arena = arena_current; arena; arena = arena->parent) {
+        if (arena_contains((const char*) arena->stack, sizeof(arena->stack), ptr)) {
+            return;
+        }
+    }
+    for (valkey_glide_arena_chunk* chunk = arena_in_use; chunk; chunk = chunk->next) {
+        if (arena_contains((const char*) chunk->data, chunk->size, ptr)) {
+            return;
+        }
+    }
+
+    efree(ptr);
+}
+
+char* valkey_glide_arena_strndup(const char* str, size_t len) {
+    char* copy = valkey_glide_arena_alloc(len + 1);
+
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+char* valkey_glide_arena_format_long(int64_t value, size_t* len) {
+    char* str = valkey_glide_arena_alloc(VALKEY_GLIDE_FORMAT_LONG_SIZE);
+
+    *len = valkey_glide_format_long(value, str);
+    return str;
+}
+
+char* valkey_glide_arena_format_double(double value, size_t* len) {
+    char* str = valkey_glide_arena_alloc(VALKEY_GLIDE_FORMAT_DOUBLE_SIZE);
+
+    *len = valkey_glide_format_double(value, str);
+    return str;
+}
+
+static void arena_free_spare(void) {
+    while (arena_spare) {
+        valkey_glide_arena_chunk* chunk = arena_spare;
+
+        arena_spare = chunk->next;
+        pefree(chunk, 1);
+    }
+    arena_spare_size = 0;
+}
+
+void valkey_glide_arena_request_shutdown(void) {
+    /* A fatal error unwinds past valkey_glide_arena_leave(); those stack frames are gone */
+    while (arena_in_use) {
+        valkey_glide_arena_chunk* chunk = arena_in_use;
+
+        arena_in_use = chunk->next;
+        arena_keep_chunk(chunk);
+    }
+    arena_current = NULL;
+#ifdef ZTS
+    /* MSHUTDOWN only sees the chunks of its own thread, the others go with their request */
+    arena_free_spare();
+#endif
+}
+
+void valkey_glide_arena_shutdown(void) {
+    valkey_glide_arena_request_shutdown();
+    arena_free_spare();
+}
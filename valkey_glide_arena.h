@@ -0,0 +1,74 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Command Argument Arena                                  |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef VALKEY_GLIDE_ARENA_H
+#define VALKEY_GLIDE_ARENA_H
+
+#include "php.h"
+
+/*
+ * Scratch memory for the argument vector of a command: the pointer and length arrays, the
+ * formatted numbers and the other strings that only live until the command was sent.
+ *
+ * The command framework opens a scope around each command, with a buffer on its own stack.
+ * Allocations are bumped off that buffer, then off heap chunks that are kept for the next
+ * commands of the process once it is full. Leaving the scope gives everything back at once.
+ * The scopes and chunks are per thread; a ZTS build frees the spare chunks with the request.
+ *
+ * valkey_glide_arena_alloc() falls back to emalloc() outside of a scope, and
+ * valkey_glide_arena_release() to efree() for memory that is not from a scope, so the
+ * preparers can use them without knowing which path they were called on.
+ */
+
+/* Covers the arrays and numbers of a command with a few dozen arguments */
+#define VALKEY_GLIDE_ARENA_STACK_SIZE 2048
+
+/* Heap chunks are at least this large */
+#define VALKEY_GLIDE_ARENA_CHUNK_SIZE (16 * 1024)
+
+/* Spare heap chunks kept between commands, in bytes; larger leftovers are freed */
+#define VALKEY_GLIDE_ARENA_SPARE_LIMIT (256 * 1024)
+
+typedef struct _valkey_glide_arena_chunk valkey_glide_arena_chunk;
+
+typedef struct _valkey_glide_arena {
+    char*                       pos;
+    char*                       end;
+    valkey_glide_arena_chunk*   mark;   /* Chunks in use when the scope was entered */
+    struct _valkey_glide_arena* parent; /* Scope of the command that ran this one, if any */
+    uint64_t                    stack[VALKEY_GLIDE_ARENA_STACK_SIZE / sizeof(uint64_t)];
+} valkey_glide_arena;
+
+/* Scopes nest: a command issued while preparing another (from a serializer callback) gets a
+ * scope of its own */
+void valkey_glide_arena_enter(valkey_glide_arena* arena);
+void valkey_glide_arena_leave(valkey_glide_arena* arena);
+
+void* valkey_glide_arena_alloc(size_t size);
+void* valkey_glide_arena_calloc(size_t count, size_t size);
+void  valkey_glide_arena_release(void* ptr);
+
+/* Copy of a string, NUL terminated */
+char* valkey_glide_arena_strndup(const char* str, size_t len);
+
+/* Decimal form of a number, formatted in place (see valkey_glide_format.h) */
+char* valkey_glide_arena_format_long(int64_t value, size_t* len);
+char* valkey_glide_arena_format_double(double value, size_t* len);
+
+/* Drop the scopes a bailout left open, from RSHUTDOWN */
+void valkey_glide_arena_request_shutdown(void);
+
+/* Free the spare chunks, from MSHUTDOWN */
+void valkey_glide_arena_shutdown(void);
+
+#endif /* VALKEY_GLIDE_ARENA_H */
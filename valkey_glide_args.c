@@ -0,0 +1,215 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Command Argument Vector                                 |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#include "valkey_glide_args.h"
+
+#include "valkey_glide_arena.h"
+#include "valkey_glide_options.h"
+
+void valkey_glide_args_init(valkey_glide_args* args) {
+    args->args          = args->inline_args;
+    args->lens          = args->inline_lens;
+    args->count         = 0;
+    args->capacity      = VALKEY_GLIDE_ARGS_INLINE;
+    args->held          = NULL;
+    args->held_count    = 0;
+    args->held_capacity = 0;
+    args->failed        = false;
+}
+
+void valkey_glide_args_free(valkey_glide_args* args) {
+    for (uint32_t i = 0; i < args->held_count; i++) {
+        if (args->held[i].str) {
+            zend_string_release(args->held[i].str);
+        } else {
+            valkey_glide_arena_release(args->held[i].owner);
+        }
+    }
+    if (args->held) {
+        valkey_glide_arena_release(args->held);
+    }
+    if (args->args != args->inline_args) {
+        valkey_glide_arena_release(args->args);
+        valkey_glide_arena_release(args->lens);
+    }
+    valkey_glide_args_init(args);
+}
+
+static void args_grow(valkey_glide_args* args) {
+    unsigned long  capacity = args->capacity * 2;
+    uintptr_t*     ptrs     = valkey_glide_arena_alloc(capacity * sizeof(uintptr_t));
+    unsigned long* lens     = valkey_glide_arena_alloc(capacity * sizeof(unsigned long));
+
+    memcpy(ptrs, args->args, args->count * sizeof(uintptr_t));
+    memcpy(lens, args->lens, args->count * sizeof(unsigned long));
+    if (args->args != args->inline_args) {
+        valkey_glide_arena_release(args->args);
+        valkey_glide_arena_release(args->lens);
+    }
+    args->args     = ptrs;
+    args->lens     = lens;
+    args->capacity = capacity;
+}
+
+static void args_hold(valkey_glide_args* args, zend_string* str, char* owner) {
+    if (args->held_count == args->held_capacity) {
+        uint32_t                capacity = args->held_capacity ? args->held_capacity * 2 : 4;
+        valkey_glide_args_held* held =
+            valkey_glide_arena_alloc(capacity * sizeof(valkey_glide_args_held));
+
+        if (args->held) {
+            memcpy(held, args->held, args->held_count * sizeof(valkey_glide_args_held));
+            valkey_glide_arena_release(args->held);
+        }
+        args->held          = held;
+        args->held_capacity = capacity;
+    }
+    args->held[args->held_count].str   = str;
+    args->held[args->held_count].owner = owner;
+    args->held_count++;
+}
+
+void valkey_glide_args_add(valkey_glide_args* args, const char* str, size_t len) {
+    if (args->count == args->capacity) {
+        args_grow(args);
+    }
+    args->args[args->count] = (uintptr_t) str;
+    args->lens[args->count] = len;
+    args->count++;
+}
+
+void valkey_glide_args_add_long(valkey_glide_args* args, zend_long value) {
+    size_t len;
+    char*  str = valkey_glide_arena_format_long(value, &len);
+
+    args_hold(args, NULL, str);
+    valkey_glide_args_add(args, str, len);
+}
+
+void valkey_glide_args_add_double(valkey_glide_args* args, double value) {
+    size_t len;
+    char*  str = valkey_glide_arena_format_double(value, &len);
+
+    args_hold(args, NULL, str);
+    valkey_glide_args_add(args, str, len);
+}
+
+/* The string form of a non-string zval, held until the vector is freed */
+static zend_string* args_convert(valkey_glide_args* args, zval* value) {
+    zend_string* str = zval_try_get_string(value);
+
+    if (!str) {
+        args->failed = true;
+        return NULL;
+    }
+    args_hold(args, str, NULL);
+    return str;
+}
+
+bool valkey_glide_args_add_zval(valkey_glide_args* args, zval* value) {
+    zend_string* str;
+
+    ZVAL_DEREF(value);
+    if (Z_TYPE_P(value) == IS_STRING) {
+        valkey_glide_args_add(args, Z_STRVAL_P(value), Z_STRLEN_P(value));
+        return true;
+    }
+    /* Same digits as PHP. Doubles go through PHP, which writes large ones as "1.0E+25": a
+     * member must not change with the path it took. */
+    if (Z_TYPE_P(value) == IS_LONG) {
+        valkey_glide_args_add_long(args, Z_LVAL_P(value));
+        return true;
+    }
+    if (!(str = args_convert(args, value))) {
+        return false;
+    }
+    valkey_glide_args_add(args, ZSTR_VAL(str), ZSTR_LEN(str));
+    return true;
+}
+
+void valkey_glide_args_add_key(valkey_glide_args* args, const char* key, size_t key_len) {
+    char*       owner;
+    size_t      len;
+    const char* full =
+        valkey_glide_prefix_key(valkey_glide_current_options(), key, key_len, &len, &owner);
+
+    if (owner) {
+        args_hold(args, NULL, owner);
+    }
+    valkey_glide_args_add(args, full, len);
+}
+
+bool valkey_glide_args_add_key_zval(valkey_glide_args* args, zval* key) {
+    zend_string* str;
+
+    ZVAL_DEREF(key);
+    if (Z_TYPE_P(key) == IS_STRING) {
+        valkey_glide_args_add_key(args, Z_STRVAL_P(key), Z_STRLEN_P(key));
+        return true;
+    }
+    if (!(str = args_convert(args, key))) {
+        return false;
+    }
+    valkey_glide_args_add_key(args, ZSTR_VAL(str), ZSTR_LEN(str));
+    return true;
+}
+
+bool valkey_glide_args_add_value(valkey_glide_args* args, zval* value) {
+    const char* str;
+    char*       owner;
+    size_t      len;
+
+    if (!(str = valkey_glide_serialize(valkey_glide_current_options(), value, &len, &owner))) {
+        args->failed = true;
+        return false;
+    }
+    if (owner) {
+        args_hold(args, NULL, owner);
+    }
+    valkey_glide_args_add(args, str, len);
+    return true;
+}
+
+bool valkey_glide_args_add_value_string(valkey_glide_args* args,
+                                        const char*        value,
+                                        size_t             value_len) {
+    const char* str;
+    char*       owner;
+    size_t      len;
+
+    str = valkey_glide_serialize_string(
+        valkey_glide_current_options(), value, value_len, &len, &owner);
+    if (!str) {
+        args->failed = true;
+        return false;
+    }
+    if (owner) {
+        args_hold(args, NULL, owner);
+    }
+    valkey_glide_args_add(args, str, len);
+    return true;
+}
+
+CommandResult* valkey_glide_args_execute(const void*        glide_client,
+                                         enum RequestType   cmd_type,
+                                         valkey_glide_args* args,
+                                         zval*              route) {
+    if (args->failed) {
+        return NULL;
+    }
+    if (route) {
+        return execute_command_with_route(
+            glide_client, cmd_type, args->count, args->args, args->lens, route);
+    }
+    return execute_command(glide_client, cmd_type, args->count, args->args, args->lens);
+}
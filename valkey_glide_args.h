@@ -0,0 +1,87 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Command Argument Vector                                 |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef VALKEY_GLIDE_ARGS_H
+#define VALKEY_GLIDE_ARGS_H
+
+#include "command_response.h"
+#include "php.h"
+
+/*
+ * The argument vector of a command, built by the preparers and handed to command().
+ *
+ * Nothing is copied on the way in. Strings, string zvals and literals go into the vector as
+ * pointers to their buffers, so they must outlive the command. Other zvals are converted once
+ * and the vector holds the reference to the converted zend_string. Numbers are formatted into
+ * the argument arena, prefixed keys and serialized values are kept as owners.
+ * valkey_glide_args_free() releases all of it, so the builder also works outside of an arena
+ * scope.
+ *
+ * The first VALKEY_GLIDE_ARGS_INLINE arguments live in the builder itself, so most commands
+ * build their vector without an allocation. Longer vectors move to the arena. The builder
+ * points into itself: declare it where it is used and do not copy it.
+ */
+
+#define VALKEY_GLIDE_ARGS_INLINE 16
+
+/* A converted zend_string, or memory given back with valkey_glide_arena_release() */
+typedef struct _valkey_glide_args_held {
+    zend_string* str;
+    char*        owner;
+} valkey_glide_args_held;
+
+typedef struct _valkey_glide_args {
+    uintptr_t*              args;
+    unsigned long*          lens;
+    unsigned long           count;
+    unsigned long           capacity;
+    valkey_glide_args_held* held;
+    uint32_t                held_count;
+    uint32_t                held_capacity;
+    bool                    failed; /* An argument could not be converted, nothing is sent */
+    uintptr_t               inline_args[VALKEY_GLIDE_ARGS_INLINE];
+    unsigned long           inline_lens[VALKEY_GLIDE_ARGS_INLINE];
+} valkey_glide_args;
+
+void valkey_glide_args_init(valkey_glide_args* args);
+void valkey_glide_args_free(valkey_glide_args* args);
+
+/* Borrow len bytes at str */
+void valkey_glide_args_add(valkey_glide_args* args, const char* str, size_t len);
+
+#define valkey_glide_args_add_literal(args, literal) \
+    valkey_glide_args_add((args), (literal), sizeof(literal) - 1)
+
+void valkey_glide_args_add_long(valkey_glide_args* args, zend_long value);
+void valkey_glide_args_add_double(valkey_glide_args* args, double value);
+
+/* A zval as PHP converts it to a string, borrowed when it is one. Returns false when the
+ * conversion threw. */
+bool valkey_glide_args_add_zval(valkey_glide_args* args, zval* value);
+
+/* A key, with OPT_PREFIX prepended */
+void valkey_glide_args_add_key(valkey_glide_args* args, const char* key, size_t key_len);
+bool valkey_glide_args_add_key_zval(valkey_glide_args* args, zval* key);
+
+/* A value through the serializer and the compressor set with setOption(). Without them,
+ * scalars only: strings are borrowed, arrays and objects fail. */
+bool valkey_glide_args_add_value(valkey_glide_args* args, zval* value);
+bool valkey_glide_args_add_value_string(valkey_glide_args* args, const char* value, size_t len);
+
+/* Send the command, to route when it is not NULL. NULL when an argument failed. */
+CommandResult* valkey_glide_args_execute(const void*        glide_client,
+                                         enum RequestType   cmd_type,
+                                         valkey_glide_args* args,
+                                         zval*              route);
+
+#endif /* VALKEY_GLIDE_ARGS_H */
@@ -0,0 +1,1033 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Async Commands                                          |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#include "valkey_glide_async.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <zend_exceptions.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+#if PHP_VERSION_ID >= 80100
+#include <zend_fibers.h>
+#include <zend_interfaces.h>
+#endif
+
+#include "command_response.h"
+#include "include/glide_bindings.h"
+#include "valkey_glide_async_arginfo.h"
+#include "valkey_glide_batch.h"
+#include "valkey_glide_commands_common.h"
+#include "valkey_glide_options.h"
+
+/* Class entries and handlers */
+zend_class_entry*           valkey_glide_future_ce;
+zend_class_entry*           valkey_glide_async_ce;
+static zend_object_handlers valkey_glide_future_object_handlers;
+static zend_object_handlers valkey_glide_async_object_handlers;
+
+#define VALKEY_GLIDE_ASYNC_PENDING 0
+#define VALKEY_GLIDE_ASYNC_DONE 1
+#define VALKEY_GLIDE_ASYNC_FAILED 2
+
+/*
+ * Per-client async state. The FFI client created with the AsyncClient type returns from
+ * command() immediately and reports completion through the callbacks below, on Glide's runtime
+ * threads. Those threads must not touch the Zend allocator, so everything they share with PHP
+ * is malloc'd and guarded by the context lock.
+ */
+struct valkey_glide_async_context {
+    const void*     glide_client; /* FFI client created with the AsyncClient type */
+    pthread_mutex_t lock;
+    pthread_cond_t  cond; /* Broadcast on every completion */
+    int             inflight;
+    int             inflight_limit;
+};
+
+struct valkey_glide_async_request {
+    valkey_glide_async_context* ctx;
+    int                         state;    /* VALKEY_GLIDE_ASYNC_PENDING/DONE/FAILED */
+    bool                        orphaned; /* Given up on first, the callback releases us */
+    CommandResponse*            response; /* Free with free_command_response() */
+    char*                       error;    /* malloc'd copy of the FFI error message */
+    enum RequestErrorType       error_type;
+};
+
+/*
+ * Completion notification for event loops. Once requested, every completion writes to this
+ * descriptor (an eventfd on Linux, a non-blocking pipe elsewhere), so a loop can watch it and
+ * call ValkeyGlide::poll() to resume the Fibers waiting on futures. The descriptor is shared by
+ * all clients of the process.
+ */
+static atomic_int notify_read_fd  = -1;
+static atomic_int notify_write_fd = -1;
+
+#if PHP_VERSION_ID >= 80100
+/* Futures whose get() suspended the calling Fiber, keyed by object handle */
+static ZEND_TLS HashTable* waiting_futures = NULL;
+
+/* A Fiber suspended by a call through ValkeyGlideAsync until its client has a free slot */
+typedef struct {
+    zval                        fiber;
+    valkey_glide_async_context* ctx;
+} valkey_glide_waiting_sender;
+
+/* Fibers waiting for a slot, keyed by Fiber handle */
+static ZEND_TLS HashTable* waiting_senders = NULL;
+#endif
+
+#define VALKEY_GLIDE_FUTURE_GET_OBJECT(obj) \
+    VALKEY_GLIDE_PHP_GET_OBJECT(valkey_glide_future_object, obj)
+#define VALKEY_GLIDE_ASYNC_GET_OBJECT(obj) \
+    VALKEY_GLIDE_PHP_GET_OBJECT(valkey_glide_async_object, obj)
+
+/* ====================================================================
+ * FFI CALLBACKS (Glide runtime threads)
+ * ==================================================================== */
+
+static void release_async_request(valkey_glide_async_request* request) {
+    if (request->response) {
+        free_command_response(request->response);
+    }
+    free(request->error);
+    free(request);
+}
+
+/* Wake up an event loop watching the notification descriptor. Safe on any thread. */
+static void signal_completion(void) {
+    int fd = atomic_load(&notify_write_fd);
+    if (fd < 0) {
+        return;
+    }
+#ifdef __linux__
+    uint64_t one = 1;
+    ssize_t  ret = write(fd, &one, sizeof(one));
+#else
+    char    one = 1;
+    ssize_t ret = write(fd, &one, sizeof(one));
+#endif
+    /* A full pipe or saturated eventfd already means "readable", nothing to retry */
+    (void) ret;
+}
+
+static void async_success_callback(uintptr_t index_ptr, const CommandResponse* message) {
+    valkey_glide_async_request* request = (valkey_glide_async_request*) index_ptr;
+    valkey_glide_async_context* ctx     = request->ctx;
+
+    pthread_mutex_lock(&ctx->lock);
+    request->response = (CommandResponse*) message;
+    request->state    = VALKEY_GLIDE_ASYNC_DONE;
+    if (request->orphaned) {
+        release_async_request(request);
+    }
+    ctx->inflight--;
+    pthread_cond_broadcast(&ctx->cond);
+    pthread_mutex_unlock(&ctx->lock);
+
+    signal_completion();
+}
+
+static void async_failure_callback(uintptr_t               index_ptr,
+                                   const char*             error_message,
+                                   enum RequestErrorType   error_type) {
+    valkey_glide_async_request* request = (valkey_glide_async_request*) index_ptr;
+    valkey_glide_async_context* ctx     = request->ctx;
+    char* error = strdup(error_message ? error_message : "Unknown error");
+
+    if (error_message) {
+        free_error_message((char*) error_message);
+    }
+
+    pthread_mutex_lock(&ctx->lock);
+    request->error      = error;
+    request->error_type = error_type;
+    request->state      = VALKEY_GLIDE_ASYNC_FAILED;
+    if (request->orphaned) {
+        release_async_request(request);
+    }
+    ctx->inflight--;
+    pthread_cond_broadcast(&ctx->cond);
+    pthread_mutex_unlock(&ctx->lock);
+
+    signal_completion();
+}
+
+/* ====================================================================
+ * ASYNC CONTEXT
+ * ==================================================================== */
+
+static valkey_glide_async_context* create_async_context(valkey_glide_object* valkey_glide) {
+    valkey_glide_async_context* ctx = calloc(1, sizeof(valkey_glide_async_context));
+    if (!ctx) {
+        zend_throw_exception(get_valkey_glide_exception_ce(), "Out of memory", 0);
+        return NULL;
+    }
+
+    pthread_mutex_init(&ctx->lock, NULL);
+    pthread_cond_init(&ctx->cond, NULL);
+    ctx->inflight_limit = valkey_glide->inflight_requests_limit > 0
+                              ? valkey_glide->inflight_requests_limit
+                              : VALKEY_GLIDE_ASYNC_DEFAULT_INFLIGHT_LIMIT;
+
+    /* Open a second connection with the same settings, but completing through callbacks */
+    ClientType client_type;
+    client_type.tag                           = AsyncClient;
+    client_type.async_client.success_callback = async_success_callback;
+    client_type.async_client.failure_callback = async_failure_callback;
+
+    const ConnectionResponse* conn_resp = create_client(valkey_glide->connection_request,
+                                                        valkey_glide->connection_request_len,
+                                                        &client_type,
+                                                        NULL /* No PubSub callback */
+    );
+
+    if (!conn_resp || conn_resp->connection_error_message) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             conn_resp ? conn_resp->connection_error_message
+                                       : "Failed to create async client",
+                             0);
+        if (conn_resp) {
+            free_connection_response((ConnectionResponse*) conn_resp);
+        }
+        pthread_cond_destroy(&ctx->cond);
+        pthread_mutex_destroy(&ctx->lock);
+        free(ctx);
+        return NULL;
+    }
+
+    ctx->glide_client = conn_resp->conn_ptr;
+    free_connection_response((ConnectionResponse*) conn_resp);
+
+    return ctx;
+}
+
+void valkey_glide_async_context_free(valkey_glide_async_context* ctx) {
+    if (!ctx) {
+        return;
+    }
+
+    /* Requests abandoned by their futures still complete through the callbacks, which
+       dereference the context. Glide enforces the request timeout, so this is bounded. */
+    pthread_mutex_lock(&ctx->lock);
+    while (ctx->inflight > 0) {
+        pthread_cond_wait(&ctx->cond, &ctx->lock);
+    }
+    pthread_mutex_unlock(&ctx->lock);
+
+    close_glide_client(ctx->glide_client);
+    pthread_cond_destroy(&ctx->cond);
+    pthread_mutex_destroy(&ctx->lock);
+    free(ctx);
+}
+
+/* Take one of the inflight_limit slots of the context. Returns false when all are taken. */
+static bool try_take_slot(valkey_glide_async_context* ctx) {
+    bool taken;
+
+    pthread_mutex_lock(&ctx->lock);
+    taken = ctx->inflight < ctx->inflight_limit;
+    if (taken) {
+        ctx->inflight++;
+    }
+    pthread_mutex_unlock(&ctx->lock);
+
+    return taken;
+}
+
+/* Give back a slot taken for a command that was not sent */
+static void release_slot(valkey_glide_async_context* ctx) {
+    pthread_mutex_lock(&ctx->lock);
+    ctx->inflight--;
+    pthread_cond_broadcast(&ctx->cond);
+    pthread_mutex_unlock(&ctx->lock);
+
+    /* A Fiber may be waiting for it */
+    signal_completion();
+}
+
+/* Backpressure: take a slot, blocking until a callback frees one when inflight_limit requests
+ * are outstanding */
+static void wait_for_slot(valkey_glide_async_context* ctx) {
+    pthread_mutex_lock(&ctx->lock);
+    while (ctx->inflight >= ctx->inflight_limit) {
+        pthread_cond_wait(&ctx->cond, &ctx->lock);
+    }
+    ctx->inflight++;
+    pthread_mutex_unlock(&ctx->lock);
+}
+
+/* Send a packed command on the async connection, in a slot the caller took. Returns the
+ * request, or NULL if allocation failed, the slot given back. */
+static valkey_glide_async_request* async_send(valkey_glide_async_context* ctx,
+                                              enum RequestType            request_type,
+                                              unsigned long               arg_count,
+                                              const uintptr_t*            args,
+                                              const unsigned long*        args_len,
+                                              const uint8_t*              route_bytes,
+                                              size_t                      route_len) {
+    valkey_glide_async_request* request = calloc(1, sizeof(valkey_glide_async_request));
+    if (!request) {
+        release_slot(ctx);
+        return NULL;
+    }
+    request->ctx   = ctx;
+    request->state = VALKEY_GLIDE_ASYNC_PENDING;
+
+    /* The request pointer is the callback index. The arguments and the route are copied before
+       command() returns, so they can be released right away. */
+    command(ctx->glide_client,
+            (uintptr_t) request,
+            request_type,
+            arg_count,
+            args,
+            args_len,
+            route_bytes,
+            route_len,
+            0);
+
+    return request;
+}
+
+/* Send the command a method recorded in the buffer of the client, in a slot taken with
+ * acquire_slot(). Returns the request, or NULL if allocation failed. */
+static valkey_glide_async_request* send_async_command(valkey_glide_async_context* ctx,
+                                                      valkey_glide_object*        valkey_glide) {
+    struct batch_command* cmd         = &valkey_glide->buffered_commands[0];
+    const struct CmdInfo* cmd_info    = valkey_glide_batch_cmd_info(valkey_glide, 0);
+    const uint8_t*        route_bytes = NULL;
+
+    if (cmd->route_len > 0) {
+        route_bytes = (const uint8_t*) valkey_glide->batch_arena.bytes + cmd->route_offset;
+    }
+    return async_send(ctx,
+                      cmd->request_type,
+                      cmd->arg_count,
+                      (const uintptr_t*) cmd_info->args,
+                      (const unsigned long*) cmd_info->args_len,
+                      route_bytes,
+                      cmd->route_len);
+}
+
+valkey_glide_async_request* valkey_glide_async_send(valkey_glide_object* valkey_glide,
+                                                    enum RequestType     request_type,
+                                                    unsigned long        arg_count,
+                                                    const uintptr_t*     args,
+                                                    const unsigned long* args_len,
+                                                    const uint8_t*       route_bytes,
+                                                    size_t               route_len) {
+    valkey_glide_async_request* request;
+
+    if (!valkey_glide->async_ctx) {
+        valkey_glide->async_ctx = create_async_context(valkey_glide);
+        if (!valkey_glide->async_ctx) {
+            return NULL;
+        }
+    }
+    /* exec() blocks until the batch completes, so its routed commands wait for a slot the same
+       way: a Fiber suspended here would leave the client in batch mode to the other Fibers */
+    wait_for_slot(valkey_glide->async_ctx);
+    request = async_send(valkey_glide->async_ctx,
+                         request_type,
+                         arg_count,
+                         args,
+                         args_len,
+                         route_bytes,
+                         route_len);
+    if (!request) {
+        zend_throw_exception(get_valkey_glide_exception_ce(), "Out of memory", 0);
+    }
+    return request;
+}
+
+CommandResponse* valkey_glide_async_finish(valkey_glide_async_request* request,
+                                           const struct timespec*      deadline,
+                                           CommandError*               error) {
+    static const char           timed_out[] = "Request timed out";
+    valkey_glide_async_context* ctx         = request->ctx;
+    CommandResponse*            response;
+
+    pthread_mutex_lock(&ctx->lock);
+    while (request->state == VALKEY_GLIDE_ASYNC_PENDING) {
+        if (!deadline) {
+            pthread_cond_wait(&ctx->cond, &ctx->lock);
+        } else if (pthread_cond_timedwait(&ctx->cond, &ctx->lock, deadline) == ETIMEDOUT &&
+                   request->state == VALKEY_GLIDE_ASYNC_PENDING) {
+            /* Given up on: the callback releases it when it completes */
+            request->orphaned = true;
+            pthread_mutex_unlock(&ctx->lock);
+            error->command_error_message = estrndup(timed_out, sizeof(timed_out) - 1);
+            error->command_error_type    = Timeout;
+            return NULL;
+        }
+    }
+    pthread_mutex_unlock(&ctx->lock);
+
+    /* Completed, the callbacks are done with it */
+    response          = request->response;
+    request->response = NULL;
+    if (!response) {
+        error->command_error_message = estrdup(request->error ? request->error : "Unknown error");
+        error->command_error_type    = request->error_type;
+    }
+    release_async_request(request);
+    return response;
+}
+
+/* ====================================================================
+ * EVENT LOOP INTEGRATION
+ * ==================================================================== */
+
+/* Create the process-wide notification descriptor on first use. Returns the read end. */
+static int ensure_notify_fd(void) {
+    int fd = atomic_load(&notify_read_fd);
+    if (fd >= 0) {
+        return fd;
+    }
+
+#ifdef __linux__
+    fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    atomic_store(&notify_read_fd, fd);
+    atomic_store(&notify_write_fd, fd);
+#else
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return -1;
+    }
+    for (int i = 0; i < 2; i++) {
+        fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+        fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+    }
+    fd = fds[0];
+    atomic_store(&notify_read_fd, fds[0]);
+    atomic_store(&notify_write_fd, fds[1]);
+#endif
+
+    return fd;
+}
+
+/* Consume pending notifications so the descriptor stops polling readable */
+static void drain_notify_fd(void) {
+    int  fd = atomic_load(&notify_read_fd);
+    char buf[64];
+
+    if (fd < 0) {
+        return;
+    }
+    while (read(fd, buf, sizeof(buf)) > 0) {
+    }
+}
+
+static bool is_request_ready(valkey_glide_async_request* request) {
+    bool ready;
+
+    pthread_mutex_lock(&request->ctx->lock);
+    ready = request->state != VALKEY_GLIDE_ASYNC_PENDING;
+    pthread_mutex_unlock(&request->ctx->lock);
+
+    return ready;
+}
+
+#if PHP_VERSION_ID >= 80100
+/* Inside a Fiber, suspend it until the future completes instead of blocking the process.
+ * Returns false when not running in a Fiber, the caller then blocks as usual. */
+static bool suspend_fiber_until_ready(valkey_glide_future_object* future) {
+    zend_fiber* fiber = EG(active_fiber);
+    zval        zfuture, retval;
+
+    if (!fiber || ensure_notify_fd() < 0) {
+        return false;
+    }
+
+    if (!waiting_futures) {
+        ALLOC_HASHTABLE(waiting_futures);
+        zend_hash_init(waiting_futures, 8, NULL, ZVAL_PTR_DTOR, 0);
+    }
+
+    while (!is_request_ready(future->request)) {
+        zval_ptr_dtor(&future->waiting_fiber);
+        ZVAL_OBJ_COPY(&future->waiting_fiber, &fiber->std);
+        ZVAL_OBJ_COPY(&zfuture, &future->std);
+        zend_hash_index_update(waiting_futures, future->std.handle, &zfuture);
+
+        zend_call_method_with_0_params(NULL, zend_ce_fiber, NULL, "suspend", &retval);
+        zval_ptr_dtor(&retval);
+
+        if (EG(exception)) {
+            /* The Fiber was destroyed or resumed with an exception */
+            zend_hash_index_del(waiting_futures, future->std.handle);
+            break;
+        }
+    }
+
+    return true;
+}
+
+static void waiting_sender_dtor(zval* entry) {
+    valkey_glide_waiting_sender* sender = Z_PTR_P(entry);
+
+    zval_ptr_dtor(&sender->fiber);
+    efree(sender);
+}
+
+static bool has_free_slot(valkey_glide_async_context* ctx) {
+    bool free_slot;
+
+    pthread_mutex_lock(&ctx->lock);
+    free_slot = ctx->inflight < ctx->inflight_limit;
+    pthread_mutex_unlock(&ctx->lock);
+
+    return free_slot;
+}
+
+/* Inside a Fiber, suspend it until the context has a free slot and take it, instead of blocking
+ * the process. Returns false when not running in a Fiber, the caller then blocks as usual. */
+static bool suspend_fiber_until_slot(valkey_glide_async_context* ctx) {
+    zend_fiber*                  fiber = EG(active_fiber);
+    valkey_glide_waiting_sender* sender;
+    zval                         retval;
+
+    if (!fiber || ensure_notify_fd() < 0) {
+        return false;
+    }
+
+    if (!waiting_senders) {
+        ALLOC_HASHTABLE(waiting_senders);
+        zend_hash_init(waiting_senders, 8, NULL, waiting_sender_dtor, 0);
+    }
+
+    /* Several Fibers may be resumed for one slot, those that lose it suspend again */
+    while (!try_take_slot(ctx)) {
+        sender      = emalloc(sizeof(*sender));
+        sender->ctx = ctx;
+        ZVAL_OBJ_COPY(&sender->fiber, &fiber->std);
+        zend_hash_index_update_ptr(waiting_senders, fiber->std.handle, sender);
+
+        zend_call_method_with_0_params(NULL, zend_ce_fiber, NULL, "suspend", &retval);
+        zval_ptr_dtor(&retval);
+
+        if (EG(exception)) {
+            /* The Fiber was destroyed or resumed with an exception */
+            zend_hash_index_del(waiting_senders, fiber->std.handle);
+            break;
+        }
+    }
+
+    return true;
+}
+#endif
+
+/* Take a slot for a command sent through ValkeyGlideAsync. A Fiber is suspended until one frees
+ * and resumed by poll(), as get() does; outside of a Fiber the process blocks. Returns false,
+ * with an exception, when the Fiber was destroyed or resumed with one. */
+static bool acquire_slot(valkey_glide_async_context* ctx) {
+#if PHP_VERSION_ID >= 80100
+    if (suspend_fiber_until_slot(ctx)) {
+        return !EG(exception);
+    }
+#endif
+    wait_for_slot(ctx);
+    return true;
+}
+
+void valkey_glide_async_get_event_stream(zval* return_value) {
+    php_stream* stream;
+    int         fd = ensure_notify_fd();
+
+    if (fd < 0) {
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), "Failed to create the notification descriptor", 0);
+        return;
+    }
+
+    /* The stream owns a duplicate, the original stays open for the process lifetime */
+    fd = dup(fd);
+    if (fd < 0 || !(stream = php_stream_fopen_from_fd(fd, "r", NULL))) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), "Failed to open the notification stream", 0);
+        return;
+    }
+
+    php_stream_to_zval(stream, return_value);
+}
+
+zend_long valkey_glide_async_poll(void) {
+    zend_long resumed = 0;
+
+    drain_notify_fd();
+
+#if PHP_VERSION_ID >= 80100
+    zval*                        zfuture;
+    valkey_glide_waiting_sender* sender;
+    zend_ulong                   handle;
+    HashTable                    ready;
+
+    if ((!waiting_futures || zend_hash_num_elements(waiting_futures) == 0) &&
+        (!waiting_senders || zend_hash_num_elements(waiting_senders) == 0)) {
+        return 0;
+    }
+
+    /* Collect first, resumed Fibers may suspend again and modify the waiting tables */
+    zend_hash_init(&ready, 8, NULL, ZVAL_PTR_DTOR, 0);
+    if (waiting_futures) {
+        ZEND_HASH_FOREACH_NUM_KEY_VAL(waiting_futures, handle, zfuture) {
+            valkey_glide_future_object* future =
+                VALKEY_GLIDE_FUTURE_GET_OBJECT(Z_OBJ_P(zfuture));
+            if (is_request_ready(future->request)) {
+                zend_hash_next_index_insert(&ready, &future->waiting_fiber);
+                ZVAL_UNDEF(&future->waiting_fiber);
+                zend_hash_index_del(waiting_futures, handle);
+            }
+        }
+        ZEND_HASH_FOREACH_END();
+    }
+    if (waiting_senders) {
+        ZEND_HASH_FOREACH_NUM_KEY_PTR(waiting_senders, handle, sender) {
+            if (has_free_slot(sender->ctx)) {
+                zend_hash_next_index_insert(&ready, &sender->fiber);
+                ZVAL_UNDEF(&sender->fiber);
+                zend_hash_index_del(waiting_senders, handle);
+            }
+        }
+        ZEND_HASH_FOREACH_END();
+    }
+
+    zval* fiber;
+    ZEND_HASH_FOREACH_VAL(&ready, fiber) {
+        zval retval;
+
+        zend_call_method_with_0_params(Z_OBJ_P(fiber), zend_ce_fiber, NULL, "resume", &retval);
+        zval_ptr_dtor(&retval);
+        resumed++;
+        if (EG(exception)) {
+            break;
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+    zend_hash_destroy(&ready);
+#endif
+
+    return resumed;
+}
+
+void valkey_glide_async_request_shutdown(void) {
+#if PHP_VERSION_ID >= 80100
+    if (waiting_futures) {
+        zend_hash_destroy(waiting_futures);
+        FREE_HASHTABLE(waiting_futures);
+        waiting_futures = NULL;
+    }
+    if (waiting_senders) {
+        zend_hash_destroy(waiting_senders);
+        FREE_HASHTABLE(waiting_senders);
+        waiting_senders = NULL;
+    }
+#endif
+}
+
+void valkey_glide_async_shutdown(void) {
+    int read_fd  = atomic_exchange(&notify_read_fd, -1);
+    int write_fd = atomic_exchange(&notify_write_fd, -1);
+
+    if (write_fd >= 0 && write_fd != read_fd) {
+        close(write_fd);
+    }
+    if (read_fd >= 0) {
+        close(read_fd);
+    }
+}
+
+/* ====================================================================
+ * FUTURE RESOLUTION
+ * ==================================================================== */
+
+/* Wait for the request and convert its response, dropping the FFI-owned memory */
+static void resolve_future(valkey_glide_future_object* future) {
+    valkey_glide_async_request* request = future->request;
+    valkey_glide_async_context* ctx;
+
+    if (future->resolved) {
+        return;
+    }
+
+#if PHP_VERSION_ID >= 80100
+    if (suspend_fiber_until_ready(future) && EG(exception)) {
+        return;
+    }
+#endif
+
+    ctx = request->ctx;
+    pthread_mutex_lock(&ctx->lock);
+    while (request->state == VALKEY_GLIDE_ASYNC_PENDING) {
+        pthread_cond_wait(&ctx->cond, &ctx->lock);
+    }
+    pthread_mutex_unlock(&ctx->lock);
+
+    if (request->state == VALKEY_GLIDE_ASYNC_DONE) {
+        valkey_glide_object* valkey_glide =
+            VALKEY_GLIDE_PHP_GET_OBJECT(valkey_glide_object, future->client);
+        valkey_glide_object* previous = valkey_glide_delegate(valkey_glide);
+
+        /* In the shape the method returns, with the options of the client at reply time */
+        valkey_glide_batch_convert_reply(
+            &valkey_glide->options, &future->command, request->response, &future->result);
+        valkey_glide_delegate(previous);
+    } else {
+        ZVAL_FALSE(&future->result);
+    }
+    future->resolved = true;
+
+    if (request->response) {
+        free_command_response(request->response);
+        request->response = NULL;
+    }
+}
+
+static valkey_glide_future_object* get_valid_future(zval* object) {
+    valkey_glide_future_object* future = VALKEY_GLIDE_FUTURE_GET_OBJECT(Z_OBJ_P(object));
+    if (!future->request && !future->resolved) {
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), "ValkeyGlideFuture is not bound to a command", 0);
+        return NULL;
+    }
+    return future;
+}
+
+void valkey_glide_async_await_all(HashTable* futures, zval* return_value) {
+    zval* entry;
+
+    ZEND_HASH_FOREACH_VAL(futures, entry) {
+        ZVAL_DEREF(entry);
+        if (Z_TYPE_P(entry) != IS_OBJECT || Z_OBJCE_P(entry) != valkey_glide_future_ce) {
+            zend_throw_exception(get_valkey_glide_exception_ce(),
+                                 "awaitAll() expects an array of ValkeyGlideFuture objects",
+                                 0);
+            return;
+        }
+        if (!get_valid_future(entry)) {
+            return;
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+
+    /* All requests are already in flight, so resolving in order waits for the slowest one */
+    array_init_size(return_value, zend_hash_num_elements(futures));
+
+    zend_string* key;
+    zend_ulong   idx;
+    ZEND_HASH_FOREACH_KEY_VAL(futures, idx, key, entry) {
+        valkey_glide_future_object* future;
+        zval                        result;
+
+        ZVAL_DEREF(entry);
+        future = VALKEY_GLIDE_FUTURE_GET_OBJECT(Z_OBJ_P(entry));
+        resolve_future(future);
+        if (!future->resolved) {
+            /* Suspended Fiber was unwound by an exception */
+            return;
+        }
+        ZVAL_COPY(&result, &future->result);
+
+        if (key) {
+            zend_hash_update(Z_ARRVAL_P(return_value), key, &result);
+        } else {
+            zend_hash_index_update(Z_ARRVAL_P(return_value), idx, &result);
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+}
+
+/* ====================================================================
+ * OBJECT HANDLERS
+ * ==================================================================== */
+
+static zend_object* create_valkey_glide_future_object(zend_class_entry* ce) {
+    valkey_glide_future_object* future =
+        ecalloc(1, sizeof(valkey_glide_future_object) + zend_object_properties_size(ce));
+
+    zend_object_std_init(&future->std, ce);
+    object_properties_init(&future->std, ce);
+    ZVAL_UNDEF(&future->result);
+    ZVAL_UNDEF(&future->waiting_fiber);
+    ZVAL_UNDEF(&future->command.reply_keys);
+
+    future->std.handlers = &valkey_glide_future_object_handlers;
+
+    return &future->std;
+}
+
+static void free_valkey_glide_future_object(zend_object* object) {
+    valkey_glide_future_object* future  = VALKEY_GLIDE_FUTURE_GET_OBJECT(object);
+    valkey_glide_async_request* request = future->request;
+
+    if (request) {
+        valkey_glide_async_context* ctx = request->ctx;
+
+        pthread_mutex_lock(&ctx->lock);
+        if (request->state == VALKEY_GLIDE_ASYNC_PENDING) {
+            request->orphaned = true;
+        } else {
+            release_async_request(request);
+        }
+        pthread_mutex_unlock(&ctx->lock);
+        future->request = NULL;
+    }
+
+    zval_ptr_dtor(&future->result);
+    zval_ptr_dtor(&future->waiting_fiber);
+    zval_ptr_dtor(&future->command.reply_keys);
+
+    /* Release the client last, the context lives inside it */
+    if (future->client) {
+        OBJ_RELEASE(future->client);
+        future->client = NULL;
+    }
+
+    zend_object_std_dtor(&future->std);
+}
+
+static zend_object* create_valkey_glide_async_object(zend_class_entry* ce) {
+    valkey_glide_async_object* proxy =
+        ecalloc(1, sizeof(valkey_glide_async_object) + zend_object_properties_size(ce));
+
+    zend_object_std_init(&proxy->std, ce);
+    object_properties_init(&proxy->std, ce);
+
+    proxy->std.handlers = &valkey_glide_async_object_handlers;
+
+    return &proxy->std;
+}
+
+static void free_valkey_glide_async_object(zend_object* object) {
+    valkey_glide_async_object* proxy = VALKEY_GLIDE_ASYNC_GET_OBJECT(object);
+
+    if (proxy->client) {
+        OBJ_RELEASE(proxy->client);
+        proxy->client = NULL;
+    }
+
+    zend_object_std_dtor(&proxy->std);
+}
+
+void valkey_glide_async_get_proxy(zval* object, zval* return_value) {
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    valkey_glide_async_object* proxy;
+
+    if (!valkey_glide->glide_client || !valkey_glide->connection_request) {
+        zend_throw_exception(get_valkey_glide_exception_ce(), "Client is not connected", 0);
+        return;
+    }
+
+    if (!valkey_glide->async_ctx) {
+        valkey_glide->async_ctx = create_async_context(valkey_glide);
+        if (!valkey_glide->async_ctx) {
+            return;
+        }
+    }
+
+    object_init_ex(return_value, valkey_glide_async_ce);
+    proxy         = VALKEY_GLIDE_ASYNC_GET_OBJECT(Z_OBJ_P(return_value));
+    proxy->client = Z_OBJ_P(object);
+    GC_ADDREF(proxy->client);
+}
+
+/* ====================================================================
+ * CLASS METHODS
+ * ==================================================================== */
+
+/* {{{ proto ValkeyGlideFuture ValkeyGlideAsync::__call(string $name, array $arguments) */
+PHP_METHOD(ValkeyGlideAsync, __call) {
+    zend_string*                     name;
+    HashTable*                       arguments;
+    valkey_glide_async_object*       proxy;
+    valkey_glide_object*             valkey_glide;
+    valkey_glide_future_object*      future;
+    valkey_glide_async_request*      request = NULL;
+    zend_function*                   func;
+    const valkey_glide_batch_method* method = NULL;
+    zval                             retval;
+
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+    Z_PARAM_STR(name)
+    Z_PARAM_ARRAY_HT(arguments)
+    ZEND_PARSE_PARAMETERS_END();
+
+    proxy = VALKEY_GLIDE_ASYNC_GET_OBJECT(Z_OBJ_P(getThis()));
+    if (!proxy->client) {
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), "ValkeyGlideAsync is not bound to a client", 0);
+        RETURN_THROWS();
+    }
+    valkey_glide = VALKEY_GLIDE_PHP_GET_OBJECT(valkey_glide_object, proxy->client);
+
+    func = zend_hash_find_ptr_lc(&proxy->client->ce->function_table, name);
+    if (func) {
+        method = valkey_glide_batch_method_of(func);
+    }
+    if (!method) {
+        zend_throw_exception_ex(get_valkey_glide_exception_ce(),
+                                0,
+                                "%s() cannot be sent asynchronously",
+                                ZSTR_VAL(name));
+        RETURN_THROWS();
+    }
+
+    /* Take a slot before the method records its command: a Fiber waiting for one is suspended
+     * with the client out of batch mode, free for the other Fibers */
+    if (!acquire_slot(valkey_glide->async_ctx)) {
+        RETURN_THROWS();
+    }
+    if (valkey_glide->is_in_batch_mode) {
+        release_slot(valkey_glide->async_ctx);
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "Cannot send asynchronous commands during a transaction or pipeline",
+                             0);
+        RETURN_THROWS();
+    }
+
+    /* The method records its command as in a pipeline: its arguments are parsed, prefixed,
+     * serialized and compressed, and its route packed, exactly as when it is called directly */
+    valkey_glide->is_in_batch_mode = true;
+    valkey_glide->batch_type       = PIPELINE;
+    zend_call_known_function(func, proxy->client, proxy->client->ce, &retval, 0, NULL, arguments);
+    if (EG(exception)) {
+        zval_ptr_dtor(&retval);
+        valkey_glide_batch_clear(valkey_glide);
+        release_slot(valkey_glide->async_ctx);
+        RETURN_THROWS();
+    }
+
+    if (valkey_glide->command_count == 0) {
+        release_slot(valkey_glide->async_ctx);
+    } else {
+        zval_ptr_dtor(&retval);
+        request = send_async_command(valkey_glide->async_ctx, valkey_glide);
+        if (!request) {
+            valkey_glide_batch_clear(valkey_glide);
+            zend_throw_exception(get_valkey_glide_exception_ce(), "Out of memory", 0);
+            RETURN_THROWS();
+        }
+    }
+
+    object_init_ex(return_value, valkey_glide_future_ce);
+    future         = VALKEY_GLIDE_FUTURE_GET_OBJECT(Z_OBJ_P(return_value));
+    future->client = proxy->client;
+    GC_ADDREF(future->client);
+
+    if (!request) {
+        /* Nothing recorded: the method rejected its arguments, and what it returned is the
+         * result */
+        ZVAL_COPY_VALUE(&future->result, &retval);
+        future->resolved = true;
+    } else {
+        /* The reply is converted as the method converts it, keyed by its arguments for HMGET */
+        future->request = request;
+        future->command = valkey_glide->buffered_commands[0];
+        ZVAL_COPY(&future->command.reply_keys, &valkey_glide->buffered_commands[0].reply_keys);
+    }
+    valkey_glide_batch_clear(valkey_glide);
+}
+/* }}} */
+
+/* {{{ proto mixed ValkeyGlideFuture::get() */
+PHP_METHOD(ValkeyGlideFuture, get) {
+    valkey_glide_future_object* future;
+
+    if (zend_parse_parameters_none() == FAILURE) {
+        RETURN_THROWS();
+    }
+
+    future = get_valid_future(getThis());
+    if (!future) {
+        RETURN_THROWS();
+    }
+
+    resolve_future(future);
+    if (!future->resolved) {
+        RETURN_THROWS();
+    }
+    RETURN_COPY(&future->result);
+}
+/* }}} */
+
+/* {{{ proto bool ValkeyGlideFuture::isReady() */
+PHP_METHOD(ValkeyGlideFuture, isReady) {
+    valkey_glide_future_object* future;
+
+    if (zend_parse_parameters_none() == FAILURE) {
+        RETURN_THROWS();
+    }
+
+    future = get_valid_future(getThis());
+    if (!future) {
+        RETURN_THROWS();
+    }
+
+    RETURN_BOOL(!future->request || is_request_ready(future->request));
+}
+/* }}} */
+
+/* {{{ proto ?string ValkeyGlideFuture::getError() */
+PHP_METHOD(ValkeyGlideFuture, getError) {
+    valkey_glide_future_object* future;
+
+    if (zend_parse_parameters_none() == FAILURE) {
+        RETURN_THROWS();
+    }
+
+    future = get_valid_future(getThis());
+    if (!future) {
+        RETURN_THROWS();
+    }
+
+    resolve_future(future);
+    if (!future->resolved) {
+        RETURN_THROWS();
+    }
+    if (future->request && future->request->error) {
+        RETURN_STRING(future->request->error);
+    }
+    RETURN_NULL();
+}
+/* }}} */
+
+/* Class registration function using generated arginfo */
+void register_valkey_glide_async_classes(void) {
+    valkey_glide_async_ce                = register_class_ValkeyGlideAsync();
+    valkey_glide_async_ce->create_object = create_valkey_glide_async_object;
+    memcpy(&valkey_glide_async_object_handlers,
+           zend_get_std_object_handlers(),
+           sizeof(valkey_glide_async_object_handlers));
+    valkey_glide_async_object_handlers.offset    = XtOffsetOf(valkey_glide_async_object, std);
+    valkey_glide_async_object_handlers.free_obj  = free_valkey_glide_async_object;
+    valkey_glide_async_object_handlers.clone_obj = NULL;
+
+    valkey_glide_future_ce                = register_class_ValkeyGlideFuture();
+    valkey_glide_future_ce->create_object = create_valkey_glide_future_object;
+    memcpy(&valkey_glide_future_object_handlers,
+           zend_get_std_object_handlers(),
+           sizeof(valkey_glide_future_object_handlers));
+    valkey_glide_future_object_handlers.offset    = XtOffsetOf(valkey_glide_future_object, std);
+    valkey_glide_future_object_handlers.free_obj  = free_valkey_glide_future_object;
+    valkey_glide_future_object_handlers.clone_obj = NULL;
+}
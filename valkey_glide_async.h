@@ -0,0 +1,86 @@
+#ifndef VALKEY_GLIDE_ASYNC_H
+#define VALKEY_GLIDE_ASYNC_H
+
+#include <time.h>
+
+#include "common.h"
+#include "php.h"
+
+/* Outstanding async requests allowed per client when inflight_requests_limit is not set.
+ * Matches the Glide core default, so the core never rejects a request we let through. */
+#define VALKEY_GLIDE_ASYNC_DEFAULT_INFLIGHT_LIMIT 1000
+
+/* Shared with the FFI completion callbacks, which run on Glide's own threads */
+typedef struct valkey_glide_async_context valkey_glide_async_context;
+typedef struct valkey_glide_async_request valkey_glide_async_request;
+
+/* ValkeyGlideFuture object structure */
+typedef struct {
+    valkey_glide_async_request* request; /* Shared with the FFI callback while pending */
+    zend_object*                client;  /* Owning client, keeps the async context alive */
+    struct batch_command        command; /* Method and reply keys the reply is converted by */
+    zval                        result;  /* Converted response, valid when resolved */
+    bool                        resolved;
+    zval                        waiting_fiber; /* Fiber suspended in get(), UNDEF otherwise */
+    zend_object                 std;
+} valkey_glide_future_object;
+
+/* ValkeyGlideAsync object structure */
+typedef struct {
+    zend_object* client; /* ValkeyGlide or ValkeyGlideCluster object */
+    zend_object  std;
+} valkey_glide_async_object;
+
+/* Class entries */
+extern zend_class_entry* valkey_glide_future_ce;
+extern zend_class_entry* valkey_glide_async_ce;
+
+/* Class registration function */
+void register_valkey_glide_async_classes(void);
+
+/* Return the ValkeyGlideAsync proxy for a client object, creating its async connection on first
+ * use. Throws and leaves return_value untouched on failure. */
+void valkey_glide_async_get_proxy(zval* object, zval* return_value);
+
+/* Send a packed command on the async connection of a client, opening it on first use, without
+ * waiting for the reply. Returns NULL with an exception thrown on failure. */
+valkey_glide_async_request* valkey_glide_async_send(valkey_glide_object* valkey_glide,
+                                                    enum RequestType     request_type,
+                                                    unsigned long        arg_count,
+                                                    const uintptr_t*     args,
+                                                    const unsigned long* args_len,
+                                                    const uint8_t*       route_bytes,
+                                                    size_t               route_len);
+
+/* Wait for a request of valkey_glide_async_send() and release it. Returns its response, to free
+ * with free_command_response(), or NULL with its error set, the message to efree(). A request
+ * still pending at the deadline, on CLOCK_REALTIME and none when NULL, fails with a timeout
+ * error and is released by its callback. */
+CommandResponse* valkey_glide_async_finish(valkey_glide_async_request* request,
+                                           const struct timespec*      deadline,
+                                           CommandError*               error);
+
+/* Wait for every future in the array, returning their results under the same keys */
+void valkey_glide_async_await_all(HashTable* futures, zval* return_value);
+
+/* Wait for outstanding requests and close the async connection */
+void valkey_glide_async_context_free(valkey_glide_async_context* ctx);
+
+/* Event loop integration: a readable stream signalled on every completion, and a poll that
+ * resumes the Fibers whose futures completed. Returns the number of Fibers resumed. */
+void      valkey_glide_async_get_event_stream(zval* return_value);
+zend_long valkey_glide_async_poll(void);
+
+/* Release the Fibers still waiting at the end of a request (RSHUTDOWN) */
+void valkey_glide_async_request_shutdown(void);
+
+/* Close the notification descriptor (MSHUTDOWN) */
+void valkey_glide_async_shutdown(void);
+
+/* Class methods */
+PHP_METHOD(ValkeyGlideAsync, __call);
+PHP_METHOD(ValkeyGlideFuture, get);
+PHP_METHOD(ValkeyGlideFuture, isReady);
+PHP_METHOD(ValkeyGlideFuture, getError);
+
+#endif /* VALKEY_GLIDE_ASYNC_H */
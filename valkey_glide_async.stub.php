@@ -0,0 +1,69 @@
+<?php
+
+/**
+ * @generate-function-entries
+ * @generate-class-entries
+ */
+
+/**
+ * Proxy returned by ValkeyGlide::async() and ValkeyGlideCluster::async().
+ *
+ * Every method call takes the arguments of the client method of the same name and sends its
+ * command without waiting for the reply, returning a ValkeyGlideFuture. The arguments are
+ * prepared as by the client method (key prefix, serializer, compression, route) and the reply
+ * has the shape the method returns, so `$async->hGetAll('h')->get()` is `$client->hGetAll('h')`.
+ * The methods that can be buffered in a pipeline can be sent asynchronously.
+ */
+final class ValkeyGlideAsync
+{
+    /**
+     * Send a command asynchronously.
+     *
+     * Blocks only when the client already has inflight_requests_limit requests outstanding.
+     *
+     * @param string $name      The method name, e.g. "get" or "hGetAll".
+     * @param array  $arguments The method arguments.
+     *
+     * @return ValkeyGlideFuture A future resolving to what the method returns, false at once
+     *                           when the method rejects its arguments.
+     *
+     * @throws ValkeyGlideException When the method cannot be sent asynchronously, or the client
+     *                              is in a transaction or pipeline.
+     */
+    public function __call(string $name, array $arguments): ValkeyGlideFuture
+    {
+    }
+}
+
+/**
+ * The pending result of a command sent through ValkeyGlideAsync.
+ */
+final class ValkeyGlideFuture
+{
+    /**
+     * Wait for the reply and return it.
+     *
+     * @return mixed The reply, or false if the command failed (see getError()).
+     */
+    public function get(): mixed
+    {
+    }
+
+    /**
+     * Check whether the reply has arrived, without blocking.
+     *
+     * @return bool True if get() will return immediately.
+     */
+    public function isReady(): bool
+    {
+    }
+
+    /**
+     * Wait for the reply and return the error message if the command failed.
+     *
+     * @return string|null The error message, or null on success.
+     */
+    public function getError(): ?string
+    {
+    }
+}
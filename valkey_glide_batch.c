@@ -0,0 +1,1042 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Batches                                                 |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#include "valkey_glide_batch.h"
+
+#include <zend_exceptions.h>
+
+#include "command_response.h"
+#include "valkey_glide_async.h"
+#include "valkey_glide_commands_common.h"
+#include "valkey_glide_errors.h"
+#include "valkey_glide_options.h"
+
+/* ====================================================================
+ * BUFFERED METHODS
+ * ==================================================================== */
+
+#define RAW(name, flags) {name, BATCH_REPLY_RAW, flags, -1}
+#define BOOL(name) {name, BATCH_REPLY_BOOL, 0, -1}
+#define DOUBLE(name) {name, BATCH_REPLY_DOUBLE, 0, -1}
+
+/* Methods buffered after multi()/pipeline(), and how exec() converts their replies */
+static const valkey_glide_batch_method batch_methods[] = {
+    /* Strings */
+    RAW("append", 0),
+    RAW("decr", 0),
+    RAW("decrby", 0),
+    RAW("get", BATCH_REPLY_VALUES),
+    RAW("getdel", BATCH_REPLY_VALUES),
+    RAW("getex", BATCH_REPLY_VALUES),
+    RAW("getrange", 0),
+    RAW("getset", BATCH_REPLY_VALUES),
+    RAW("incr", 0),
+    RAW("incrby", 0),
+    DOUBLE("incrbyfloat"),
+    RAW("lcs", 0),
+    RAW("mget", BATCH_REPLY_NESTED_FALSE | BATCH_REPLY_VALUES),
+    RAW("mset", 0),
+    BOOL("msetnx"),
+    RAW("psetex", 0),
+    RAW("set", BATCH_REPLY_VALUES),
+    RAW("setex", 0),
+    BOOL("setnx"),
+    RAW("setrange", 0),
+    RAW("strlen", 0),
+    /* Bits and HyperLogLog */
+    RAW("bitcount", 0),
+    RAW("bitop", 0),
+    RAW("bitpos", 0),
+    RAW("getbit", 0),
+    RAW("setbit", 0),
+    RAW("pfadd", 0),
+    RAW("pfcount", 0),
+    RAW("pfmerge", 0),
+    /* Keys */
+    BOOL("copy"),
+    RAW("del", 0),
+    RAW("dump", 0),
+    RAW("exists", 0),
+    BOOL("expire"),
+    BOOL("expireat"),
+    RAW("expiretime", 0),
+    BOOL("move"),
+    BOOL("persist"),
+    BOOL("pexpire"),
+    BOOL("pexpireat"),
+    RAW("pexpiretime", 0),
+    RAW("pttl", 0),
+    RAW("randomkey", 0),
+    RAW("object", 0),
+    RAW("rename", 0),
+    BOOL("renamenx"),
+    RAW("restore", 0),
+    RAW("sort", 0),
+    RAW("sort_ro", 0),
+    RAW("touch", 0),
+    RAW("ttl", 0),
+    {"type", BATCH_REPLY_TYPE, 0, -1},
+    RAW("unlink", 0),
+    /* Hashes */
+    RAW("hdel", 0),
+    BOOL("hexists"),
+    RAW("hget", BATCH_REPLY_VALUES),
+    {"hgetall", BATCH_REPLY_MAP, BATCH_REPLY_VALUES, -1},
+    RAW("hincrby", 0),
+    DOUBLE("hincrbyfloat"),
+    RAW("hkeys", 0),
+    RAW("hlen", 0),
+    {"hmget", BATCH_REPLY_KEYED, BATCH_REPLY_VALUES, 1},
+    RAW("hmset", 0),
+    RAW("hrandfield", 0),
+    RAW("hset", 0),
+    BOOL("hsetnx"),
+    RAW("hstrlen", 0),
+    RAW("hvals", BATCH_REPLY_VALUES),
+    /* Lists */
+    RAW("blmove", BATCH_REPLY_VALUES),
+    RAW("blmpop", BATCH_REPLY_NULL),
+    RAW("blpop", BATCH_REPLY_NULL),
+    RAW("brpop", BATCH_REPLY_NULL),
+    RAW("lindex", BATCH_REPLY_VALUES),
+    RAW("linsert", 0),
+    RAW("llen", 0),
+    RAW("lmove", BATCH_REPLY_VALUES),
+    RAW("lmpop", BATCH_REPLY_NULL),
+    RAW("lpop", BATCH_REPLY_VALUES),
+    RAW("lpos", BATCH_REPLY_NULL),
+    RAW("lpush", 0),
+    RAW("lpushx", 0),
+    RAW("lrange", BATCH_REPLY_VALUES),
+    RAW("lrem", 0),
+    RAW("lset", 0),
+    RAW("ltrim", 0),
+    RAW("rpop", BATCH_REPLY_VALUES),
+    RAW("rpush", 0),
+    RAW("rpushx", 0),
+    /* Sets */
+    RAW("sadd", 0),
+    RAW("scard", 0),
+    RAW("sdiff", BATCH_REPLY_VALUES),
+    RAW("sdiffstore", 0),
+    RAW("sinter", BATCH_REPLY_VALUES),
+    RAW("sintercard", 0),
+    RAW("sinterstore", 0),
+    BOOL("sismember"),
+    RAW("smembers", BATCH_REPLY_VALUES),
+    RAW("smismember", 0),
+    BOOL("smove"),
+    RAW("spop", BATCH_REPLY_VALUES),
+    RAW("srandmember", BATCH_REPLY_VALUES),
+    RAW("srem", 0),
+    RAW("sunion", BATCH_REPLY_VALUES),
+    RAW("sunionstore", 0),
+    /* Sorted sets */
+    RAW("bzmpop", BATCH_REPLY_NULL | BATCH_REPLY_VALUES),
+    RAW("bzpopmax", BATCH_REPLY_VALUES),
+    RAW("bzpopmin", BATCH_REPLY_VALUES),
+    RAW("zadd", 0),
+    RAW("zcard", 0),
+    RAW("zcount", 0),
+    RAW("zdiff", BATCH_REPLY_VALUES),
+    RAW("zdiffstore", 0),
+    DOUBLE("zincrby"),
+    RAW("zinter", BATCH_REPLY_VALUES),
+    RAW("zintercard", 0),
+    RAW("zinterstore", 0),
+    RAW("zlexcount", 0),
+    RAW("zmpop", BATCH_REPLY_NULL | BATCH_REPLY_VALUES),
+    RAW("zmscore", BATCH_REPLY_NESTED_FALSE),
+    RAW("zpopmax", BATCH_REPLY_VALUES),
+    RAW("zpopmin", BATCH_REPLY_VALUES),
+    RAW("zrandmember", BATCH_REPLY_VALUES),
+    RAW("zrange", BATCH_REPLY_VALUES),
+    RAW("zrangebylex", BATCH_REPLY_VALUES),
+    RAW("zrangebyscore", BATCH_REPLY_VALUES),
+    RAW("zrangestore", 0),
+    RAW("zrank", 0),
+    RAW("zrem", 0),
+    RAW("zremrangebylex", 0),
+    RAW("zremrangebyrank", 0),
+    RAW("zremrangebyscore", 0),
+    RAW("zrevrangebyscore", BATCH_REPLY_VALUES),
+    RAW("zrevrank", 0),
+    DOUBLE("zscore"),
+    RAW("zunion", BATCH_REPLY_VALUES),
+    RAW("zunionstore", 0),
+    /* Streams */
+    RAW("xack", 0),
+    RAW("xadd", 0),
+    RAW("xautoclaim", 0),
+    RAW("xclaim", BATCH_REPLY_VALUES),
+    RAW("xdel", 0),
+    RAW("xgroup", 0),
+    {"xinfo", BATCH_REPLY_MAP, 0, -1},
+    RAW("xlen", 0),
+    RAW("xpending", 0),
+    RAW("xrange", BATCH_REPLY_VALUES),
+    RAW("xread", BATCH_REPLY_VALUES),
+    RAW("xreadgroup", BATCH_REPLY_VALUES),
+    RAW("xrevrange", BATCH_REPLY_VALUES),
+    RAW("xtrim", 0),
+    /* Geospatial */
+    RAW("geoadd", 0),
+    DOUBLE("geodist"),
+    RAW("geohash", 0),
+    RAW("geopos", 0),
+    RAW("geosearch", 0),
+    RAW("geosearchstore", 0),
+    /* Server, routed by their $route in a cluster pipeline */
+    {"client", BATCH_REPLY_CLIENT, 0, -1},
+    {"config", BATCH_REPLY_MAP, 0, -1},
+    RAW("dbsize", 0),
+    RAW("echo", 0),
+    RAW("flushall", 0),
+    RAW("flushdb", 0),
+    {"info", BATCH_REPLY_INFO, 0, -1},
+    {"ping", BATCH_REPLY_PONG, 0, -1},
+    RAW("rawcommand", 0),
+    RAW("time", 0),
+    RAW("wait", 0),
+    /* Scripts, functions and Pub/Sub */
+    {"eval", BATCH_REPLY_MAP, BATCH_REPLY_NULL, -1},
+    {"eval_ro", BATCH_REPLY_MAP, BATCH_REPLY_NULL, -1},
+    {"evalsha", BATCH_REPLY_MAP, BATCH_REPLY_NULL, -1},
+    {"evalsha_ro", BATCH_REPLY_MAP, BATCH_REPLY_NULL, -1},
+    RAW("fcall", BATCH_REPLY_NULL),
+    RAW("fcall_ro", BATCH_REPLY_NULL),
+    {"function", BATCH_REPLY_FUNCTION, BATCH_REPLY_NESTED_FALSE, -1},
+    RAW("publish", 0),
+    RAW("spublish", 0),
+};
+
+#undef RAW
+#undef BOOL
+#undef DOUBLE
+
+#define BATCH_METHOD_COUNT (sizeof(batch_methods) / sizeof(batch_methods[0]))
+
+/* Original handlers of the wrapped methods, for ValkeyGlide and ValkeyGlideCluster */
+typedef struct {
+    zif_handler                      handler;
+    const valkey_glide_batch_method* method;
+} batch_handler_t;
+
+static batch_handler_t batch_handlers[2 * BATCH_METHOD_COUNT];
+static uint32_t        batch_handler_count = 0;
+
+/* zend_function pointer to its batch_handlers entry, looked up on every call */
+static HashTable batch_handler_lookup;
+static bool      batch_handler_lookup_init = false;
+
+/* The batch_handlers entry of a wrapped method. A class extending ValkeyGlide runs a copy of
+ * the zend_function, found through the class that declares the method. */
+static batch_handler_t* batch_handler_entry(const zend_function* func) {
+    batch_handler_t* entry =
+        zend_hash_index_find_ptr(&batch_handler_lookup, (zend_ulong) (uintptr_t) func);
+
+    if (!entry && func->common.scope && func->common.function_name) {
+        zend_function* declared = zend_hash_find_ptr_lc(&func->common.scope->function_table,
+                                                         func->common.function_name);
+
+        if (declared && declared != func) {
+            entry = zend_hash_index_find_ptr(&batch_handler_lookup,
+                                             (zend_ulong) (uintptr_t) declared);
+        }
+    }
+    return entry;
+}
+
+static void valkey_glide_batch_handler(INTERNAL_FUNCTION_PARAMETERS) {
+    batch_handler_t*      entry = batch_handler_entry(EX(func));
+    valkey_glide_object*  valkey_glide;
+    struct batch_command* cmd;
+    size_t                count;
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, ZEND_THIS);
+    if (!valkey_glide->is_in_batch_mode || valkey_glide->batch_method) {
+        entry->handler(INTERNAL_FUNCTION_PARAM_PASSTHRU);
+        return;
+    }
+
+    count                      = valkey_glide->command_count;
+    valkey_glide->batch_method = entry->method;
+    entry->handler(INTERNAL_FUNCTION_PARAM_PASSTHRU);
+    valkey_glide->batch_method = NULL;
+
+    /* Nothing buffered: the arguments were rejected, or the command was routed and ran */
+    if (valkey_glide->command_count == count || EG(exception)) {
+        return;
+    }
+
+    if (entry->method->keys_arg >= 0 &&
+        (uint32_t) entry->method->keys_arg < ZEND_CALL_NUM_ARGS(execute_data)) {
+        cmd = &valkey_glide->buffered_commands[valkey_glide->command_count - 1];
+        ZVAL_COPY(&cmd->reply_keys, ZEND_CALL_ARG(execute_data, entry->method->keys_arg + 1));
+        valkey_glide->batch_arena.keyed_count++;
+    }
+
+    zval_ptr_dtor(return_value);
+    ZVAL_COPY(return_value, ZEND_THIS);
+}
+
+void valkey_glide_batch_install(zend_class_entry* ce) {
+    if (!batch_handler_lookup_init) {
+        zend_hash_init(&batch_handler_lookup, 2 * BATCH_METHOD_COUNT, NULL, NULL, 1);
+        batch_handler_lookup_init = true;
+    }
+
+    for (size_t i = 0; i < BATCH_METHOD_COUNT; i++) {
+        const char*    name = batch_methods[i].name;
+        zend_function* func = zend_hash_str_find_ptr(&ce->function_table, name, strlen(name));
+        batch_handler_t* entry;
+
+        if (!func || func->type != ZEND_INTERNAL_FUNCTION ||
+            batch_handler_count == 2 * BATCH_METHOD_COUNT) {
+            continue;
+        }
+        entry          = &batch_handlers[batch_handler_count++];
+        entry->handler = func->internal_function.handler;
+        entry->method  = &batch_methods[i];
+        zend_hash_index_update_ptr(&batch_handler_lookup, (zend_ulong) (uintptr_t) func, entry);
+        func->internal_function.handler = valkey_glide_batch_handler;
+    }
+}
+
+const valkey_glide_batch_method* valkey_glide_batch_method_of(const zend_function* func) {
+    batch_handler_t* entry;
+
+    if (!batch_handler_lookup_init || func->type != ZEND_INTERNAL_FUNCTION ||
+        func->internal_function.handler != valkey_glide_batch_handler) {
+        return NULL;
+    }
+    entry = batch_handler_entry(func);
+    return entry ? entry->method : NULL;
+}
+
+void valkey_glide_batch_shutdown(void) {
+    if (batch_handler_lookup_init) {
+        zend_hash_destroy(&batch_handler_lookup);
+        batch_handler_lookup_init = false;
+    }
+}
+
+/* ====================================================================
+ * BUFFERING
+ * ==================================================================== */
+
+/* Grow the command buffer, and the CmdInfo arrays exec() builds from it */
+static void expand_command_buffer(valkey_glide_object* valkey_glide) {
+    struct batch_arena* arena        = &valkey_glide->batch_arena;
+    size_t              new_capacity = valkey_glide->command_capacity * 2;
+
+    if (new_capacity == 0) {
+        new_capacity = 16;
+    }
+
+    valkey_glide->buffered_commands = (struct batch_command*) safe_erealloc(
+        valkey_glide->buffered_commands, new_capacity, sizeof(struct batch_command), 0);
+    arena->cmd_infos = (struct CmdInfo*) safe_erealloc(
+        arena->cmd_infos, new_capacity, sizeof(struct CmdInfo), 0);
+    arena->cmd_info_ptrs = (const struct CmdInfo**) safe_erealloc(
+        arena->cmd_info_ptrs, new_capacity, sizeof(struct CmdInfo*), 0);
+    valkey_glide->command_capacity = new_capacity;
+}
+
+/* Make room for arg_count more arguments of bytes_len bytes in all */
+static void batch_arena_reserve(struct batch_arena* arena, size_t arg_count, size_t bytes_len) {
+    if (arena->arg_count + arg_count > arena->arg_capacity) {
+        size_t capacity = MAX(arena->arg_capacity * 2, arena->arg_count + arg_count);
+
+        capacity       = MAX(capacity, 64);
+        arena->offsets = (size_t*) safe_erealloc(arena->offsets, capacity, sizeof(size_t), 0);
+        arena->lengths =
+            (uintptr_t*) safe_erealloc(arena->lengths, capacity, sizeof(uintptr_t), 0);
+        arena->args =
+            (const uint8_t**) safe_erealloc(arena->args, capacity, sizeof(uint8_t*), 0);
+        arena->arg_capacity = capacity;
+    }
+    if (arena->bytes_len + bytes_len > arena->bytes_capacity) {
+        size_t capacity = MAX(arena->bytes_capacity * 2, arena->bytes_len + bytes_len);
+
+        capacity              = MAX(capacity, 1024);
+        arena->bytes          = (char*) erealloc(arena->bytes, capacity);
+        arena->bytes_capacity = capacity;
+    }
+}
+
+void valkey_glide_batch_append(valkey_glide_object*             valkey_glide,
+                               const valkey_glide_batch_method* method,
+                               enum RequestType                 request_type,
+                               unsigned long                    arg_count,
+                               const uintptr_t*                 args,
+                               const unsigned long*             args_len,
+                               const uint8_t*                   route_bytes,
+                               size_t                           route_len) {
+    struct batch_arena*   arena     = &valkey_glide->batch_arena;
+    struct batch_command* cmd;
+    size_t                bytes_len = route_len;
+
+    if (valkey_glide->command_count >= valkey_glide->command_capacity) {
+        expand_command_buffer(valkey_glide);
+    }
+    for (unsigned long i = 0; i < arg_count; i++) {
+        bytes_len += args_len[i];
+    }
+    batch_arena_reserve(arena, arg_count, bytes_len);
+
+    cmd               = &valkey_glide->buffered_commands[valkey_glide->command_count++];
+    cmd->request_type = request_type;
+    cmd->method       = method;
+    cmd->first_arg    = arena->arg_count;
+    cmd->arg_count    = arg_count;
+    cmd->route_offset = 0;
+    cmd->route_len    = route_len;
+    ZVAL_UNDEF(&cmd->reply_keys);
+
+    /* The arguments may be scratch memory of the preparer, released once it returns: they are
+     * appended to the arena, and only turned into pointers by exec() as the buffer may move */
+    for (unsigned long i = 0; i < arg_count; i++) {
+        if (args_len[i] > 0) {
+            memcpy(arena->bytes + arena->bytes_len, (const void*) args[i], args_len[i]);
+        }
+        arena->offsets[arena->arg_count] = arena->bytes_len;
+        arena->lengths[arena->arg_count] = args_len[i];
+        arena->bytes_len += args_len[i];
+        arena->arg_count++;
+    }
+    if (route_len > 0) {
+        memcpy(arena->bytes + arena->bytes_len, route_bytes, route_len);
+        cmd->route_offset = arena->bytes_len;
+        arena->bytes_len += route_len;
+        arena->routed_count++;
+    }
+}
+
+bool valkey_glide_batch_record(enum RequestType     request_type,
+                               unsigned long        arg_count,
+                               const uintptr_t*     args,
+                               const unsigned long* args_len) {
+    valkey_glide_object* valkey_glide = valkey_glide_current_object();
+
+    if (!valkey_glide || !valkey_glide->batch_method) {
+        return false;
+    }
+    valkey_glide_batch_append(valkey_glide,
+                              valkey_glide->batch_method,
+                              request_type,
+                              arg_count,
+                              args,
+                              args_len,
+                              NULL,
+                              0);
+    return true;
+}
+
+bool valkey_glide_batch_record_routed(enum RequestType     request_type,
+                                      unsigned long        arg_count,
+                                      const uintptr_t*     args,
+                                      const unsigned long* args_len,
+                                      const uint8_t*       route_bytes,
+                                      size_t               route_len) {
+    valkey_glide_object* valkey_glide = valkey_glide_current_object();
+
+    /* A transaction runs on the node of its keys, so its routed commands still run at once */
+    if (!valkey_glide || !valkey_glide->batch_method || valkey_glide->batch_type != PIPELINE) {
+        return false;
+    }
+    valkey_glide_batch_append(valkey_glide,
+                              valkey_glide->batch_method,
+                              request_type,
+                              arg_count,
+                              args,
+                              args_len,
+                              route_bytes,
+                              route_len);
+    return true;
+}
+
+bool valkey_glide_batch_parse_options(HashTable*            options,
+                                      struct batch_options* batch_options,
+                                      uint32_t              arg_num) {
+    zend_string* name;
+    zval*        value;
+
+    ZEND_HASH_FOREACH_STR_KEY_VAL(options, name, value) {
+        if (!name) {
+            zend_argument_value_error(arg_num, "must only have string keys");
+            return false;
+        }
+        if (zend_string_equals_literal(name, "timeout")) {
+            if (Z_TYPE_P(value) != IS_LONG || Z_LVAL_P(value) < 0 ||
+                (zend_ulong) Z_LVAL_P(value) > UINT32_MAX) {
+                zend_argument_value_error(
+                    arg_num, "option \"timeout\" must be a number of milliseconds");
+                return false;
+            }
+            batch_options->timeout = (uint32_t) Z_LVAL_P(value);
+        } else if (zend_string_equals_literal(name, "raise_on_error")) {
+            batch_options->raise_on_error = zend_is_true(value);
+        } else if (zend_string_equals_literal(name, "retry_server_error")) {
+            batch_options->retry_server_error = zend_is_true(value);
+        } else if (zend_string_equals_literal(name, "retry_connection_error")) {
+            batch_options->retry_connection_error = zend_is_true(value);
+        } else {
+            zend_argument_value_error(arg_num, "has an unknown option \"%s\"", ZSTR_VAL(name));
+            return false;
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+
+    return true;
+}
+
+/* The CmdInfo of every buffered command, valid until the next command is buffered */
+static const struct CmdInfo* const* batch_cmd_infos(valkey_glide_object* valkey_glide) {
+    struct batch_arena* arena = &valkey_glide->batch_arena;
+
+    for (size_t i = 0; i < arena->arg_count; i++) {
+        arena->args[i] = (const uint8_t*) arena->bytes + arena->offsets[i];
+    }
+    for (size_t i = 0; i < valkey_glide->command_count; i++) {
+        struct batch_command* cmd      = &valkey_glide->buffered_commands[i];
+        struct CmdInfo*       cmd_info = &arena->cmd_infos[i];
+
+        cmd_info->request_type = cmd->request_type;
+        cmd_info->args         = (const uint8_t* const*) &arena->args[cmd->first_arg];
+        cmd_info->arg_count    = cmd->arg_count;
+        cmd_info->args_len     = (const uintptr_t*) &arena->lengths[cmd->first_arg];
+
+        arena->cmd_info_ptrs[i] = cmd_info;
+    }
+    return (const struct CmdInfo* const*) arena->cmd_info_ptrs;
+}
+
+const struct CmdInfo* valkey_glide_batch_cmd_info(valkey_glide_object* valkey_glide,
+                                                  size_t               index) {
+    return batch_cmd_infos(valkey_glide)[index];
+}
+
+/* Bytes held by the arena and the command buffer of a client */
+static size_t batch_arena_size(valkey_glide_object* valkey_glide) {
+    const struct batch_arena* arena = &valkey_glide->batch_arena;
+
+    return arena->bytes_capacity +
+           arena->arg_capacity * (sizeof(size_t) + sizeof(uintptr_t) + sizeof(uint8_t*)) +
+           valkey_glide->command_capacity *
+               (sizeof(struct batch_command) + sizeof(struct CmdInfo) + sizeof(struct CmdInfo*));
+}
+
+void valkey_glide_batch_clear(valkey_glide_object* valkey_glide) {
+    struct batch_arena* arena;
+
+    if (!valkey_glide) {
+        return;
+    }
+    arena = &valkey_glide->batch_arena;
+
+    /* Only the HMGET-like commands hold a reference, the rest is dropped at once */
+    if (arena->keyed_count > 0) {
+        for (size_t i = 0; i < valkey_glide->command_count; i++) {
+            zval_ptr_dtor(&valkey_glide->buffered_commands[i].reply_keys);
+        }
+        arena->keyed_count = 0;
+    }
+    arena->routed_count            = 0;
+    valkey_glide->command_count    = 0;
+    arena->arg_count               = 0;
+    arena->bytes_len               = 0;
+    valkey_glide->is_in_batch_mode = false;
+    valkey_glide->batch_type       = MULTI;
+    memset(&valkey_glide->batch_options, 0, sizeof(valkey_glide->batch_options));
+
+    if (batch_arena_size(valkey_glide) > VALKEY_GLIDE_BATCH_SPARE_LIMIT) {
+        valkey_glide_batch_free(valkey_glide);
+    }
+}
+
+void valkey_glide_batch_free(valkey_glide_object* valkey_glide) {
+    struct batch_arena* arena = &valkey_glide->batch_arena;
+
+    if (valkey_glide->command_count > 0) {
+        valkey_glide_batch_clear(valkey_glide);
+    }
+    if (valkey_glide->buffered_commands) {
+        efree(valkey_glide->buffered_commands);
+        valkey_glide->buffered_commands = NULL;
+    }
+    if (arena->bytes) {
+        efree(arena->bytes);
+    }
+    if (arena->offsets) {
+        efree(arena->offsets);
+        efree(arena->lengths);
+        efree(arena->args);
+    }
+    if (arena->cmd_infos) {
+        efree(arena->cmd_infos);
+        efree(arena->cmd_info_ptrs);
+    }
+    memset(arena, 0, sizeof(*arena));
+    valkey_glide->command_capacity = 0;
+}
+
+/* ====================================================================
+ * REPLIES
+ * ==================================================================== */
+
+static void batch_reply_double(CommandResponse* response, zval* out) {
+    switch (response->response_type) {
+        case Float:
+            ZVAL_DOUBLE(out, response->float_value);
+            break;
+        case Int:
+            ZVAL_DOUBLE(out, (double) response->int_value);
+            break;
+        case String: {
+            char buf[64];
+
+            if (response->string_value_len < sizeof(buf)) {
+                memcpy(buf, response->string_value, response->string_value_len);
+                buf[response->string_value_len] = '\0';
+                ZVAL_DOUBLE(out, zend_strtod(buf, NULL));
+                break;
+            }
+            ZVAL_FALSE(out);
+            break;
+        }
+        default:
+            ZVAL_FALSE(out);
+            break;
+    }
+}
+
+static void batch_reply_type(CommandResponse* response, zval* out) {
+    static const struct {
+        const char* name;
+        size_t      len;
+        zend_long   type;
+    } types[] = {
+        {"string", 6, VALKEY_GLIDE_STRING},
+        {"set", 3, VALKEY_GLIDE_SET},
+        {"list", 4, VALKEY_GLIDE_LIST},
+        {"zset", 4, VALKEY_GLIDE_ZSET},
+        {"hash", 4, VALKEY_GLIDE_HASH},
+        {"stream", 6, VALKEY_GLIDE_STREAM},
+    };
+
+    ZVAL_LONG(out, VALKEY_GLIDE_NOT_FOUND);
+    if (response->response_type != String) {
+        return;
+    }
+    for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+        if (response->string_value_len == types[i].len &&
+            memcmp(response->string_value, types[i].name, types[i].len) == 0) {
+            ZVAL_LONG(out, types[i].type);
+            return;
+        }
+    }
+}
+
+/* HMGET: [field => value], false for the missing fields */
+static void batch_reply_keyed(const valkey_glide_options_t* options,
+                              struct batch_command*         cmd,
+                              CommandResponse*              response,
+                              zval*                         out) {
+    zval*     key;
+    zval      value;
+    zend_long i = 0;
+
+    if (response->response_type != Array || Z_TYPE(cmd->reply_keys) != IS_ARRAY) {
+        ZVAL_FALSE(out);
+        return;
+    }
+
+    array_init_size(out, response->array_value_len);
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL(cmd->reply_keys), key) {
+        CommandResponse* element;
+        zend_string*     field;
+
+        if (i >= response->array_value_len) {
+            break;
+        }
+        element = &response->array_value[i++];
+        if (element->response_type == String) {
+            valkey_glide_unserialize(
+                options, element->string_value, element->string_value_len, &value);
+        } else if (element->response_type == Null) {
+            ZVAL_FALSE(&value);
+        } else {
+            ZVAL_NULL(&value);
+        }
+        field = zval_get_string(key);
+        zend_symtable_update(Z_ARRVAL_P(out), field, &value);
+        zend_string_release(field);
+    }
+    ZEND_HASH_FOREACH_END();
+}
+
+/* Convert the reply of one buffered command, as its method converts it outside of a batch */
+static void batch_reply(const valkey_glide_options_t* options,
+                        struct batch_command*         cmd,
+                        CommandResponse*              response,
+                        zval*                         out) {
+    const valkey_glide_batch_method* method       = cmd->method;
+    bool                             nested_false = false;
+    bool                             values       = false;
+
+    if (!method) {
+        command_response_to_shape_zval(
+            response, command_response_shape(cmd->request_type), out, false);
+        return;
+    }
+    nested_false = (method->flags & BATCH_REPLY_NESTED_FALSE) != 0;
+    values       = (method->flags & BATCH_REPLY_VALUES) &&
+                   valkey_glide_options_encode_values(options);
+
+    if (response->response_type == Null && method->reply != BATCH_REPLY_TYPE) {
+        if (method->flags & BATCH_REPLY_NULL) {
+            ZVAL_NULL(out);
+        } else {
+            ZVAL_FALSE(out);
+        }
+        return;
+    }
+
+    switch (method->reply) {
+        case BATCH_REPLY_BOOL:
+            if (response->response_type == Int) {
+                ZVAL_BOOL(out, response->int_value != 0);
+            } else if (response->response_type == Bool) {
+                ZVAL_BOOL(out, response->bool_value);
+            } else {
+                ZVAL_BOOL(out, response->response_type == Ok);
+            }
+            return;
+        case BATCH_REPLY_DOUBLE:
+            batch_reply_double(response, out);
+            return;
+        case BATCH_REPLY_TYPE:
+            batch_reply_type(response, out);
+            return;
+        case BATCH_REPLY_KEYED:
+            batch_reply_keyed(options, cmd, response, out);
+            return;
+        case BATCH_REPLY_PONG:
+            if (cmd->arg_count == 0 && response->response_type == String &&
+                response->string_value_len == 4 && memcmp(response->string_value, "PONG", 4) == 0) {
+                ZVAL_TRUE(out);
+                return;
+            }
+            break;
+        case BATCH_REPLY_INFO:
+            if (!valkey_glide_info_to_zval(response, out)) {
+                ZVAL_FALSE(out);
+            }
+            return;
+        case BATCH_REPLY_CLIENT:
+            if (!valkey_glide_client_reply_to_zval(cmd->request_type, response, out)) {
+                ZVAL_FALSE(out);
+            }
+            return;
+        case BATCH_REPLY_FUNCTION:
+            command_response_to_zval(
+                response, out, COMMAND_RESPONSE_ASSOSIATIVE_ARRAY_MAP_FUNCTION, nested_false);
+            return;
+        case BATCH_REPLY_MAP:
+            command_response_to_zval(
+                response, out, COMMAND_RESPONSE_ASSOSIATIVE_ARRAY_MAP, nested_false);
+            if (values && Z_TYPE_P(out) == IS_ARRAY) {
+                valkey_glide_unserialize_array(options, out);
+            }
+            return;
+        default:
+            break;
+    }
+
+    if (values) {
+        command_response_to_values_zval(
+            response, command_response_shape(cmd->request_type), out, nested_false);
+    } else {
+        command_response_to_shape_zval(
+            response, command_response_shape(cmd->request_type), out, nested_false);
+    }
+}
+
+void valkey_glide_batch_convert_reply(const valkey_glide_options_t* options,
+                                      struct batch_command*         cmd,
+                                      CommandResponse*              response,
+                                      zval*                         out) {
+    batch_reply(options, cmd, response, out);
+}
+
+/* Convert the reply of exec(), each command's reply as its method returns it. Returns 0 with
+ * an exception thrown when a reply could not be converted. */
+static int batch_replies(valkey_glide_object* valkey_glide,
+                         CommandResponse*     response,
+                         zval*                replies) {
+    const valkey_glide_options_t* options = valkey_glide_current_options();
+    zval                          reply;
+
+    if (response->response_type != Array ||
+        (size_t) response->array_value_len != valkey_glide->command_count) {
+        return command_response_to_zval(response, replies, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false);
+    }
+
+    array_init_size(replies, valkey_glide->command_count);
+    for (size_t i = 0; i < valkey_glide->command_count; i++) {
+        batch_reply(
+            options, &valkey_glide->buffered_commands[i], &response->array_value[i], &reply);
+        if (EG(exception)) {
+            zval_ptr_dtor(replies);
+            ZVAL_NULL(replies);
+            return 0;
+        }
+        add_next_index_zval(replies, &reply);
+    }
+    return 1;
+}
+
+/* ====================================================================
+ * EXECUTION
+ * ==================================================================== */
+
+/* Convert the result of a batch, or record its error */
+static int batch_result(valkey_glide_object* valkey_glide, CommandResult* result, zval* replies) {
+    int status = 0;
+
+    if (!result) {
+        return 0;
+    }
+    if (result->command_error) {
+        /* Batch failed: EXECABORT, or a timeout or lost connection, which throw */
+        valkey_glide_command_error(result->command_error);
+    } else if (result->response) {
+        status = batch_replies(valkey_glide, result->response, replies);
+    }
+    free_command_result(result);
+    return status;
+}
+
+/* Send a routed command of the buffer on the async connection of the client */
+static valkey_glide_async_request* batch_send_routed(valkey_glide_object*         valkey_glide,
+                                                     const struct CmdInfo* const* cmd_infos,
+                                                     size_t                       index) {
+    struct batch_command* cmd = &valkey_glide->buffered_commands[index];
+
+    return valkey_glide_async_send(valkey_glide,
+                                   cmd->request_type,
+                                   cmd->arg_count,
+                                   (const uintptr_t*) cmd_infos[index]->args,
+                                   (const unsigned long*) cmd_infos[index]->args_len,
+                                   (const uint8_t*) valkey_glide->batch_arena.bytes +
+                                       cmd->route_offset,
+                                   cmd->route_len);
+}
+
+/* Whether the retry options of the batch send a routed command that failed again */
+static bool batch_retry_routed(const struct BatchOptionsInfo* options, const CommandError* error) {
+    const char* message = error->command_error_message;
+
+    if (error->command_error_type == Disconnect) {
+        return options->retry_connection_error;
+    }
+    return options->retry_server_error && message &&
+           (strstr(message, "TRYAGAIN") || strstr(message, "TryAgain"));
+}
+
+/* A pipeline with routed commands. The commands routed by their keys go as one batch, split by
+ * slot and sent to the nodes in parallel by the core, while the routed commands are all in
+ * flight on the async connection of the client: the core multiplexes them, so the commands
+ * routed to one node share its round trips. The timeout of the batch is their deadline too, and
+ * its retry options send them again once. The replies are put back together in the order of
+ * the commands, a routed command that failed being false in its place like a command of the
+ * batch, its error kept for getLastError(). */
+static int batch_exec_segments(valkey_glide_object*           valkey_glide,
+                               const struct CmdInfo* const*   cmd_infos,
+                               bool                           raise_on_error,
+                               const struct BatchOptionsInfo* options,
+                               zval*                          replies) {
+    size_t                       count        = valkey_glide->command_count;
+    size_t                       routed_count = valkey_glide->batch_arena.routed_count;
+    valkey_glide_async_request** requests;
+    size_t*                      positions;
+    CommandResponse**            routed;
+    CommandError*                errors;
+    const struct CmdInfo**       keyed;
+    CommandResponse*             merged;
+    CommandResult*               result = NULL;
+    CommandResponse              response;
+    struct timespec              deadline;
+    const struct timespec*       wait_until  = NULL;
+    size_t                       sent        = 0;
+    size_t                       keyed_count = 0;
+    int                          status      = 0;
+
+    requests = (valkey_glide_async_request**) safe_emalloc(
+        routed_count, sizeof(valkey_glide_async_request*), 0);
+    positions = (size_t*) safe_emalloc(routed_count, sizeof(size_t), 0);
+    routed    = (CommandResponse**) ecalloc(routed_count, sizeof(CommandResponse*));
+    errors    = (CommandError*) ecalloc(routed_count, sizeof(CommandError));
+    keyed     = (const struct CmdInfo**) safe_emalloc(
+        count - routed_count, sizeof(struct CmdInfo*), 0);
+    merged = (CommandResponse*) ecalloc(count, sizeof(CommandResponse));
+
+    if (options->has_timeout) {
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += options->timeout / 1000;
+        deadline.tv_nsec += (long) (options->timeout % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+        wait_until = &deadline;
+    }
+
+    /* The routed commands go first, to be in flight while the batch runs */
+    for (size_t i = 0; i < count; i++) {
+        if (valkey_glide->buffered_commands[i].route_len == 0) {
+            keyed[keyed_count++] = cmd_infos[i];
+            continue;
+        }
+        requests[sent] = batch_send_routed(valkey_glide, cmd_infos, i);
+        if (!requests[sent]) {
+            break;
+        }
+        positions[sent++] = i;
+    }
+    if (sent == routed_count && keyed_count > 0) {
+        struct BatchInfo batch_info;
+
+        batch_info.cmd_count = keyed_count;
+        batch_info.cmds      = keyed;
+        batch_info.is_atomic = false;
+        result = batch(valkey_glide->glide_client, 0, &batch_info, raise_on_error, options, 0);
+    }
+
+    /* Every request sent is waited for, even when the batch failed */
+    for (size_t i = 0; i < sent; i++) {
+        routed[i] = valkey_glide_async_finish(requests[i], wait_until, &errors[i]);
+    }
+    for (size_t i = 0; sent == routed_count && i < sent; i++) {
+        requests[i] = NULL;
+        if (!routed[i] && !EG(exception) && batch_retry_routed(options, &errors[i])) {
+            requests[i] = batch_send_routed(valkey_glide, cmd_infos, positions[i]);
+        }
+    }
+    for (size_t i = 0; sent == routed_count && i < sent; i++) {
+        if (requests[i]) {
+            efree((char*) errors[i].command_error_message);
+            errors[i].command_error_message = NULL;
+            routed[i] = valkey_glide_async_finish(requests[i], wait_until, &errors[i]);
+        }
+    }
+    if (sent < routed_count || (keyed_count > 0 && !result) || EG(exception)) {
+        goto done;
+    }
+    if (result && result->command_error) {
+        valkey_glide_command_error(result->command_error);
+        goto done;
+    }
+    if (result && (!result->response || result->response->response_type != Array ||
+                   (size_t) result->response->array_value_len != keyed_count)) {
+        goto done;
+    }
+    for (size_t i = 0; raise_on_error && i < sent; i++) {
+        if (!routed[i]) {
+            valkey_glide_command_error(&errors[i]);
+            goto done;
+        }
+    }
+
+    /* The elements still belong to the results, freed once converted */
+    for (size_t i = 0, k = 0, r = 0; i < count; i++) {
+        if (valkey_glide->buffered_commands[i].route_len == 0) {
+            merged[i] = result->response->array_value[k++];
+        } else if (routed[r++]) {
+            merged[i] = *routed[r - 1];
+        } else {
+            merged[i].response_type = Null;
+        }
+    }
+    memset(&response, 0, sizeof(response));
+    response.response_type   = Array;
+    response.array_value     = merged;
+    response.array_value_len = count;
+    status                   = batch_replies(valkey_glide, &response, replies);
+
+    /* A routed command that failed is false, its error kept as the last */
+    for (size_t r = 0; status && r < sent; r++) {
+        zval failed;
+
+        if (routed[r]) {
+            continue;
+        }
+        valkey_glide_set_last_error(errors[r].command_error_message,
+                                    strlen(errors[r].command_error_message));
+        ZVAL_FALSE(&failed);
+        zend_hash_index_update(Z_ARRVAL_P(replies), positions[r], &failed);
+    }
+
+done:
+    for (size_t i = 0; i < sent; i++) {
+        if (routed[i]) {
+            free_command_response(routed[i]);
+        } else {
+            efree((char*) errors[i].command_error_message);
+        }
+    }
+    if (result) {
+        free_command_result(result);
+    }
+    efree(requests);
+    efree(positions);
+    efree(routed);
+    efree(errors);
+    efree(keyed);
+    efree(merged);
+    return status;
+}
+
+int valkey_glide_batch_exec(valkey_glide_object*        valkey_glide,
+                            const struct batch_options* batch_options,
+                            zval*                       replies) {
+    const struct CmdInfo* const* cmd_infos   = batch_cmd_infos(valkey_glide);
+    bool                         is_pipeline = valkey_glide->batch_type == PIPELINE;
+    struct BatchOptionsInfo      options     = {0};
+    struct BatchInfo             batch_info;
+
+    /* Retries could run a command twice, so they are only for pipelines */
+    options.retry_server_error     = batch_options->retry_server_error && is_pipeline;
+    options.retry_connection_error = batch_options->retry_connection_error && is_pipeline;
+    options.has_timeout            = batch_options->timeout > 0;
+    options.timeout                = batch_options->timeout;
+    options.route_info             = NULL;
+
+    if (valkey_glide->batch_arena.routed_count > 0) {
+        return batch_exec_segments(
+            valkey_glide, cmd_infos, batch_options->raise_on_error, &options, replies);
+    }
+
+    batch_info.cmd_count = valkey_glide->command_count;
+    batch_info.cmds      = cmd_infos;
+    batch_info.is_atomic = !is_pipeline;
+    return batch_result(valkey_glide,
+                        batch(valkey_glide->glide_client,
+                              0,
+                              &batch_info,
+                              batch_options->raise_on_error,
+                              &options,
+                              0),
+                        replies);
+}
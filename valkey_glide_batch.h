@@ -0,0 +1,141 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Batches                                                 |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef VALKEY_GLIDE_BATCH_H
+#define VALKEY_GLIDE_BATCH_H
+
+#include "common.h"
+#include "php.h"
+
+/*
+ * Commands buffered between multi()/pipeline() and exec().
+ *
+ * The methods of the batch_methods table are wrapped, as the cache wraps its read methods.
+ * After multi() a wrapped method runs its handler as usual: the arguments are parsed,
+ * prefixed and serialized by the same preparer as outside of a batch, but execute_command()
+ * hands the packed arguments to valkey_glide_batch_record() instead of sending them, and the
+ * method returns the client for chaining. Methods that are not in the table still run at once.
+ *
+ * In a pipeline of ValkeyGlideCluster the commands may span any number of slots: the core
+ * splits the batch by node, sends the parts in parallel and puts the replies back in order.
+ * A command sent with an explicit route (allPrimaries, a node address...) is buffered too, with
+ * its packed route. exec() sends the routed commands on the async connection of the client, all
+ * in flight while the batch of the other commands runs, with the timeout and the retry options
+ * of the batch, and a routed command that fails is false in its place in the replies. As across
+ * slots, the order of a routed command and the other commands on a node is not kept.
+ *
+ * The packed arguments are appended to the batch arena of the client: one byte buffer with an
+ * offset and a length per argument. exec() turns the offsets into pointers and builds all the
+ * CmdInfo at once, and the arena is reset without being freed, so a batch of any size costs a
+ * copy per argument and no allocation once the arena has grown to it.
+ *
+ * Each buffered command keeps the row of its method, which says how exec() converts its reply
+ * so that it has the shape the method returns outside of a batch: 1/0 as a bool, a TYPE name
+ * as a ValkeyGlide::VALKEY_GLIDE_* constant, HMGET values keyed by their fields, and so on.
+ */
+
+/* Arena and command buffer kept for the next batch up to this size, in bytes */
+#define VALKEY_GLIDE_BATCH_SPARE_LIMIT (4 * 1024 * 1024)
+
+/* How exec() converts the reply of a buffered command */
+typedef enum {
+    BATCH_REPLY_RAW,      /* As converted, in the shape of the request type */
+    BATCH_REPLY_BOOL,     /* 1/0 as true/false */
+    BATCH_REPLY_DOUBLE,   /* A float or a numeric string as a float */
+    BATCH_REPLY_MAP,      /* A map as an associative array */
+    BATCH_REPLY_KEYED,    /* A list keyed by the values of the array argument keys_arg */
+    BATCH_REPLY_TYPE,     /* A TYPE name as a ValkeyGlide::VALKEY_GLIDE_* constant */
+    BATCH_REPLY_PONG,     /* PONG as true when PING had no message */
+    BATCH_REPLY_INFO,     /* INFO parsed into [field => value], per node when routed to several */
+    BATCH_REPLY_CLIENT,   /* CLIENT LIST parsed into one array per client */
+    BATCH_REPLY_FUNCTION, /* A map as an associative array, without the node wrapper */
+} valkey_glide_batch_reply;
+
+/* Flags of a batch_methods row */
+#define BATCH_REPLY_NULL (1 << 0)         /* A null reply stays null rather than false */
+#define BATCH_REPLY_NESTED_FALSE (1 << 1) /* Null elements are false too */
+#define BATCH_REPLY_VALUES (1 << 2)       /* Strings are stored values, unserialized */
+
+typedef struct valkey_glide_batch_method {
+    const char* name; /* Lowercase, as in the function table */
+    uint8_t     reply;
+    uint8_t     flags;
+    int8_t      keys_arg; /* Argument kept for BATCH_REPLY_KEYED, -1 otherwise */
+} valkey_glide_batch_method;
+
+/* Buffer the methods of the table for ValkeyGlide and ValkeyGlideCluster, called from MINIT
+ * after valkey_glide_cache_install() */
+void valkey_glide_batch_install(zend_class_entry* ce);
+
+/* The row of a method wrapped by valkey_glide_batch_install(), NULL for the other methods */
+const valkey_glide_batch_method* valkey_glide_batch_method_of(const zend_function* func);
+
+/* Free the handler lookup, from MSHUTDOWN */
+void valkey_glide_batch_shutdown(void);
+
+/* Buffer a command of the client whose wrapped method is running, copying its arguments to
+ * the arena. Returns false, to send it, when no method is being recorded. */
+bool valkey_glide_batch_record(enum RequestType     request_type,
+                               unsigned long        arg_count,
+                               const uintptr_t*     args,
+                               const unsigned long* args_len);
+
+/* Set the options present in an options array of pipeline() or exec(), argument arg_num.
+ * Returns false with an error thrown for an unknown option or an invalid value. */
+bool valkey_glide_batch_parse_options(HashTable*            options,
+                                      struct batch_options* batch_options,
+                                      uint32_t              arg_num);
+
+/* Append a packed command, with its packed route if route_len is not 0, to the buffer of a
+ * client in batch mode, copying its arguments to the arena */
+void valkey_glide_batch_append(valkey_glide_object*             valkey_glide,
+                               const valkey_glide_batch_method* method,
+                               enum RequestType                 request_type,
+                               unsigned long                    arg_count,
+                               const uintptr_t*                 args,
+                               const unsigned long*             args_len,
+                               const uint8_t*                   route_bytes,
+                               size_t                           route_len);
+
+/* Buffer a command sent with an explicit route, a pipeline of ValkeyGlideCluster being
+ * recorded. Returns false, to send it at once, otherwise and in a transaction. */
+bool valkey_glide_batch_record_routed(enum RequestType     request_type,
+                                      unsigned long        arg_count,
+                                      const uintptr_t*     args,
+                                      const unsigned long* args_len,
+                                      const uint8_t*       route_bytes,
+                                      size_t               route_len);
+
+/* Send the buffered commands and convert their replies, each as its method returns it. Returns
+ * 0 when the batch failed, its error recorded or thrown. */
+int valkey_glide_batch_exec(valkey_glide_object*        valkey_glide,
+                            const struct batch_options* batch_options,
+                            zval*                       replies);
+
+/* The packed arguments of a buffered command, valid until the next command is buffered */
+const struct CmdInfo* valkey_glide_batch_cmd_info(valkey_glide_object* valkey_glide,
+                                                  size_t               index);
+
+/* Convert the reply of a buffered command as its method returns it, as exec() does */
+void valkey_glide_batch_convert_reply(const valkey_glide_options_t* options,
+                                      struct batch_command*         cmd,
+                                      CommandResponse*              response,
+                                      zval*                         out);
+
+/* Leave batch mode and drop the buffered commands, keeping the arena for the next batch */
+void valkey_glide_batch_clear(valkey_glide_object* valkey_glide);
+
+/* Free the arena and the command buffer, from the free_obj handler */
+void valkey_glide_batch_free(valkey_glide_object* valkey_glide);
+
+#endif /* VALKEY_GLIDE_BATCH_H */
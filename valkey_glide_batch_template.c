@@ -0,0 +1,426 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Batch Templates                                         |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#include "valkey_glide_batch_template.h"
+
+#include <zend_exceptions.h>
+#include <zend_smart_str.h>
+
+#include "valkey_glide_batch.h"
+#include "valkey_glide_batch_template_arginfo.h"
+#include "valkey_glide_options.h"
+
+/* Class entry and handlers */
+zend_class_entry*           valkey_glide_batch_template_ce;
+static zend_object_handlers valkey_glide_batch_template_object_handlers;
+
+#define VALKEY_GLIDE_BATCH_TEMPLATE_GET_OBJECT(o) \
+    VALKEY_GLIDE_PHP_GET_OBJECT(valkey_glide_batch_template_object, o)
+
+static zend_object* create_valkey_glide_batch_template_object(zend_class_entry* ce) {
+    valkey_glide_batch_template_object* object =
+        ecalloc(1, sizeof(valkey_glide_batch_template_object) + zend_object_properties_size(ce));
+
+    zend_object_std_init(&object->std, ce);
+    object_properties_init(&object->std, ce);
+    object->std.handlers = &valkey_glide_batch_template_object_handlers;
+
+    return &object->std;
+}
+
+static void free_valkey_glide_batch_template_object(zend_object* object) {
+    valkey_glide_batch_template_object* tpl = VALKEY_GLIDE_BATCH_TEMPLATE_GET_OBJECT(object);
+
+    for (size_t i = 0; i < tpl->command_count; i++) {
+        zval_ptr_dtor(&tpl->commands[i].reply_keys);
+    }
+    if (tpl->commands) {
+        efree(tpl->commands);
+    }
+    if (tpl->args) {
+        efree(tpl->args);
+    }
+    if (tpl->slots) {
+        efree(tpl->slots);
+    }
+    if (tpl->bytes) {
+        zend_string_release(tpl->bytes);
+    }
+    if (tpl->client) {
+        OBJ_RELEASE(tpl->client);
+    }
+    zend_object_std_dtor(&tpl->std);
+}
+
+void register_valkey_glide_batch_template_class(void) {
+    valkey_glide_batch_template_ce = register_class_ValkeyGlideBatchTemplate();
+    valkey_glide_batch_template_ce->create_object = create_valkey_glide_batch_template_object;
+    memcpy(&valkey_glide_batch_template_object_handlers,
+           zend_get_std_object_handlers(),
+           sizeof(valkey_glide_batch_template_object_handlers));
+    valkey_glide_batch_template_object_handlers.offset =
+        XtOffsetOf(valkey_glide_batch_template_object, std);
+    valkey_glide_batch_template_object_handlers.free_obj  = free_valkey_glide_batch_template_object;
+    valkey_glide_batch_template_object_handlers.clone_obj = NULL;
+}
+
+/* ====================================================================
+ * COMPILING
+ * ==================================================================== */
+
+static size_t built_len(const smart_str* str) {
+    return str->s ? ZSTR_LEN(str->s) : 0;
+}
+
+#define PARAM_PREFIX VALKEY_GLIDE_BATCH_TEMPLATE_PARAM_PREFIX
+#define PARAM_PREFIX_LEN (sizeof(VALKEY_GLIDE_BATCH_TEMPLATE_PARAM_PREFIX) - 1)
+#define PARAM_SUFFIX VALKEY_GLIDE_BATCH_TEMPLATE_PARAM_SUFFIX
+#define PARAM_SUFFIX_LEN (sizeof(VALKEY_GLIDE_BATCH_TEMPLATE_PARAM_SUFFIX) - 1)
+
+/* Builders running on this thread, whose values must not hide a placeholder */
+static ZEND_TLS uint32_t preparing = 0;
+
+bool valkey_glide_batch_template_encoded_param(const char* value, size_t len) {
+    if (!preparing || !value || !zend_memnstr(value, PARAM_PREFIX, PARAM_PREFIX_LEN, value + len)) {
+        return false;
+    }
+    zend_value_error(
+        "ValkeyGlideBatchTemplate::param() cannot be in a serialized or compressed value");
+    return true;
+}
+
+/* The index of the placeholder at p, or -1 if the bytes at p are not one */
+static zend_long batch_template_param_at(const char* p, const char* end, const char** next) {
+    zend_long index = 0;
+
+    p += PARAM_PREFIX_LEN;
+    if (p == end || *p < '0' || *p > '9') {
+        return -1;
+    }
+    while (p < end && *p >= '0' && *p <= '9' && index <= UINT32_MAX / 10) {
+        index = index * 10 + (*p++ - '0');
+    }
+    if (index > UINT32_MAX || (size_t) (end - p) < PARAM_SUFFIX_LEN ||
+        memcmp(p, PARAM_SUFFIX, PARAM_SUFFIX_LEN) != 0) {
+        return -1;
+    }
+    *next = p + PARAM_SUFFIX_LEN;
+    return index;
+}
+
+/* Copy the commands buffered by the builder, taking the placeholders out of their arguments */
+static void batch_template_compile(valkey_glide_batch_template_object* tpl,
+                                   valkey_glide_object*                valkey_glide) {
+    const struct batch_arena* arena         = &valkey_glide->batch_arena;
+    smart_str                 bytes         = {0};
+    size_t                    slot_count    = 0;
+    size_t                    slot_capacity = 0;
+
+    tpl->batch_type    = valkey_glide->batch_type;
+    tpl->command_count = valkey_glide->command_count;
+    tpl->commands      = (struct batch_command*) safe_emalloc(
+        tpl->command_count, sizeof(struct batch_command), 0);
+    memcpy(tpl->commands,
+           valkey_glide->buffered_commands,
+           tpl->command_count * sizeof(struct batch_command));
+    tpl->args = (valkey_glide_batch_template_arg*) safe_emalloc(
+        arena->arg_count, sizeof(valkey_glide_batch_template_arg), 0);
+
+    for (size_t i = 0; i < tpl->command_count; i++) {
+        struct batch_command* cmd = &tpl->commands[i];
+
+        Z_TRY_ADDREF(cmd->reply_keys);
+
+        for (size_t j = cmd->first_arg; j < cmd->first_arg + cmd->arg_count; j++) {
+            valkey_glide_batch_template_arg* arg = &tpl->args[j];
+            const char*                      p   = arena->bytes + arena->offsets[j];
+            const char*                      end = p + arena->lengths[j];
+            const char*                      mark;
+            const char*                      next;
+            zend_long                        index;
+
+            arg->offset     = built_len(&bytes);
+            arg->first_slot = (uint32_t) slot_count;
+            arg->slot_count = 0;
+
+            while ((mark = zend_memnstr(p, PARAM_PREFIX, PARAM_PREFIX_LEN, end)) != NULL) {
+                smart_str_appendl(&bytes, p, mark - p);
+                index = batch_template_param_at(mark, end, &next);
+                if (index < 0) {
+                    smart_str_appendl(&bytes, mark, PARAM_PREFIX_LEN);
+                    p = mark + PARAM_PREFIX_LEN;
+                    continue;
+                }
+                p = next;
+
+                if (slot_count == slot_capacity) {
+                    slot_capacity = MAX(slot_capacity * 2, 8);
+                    tpl->slots    = (valkey_glide_batch_template_slot*) safe_erealloc(
+                        tpl->slots, slot_capacity, sizeof(valkey_glide_batch_template_slot), 0);
+                }
+                tpl->slots[slot_count].pos   = built_len(&bytes) - arg->offset;
+                tpl->slots[slot_count].param = (uint32_t) index;
+                tpl->param_count             = MAX(tpl->param_count, (uint32_t) index + 1);
+                slot_count++;
+                arg->slot_count++;
+            }
+            smart_str_appendl(&bytes, p, end - p);
+            arg->len = built_len(&bytes) - arg->offset;
+        }
+
+        if (cmd->route_len > 0) {
+            size_t route_offset = cmd->route_offset;
+
+            cmd->route_offset = built_len(&bytes);
+            smart_str_appendl(&bytes, arena->bytes + route_offset, cmd->route_len);
+        }
+        tpl->max_arg_count = MAX(tpl->max_arg_count, (uint32_t) cmd->arg_count);
+    }
+
+    tpl->bytes = smart_str_extract(&bytes);
+}
+
+void valkey_glide_batch_template_prepare(zval*                  object,
+                                         zend_fcall_info*       builder,
+                                         zend_fcall_info_cache* builder_cache,
+                                         zend_long              batch_type,
+                                         zval*                  return_value) {
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    valkey_glide_batch_template_object* tpl;
+    zval                                retval;
+
+    if (batch_type != MULTI && batch_type != PIPELINE) {
+        zend_argument_value_error(2, "must be either ValkeyGlide::MULTI or ValkeyGlide::PIPELINE");
+        return;
+    }
+    if (valkey_glide->is_in_batch_mode) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "Cannot prepare a batch inside multi() or pipeline()",
+                             0);
+        return;
+    }
+
+    /* The builder buffers its commands as it would after multi() or pipeline() */
+    valkey_glide_batch_clear(valkey_glide);
+    valkey_glide->is_in_batch_mode = true;
+    valkey_glide->batch_type       = (int) batch_type;
+
+    ZVAL_UNDEF(&retval);
+    builder->retval      = &retval;
+    builder->params      = object;
+    builder->param_count = 1;
+    preparing++;
+    if (zend_call_function(builder, builder_cache) == FAILURE || EG(exception)) {
+        preparing--;
+        zval_ptr_dtor(&retval);
+        valkey_glide_batch_clear(valkey_glide);
+        return;
+    }
+    preparing--;
+    zval_ptr_dtor(&retval);
+
+    if (!valkey_glide->is_in_batch_mode || valkey_glide->command_count == 0) {
+        valkey_glide_batch_clear(valkey_glide);
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "The batch builder did not buffer any command",
+                             0);
+        return;
+    }
+
+    object_init_ex(return_value, valkey_glide_batch_template_ce);
+    tpl         = VALKEY_GLIDE_BATCH_TEMPLATE_GET_OBJECT(Z_OBJ_P(return_value));
+    tpl->client = Z_OBJ_P(object);
+    GC_ADDREF(tpl->client);
+    batch_template_compile(tpl, valkey_glide);
+
+    valkey_glide_batch_clear(valkey_glide);
+}
+
+/* ====================================================================
+ * EXECUTION
+ * ==================================================================== */
+
+/* Append a command of the template to the batch of the client, its parameters copied into
+ * its slots */
+static void batch_template_append(valkey_glide_object*                      valkey_glide,
+                                  const valkey_glide_batch_template_object* tpl,
+                                  const struct batch_command*               cmd,
+                                  zend_string**                             params,
+                                  uintptr_t*                                args,
+                                  unsigned long*                            args_len,
+                                  smart_str*                                scratch) {
+    const uint8_t* route = NULL;
+
+    if (scratch->s) {
+        ZSTR_LEN(scratch->s) = 0;
+    }
+    for (uintptr_t i = 0; i < cmd->arg_count; i++) {
+        const valkey_glide_batch_template_arg* arg     = &tpl->args[cmd->first_arg + i];
+        const char*                            literal = ZSTR_VAL(tpl->bytes) + arg->offset;
+        size_t                                 start   = built_len(scratch);
+        size_t                                 pos     = 0;
+
+        if (arg->slot_count == 0) {
+            args[i]     = (uintptr_t) literal;
+            args_len[i] = arg->len;
+            continue;
+        }
+        for (uint32_t j = 0; j < arg->slot_count; j++) {
+            const valkey_glide_batch_template_slot* slot = &tpl->slots[arg->first_slot + j];
+
+            smart_str_appendl(scratch, literal + pos, slot->pos - pos);
+            smart_str_append(scratch, params[slot->param]);
+            pos = slot->pos;
+        }
+        smart_str_appendl(scratch, literal + pos, arg->len - pos);
+        args[i]     = start;
+        args_len[i] = built_len(scratch) - start;
+    }
+
+    /* Offsets until the scratch buffer is done growing */
+    for (uintptr_t i = 0; i < cmd->arg_count; i++) {
+        if (tpl->args[cmd->first_arg + i].slot_count > 0) {
+            args[i] += (uintptr_t) ZSTR_VAL(scratch->s);
+        }
+    }
+
+    if (cmd->route_len > 0) {
+        route = (const uint8_t*) ZSTR_VAL(tpl->bytes) + cmd->route_offset;
+    }
+    valkey_glide_batch_append(valkey_glide,
+                              cmd->method,
+                              cmd->request_type,
+                              cmd->arg_count,
+                              args,
+                              args_len,
+                              route,
+                              cmd->route_len);
+
+    if (Z_TYPE(cmd->reply_keys) != IS_UNDEF) {
+        ZVAL_COPY(&valkey_glide->buffered_commands[valkey_glide->command_count - 1].reply_keys,
+                  &cmd->reply_keys);
+        valkey_glide->batch_arena.keyed_count++;
+    }
+}
+
+/* {{{ proto array|false ValkeyGlideBatchTemplate::execute(array $params [, array $options]) */
+PHP_METHOD(ValkeyGlideBatchTemplate, execute) {
+    HashTable*                          params;
+    HashTable*                          options    = NULL;
+    struct batch_options                batch_opts = {0};
+    valkey_glide_batch_template_object* tpl;
+    valkey_glide_object*                valkey_glide;
+    valkey_glide_object*                previous;
+    zend_string**                       values;
+    uintptr_t*                          args;
+    unsigned long*                      args_len;
+    smart_str                           scratch = {0};
+    uint32_t                            count   = 0;
+    int                                 status;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+    Z_PARAM_ARRAY_HT(params)
+    Z_PARAM_OPTIONAL
+    Z_PARAM_ARRAY_HT(options)
+    ZEND_PARSE_PARAMETERS_END();
+
+    tpl = VALKEY_GLIDE_BATCH_TEMPLATE_GET_OBJECT(Z_OBJ_P(getThis()));
+    if (!tpl->client) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "ValkeyGlideBatchTemplate is not bound to a client",
+                             0);
+        RETURN_THROWS();
+    }
+    valkey_glide = VALKEY_GLIDE_PHP_GET_OBJECT(valkey_glide_object, tpl->client);
+    if (!valkey_glide->glide_client) {
+        zend_throw_exception(get_valkey_glide_exception_ce(), "Client is not connected", 0);
+        RETURN_THROWS();
+    }
+    if (valkey_glide->is_in_batch_mode) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "Cannot execute a batch template inside multi() or pipeline()",
+                             0);
+        RETURN_THROWS();
+    }
+    if (options && !valkey_glide_batch_parse_options(options, &batch_opts, 2)) {
+        RETURN_THROWS();
+    }
+
+    values = (zend_string**) safe_emalloc(tpl->param_count, sizeof(zend_string*), 0);
+    for (; count < tpl->param_count; count++) {
+        zval* value = zend_hash_index_find(params, count);
+
+        if (!value) {
+            zend_argument_value_error(1, "must have a value for parameter %u", count);
+            break;
+        }
+        values[count] = zval_get_string(value);
+        if (EG(exception)) {
+            zend_string_release(values[count]);
+            break;
+        }
+    }
+    if (count < tpl->param_count) {
+        while (count > 0) {
+            zend_string_release(values[--count]);
+        }
+        efree(values);
+        RETURN_THROWS();
+    }
+
+    args     = (uintptr_t*) safe_emalloc(tpl->max_arg_count, sizeof(uintptr_t), 0);
+    args_len = (unsigned long*) safe_emalloc(tpl->max_arg_count, sizeof(unsigned long), 0);
+
+    /* The commands are the client's: its options convert the replies, its last error is set */
+    previous                       = valkey_glide_delegate(valkey_glide);
+    valkey_glide->is_in_batch_mode = true;
+    valkey_glide->batch_type       = tpl->batch_type;
+    for (size_t i = 0; i < tpl->command_count; i++) {
+        batch_template_append(
+            valkey_glide, tpl, &tpl->commands[i], values, args, args_len, &scratch);
+    }
+    status = valkey_glide_batch_exec(valkey_glide, &batch_opts, return_value);
+    valkey_glide_batch_clear(valkey_glide);
+    valkey_glide_delegate(previous);
+
+    smart_str_free(&scratch);
+    efree(args_len);
+    efree(args);
+    while (count > 0) {
+        zend_string_release(values[--count]);
+    }
+    efree(values);
+
+    if (!status) {
+        zval_ptr_dtor(return_value);
+        RETURN_FALSE;
+    }
+}
+/* }}} */
+
+/* {{{ proto string ValkeyGlideBatchTemplate::param(int $index) */
+PHP_METHOD(ValkeyGlideBatchTemplate, param) {
+    zend_long index;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+    Z_PARAM_LONG(index)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (index < 0 || index > UINT32_MAX) {
+        zend_argument_value_error(1, "must be between 0 and %u", UINT32_MAX);
+        RETURN_THROWS();
+    }
+    RETURN_STR(zend_strpprintf(0, PARAM_PREFIX ZEND_LONG_FMT PARAM_SUFFIX, index));
+}
+/* }}} */
@@ -0,0 +1,85 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Batch Templates                                         |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef VALKEY_GLIDE_BATCH_TEMPLATE_H
+#define VALKEY_GLIDE_BATCH_TEMPLATE_H
+
+#include "common.h"
+#include "php.h"
+
+/*
+ * Batches prepared once and run with parameters, ValkeyGlide::prepareBatch().
+ *
+ * The builder runs the methods on the client in batch mode, so the commands are parsed,
+ * prefixed and serialized as in a pipeline, and are compiled from the batch arena: each
+ * placeholder of ValkeyGlideBatchTemplate::param($n) in an argument is a parameter slot taking
+ * $params[$n]. execute() appends the packed arguments back to the arena of the client with the
+ * parameters copied into their slots, and sends them through the exec() path, so a run costs a
+ * copy per argument and no method call, option or argument conversion.
+ *
+ * A placeholder is only replaced in the arguments sent as they were given, keys and plain
+ * strings. Serializing or compressing a value while a builder runs throws when the value holds
+ * one, as its slot would be lost or would sit in bytes that depend on its length.
+ */
+
+/* A placeholder: the prefix, the index of its parameter in decimal, the suffix */
+#define VALKEY_GLIDE_BATCH_TEMPLATE_PARAM_PREFIX "{?ValkeyGlideParam:"
+#define VALKEY_GLIDE_BATCH_TEMPLATE_PARAM_SUFFIX "?}"
+
+/* An argument of a template, its literal bytes with the parameters taken out */
+typedef struct {
+    size_t   offset; /* In the bytes of the template */
+    size_t   len;
+    uint32_t first_slot;
+    uint32_t slot_count;
+} valkey_glide_batch_template_arg;
+
+/* Where a parameter goes in an argument */
+typedef struct {
+    size_t   pos; /* In the literal bytes of the argument */
+    uint32_t param;
+} valkey_glide_batch_template_slot;
+
+/* ValkeyGlideBatchTemplate object structure */
+typedef struct {
+    zend_object*                      client; /* ValkeyGlide or ValkeyGlideCluster object */
+    int                               batch_type;
+    struct batch_command*             commands; /* first_arg and route_offset index the below */
+    size_t                            command_count;
+    zend_string*                      bytes;
+    valkey_glide_batch_template_arg*  args;
+    valkey_glide_batch_template_slot* slots;
+    uint32_t                          param_count;
+    uint32_t                          max_arg_count; /* Arguments of the longest command */
+    zend_object                       std;
+} valkey_glide_batch_template_object;
+
+/* Class entry */
+extern zend_class_entry* valkey_glide_batch_template_ce;
+
+/* Class registration function */
+void register_valkey_glide_batch_template_class(void);
+
+/* Run the builder on a client in batch mode and compile what it buffered into a
+ * ValkeyGlideBatchTemplate. Throws and leaves return_value untouched on failure. */
+void valkey_glide_batch_template_prepare(zval*                  object,
+                                         zend_fcall_info*       builder,
+                                         zend_fcall_info_cache* builder_cache,
+                                         zend_long              batch_type,
+                                         zval*                  return_value);
+
+/* Whether a value being serialized or compressed while a builder runs holds a placeholder,
+ * a ValueError then thrown */
+bool valkey_glide_batch_template_encoded_param(const char* value, size_t len);
+
+#endif /* VALKEY_GLIDE_BATCH_TEMPLATE_H */
@@ -0,0 +1,59 @@
+<?php
+
+/**
+ * @generate-function-entries
+ * @generate-class-entries
+ */
+
+/**
+ * A batch prepared once by ValkeyGlide::prepareBatch() and run with parameters.
+ *
+ * The commands are parsed, prefixed and serialized when the batch is prepared. The builder
+ * marks where the parameters go with ValkeyGlideBatchTemplate::param($n), in keys and string
+ * arguments, and running the template only copies $params[$n] into those slots before sending
+ * the batch.
+ *
+ * @example
+ * static $feed;
+ * $feed ??= $valkey_glide->prepareBatch(function ($b) {
+ *     $user = ValkeyGlideBatchTemplate::param(0);
+ *     $b->hGetAll("{u:$user}:profile");
+ *     $b->zRange("{u:$user}:feed", 0, 49);
+ * });
+ * [$profile, $items] = $feed->execute([$user_id]);
+ *
+ * @not-serializable
+ */
+final class ValkeyGlideBatchTemplate
+{
+    /**
+     * Run the batch with a set of parameters.
+     *
+     * @param array $params  The parameters, converted to strings, $params[$n] going where
+     *                       param($n) was.
+     * @param array $options Options of this run, as for ValkeyGlide::exec().
+     *
+     * @return array|false The replies of the commands, as exec() returns them, or false on
+     *                     failure.
+     *
+     * @throws ValueError When a parameter is missing.
+     */
+    public function execute(array $params, array $options = []): array|false
+    {
+    }
+
+    /**
+     * The placeholder of a parameter, for a key or a string argument of a command the builder of
+     * ValkeyGlide::prepareBatch() buffers. It can be part of a longer string.
+     *
+     * @param int $index The key of the parameter in the array given to execute().
+     *
+     * @return string The placeholder, replaced by the parameter each time the template runs.
+     *
+     * @throws ValueError When $index is negative. Serializing or compressing a value that
+     *                    holds a placeholder throws a ValueError too.
+     */
+    public static function param(int $index): string
+    {
+    }
+}
@@ -0,0 +1,918 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Client-Side Cache                                       |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#include "valkey_glide_cache.h"
+
+#include <zend_exceptions.h>
+#include <zend_smart_str.h>
+
+#include "command_response.h"
+#include "include/glide_bindings.h"
+#include "logger.h"
+#include "valkey_glide_args.h"
+#include "valkey_glide_commands_common.h"
+#include "valkey_glide_options.h"
+#include "valkey_glide_pubsub.h"
+#include "valkey_glide_shm_cache.h"
+
+/* Entries looked at when choosing an LFU victim, starting from the least recently used */
+#define CACHE_LFU_SAMPLES 8
+
+typedef struct cache_entry {
+    zend_string*        lookup; /* Method and arguments, the key in entries (borrowed) */
+    zend_string*        key;    /* The Valkey key the reply depends on */
+    zval                value;
+    size_t              size;
+    uint32_t            hits;
+    struct cache_entry* prev; /* Recency list, most recent first */
+    struct cache_entry* next;
+    struct cache_entry* key_prev; /* Other entries for the same Valkey key */
+    struct cache_entry* key_next;
+} cache_entry;
+
+struct valkey_glide_cache {
+    HashTable    entries; /* lookup -> cache_entry */
+    HashTable    by_key;  /* Valkey key -> first cache_entry for it */
+    cache_entry* head;
+    cache_entry* tail;
+    size_t       memory;
+    size_t       max_memory;
+    bool         lfu;
+
+    /* Tracking */
+    const void*                glide_client;
+    bool                       is_cluster;
+    bool                       bcast;
+    zend_string**              prefixes;
+    uint32_t                   prefix_count;
+    bool                       tracking; /* Enabled on the current connection */
+    valkey_glide_pubsub_state* pubsub;
+    uint64_t                   seq;       /* Invalidations replayed so far */
+    uint64_t                   shared_ns; /* Shared GET cache namespace, 0 if not used */
+
+    zend_long hits;
+    zend_long misses;
+    zend_long evictions;
+    zend_long invalidations;
+};
+
+/* ====================================================================
+ * CONFIGURATION
+ * ==================================================================== */
+
+valkey_glide_cache_configuration_t* valkey_glide_cache_parse_configuration(zval* value) {
+    valkey_glide_cache_configuration_t* config;
+    zval*                               option;
+
+    if (!value || (Z_TYPE_P(value) != IS_ARRAY && Z_TYPE_P(value) != IS_TRUE)) {
+        return NULL;
+    }
+
+    config             = ecalloc(1, sizeof(valkey_glide_cache_configuration_t));
+    config->max_memory = VALKEY_GLIDE_CACHE_DEFAULT_MAX_MEMORY;
+    if (Z_TYPE_P(value) != IS_ARRAY) {
+        return config;
+    }
+
+    option = zend_hash_str_find(Z_ARRVAL_P(value), "max_memory", 10);
+    if (option && Z_TYPE_P(option) == IS_LONG && Z_LVAL_P(option) > 0) {
+        config->max_memory = Z_LVAL_P(option);
+    }
+
+    option = zend_hash_str_find(Z_ARRVAL_P(value), "eviction", 8);
+    if (option && Z_TYPE_P(option) == IS_STRING) {
+        config->lfu = zend_string_equals_literal_ci(Z_STR_P(option), "lfu");
+    }
+
+    option = zend_hash_str_find(Z_ARRVAL_P(value), "mode", 4);
+    if (option && Z_TYPE_P(option) == IS_STRING) {
+        config->bcast = zend_string_equals_literal_ci(Z_STR_P(option), "bcast");
+    }
+
+    option = zend_hash_str_find(Z_ARRVAL_P(value), "prefixes", 8);
+    if (option && Z_TYPE_P(option) == IS_ARRAY && zend_hash_num_elements(Z_ARRVAL_P(option))) {
+        config->prefixes = Z_ARRVAL_P(option);
+    }
+
+    return config;
+}
+
+/* ====================================================================
+ * ENTRIES
+ * ==================================================================== */
+
+static void cache_entry_dtor(zval* zv) {
+    cache_entry* entry = Z_PTR_P(zv);
+
+    zval_ptr_dtor(&entry->value);
+    zend_string_release(entry->key);
+    efree(entry);
+}
+
+/* Rough heap footprint of a reply, what max_memory is measured in */
+static size_t cache_zval_size(zval* value) {
+    zend_string* key;
+    zval*        element;
+    size_t       size;
+
+    switch (Z_TYPE_P(value)) {
+        case IS_STRING:
+            return _ZSTR_STRUCT_SIZE(Z_STRLEN_P(value));
+        case IS_ARRAY:
+            size = sizeof(HashTable) +
+                   zend_hash_num_elements(Z_ARRVAL_P(value)) * (sizeof(Bucket) + sizeof(uint32_t));
+            ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(value), key, element) {
+                if (key) {
+                    size += _ZSTR_STRUCT_SIZE(ZSTR_LEN(key));
+                }
+                size += cache_zval_size(element);
+            }
+            ZEND_HASH_FOREACH_END();
+            return size;
+        default:
+            return 0;
+    }
+}
+
+static void cache_lru_unlink(valkey_glide_cache* cache, cache_entry* entry) {
+    if (entry->prev) {
+        entry->prev->next = entry->next;
+    } else {
+        cache->head = entry->next;
+    }
+    if (entry->next) {
+        entry->next->prev = entry->prev;
+    } else {
+        cache->tail = entry->prev;
+    }
+    entry->prev = entry->next = NULL;
+}
+
+static void cache_lru_push(valkey_glide_cache* cache, cache_entry* entry) {
+    entry->prev = NULL;
+    entry->next = cache->head;
+    if (cache->head) {
+        cache->head->prev = entry;
+    } else {
+        cache->tail = entry;
+    }
+    cache->head = entry;
+}
+
+/* Drop one entry, keeping the per-key chain consistent */
+static void cache_remove(valkey_glide_cache* cache, cache_entry* entry) {
+    cache_lru_unlink(cache, entry);
+
+    if (entry->key_next) {
+        entry->key_next->key_prev = entry->key_prev;
+    }
+    if (entry->key_prev) {
+        entry->key_prev->key_next = entry->key_next;
+    } else if (entry->key_next) {
+        zend_hash_update_ptr(&cache->by_key, entry->key, entry->key_next);
+    } else {
+        zend_hash_del(&cache->by_key, entry->key);
+    }
+
+    cache->memory -= entry->size;
+    zend_hash_del(&cache->entries, entry->lookup);
+}
+
+static void cache_clear(valkey_glide_cache* cache) {
+    zend_hash_clean(&cache->by_key);
+    zend_hash_clean(&cache->entries);
+    cache->head   = NULL;
+    cache->tail   = NULL;
+    cache->memory = 0;
+}
+
+static void cache_invalidate_key(valkey_glide_cache* cache, const char* key, size_t key_len) {
+    cache_entry* entry = zend_hash_str_find_ptr(&cache->by_key, key, key_len);
+
+    if (!entry) {
+        return;
+    }
+    zend_hash_str_del(&cache->by_key, key, key_len);
+
+    while (entry) {
+        cache_entry* next = entry->key_next;
+
+        cache_lru_unlink(cache, entry);
+        cache->memory -= entry->size;
+        cache->invalidations++;
+        zend_hash_del(&cache->entries, entry->lookup);
+        entry = next;
+    }
+}
+
+static void cache_evict(valkey_glide_cache* cache) {
+    cache_entry* victim = cache->tail;
+
+    if (cache->lfu) {
+        cache_entry* candidate = victim;
+
+        for (int i = 0; candidate && i < CACHE_LFU_SAMPLES; i++, candidate = candidate->prev) {
+            if (candidate->hits < victim->hits) {
+                victim = candidate;
+            }
+        }
+    }
+
+    if (victim) {
+        cache_remove(cache, victim);
+        cache->evictions++;
+    }
+}
+
+static void cache_insert(valkey_glide_cache* cache,
+                         zend_string*        lookup,
+                         zend_string*        key,
+                         zval*               value) {
+    size_t       size = sizeof(cache_entry) + _ZSTR_STRUCT_SIZE(ZSTR_LEN(lookup)) +
+                  _ZSTR_STRUCT_SIZE(ZSTR_LEN(key)) + cache_zval_size(value);
+    cache_entry* entry;
+    cache_entry* first;
+
+    if (size > cache->max_memory) {
+        return;
+    }
+    while (cache->memory + size > cache->max_memory && cache->tail) {
+        cache_evict(cache);
+    }
+
+    entry       = ecalloc(1, sizeof(cache_entry));
+    entry->key  = zend_string_copy(key);
+    entry->size = size;
+    ZVAL_COPY(&entry->value, value);
+
+    /* The table holds a reference to lookup, which outlives the caller's */
+    zend_hash_add_new_ptr(&cache->entries, lookup, entry);
+    entry->lookup = lookup;
+
+    first = zend_hash_find_ptr(&cache->by_key, key);
+    if (first) {
+        first->key_prev = entry;
+        entry->key_next = first;
+        zend_hash_update_ptr(&cache->by_key, key, entry);
+    } else {
+        zend_hash_add_new_ptr(&cache->by_key, key, entry);
+    }
+
+    cache_lru_push(cache, entry);
+    cache->memory += size;
+}
+
+/* ====================================================================
+ * TRACKING
+ * ==================================================================== */
+
+/* CLIENT TRACKING ON [BCAST [PREFIX prefix...]], on every node of a cluster */
+static bool cache_enable_tracking(valkey_glide_cache* cache) {
+    valkey_glide_args args;
+    CommandResult*    result;
+    bool              enabled = false;
+
+    valkey_glide_args_init(&args);
+    valkey_glide_args_add_literal(&args, "CLIENT");
+    valkey_glide_args_add_literal(&args, "TRACKING");
+    valkey_glide_args_add_literal(&args, "ON");
+    if (cache->bcast) {
+        valkey_glide_args_add_literal(&args, "BCAST");
+        for (uint32_t i = 0; i < cache->prefix_count; i++) {
+            valkey_glide_args_add_literal(&args, "PREFIX");
+            valkey_glide_args_add(
+                &args, ZSTR_VAL(cache->prefixes[i]), ZSTR_LEN(cache->prefixes[i]));
+        }
+    }
+
+    if (cache->is_cluster) {
+        zval route;
+
+        ZVAL_STRINGL(&route, "allNodes", 8);
+        result = valkey_glide_args_execute(cache->glide_client, CustomCommand, &args, &route);
+        zval_dtor(&route);
+    } else {
+        result = valkey_glide_args_execute(cache->glide_client, CustomCommand, &args, NULL);
+    }
+    valkey_glide_args_free(&args);
+
+    if (result) {
+        if (result->command_error) {
+            VALKEY_LOG_ERROR("client_side_cache", result->command_error->command_error_message);
+        } else {
+            enabled = true;
+        }
+        free_command_result(result);
+    }
+    return enabled;
+}
+
+static void cache_apply_invalidation(void* ctx, const char* key, size_t key_len, bool reconnect) {
+    valkey_glide_cache* cache = ctx;
+
+    if (reconnect) {
+        cache->tracking = false;
+    }
+    if (!key) {
+        cache->invalidations += zend_hash_num_elements(&cache->entries);
+        cache_clear(cache);
+        if (cache->shared_ns) {
+            valkey_glide_shm_cache_flush();
+        }
+    } else {
+        cache_invalidate_key(cache, key, key_len);
+        if (cache->shared_ns) {
+            valkey_glide_shm_cache_invalidate(cache->shared_ns, key, key_len);
+        }
+    }
+}
+
+/* Apply pending invalidations and make sure tracking is on. Returns false if the cache cannot
+ * be trusted right now. */
+static bool cache_sync(valkey_glide_cache* cache) {
+    if (valkey_glide_pubsub_invalidation_seq(cache->pubsub) != cache->seq) {
+        cache->seq = valkey_glide_pubsub_replay_invalidations(
+            cache->pubsub, cache->seq, cache_apply_invalidation, cache);
+    }
+
+    if (!cache->tracking) {
+        /* Nothing cached before now was tracked on this connection */
+        cache_clear(cache);
+        cache->tracking = cache_enable_tracking(cache);
+    }
+    return cache->tracking;
+}
+
+static bool cache_key_tracked(valkey_glide_cache* cache, zend_string* key) {
+    if (!cache->bcast || cache->prefix_count == 0) {
+        return true;
+    }
+    for (uint32_t i = 0; i < cache->prefix_count; i++) {
+        zend_string* prefix = cache->prefixes[i];
+
+        if (ZSTR_LEN(key) >= ZSTR_LEN(prefix) &&
+            memcmp(ZSTR_VAL(key), ZSTR_VAL(prefix), ZSTR_LEN(prefix)) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+valkey_glide_cache* valkey_glide_cache_create(valkey_glide_object*                valkey_glide,
+                                              valkey_glide_cache_configuration_t* config,
+                                              bool                                is_cluster) {
+    valkey_glide_cache* cache;
+
+    if (!valkey_glide->pubsub || !valkey_glide_pubsub_track_invalidations(valkey_glide->pubsub)) {
+        VALKEY_LOG_WARN("client_side_cache", "Cannot track invalidations, cache disabled");
+        return NULL;
+    }
+
+    cache = ecalloc(1, sizeof(valkey_glide_cache));
+    zend_hash_init(&cache->entries, 64, NULL, cache_entry_dtor, 0);
+    zend_hash_init(&cache->by_key, 64, NULL, NULL, 0);
+    cache->max_memory   = config->max_memory;
+    cache->lfu          = config->lfu;
+    cache->bcast        = config->bcast;
+    cache->glide_client = valkey_glide->glide_client;
+    cache->is_cluster   = is_cluster;
+    cache->pubsub       = valkey_glide->pubsub;
+    cache->seq          = valkey_glide_pubsub_invalidation_seq(cache->pubsub);
+    cache->shared_ns    = valkey_glide->shared_cache_ns;
+
+    if (config->bcast && config->prefixes) {
+        zval* prefix;
+
+        cache->prefixes = ecalloc(zend_hash_num_elements(config->prefixes), sizeof(zend_string*));
+        ZEND_HASH_FOREACH_VAL(config->prefixes, prefix) {
+            cache->prefixes[cache->prefix_count++] = zval_get_string(prefix);
+        }
+        ZEND_HASH_FOREACH_END();
+    }
+
+    return cache;
+}
+
+void valkey_glide_cache_reset(valkey_glide_cache* cache) {
+    if (cache) {
+        cache_clear(cache);
+    }
+}
+
+void valkey_glide_cache_free(valkey_glide_cache* cache) {
+    if (!cache) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < cache->prefix_count; i++) {
+        zend_string_release(cache->prefixes[i]);
+    }
+    if (cache->prefixes) {
+        efree(cache->prefixes);
+    }
+    zend_hash_destroy(&cache->by_key);
+    zend_hash_destroy(&cache->entries);
+    efree(cache);
+}
+
+/* ====================================================================
+ * METHOD INTERCEPTION
+ * ==================================================================== */
+
+/* Read methods whose reply depends only on their first argument, a key */
+static const char* const cache_methods[] = {
+    /* Strings */
+    "get", "strlen", "getrange",
+    /* Hashes */
+    "hget", "hgetall", "hmget", "hexists", "hlen", "hkeys", "hvals", "hstrlen",
+    /* Sets */
+    "smembers", "sismember", "scard",
+    /* Sorted sets */
+    "zrange", "zscore", "zcard", "zrank", "zrevrank", "zcount",
+    /* Lists */
+    "lrange", "llen", "lindex",
+};
+
+#define CACHE_METHOD_COUNT (sizeof(cache_methods) / sizeof(cache_methods[0]))
+
+/* Which arguments of a write method name the keys whose cached replies it changes */
+#define CACHE_WRITE_READ -1      /* Not a write method */
+#define CACHE_WRITE_FIRST 0      /* The first argument */
+#define CACHE_WRITE_TWO 1        /* The first two arguments, a source and a destination */
+#define CACHE_WRITE_ALL 2        /* Every argument, and the values of array arguments */
+#define CACHE_WRITE_ARRAY_KEYS 3 /* The keys of the array of the first argument */
+#define CACHE_WRITE_FLUSH 4      /* Every key */
+
+/* Write methods, whose keys are dropped from the caches when they return */
+static const struct {
+    const char* name;
+    int8_t      keys;
+} cache_write_methods[] = {
+    /* Strings */
+    {"append", CACHE_WRITE_FIRST},
+    {"decr", CACHE_WRITE_FIRST},
+    {"decrby", CACHE_WRITE_FIRST},
+    {"getdel", CACHE_WRITE_FIRST},
+    {"getex", CACHE_WRITE_FIRST},
+    {"getset", CACHE_WRITE_FIRST},
+    {"incr", CACHE_WRITE_FIRST},
+    {"incrby", CACHE_WRITE_FIRST},
+    {"incrbyfloat", CACHE_WRITE_FIRST},
+    {"mset", CACHE_WRITE_ARRAY_KEYS},
+    {"msetnx", CACHE_WRITE_ARRAY_KEYS},
+    {"psetex", CACHE_WRITE_FIRST},
+    {"set", CACHE_WRITE_FIRST},
+    {"setbit", CACHE_WRITE_FIRST},
+    {"setex", CACHE_WRITE_FIRST},
+    {"setnx", CACHE_WRITE_FIRST},
+    {"setrange", CACHE_WRITE_FIRST},
+    /* Keys */
+    {"copy", CACHE_WRITE_TWO},
+    {"del", CACHE_WRITE_ALL},
+    {"flushall", CACHE_WRITE_FLUSH},
+    {"flushdb", CACHE_WRITE_FLUSH},
+    {"move", CACHE_WRITE_FIRST},
+    {"rename", CACHE_WRITE_TWO},
+    {"renamenx", CACHE_WRITE_TWO},
+    {"restore", CACHE_WRITE_FIRST},
+    {"unlink", CACHE_WRITE_ALL},
+    /* Hashes */
+    {"hdel", CACHE_WRITE_FIRST},
+    {"hincrby", CACHE_WRITE_FIRST},
+    {"hincrbyfloat", CACHE_WRITE_FIRST},
+    {"hmset", CACHE_WRITE_FIRST},
+    {"hset", CACHE_WRITE_FIRST},
+    {"hsetnx", CACHE_WRITE_FIRST},
+    /* Sets */
+    {"sadd", CACHE_WRITE_FIRST},
+    {"sdiffstore", CACHE_WRITE_FIRST},
+    {"sinterstore", CACHE_WRITE_FIRST},
+    {"smove", CACHE_WRITE_TWO},
+    {"spop", CACHE_WRITE_FIRST},
+    {"srem", CACHE_WRITE_FIRST},
+    {"sunionstore", CACHE_WRITE_FIRST},
+    /* Sorted sets */
+    {"zadd", CACHE_WRITE_FIRST},
+    {"zdiffstore", CACHE_WRITE_FIRST},
+    {"zincrby", CACHE_WRITE_FIRST},
+    {"zinterstore", CACHE_WRITE_FIRST},
+    {"zpopmax", CACHE_WRITE_FIRST},
+    {"zpopmin", CACHE_WRITE_FIRST},
+    {"zrangestore", CACHE_WRITE_FIRST},
+    {"zrem", CACHE_WRITE_FIRST},
+    {"zremrangebylex", CACHE_WRITE_FIRST},
+    {"zremrangebyrank", CACHE_WRITE_FIRST},
+    {"zremrangebyscore", CACHE_WRITE_FIRST},
+    {"zunionstore", CACHE_WRITE_FIRST},
+    /* Lists */
+    {"linsert", CACHE_WRITE_FIRST},
+    {"lmove", CACHE_WRITE_TWO},
+    {"lpop", CACHE_WRITE_FIRST},
+    {"lpush", CACHE_WRITE_FIRST},
+    {"lpushx", CACHE_WRITE_FIRST},
+    {"lrem", CACHE_WRITE_FIRST},
+    {"lset", CACHE_WRITE_FIRST},
+    {"ltrim", CACHE_WRITE_FIRST},
+    {"rpop", CACHE_WRITE_FIRST},
+    {"rpush", CACHE_WRITE_FIRST},
+    {"rpushx", CACHE_WRITE_FIRST},
+};
+
+#define CACHE_WRITE_METHOD_COUNT (sizeof(cache_write_methods) / sizeof(cache_write_methods[0]))
+
+/* Original handlers of the intercepted methods, for ValkeyGlide and ValkeyGlideCluster */
+typedef struct {
+    zend_function* func;
+    zif_handler    handler;
+    int8_t         write_keys; /* CACHE_WRITE_* */
+} cache_handler_t;
+
+static cache_handler_t cache_handlers[2 * (CACHE_METHOD_COUNT + CACHE_WRITE_METHOD_COUNT)];
+static uint32_t        cache_handler_count = 0;
+
+static cache_handler_t* cache_handler_find(const zend_function* func) {
+    for (uint32_t i = 0; i < cache_handler_count; i++) {
+        if (cache_handlers[i].func == func) {
+            return &cache_handlers[i];
+        }
+    }
+    return NULL;
+}
+
+/* The entry of an intercepted method. A class extending ValkeyGlide runs a copy of the
+ * zend_function, found through the class that declares the method. */
+static cache_handler_t* cache_handler_entry(const zend_function* func) {
+    cache_handler_t* entry = cache_handler_find(func);
+
+    if (!entry && func->common.scope && func->common.function_name) {
+        zend_function* declared = zend_hash_find_ptr_lc(&func->common.scope->function_table,
+                                                         func->common.function_name);
+
+        if (declared && declared != func) {
+            entry = cache_handler_find(declared);
+        }
+    }
+    return entry;
+}
+
+static zif_handler cache_original_handler(const zend_function* func) {
+    cache_handler_t* entry = cache_handler_entry(func);
+
+    return entry ? entry->handler : NULL;
+}
+
+/* Append one argument to the lookup key; false for arguments that cannot be part of it */
+static bool cache_lookup_append(smart_str* lookup, zval* arg, int depth) {
+    zend_string* key;
+    zend_ulong   index;
+    zval*        element;
+
+    ZVAL_DEREF(arg);
+    switch (Z_TYPE_P(arg)) {
+        case IS_NULL:
+        case IS_FALSE:
+        case IS_TRUE:
+            smart_str_appendc(lookup, '0' + Z_TYPE_P(arg));
+            return true;
+        case IS_LONG:
+            smart_str_appendc(lookup, 'l');
+            smart_str_append_long(lookup, Z_LVAL_P(arg));
+            return true;
+        case IS_DOUBLE:
+            smart_str_appendc(lookup, 'd');
+            smart_str_appendl(lookup, (const char*) &Z_DVAL_P(arg), sizeof(double));
+            return true;
+        case IS_STRING:
+            smart_str_appendc(lookup, 's');
+            smart_str_append_long(lookup, (zend_long) Z_STRLEN_P(arg));
+            smart_str_appendc(lookup, ':');
+            smart_str_append(lookup, Z_STR_P(arg));
+            return true;
+        case IS_ARRAY:
+            if (depth > 2) {
+                return false;
+            }
+            smart_str_appendc(lookup, '[');
+            ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(arg), index, key, element) {
+                if (key) {
+                    smart_str_appendc(lookup, 's');
+                    smart_str_append_long(lookup, (zend_long) ZSTR_LEN(key));
+                    smart_str_appendc(lookup, ':');
+                    smart_str_append(lookup, key);
+                } else {
+                    smart_str_appendc(lookup, 'l');
+                    smart_str_append_long(lookup, (zend_long) index);
+                }
+                if (!cache_lookup_append(lookup, element, depth + 1)) {
+                    return false;
+                }
+            }
+            ZEND_HASH_FOREACH_END();
+            smart_str_appendc(lookup, ']');
+            return true;
+        default:
+            return false;
+    }
+}
+
+/* The key as the server knows it, with OPT_PREFIX; invalidations name that key */
+static zend_string* cache_server_key(valkey_glide_object* valkey_glide, zend_string* key) {
+    zend_string* prefix = valkey_glide->options.prefix;
+
+    if (!prefix) {
+        return zend_string_copy(key);
+    }
+    return zend_string_concat2(ZSTR_VAL(prefix), ZSTR_LEN(prefix), ZSTR_VAL(key), ZSTR_LEN(key));
+}
+
+/* GET from the segment shared by the worker processes, then from the server */
+static void cache_shared_handler(INTERNAL_FUNCTION_PARAMETERS) {
+    zif_handler          handler = cache_original_handler(EX(func));
+    valkey_glide_object* valkey_glide;
+    zval*                key;
+    zend_string*         full_key;
+    zend_string*         value;
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, ZEND_THIS);
+
+    key = ZEND_CALL_NUM_ARGS(execute_data) == 1 ? ZEND_CALL_ARG(execute_data, 1) : NULL;
+    /* Workers do not share their serializer and compression settings, only raw values are
+     * shared. The namespace is that of the connection settings, database included, so after
+     * select() the shared entries are of another database. */
+    if (!valkey_glide->shared_cache_ttl || valkey_glide->is_in_batch_mode || !key ||
+        valkey_glide->selected_database != valkey_glide->database ||
+        Z_TYPE_P(key) != IS_STRING ||
+        valkey_glide_options_encode_values(&valkey_glide->options) ||
+        !zend_string_equals_literal(EX(func)->common.function_name, "get")) {
+        handler(INTERNAL_FUNCTION_PARAM_PASSTHRU);
+        return;
+    }
+
+    full_key = cache_server_key(valkey_glide, Z_STR_P(key));
+    value    = valkey_glide_shm_cache_get(
+        valkey_glide->shared_cache_ns, ZSTR_VAL(full_key), ZSTR_LEN(full_key));
+    if (value) {
+        zend_string_release(full_key);
+        RETURN_STR(value);
+    }
+
+    handler(INTERNAL_FUNCTION_PARAM_PASSTHRU);
+
+    if (!EG(exception) && Z_TYPE_P(return_value) == IS_STRING) {
+        valkey_glide_shm_cache_set(valkey_glide->shared_cache_ns,
+                                   ZSTR_VAL(full_key),
+                                   ZSTR_LEN(full_key),
+                                   Z_STRVAL_P(return_value),
+                                   Z_STRLEN_P(return_value),
+                                   valkey_glide->shared_cache_ttl);
+    }
+    zend_string_release(full_key);
+}
+
+static void valkey_glide_cache_handler(INTERNAL_FUNCTION_PARAMETERS) {
+    valkey_glide_object* valkey_glide;
+    valkey_glide_cache*  cache;
+    uint32_t             argc = ZEND_CALL_NUM_ARGS(execute_data);
+    smart_str            lookup = {0};
+    zval*                key;
+    zend_string*         full_key;
+    cache_entry*         entry;
+    uint64_t             seq;
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, ZEND_THIS);
+    cache        = valkey_glide->cache;
+
+    key = argc > 0 ? ZEND_CALL_ARG(execute_data, 1) : NULL;
+    if (!cache || valkey_glide->is_in_batch_mode || !key || Z_TYPE_P(key) != IS_STRING) {
+        cache_shared_handler(INTERNAL_FUNCTION_PARAM_PASSTHRU);
+        return;
+    }
+
+    full_key = cache_server_key(valkey_glide, Z_STR_P(key));
+    if (!cache_key_tracked(cache, full_key) || !cache_sync(cache)) {
+        zend_string_release(full_key);
+        cache_shared_handler(INTERNAL_FUNCTION_PARAM_PASSTHRU);
+        return;
+    }
+
+    smart_str_append(&lookup, EX(func)->common.function_name);
+    for (uint32_t i = 1; i <= argc; i++) {
+        if (!cache_lookup_append(&lookup, ZEND_CALL_ARG(execute_data, i), 0)) {
+            smart_str_free(&lookup);
+            zend_string_release(full_key);
+            cache_shared_handler(INTERNAL_FUNCTION_PARAM_PASSTHRU);
+            return;
+        }
+    }
+    smart_str_0(&lookup);
+
+    entry = zend_hash_find_ptr(&cache->entries, lookup.s);
+    if (entry) {
+        cache->hits++;
+        if (entry->hits < UINT32_MAX) {
+            entry->hits++;
+        }
+        if (cache->head != entry) {
+            cache_lru_unlink(cache, entry);
+            cache_lru_push(cache, entry);
+        }
+        smart_str_free(&lookup);
+        zend_string_release(full_key);
+        RETURN_COPY(&entry->value);
+    }
+
+    cache->misses++;
+    seq = valkey_glide_pubsub_invalidation_seq(cache->pubsub);
+
+    cache_shared_handler(INTERNAL_FUNCTION_PARAM_PASSTHRU);
+
+    /* Only keep replies nothing could have invalidated while they were on the way. False and
+     * null are not cached: they also report errors. */
+    if (!EG(exception) && Z_TYPE_P(return_value) > IS_FALSE &&
+        Z_TYPE_P(return_value) != IS_OBJECT &&
+        valkey_glide_pubsub_invalidation_seq(cache->pubsub) == seq) {
+        cache_insert(cache, lookup.s, full_key, return_value);
+    }
+    smart_str_free(&lookup);
+    zend_string_release(full_key);
+}
+
+/* Drop the cached replies of a key the client wrote */
+static void cache_drop_key(valkey_glide_object* valkey_glide, zend_string* key) {
+    zend_string* full_key = cache_server_key(valkey_glide, key);
+
+    if (valkey_glide->cache) {
+        cache_invalidate_key(valkey_glide->cache, ZSTR_VAL(full_key), ZSTR_LEN(full_key));
+    }
+    if (valkey_glide->shared_cache_ttl) {
+        valkey_glide_shm_cache_invalidate(
+            valkey_glide->shared_cache_ns, ZSTR_VAL(full_key), ZSTR_LEN(full_key));
+    }
+    zend_string_release(full_key);
+}
+
+static void cache_drop_arg(valkey_glide_object* valkey_glide, zval* arg) {
+    zval* element;
+
+    ZVAL_DEREF(arg);
+    if (Z_TYPE_P(arg) == IS_ARRAY) {
+        ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(arg), element) {
+            cache_drop_arg(valkey_glide, element);
+        }
+        ZEND_HASH_FOREACH_END();
+    } else if (Z_TYPE_P(arg) == IS_STRING) {
+        cache_drop_key(valkey_glide, Z_STR_P(arg));
+    } else if (Z_TYPE_P(arg) == IS_LONG) {
+        zend_string* key = zend_long_to_str(Z_LVAL_P(arg));
+
+        cache_drop_key(valkey_glide, key);
+        zend_string_release(key);
+    }
+}
+
+/* Run a write method, then drop the cached replies of its keys. The server invalidates them
+ * too, but its push may only be read after the next call of this client. The keys are dropped
+ * whatever the method returned, a timed out write may still have been applied. */
+static void cache_write_handler(INTERNAL_FUNCTION_PARAMETERS) {
+    const cache_handler_t* entry = cache_handler_entry(EX(func));
+    valkey_glide_object*   valkey_glide;
+    uint32_t               argc = ZEND_CALL_NUM_ARGS(execute_data);
+    uint32_t               count;
+    zend_string*           key;
+    zend_ulong             index;
+    zval*                  arg;
+
+    entry->handler(INTERNAL_FUNCTION_PARAM_PASSTHRU);
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, ZEND_THIS);
+    if (valkey_glide->is_in_batch_mode ||
+        (!valkey_glide->cache && !valkey_glide->shared_cache_ttl)) {
+        return;
+    }
+
+    switch (entry->write_keys) {
+        case CACHE_WRITE_FLUSH:
+            if (valkey_glide->cache) {
+                valkey_glide->cache->invalidations +=
+                    zend_hash_num_elements(&valkey_glide->cache->entries);
+                cache_clear(valkey_glide->cache);
+            }
+            if (valkey_glide->shared_cache_ttl) {
+                valkey_glide_shm_cache_flush();
+            }
+            return;
+        case CACHE_WRITE_ARRAY_KEYS:
+            arg = argc > 0 ? ZEND_CALL_ARG(execute_data, 1) : NULL;
+            if (!arg || Z_TYPE_P(arg) != IS_ARRAY) {
+                return;
+            }
+            ZEND_HASH_FOREACH_KEY(Z_ARRVAL_P(arg), index, key) {
+                if (key) {
+                    cache_drop_key(valkey_glide, key);
+                } else {
+                    key = zend_long_to_str((zend_long) index);
+                    cache_drop_key(valkey_glide, key);
+                    zend_string_release(key);
+                }
+            }
+            ZEND_HASH_FOREACH_END();
+            return;
+        default:
+            count = entry->write_keys == CACHE_WRITE_FIRST ? 1
+                    : entry->write_keys == CACHE_WRITE_TWO ? 2
+                                                           : argc;
+            for (uint32_t i = 1; i <= MIN(count, argc); i++) {
+                cache_drop_arg(valkey_glide, ZEND_CALL_ARG(execute_data, i));
+            }
+            return;
+    }
+}
+
+static void cache_intercept(zend_class_entry* ce,
+                            const char*       name,
+                            zif_handler       handler,
+                            int8_t            write_keys) {
+    zend_function* func = zend_hash_str_find_ptr(&ce->function_table, name, strlen(name));
+
+    if (!func || func->type != ZEND_INTERNAL_FUNCTION ||
+        cache_handler_count == sizeof(cache_handlers) / sizeof(cache_handlers[0])) {
+        return;
+    }
+    cache_handlers[cache_handler_count].func       = func;
+    cache_handlers[cache_handler_count].handler    = func->internal_function.handler;
+    cache_handlers[cache_handler_count].write_keys = write_keys;
+    cache_handler_count++;
+    func->internal_function.handler = handler;
+}
+
+void valkey_glide_cache_install(zend_class_entry* ce) {
+    for (size_t i = 0; i < CACHE_METHOD_COUNT; i++) {
+        cache_intercept(ce, cache_methods[i], valkey_glide_cache_handler, CACHE_WRITE_READ);
+    }
+    for (size_t i = 0; i < CACHE_WRITE_METHOD_COUNT; i++) {
+        cache_intercept(ce,
+                        cache_write_methods[i].name,
+                        cache_write_handler,
+                        cache_write_methods[i].keys);
+    }
+}
+
+/* ====================================================================
+ * STATISTICS
+ * ==================================================================== */
+
+int execute_get_cache_stats_command(zval*             object,
+                                    int               argc,
+                                    zval*             return_value,
+                                    zend_class_entry* ce) {
+    valkey_glide_object* valkey_glide;
+    valkey_glide_cache*  cache;
+
+    if (zend_parse_method_parameters(argc, object, "O", &object, ce) == FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    cache        = valkey_glide->cache;
+    if (!cache && !valkey_glide->shared_cache_ttl) {
+        return 0;
+    }
+
+    array_init_size(return_value, 9);
+    if (valkey_glide->shared_cache_ttl) {
+        zval shared;
+
+        valkey_glide_shm_cache_stats(&shared);
+        add_assoc_long(&shared, "ttl", valkey_glide->shared_cache_ttl);
+        add_assoc_zval(return_value, "shared", &shared);
+    }
+    if (!cache) {
+        return 1;
+    }
+
+    /* Report the state as of now, not as of the last cached call */
+    if (valkey_glide_pubsub_invalidation_seq(cache->pubsub) != cache->seq) {
+        cache->seq = valkey_glide_pubsub_replay_invalidations(
+            cache->pubsub, cache->seq, cache_apply_invalidation, cache);
+    }
+
+    add_assoc_long(return_value, "entries", zend_hash_num_elements(&cache->entries));
+    add_assoc_long(return_value, "memory", (zend_long) cache->memory);
+    add_assoc_long(return_value, "max_memory", (zend_long) cache->max_memory);
+    add_assoc_long(return_value, "hits", cache->hits);
+    add_assoc_long(return_value, "misses", cache->misses);
+    add_assoc_long(return_value, "evictions", cache->evictions);
+    add_assoc_long(return_value, "invalidations", cache->invalidations);
+    add_assoc_string(return_value, "eviction", cache->lfu ? "lfu" : "lru");
+    return 1;
+}
@@ -0,0 +1,73 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Client-Side Cache                                       |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef VALKEY_GLIDE_CACHE_H
+#define VALKEY_GLIDE_CACHE_H
+
+#include "common.h"
+#include "php.h"
+
+/*
+ * Opt-in cache of read command replies (advanced_config['client_side_cache']), kept with the
+ * client object. The server is asked to track the keys read (CLIENT TRACKING, or BCAST for a
+ * set of prefixes) and the invalidation pushes it sends over the RESP3 connection evict the
+ * matching entries before the next lookup. The write methods of the client drop the entries of
+ * their keys when they return, as the push for them may only be read after the next call.
+ *
+ * Cached replies are the zvals built by command_response_to_zval() for the first call; hits
+ * return them by reference count, without a copy. PHP's copy-on-write keeps the cached value
+ * intact if the caller modifies what it got.
+ */
+
+/* Default memory cap when client_side_cache does not set max_memory */
+#define VALKEY_GLIDE_CACHE_DEFAULT_MAX_MEMORY (16 * 1024 * 1024)
+
+typedef struct valkey_glide_cache valkey_glide_cache;
+
+/* Parse advanced_config['client_side_cache']: true, or an array with max_memory, eviction
+ * ('lru' or 'lfu'), mode ('default' or 'bcast') and prefixes. Returns NULL when disabled. */
+valkey_glide_cache_configuration_t* valkey_glide_cache_parse_configuration(zval* value);
+
+/* Create the cache of a connected client. Returns NULL if it cannot track invalidations. */
+valkey_glide_cache* valkey_glide_cache_create(valkey_glide_object*                valkey_glide,
+                                              valkey_glide_cache_configuration_t* config,
+                                              bool                                is_cluster);
+void                valkey_glide_cache_free(valkey_glide_cache* cache);
+
+/* Drop every cached reply, e.g. when setOption() changes how replies are decoded */
+void valkey_glide_cache_reset(valkey_glide_cache* cache);
+
+/* Route the cacheable read methods of a class through the cache, and GET through the shared
+ * cache of valkey_glide_shm_cache.h, called from MINIT */
+void valkey_glide_cache_install(zend_class_entry* ce);
+
+int execute_get_cache_stats_command(zval*             object,
+                                    int               argc,
+                                    zval*             return_value,
+                                    zend_class_entry* ce);
+
+#define GETCACHESTATS_METHOD_IMPL(class_name)                                                  \
+    PHP_METHOD(class_name, getCacheStats) {                                                    \
+        if (execute_get_cache_stats_command(getThis(),                                         \
+                                            ZEND_NUM_ARGS(),                                   \
+                                            return_value,                                      \
+                                            strcmp(#class_name, "ValkeyGlideCluster") == 0     \
+                                                ? get_valkey_glide_cluster_ce()                \
+                                                : get_valkey_glide_ce())) {                    \
+            return;                                                                            \
+        }                                                                                      \
+        zval_dtor(return_value);                                                               \
+        RETURN_FALSE;                                                                          \
+    }
+
+#endif /* VALKEY_GLIDE_CACHE_H */
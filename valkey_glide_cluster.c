@@ -12,11 +12,19 @@
 
 #include "common.h"
 #include "ext/standard/info.h"
+#include "valkey_glide_async.h"
+#include "valkey_glide_batch_template.h"
+#include "valkey_glide_cache.h"
 #include "valkey_glide_commands_common.h"
+#include "valkey_glide_errors.h"
 #include "valkey_glide_geo_common.h"
 #include "valkey_glide_hash_common.h" /* Include hash command framework */
 #include "valkey_glide_list_common.h"
+#include "valkey_glide_options.h"
+#include "valkey_glide_pool.h"
+#include "valkey_glide_pubsub.h"
 #include "valkey_glide_s_common.h"
+#include "valkey_glide_script.h"
 #include "valkey_glide_x_common.h"
 #include "valkey_glide_z_common.h"
 
@@ -39,7 +47,7 @@ PHP_METHOD(ValkeyGlideCluster, __construct) {
     valkey_glide_init_common_constructor_params(&common_params);
     valkey_glide_object* valkey_glide;
 
-    ZEND_PARSE_PARAMETERS_START(1, 11)
+    ZEND_PARSE_PARAMETERS_START(1, 12)
     Z_PARAM_ARRAY(common_params.addresses)
     Z_PARAM_OPTIONAL
     Z_PARAM_BOOL(common_params.use_tls)
@@ -52,6 +60,7 @@ PHP_METHOD(ValkeyGlideCluster, __construct) {
     Z_PARAM_STRING_OR_NULL(common_params.client_az, common_params.client_az_len)
     Z_PARAM_ARRAY_OR_NULL(common_params.advanced_config)
     Z_PARAM_BOOL_OR_NULL(common_params.lazy_connect, common_params.lazy_connect_is_null)
+    Z_PARAM_STRING_OR_NULL(common_params.persistent_id, common_params.persistent_id_len)
     ZEND_PARSE_PARAMETERS_END_EX(RETURN_THROWS());
 
     valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, getThis());
@@ -69,16 +78,8 @@ PHP_METHOD(ValkeyGlideCluster, __construct) {
     valkey_glide_build_client_config_base(&common_params, &client_config.base, true);
 
     /* Issue the connection request. */
-    const ConnectionResponse* conn_resp = create_glide_cluster_client(&client_config);
-
-    if (conn_resp->connection_error_message) {
-        zend_throw_exception(
-            get_valkey_glide_exception_ce(), conn_resp->connection_error_message, 0);
-    } else {
-        valkey_glide->glide_client = conn_resp->conn_ptr;
-    }
-
-    free_connection_response((ConnectionResponse*) conn_resp);
+    valkey_glide_connect(
+        valkey_glide, &client_config.base, 0, client_config.periodic_checks_status, true);
 
     /* Clean up temporary configuration structures */
     valkey_glide_cleanup_client_config(&client_config.base);
@@ -90,6 +91,43 @@ static zend_function_entry valkey_glide_cluster_methods[] = {
  * ValkeyGlideCluster method implementation
  */
 
+/* {{{ proto array ValkeyGlideCluster::getPersistentPoolStats() */
+PHP_METHOD(ValkeyGlideCluster, getPersistentPoolStats) {
+    if (zend_parse_parameters_none() == FAILURE) {
+        RETURN_THROWS();
+    }
+
+    valkey_glide_pool_stats(return_value);
+}
+/* }}} */
+
+/* {{{ proto ValkeyGlideAsync ValkeyGlideCluster::async() */
+PHP_METHOD(ValkeyGlideCluster, async) {
+    if (zend_parse_parameters_none() == FAILURE) {
+        RETURN_THROWS();
+    }
+
+    valkey_glide_async_get_proxy(getThis(), return_value);
+}
+/* }}} */
+
+/* {{{ proto ValkeyGlideBatchTemplate ValkeyGlideCluster::prepareBatch(callable builder
+ *        [, int type]) */
+PHP_METHOD(ValkeyGlideCluster, prepareBatch) {
+    zend_fcall_info       fci;
+    zend_fcall_info_cache fcc;
+    zend_long             type = PIPELINE;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+    Z_PARAM_FUNC(fci, fcc)
+    Z_PARAM_OPTIONAL
+    Z_PARAM_LONG(type)
+    ZEND_PARSE_PARAMETERS_END();
+
+    valkey_glide_batch_template_prepare(getThis(), &fci, &fcc, type, return_value);
+}
+/* }}} */
+
 /* {{{ proto bool ValkeyGlideCluster::close() */
 PHP_METHOD(ValkeyGlideCluster, close) {
     RETURN_TRUE;
@@ -634,23 +672,19 @@ PHP_METHOD(ValkeyGlideCluster, punsubscribe) {
 /* }}} */
 
 /* {{{ proto mixed ValkeyGlideCluster::eval(string script, [array args, int numkeys) */
-PHP_METHOD(ValkeyGlideCluster, eval) {
-}
+EVAL_METHOD_IMPL(ValkeyGlideCluster)
 /* }}} */
 
 /* {{{ proto mixed ValkeyGlideCluster::eval_ro(string script, [array args, int numkeys) */
-PHP_METHOD(ValkeyGlideCluster, eval_ro) {
-}
+EVAL_RO_METHOD_IMPL(ValkeyGlideCluster)
 /* }}} */
 
 /* {{{ proto mixed ValkeyGlideCluster::evalsha(string sha, [array args, int numkeys]) */
-PHP_METHOD(ValkeyGlideCluster, evalsha) {
-}
+EVALSHA_METHOD_IMPL(ValkeyGlideCluster)
 /* }}} */
 
 /* {{{ proto mixed ValkeyGlideCluster::evalsha_ro(string sha, [array args, int numkeys]) */
-PHP_METHOD(ValkeyGlideCluster, evalsha_ro) {
-}
+EVALSHA_RO_METHOD_IMPL(ValkeyGlideCluster)
 
 /* }}} */
 /* Commands that do not interact with ValkeyGlide, but just report stuff about
@@ -669,9 +703,12 @@ WATCH_METHOD_IMPL(ValkeyGlideCluster)
 /* {{{ proto bool ValkeyGlideCluster::unwatch() */
 UNWATCH_METHOD_IMPL(ValkeyGlideCluster)
 
-/* {{{ proto array ValkeyGlideCluster::exec() */
+/* {{{ proto array ValkeyGlideCluster::exec([array options]) */
 EXEC_METHOD_IMPL(ValkeyGlideCluster)
 
+/* {{{ proto ValkeyGlideCluster ValkeyGlideCluster::pipeline([array options]) */
+PIPELINE_METHOD_IMPL(ValkeyGlideCluster)
+
 /* {{{ proto bool ValkeyGlideCluster::discard() */
 DISCARD_METHOD_IMPL(ValkeyGlideCluster)
 
@@ -732,8 +769,7 @@ PHP_METHOD(ValkeyGlideCluster, pubsub) {
 
 /* {{{ proto mixed ValkeyGlideCluster::script(string key, ...)
  *     proto mixed ValkeyGlideCluster::script(array host_port, ...) */
-PHP_METHOD(ValkeyGlideCluster, script) {
-}
+SCRIPT_METHOD_IMPL(ValkeyGlideCluster)
 /* }}} */
 
 /* {{{ proto array ValkeyGlideCluster::geohash(string key, string mem1, [string mem2...]) */
@@ -819,5 +855,41 @@ RAWCOMMAND_METHOD_IMPL(ValkeyGlideCluster)
 
 
 COPY_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto bool ValkeyGlideCluster::ssubscribe(array channels) */
+SSUBSCRIBE_METHOD_IMPL(ValkeyGlideCluster)
+/* }}} */
+
+/* {{{ proto bool ValkeyGlideCluster::sunsubscribe([array channels]) */
+SUNSUBSCRIBE_METHOD_IMPL(ValkeyGlideCluster)
+/* }}} */
+
+/* {{{ proto long ValkeyGlideCluster::spublish(string channel, string message) */
+SPUBLISH_METHOD_IMPL(ValkeyGlideCluster)
+/* }}} */
+
+/* {{{ proto array ValkeyGlideCluster::getMessages([long max, double timeout]) */
+GETMESSAGES_METHOD_IMPL(ValkeyGlideCluster)
+/* }}} */
+
+/* {{{ proto array ValkeyGlideCluster::getCacheStats() */
+GETCACHESTATS_METHOD_IMPL(ValkeyGlideCluster)
+/* }}} */
+
+/* {{{ proto bool ValkeyGlideCluster::setOption(long option, mixed value) */
+SETOPTION_METHOD_IMPL(ValkeyGlideCluster)
+/* }}} */
+
+/* {{{ proto mixed ValkeyGlideCluster::getOption(long option) */
+GETOPTION_METHOD_IMPL(ValkeyGlideCluster)
+/* }}} */
+
+/* {{{ proto string|null ValkeyGlideCluster::getLastError() */
+GETLASTERROR_METHOD_IMPL(ValkeyGlideCluster)
+/* }}} */
+
+/* {{{ proto bool ValkeyGlideCluster::clearLastError() */
+CLEARLASTERROR_METHOD_IMPL(ValkeyGlideCluster)
+/* }}} */
 #endif /* PHP_REDIS_CLUSTER_C */
 /* vim: set tabstop=4 softtabstop=4 expandtab shiftwidth=4: */
@@ -107,9 +107,23 @@ class ValkeyGlideCluster
      * @param int|null $periodic_checks         Periodic checks configuration.
      * @param string|null $client_az            Client availability zone.
      * @param array|null $advanced_config       Advanced configuration ['connection_timeout' => 5000,
-     *                                          'tls_config' => ['use_insecure_tls' => false]].
+     *                                          'tls_config' => ['use_insecure_tls' => false],
+     *                                          'inflight_requests_limit' => 1000,
+     *                                          'pubsub_subscriptions' => ['channels' => [...],
+     *                                          'patterns' => [...], 'sharded' => [...]],
+     *                                          'pubsub_buffer_size' => 4096,
+     *                                          'client_side_cache' => ['max_memory' => 16777216,
+     *                                          'eviction' => 'lru'|'lfu', 'mode' => 'default'|'bcast',
+     *                                          'prefixes' => [...]],
+     *                                          'shared_cache' => true|1000].
      *                                           connection_timeout is in milliseconds.
      * @param bool|null $lazy_connect           Whether to use lazy connection.
+     * @param string|null $persistent_id        When set, the underlying connection is kept open in a
+     *                                          process-wide pool and reused by later requests served by
+     *                                          the same worker that pass the same persistent_id and
+     *                                          an identical configuration. A connection is used by one
+     *                                          client at a time and is reset (database, WATCH,
+     *                                          subscriptions) before it is reused.
      */
     public function __construct(
         array $addresses,
@@ -122,9 +136,31 @@ class ValkeyGlideCluster
         ?int $periodic_checks = ValkeyGlideCluster::PERIODIC_CHECK_ENABLED_DEFAULT_CONFIGS,
         ?string $client_az = null,
         ?array $advanced_config = null,
-        ?bool $lazy_connect = null
+        ?bool $lazy_connect = null,
+        ?string $persistent_id = null
     );
 
+    /**
+     * Return the persistent client pool counters for this process.
+     *
+     * The pool is shared by ValkeyGlide and ValkeyGlideCluster.
+     *
+     * @return array ['hits' => int, 'misses' => int, 'connections' => int]
+     */
+    public static function getPersistentPoolStats(): array;
+
+    /**
+     * Return a proxy that sends commands without waiting for their replies.
+     *
+     * The first call opens a second connection with the same configuration. Each call on the
+     * proxy returns a ValkeyGlideFuture, so many commands can be in flight at once. At most
+     * advanced_config['inflight_requests_limit'] requests (1000 by default) are outstanding;
+     * beyond that, sending blocks until a reply arrives.
+     *
+     * @return ValkeyGlideAsync The async command proxy.
+     */
+    public function async(): ValkeyGlideAsync;
+
 
 
     /**
@@ -238,6 +274,7 @@ class ValkeyGlideCluster
      *                             - array ['type' => 'primarySlotKey', 'key' => 'keyName'] for slot key routing
      *                             - array ['type' => 'routeByAddress', 'host' => 'hostname', 'port' => port]
      *                               for specific node routing
+     *                             - a ValkeyGlideRoute built once from any of the above
      * @see ValkeyGlide::dbsize()
      */
     public function dbSize(mixed $route): ValkeyGlideCluster|int;
@@ -266,7 +303,7 @@ class ValkeyGlideCluster
     /**
      * @see ValkeyGlide::discard
      */
-    /* TODO public function discard(): bool; */
+    public function discard(): bool;
 
     /**
      * @see ValkeyGlide::dump
@@ -281,27 +318,38 @@ class ValkeyGlideCluster
     /**
      * @see ValkeyGlide::eval
      */
-   /* TODO public function eval(string $script, array $args = [], int $num_keys = 0): mixed; */
+    public function eval(string $script, array $args = [], int $num_keys = 0): mixed;
 
     /**
      * @see ValkeyGlide::eval_ro
      */
-    /* TODOpublic function eval_ro(string $script, array $args = [], int $num_keys = 0): mixed; */
+    public function eval_ro(string $script, array $args = [], int $num_keys = 0): mixed;
 
     /**
      * @see ValkeyGlide::evalsha
      */
-   /* TODO public function evalsha(string $script_sha, array $args = [], int $num_keys = 0): mixed;*/
+    public function evalsha(string $script_sha, array $args = [], int $num_keys = 0): mixed;
 
     /**
      * @see ValkeyGlide::evalsha_ro
      */
-    /* TODOpublic function evalsha_ro(string $script_sha, array $args = [], int $num_keys = 0): mixed;*/
+    public function evalsha_ro(string $script_sha, array $args = [], int $num_keys = 0): mixed;
 
     /**
+     * In a pipeline, the commands given a route of their own are sent on the async connection of
+     * the client (see async()), in flight while the other commands run. They are not part of the
+     * batch the core sends, which makes these differences:
+     *  - the timeout is their deadline too, a routed command still pending then fails with a
+     *    timeout error;
+     *  - retry_server_error and retry_connection_error send a routed command that failed again,
+     *    once, where the core retries the other commands itself;
+     *  - their order relative to the other commands sent to the same node is not kept.
+     * Unless raise_on_error is set, a routed command that fails is false in the replies like any
+     * other, its error kept for getLastError().
+     *
      * @see ValkeyGlide::exec()
      */
-    /* TODOpublic function exec(): array|false;*/
+    public function exec(array $options = []): array|false;
 
     /**
      * @see ValkeyGlide::exists
@@ -525,6 +573,7 @@ class ValkeyGlideCluster
      *                             - array ['type' => 'primarySlotKey', 'key' => 'keyName'] for slot key routing
      *                             - array ['type' => 'routeByAddress', 'host' => 'hostname', 'port' => port]
      *                               for specific node routing
+     *                             - a ValkeyGlideRoute built once from any of the above
      * @param string $sections     Optional section(s) you wish ValkeyGlide server to return.
      *
      * @return ValkeyGlideCluster|array|false
@@ -602,10 +651,10 @@ class ValkeyGlideCluster
      */
     public function msetnx(array $key_values): ValkeyGlideCluster|array|false;
 
-    /* We only support ValkeyGlide::MULTI in ValkeyGlideCluster but take the argument
-       so we can test MULTI..EXEC with ValkeyGlideTest.php and in the event
-       we add pipeline support in the future. */
-    /* TODO public function multi(int $value = ValkeyGlide::MULTI): ValkeyGlideCluster|bool; */
+    /**
+     * @see ValkeyGlide::multi()
+     */
+    public function multi(int $value = ValkeyGlide::MULTI): ValkeyGlideCluster|bool;
 
     /**
      * @see ValkeyGlide::object
@@ -657,6 +706,7 @@ class ValkeyGlideCluster
      *                             - array ['type' => 'primarySlotKey', 'key' => 'keyName'] for slot key routing
      *                             - array ['type' => 'routeByAddress', 'host' => 'hostname', 'port' => port]
      *                               for specific node routing
+     *                             - a ValkeyGlideRoute built once from any of the above
      *
      * @param string       $message        An optional message to send.
      *
@@ -665,6 +715,16 @@ class ValkeyGlideCluster
      */
     public function ping(mixed $route, ?string $message = null): mixed;
 
+    /**
+     * @see ValkeyGlide::pipeline()
+     */
+    public function pipeline(array $options = []): ValkeyGlideCluster|bool;
+
+    /**
+     * @see ValkeyGlide::prepareBatch()
+     */
+    public function prepareBatch(callable $builder, int $type = ValkeyGlide::PIPELINE): ValkeyGlideBatchTemplate;
+
     /**
      * @see ValkeyGlide::psetex
      */
@@ -857,6 +917,91 @@ class ValkeyGlideCluster
      */
     public function sscan(string $key, null|string &$iterator, ?string $pattern = null, int $count = 0): array|false;
 
+    /**
+     * Subscribe to one or more shard channels.
+     *
+     * Channels are grouped by hash slot and each group is subscribed on the shard owning it.
+     * When a slot migrates, the server drops its subscriptions; they are subscribed again on
+     * the new owner the next time getMessages() is called.
+     *
+     * @param array $channels One or more channel names.
+     *
+     * @return bool True on success, false on failure.
+     *
+     * @see https://valkey.io/commands/ssubscribe
+     * @see ValkeyGlideCluster::getMessages()
+     */
+    public function ssubscribe(array $channels): bool;
+
+    /**
+     * Publish a message to a shard channel.
+     *
+     * The message is sent to the shard owning the channel's slot and only propagated within
+     * that shard, instead of being broadcast over the cluster bus like PUBLISH.
+     *
+     * @see https://valkey.io/commands/spublish
+     *
+     * @param string $channel The shard channel to publish to.
+     * @param string $message The message itself.
+     *
+     * @return ValkeyGlideCluster|int|false The number of clients that received the message.
+     */
+    public function spublish(string $channel, string $message): ValkeyGlideCluster|int|false;
+
+    /**
+     * Unsubscribe from the given shard channels, or from all of them if none is given.
+     *
+     * @param array $channels One or more channels to unsubscribe from.
+     *
+     * @return bool True on success, false on failure.
+     *
+     * @see https://valkey.io/commands/sunsubscribe
+     */
+    public function sunsubscribe(array $channels = []): bool;
+
+    /**
+     * Read the Pub/Sub messages buffered since the last call.
+     *
+     * Messages from every shard are merged into one buffer. Shard messages carry the hash
+     * slot of their channel, which identifies the shard they came from.
+     *
+     * @param int   $max     The maximum number of messages to return.
+     * @param float $timeout Seconds to wait for a message when none is buffered, 0 to return
+     *                       immediately.
+     *
+     * @return array|false A list of ['kind' => 'message'|'pmessage'|'smessage',
+     *                     'channel' => ..., 'message' => ...] entries, with an additional
+     *                     'slot' for smessage and 'pattern' for pmessage. False on failure.
+     *
+     * @see ValkeyGlide::getMessages()
+     */
+    public function getMessages(int $max = 100, float $timeout = 0): array|false;
+
+    /**
+     * @see ValkeyGlide::getCacheStats()
+     */
+    public function getCacheStats(): array|false;
+
+    /**
+     * @see ValkeyGlide::setOption()
+     */
+    public function setOption(int $option, mixed $value): bool;
+
+    /**
+     * @see ValkeyGlide::getOption()
+     */
+    public function getOption(int $option): mixed;
+
+    /**
+     * @see ValkeyGlide::getLastError()
+     */
+    public function getLastError(): ?string;
+
+    /**
+     * @see ValkeyGlide::clearLastError()
+     */
+    public function clearLastError(): bool;
+
     /**
      * @see ValkeyGlide::strlen
      */
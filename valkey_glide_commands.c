@@ -19,6 +19,7 @@
 
 #include "command_response.h"
 #include "include/glide_bindings.h"
+#include "valkey_glide_cache.h"
 #include "valkey_glide_commands_common.h"
 #include "valkey_glide_core_common.h"
 
@@ -304,6 +305,7 @@ int execute_watch_command(zval* object, int argc, zval* return_value, zend_class
     args.arg_count                    = 1;
 
     if (execute_core_command(&args, NULL, process_core_bool_result)) {
+        valkey_glide->watching = true;
         ZVAL_TRUE(return_value);
         return 1;
     } else {
@@ -333,6 +335,7 @@ int execute_unwatch_command(zval* object, int argc, zval* return_value, zend_cla
     args.cmd_type            = UnWatch;
 
     if (execute_core_command(&args, NULL, process_core_bool_result)) {
+        valkey_glide->watching = false;
         ZVAL_TRUE(return_value);
         return 1;
     } else {
@@ -675,6 +678,11 @@ int execute_select_command(zval* object, int argc, zval* return_value, zend_clas
 
     /* Execute the SELECT command using the Glide client */
     if (execute_select_command_internal(valkey_glide->glide_client, dbindex)) {
+        /* Cached replies are keyed by name only, they were read from the previous database */
+        if (dbindex != valkey_glide->selected_database) {
+            valkey_glide_cache_reset(valkey_glide->cache);
+        }
+        valkey_glide->selected_database = dbindex;
         ZVAL_TRUE(return_value);
         return 1;
     }
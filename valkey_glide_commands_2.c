@@ -18,6 +18,7 @@
 #include "php.h"
 #include "valkey_glide_commands_common.h"
 #include "valkey_glide_core_common.h"
+#include "valkey_glide_options.h"
 
 #if PHP_VERSION_ID < 80400
 #include <ext/standard/php_random.h>
@@ -121,8 +122,6 @@ int execute_getdel_command(zval* object, int argc, zval* return_value, zend_clas
     valkey_glide_object* valkey_glide;
     char*                key = NULL;
     size_t               key_len;
-    char*                response     = NULL;
-    size_t               response_len = 0;
 
     /* Parse parameters */
     if (zend_parse_method_parameters(argc, object, "Os", &object, ce, &key, &key_len) == FAILURE) {
@@ -142,19 +141,12 @@ int execute_getdel_command(zval* object, int argc, zval* return_value, zend_clas
     args.key                 = key;
     args.key_len             = key_len;
 
-    /* Use string result processor */
-    struct {
-        char**  result;
-        size_t* result_len;
-    } output = {&response, &response_len};
-
-    int result = execute_core_command(&args, &output, process_core_string_result);
+    /* Use value result processor */
+    int result = execute_core_command(&args, return_value, process_core_value_result);
 
     /* Process the result */
-    if (result == 1 && response != NULL) {
+    if (result == 1) {
         /* Return the value */
-        ZVAL_STRINGL(return_value, response, response_len);
-        efree(response);
         return 1;
     } else if (result == 0) {
         /* Key didn't exist */
@@ -171,9 +163,7 @@ int execute_getex_command(zval* object, int argc, zval* return_value, zend_class
     valkey_glide_object* valkey_glide;
     char*                key = NULL;
     size_t               key_len;
-    zval*                opts         = NULL;
-    char*                response     = NULL;
-    size_t               response_len = 0;
+    zval*                opts = NULL;
 
     /* Parse parameters */
     if (zend_parse_method_parameters(argc, object, "Os|a", &object, ce, &key, &key_len, &opts) ==
@@ -200,19 +190,12 @@ int execute_getex_command(zval* object, int argc, zval* return_value, zend_class
         parse_core_options(opts, &args.options);
     }
 
-    /* Use string result processor */
-    struct {
-        char**  result;
-        size_t* result_len;
-    } output = {&response, &response_len};
-
-    int result = execute_core_command(&args, &output, process_core_string_result);
+    /* Use value result processor */
+    int result = execute_core_command(&args, return_value, process_core_value_result);
 
     /* Process the result */
-    if (result == 1 && response != NULL) {
+    if (result == 1) {
         /* Return the value */
-        ZVAL_STRINGL(return_value, response, response_len);
-        efree(response);
         return 1;
     } else if (result == 0) {
         /* Key didn't exist */
@@ -502,8 +485,6 @@ int execute_mget_command(zval* object, int argc, zval* return_value, zend_class_
     }
 
     /* Execute the MGET command using the Glide client */
-    array_init(return_value);
-
     core_command_args_t args = {0};
     args.glide_client        = valkey_glide->glide_client;
     args.cmd_type            = MGet;
@@ -514,7 +495,7 @@ int execute_mget_command(zval* object, int argc, zval* return_value, zend_class_
     args.args[0].data.array_arg.count = zend_hash_num_elements(Z_ARRVAL_P(z_array));
     args.arg_count                    = 1;
 
-    if (execute_core_command(&args, return_value, process_core_array_result)) {
+    if (execute_core_command(&args, return_value, process_core_value_array_result)) {
         /* Command succeeded, return_value is already set */
         return 1;
     } else {
@@ -16,32 +16,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <zend_exceptions.h>
 
 #include "command_response.h"
 #include "include/glide_bindings.h"
+#include "valkey_glide_args.h"
+#include "valkey_glide_batch.h"
 #include "valkey_glide_commands_common.h"
 #include "valkey_glide_core_common.h"
-
-/* Helper functions for batch state management */
-static void clear_batch_state(valkey_glide_object* valkey_glide);
-static int  buffer_command_for_batch(valkey_glide_object* valkey_glide,
-                                     enum RequestType     cmd_type,
-                                     uint8_t**            args,
-                                     uintptr_t*           arg_lengths,
-                                     uintptr_t            arg_count,
-                                     const char*          key,
-                                     size_t               key_len);
-static void expand_command_buffer(valkey_glide_object* valkey_glide);
-int         buffer_current_command_generic(valkey_glide_object* valkey_glide,
-                                           enum RequestType     request_type,
-                                           int                  argc,
-                                           zval*                this_ptr);
-
-/* Helper function to process array arguments for FCALL commands */
-static void process_array_to_args(zval*          array,
-                                  uintptr_t*     cmd_args,
-                                  unsigned long* args_len,
-                                  unsigned long* arg_index);
+#include "valkey_glide_errors.h"
+#include "valkey_glide_options.h"
 
 /* Execute a WAIT command using the Valkey Glide client - MIGRATED TO CORE FRAMEWORK */
 int execute_wait_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
@@ -85,256 +69,6 @@ int execute_wait_command(zval* object, int argc, zval* return_value, zend_class_
     return 0;
 }
 
-/* Helper function implementations */
-
-/* Clear batch state and free buffered commands */
-static void clear_batch_state(valkey_glide_object* valkey_glide) {
-    if (!valkey_glide) {
-        return;
-    }
-
-    valkey_glide->is_in_batch_mode = false;
-    valkey_glide->batch_type       = MULTI;
-    valkey_glide->command_count    = 0;
-
-    if (valkey_glide->buffered_commands) {
-        /* Free each buffered command */
-        size_t i, j;
-        for (i = 0; i < valkey_glide->command_count; i++) {
-            struct batch_command* cmd = &valkey_glide->buffered_commands[i];
-
-            /* Free argument arrays */
-            if (cmd->args) {
-                for (j = 0; j < cmd->arg_count; j++) {
-                    if (cmd->args[j]) {
-                        efree(cmd->args[j]);
-                    }
-                }
-                efree(cmd->args);
-            }
-
-            if (cmd->arg_lengths) {
-                efree(cmd->arg_lengths);
-            }
-
-            if (cmd->key) {
-                efree(cmd->key);
-            }
-
-            if (cmd->route_info) {
-                efree(cmd->route_info);
-            }
-        }
-
-        efree(valkey_glide->buffered_commands);
-        valkey_glide->buffered_commands = NULL;
-        valkey_glide->command_capacity  = 0;
-    }
-}
-
-/* Expand command buffer capacity */
-static void expand_command_buffer(valkey_glide_object* valkey_glide) {
-    if (!valkey_glide) {
-        return;
-    }
-
-    size_t new_capacity = valkey_glide->command_capacity * 2;
-    if (new_capacity == 0) {
-        new_capacity = 16;
-    }
-
-    struct batch_command* new_buffer = (struct batch_command*) erealloc(
-        valkey_glide->buffered_commands, new_capacity * sizeof(struct batch_command));
-
-    if (new_buffer) {
-        valkey_glide->buffered_commands = new_buffer;
-        valkey_glide->command_capacity  = new_capacity;
-
-        /* Initialize new slots */
-        size_t i;
-        for (i = valkey_glide->command_count; i < new_capacity; i++) {
-            memset(&valkey_glide->buffered_commands[i], 0, sizeof(struct batch_command));
-        }
-    }
-}
-
-/* Buffer a command for batch execution */
-static int buffer_command_for_batch(valkey_glide_object* valkey_glide,
-                                    enum RequestType     cmd_type,
-                                    uint8_t**            args,
-                                    uintptr_t*           arg_lengths,
-                                    uintptr_t            arg_count,
-                                    const char*          key,
-                                    size_t               key_len) {
-    if (!valkey_glide || !valkey_glide->is_in_batch_mode) {
-        return 0;
-    }
-
-    /* Expand buffer if needed */
-    if (valkey_glide->command_count >= valkey_glide->command_capacity) {
-        expand_command_buffer(valkey_glide);
-        if (valkey_glide->command_count >= valkey_glide->command_capacity) {
-            return 0; /* Failed to expand */
-        }
-    }
-
-    struct batch_command* cmd = &valkey_glide->buffered_commands[valkey_glide->command_count];
-
-    /* Store command details */
-    cmd->request_type = cmd_type;
-    cmd->arg_count    = arg_count;
-
-    /* Copy arguments */
-    if (arg_count > 0 && args && arg_lengths) {
-        cmd->args        = (uint8_t**) emalloc(arg_count * sizeof(uint8_t*));
-        cmd->arg_lengths = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-
-        if (!cmd->args || !cmd->arg_lengths) {
-            if (cmd->args)
-                efree(cmd->args);
-            if (cmd->arg_lengths)
-                efree(cmd->arg_lengths);
-            return 0;
-        }
-
-        uintptr_t i;
-        for (i = 0; i < arg_count; i++) {
-            if (args[i] && arg_lengths[i] > 0) {
-                cmd->args[i] = (uint8_t*) emalloc(arg_lengths[i] + 1);
-                if (cmd->args[i]) {
-                    memcpy(cmd->args[i], args[i], arg_lengths[i]);
-                    cmd->args[i][arg_lengths[i]] = '\0';
-                    cmd->arg_lengths[i]          = arg_lengths[i];
-                } else {
-                    cmd->arg_lengths[i] = 0;
-                }
-            } else {
-                cmd->args[i]        = NULL;
-                cmd->arg_lengths[i] = 0;
-            }
-        }
-    } else {
-        cmd->args        = NULL;
-        cmd->arg_lengths = NULL;
-    }
-
-    /* Copy key if provided */
-    if (key && key_len > 0) {
-        cmd->key = (char*) emalloc(key_len + 1);
-        if (cmd->key) {
-            memcpy(cmd->key, key, key_len);
-            cmd->key[key_len] = '\0';
-            cmd->key_len      = key_len;
-        } else {
-            cmd->key_len = 0;
-        }
-    } else {
-        cmd->key     = NULL;
-        cmd->key_len = 0;
-    }
-
-    cmd->route_info = NULL; /* TODO: Handle routing info if needed */
-
-    valkey_glide->command_count++;
-    return 1;
-}
-
-/* Generic command buffering function for batch execution */
-int buffer_current_command_generic(valkey_glide_object* valkey_glide,
-                                   enum RequestType     request_type,
-                                   int                  argc,
-                                   zval*                this_ptr) {
-    (void) this_ptr; /* Unused parameter */
-
-    if (!valkey_glide || !valkey_glide->is_in_batch_mode) {
-        return 0;
-    }
-
-    /* Use modern parameter parsing API */
-    zval* args      = NULL;
-    int   arg_count = 0;
-
-    /* Parse all arguments using variadic syntax */
-    if (zend_parse_parameters(argc, "*", &args, &arg_count) == FAILURE) {
-        return 0;
-    }
-
-    /* Convert PHP zvals to FFI-compatible format */
-    uint8_t**  cmd_args    = NULL;
-    uintptr_t* arg_lengths = NULL;
-
-    if (arg_count > 0 && args) {
-        cmd_args    = (uint8_t**) emalloc(arg_count * sizeof(uint8_t*));
-        arg_lengths = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-
-        if (!cmd_args || !arg_lengths) {
-            if (cmd_args)
-                efree(cmd_args);
-            if (arg_lengths)
-                efree(arg_lengths);
-            return 0;
-        }
-
-        int i;
-        for (i = 0; i < arg_count; i++) {
-            /* Convert each argument to string */
-            zval temp_zval;
-            ZVAL_COPY(&temp_zval, &args[i]);
-            convert_to_string(&temp_zval);
-
-            /* Allocate and copy the string data immediately */
-            size_t str_len = Z_STRLEN(temp_zval);
-            cmd_args[i]    = (uint8_t*) emalloc(str_len + 1);
-            if (cmd_args[i]) {
-                memcpy(cmd_args[i], Z_STRVAL(temp_zval), str_len);
-                cmd_args[i][str_len] = '\0';
-                arg_lengths[i]       = str_len;
-            } else {
-                arg_lengths[i] = 0;
-            }
-
-            zval_dtor(&temp_zval);
-        }
-    }
-
-    /* Buffer the command */
-    int result = buffer_command_for_batch(
-        valkey_glide, request_type, cmd_args, arg_lengths, arg_count, NULL, 0);
-
-    /* Cleanup */
-    if (cmd_args)
-        efree(cmd_args);
-    if (arg_lengths)
-        efree(arg_lengths);
-
-    return result;
-}
-
-/* Helper function to process array arguments for FCALL commands */
-static void process_array_to_args(zval*          array,
-                                  uintptr_t*     cmd_args,
-                                  unsigned long* args_len,
-                                  unsigned long* arg_index) {
-    if (array && Z_TYPE_P(array) == IS_ARRAY) {
-        zval* val;
-        ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(array), val) {
-            if (Z_TYPE_P(val) != IS_STRING) {
-                zval temp;
-                ZVAL_COPY(&temp, val);
-                convert_to_string(&temp);
-                cmd_args[*arg_index] = (uintptr_t) Z_STRVAL(temp);
-                args_len[*arg_index] = Z_STRLEN(temp);
-                zval_dtor(&temp);
-            } else {
-                cmd_args[*arg_index] = (uintptr_t) Z_STRVAL_P(val);
-                args_len[*arg_index] = Z_STRLEN_P(val);
-            }
-            (*arg_index)++;
-        }
-        ZEND_HASH_FOREACH_END();
-    }
-}
-
 /* Execute a FUNCTION command using the Valkey Glide client */
 int execute_function_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
     valkey_glide_object* valkey_glide;
@@ -357,79 +91,18 @@ int execute_function_command(zval* object, int argc, zval* return_value, zend_cl
             return 0;
         }
 
-        /* Prepare command arguments */
-        unsigned long  arg_count = args_count;
-        uintptr_t*     cmd_args  = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-        unsigned long* args_len  = (unsigned long*) emalloc(arg_count * sizeof(unsigned long));
-
-        if (!cmd_args || !args_len) {
-            if (cmd_args)
-                efree(cmd_args);
-            if (args_len)
-                efree(args_len);
-            return 0;
-        }
-
-        /* Convert arguments to strings if needed */
-        int i;
-        for (i = 0; i < args_count; i++) {
-            zval* arg = &z_args[i];
-
-            /* If not string, convert to one */
-            if (Z_TYPE_P(arg) != IS_STRING) {
-                zval temp;
-                ZVAL_COPY(&temp, arg);
-                convert_to_string(&temp);
-                cmd_args[i] = (uintptr_t) Z_STRVAL(temp);
-                args_len[i] = Z_STRLEN(temp);
-                zval_dtor(&temp);
-            } else {
-                cmd_args[i] = (uintptr_t) Z_STRVAL_P(arg);
-                args_len[i] = Z_STRLEN_P(arg);
-            }
-        }
-
-        /* Set the first argument as "FUNCTION" */
-        const char*    function_cmd = "FUNCTION";
-        uintptr_t*     final_args   = (uintptr_t*) emalloc((arg_count + 1) * sizeof(uintptr_t));
-        unsigned long* final_args_len =
-            (unsigned long*) emalloc((arg_count + 1) * sizeof(unsigned long));
-
-        if (!final_args || !final_args_len) {
-            if (cmd_args)
-                efree(cmd_args);
-            if (args_len)
-                efree(args_len);
-            if (final_args)
-                efree(final_args);
-            if (final_args_len)
-                efree(final_args_len);
-            return 0;
-        }
-
-        final_args[0]     = (uintptr_t) function_cmd;
-        final_args_len[0] = strlen(function_cmd);
+        /* FUNCTION subcommand [arg ...], sent as a custom command */
+        valkey_glide_args args;
 
-        /* Copy the rest of the arguments */
-        for (i = 0; i < arg_count; i++) {
-            final_args[i + 1]     = cmd_args[i];
-            final_args_len[i + 1] = args_len[i];
+        valkey_glide_args_init(&args);
+        valkey_glide_args_add_literal(&args, "FUNCTION");
+        for (int i = 0; i < args_count; i++) {
+            valkey_glide_args_add_zval(&args, &z_args[i]);
         }
 
-        /* Execute the command */
         CommandResult* result =
-            execute_command(valkey_glide->glide_client,
-                            CustomCommand, /* FUNCTION commands use custom command type */
-                            arg_count + 1, /* FUNCTION command + args */
-                            final_args,    /* arguments */
-                            final_args_len /* argument lengths */
-            );
-
-        /* Free the argument arrays */
-        efree(cmd_args);
-        efree(args_len);
-        efree(final_args);
-        efree(final_args_len);
+            valkey_glide_args_execute(valkey_glide->glide_client, CustomCommand, &args, NULL);
+        valkey_glide_args_free(&args);
 
         /* Handle the result directly */
         int status = 0;
@@ -479,19 +152,39 @@ int execute_multi_command(zval* object, int argc, zval* return_value, zend_class
         return 0;
     }
 
-    /* Initialize batch mode */
+    /* Initialize batch mode, dropping the commands of an earlier multi() never executed */
+    valkey_glide_batch_clear(valkey_glide);
     valkey_glide->is_in_batch_mode = true;
     valkey_glide->batch_type       = (int) batch_type;
-    valkey_glide->command_count    = 0;
 
-    /* Initialize buffer if needed */
-    if (!valkey_glide->buffered_commands) {
-        valkey_glide->command_capacity  = 16; /* Initial capacity */
-        valkey_glide->buffered_commands = (struct batch_command*) ecalloc(
-            valkey_glide->command_capacity, sizeof(struct batch_command));
+    /* Return $this for method chaining */
+    ZVAL_COPY(return_value, object);
+    return 1;
+}
+
+/* Execute a PIPELINE command: multi(ValkeyGlide::PIPELINE), with the options of its exec() */
+int execute_pipeline_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    valkey_glide_object* valkey_glide;
+    struct batch_options batch_options = {0};
+    HashTable*           options       = NULL;
+
+    if (zend_parse_method_parameters(argc, object, "O|h", &object, ce, &options) == FAILURE) {
+        return 0;
+    }
+    if (options && !valkey_glide_batch_parse_options(options, &batch_options, 1)) {
+        return 0;
     }
 
-    /* Return $this for method chaining */
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (!valkey_glide || !valkey_glide->glide_client) {
+        return 0;
+    }
+
+    valkey_glide_batch_clear(valkey_glide);
+    valkey_glide->is_in_batch_mode = true;
+    valkey_glide->batch_type       = PIPELINE;
+    valkey_glide->batch_options    = batch_options;
+
     ZVAL_COPY(return_value, object);
     return 1;
 }
@@ -514,7 +207,7 @@ int execute_discard_command(zval* object, int argc, zval* return_value, zend_cla
 
     /* Clear batch state if we're in batch mode */
     if (valkey_glide->is_in_batch_mode) {
-        clear_batch_state(valkey_glide);
+        valkey_glide_batch_clear(valkey_glide);
         ZVAL_TRUE(return_value);
         return 1;
     }
@@ -535,9 +228,10 @@ int execute_discard_command(zval* object, int argc, zval* return_value, zend_cla
 /* Execute an EXEC command using the Valkey Glide client - UPDATED FOR BUFFERING */
 int execute_exec_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
     valkey_glide_object* valkey_glide;
+    HashTable*           options = NULL;
 
     /* Parse parameters */
-    if (zend_parse_method_parameters(argc, object, "O", &object, ce) == FAILURE) {
+    if (zend_parse_method_parameters(argc, object, "O|h", &object, ce, &options) == FAILURE) {
         return 0;
     }
 
@@ -554,85 +248,16 @@ int execute_exec_command(zval* object, int argc, zval* return_value, zend_class_
         return 0;
     }
 
-    /* Convert buffered commands to FFI BatchInfo structure */
-    struct CmdInfo** cmd_infos =
-        (struct CmdInfo**) emalloc(valkey_glide->command_count * sizeof(struct CmdInfo*));
-    if (!cmd_infos) {
-        clear_batch_state(valkey_glide);
-        ZVAL_FALSE(return_value);
+    /* Options of exec() override those of pipeline(); the batch stays buffered if invalid */
+    struct batch_options batch_opts = valkey_glide->batch_options;
+    if (options && !valkey_glide_batch_parse_options(options, &batch_opts, 1)) {
         return 0;
     }
 
-    /* Create CmdInfo structures for each buffered command */
-    size_t i;
-    for (i = 0; i < valkey_glide->command_count; i++) {
-        struct batch_command* buffered = &valkey_glide->buffered_commands[i];
-        struct CmdInfo*       cmd_info = (struct CmdInfo*) emalloc(sizeof(struct CmdInfo));
-
-        if (!cmd_info) {
-            /* Cleanup on error */
-            for (size_t j = 0; j < i; j++) {
-                efree(cmd_infos[j]);
-            }
-            efree(cmd_infos);
-            clear_batch_state(valkey_glide);
-            ZVAL_FALSE(return_value);
-            return 0;
-        }
-
-        cmd_info->request_type = buffered->request_type;
-        cmd_info->args         = (const uint8_t* const*) buffered->args;
-        cmd_info->arg_count    = buffered->arg_count;
-        cmd_info->args_len     = (const uintptr_t*) buffered->arg_lengths;
-
-        cmd_infos[i] = cmd_info;
-    }
-
-    /* Create BatchInfo structure */
-    struct BatchInfo batch_info = {
-        .cmd_count = valkey_glide->command_count,
-        .cmds      = (const struct CmdInfo* const*) cmd_infos,
-        .is_atomic = (valkey_glide->batch_type == MULTI || valkey_glide->batch_type == ATOMIC)};
-
-    /* Execute via FFI batch() function */
-    struct CommandResult* result = batch(valkey_glide->glide_client,
-                                         0, /* callback_index (not used for sync) */
-                                         &batch_info,
-                                         false, /* raise_on_error */
-                                         NULL,  /* options */
-                                         0      /* span_ptr */
-    );
-
-    /* Free CmdInfo structures */
-    for (i = 0; i < valkey_glide->command_count; i++) {
-        efree(cmd_infos[i]);
-    }
-    efree(cmd_infos);
-
-    /* Process results and clear batch state */
-    int status = 0;
-    if (result) {
-        if (result->command_error) {
-            /* Command failed */
-            free_command_result(result);
-            clear_batch_state(valkey_glide);
-            ZVAL_FALSE(return_value);
-            return 0;
-        }
-
-        if (result->response) {
-            status = command_response_to_zval(
-                result->response, return_value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false);
-            free_command_result(result);
-            clear_batch_state(valkey_glide);
-            return status ? 1 : 0;
-        }
-        free_command_result(result);
-    }
-
-    clear_batch_state(valkey_glide);
-    ZVAL_FALSE(return_value);
-    return 0;
+    /* Execute the buffered commands, then clear the batch state */
+    int status = valkey_glide_batch_exec(valkey_glide, &batch_opts, return_value);
+    valkey_glide_batch_clear(valkey_glide);
+    return status ? 1 : 0;
 }
 
 /* Internal function to execute FCALL/FCALL_RO commands using the Valkey Glide client */
@@ -648,60 +273,31 @@ static int execute_fcall_command_internal(const void*      glide_client,
         return 0;
     }
 
-    /* Calculate numkeys from keys array */
-    long numkeys = 0;
+    /* name numkeys [key ...] [arg ...], the keys with OPT_PREFIX */
+    valkey_glide_args args;
+    zval*             val;
+
+    valkey_glide_args_init(&args);
+    valkey_glide_args_add(&args, name, name_len);
     if (keys_array && Z_TYPE_P(keys_array) == IS_ARRAY) {
-        numkeys = zend_hash_num_elements(Z_ARRVAL_P(keys_array));
+        valkey_glide_args_add_long(&args, zend_hash_num_elements(Z_ARRVAL_P(keys_array)));
+        ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(keys_array), val) {
+            valkey_glide_args_add_key_zval(&args, val);
+        }
+        ZEND_HASH_FOREACH_END();
+    } else {
+        valkey_glide_args_add_literal(&args, "0");
     }
-
-    /* Calculate args count from args array */
-    long args_count = 0;
     if (args_array && Z_TYPE_P(args_array) == IS_ARRAY) {
-        args_count = zend_hash_num_elements(Z_ARRVAL_P(args_array));
-    }
-
-    /* Prepare numkeys as string */
-    char numkeys_str[32];
-    snprintf(numkeys_str, sizeof(numkeys_str), "%ld", numkeys);
-
-    /* Calculate total arguments: function_name + numkeys + keys + args */
-    unsigned long  arg_count = 2 + numkeys + args_count;
-    uintptr_t*     cmd_args  = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-    unsigned long* args_len  = (unsigned long*) emalloc(arg_count * sizeof(unsigned long));
-
-    if (!cmd_args || !args_len) {
-        if (cmd_args)
-            efree(cmd_args);
-        if (args_len)
-            efree(args_len);
-        return 0;
+        ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(args_array), val) {
+            valkey_glide_args_add_zval(&args, val);
+        }
+        ZEND_HASH_FOREACH_END();
     }
 
-    /* Set function name and numkeys */
-    cmd_args[0] = (uintptr_t) name;
-    args_len[0] = name_len;
-    cmd_args[1] = (uintptr_t) numkeys_str;
-    args_len[1] = strlen(numkeys_str);
-
-    unsigned long arg_index = 2;
-
-    /* Process keys array */
-    process_array_to_args(keys_array, cmd_args, args_len, &arg_index);
-
-    /* Process args array */
-    process_array_to_args(args_array, cmd_args, args_len, &arg_index);
-
-    /* Execute the command */
-    CommandResult* result = execute_command(glide_client,
-                                            command_type, /* FCall or FCallReadOnly */
-                                            arg_count,    /* number of arguments */
-                                            cmd_args,     /* arguments */
-                                            args_len      /* argument lengths */
-    );
-
-    /* Free the argument arrays */
-    efree(cmd_args);
-    efree(args_len);
+    /* FCall or FCallReadOnly */
+    CommandResult* result = valkey_glide_args_execute(glide_client, command_type, &args, NULL);
+    valkey_glide_args_free(&args);
 
     /* Handle the result directly */
     int status = 0;
@@ -868,33 +464,13 @@ int execute_restore_command(zval* object, int argc, zval* return_value, zend_cla
             return 0;
         }
 
-        /* Convert TTL to string */
-        char ttl_str[32];
-        snprintf(ttl_str, sizeof(ttl_str), "%ld", ttl);
-
-        /* Start with basic arguments: key + ttl + serialized */
-        unsigned long  base_arg_count = 3;
-        unsigned long  max_args       = 10; /* Maximum possible arguments */
-        uintptr_t*     args           = (uintptr_t*) emalloc(max_args * sizeof(uintptr_t));
-        unsigned long* args_len       = (unsigned long*) emalloc(max_args * sizeof(unsigned long));
-
-        if (!args || !args_len) {
-            if (args)
-                efree(args);
-            if (args_len)
-                efree(args_len);
-            return 0;
-        }
+        /* key ttl serialized-value [REPLACE] [ABSTTL] [IDLETIME seconds] [FREQ frequency] */
+        valkey_glide_args args;
 
-        /* Set up base arguments */
-        args[0]     = (uintptr_t) key;
-        args_len[0] = key_len;
-        args[1]     = (uintptr_t) ttl_str;
-        args_len[1] = strlen(ttl_str);
-        args[2]     = (uintptr_t) serialized;
-        args_len[2] = serialized_len;
-
-        unsigned long arg_count = base_arg_count;
+        valkey_glide_args_init(&args);
+        valkey_glide_args_add_key(&args, key, key_len);
+        valkey_glide_args_add_long(&args, ttl);
+        valkey_glide_args_add(&args, serialized, serialized_len);
 
         /* Process options if provided */
         if (options && Z_TYPE_P(options) == IS_ARRAY) {
@@ -936,74 +512,25 @@ int execute_restore_command(zval* object, int argc, zval* return_value, zend_cla
             }
             ZEND_HASH_FOREACH_END();
 
-            /* Add REPLACE if needed */
-            if (has_replace && arg_count < max_args) {
-                const char* replace_str = "REPLACE";
-                args[arg_count]         = (uintptr_t) replace_str;
-                args_len[arg_count]     = strlen(replace_str);
-                arg_count++;
+            if (has_replace) {
+                valkey_glide_args_add_literal(&args, "REPLACE");
             }
-
-            /* Add ABSTTL if needed */
-            if (has_absttl && arg_count < max_args) {
-                const char* absttl_str = "ABSTTL";
-                args[arg_count]        = (uintptr_t) absttl_str;
-                args_len[arg_count]    = strlen(absttl_str);
-                arg_count++;
+            if (has_absttl) {
+                valkey_glide_args_add_literal(&args, "ABSTTL");
             }
-
-            /* Add IDLETIME if provided */
-            if (idletime >= 0 && arg_count + 1 < max_args) {
-                const char* idletime_str = "IDLETIME";
-                args[arg_count]          = (uintptr_t) idletime_str;
-                args_len[arg_count]      = strlen(idletime_str);
-                arg_count++;
-
-                /* Convert idletime to string */
-                char* idletime_val = (char*) emalloc(32);
-                snprintf(idletime_val, 32, "%ld", idletime);
-                args[arg_count]     = (uintptr_t) idletime_val;
-                args_len[arg_count] = strlen(idletime_val);
-                arg_count++;
+            if (idletime >= 0) {
+                valkey_glide_args_add_literal(&args, "IDLETIME");
+                valkey_glide_args_add_long(&args, idletime);
             }
-
-            /* Add FREQ if provided */
-            if (freq >= 0 && arg_count + 1 < max_args) {
-                const char* freq_str = "FREQ";
-                args[arg_count]      = (uintptr_t) freq_str;
-                args_len[arg_count]  = strlen(freq_str);
-                arg_count++;
-
-                /* Convert freq to string */
-                char* freq_val = (char*) emalloc(32);
-                snprintf(freq_val, 32, "%ld", freq);
-                args[arg_count]     = (uintptr_t) freq_val;
-                args_len[arg_count] = strlen(freq_val);
-                arg_count++;
+            if (freq >= 0) {
+                valkey_glide_args_add_literal(&args, "FREQ");
+                valkey_glide_args_add_long(&args, freq);
             }
         }
 
-        /* Execute the command */
-        CommandResult* result = execute_command(valkey_glide->glide_client,
-                                                Restore,   /* command type */
-                                                arg_count, /* number of arguments */
-                                                args,      /* arguments */
-                                                args_len   /* argument lengths */
-        );
-
-        /* Free any dynamically allocated option values */
-        int i;
-        for (i = base_arg_count; i < arg_count; i++) {
-            /* Check if this is a dynamically allocated string (IDLETIME/FREQ values) */
-            char* str = (char*) args[i];
-            if (str && str[0] >= '0' && str[0] <= '9') {
-                efree(str);
-            }
-        }
-
-        /* Free the argument arrays */
-        efree(args);
-        efree(args_len);
+        CommandResult* result =
+            valkey_glide_args_execute(valkey_glide->glide_client, Restore, &args, NULL);
+        valkey_glide_args_free(&args);
 
         /* Process the result */
         int status = 0;
@@ -1072,12 +599,9 @@ int execute_config_command(zval* object, int argc, zval* return_value, zend_clas
             return 0;
         }
 
-        /* Prepare command arguments */
-        unsigned long  arg_count         = 0;
-        uintptr_t*     args              = NULL;
-        unsigned long* args_len          = NULL;
-        char**         temp_strings      = NULL;
-        int            temp_string_count = 0;
+        valkey_glide_args args;
+
+        valkey_glide_args_init(&args);
 
         /* For CONFIG GET */
         if (command_type == ConfigGet) {
@@ -1088,39 +612,16 @@ int execute_config_command(zval* object, int argc, zval* return_value, zend_clas
 
             /* Handle string or array parameter */
             if (Z_TYPE_P(key) == IS_STRING) {
-                arg_count = 1;
-                args      = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-                args_len  = (unsigned long*) emalloc(arg_count * sizeof(unsigned long));
-
-                args[0]     = (uintptr_t) Z_STRVAL_P(key);
-                args_len[0] = Z_STRLEN_P(key);
+                valkey_glide_args_add(&args, Z_STRVAL_P(key), Z_STRLEN_P(key));
             } else if (Z_TYPE_P(key) == IS_ARRAY) {
-                HashTable* ht = Z_ARRVAL_P(key);
-                arg_count     = zend_hash_num_elements(ht);
+                zval* z_param;
 
-                if (arg_count == 0) {
+                if (zend_hash_num_elements(Z_ARRVAL_P(key)) == 0) {
                     php_error_docref(NULL, E_WARNING, "CONFIG GET array cannot be empty");
                     return 0;
                 }
-
-                args         = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-                args_len     = (unsigned long*) emalloc(arg_count * sizeof(unsigned long));
-                temp_strings = (char**) ecalloc(arg_count, sizeof(char*));
-
-                zval* z_param;
-                int   i = 0;
-                ZEND_HASH_FOREACH_VAL(ht, z_param) {
-                    zval temp;
-                    ZVAL_COPY(&temp, z_param);
-                    convert_to_string(&temp);
-
-                    temp_strings[temp_string_count] = estrdup(Z_STRVAL(temp));
-                    args[i]                         = (uintptr_t) temp_strings[temp_string_count];
-                    args_len[i]                     = Z_STRLEN(temp);
-                    temp_string_count++;
-                    i++;
-
-                    zval_dtor(&temp);
+                ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(key), z_param) {
+                    valkey_glide_args_add_zval(&args, z_param);
                 }
                 ZEND_HASH_FOREACH_END();
             } else {
@@ -1138,66 +639,25 @@ int execute_config_command(zval* object, int argc, zval* return_value, zend_clas
             /* Handle two strings or an array */
             if (Z_TYPE_P(key) == IS_STRING && Z_TYPE_P(value) != IS_NULL) {
                 /* CONFIG SET key value */
-                arg_count    = 2;
-                args         = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-                args_len     = (unsigned long*) emalloc(arg_count * sizeof(unsigned long));
-                temp_strings = (char**) ecalloc(2, sizeof(char*));
-
-                /* Key */
-                args[0]     = (uintptr_t) Z_STRVAL_P(key);
-                args_len[0] = Z_STRLEN_P(key);
-
-                /* Value */
-                zval temp;
-                ZVAL_COPY(&temp, value);
-                convert_to_string(&temp);
-
-                temp_strings[0]   = estrdup(Z_STRVAL(temp));
-                args[1]           = (uintptr_t) temp_strings[0];
-                args_len[1]       = Z_STRLEN(temp);
-                temp_string_count = 1;
-
-                zval_dtor(&temp);
+                valkey_glide_args_add(&args, Z_STRVAL_P(key), Z_STRLEN_P(key));
+                valkey_glide_args_add_zval(&args, value);
             } else if (Z_TYPE_P(key) == IS_ARRAY && value == NULL) {
                 /* CONFIG SET from array */
-                HashTable* ht = Z_ARRVAL_P(key);
-                arg_count     = zend_hash_num_elements(ht) * 2;
+                zend_string* zkey;
+                zval*        zvalue;
 
-                if (arg_count == 0) {
+                if (zend_hash_num_elements(Z_ARRVAL_P(key)) == 0) {
                     php_error_docref(NULL, E_WARNING, "CONFIG SET array cannot be empty");
                     return 0;
                 }
-
-                args         = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-                args_len     = (unsigned long*) emalloc(arg_count * sizeof(unsigned long));
-                temp_strings = (char**) ecalloc(zend_hash_num_elements(ht), sizeof(char*));
-
-                zend_string* zkey;
-                zval*        zvalue;
-                int          i = 0;
-                ZEND_HASH_FOREACH_STR_KEY_VAL(ht, zkey, zvalue) {
+                ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(key), zkey, zvalue) {
                     if (!zkey) {
                         php_error_docref(NULL, E_WARNING, "CONFIG SET array must be associative");
-                        goto cleanup;
+                        valkey_glide_args_free(&args);
+                        return 0;
                     }
-
-                    /* Add key */
-                    args[i]     = (uintptr_t) ZSTR_VAL(zkey);
-                    args_len[i] = ZSTR_LEN(zkey);
-                    i++;
-
-                    /* Add value */
-                    zval temp;
-                    ZVAL_COPY(&temp, zvalue);
-                    convert_to_string(&temp);
-
-                    temp_strings[temp_string_count] = estrdup(Z_STRVAL(temp));
-                    args[i]                         = (uintptr_t) temp_strings[temp_string_count];
-                    args_len[i]                     = Z_STRLEN(temp);
-                    temp_string_count++;
-                    i++;
-
-                    zval_dtor(&temp);
+                    valkey_glide_args_add(&args, ZSTR_VAL(zkey), ZSTR_LEN(zkey));
+                    valkey_glide_args_add_zval(&args, zvalue);
                 }
                 ZEND_HASH_FOREACH_END();
             } else {
@@ -1206,33 +666,11 @@ int execute_config_command(zval* object, int argc, zval* return_value, zend_clas
             }
         }
         /* CONFIG RESETSTAT and CONFIG REWRITE have no additional arguments */
-        else if (command_type == ConfigResetStat || command_type == ConfigRewrite) {
-            arg_count = 0; /* No arguments needed */
-            args      = NULL;
-            args_len  = NULL;
-        } else {
-            php_error_docref(NULL, E_WARNING, "Unknown CONFIG operation '%s'", operation);
-            return 0;
-        }
 
         /* Execute the command */
         CommandResult* result =
-            execute_command(valkey_glide->glide_client, command_type, arg_count, args, args_len);
-
-        /* Free temporary strings */
-        if (temp_strings) {
-            for (int i = 0; i < temp_string_count; i++) {
-                if (temp_strings[i])
-                    efree(temp_strings[i]);
-            }
-            efree(temp_strings);
-        }
-
-        /* Free the argument arrays */
-        if (args)
-            efree(args);
-        if (args_len)
-            efree(args_len);
+            valkey_glide_args_execute(valkey_glide->glide_client, command_type, &args, NULL);
+        valkey_glide_args_free(&args);
 
         /* Handle the result */
         int status = 0;
@@ -1265,20 +703,6 @@ int execute_config_command(zval* object, int argc, zval* return_value, zend_clas
         }
 
         return status;
-
-    cleanup:
-        /* Cleanup on error */
-        if (temp_strings) {
-            for (int i = 0; i < temp_string_count; i++) {
-                if (temp_strings[i])
-                    efree(temp_strings[i]);
-            }
-            efree(temp_strings);
-        }
-        if (args)
-            efree(args);
-        if (args_len)
-            efree(args_len);
     }
 
     return 0;
@@ -1383,6 +807,18 @@ static int parse_client_list_response(const char* response_str,
     return 1;
 }
 
+int valkey_glide_client_reply_to_zval(enum RequestType type,
+                                      CommandResponse* response,
+                                      zval*            return_value) {
+    /* Special handling for CLIENT LIST - convert string to array of associative arrays */
+    if (type == ClientList && response->response_type == String) {
+        return parse_client_list_response(
+            response->string_value, response->string_value_len, return_value);
+    }
+    return command_response_to_zval(
+        response, return_value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false);
+}
+
 /* Execute a CLIENT command using the Valkey Glide client */
 int execute_client_command_internal(
     const void* glide_client, zval* args, int args_count, zval* return_value, zval* route) {
@@ -1391,57 +827,6 @@ int execute_client_command_internal(
         return 0;
     }
 
-    /* Create argument arrays */
-    unsigned long  arg_count = args_count;
-    uintptr_t*     cmd_args  = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-    unsigned long* args_len  = (unsigned long*) emalloc(arg_count * sizeof(unsigned long));
-
-    if (!cmd_args || !args_len) {
-        if (cmd_args)
-            efree(cmd_args);
-        if (args_len)
-            efree(args_len);
-        return 0;
-    }
-
-    /* Keep track of allocated strings for cleanup */
-    char** allocated     = (char**) emalloc(args_count * sizeof(char*));
-    int    allocated_idx = 0;
-
-    /* Convert arguments to strings if needed */
-    int i;
-
-    for (i = 1; i < args_count; i++) {
-        zval* arg = &args[i];
-
-        /* If string, use directly */
-        if (Z_TYPE_P(arg) == IS_STRING) {
-            cmd_args[i - 1] = (uintptr_t) Z_STRVAL_P(arg);
-            args_len[i - 1] = Z_STRLEN_P(arg);
-        } else {
-            /* Convert non-string types to string */
-            zval   copy;
-            size_t str_len;
-            char*  str;
-
-            ZVAL_DUP(&copy, arg);
-            convert_to_string(&copy);
-
-            str_len = Z_STRLEN(copy);
-            str     = emalloc(str_len + 1);
-            memcpy(str, Z_STRVAL(copy), str_len);
-            str[str_len] = '\0';
-
-            cmd_args[i - 1] = (uintptr_t) str;
-            args_len[i - 1] = str_len;
-
-            /* Track allocated string for cleanup */
-            allocated[allocated_idx++] = str;
-
-            zval_dtor(&copy);
-        }
-    }
-
     /* Determine the appropriate client command type based on the first argument */
     enum RequestType command_type = ClientInfo; /* Default to ClientInfo */
 
@@ -1474,46 +859,17 @@ int execute_client_command_internal(
             return 0; /* Unknown command */
     }
 
-    /* Set additional client prefix for custom commands */
-    uintptr_t*     final_args      = cmd_args;
-    unsigned long* final_args_len  = args_len;
-    unsigned long  final_arg_count = arg_count - 1;
-
+    /* The arguments after the subcommand, which the request type names */
+    valkey_glide_args cmd_args;
 
-    /* Execute the command with or without routing */
-    CommandResult* result;
-    if (route) {
-        /* Use cluster routing */
-        result = execute_command_with_route(glide_client,
-                                            command_type,    /* command type */
-                                            final_arg_count, /* number of arguments */
-                                            final_args,      /* arguments */
-                                            final_args_len,  /* argument lengths */
-                                            route            /* route parameter */
-        );
-    } else {
-        /* No routing (standalone mode) */
-        result = execute_command(glide_client,
-                                 command_type,    /* command type */
-                                 final_arg_count, /* number of arguments */
-                                 final_args,      /* arguments */
-                                 final_args_len   /* argument lengths */
-        );
+    valkey_glide_args_init(&cmd_args);
+    for (int i = 1; i < args_count; i++) {
+        valkey_glide_args_add_zval(&cmd_args, &args[i]);
     }
 
-    /* Free allocated memory */
-    for (i = 0; i < allocated_idx; i++)
-        efree(allocated[i]);
-    efree(allocated);
-
-    /* If we created a new args array for CustomCommand, free it */
-    if (command_type == CustomCommand) {
-        efree(final_args);
-        efree(final_args_len);
-    }
-
-    efree(cmd_args);
-    efree(args_len);
+    /* Execute the command with or without routing */
+    CommandResult* result = valkey_glide_args_execute(glide_client, command_type, &cmd_args, route);
+    valkey_glide_args_free(&cmd_args);
 
     /* Process the result */
     int status = 0;
@@ -1527,16 +883,8 @@ int execute_client_command_internal(
         }
 
         if (result->response) {
-            /* Special handling for CLIENT LIST - convert string to array of associative arrays */
-            if (command_type == ClientList && result->response->response_type == String) {
-                status = parse_client_list_response(result->response->string_value,
-                                                    result->response->string_value_len,
-                                                    return_value);
-            } else {
-                /* Convert the response to PHP value using normal processing */
-                status = command_response_to_zval(
-                    result->response, return_value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false);
-            }
+            status =
+                valkey_glide_client_reply_to_zval(command_type, result->response, return_value);
         }
         free_command_result(result);
     }
@@ -1552,83 +900,18 @@ int execute_rawcommand_command_internal(
         return 0;
     }
 
-    /* Create argument arrays */
-    unsigned long  arg_count = args_count;
-    uintptr_t*     cmd_args  = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-    unsigned long* args_len  = (unsigned long*) emalloc(arg_count * sizeof(unsigned long));
-
-    if (!cmd_args || !args_len) {
-        if (cmd_args)
-            efree(cmd_args);
-        if (args_len)
-            efree(args_len);
-        return 0;
-    }
-
-    /* Keep track of allocated strings for cleanup */
-    char** allocated     = (char**) emalloc(args_count * sizeof(char*));
-    int    allocated_idx = 0;
-
-    /* Convert arguments to strings if needed */
-    int i;
-    for (i = 0; i < args_count; i++) {
-        zval* arg = &args[i];
-
-        /* If string, use directly */
-        if (Z_TYPE_P(arg) == IS_STRING) {
-            cmd_args[i] = (uintptr_t) Z_STRVAL_P(arg);
-            args_len[i] = Z_STRLEN_P(arg);
-        } else {
-            /* Convert non-string types to string */
-            zval   copy;
-            size_t str_len;
-            char*  str;
-
-            ZVAL_DUP(&copy, arg);
-            convert_to_string(&copy);
-
-            str_len = Z_STRLEN(copy);
-            str     = emalloc(str_len + 1);
-            memcpy(str, Z_STRVAL(copy), str_len);
-            str[str_len] = '\0';
-
-            cmd_args[i] = (uintptr_t) str;
-            args_len[i] = str_len;
-
-            /* Track allocated string for cleanup */
-            allocated[allocated_idx++] = str;
+    /* Sent as it is given, as a custom command */
+    valkey_glide_args cmd_args;
 
-            zval_dtor(&copy);
-        }
+    valkey_glide_args_init(&cmd_args);
+    for (int i = 0; i < args_count; i++) {
+        valkey_glide_args_add_zval(&cmd_args, &args[i]);
     }
 
     /* Execute the command with or without routing */
-    CommandResult* result;
-    if (route) {
-        /* Use cluster routing */
-        result = execute_command_with_route(glide_client,
-                                            CustomCommand, /* command type for raw commands */
-                                            arg_count,     /* number of arguments */
-                                            cmd_args,      /* arguments */
-                                            args_len,      /* argument lengths */
-                                            route          /* route parameter */
-        );
-    } else {
-        /* No routing (standalone mode) */
-        result = execute_command(glide_client,
-                                 CustomCommand, /* command type for raw commands */
-                                 arg_count,     /* number of arguments */
-                                 cmd_args,      /* arguments */
-                                 args_len       /* argument lengths */
-        );
-    }
-
-    /* Free allocated memory */
-    for (i = 0; i < allocated_idx; i++)
-        efree(allocated[i]);
-    efree(allocated);
-    efree(cmd_args);
-    efree(args_len);
+    CommandResult* result =
+        valkey_glide_args_execute(glide_client, CustomCommand, &cmd_args, route);
+    valkey_glide_args_free(&cmd_args);
 
     /* Process the result */
     int status = 0;
@@ -1695,6 +978,14 @@ int execute_client_command(zval* object, int argc, zval* return_value, zend_clas
         }
     }
 
+    /* CLIENT REPLY OFF|SKIP would leave the batch without the replies of its commands */
+    if (valkey_glide->is_in_batch_mode && Z_TYPE(z_args[0]) == IS_STRING &&
+        zend_string_equals_literal_ci(Z_STR(z_args[0]), "REPLY")) {
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), "CLIENT REPLY cannot be used in a batch", 0);
+        return 0;
+    }
+
     /* Execute the client command using the Glide client */
     if (execute_client_command_internal(
             valkey_glide->glide_client, z_args, arg_count, return_value, route)) {
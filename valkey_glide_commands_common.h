@@ -58,10 +58,16 @@ void free_command_response(CommandResponse* command_response_ptr);
 void free_command_result(CommandResult* command_result_ptr);
 
 /* Helper functions for Valkey Glide integration */
-const ConnectionResponse* create_glide_client(valkey_glide_client_configuration_t* config);
+const ConnectionResponse* create_glide_client_from_request(const uint8_t* request_bytes,
+                                                          size_t         len);
 
-const ConnectionResponse* create_glide_cluster_client(
-    valkey_glide_cluster_client_configuration_t* config);
+/* Connect a client object from its configuration, borrowing from the persistent pool when a
+ * persistent_id is set. Throws and returns false on failure. */
+bool valkey_glide_connect(valkey_glide_object*                      valkey_glide,
+                          valkey_glide_base_client_configuration_t* config,
+                          int                                       database_id,
+                          valkey_glide_periodic_checks_status_t     periodic_checks,
+                          bool                                      is_cluster);
 
 /* Return the protobuf message representing the connection request. Caller must free the result with
  * efree() */
@@ -82,8 +88,7 @@ int execute_bitpos_command(zval* object, int argc, zval* return_value, zend_clas
 int execute_set_command_internal(const void* glide_client,
                                  const char* key,
                                  size_t      key_len,
-                                 const char* val,
-                                 size_t      val_len,
+                                 zval*       value,
                                  long        expire,
                                  zval*       opts,
                                  char**      old_val,
@@ -103,6 +108,12 @@ int execute_ping_command(zval* object, int argc, zval* return_value, zend_class_
 int execute_reset_command(const void* glide_client);
 int execute_info_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
 
+/* INFO and CLIENT replies as info() and client() return them, also used by exec() */
+int valkey_glide_info_to_zval(CommandResponse* response, zval* return_value);
+int valkey_glide_client_reply_to_zval(enum RequestType type,
+                                      CommandResponse* response,
+                                      zval*            return_value);
+
 /* Additional operations */
 int execute_getbit_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
 int execute_setbit_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
@@ -175,6 +186,7 @@ int execute_function_command(zval* object, int argc, zval* return_value, zend_cl
 int execute_multi_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
 int execute_discard_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
 int execute_exec_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+int execute_pipeline_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
 int execute_fcall_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
 int execute_fcall_ro_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
 int execute_dump_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
@@ -213,12 +225,6 @@ int execute_unlink_command(zval* object, int argc, zval* return_value, zend_clas
 
 int execute_del_array(const void* glide_client, HashTable* keys_hash, long* output_value);
 
-/* Batch command buffering function */
-int buffer_current_command_generic(valkey_glide_object* valkey_glide,
-                                   enum RequestType     request_type,
-                                   int                  argc,
-                                   zval*                this_ptr);
-
 /* ====================================================================
  * METHOD IMPLEMENTATION MACROS
  * ==================================================================== */
@@ -1025,6 +1031,20 @@ int buffer_current_command_generic(valkey_glide_object* valkey_glide,
         RETURN_FALSE;                                                           \
     }
 
+#define PIPELINE_METHOD_IMPL(class_name)                                            \
+    PHP_METHOD(class_name, pipeline) {                                              \
+        if (execute_pipeline_command(getThis(),                                     \
+                                     ZEND_NUM_ARGS(),                               \
+                                     return_value,                                  \
+                                     strcmp(#class_name, "ValkeyGlideCluster") == 0 \
+                                         ? get_valkey_glide_cluster_ce()            \
+                                         : get_valkey_glide_ce())) {                \
+            return;                                                                 \
+        }                                                                           \
+        zval_dtor(return_value);                                                    \
+        RETURN_FALSE;                                                               \
+    }
+
 #define FCALL_METHOD_IMPL(class_name)                                            \
     PHP_METHOD(class_name, fcall) {                                              \
         if (execute_fcall_command(getThis(),                                     \
@@ -1292,60 +1312,4 @@ int buffer_current_command_generic(valkey_glide_object* valkey_glide,
         RETURN_FALSE;                                                             \
     }
 
-/* ====================================================================
- * BATCH-AWARE METHOD IMPLEMENTATION MACRO
- * ==================================================================== */
-
-/* Generic batch-aware macro that handles batch mode checking and method chaining */
-#define BATCH_AWARE_METHOD_IMPL(class_name, method_name, request_type, execute_func) \
-    PHP_METHOD(class_name, method_name) {                                            \
-        valkey_glide_object* valkey_glide =                                          \
-            VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, getThis());        \
-                                                                                     \
-        /* Check for batch mode first */                                             \
-        if (valkey_glide && valkey_glide->is_in_batch_mode) {                        \
-            /* Buffer the command and return $this for chaining */                   \
-            extern int buffer_current_command_generic(                               \
-                valkey_glide_object*, enum RequestType, int, zval*);                 \
-            if (buffer_current_command_generic(                                      \
-                    valkey_glide, request_type, ZEND_NUM_ARGS(), getThis())) {       \
-                ZVAL_COPY(return_value, getThis());                                  \
-                return;                                                              \
-            }                                                                        \
-        }                                                                            \
-                                                                                     \
-        /* Normal execution if not in batch mode */                                  \
-        if (execute_func(getThis(),                                                  \
-                         ZEND_NUM_ARGS(),                                            \
-                         return_value,                                               \
-                         strcmp(#class_name, "ValkeyGlideCluster") == 0              \
-                             ? get_valkey_glide_cluster_ce()                         \
-                             : get_valkey_glide_ce())) {                             \
-            return;                                                                  \
-        }                                                                            \
-        zval_dtor(return_value);                                                     \
-        RETURN_FALSE;                                                                \
-    }
-
-/* Updated method implementations using batch-aware macro */
-#undef SET_METHOD_IMPL
-#define SET_METHOD_IMPL(class_name) \
-    BATCH_AWARE_METHOD_IMPL(class_name, set, Set, execute_set_command)
-
-#undef GET_METHOD_IMPL
-#define GET_METHOD_IMPL(class_name) \
-    BATCH_AWARE_METHOD_IMPL(class_name, get, Get, execute_get_command)
-
-#undef EXISTS_METHOD_IMPL
-#define EXISTS_METHOD_IMPL(class_name) \
-    BATCH_AWARE_METHOD_IMPL(class_name, exists, Exists, execute_exists_command)
-
-#undef DEL_METHOD_IMPL
-#define DEL_METHOD_IMPL(class_name) \
-    BATCH_AWARE_METHOD_IMPL(class_name, del, Del, execute_del_command)
-
-#undef TYPE_METHOD_IMPL
-#define TYPE_METHOD_IMPL(class_name) \
-    BATCH_AWARE_METHOD_IMPL(class_name, type, Type, execute_type_command)
-
 #endif /* VALKEY_GLIDE_COMMANDS_COMMON_H */
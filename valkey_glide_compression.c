@@ -0,0 +1,181 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Value Compression                                       |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#include "valkey_glide_compression.h"
+
+#ifdef HAVE_VALKEY_GLIDE_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+#ifdef HAVE_VALKEY_GLIDE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "common.h"
+
+static const unsigned char compression_magic[3] = {0xFE, 'V', 'G'};
+
+/* Largest value the header can describe */
+#define COMPRESSION_MAX_LEN UINT32_MAX
+
+static void compression_write_header(char* out, int algorithm, size_t len) {
+    memcpy(out, compression_magic, sizeof(compression_magic));
+    out[3] = (char) algorithm;
+    out[4] = (char) (len & 0xff);
+    out[5] = (char) ((len >> 8) & 0xff);
+    out[6] = (char) ((len >> 16) & 0xff);
+    out[7] = (char) ((len >> 24) & 0xff);
+}
+
+bool valkey_glide_compression_available(zend_long algorithm) {
+    switch (algorithm) {
+        case VALKEY_GLIDE_COMPRESSION_NONE:
+            return true;
+#ifdef HAVE_VALKEY_GLIDE_LZ4
+        case VALKEY_GLIDE_COMPRESSION_LZ4:
+            return true;
+#endif
+#ifdef HAVE_VALKEY_GLIDE_ZSTD
+        case VALKEY_GLIDE_COMPRESSION_ZSTD:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+char* valkey_glide_compress(
+    int algorithm, int level, const char* value, size_t value_len, size_t* len) {
+    size_t bound, compressed_len = 0;
+    char*  out;
+
+    if (value_len <= VALKEY_GLIDE_COMPRESSION_HEADER_SIZE || value_len > COMPRESSION_MAX_LEN) {
+        return NULL;
+    }
+
+    switch (algorithm) {
+#ifdef HAVE_VALKEY_GLIDE_LZ4
+        case VALKEY_GLIDE_COMPRESSION_LZ4: {
+            int written;
+
+            if (value_len > LZ4_MAX_INPUT_SIZE) {
+                return NULL;
+            }
+            bound = (size_t) LZ4_compressBound((int) value_len);
+            out   = emalloc(VALKEY_GLIDE_COMPRESSION_HEADER_SIZE + bound);
+            /* Level 0 is the fast compressor, anything above selects the HC compressor */
+            if (level > 0) {
+                written = LZ4_compress_HC(value,
+                                          out + VALKEY_GLIDE_COMPRESSION_HEADER_SIZE,
+                                          (int) value_len,
+                                          (int) bound,
+                                          MIN(level, LZ4HC_CLEVEL_MAX));
+            } else {
+                written = LZ4_compress_default(value,
+                                               out + VALKEY_GLIDE_COMPRESSION_HEADER_SIZE,
+                                               (int) value_len,
+                                               (int) bound);
+            }
+            compressed_len = written > 0 ? (size_t) written : 0;
+            break;
+        }
+#endif
+
+#ifdef HAVE_VALKEY_GLIDE_ZSTD
+        case VALKEY_GLIDE_COMPRESSION_ZSTD: {
+            size_t written;
+
+            bound   = ZSTD_compressBound(value_len);
+            out     = emalloc(VALKEY_GLIDE_COMPRESSION_HEADER_SIZE + bound);
+            level   = level > 0 ? MIN(level, ZSTD_maxCLevel()) : ZSTD_CLEVEL_DEFAULT;
+            written = ZSTD_compress(
+                out + VALKEY_GLIDE_COMPRESSION_HEADER_SIZE, bound, value, value_len, level);
+            compressed_len = ZSTD_isError(written) ? 0 : written;
+            break;
+        }
+#endif
+
+        default:
+            (void) bound;
+            (void) level;
+            return NULL;
+    }
+
+    /* Not worth the header, or the library failed */
+    if (compressed_len == 0 ||
+        compressed_len + VALKEY_GLIDE_COMPRESSION_HEADER_SIZE >= value_len) {
+        efree(out);
+        return NULL;
+    }
+
+    compression_write_header(out, algorithm, value_len);
+    *len = VALKEY_GLIDE_COMPRESSION_HEADER_SIZE + compressed_len;
+    return out;
+}
+
+char* valkey_glide_decompress(const char* value, size_t value_len, size_t* len) {
+    const unsigned char* header = (const unsigned char*) value;
+    const char*          data   = value + VALKEY_GLIDE_COMPRESSION_HEADER_SIZE;
+    size_t               data_len, original_len;
+    char*                out;
+
+    if (value_len <= VALKEY_GLIDE_COMPRESSION_HEADER_SIZE ||
+        memcmp(header, compression_magic, sizeof(compression_magic)) != 0) {
+        return NULL;
+    }
+
+    data_len     = value_len - VALKEY_GLIDE_COMPRESSION_HEADER_SIZE;
+    original_len = (size_t) header[4] | (size_t) header[5] << 8 | (size_t) header[6] << 16 |
+                   (size_t) header[7] << 24;
+
+    switch (header[3]) {
+#ifdef HAVE_VALKEY_GLIDE_LZ4
+        case VALKEY_GLIDE_COMPRESSION_LZ4:
+            /* LZ4 cannot expand data more than 255 times, do not trust a larger length */
+            if (original_len > LZ4_MAX_INPUT_SIZE || data_len > INT_MAX ||
+                original_len / 255 > data_len) {
+                return NULL;
+            }
+            out = emalloc(original_len + 1);
+            if (LZ4_decompress_safe(data, out, (int) data_len, (int) original_len) !=
+                (int) original_len) {
+                efree(out);
+                return NULL;
+            }
+            break;
+#endif
+
+#ifdef HAVE_VALKEY_GLIDE_ZSTD
+        case VALKEY_GLIDE_COMPRESSION_ZSTD:
+            if (ZSTD_getFrameContentSize(data, data_len) != original_len) {
+                return NULL;
+            }
+            out = emalloc(original_len + 1);
+            if (ZSTD_decompress(out, original_len, data, data_len) != original_len) {
+                efree(out);
+                return NULL;
+            }
+            break;
+#endif
+
+        default:
+            /* An algorithm this build does not have, or not a header after all */
+            (void) data;
+            (void) data_len;
+            return NULL;
+    }
+
+    out[original_len] = '\0';
+    *len              = original_len;
+    return out;
+}
@@ -0,0 +1,45 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Value Compression                                       |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef VALKEY_GLIDE_COMPRESSION_H
+#define VALKEY_GLIDE_COMPRESSION_H
+
+#include "php.h"
+
+/*
+ * OPT_COMPRESSION: values are compressed after the serializer ran, and decompressed before it
+ * runs on the replies.
+ *
+ * A compressed value starts with an 8 byte header: the magic bytes 0xFE 'V' 'G', the
+ * VALKEY_GLIDE_COMPRESSION_* algorithm and the uncompressed length (32 bits, little endian).
+ * Values without the header are returned as they are, so compressed and plain values can be
+ * mixed while the option is rolled out, and a reader can take values written with another
+ * algorithm than its own.
+ */
+
+#define VALKEY_GLIDE_COMPRESSION_HEADER_SIZE 8
+
+/* Values shorter than this are not compressed unless OPT_COMPRESSION_MIN_SIZE says otherwise */
+#define VALKEY_GLIDE_COMPRESSION_DEFAULT_MIN_SIZE 256
+
+/* Whether this build can use a VALKEY_GLIDE_COMPRESSION_* */
+bool valkey_glide_compression_available(zend_long algorithm);
+
+/* Header and compressed data in an emalloc'ed buffer, NULL if the value does not get smaller */
+char* valkey_glide_compress(
+    int algorithm, int level, const char* value, size_t value_len, size_t* len);
+
+/* The uncompressed value in an emalloc'ed buffer, NULL if value is not a compressed value */
+char* valkey_glide_decompress(const char* value, size_t value_len, size_t* len);
+
+#endif /* VALKEY_GLIDE_COMPRESSION_H */
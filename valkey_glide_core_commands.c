@@ -26,15 +26,21 @@
 
 #include "command_response.h"
 #include "include/glide_bindings.h"
+#include "logger.h"
+#include "valkey_glide_args.h"
+#include "valkey_glide_cache.h"
 #include "valkey_glide_commands_common.h"
 #include "valkey_glide_core_common.h"
 #include "valkey_glide_list_common.h"
+#include "valkey_glide_options.h"
+#include "valkey_glide_pool.h"
+#include "valkey_glide_pubsub.h"
+#include "valkey_glide_shm_cache.h"
 
 extern zend_class_entry* ce;
 extern zend_class_entry* get_valkey_glide_exception_ce();
 
 /* Import the string conversion functions from command_response.c */
-extern char* long_to_string(long value, size_t* len);
 extern char* double_to_string(double value, size_t* len);
 
 /* Create a connection request in protobuf format. Made visible for testing. */
@@ -112,7 +118,21 @@ uint8_t* create_connection_request(const char*                               hos
         conn_req.connection_timeout = config->advanced_config->connection_timeout;
     }
 
+    /* Subscriptions established (and re-established after reconnects) by the core */
+    ConnectionRequest__PubSubSubscriptions* pubsub_subscriptions = NULL;
+    if (config->advanced_config && config->advanced_config->pubsub_subscriptions) {
+        pubsub_subscriptions =
+            valkey_glide_pubsub_build_subscriptions(config->advanced_config->pubsub_subscriptions);
+        conn_req.pubsub_subscriptions = pubsub_subscriptions;
+    }
+
     conn_req.lazy_connect = config->lazy_connect;
+
+    /* Cap the number of requests the core keeps in flight on this connection */
+    if (config->inflight_requests_limit > 0) {
+        conn_req.inflight_requests_limit = config->inflight_requests_limit;
+    }
+
     /* Map read_from configuration */
     if (config->read_from == VALKEY_GLIDE_READ_FROM_PREFER_REPLICA) {
         conn_req.read_from = CONNECTION_REQUEST__READ_FROM__PreferReplica;
@@ -173,22 +193,43 @@ uint8_t* create_connection_request(const char*                               hos
     /* Allocate memory for the serialized message */
     uint8_t* buffer = (uint8_t*) emalloc(*len);
     if (!buffer) {
+        valkey_glide_pubsub_free_subscriptions(pubsub_subscriptions);
         *len = 0;
         return NULL;
     }
 
     /* Serialize the message */
     connection_request__connection_request__pack(&conn_req, buffer);
+    valkey_glide_pubsub_free_subscriptions(pubsub_subscriptions);
 
     return buffer;
 }
 
-/* Create a Valkey Glide client or Cluster client using shared properties. */
-static const ConnectionResponse* create_base_glide_client(
-    valkey_glide_base_client_configuration_t* config,
-    int                                       database_id,
-    valkey_glide_periodic_checks_status_t     periodic_checks,
-    bool                                      is_cluster) {
+/* Create a Valkey Glide client from an already serialized connection request. */
+const ConnectionResponse* create_glide_client_from_request(const uint8_t* request_bytes,
+                                                          size_t         len) {
+    /* Set up client type for synchronous operation */
+    ClientType client_type;
+    client_type.tag = SyncClient;
+
+    /* Create the client */
+    const ConnectionResponse* conn_resp =
+        create_client(request_bytes, len, &client_type, valkey_glide_pubsub_callback);
+
+    /* Check if there was an error */
+    if (conn_resp->connection_error_message) {
+        VALKEY_LOG_ERROR("create_client", conn_resp->connection_error_message);
+    }
+
+    return conn_resp;
+}
+
+/* Connect a ValkeyGlide or ValkeyGlideCluster object using shared properties. */
+bool valkey_glide_connect(valkey_glide_object*                      valkey_glide,
+                          valkey_glide_base_client_configuration_t* config,
+                          int                                       database_id,
+                          valkey_glide_periodic_checks_status_t     periodic_checks,
+                          bool                                      is_cluster) {
     /* Create a connection request using first address or default */
     size_t      len;
     const char* default_host = "localhost";
@@ -198,38 +239,81 @@ static const ConnectionResponse* create_base_glide_client(
         default_host, default_port, &len, config, database_id, periodic_checks, is_cluster);
 
     if (!request_bytes) {
-        return NULL;
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), "Failed to create connection request", 0);
+        return false;
+    }
+
+    /* Connect-time subscriptions can deliver before create_client() returns */
+    zend_long pubsub_buffer_size =
+        config->advanced_config ? config->advanced_config->pubsub_buffer_size : 0;
+    valkey_glide_pubsub_begin_connect(
+        pubsub_buffer_size,
+        config->advanced_config && config->advanced_config->pubsub_subscriptions);
+
+    if (config->persistent_id) {
+        /* Borrow (or create) a client from the persistent pool. */
+        valkey_glide->glide_client = valkey_glide_pool_acquire(config->persistent_id,
+                                                               config->persistent_id_len,
+                                                               request_bytes,
+                                                               len,
+                                                               &valkey_glide->pool_entry);
+        valkey_glide->is_persistent = valkey_glide->glide_client != NULL;
+    } else {
+        const ConnectionResponse* conn_resp = create_glide_client_from_request(request_bytes, len);
+
+        if (conn_resp->connection_error_message) {
+            zend_throw_exception(
+                get_valkey_glide_exception_ce(), conn_resp->connection_error_message, 0);
+        } else {
+            valkey_glide->glide_client = conn_resp->conn_ptr;
+        }
+
+        free_connection_response((ConnectionResponse*) conn_resp);
     }
 
-    /* Set up client type for synchronous operation */
-    ClientType client_type;
-    client_type.tag = SyncClient;
+    valkey_glide->pubsub =
+        valkey_glide_pubsub_end_connect(valkey_glide->glide_client, pubsub_buffer_size);
 
-    /* Create the client */
-    const ConnectionResponse* conn_resp =
-        create_client(request_bytes, len, &client_type, NULL /* No PubSub callback */
-        );
+    if (!valkey_glide->glide_client) {
+        efree(request_bytes);
+        return false;
+    }
 
-    /* Free the request bytes as they're no longer needed */
-    efree(request_bytes);
+    /* A pooled client comes back on the database of its connection request */
+    valkey_glide->database          = !is_cluster && database_id >= 0 ? database_id : 0;
+    valkey_glide->selected_database = valkey_glide->database;
 
-    /* Check if there was an error */
-    if (conn_resp->connection_error_message) {
-        printf("Error creating client: %s\n", conn_resp->connection_error_message);
+    /* Secondary connections must not subscribe a second time; they have no message buffer. */
+    if (config->advanced_config && config->advanced_config->pubsub_subscriptions) {
+        HashTable* subscriptions = config->advanced_config->pubsub_subscriptions;
+
+        config->advanced_config->pubsub_subscriptions = NULL;
+        efree(request_bytes);
+        request_bytes = create_connection_request(
+            default_host, default_port, &len, config, database_id, periodic_checks, is_cluster);
+        config->advanced_config->pubsub_subscriptions = subscriptions;
     }
 
-    return conn_resp;
-}
+    /* Workers connected with the same settings share GET replies */
+    if (config->advanced_config && config->advanced_config->shared_cache_ttl &&
+        valkey_glide_shm_cache_enabled()) {
+        valkey_glide->shared_cache_ns  = valkey_glide_shm_cache_namespace(request_bytes, len);
+        valkey_glide->shared_cache_ttl = config->advanced_config->shared_cache_ttl;
+    }
 
-/* Create a Valkey Glide client */
-const ConnectionResponse* create_glide_client(valkey_glide_client_configuration_t* config) {
-    return create_base_glide_client(
-        &config->base, config->database_id, VALKEY_GLIDE_PERIODIC_CHECKS_DISABLED, false);
-}
+    /* Client-side caching needs the invalidations delivered through the push callback */
+    if (config->advanced_config && config->advanced_config->client_side_cache) {
+        valkey_glide->cache = valkey_glide_cache_create(
+            valkey_glide, config->advanced_config->client_side_cache, is_cluster);
+    }
+
+    /* Keep the request around so secondary connections (async mode) use the same settings. */
+    valkey_glide->connection_request      = request_bytes;
+    valkey_glide->connection_request_len  = len;
+    valkey_glide->inflight_requests_limit = config->inflight_requests_limit;
 
-const ConnectionResponse* create_glide_cluster_client(
-    valkey_glide_cluster_client_configuration_t* config) {
-    return create_base_glide_client(&config->base, 0, config->periodic_checks_status, true);
+    return true;
 }
 
 /* Custom result processor for SET commands with GET option support */
@@ -459,12 +543,11 @@ int execute_bitpos_command(zval* object, int argc, zval* return_value, zend_clas
 int execute_set_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
     valkey_glide_object* valkey_glide;
     zval *               z_value, *z_expire = NULL, *z_opts = NULL;
-    char *               key = NULL, *val = NULL;
-    size_t               key_len, val_len;
+    char*                key = NULL;
+    size_t               key_len;
     double               expire     = 0;
     zend_long            expire_int = 0;
     zval*  z_set_opts  = NULL; /* Will hold our options either from z_expire or z_opts */
-    int    free_val    = 0;    /* Flag to track if we need to free val */
     char*  old_val     = NULL; /* For storing GET response */
     size_t old_val_len = 0;
 
@@ -512,67 +595,16 @@ int execute_set_command(zval* object, int argc, zval* return_value, zend_class_e
         z_set_opts = z_opts;
     }
 
-    /* Convert value based on its type */
-    switch (Z_TYPE_P(z_value)) {
-        case IS_STRING:
-            /* It's already a string, use directly */
-            val     = Z_STRVAL_P(z_value);
-            val_len = Z_STRLEN_P(z_value);
-            break;
-        case IS_LONG:
-            /* Convert integer to string */
-            val      = long_to_string(Z_LVAL_P(z_value), &val_len);
-            free_val = 1;  // We'll need to free this
-            break;
-        case IS_DOUBLE:
-            /* Convert float to string */
-            val      = double_to_string(Z_DVAL_P(z_value), &val_len);
-            free_val = 1;  // We'll need to free this
-            break;
-        case IS_TRUE:
-            /* Convert boolean TRUE to "1" */
-            val      = estrdup("1");
-            val_len  = 1;
-            free_val = 1;
-            break;
-        case IS_FALSE:
-            /* Convert boolean FALSE to "0" */
-            val      = estrdup("0");
-            val_len  = 1;
-            free_val = 1;
-            break;
-        case IS_NULL:
-            /* Convert NULL to empty string */
-            val      = estrdup("");
-            val_len  = 0;
-            free_val = 1;
-            break;
-        default:
-            /* Unsupported type */
-            return 0;
-    }
-
-    /* Check if conversion succeeded */
-    if (!val) {
-        return 0;
-    }
-
     /* Execute the SET command using the internal helper function */
     int result = execute_set_command_internal(valkey_glide->glide_client,
                                               key,
                                               key_len,
-                                              val,
-                                              val_len,
+                                              z_value,
                                               expire_int,
                                               z_set_opts,
                                               &old_val,
                                               &old_val_len);
 
-    /* Free the allocated string if needed */
-    if (free_val) {
-        efree(val);
-    }
-
     /* Process the result */
     switch (result) {
         case 1: /* Success */
@@ -585,7 +617,8 @@ int execute_set_command(zval* object, int argc, zval* return_value, zend_class_e
             /* If GET option was used and old value was returned */
             if (old_val != NULL) {
                 /* Return the old value */
-                ZVAL_STRINGL(return_value, old_val, old_val_len);
+                valkey_glide_unserialize(
+                    valkey_glide_current_options(), old_val, old_val_len, return_value);
                 efree(old_val); /* Free the allocated old value */
                 return 1;
             }
@@ -603,8 +636,7 @@ int execute_set_command(zval* object, int argc, zval* return_value, zend_class_e
 int execute_set_command_internal(const void* glide_client,
                                  const char* key,
                                  size_t      key_len,
-                                 const char* val,
-                                 size_t      val_len,
+                                 zval*       value,
                                  long        expire,
                                  zval*       opts,
                                  char**      old_val,
@@ -616,11 +648,10 @@ int execute_set_command_internal(const void* glide_client,
     args.key_len             = key_len;
     args.raw_options         = opts;
 
-    /* Add value argument */
-    args.args[0].type                  = CORE_ARG_TYPE_STRING;
-    args.args[0].data.string_arg.value = val;
-    args.args[0].data.string_arg.len   = val_len;
-    args.arg_count                     = 1;
+    /* Add value argument, serialized when the command is prepared */
+    args.args[0].type                 = CORE_ARG_TYPE_VALUE;
+    args.args[0].data.value_arg.value = value;
+    args.arg_count                    = 1;
 
     /* Parse options */
     if (opts) {
@@ -645,14 +676,14 @@ int execute_set_command_internal(const void* glide_client,
 /* Execute a SETEX command using the Valkey Glide client - UNIFIED IMPLEMENTATION */
 int execute_setex_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
     valkey_glide_object* valkey_glide;
-    char *               key = NULL, *val = NULL;
-    size_t               key_len, val_len;
+    char*                key = NULL;
+    size_t               key_len;
     zend_long            expire;
+    zval*                z_value;
 
     /* Parse parameters */
     if (zend_parse_method_parameters(
-            argc, object, "Osls", &object, ce, &key, &key_len, &expire, &val, &val_len) ==
-        FAILURE) {
+            argc, object, "Oslz", &object, ce, &key, &key_len, &expire, &z_value) == FAILURE) {
         return 0;
     }
 
@@ -664,7 +695,7 @@ int execute_setex_command(zval* object, int argc, zval* return_value, zend_class
 
     /* Call execute_set_command_internal with expire in seconds (EX) and no special options */
     int result = execute_set_command_internal(
-        valkey_glide->glide_client, key, key_len, val, val_len, expire, NULL, NULL, NULL);
+        valkey_glide->glide_client, key, key_len, z_value, expire, NULL, NULL, NULL);
 
     if (result == 1) {
         ZVAL_TRUE(return_value);
@@ -678,14 +709,14 @@ int execute_setex_command(zval* object, int argc, zval* return_value, zend_class
 /* Execute a PSETEX command using the Valkey Glide client - UNIFIED IMPLEMENTATION */
 int execute_psetex_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
     valkey_glide_object* valkey_glide;
-    char *               key = NULL, *val = NULL;
-    size_t               key_len, val_len;
+    char*                key = NULL;
+    size_t               key_len;
     zend_long            expire;
+    zval*                z_value;
 
     /* Parse parameters */
     if (zend_parse_method_parameters(
-            argc, object, "Osls", &object, ce, &key, &key_len, &expire, &val, &val_len) ==
-        FAILURE) {
+            argc, object, "Oslz", &object, ce, &key, &key_len, &expire, &z_value) == FAILURE) {
         return 0;
     }
 
@@ -704,7 +735,7 @@ int execute_psetex_command(zval* object, int argc, zval* return_value, zend_clas
 
     /* Call execute_set_command_internal with the PX option */
     int result = execute_set_command_internal(
-        valkey_glide->glide_client, key, key_len, val, val_len, 0, &options, NULL, NULL);
+        valkey_glide->glide_client, key, key_len, z_value, 0, &options, NULL, NULL);
 
     /* Clean up options array */
     zval_dtor(&options);
@@ -721,12 +752,13 @@ int execute_psetex_command(zval* object, int argc, zval* return_value, zend_clas
 /* Execute a SETNX command using the Valkey Glide client - UNIFIED IMPLEMENTATION */
 int execute_setnx_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
     valkey_glide_object* valkey_glide;
-    char *               key = NULL, *val = NULL;
-    size_t               key_len, val_len;
+    char*                key = NULL;
+    size_t               key_len;
+    zval*                z_value;
 
     /* Parse parameters */
-    if (zend_parse_method_parameters(
-            argc, object, "Oss", &object, ce, &key, &key_len, &val, &val_len) == FAILURE) {
+    if (zend_parse_method_parameters(argc, object, "Osz", &object, ce, &key, &key_len, &z_value) ==
+        FAILURE) {
         return 0;
     }
 
@@ -747,7 +779,7 @@ int execute_setnx_command(zval* object, int argc, zval* return_value, zend_class
 
     /* Call execute_set_command_internal with the NX option and no expiration */
     int result = execute_set_command_internal(
-        valkey_glide->glide_client, key, key_len, val, val_len, 0, &options, NULL, NULL);
+        valkey_glide->glide_client, key, key_len, z_value, 0, &options, NULL, NULL);
 
     /* Clean up options array */
     zval_dtor(&options);
@@ -767,6 +799,9 @@ void close_glide_client(const void* glide_client) {
     if (!glide_client) {
         return;
     }
+    /* Stop routing push messages to the client before it goes away */
+    valkey_glide_pubsub_unregister(glide_client);
+
     /* Close the client using the close_client function from glide_bindings.h */
     close_client(glide_client);
 }
@@ -988,50 +1023,45 @@ static void valkey_glide_parse_info_response(char* response, zval* z_ret) {
         } while ((p1 = php_strtok_r(NULL, _NL, &s1)) != NULL);
     }
 }
-static int parse_info_multi_node_response(CommandResult* cmd_result, zval* return_value) {
-    int result = 0;
-    if (cmd_result && cmd_result->response) {
-        zval temp_result;
-        if (command_response_to_zval(
-                cmd_result->response, &temp_result, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false)) {
-            if (Z_TYPE(temp_result) == IS_ARRAY) {
-                /* AllNodes routing - array of responses */
-                array_init(return_value);
-                HashTable* ht = Z_ARRVAL(temp_result);
-                zval*      entry;
-                int        index        = 0;
-                char*      current_node = NULL;
-                int        current_port = 0;
-
-                ZEND_HASH_FOREACH_VAL(ht, entry) {
-                    if (Z_TYPE_P(entry) == IS_STRING) {
-                        zval parsed_info;
-                        valkey_glide_parse_info_response(Z_STRVAL_P(entry), &parsed_info);
-                        add_next_index_zval(return_value, &parsed_info);
-                    }
-                }
-                ZEND_HASH_FOREACH_END();
-                result = 1;
-            } else if (Z_TYPE(temp_result) == IS_STRING) {
-                /* Single node response */
-                valkey_glide_parse_info_response(Z_STRVAL(temp_result), return_value);
-                result = 1;
+
+int valkey_glide_info_to_zval(CommandResponse* response, zval* return_value) {
+    zval reply;
+    int  result = 0;
+
+    if (!response ||
+        !command_response_to_zval(response, &reply, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false)) {
+        return 0;
+    }
+    if (Z_TYPE(reply) == IS_ARRAY) {
+        /* AllNodes routing - array of responses */
+        zval* entry;
+
+        array_init(return_value);
+        ZEND_HASH_FOREACH_VAL(Z_ARRVAL(reply), entry) {
+            if (Z_TYPE_P(entry) == IS_STRING) {
+                zval parsed_info;
+                valkey_glide_parse_info_response(Z_STRVAL_P(entry), &parsed_info);
+                add_next_index_zval(return_value, &parsed_info);
             }
-            zval_dtor(&temp_result);
         }
-    }
-    free_command_result(cmd_result);
+        ZEND_HASH_FOREACH_END();
+        result = 1;
+    } else if (Z_TYPE(reply) == IS_STRING) {
+        /* Single node response */
+        valkey_glide_parse_info_response(Z_STRVAL(reply), return_value);
+        result = 1;
+    }
+    zval_dtor(&reply);
     return result;
 }
+
 /* Execute an INFO command using the Valkey Glide client - UNIFIED IMPLEMENTATION */
 int execute_info_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
     valkey_glide_object* valkey_glide;
-    zval*                args         = NULL;
-    int                  args_count   = 0;
-    char*                response     = NULL;
-    size_t               response_len = 0;
-    int                  result       = 0;
-    zend_bool            is_cluster   = (ce == get_valkey_glide_cluster_ce());
+    zval*                args       = NULL;
+    int                  args_count = 0;
+    int                  result     = 0;
+    zend_bool            is_cluster = (ce == get_valkey_glide_cluster_ce());
 
     /* Get ValkeyGlide object */
     valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
@@ -1045,186 +1075,33 @@ int execute_info_command(zval* object, int argc, zval* return_value, zend_class_
         return 0;
     }
 
-    /* Setup core command arguments */
-    core_command_args_t core_args = {0};
-    core_args.glide_client        = valkey_glide->glide_client;
-    core_args.cmd_type            = Info;
-    core_args.is_cluster          = is_cluster;
-
-    if (is_cluster) {
-        if (args_count == 0) {
-            /* Need at least the route parameter */
-            return 0;
-        }
-
-        /* If no sections are specified, call with NULL section */
-        if (args_count == 1) {
-            CommandResult* cmd_result;
-
-            /* Execute the command with the route bytes */
-            cmd_result = execute_command_with_route(
-                valkey_glide->glide_client, Info, 0, NULL, NULL, &args[0]);
-
-            /* Use command_response_to_zval to handle both single and array responses */
-            result = parse_info_multi_node_response(cmd_result, return_value);
-            /* If we processed the result above, return early */
-            if (result == 1) {
-                return 1;
-            }
-        } else {
-            /* One or more sections specified */
-            unsigned long  arg_count = args_count - 1; /* Subtract 1 for route parameter */
-            uintptr_t*     cmd_args  = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-            unsigned long* cmd_args_len =
-                (unsigned long*) emalloc(arg_count * sizeof(unsigned long));
-
-            if (!cmd_args || !cmd_args_len) {
-                if (cmd_args)
-                    efree(cmd_args);
-                if (cmd_args_len)
-                    efree(cmd_args_len);
-
-                return 0;
-            }
-
-            /* Process each section argument (start from index 1, after route) */
-            for (int i = 1; i < args_count; i++) {
-                zval* section = &args[i];
-                int   arg_idx = i - 1;
-
-                /* Check if the section is a string */
-                if (Z_TYPE_P(section) != IS_STRING) {
-                    /* Convert to string if needed */
-                    zval temp;
-                    ZVAL_COPY(&temp, section);
-                    convert_to_string(&temp);
-
-                    cmd_args[arg_idx]     = (uintptr_t) Z_STRVAL(temp);
-                    cmd_args_len[arg_idx] = Z_STRLEN(temp);
-
-                    /* Free the temporary zval */
-                    zval_dtor(&temp);
-                } else {
-                    /* It's already a string */
-                    cmd_args[arg_idx]     = (uintptr_t) Z_STRVAL_P(section);
-                    cmd_args_len[arg_idx] = Z_STRLEN_P(section);
-                }
-            }
-
-            /* Execute the command with the route information */
-            CommandResult* cmd_result = execute_command_with_route(valkey_glide->glide_client,
-                                                                   Info,
-                                                                   arg_count,
-                                                                   cmd_args,
-                                                                   cmd_args_len,
-                                                                   &args[0]); /* Route parameter */
-
-            /* Free the argument arrays */
-            efree(cmd_args);
-            efree(cmd_args_len);
-
-            /* Use the generic handler to process the result */
-            /* Use command_response_to_zval to handle both single and array responses */
-            result = parse_info_multi_node_response(cmd_result, return_value);
-            /* If we processed the result above, return early */
-            if (result == 1) {
-                return 1;
-            }
-        }
-    } else {
-        /* Non-cluster case - parse parameters as before */
-        if (zend_parse_method_parameters(argc, object, "O*", &object, ce, &args, &args_count) ==
-            FAILURE) {
-            return 0;
-        }
-
-        /* Handle different cases based on number of arguments */
-        if (args_count == 0) {
-            /* No sections specified, call with NULL section */
-            CommandResult* cmd_result = execute_command(valkey_glide->glide_client,
-                                                        Info, /* command type */
-                                                        0,    /* number of arguments */
-                                                        NULL, /* arguments */
-                                                        NULL  /* argument lengths */
-
-            );
-
-            /* Use the generic handler to process the result */
-            result = handle_string_response(cmd_result, &response, &response_len);
-        } else {
-            /* One or more sections specified */
-            unsigned long  arg_count = args_count;
-            uintptr_t*     cmd_args  = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-            unsigned long* cmd_args_len =
-                (unsigned long*) emalloc(arg_count * sizeof(unsigned long));
-
-            if (!cmd_args || !cmd_args_len) {
-                if (cmd_args)
-                    efree(cmd_args);
-                if (cmd_args_len)
-                    efree(cmd_args_len);
-                return 0;
-            }
-
-            /* Process each section argument */
-            for (int i = 0; i < args_count; i++) {
-                zval* section = &args[i];
-
-                /* Check if the section is a string */
-                if (Z_TYPE_P(section) != IS_STRING) {
-                    /* Convert to string if needed */
-                    zval temp;
-                    ZVAL_COPY(&temp, section);
-                    convert_to_string(&temp);
-
-                    cmd_args[i]     = (uintptr_t) Z_STRVAL(temp);
-                    cmd_args_len[i] = Z_STRLEN(temp);
-
-                    /* Free the temporary zval */
-                    zval_dtor(&temp);
-                } else {
-                    /* It's already a string */
-                    cmd_args[i]     = (uintptr_t) Z_STRVAL_P(section);
-                    cmd_args_len[i] = Z_STRLEN_P(section);
-                }
-            }
-
-            /* Execute the command */
-            CommandResult* cmd_result = execute_command(valkey_glide->glide_client,
-                                                        Info,        /* command type */
-                                                        arg_count,   /* number of arguments */
-                                                        cmd_args,    /* arguments */
-                                                        cmd_args_len /* argument lengths */
-
-            );
-
-            /* Free the argument arrays */
-            efree(cmd_args);
-            efree(cmd_args_len);
-
-            /* Use the generic handler to process the result */
-            result = handle_string_response(cmd_result, &response, &response_len);
-        }
+    /* In a cluster the route comes first */
+    if (is_cluster && args_count == 0) {
+        return 0;
     }
 
-    /* Process the result */
-    if (result == 1 && response != NULL) {
-        zval z_ret;
-        ZVAL_UNDEF(&z_ret);
+    /* [section ...] */
+    valkey_glide_args cmd_args;
 
-        /* Parse the INFO response into a zval array */
-        valkey_glide_parse_info_response(response, &z_ret);
+    valkey_glide_args_init(&cmd_args);
+    for (int i = is_cluster ? 1 : 0; i < args_count; i++) {
+        valkey_glide_args_add_zval(&cmd_args, &args[i]);
+    }
 
-        /* Free the response string */
-        efree(response);
+    CommandResult* cmd_result = valkey_glide_args_execute(
+        valkey_glide->glide_client, Info, &cmd_args, is_cluster ? &args[0] : NULL);
+    valkey_glide_args_free(&cmd_args);
 
-        /* Return the parsed array */
-        ZVAL_COPY_VALUE(return_value, &z_ret);
-        return 1;
+    if (!cmd_result) {
+        return 0;
     }
 
-    /* Error or empty response */
-    return 0;
+    /* One reply, or one per node in a cluster */
+    if (!cmd_result->command_error) {
+        result = valkey_glide_info_to_zval(cmd_result->response, return_value);
+    }
+    free_command_result(cmd_result);
+    return result;
 }
 
 /* Execute a GET command using the Valkey Glide client - UNIFIED IMPLEMENTATION */
@@ -1232,8 +1109,6 @@ int execute_get_command(zval* object, int argc, zval* return_value, zend_class_e
     valkey_glide_object* valkey_glide;
     char*                key = NULL;
     size_t               key_len;
-    char*                response     = NULL;
-    size_t               response_len = 0;
 
     /* Parse parameters */
     if (zend_parse_method_parameters(argc, object, "Os", &object, ce, &key, &key_len) == FAILURE) {
@@ -1253,21 +1128,9 @@ int execute_get_command(zval* object, int argc, zval* return_value, zend_class_e
     args.key                 = key;
     args.key_len             = key_len;
 
-    /* Use string result processor */
-    struct {
-        char**  result;
-        size_t* result_len;
-    } output = {&response, &response_len};
-
-    if (execute_core_command(&args, &output, process_core_string_result)) {
-        if (response != NULL) {
-            ZVAL_STRINGL(return_value, response, response_len);
-            efree(response);
-            return 1;
-        } else {
-            ZVAL_FALSE(return_value);
-            return 1;
-        }
+    /* Use value result processor */
+    if (execute_core_command(&args, return_value, process_core_value_result)) {
+        return 1;
     }
 
     return 0;
@@ -1720,14 +1583,15 @@ int execute_pttl_command(zval* object, int argc, zval* return_value, zend_class_
 /* Execute a GETSET command using the Valkey Glide client - UNIFIED IMPLEMENTATION */
 int execute_getset_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
     valkey_glide_object* valkey_glide;
-    char *               key = NULL, *val = NULL;
-    size_t               key_len, val_len;
+    char*                key = NULL;
+    size_t               key_len;
+    zval*                z_value;
     char*                response     = NULL;
     size_t               response_len = 0;
 
     /* Parse parameters */
-    if (zend_parse_method_parameters(
-            argc, object, "Oss", &object, ce, &key, &key_len, &val, &val_len) == FAILURE) {
+    if (zend_parse_method_parameters(argc, object, "Osz", &object, ce, &key, &key_len, &z_value) ==
+        FAILURE) {
         return 0;
     }
 
@@ -1746,8 +1610,7 @@ int execute_getset_command(zval* object, int argc, zval* return_value, zend_clas
     int result = execute_set_command_internal(valkey_glide->glide_client,
                                               key,
                                               key_len,
-                                              val,
-                                              val_len,
+                                              z_value,
                                               0,       /* No expiry */
                                               &z_opts, /* Use GET option */
                                               &response,
@@ -1759,7 +1622,8 @@ int execute_getset_command(zval* object, int argc, zval* return_value, zend_clas
     /* Process the result */
     if ((result == 1 || result == 2) && response != NULL) {
         /* Return the old value */
-        ZVAL_STRINGL(return_value, response, response_len);
+        valkey_glide_unserialize(
+            valkey_glide_current_options(), response, response_len, return_value);
         efree(response);
         return 1;
     } else if (result == 0 || (result == 2 && response == NULL)) {
@@ -1804,19 +1668,10 @@ int execute_lcs_command(zval* object, int argc, zval* return_value, zend_class_e
         return 0;
     }
 
-    /* Prepare command arguments */
-    unsigned long arg_count = 2; /* key1 + key2 */
-    uintptr_t
-        args[7]; /* Maximum 7 arguments: key1, key2, LEN, IDX, MINMATCHLEN, value, WITHMATCHLEN */
-    unsigned long args_len[7];
-
-    /* First argument: key1 */
-    args[0]     = (uintptr_t) key1;
-    args_len[0] = key1_len;
-
-    /* Second argument: key2 */
-    args[1]     = (uintptr_t) key2;
-    args_len[1] = key2_len;
+    valkey_glide_args cmd_args;
+    valkey_glide_args_init(&cmd_args);
+    valkey_glide_args_add_key(&cmd_args, key1, key1_len);
+    valkey_glide_args_add_key(&cmd_args, key2, key2_len);
 
     /* Parse options and flags */
     int  has_len           = 0;
@@ -1866,51 +1721,23 @@ int execute_lcs_command(zval* object, int argc, zval* return_value, zend_class_e
         }
     }
 
-    /* Add LEN option if specified */
     if (has_len) {
-        args[arg_count]     = (uintptr_t) "LEN";
-        args_len[arg_count] = 3;
-        arg_count++;
+        valkey_glide_args_add_literal(&cmd_args, "LEN");
     }
-
-    /* Add IDX option if specified */
     if (has_idx) {
-        args[arg_count]     = (uintptr_t) "IDX";
-        args_len[arg_count] = 3;
-        arg_count++;
+        valkey_glide_args_add_literal(&cmd_args, "IDX");
     }
-
-    /* Add MINMATCHLEN option if specified */
     if (has_minmatchlen) {
-        args[arg_count]     = (uintptr_t) "MINMATCHLEN";
-        args_len[arg_count] = 11;
-        arg_count++;
-
-        /* Add the minmatchlen value */
-        size_t minmatchlen_len;
-        char*  minmatchlen_str = long_to_string(minmatchlen_value, &minmatchlen_len);
-        if (!minmatchlen_str) {
-            return 0;
-        }
-        args[arg_count]     = (uintptr_t) minmatchlen_str;
-        args_len[arg_count] = minmatchlen_len;
-        arg_count++;
+        valkey_glide_args_add_literal(&cmd_args, "MINMATCHLEN");
+        valkey_glide_args_add_long(&cmd_args, minmatchlen_value);
     }
-
-    /* Add WITHMATCHLEN option if specified */
     if (has_withmatchlen) {
-        args[arg_count]     = (uintptr_t) "WITHMATCHLEN";
-        args_len[arg_count] = 12;
-        arg_count++;
+        valkey_glide_args_add_literal(&cmd_args, "WITHMATCHLEN");
     }
 
-    /* Execute the command */
-    CommandResult* cmd_result = execute_command(valkey_glide->glide_client,
-                                                LCS,       /* command type */
-                                                arg_count, /* number of arguments */
-                                                args,      /* arguments */
-                                                args_len   /* argument lengths */
-    );
+    CommandResult* cmd_result =
+        valkey_glide_args_execute(valkey_glide->glide_client, LCS, &cmd_args, NULL);
+    valkey_glide_args_free(&cmd_args);
 
     /* Check if the command was successful */
     if (!cmd_result) {
@@ -1947,7 +1774,6 @@ int execute_lcs_command(zval* object, int argc, zval* return_value, zend_class_e
                     return ret_val; /* handle_map_response already frees cmd_result */
 
                 default:
-                    printf("default response\n");
                     /* Unsupported response type */
                     ret_val = 0;
                     break;
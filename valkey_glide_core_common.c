@@ -20,6 +20,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "valkey_glide_arena.h"
+#include "valkey_glide_options.h"
+#include "valkey_glide_result.h"
+
 /* ====================================================================
  * CORE FRAMEWORK IMPLEMENTATION
  * ==================================================================== */
@@ -35,38 +39,29 @@ int execute_core_command(core_command_args_t*    args,
         return 0;
     }
 
-    uintptr_t*     cmd_args          = NULL;
-    unsigned long* cmd_args_len      = NULL;
-    char**         allocated_strings = NULL;
-    int            allocated_count   = 0;
-    int            arg_count         = 0;
-    int            res               = 0;
-    CommandResult* result            = NULL;
+    int                res    = 0;
+    CommandResult*     result = NULL;
+    valkey_glide_args  cmd_args;
+    valkey_glide_arena arena;
+
+    valkey_glide_arena_enter(&arena);
+    valkey_glide_args_init(&cmd_args);
 
     debug_print_core_args(args);
 
     /* Prepare command arguments based on command type */
-    arg_count =
-        prepare_core_args(args, &cmd_args, &cmd_args_len, &allocated_strings, &allocated_count);
-
-    if (arg_count < 0) {
+    if (prepare_core_args(args, &cmd_args) < 0) {
+        /* A value that cannot be serialized */
+        valkey_glide_args_free(&cmd_args);
+        valkey_glide_arena_leave(&arena);
         return 0;
     }
 
     /* Execute the command - use routing if cluster mode and route provided */
-    if (args->has_route && args->route_param) {
-        /* Cluster mode with routing */
-        result = execute_command_with_route(args->glide_client,
-                                            args->cmd_type,
-                                            arg_count,
-                                            cmd_args,
-                                            cmd_args_len,
-                                            args->route_param);
-    } else {
-        /* Non-cluster mode or no routing */
-        result =
-            execute_command(args->glide_client, args->cmd_type, arg_count, cmd_args, cmd_args_len);
-    }
+    result = valkey_glide_args_execute(args->glide_client,
+                                       args->cmd_type,
+                                       &cmd_args,
+                                       args->has_route ? args->route_param : NULL);
 
     debug_print_command_result(result);
 
@@ -83,7 +78,8 @@ int execute_core_command(core_command_args_t*    args,
     }
 
     /* Cleanup */
-    free_core_args(cmd_args, cmd_args_len, allocated_strings, allocated_count);
+    valkey_glide_args_free(&cmd_args);
+    valkey_glide_arena_leave(&arena);
 
     return res;
 }
@@ -91,11 +87,7 @@ int execute_core_command(core_command_args_t*    args,
 /**
  * Prepare command arguments based on command type and structure
  */
-int prepare_core_args(core_command_args_t* args,
-                      uintptr_t**          cmd_args,
-                      unsigned long**      cmd_args_len,
-                      char***              allocated_strings,
-                      int*                 allocated_count) {
+int prepare_core_args(core_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args) {
         return 0;
     }
@@ -109,7 +101,7 @@ int prepare_core_args(core_command_args_t* args,
         case Time:
         case Role:
         case DBSize:
-            return prepare_zero_args(args, cmd_args, cmd_args_len);
+            return prepare_zero_args(args, cmd_args);
 
         /* Single key operations */
         case GetDel:
@@ -122,16 +114,15 @@ int prepare_core_args(core_command_args_t* args,
         case PExpireTime:
         case Persist:
         case Dump:
-            return prepare_key_only_args(args, cmd_args, cmd_args_len);
+            return prepare_key_only_args(args, cmd_args);
 
         /* Pattern-based operations */
         case Keys:
-            return prepare_message_args(
-                args, cmd_args, cmd_args_len, allocated_strings, allocated_count);
+            return prepare_message_args(args, cmd_args);
 
         /* Zero-argument operations */
         case UnWatch:
-            return prepare_zero_args(args, cmd_args, cmd_args_len);
+            return prepare_zero_args(args, cmd_args);
 
         /* Key-value operations */
         case Set:
@@ -152,8 +143,7 @@ int prepare_core_args(core_command_args_t* args,
         case IncrByFloat:
         case Move:
         case Copy:
-            return prepare_key_value_args(
-                args, cmd_args, cmd_args_len, allocated_strings, allocated_count);
+            return prepare_key_value_args(args, cmd_args);
 
         /* DEL and UNLINK: Support both single-key and multi-key operations */
         case Del:
@@ -162,11 +152,11 @@ int prepare_core_args(core_command_args_t* args,
             if (args->key && args->key_len > 0 && args->arg_count == 0) {
                 /* Single key: DEL key */
 
-                return prepare_key_only_args(args, cmd_args, cmd_args_len);
+                return prepare_key_only_args(args, cmd_args);
             } else if (args->arg_count > 0 && args->args[0].type == CORE_ARG_TYPE_ARRAY) {
                 /* Multi-key: DEL key1 key2 key3 */
 
-                return prepare_multi_key_args(args, cmd_args, cmd_args_len);
+                return prepare_multi_key_args(args, cmd_args);
             }
             return 0;
 
@@ -175,25 +165,24 @@ int prepare_core_args(core_command_args_t* args,
         case Touch:
         case MGet:
         case Watch:
-            return prepare_multi_key_args(args, cmd_args, cmd_args_len);
+            return prepare_multi_key_args(args, cmd_args);
 
         /* PFCOUNT: Support both single-key and multi-key operations */
         case PfCount:
             /* Check if single key or multi-key operation */
             if (args->key && args->key_len > 0 && args->arg_count == 0) {
                 /* Single key: PFCOUNT key */
-                return prepare_key_only_args(args, cmd_args, cmd_args_len);
+                return prepare_key_only_args(args, cmd_args);
             } else if (args->arg_count > 0 && args->args[0].type == CORE_ARG_TYPE_ARRAY) {
                 /* Multi-key: PFCOUNT key1 key2 key3 */
-                return prepare_multi_key_args(args, cmd_args, cmd_args_len);
+                return prepare_multi_key_args(args, cmd_args);
             }
             return 0;
 
         /* HyperLogLog operations */
         case PfAdd:
         case PfMerge:
-            return prepare_key_value_args(
-                args, cmd_args, cmd_args_len, allocated_strings, allocated_count);
+            return prepare_key_value_args(args, cmd_args);
 
         /* Bit operations */
         case BitCount:
@@ -201,22 +190,19 @@ int prepare_core_args(core_command_args_t* args,
         case GetBit:
         case SetBit:
         case BitOp:
-            return prepare_bit_operation_args(
-                args, cmd_args, cmd_args_len, allocated_strings, allocated_count);
+            return prepare_bit_operation_args(args, cmd_args);
 
         /* Expire operations */
         case Expire:
         case ExpireAt:
         case PExpire:
         case PExpireAt:
-            return prepare_expire_args(
-                args, cmd_args, cmd_args_len, allocated_strings, allocated_count);
+            return prepare_expire_args(args, cmd_args);
 
         /* Range operations */
         case GetRange:
         case SetRange:
-            return prepare_range_args(
-                args, cmd_args, cmd_args_len, allocated_strings, allocated_count);
+            return prepare_range_args(args, cmd_args);
 
         /* Message operations (no key, just arguments) */
         case Ping:
@@ -226,428 +212,202 @@ int prepare_core_args(core_command_args_t* args,
         case FlushAll:
         case Select:
         case SwapDb:
-            return prepare_message_args(
-                args, cmd_args, cmd_args_len, allocated_strings, allocated_count);
+            return prepare_message_args(args, cmd_args);
 
         /* Key-value pair operations */
         case MSet:
         case MSetNX:
-            return prepare_key_value_pairs_args(
-                args, cmd_args, cmd_args_len, allocated_strings, allocated_count);
+            return prepare_key_value_pairs_args(args, cmd_args);
 
         default:
             return 0;
     }
 }
 
+/* ====================================================================
+ * ARGUMENT PREPARATION HELPERS
+ * ==================================================================== */
+
 /**
- * Free all allocated command arguments and strings
+ * Whether the argument at index is a key, which takes OPT_PREFIX. The primary key always is.
  */
-void free_core_args(uintptr_t*     cmd_args,
-                    unsigned long* cmd_args_len,
-                    char**         allocated_strings,
-                    int            allocated_count) {
-    if (cmd_args) {
-        efree(cmd_args);
-    }
-    if (cmd_args_len) {
-        efree(cmd_args_len);
-    }
-    if (allocated_strings) {
-        free_tracked_strings(allocated_strings, allocated_count);
-        efree(allocated_strings);
+static bool core_arg_is_key(core_command_args_t* args, int index) {
+    switch (args->cmd_type) {
+        case Rename:
+        case RenameNX:
+        case Copy:
+            /* The destination key */
+            return index == 0;
+        case BitOp:
+            /* The source keys follow the operation */
+            return index > 0;
+        case PfMerge:
+            /* The source keys */
+            return true;
+        default:
+            return false;
     }
 }
 
-/* ====================================================================
- * ARGUMENT PREPARATION HELPERS
- * ==================================================================== */
+/**
+ * Add one flexible argument, expanding arrays and multi-strings. Returns false when a value
+ * cannot be converted or serialized.
+ */
+static bool core_add_arg(valkey_glide_args* cmd_args, core_arg_t* arg, bool is_key) {
+    zval* element;
+
+    switch (arg->type) {
+        case CORE_ARG_TYPE_STRING:
+            if (is_key) {
+                valkey_glide_args_add_key(
+                    cmd_args, arg->data.string_arg.value, arg->data.string_arg.len);
+            } else {
+                valkey_glide_args_add(
+                    cmd_args, arg->data.string_arg.value, arg->data.string_arg.len);
+            }
+            return true;
+
+        case CORE_ARG_TYPE_LONG:
+            valkey_glide_args_add_long(cmd_args, arg->data.long_arg.value);
+            return true;
+
+        case CORE_ARG_TYPE_DOUBLE:
+            valkey_glide_args_add_double(cmd_args, arg->data.double_arg.value);
+            return true;
+
+        case CORE_ARG_TYPE_VALUE:
+            /* Serialized straight into the argument vector */
+            return valkey_glide_args_add_value(cmd_args, arg->data.value_arg.value);
+
+        case CORE_ARG_TYPE_MULTI_STRING:
+            for (int j = 0; j < arg->data.multi_string_arg.count; j++) {
+                valkey_glide_args_add(cmd_args,
+                                      arg->data.multi_string_arg.values[j],
+                                      arg->data.multi_string_arg.lengths[j]);
+            }
+            return true;
+
+        case CORE_ARG_TYPE_ARRAY:
+            /* Expand array elements into individual arguments */
+            if (Z_TYPE_P(arg->data.array_arg.array) != IS_ARRAY) {
+                return true;
+            }
+            ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(arg->data.array_arg.array), element) {
+                if (!(is_key ? valkey_glide_args_add_key_zval(cmd_args, element)
+                             : valkey_glide_args_add_zval(cmd_args, element))) {
+                    return false;
+                }
+            }
+            ZEND_HASH_FOREACH_END();
+            return true;
+
+        default:
+            return true;
+    }
+}
 
 /**
  * Prepare arguments for zero-argument operations (RANDOMKEY, etc.)
  */
-int prepare_zero_args(core_command_args_t* args,
-                      uintptr_t**          cmd_args,
-                      unsigned long**      cmd_args_len) {
+int prepare_zero_args(core_command_args_t* args, valkey_glide_args* cmd_args) {
     /* No arguments needed - just return 0 to indicate success but no args */
-    *cmd_args     = NULL;
-    *cmd_args_len = NULL;
     return 0; /* Zero arguments */
 }
 
 /**
  * Prepare arguments for single key operations
  */
-int prepare_key_only_args(core_command_args_t* args,
-                          uintptr_t**          cmd_args,
-                          unsigned long**      cmd_args_len) {
+int prepare_key_only_args(core_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->key || args->key_len == 0) {
         return 0;
     }
 
-    if (!allocate_core_arg_arrays(1, cmd_args, cmd_args_len)) {
-        return 0;
-    }
-
-    (*cmd_args)[0]     = (uintptr_t) args->key;
-    (*cmd_args_len)[0] = args->key_len;
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
 
-    return 1;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for key-value operations
  */
-int prepare_key_value_args(core_command_args_t* args,
-                           uintptr_t**          cmd_args,
-                           unsigned long**      cmd_args_len,
-                           char***              allocated_strings,
-                           int*                 allocated_count) {
+int prepare_key_value_args(core_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->key || args->key_len == 0) {
         return 0;
     }
-    /* Calculate total argument count */
-    int total_args = 1; /* key */
-
-    /* Add primary arguments */
-    for (int i = 0; i < args->arg_count; i++) {
-        switch (args->args[i].type) {
-            case CORE_ARG_TYPE_STRING:
-            case CORE_ARG_TYPE_LONG:
-            case CORE_ARG_TYPE_DOUBLE:
-                total_args++;
-                break;
-            case CORE_ARG_TYPE_MULTI_STRING:
-                total_args += args->args[i].data.multi_string_arg.count;
-                break;
-            case CORE_ARG_TYPE_ARRAY:
-                /* Count elements in the array */
-                total_args += args->args[i].data.array_arg.count;
-                break;
-            default:
-                break;
-        }
-    }
-
-    /* Add option arguments */
-    if (args->options.has_expire) {
-        total_args += 2; /* EX/PX/EXAT/PXAT + value */
-    }
-    if (args->options.nx) {
-        total_args++; /* NX */
-    }
-    if (args->options.xx) {
-        total_args++; /* XX */
-    }
-    if (args->options.get_old_value) {
-        total_args++; /* GET */
-    }
-    if (args->options.keep_ttl) {
-        total_args++; /* KEEPTTL */
-    }
-    if (args->options.has_ifeq) {
-        total_args += 2; /* IFEQ + value */
-    }
-    if (args->options.persist) {
-        total_args++; /* PERSIST */
-    }
-
-    if (!allocate_core_arg_arrays(total_args, cmd_args, cmd_args_len)) {
-        return 0;
-    }
-
-    /* Initialize string tracking */
-    *allocated_strings = create_string_tracker(total_args);
-    *allocated_count   = 0;
-
-    int arg_idx = 0;
 
     /* Add key */
-    (*cmd_args)[arg_idx]     = (uintptr_t) args->key;
-    (*cmd_args_len)[arg_idx] = args->key_len;
-    arg_idx++;
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
 
     /* Add primary arguments */
     for (int i = 0; i < args->arg_count; i++) {
-        switch (args->args[i].type) {
-            case CORE_ARG_TYPE_STRING:
-                (*cmd_args)[arg_idx]     = (uintptr_t) args->args[i].data.string_arg.value;
-                (*cmd_args_len)[arg_idx] = args->args[i].data.string_arg.len;
-                arg_idx++;
-                break;
-
-            case CORE_ARG_TYPE_LONG: {
-                size_t len;
-                char*  str = core_long_to_string(args->args[i].data.long_arg.value, &len);
-                if (str) {
-                    (*cmd_args)[arg_idx]     = (uintptr_t) str;
-                    (*cmd_args_len)[arg_idx] = len;
-                    add_tracked_string(*allocated_strings, allocated_count, str);
-                    arg_idx++;
-                }
-                break;
-            }
-
-            case CORE_ARG_TYPE_DOUBLE: {
-                size_t len;
-                char*  str = core_double_to_string(args->args[i].data.double_arg.value, &len);
-                if (str) {
-                    (*cmd_args)[arg_idx]     = (uintptr_t) str;
-                    (*cmd_args_len)[arg_idx] = len;
-                    add_tracked_string(*allocated_strings, allocated_count, str);
-                    arg_idx++;
-                }
-                break;
-            }
-
-            case CORE_ARG_TYPE_MULTI_STRING:
-                for (int j = 0; j < args->args[i].data.multi_string_arg.count; j++) {
-                    (*cmd_args)[arg_idx] =
-                        (uintptr_t) args->args[i].data.multi_string_arg.values[j];
-                    (*cmd_args_len)[arg_idx] = args->args[i].data.multi_string_arg.lengths[j];
-                    arg_idx++;
-                }
-                break;
-
-            case CORE_ARG_TYPE_ARRAY: {
-                /* Expand array elements into individual arguments */
-                zval* array = args->args[i].data.array_arg.array;
-                if (Z_TYPE_P(array) == IS_ARRAY) {
-                    HashTable* ht = Z_ARRVAL_P(array);
-                    zval*      element;
-
-                    ZEND_HASH_FOREACH_VAL(ht, element) {
-                        if (Z_TYPE_P(element) == IS_STRING) {
-                            (*cmd_args)[arg_idx]     = (uintptr_t) Z_STRVAL_P(element);
-                            (*cmd_args_len)[arg_idx] = Z_STRLEN_P(element);
-                            arg_idx++;
-                        } else {
-                            /* Convert non-string to string */
-                            zend_string* str = zval_get_string(element);
-                            if (str) {
-                                size_t len      = ZSTR_LEN(str);
-                                char*  str_copy = emalloc(len + 1);
-                                if (str_copy) {
-                                    memcpy(str_copy, ZSTR_VAL(str), len);
-                                    str_copy[len]            = '\0';
-                                    (*cmd_args)[arg_idx]     = (uintptr_t) str_copy;
-                                    (*cmd_args_len)[arg_idx] = len;
-                                    add_tracked_string(
-                                        *allocated_strings, allocated_count, str_copy);
-                                    arg_idx++;
-                                }
-                                zend_string_release(str);
-                            }
-                        }
-                    }
-                    ZEND_HASH_FOREACH_END();
-                }
-                break;
-            }
-
-            default:
-                break;
+        if (!core_add_arg(cmd_args, &args->args[i], core_arg_is_key(args, i))) {
+            return -1;
         }
     }
 
     /* Add options */
     if (args->options.has_expire) {
         if (args->options.has_pxat) {
-            (*cmd_args)[arg_idx]     = (uintptr_t) "PXAT";
-            (*cmd_args_len)[arg_idx] = 4;
-            arg_idx++;
-
-            size_t len;
-            char*  str = core_long_to_string(args->options.expire_at_milliseconds, &len);
-            if (str) {
-                (*cmd_args)[arg_idx]     = (uintptr_t) str;
-                (*cmd_args_len)[arg_idx] = len;
-                add_tracked_string(*allocated_strings, allocated_count, str);
-                arg_idx++;
-            }
+            valkey_glide_args_add_literal(cmd_args, "PXAT");
+            valkey_glide_args_add_long(cmd_args, args->options.expire_at_milliseconds);
         } else if (args->options.has_exat) {
-            (*cmd_args)[arg_idx]     = (uintptr_t) "EXAT";
-            (*cmd_args_len)[arg_idx] = 4;
-            arg_idx++;
-
-            size_t len;
-            char*  str = core_long_to_string(args->options.expire_at_seconds, &len);
-            if (str) {
-                (*cmd_args)[arg_idx]     = (uintptr_t) str;
-                (*cmd_args_len)[arg_idx] = len;
-                add_tracked_string(*allocated_strings, allocated_count, str);
-                arg_idx++;
-            }
+            valkey_glide_args_add_literal(cmd_args, "EXAT");
+            valkey_glide_args_add_long(cmd_args, args->options.expire_at_seconds);
         } else if (args->options.has_pexpire) {
-            (*cmd_args)[arg_idx]     = (uintptr_t) "PX";
-            (*cmd_args_len)[arg_idx] = 2;
-            arg_idx++;
-
-            size_t len;
-            char*  str = core_long_to_string(args->options.expire_milliseconds, &len);
-            if (str) {
-                (*cmd_args)[arg_idx]     = (uintptr_t) str;
-                (*cmd_args_len)[arg_idx] = len;
-                add_tracked_string(*allocated_strings, allocated_count, str);
-                arg_idx++;
-            }
+            valkey_glide_args_add_literal(cmd_args, "PX");
+            valkey_glide_args_add_long(cmd_args, args->options.expire_milliseconds);
         } else {
-            (*cmd_args)[arg_idx]     = (uintptr_t) "EX";
-            (*cmd_args_len)[arg_idx] = 2;
-            arg_idx++;
-
-            size_t len;
-            char*  str = core_long_to_string(args->options.expire_seconds, &len);
-            if (str) {
-                (*cmd_args)[arg_idx]     = (uintptr_t) str;
-                (*cmd_args_len)[arg_idx] = len;
-                add_tracked_string(*allocated_strings, allocated_count, str);
-                arg_idx++;
-            }
+            valkey_glide_args_add_literal(cmd_args, "EX");
+            valkey_glide_args_add_long(cmd_args, args->options.expire_seconds);
         }
     }
 
     if (args->options.nx) {
-        (*cmd_args)[arg_idx]     = (uintptr_t) "NX";
-        (*cmd_args_len)[arg_idx] = 2;
-        arg_idx++;
+        valkey_glide_args_add_literal(cmd_args, "NX");
     }
 
     if (args->options.xx) {
-        (*cmd_args)[arg_idx]     = (uintptr_t) "XX";
-        (*cmd_args_len)[arg_idx] = 2;
-        arg_idx++;
+        valkey_glide_args_add_literal(cmd_args, "XX");
     }
 
     if (args->options.get_old_value) {
-        (*cmd_args)[arg_idx]     = (uintptr_t) "GET";
-        (*cmd_args_len)[arg_idx] = 3;
-        arg_idx++;
+        valkey_glide_args_add_literal(cmd_args, "GET");
     }
 
     if (args->options.keep_ttl) {
-        (*cmd_args)[arg_idx]     = (uintptr_t) "KEEPTTL";
-        (*cmd_args_len)[arg_idx] = 7;
-        arg_idx++;
+        valkey_glide_args_add_literal(cmd_args, "KEEPTTL");
     }
 
     if (args->options.has_ifeq) {
-        (*cmd_args)[arg_idx]     = (uintptr_t) "IFEQ";
-        (*cmd_args_len)[arg_idx] = 4;
-        arg_idx++;
-
-        (*cmd_args)[arg_idx]     = (uintptr_t) args->options.ifeq_value;
-        (*cmd_args_len)[arg_idx] = args->options.ifeq_len;
-        arg_idx++;
+        valkey_glide_args_add_literal(cmd_args, "IFEQ");
+        valkey_glide_args_add(cmd_args, args->options.ifeq_value, args->options.ifeq_len);
     }
 
     if (args->options.persist) {
-        (*cmd_args)[arg_idx]     = (uintptr_t) "PERSIST";
-        (*cmd_args_len)[arg_idx] = 7;
-        arg_idx++;
+        valkey_glide_args_add_literal(cmd_args, "PERSIST");
     }
 
-    return arg_idx;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for message operations (ECHO, etc.)
  */
-int prepare_message_args(core_command_args_t* args,
-                         uintptr_t**          cmd_args,
-                         unsigned long**      cmd_args_len,
-                         char***              allocated_strings,
-                         int*                 allocated_count) {
-    if (args->arg_count == 0) {
-        return 0;
-    }
-
-    /* Calculate total argument count - just the arguments, no key */
-    int total_args = 0;
-
-    for (int i = 0; i < args->arg_count; i++) {
-        switch (args->args[i].type) {
-            case CORE_ARG_TYPE_STRING:
-            case CORE_ARG_TYPE_LONG:
-            case CORE_ARG_TYPE_DOUBLE:
-                total_args++;
-                break;
-            case CORE_ARG_TYPE_MULTI_STRING:
-                total_args += args->args[i].data.multi_string_arg.count;
-                break;
-            default:
-                break;
-        }
-    }
-
-    if (!allocate_core_arg_arrays(total_args, cmd_args, cmd_args_len)) {
-        return 0;
-    }
-
-    /* Initialize string tracking */
-    *allocated_strings = create_string_tracker(total_args);
-    *allocated_count   = 0;
-
-    int arg_idx = 0;
-
-    /* Add all arguments */
+int prepare_message_args(core_command_args_t* args, valkey_glide_args* cmd_args) {
+    /* Just the arguments, no key */
     for (int i = 0; i < args->arg_count; i++) {
-        switch (args->args[i].type) {
-            case CORE_ARG_TYPE_STRING:
-                (*cmd_args)[arg_idx]     = (uintptr_t) args->args[i].data.string_arg.value;
-                (*cmd_args_len)[arg_idx] = args->args[i].data.string_arg.len;
-                arg_idx++;
-                break;
-
-            case CORE_ARG_TYPE_LONG: {
-                size_t len;
-                char*  str = core_long_to_string(args->args[i].data.long_arg.value, &len);
-                if (str) {
-                    (*cmd_args)[arg_idx]     = (uintptr_t) str;
-                    (*cmd_args_len)[arg_idx] = len;
-                    add_tracked_string(*allocated_strings, allocated_count, str);
-                    arg_idx++;
-                }
-                break;
-            }
-
-            case CORE_ARG_TYPE_DOUBLE: {
-                size_t len;
-                char*  str = core_double_to_string(args->args[i].data.double_arg.value, &len);
-                if (str) {
-                    (*cmd_args)[arg_idx]     = (uintptr_t) str;
-                    (*cmd_args_len)[arg_idx] = len;
-                    add_tracked_string(*allocated_strings, allocated_count, str);
-                    arg_idx++;
-                }
-                break;
-            }
-
-            case CORE_ARG_TYPE_MULTI_STRING:
-                for (int j = 0; j < args->args[i].data.multi_string_arg.count; j++) {
-                    (*cmd_args)[arg_idx] =
-                        (uintptr_t) args->args[i].data.multi_string_arg.values[j];
-                    (*cmd_args_len)[arg_idx] = args->args[i].data.multi_string_arg.lengths[j];
-                    arg_idx++;
-                }
-                break;
-
-            default:
-                break;
+        if (!core_add_arg(cmd_args, &args->args[i], false)) {
+            return -1;
         }
     }
 
-    return arg_idx;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for key-value pairs operations (MSET, MSETNX)
  */
-int prepare_key_value_pairs_args(core_command_args_t* args,
-                                 uintptr_t**          cmd_args,
-                                 unsigned long**      cmd_args_len,
-                                 char***              allocated_strings,
-                                 int*                 allocated_count) {
+int prepare_key_value_pairs_args(core_command_args_t* args, valkey_glide_args* cmd_args) {
     if (args->arg_count == 0 || args->args[0].type != CORE_ARG_TYPE_ARRAY) {
         return 0;
     }
@@ -657,348 +417,153 @@ int prepare_key_value_pairs_args(core_command_args_t* args,
         return 0;
     }
 
-    HashTable* ht        = Z_ARRVAL_P(arr);
-    int        key_count = zend_hash_num_elements(ht);
-
-    if (key_count == 0) {
-        return 0;
-    }
-
-    /* Each key-value pair requires 2 arguments */
-    int total_args = key_count * 2;
-
-    if (!allocate_core_arg_arrays(total_args, cmd_args, cmd_args_len)) {
-        return 0;
-    }
-
-    /* Initialize string tracking */
-    *allocated_strings = create_string_tracker(total_args);
-    *allocated_count   = 0;
-
-    int          arg_idx = 0;
     zval*        data;
     zend_string* key;
     zend_ulong   num_key;
+    zval         z_num_key;
 
-    ZEND_HASH_FOREACH_KEY_VAL(ht, num_key, key, data) {
+    ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(arr), num_key, key, data) {
         /* Add key */
-        if (!key) {
-            /* Numeric key - convert to string */
-            size_t key_len;
-            char*  key_str = core_long_to_string((long) num_key, &key_len);
-            if (key_str) {
-                (*cmd_args)[arg_idx]     = (uintptr_t) key_str;
-                (*cmd_args_len)[arg_idx] = key_len;
-                add_tracked_string(*allocated_strings, allocated_count, key_str);
-                arg_idx++;
-            }
+        if (key) {
+            valkey_glide_args_add_key(cmd_args, ZSTR_VAL(key), ZSTR_LEN(key));
         } else {
-            /* String key */
-            (*cmd_args)[arg_idx]     = (uintptr_t) ZSTR_VAL(key);
-            (*cmd_args_len)[arg_idx] = ZSTR_LEN(key);
-            arg_idx++;
+            /* Numeric key - converted, then prefixed */
+            ZVAL_LONG(&z_num_key, (zend_long) num_key);
+            valkey_glide_args_add_key_zval(cmd_args, &z_num_key);
         }
 
-        /* Add value */
-        if (Z_TYPE_P(data) == IS_STRING) {
-            (*cmd_args)[arg_idx]     = (uintptr_t) Z_STRVAL_P(data);
-            (*cmd_args_len)[arg_idx] = Z_STRLEN_P(data);
-            arg_idx++;
-        } else {
-            /* Convert non-string value to string using safe method */
-            zend_string* str = zval_get_string(data);
-            if (str) {
-                (*cmd_args)[arg_idx]     = (uintptr_t) ZSTR_VAL(str);
-                (*cmd_args_len)[arg_idx] = ZSTR_LEN(str);
-                arg_idx++;
-            }
+        /* Add value, serialized with the client's serializer */
+        if (!valkey_glide_args_add_value(cmd_args, data)) {
+            return -1;
         }
     }
     ZEND_HASH_FOREACH_END();
 
-    return arg_idx;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for multi-key operations
  */
-int prepare_multi_key_args(core_command_args_t* args,
-                           uintptr_t**          cmd_args,
-                           unsigned long**      cmd_args_len) {
+int prepare_multi_key_args(core_command_args_t* args, valkey_glide_args* cmd_args) {
     if (args->arg_count == 0 || args->args[0].type != CORE_ARG_TYPE_ARRAY) {
         return 0;
     }
 
-    zval* keys      = args->args[0].data.array_arg.array;
-    int   key_count = args->args[0].data.array_arg.count;
-
-    if (!allocate_core_arg_arrays(key_count, cmd_args, cmd_args_len)) {
-        return 0;
-    }
-
-    HashTable* keys_hash = Z_ARRVAL_P(keys);
-    zval*      key;
-    int        idx = 0;
-
-    ZEND_HASH_FOREACH_VAL(keys_hash, key) {
-        if (Z_TYPE_P(key) != IS_STRING) {
-            convert_to_string(key);
-        }
-        (*cmd_args)[idx]     = (uintptr_t) Z_STRVAL_P(key);
-        (*cmd_args_len)[idx] = Z_STRLEN_P(key);
-        idx++;
+    if (!core_add_arg(cmd_args, &args->args[0], true)) {
+        return -1;
     }
-    ZEND_HASH_FOREACH_END();
 
-    return idx;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for bit operations
  */
-int prepare_bit_operation_args(core_command_args_t* args,
-                               uintptr_t**          cmd_args,
-                               unsigned long**      cmd_args_len,
-                               char***              allocated_strings,
-                               int*                 allocated_count) {
+int prepare_bit_operation_args(core_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->key || args->key_len == 0) {
         return 0;
     }
 
-    int total_args = 1; /* key */
-
-    /* Calculate arguments based on command type */
-    switch (args->cmd_type) {
-        case BitCount:
-            total_args += (args->options.has_range ? 2 : 0); /* start, end */
-            total_args += (args->options.bybit ? 1 : 0);     /* BYBIT */
-            break;
-        case BitPos:
-            total_args += 1;                                 /* bit value */
-            total_args += (args->options.has_range ? 2 : 0); /* start, end */
-            total_args += (args->options.bybit ? 1 : 0);     /* BYBIT */
-            break;
-        case GetBit:
-            total_args += 1; /* offset */
-            break;
-        case SetBit:
-            total_args += 2; /* offset, value */
-            break;
-        case BitOp:
-            total_args += 1;               /* operation */
-            total_args += 1;               /* destination */
-            total_args += args->arg_count; /* source keys */
-            break;
-        default:
-            return 0;
-    }
-
-    if (!allocate_core_arg_arrays(total_args, cmd_args, cmd_args_len)) {
-        return 0;
-    }
-
-    *allocated_strings = create_string_tracker(total_args);
-    *allocated_count   = 0;
-
-    int arg_idx = 0;
-
     /* Handle BitOp differently - operation comes first */
     if (args->cmd_type == BitOp) {
         /* Add operation */
-        (*cmd_args)[arg_idx]     = (uintptr_t) args->args[0].data.string_arg.value;
-        (*cmd_args_len)[arg_idx] = args->args[0].data.string_arg.len;
-        arg_idx++;
+        valkey_glide_args_add(
+            cmd_args, args->args[0].data.string_arg.value, args->args[0].data.string_arg.len);
 
         /* Add destination key */
-        (*cmd_args)[arg_idx]     = (uintptr_t) args->key;
-        (*cmd_args_len)[arg_idx] = args->key_len;
-        arg_idx++;
+        valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
 
         /* Add source keys */
         for (int i = 1; i < args->arg_count; i++) {
             if (args->args[i].type == CORE_ARG_TYPE_STRING) {
-                (*cmd_args)[arg_idx]     = (uintptr_t) args->args[i].data.string_arg.value;
-                (*cmd_args_len)[arg_idx] = args->args[i].data.string_arg.len;
-                arg_idx++;
-            }
-        }
-    } else {
-        /* Add key first for other bit operations */
-        (*cmd_args)[arg_idx]     = (uintptr_t) args->key;
-        (*cmd_args_len)[arg_idx] = args->key_len;
-        arg_idx++;
-
-        /* Add arguments based on command type */
-        for (int i = 0; i < args->arg_count; i++) {
-            switch (args->args[i].type) {
-                case CORE_ARG_TYPE_LONG: {
-                    size_t len;
-                    char*  str = core_long_to_string(args->args[i].data.long_arg.value, &len);
-                    if (str) {
-                        (*cmd_args)[arg_idx]     = (uintptr_t) str;
-                        (*cmd_args_len)[arg_idx] = len;
-                        add_tracked_string(*allocated_strings, allocated_count, str);
-                        arg_idx++;
-                    }
-                    break;
-                }
-                default:
-                    break;
+                core_add_arg(cmd_args, &args->args[i], true);
             }
         }
+        return cmd_args->count;
+    }
 
-        /* Add range arguments if present */
-        if (args->options.has_range) {
-            size_t len;
-            char*  start_str = core_long_to_string(args->options.start, &len);
-            if (start_str) {
-                (*cmd_args)[arg_idx]     = (uintptr_t) start_str;
-                (*cmd_args_len)[arg_idx] = len;
-                add_tracked_string(*allocated_strings, allocated_count, start_str);
-                arg_idx++;
-            }
+    switch (args->cmd_type) {
+        case BitCount:
+        case BitPos:
+        case GetBit:
+        case SetBit:
+            break;
+        default:
+            return 0;
+    }
 
-            char* end_str = core_long_to_string(args->options.end, &len);
-            if (end_str) {
-                (*cmd_args)[arg_idx]     = (uintptr_t) end_str;
-                (*cmd_args_len)[arg_idx] = len;
-                add_tracked_string(*allocated_strings, allocated_count, end_str);
-                arg_idx++;
-            }
-        }
+    /* Add key first for other bit operations */
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
 
-        /* Add BYBIT flag if present */
-        if (args->options.bybit) {
-            (*cmd_args)[arg_idx]     = (uintptr_t) "BIT";
-            (*cmd_args_len)[arg_idx] = 3;
-            arg_idx++;
+    /* Add arguments based on command type */
+    for (int i = 0; i < args->arg_count; i++) {
+        if (args->args[i].type == CORE_ARG_TYPE_LONG) {
+            core_add_arg(cmd_args, &args->args[i], false);
         }
     }
 
-    return arg_idx;
+    /* Add range arguments if present */
+    if (args->options.has_range) {
+        valkey_glide_args_add_long(cmd_args, args->options.start);
+        valkey_glide_args_add_long(cmd_args, args->options.end);
+    }
+
+    /* Add BYBIT flag if present */
+    if (args->options.bybit) {
+        valkey_glide_args_add_literal(cmd_args, "BIT");
+    }
+
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for expire operations
  */
-int prepare_expire_args(core_command_args_t* args,
-                        uintptr_t**          cmd_args,
-                        unsigned long**      cmd_args_len,
-                        char***              allocated_strings,
-                        int*                 allocated_count) {
+int prepare_expire_args(core_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->key || args->key_len == 0 || args->arg_count == 0) {
         return 0;
     }
 
-    /* Calculate total arguments: key + time + optional mode */
-    int total_args = 1 + args->arg_count; /* key + all provided arguments */
-
-    if (!allocate_core_arg_arrays(total_args, cmd_args, cmd_args_len)) {
-        return 0;
-    }
-
-    *allocated_strings = create_string_tracker(total_args);
-    *allocated_count   = 0;
-
-    int arg_idx = 0;
-
     /* Add key */
-    (*cmd_args)[arg_idx]     = (uintptr_t) args->key;
-    (*cmd_args_len)[arg_idx] = args->key_len;
-    arg_idx++;
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
 
     /* Add all arguments (time value and optional mode) */
     for (int i = 0; i < args->arg_count; i++) {
-        switch (args->args[i].type) {
-            case CORE_ARG_TYPE_LONG: {
-                size_t len;
-                char*  str = core_long_to_string(args->args[i].data.long_arg.value, &len);
-                if (str) {
-                    (*cmd_args)[arg_idx]     = (uintptr_t) str;
-                    (*cmd_args_len)[arg_idx] = len;
-                    add_tracked_string(*allocated_strings, allocated_count, str);
-                    arg_idx++;
-                }
-                break;
-            }
-            case CORE_ARG_TYPE_STRING:
-                (*cmd_args)[arg_idx]     = (uintptr_t) args->args[i].data.string_arg.value;
-                (*cmd_args_len)[arg_idx] = args->args[i].data.string_arg.len;
-                arg_idx++;
-                break;
-            default:
-                break;
+        if (args->args[i].type == CORE_ARG_TYPE_LONG ||
+            args->args[i].type == CORE_ARG_TYPE_STRING) {
+            core_add_arg(cmd_args, &args->args[i], false);
         }
     }
 
-    return arg_idx;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for range operations
  */
-int prepare_range_args(core_command_args_t* args,
-                       uintptr_t**          cmd_args,
-                       unsigned long**      cmd_args_len,
-                       char***              allocated_strings,
-                       int*                 allocated_count) {
+int prepare_range_args(core_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->key || args->key_len == 0) {
         return 0;
     }
 
-    int total_args = 1; /* key */
-
-    /* Add arguments based on command type */
-    switch (args->cmd_type) {
-        case GetRange:
-            total_args += 2; /* start, end */
-            break;
-        case SetRange:
-            total_args += 2; /* offset, value */
-            break;
-        default:
-            return 0;
-    }
-
-    if (!allocate_core_arg_arrays(total_args, cmd_args, cmd_args_len)) {
+    /* start, end for GETRANGE; offset, value for SETRANGE */
+    if (args->cmd_type != GetRange && args->cmd_type != SetRange) {
         return 0;
     }
 
-    *allocated_strings = create_string_tracker(total_args);
-    *allocated_count   = 0;
-
-    int arg_idx = 0;
-
     /* Add key */
-    (*cmd_args)[arg_idx]     = (uintptr_t) args->key;
-    (*cmd_args_len)[arg_idx] = args->key_len;
-    arg_idx++;
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
 
     /* Add range-specific arguments */
-    for (int i = 0; i < args->arg_count && arg_idx < total_args; i++) {
-        switch (args->args[i].type) {
-            case CORE_ARG_TYPE_LONG: {
-                size_t len;
-                char*  str = core_long_to_string(args->args[i].data.long_arg.value, &len);
-                if (str) {
-                    (*cmd_args)[arg_idx]     = (uintptr_t) str;
-                    (*cmd_args_len)[arg_idx] = len;
-                    add_tracked_string(*allocated_strings, allocated_count, str);
-                    arg_idx++;
-                }
-                break;
-            }
-            case CORE_ARG_TYPE_STRING:
-                (*cmd_args)[arg_idx]     = (uintptr_t) args->args[i].data.string_arg.value;
-                (*cmd_args_len)[arg_idx] = args->args[i].data.string_arg.len;
-                arg_idx++;
-                break;
-            default:
-                break;
+    for (int i = 0; i < args->arg_count && cmd_args->count < 3; i++) {
+        if (args->args[i].type == CORE_ARG_TYPE_LONG ||
+            args->args[i].type == CORE_ARG_TYPE_STRING) {
+            core_add_arg(cmd_args, &args->args[i], false);
         }
     }
 
-    return arg_idx;
+    return cmd_args->count;
 }
 
 /* ====================================================================
@@ -1063,6 +628,25 @@ int process_core_string_result(CommandResult* result, void* output) {
     return 0;
 }
 
+/**
+ * Process a stored value: unserialized straight from the response buffer into the zval
+ * output. Returns 0 for a missing key.
+ */
+int process_core_value_result(CommandResult* result, void* output) {
+    zval* return_value = (zval*) output;
+
+    if (!result || !result->response || !return_value ||
+        result->response->response_type != String) {
+        return 0;
+    }
+
+    valkey_glide_unserialize(valkey_glide_current_options(),
+                             result->response->string_value,
+                             result->response->string_value_len,
+                             return_value);
+    return 1;
+}
+
 /**
  * Process boolean result
  * Handles Bool, Int, and Ok response types from ValkeyGlide/Valkey
@@ -1094,11 +678,35 @@ int process_core_array_result(CommandResult* result, void* output) {
     if (!result || !result->response || !return_value) {
         return 0;
     }
+    if (valkey_glide_result_take(result, false, return_value)) {
+        return 1;
+    }
 
     return command_response_to_zval(
         result->response, return_value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, true);
 }
 
+/**
+ * Process an array of stored values, unserialized with the client's serializer
+ */
+int process_core_value_array_result(CommandResult* result, void* output) {
+    zval* return_value = (zval*) output;
+
+    if (!result || !result->response || !return_value) {
+        return 0;
+    }
+    if (valkey_glide_result_take(result, true, return_value)) {
+        return 1;
+    }
+
+    if (!command_response_to_zval(
+            result->response, return_value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, true)) {
+        return 0;
+    }
+    valkey_glide_unserialize_array(valkey_glide_current_options(), return_value);
+    return 1;
+}
+
 /**
  * Process double result
  */
@@ -1188,104 +796,6 @@ int process_core_type_result(CommandResult* result, void* output) {
     return -1; /* Error */
 }
 
-/* ====================================================================
- * MEMORY MANAGEMENT UTILITIES
- * ==================================================================== */
-
-/**
- * Allocate command argument arrays
- */
-int allocate_core_arg_arrays(int count, uintptr_t** args_out, unsigned long** args_len_out) {
-    *args_out     = (uintptr_t*) emalloc(count * sizeof(uintptr_t));
-    *args_len_out = (unsigned long*) emalloc(count * sizeof(unsigned long));
-
-    if (!*args_out || !*args_len_out) {
-        if (*args_out)
-            efree(*args_out);
-        if (*args_len_out)
-            efree(*args_len_out);
-        return 0;
-    }
-
-    return 1;
-}
-
-/**
- * Free command argument arrays
- */
-void free_core_arg_arrays(uintptr_t* args, unsigned long* args_len) {
-    if (args)
-        efree(args);
-    if (args_len)
-        efree(args_len);
-}
-
-/**
- * Create string tracker for memory management
- */
-char** create_string_tracker(int max_strings) {
-    return (char**) ecalloc(max_strings, sizeof(char*));
-}
-
-/**
- * Add string to tracker
- */
-void add_tracked_string(char** tracker, int* count, char* str) {
-    if (tracker && str) {
-        tracker[*count] = str;
-        (*count)++;
-    }
-}
-
-/**
- * Free all tracked strings
- */
-void free_tracked_strings(char** tracker, int count) {
-    if (!tracker)
-        return;
-
-    for (int i = 0; i < count; i++) {
-        if (tracker[i]) {
-            efree(tracker[i]);
-        }
-    }
-}
-
-/**
- * Convert long to string
- */
-char* core_long_to_string(long value, size_t* len) {
-    char buffer[32];
-    *len      = snprintf(buffer, sizeof(buffer), "%ld", value);
-    char* str = (char*) emalloc(*len + 1);
-    if (str) {
-        memcpy(str, buffer, *len);
-        str[*len] = '\0';
-    }
-    return str;
-}
-
-/**
- * Convert double to string
- */
-char* core_double_to_string(double value, size_t* len) {
-    char buffer[64];
-    *len      = snprintf(buffer, sizeof(buffer), "%.17g", value);
-    char* str = (char*) emalloc(*len + 1);
-    if (str) {
-        memcpy(str, buffer, *len);
-        str[*len] = '\0';
-    }
-    return str;
-}
-
-/**
- * Convert zval to string safely
- */
-char* core_zval_to_string(zval* z, size_t* len, int* need_free) {
-    return zval_to_string_safe(z, len, need_free);
-}
-
 /* ====================================================================
  * OPTION PARSING UTILITIES
  * ==================================================================== */
@@ -18,6 +18,7 @@
 #define VALKEY_GLIDE_CORE_COMMON_H
 
 #include "command_response.h"
+#include "valkey_glide_args.h"
 #include "valkey_glide_commands_common.h"
 
 /* ====================================================================
@@ -32,7 +33,8 @@ typedef enum {
     CORE_ARG_TYPE_DOUBLE,
     CORE_ARG_TYPE_ARRAY,
     CORE_ARG_TYPE_MULTI_STRING,
-    CORE_ARG_TYPE_KEY_VALUE_PAIRS
+    CORE_ARG_TYPE_KEY_VALUE_PAIRS,
+    CORE_ARG_TYPE_VALUE /* A user value, sent through the client's serializer */
 } core_arg_type_t;
 
 /* Flexible argument container */
@@ -66,6 +68,10 @@ typedef struct {
         struct {
             HashTable* pairs;
         } key_value_arg;
+
+        struct {
+            zval* value;
+        } value_arg;
     } data;
 } core_arg_t;
 
@@ -142,76 +148,38 @@ int execute_core_command(core_command_args_t*    args,
                          void*                   result_ptr,
                          core_result_processor_t processor);
 
-/* Command argument preparation utilities */
-int prepare_core_args(core_command_args_t* args,
-                      uintptr_t**          cmd_args,
-                      unsigned long**      cmd_args_len,
-                      char***              allocated_strings,
-                      int*                 allocated_count);
-
-void free_core_args(uintptr_t*     cmd_args,
-                    unsigned long* cmd_args_len,
-                    char**         allocated_strings,
-                    int            allocated_count);
+/* Command argument preparation utilities. Return the argument count, -1 when a value
+ * cannot be serialized. */
+int prepare_core_args(core_command_args_t* args, valkey_glide_args* cmd_args);
 
 /* ====================================================================
  * ARGUMENT PREPARATION HELPERS
  * ==================================================================== */
 
 /* Single key operations */
-int prepare_key_only_args(core_command_args_t* args,
-                          uintptr_t**          cmd_args,
-                          unsigned long**      cmd_args_len);
+int prepare_key_only_args(core_command_args_t* args, valkey_glide_args* cmd_args);
 
 /* Key-value operations */
-int prepare_key_value_args(core_command_args_t* args,
-                           uintptr_t**          cmd_args,
-                           unsigned long**      cmd_args_len,
-                           char***              allocated_strings,
-                           int*                 allocated_count);
-
-int prepare_key_value_pairs_args(core_command_args_t* args,
-                                 uintptr_t**          cmd_args,
-                                 unsigned long**      cmd_args_len,
-                                 char***              allocated_strings,
-                                 int*                 allocated_count);
+int prepare_key_value_args(core_command_args_t* args, valkey_glide_args* cmd_args);
+
+int prepare_key_value_pairs_args(core_command_args_t* args, valkey_glide_args* cmd_args);
 
 /* Message operations (no key, just arguments) */
-int prepare_message_args(core_command_args_t* args,
-                         uintptr_t**          cmd_args,
-                         unsigned long**      cmd_args_len,
-                         char***              allocated_strings,
-                         int*                 allocated_count);
+int prepare_message_args(core_command_args_t* args, valkey_glide_args* cmd_args);
 
 /* Multi-key operations */
-int prepare_multi_key_args(core_command_args_t* args,
-                           uintptr_t**          cmd_args,
-                           unsigned long**      cmd_args_len);
+int prepare_multi_key_args(core_command_args_t* args, valkey_glide_args* cmd_args);
 
 /* Bit operations */
-int prepare_bit_operation_args(core_command_args_t* args,
-                               uintptr_t**          cmd_args,
-                               unsigned long**      cmd_args_len,
-                               char***              allocated_strings,
-                               int*                 allocated_count);
+int prepare_bit_operation_args(core_command_args_t* args, valkey_glide_args* cmd_args);
 
 /* Expire operations */
-int prepare_expire_args(core_command_args_t* args,
-                        uintptr_t**          cmd_args,
-                        unsigned long**      cmd_args_len,
-                        char***              allocated_strings,
-                        int*                 allocated_count);
+int prepare_expire_args(core_command_args_t* args, valkey_glide_args* cmd_args);
 
 /* Range operations */
-int prepare_range_args(core_command_args_t* args,
-                       uintptr_t**          cmd_args,
-                       unsigned long**      cmd_args_len,
-                       char***              allocated_strings,
-                       int*                 allocated_count);
+int prepare_range_args(core_command_args_t* args, valkey_glide_args* cmd_args);
 
-int prepare_zero_args(core_command_args_t* args,
-                      uintptr_t**          cmd_args,
-                      unsigned long**      cmd_args_len);
+int prepare_zero_args(core_command_args_t* args, valkey_glide_args* cmd_args);
 
 /* ====================================================================
  * RESULT PROCESSORS
@@ -223,12 +191,18 @@ int process_core_int_result(CommandResult* result, void* output);
 /* String result processor */
 int process_core_string_result(CommandResult* result, void* output);
 
+/* Stored value result processor, applies the client's serializer */
+int process_core_value_result(CommandResult* result, void* output);
+
 /* Boolean result processor */
 int process_core_bool_result(CommandResult* result, void* output);
 
 /* Array result processor */
 int process_core_array_result(CommandResult* result, void* output);
 
+/* Array of stored values result processor, applies the client's serializer */
+int process_core_value_array_result(CommandResult* result, void* output);
+
 /* Double result processor */
 int process_core_double_result(CommandResult* result, void* output);
 
@@ -238,26 +212,6 @@ int process_core_null_or_value_result(CommandResult* result, void* output);
 /* Core type result processor */
 int process_core_type_result(CommandResult* result, void* output);
 
-/* ====================================================================
- * MEMORY MANAGEMENT UTILITIES
- * ==================================================================== */
-
-/* Allocate command argument arrays */
-int allocate_core_arg_arrays(int count, uintptr_t** args_out, unsigned long** args_len_out);
-
-/* Free command argument arrays */
-void free_core_arg_arrays(uintptr_t* args, unsigned long* args_len);
-
-/* Track allocated strings for cleanup */
-char** create_string_tracker(int max_strings);
-void   add_tracked_string(char** tracker, int* count, char* str);
-void   free_tracked_strings(char** tracker, int count);
-
-/* Convert various types to string arguments */
-char* core_long_to_string(long value, size_t* len);
-char* core_double_to_string(double value, size_t* len);
-char* core_zval_to_string(zval* z, size_t* len, int* need_free);
-
 /* ====================================================================
  * OPTION PARSING UTILITIES
  * ==================================================================== */
@@ -0,0 +1,93 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Command Errors                                          |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#include "valkey_glide_errors.h"
+
+#include <zend_exceptions.h>
+
+#include "valkey_glide_options.h"
+
+void valkey_glide_set_last_error(const char* message, size_t message_len) {
+    valkey_glide_object* valkey_glide = valkey_glide_current_object();
+
+    if (!valkey_glide) {
+        return;
+    }
+    if (valkey_glide->last_error) {
+        zend_string_release(valkey_glide->last_error);
+    }
+    valkey_glide->last_error = zend_string_init(message, message_len, 0);
+}
+
+void valkey_glide_command_error(const CommandError* error) {
+    const char* message = error->command_error_message ? error->command_error_message
+                                                       : "Unknown error";
+
+    valkey_glide_set_last_error(message, strlen(message));
+
+    switch (error->command_error_type) {
+        case Timeout:
+            zend_throw_exception(
+                get_valkey_glide_timeout_exception_ce(), message, error->command_error_type);
+            break;
+        case Disconnect:
+            zend_throw_exception(
+                get_valkey_glide_connection_exception_ce(), message, error->command_error_type);
+            break;
+        default:
+            /* Server errors (WRONGTYPE, NOSCRIPT, EXECABORT, ...) are a false return */
+            break;
+    }
+}
+
+/* ====================================================================
+ * getLastError() / clearLastError()
+ * ==================================================================== */
+
+int execute_get_last_error_command(zval*             object,
+                                   int               argc,
+                                   zval*             return_value,
+                                   zend_class_entry* ce) {
+    valkey_glide_object* valkey_glide;
+
+    if (zend_parse_method_parameters(argc, object, "O", &object, ce) == FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (valkey_glide->last_error) {
+        ZVAL_STR_COPY(return_value, valkey_glide->last_error);
+    } else {
+        ZVAL_NULL(return_value);
+    }
+    return 1;
+}
+
+int execute_clear_last_error_command(zval*             object,
+                                     int               argc,
+                                     zval*             return_value,
+                                     zend_class_entry* ce) {
+    valkey_glide_object* valkey_glide;
+
+    if (zend_parse_method_parameters(argc, object, "O", &object, ce) == FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (valkey_glide->last_error) {
+        zend_string_release(valkey_glide->last_error);
+        valkey_glide->last_error = NULL;
+    }
+    ZVAL_TRUE(return_value);
+    return 1;
+}
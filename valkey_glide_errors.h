@@ -0,0 +1,71 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Command Errors                                          |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef VALKEY_GLIDE_ERRORS_H
+#define VALKEY_GLIDE_ERRORS_H
+
+#include "common.h"
+#include "php.h"
+#include "valkey_glide_commands_common.h"
+
+/*
+ * Errors of failed commands.
+ *
+ * A command the server rejects returns false, as in phpredis, and its message is kept on the
+ * client for getLastError() until clearLastError(). A timeout or a lost connection is not
+ * something the caller can tell apart from a server error by a false return, so those throw a
+ * ValkeyGlideTimeoutException or a ValkeyGlideConnectionException instead, with the
+ * RequestErrorType of the FFI as the exception code. Retry logic can then tell them apart by
+ * class rather than by parsing the message.
+ *
+ * Errors are recorded where the FFI result comes back (execute_command(),
+ * execute_command_with_route() and exec()), so the command handlers only return false.
+ */
+
+/* Record the error of a failed command on the client whose method is running, and throw for
+ * timeouts and lost connections */
+void valkey_glide_command_error(const CommandError* error);
+
+/* Record an error found before the command was sent, such as an invalid route */
+void valkey_glide_set_last_error(const char* message, size_t message_len);
+
+int execute_get_last_error_command(zval*             object,
+                                   int               argc,
+                                   zval*             return_value,
+                                   zend_class_entry* ce);
+int execute_clear_last_error_command(zval*             object,
+                                     int               argc,
+                                     zval*             return_value,
+                                     zend_class_entry* ce);
+
+#define LAST_ERROR_METHOD_IMPL_EX(class_name, method_name, execute_fn)             \
+    PHP_METHOD(class_name, method_name) {                                          \
+        if (execute_fn(getThis(),                                                  \
+                       ZEND_NUM_ARGS(),                                            \
+                       return_value,                                               \
+                       strcmp(#class_name, "ValkeyGlideCluster") == 0              \
+                           ? get_valkey_glide_cluster_ce()                         \
+                           : get_valkey_glide_ce())) {                             \
+            return;                                                                \
+        }                                                                          \
+        zval_dtor(return_value);                                                   \
+        RETURN_FALSE;                                                              \
+    }
+
+#define GETLASTERROR_METHOD_IMPL(class_name) \
+    LAST_ERROR_METHOD_IMPL_EX(class_name, getLastError, execute_get_last_error_command)
+
+#define CLEARLASTERROR_METHOD_IMPL(class_name) \
+    LAST_ERROR_METHOD_IMPL_EX(class_name, clearLastError, execute_clear_last_error_command)
+
+#endif /* VALKEY_GLIDE_ERRORS_H */
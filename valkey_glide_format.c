@@ -0,0 +1,389 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Number Formatting                                       |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#include "valkey_glide_format.h"
+
+#include <math.h>
+#include <string.h>
+
+static const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const uint64_t pow10_table[20] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL,
+};
+
+static inline int count_digits(uint64_t n) {
+    int digits = 1;
+
+    for (;;) {
+        if (n < 10) {
+            return digits;
+        }
+        if (n < 100) {
+            return digits + 1;
+        }
+        if (n < 1000) {
+            return digits + 2;
+        }
+        if (n < 10000) {
+            return digits + 3;
+        }
+        n /= 10000;
+        digits += 4;
+    }
+}
+
+/* Write the len digits of n ending at end, two at a time */
+static inline void write_digits(uint64_t n, char* end) {
+    while (n >= 100) {
+        unsigned pair = (unsigned) (n % 100) * 2;
+
+        n /= 100;
+        *--end = digit_pairs[pair + 1];
+        *--end = digit_pairs[pair];
+    }
+    if (n >= 10) {
+        *--end = digit_pairs[n * 2 + 1];
+        *--end = digit_pairs[n * 2];
+    } else {
+        *--end = (char) ('0' + n);
+    }
+}
+
+size_t valkey_glide_format_long(int64_t value, char* buffer) {
+    uint64_t n   = value < 0 ? 0 - (uint64_t) value : (uint64_t) value;
+    size_t   len = (size_t) count_digits(n) + (value < 0);
+
+    if (value < 0) {
+        buffer[0] = '-';
+    }
+    write_digits(n, buffer + len);
+    buffer[len] = '\0';
+    return len;
+}
+
+/* ====================================================================
+ * GRISU2
+ *
+ * Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers"
+ * (PLDI 2010). The digits always read back as the input. They are the shortest such digits
+ * for all but about one input in a thousand, which gets a longer exact form (146.49512 comes
+ * out as 146.49511999999999); Ryu would close that gap at the cost of much larger tables.
+ * ==================================================================== */
+
+typedef struct {
+    uint64_t f;
+    int      e;
+} diy_fp;
+
+#define DP_SIGNIFICAND_SIZE 52
+#define DP_EXPONENT_BIAS (0x3FF + DP_SIGNIFICAND_SIZE)
+#define DP_HIDDEN_BIT 0x0010000000000000ULL
+#define DP_SIGNIFICAND_MASK 0x000FFFFFFFFFFFFFULL
+#define DP_EXPONENT_MASK 0x7FF0000000000000ULL
+
+/* Normalized 10^k for k = -348, -340, ..., 340 */
+static const uint64_t cached_powers_f[87] = {
+    0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL, 0xcf42894a5dce35eaULL,
+    0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL, 0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL,
+    0xbe5691ef416bd60cULL, 0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+    0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL, 0xc21094364dfb5637ULL,
+    0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL, 0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL,
+    0xb23867fb2a35b28eULL, 0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+    0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL, 0xb5b5ada8aaff80b8ULL,
+    0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL, 0x964e858c91ba2655ULL, 0xdff9772470297ebdULL,
+    0xa6dfbd9fb8e5b88fULL, 0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+    0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL, 0xaa242499697392d3ULL,
+    0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL, 0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL,
+    0x9c40000000000000ULL, 0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+    0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL, 0x9f4f2726179a2245ULL,
+    0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL, 0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL,
+    0x924d692ca61be758ULL, 0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+    0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL, 0x952ab45cfa97a0b3ULL,
+    0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL, 0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL,
+    0x88fcf317f22241e2ULL, 0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+    0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL, 0x8bab8eefb6409c1aULL,
+    0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL, 0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL,
+    0x80444b5e7aa7cf85ULL, 0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+    0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL,
+};
+
+static const int16_t cached_powers_e[87] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+    -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+    -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+    -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+    56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+    694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+    1013, 1039, 1066,
+};
+
+static inline diy_fp diy_fp_from_double(double value) {
+    uint64_t bits;
+    int      biased_e;
+    diy_fp   fp;
+
+    memcpy(&bits, &value, sizeof(bits));
+    biased_e = (int) ((bits & DP_EXPONENT_MASK) >> DP_SIGNIFICAND_SIZE);
+    if (biased_e != 0) {
+        fp.f = (bits & DP_SIGNIFICAND_MASK) + DP_HIDDEN_BIT;
+        fp.e = biased_e - DP_EXPONENT_BIAS;
+    } else {
+        /* Subnormal */
+        fp.f = bits & DP_SIGNIFICAND_MASK;
+        fp.e = 1 - DP_EXPONENT_BIAS;
+    }
+    return fp;
+}
+
+static inline diy_fp diy_fp_multiply(diy_fp x, diy_fp y) {
+    const uint64_t mask = 0xFFFFFFFFULL;
+    uint64_t       a = x.f >> 32, b = x.f & mask, c = y.f >> 32, d = y.f & mask;
+    uint64_t       ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    uint64_t       tmp = (bd >> 32) + (ad & mask) + (bc & mask) + (1ULL << 31);
+    diy_fp         product;
+
+    product.f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+    product.e = x.e + y.e + 64;
+    return product;
+}
+
+static inline diy_fp diy_fp_normalize(diy_fp fp, uint64_t top_bit, int shift) {
+    while (!(fp.f & top_bit)) {
+        fp.f <<= 1;
+        fp.e--;
+    }
+    fp.f <<= shift;
+    fp.e -= shift;
+    return fp;
+}
+
+/* Normalized boundaries of the interval of reals that round to v */
+static void normalized_boundaries(diy_fp v, diy_fp* minus, diy_fp* plus) {
+    diy_fp pl = {(v.f << 1) + 1, v.e - 1};
+    diy_fp mi;
+
+    pl = diy_fp_normalize(pl, DP_HIDDEN_BIT << 1, 64 - DP_SIGNIFICAND_SIZE - 2);
+    if (v.f == DP_HIDDEN_BIT) {
+        /* The lower neighbour is closer at a power of two */
+        mi.f = (v.f << 2) - 1;
+        mi.e = v.e - 2;
+    } else {
+        mi.f = (v.f << 1) - 1;
+        mi.e = v.e - 1;
+    }
+    mi.f <<= mi.e - pl.e;
+    mi.e = pl.e;
+
+    *minus = mi;
+    *plus  = pl;
+}
+
+/* Cached power c with e + c.e in [-60, -32], and its decimal exponent */
+static inline diy_fp cached_power(int e, int* k_out) {
+    double   dk = (-61 - e) * 0.30102999566398114 + 347;
+    int      k  = (int) dk;
+    unsigned index;
+    diy_fp   power;
+
+    if (dk - k > 0.0) {
+        k++;
+    }
+    index   = (unsigned) ((k >> 3) + 1);
+    *k_out  = -(-348 + (int) (index << 3));
+    power.f = cached_powers_f[index];
+    power.e = cached_powers_e[index];
+    return power;
+}
+
+static inline void grisu_round(
+    char* buffer, int len, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w) {
+    while (rest < wp_w && delta - rest >= ten_kappa &&
+           (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+        buffer[len - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+static void digit_gen(diy_fp w, diy_fp mp, uint64_t delta, char* buffer, int* len, int* k) {
+    const int      shift = -mp.e;
+    const uint64_t one   = 1ULL << shift;
+    const uint64_t wp_w  = mp.f - w.f;
+    uint32_t       p1    = (uint32_t) (mp.f >> shift);
+    uint64_t       p2    = mp.f & (one - 1);
+    int            kappa = count_digits(p1);
+
+    *len = 0;
+    while (kappa > 0) {
+        uint32_t digit = (uint32_t) (p1 / pow10_table[kappa - 1]);
+        uint64_t rest;
+
+        p1 = (uint32_t) (p1 % pow10_table[kappa - 1]);
+        if (digit || *len) {
+            buffer[(*len)++] = (char) ('0' + digit);
+        }
+        kappa--;
+        rest = ((uint64_t) p1 << shift) + p2;
+        if (rest <= delta) {
+            *k += kappa;
+            grisu_round(buffer, *len, delta, rest, pow10_table[kappa] << shift, wp_w);
+            return;
+        }
+    }
+
+    for (;;) {
+        char digit;
+
+        p2 *= 10;
+        delta *= 10;
+        digit = (char) (p2 >> shift);
+        if (digit || *len) {
+            buffer[(*len)++] = (char) ('0' + digit);
+        }
+        p2 &= one - 1;
+        kappa--;
+        if (p2 < delta) {
+            *k += kappa;
+            grisu_round(
+                buffer, *len, delta, p2, one, wp_w * (-kappa < 20 ? pow10_table[-kappa] : 0));
+            return;
+        }
+    }
+}
+
+/* Shortest digits of a positive finite value: value = digits * 10^k */
+static int grisu2(double value, char* digits, int* k) {
+    diy_fp v = diy_fp_from_double(value);
+    diy_fp w_minus, w_plus, c_mk, w;
+    int    len;
+
+    normalized_boundaries(v, &w_minus, &w_plus);
+    c_mk = cached_power(w_plus.e, k);
+    w    = diy_fp_multiply(diy_fp_normalize(v, DP_HIDDEN_BIT, 64 - DP_SIGNIFICAND_SIZE - 1), c_mk);
+    w_plus  = diy_fp_multiply(w_plus, c_mk);
+    w_minus = diy_fp_multiply(w_minus, c_mk);
+    w_minus.f++;
+    w_plus.f--;
+    digit_gen(w, w_plus, w_plus.f - w_minus.f, digits, &len, k);
+    return len;
+}
+
+/* ====================================================================
+ * LAYOUT
+ * ==================================================================== */
+
+/* digits[0..len) * 10^k in the layout of "%.17g" */
+static size_t layout_digits(const char* digits, int len, int k, char* out) {
+    int   point = len + k; /* Digits before the decimal point */
+    char* p     = out;
+
+    if (point > 0 && point <= 17) {
+        if (len <= point) {
+            memcpy(p, digits, len);
+            memset(p + len, '0', point - len);
+            p += point;
+        } else {
+            memcpy(p, digits, point);
+            p += point;
+            *p++ = '.';
+            memcpy(p, digits + point, len - point);
+            p += len - point;
+        }
+    } else if (point <= 0 && point > -4) {
+        *p++ = '0';
+        *p++ = '.';
+        memset(p, '0', -point);
+        p += -point;
+        memcpy(p, digits, len);
+        p += len;
+    } else {
+        int exponent = point - 1;
+
+        *p++ = digits[0];
+        if (len > 1) {
+            *p++ = '.';
+            memcpy(p, digits + 1, len - 1);
+            p += len - 1;
+        }
+        *p++ = 'e';
+        if (exponent < 0) {
+            *p++     = '-';
+            exponent = -exponent;
+        } else {
+            *p++ = '+';
+        }
+        if (exponent < 10) {
+            *p++ = '0';
+        }
+        p += count_digits((uint64_t) exponent);
+        write_digits((uint64_t) exponent, p);
+    }
+
+    *p = '\0';
+    return (size_t) (p - out);
+}
+
+size_t valkey_glide_format_double(double value, char* buffer) {
+    char  digits[24];
+    char* p = buffer;
+    int   len, k = 0;
+
+    if (isnan(value)) {
+        memcpy(buffer, "nan", sizeof("nan"));
+        return sizeof("nan") - 1;
+    }
+    if (signbit(value)) {
+        *p++  = '-';
+        value = -value;
+    }
+    if (isinf(value)) {
+        memcpy(p, "inf", sizeof("inf"));
+        return (size_t) (p - buffer) + sizeof("inf") - 1;
+    }
+    if (value == 0) {
+        *p++ = '0';
+        *p   = '\0';
+        return (size_t) (p - buffer);
+    }
+
+    /* Whole numbers below 2^53 are exact, and common as scores and counters */
+    if (value < 9007199254740992.0 && value == (double) (int64_t) value) {
+        return (size_t) (p - buffer) + valkey_glide_format_long((int64_t) value, p);
+    }
+
+    len = grisu2(value, digits, &k);
+    return (size_t) (p - buffer) + layout_digits(digits, len, k, p);
+}
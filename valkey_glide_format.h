@@ -0,0 +1,40 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Number Formatting                                       |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef VALKEY_GLIDE_FORMAT_H
+#define VALKEY_GLIDE_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Integers and doubles as command arguments, without going through snprintf().
+ *
+ * Doubles are written with the shortest digits that read back as the same double (Grisu2),
+ * so scores, coordinates and increments reach the server unrounded: 0.1 is "0.1", not
+ * "0.10000000000000001", and 1.2345678 is not cut to "1.23457". The layout follows "%.17g":
+ * plain notation for decimal exponents from -4 to 16, "1.5e+20" outside, "inf", "-inf" and
+ * "nan".
+ *
+ * Plain C without the PHP headers, so the benchmark in benchmarks/ can build it on its own.
+ */
+
+/* Buffer sizes, with the terminating NUL */
+#define VALKEY_GLIDE_FORMAT_LONG_SIZE 21
+#define VALKEY_GLIDE_FORMAT_DOUBLE_SIZE 32
+
+/* Write the decimal form of value and a NUL to buffer, return its length */
+size_t valkey_glide_format_long(int64_t value, char* buffer);
+size_t valkey_glide_format_double(double value, char* buffer);
+
+#endif /* VALKEY_GLIDE_FORMAT_H */
@@ -22,6 +22,7 @@
 #include <string.h>
 
 #include "command_response.h"
+#include "valkey_glide_args.h"
 #include "valkey_glide_commands_common.h"
 
 /* ====================================================================
@@ -102,33 +103,11 @@ typedef int (*geo_result_processor_t)(CommandResult* result, void* output);
  * FUNCTION PROTOTYPES
  * ==================================================================== */
 
-int prepare_geo_members_args(geo_command_args_t* args,
-                             uintptr_t**         args_out,
-                             unsigned long**     args_len_out,
-                             char***             allocated_strings,
-                             int*                allocated_count);
-
-int prepare_geo_dist_args(geo_command_args_t* args,
-                          uintptr_t**         args_out,
-                          unsigned long**     args_len_out);
-
-int prepare_geo_add_args(geo_command_args_t* args,
-                         uintptr_t**         args_out,
-                         unsigned long**     args_len_out,
-                         char***             allocated_strings,
-                         int*                allocated_count);
-
-int prepare_geo_search_args(geo_command_args_t* args,
-                            uintptr_t**         args_out,
-                            unsigned long**     args_len_out,
-                            char***             allocated_strings,
-                            int*                allocated_count);
-
-int prepare_geo_search_store_args(geo_command_args_t* args,
-                                  uintptr_t**         args_out,
-                                  unsigned long**     args_len_out,
-                                  char***             allocated_strings,
-                                  int*                allocated_count);
+int prepare_geo_members_args(geo_command_args_t* args, valkey_glide_args* cmd_args);
+int prepare_geo_dist_args(geo_command_args_t* args, valkey_glide_args* cmd_args);
+int prepare_geo_add_args(geo_command_args_t* args, valkey_glide_args* cmd_args);
+int prepare_geo_search_args(geo_command_args_t* args, valkey_glide_args* cmd_args);
+int prepare_geo_search_store_args(geo_command_args_t* args, valkey_glide_args* cmd_args);
 
 /* Result processing */
 int process_geo_int_result(CommandResult* result, void* output);
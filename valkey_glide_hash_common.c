@@ -17,6 +17,8 @@
 #include "valkey_glide_hash_common.h"
 
 #include "common.h"
+#include "valkey_glide_arena.h"
+#include "valkey_glide_options.h"
 
 extern zend_class_entry* ce;
 extern zend_class_entry* get_valkey_glide_exception_ce();
@@ -25,89 +27,73 @@ extern zend_class_entry* get_valkey_glide_exception_ce();
  * ==================================================================== */
 
 /**
- * Generic hash command execution framework
+ * Build the arguments of a hash command. Returns the argument count, 0 on failure.
  */
-int execute_h_generic_command(const void*          glide_client,
-                              enum RequestType     cmd_type,
-                              h_command_args_t*    args,
-                              void*                result_ptr,
-                              h_result_processor_t process_result) {
-    uintptr_t*     cmd_args          = NULL;
-    unsigned long* args_len          = NULL;
-    char**         allocated_strings = NULL;
-    int            allocated_count   = 0;
-    int            arg_count         = 0;
-    int            status            = 0;
-
-    /* Validate basic arguments */
-    VALIDATE_HASH_ARGS(glide_client, args->key);
-
-    /* Prepare arguments based on command type */
+static int prepare_h_args(enum RequestType   cmd_type,
+                          h_command_args_t*  args,
+                          valkey_glide_args* cmd_args) {
     switch (cmd_type) {
         case HLen:
-            arg_count = prepare_h_key_only_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
+        case HKeys:
+        case HVals:
+        case HGetAll:
+            return prepare_h_key_only_args(args, cmd_args);
         case HGet:
         case HExists:
         case HStrlen:
-            arg_count = prepare_h_single_field_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
+            return prepare_h_single_field_args(args, cmd_args);
         case HSetNX:
-            arg_count = prepare_h_field_value_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
+            return prepare_h_field_value_args(args, cmd_args);
         case HDel:
         case HMGet:
-            arg_count = prepare_h_multi_field_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
+            return prepare_h_multi_field_args(args, cmd_args);
         case HSet:
-            arg_count = prepare_h_set_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
+            return prepare_h_set_args(args, cmd_args);
         case HMSet:
-            arg_count = prepare_h_mset_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
+            return prepare_h_mset_args(args, cmd_args);
         case HIncrBy:
         case HIncrByFloat:
-            arg_count = prepare_h_incr_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
+            return prepare_h_incr_args(args, cmd_args);
         case HRandField:
-            arg_count = prepare_h_randfield_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
-        case HKeys:
-        case HVals:
-        case HGetAll:
-            arg_count = prepare_h_key_only_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
+            return prepare_h_randfield_args(args, cmd_args);
         default:
             return 0;
     }
+}
 
-    if (arg_count <= 0) {
-        goto cleanup;
-    }
+/**
+ * Generic hash command execution framework
+ */
+int execute_h_generic_command(const void*          glide_client,
+                              enum RequestType     cmd_type,
+                              h_command_args_t*    args,
+                              void*                result_ptr,
+                              h_result_processor_t process_result) {
+    valkey_glide_args  cmd_args;
+    int                status = 0;
+    valkey_glide_arena arena;
 
-    /* Execute the command */
-    CommandResult* result = execute_command(glide_client, cmd_type, arg_count, cmd_args, args_len);
+    /* Validate basic arguments */
+    VALIDATE_HASH_ARGS(glide_client, args->key);
 
-    /* Process result */
-    if (result) {
-        if (!result->command_error && result->response && process_result) {
-            status = process_result(result, result_ptr);
+    valkey_glide_arena_enter(&arena);
+    valkey_glide_args_init(&cmd_args);
+
+    if (prepare_h_args(cmd_type, args, &cmd_args) > 0) {
+        CommandResult* result =
+            valkey_glide_args_execute(glide_client, cmd_type, &cmd_args, NULL);
+
+        /* Process result */
+        if (result) {
+            if (!result->command_error && result->response && process_result) {
+                status = process_result(result, result_ptr);
+            }
+            free_command_result(result);
         }
-        free_command_result(result);
     }
 
-cleanup:
-    /* Clean up allocated resources */
-    cleanup_h_command_args(allocated_strings, allocated_count, cmd_args, args_len);
+    valkey_glide_args_free(&cmd_args);
+    valkey_glide_arena_leave(&arena);
     return status;
 }
 
@@ -119,62 +105,21 @@ int execute_h_simple_command(const void*       glide_client,
                              h_command_args_t* args,
                              void*             result_ptr,
                              int               response_type) {
-    uintptr_t*     cmd_args          = NULL;
-    unsigned long* args_len          = NULL;
-    char**         allocated_strings = NULL;
-    int            allocated_count   = 0;
-    int            arg_count         = 0;
-    int            status            = 0;
+    valkey_glide_args  cmd_args;
+    int                status = 0;
+    CommandResult*     result = NULL;
+    valkey_glide_arena arena;
 
     /* Validate basic arguments */
     VALIDATE_HASH_ARGS(glide_client, args->key);
 
-    /* Prepare arguments based on command type */
-    switch (cmd_type) {
-        case HLen:
-        case HKeys:
-        case HVals:
-        case HGetAll:
-            arg_count = prepare_h_key_only_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
-        case HGet:
-        case HExists:
-        case HStrlen:
-            arg_count = prepare_h_single_field_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
-        case HSetNX:
-            arg_count = prepare_h_field_value_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
-        case HDel:
-            arg_count = prepare_h_multi_field_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
-        case HSet:
-            arg_count = prepare_h_set_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
-        case HMSet:
-            arg_count = prepare_h_mset_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
-        case HIncrBy:
-            arg_count = prepare_h_incr_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
-        default:
-            goto cleanup;
-    }
+    valkey_glide_arena_enter(&arena);
+    valkey_glide_args_init(&cmd_args);
 
-    if (arg_count <= 0) {
-        goto cleanup;
+    if (prepare_h_args(cmd_type, args, &cmd_args) > 0) {
+        result = valkey_glide_args_execute(glide_client, cmd_type, &cmd_args, NULL);
     }
 
-    /* Execute the command */
-    CommandResult* result = execute_command(glide_client, cmd_type, arg_count, cmd_args, args_len);
-
     /* Process result using standard handlers */
     if (result) {
         switch (response_type) {
@@ -207,13 +152,10 @@ int execute_h_simple_command(const void*       glide_client,
                 break;
         }
         /* Note: handle_* functions free the result internally */
-    } else {
-        status = 0;
     }
 
-cleanup:
-    /* Clean up allocated resources */
-    cleanup_h_command_args(allocated_strings, allocated_count, cmd_args, args_len);
+    valkey_glide_args_free(&cmd_args);
+    valkey_glide_arena_leave(&arena);
     return status;
 }
 
@@ -224,412 +166,201 @@ cleanup:
 /**
  * Prepare arguments for single-key commands (HLEN, HKEYS, HVALS, HGETALL)
  */
-int prepare_h_key_only_args(h_command_args_t* args,
-                            uintptr_t**       args_out,
-                            unsigned long**   args_len_out,
-                            char***           allocated_strings,
-                            int*              allocated_count) {
-    /* Allocate argument arrays */
-    *args_out          = (uintptr_t*) emalloc(sizeof(uintptr_t));
-    *args_len_out      = (unsigned long*) emalloc(sizeof(unsigned long));
-    *allocated_strings = NULL;
-    *allocated_count   = 0;
-
-    if (!*args_out || !*args_len_out) {
-        if (*args_out)
-            efree(*args_out);
-        if (*args_len_out)
-            efree(*args_len_out);
-        return 0;
-    }
-
-    /* Set key as the only argument */
-    (*args_out)[0]     = (uintptr_t) args->key;
-    (*args_len_out)[0] = args->key_len;
+int prepare_h_key_only_args(h_command_args_t* args, valkey_glide_args* cmd_args) {
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
 
-    return 1;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for single-field commands (HGET, HEXISTS, HSTRLEN)
  */
-int prepare_h_single_field_args(h_command_args_t* args,
-                                uintptr_t**       args_out,
-                                unsigned long**   args_len_out,
-                                char***           allocated_strings,
-                                int*              allocated_count) {
+int prepare_h_single_field_args(h_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->field) {
         return 0;
     }
 
-    /* Allocate argument arrays */
-    *args_out          = (uintptr_t*) emalloc(2 * sizeof(uintptr_t));
-    *args_len_out      = (unsigned long*) emalloc(2 * sizeof(unsigned long));
-    *allocated_strings = NULL;
-    *allocated_count   = 0;
-
-    if (!*args_out || !*args_len_out) {
-        if (*args_out)
-            efree(*args_out);
-        if (*args_len_out)
-            efree(*args_len_out);
-        return 0;
-    }
-
-    /* Set key and field arguments */
-    (*args_out)[0]     = (uintptr_t) args->key;
-    (*args_len_out)[0] = args->key_len;
-    (*args_out)[1]     = (uintptr_t) args->field;
-    (*args_len_out)[1] = args->field_len;
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
+    valkey_glide_args_add(cmd_args, args->field, args->field_len);
 
-    return 2;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for field-value commands (HSETNX)
  */
-int prepare_h_field_value_args(h_command_args_t* args,
-                               uintptr_t**       args_out,
-                               unsigned long**   args_len_out,
-                               char***           allocated_strings,
-                               int*              allocated_count) {
+int prepare_h_field_value_args(h_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->field || !args->value) {
         return 0;
     }
 
-    /* Allocate argument arrays */
-    *args_out          = (uintptr_t*) emalloc(3 * sizeof(uintptr_t));
-    *args_len_out      = (unsigned long*) emalloc(3 * sizeof(unsigned long));
-    *allocated_strings = NULL;
-    *allocated_count   = 0;
-
-    if (!*args_out || !*args_len_out) {
-        if (*args_out)
-            efree(*args_out);
-        if (*args_len_out)
-            efree(*args_len_out);
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
+    valkey_glide_args_add(cmd_args, args->field, args->field_len);
+    if (!valkey_glide_args_add_value_string(cmd_args, args->value, args->value_len)) {
         return 0;
     }
 
-    /* Set key, field, and value arguments */
-    (*args_out)[0]     = (uintptr_t) args->key;
-    (*args_len_out)[0] = args->key_len;
-    (*args_out)[1]     = (uintptr_t) args->field;
-    (*args_len_out)[1] = args->field_len;
-    (*args_out)[2]     = (uintptr_t) args->value;
-    (*args_len_out)[2] = args->value_len;
-
-    return 3;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for multi-field commands (HDEL, HMGET)
  */
-int prepare_h_multi_field_args(h_command_args_t* args,
-                               uintptr_t**       args_out,
-                               unsigned long**   args_len_out,
-                               char***           allocated_strings,
-                               int*              allocated_count) {
+int prepare_h_multi_field_args(h_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->fields || args->field_count <= 0) {
         return 0;
     }
 
-    /* Calculate total argument count: key + fields */
-    unsigned long arg_count = 1 + args->field_count;
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
+    for (int i = 0; i < args->field_count; i++) {
+        if (!valkey_glide_args_add_zval(cmd_args, &args->fields[i])) {
+            return 0;
+        }
+    }
 
-    /* Allocate argument arrays */
-    *args_out          = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-    *args_len_out      = (unsigned long*) emalloc(arg_count * sizeof(unsigned long));
-    *allocated_strings = (char**) emalloc(args->field_count * sizeof(char*));
-    *allocated_count   = 0;
+    return cmd_args->count;
+}
 
-    if (!*args_out || !*args_len_out || !*allocated_strings) {
-        if (*args_out)
-            efree(*args_out);
-        if (*args_len_out)
-            efree(*args_len_out);
-        if (*allocated_strings)
-            efree(*allocated_strings);
-        return 0;
+/**
+ * Add the value of a field. Without a serializer, values PHP cannot turn into a string are
+ * still stored: arrays as "Array", objects without __toString() as their class name.
+ */
+static bool h_add_field_value(valkey_glide_args* cmd_args, zval* value) {
+    if (valkey_glide_options_encode_values(valkey_glide_current_options())) {
+        return valkey_glide_args_add_value(cmd_args, value);
+    }
+
+    ZVAL_DEREF(value);
+    switch (Z_TYPE_P(value)) {
+        case IS_FALSE:
+            valkey_glide_args_add_literal(cmd_args, "0");
+            return true;
+        case IS_ARRAY:
+            valkey_glide_args_add_literal(cmd_args, "Array");
+            return true;
+        case IS_RESOURCE:
+            valkey_glide_args_add_literal(cmd_args, "Resource");
+            return true;
+        case IS_OBJECT:
+            if (!Z_OBJCE_P(value)->__tostring) {
+                zend_string* class_name = Z_OBJCE_P(value)->name;
+
+                valkey_glide_args_add(cmd_args, ZSTR_VAL(class_name), ZSTR_LEN(class_name));
+                return true;
+            }
+            return valkey_glide_args_add_zval(cmd_args, value);
+        default:
+            return valkey_glide_args_add_zval(cmd_args, value);
     }
+}
 
-    /* Set key as first argument */
-    (*args_out)[0]     = (uintptr_t) args->key;
-    (*args_len_out)[0] = args->key_len;
+/**
+ * Add the field-value pairs of an associative array
+ */
+static int h_add_field_value_pairs(valkey_glide_args* cmd_args, zval* field_values) {
+    zval*        data;
+    zend_string* hash_key;
+    zend_ulong   num_idx;
 
-    /* Convert and add fields */
-    return convert_zval_array_to_args(args->fields,
-                                      1,
-                                      *args_out,
-                                      *args_len_out,
-                                      *allocated_strings,
-                                      allocated_count,
-                                      args->field_count);
+    ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(field_values), num_idx, hash_key, data) {
+        if (hash_key) {
+            valkey_glide_args_add(cmd_args, ZSTR_VAL(hash_key), ZSTR_LEN(hash_key));
+        } else {
+            valkey_glide_args_add_long(cmd_args, (zend_long) num_idx);
+        }
+        if (!h_add_field_value(cmd_args, data)) {
+            return 0;
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for HSET command (handles both formats)
  */
-int prepare_h_set_args(h_command_args_t* args,
-                       uintptr_t**       args_out,
-                       unsigned long**   args_len_out,
-                       char***           allocated_strings,
-                       int*              allocated_count) {
+int prepare_h_set_args(h_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->field_values) {
         return 0;
     }
 
     /* Handle associative array format */
     if (args->is_array_arg) {
-        if (args->fv_count != 1 || Z_TYPE(args->field_values[0]) != IS_ARRAY) {
-            return 0;
-        }
-
-        zval*      z_array     = &args->field_values[0];
-        HashTable* ht          = Z_ARRVAL_P(z_array);
-        int        pairs_count = zend_hash_num_elements(ht);
-
-        if (pairs_count == 0) {
-            return 0;
-        }
-
-        /* Prepare command arguments: key + field-value pairs */
-        unsigned long arg_count = 1 + (pairs_count * 2);
-        *args_out               = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-        *args_len_out           = (unsigned long*) emalloc(arg_count * sizeof(unsigned long));
-        *allocated_strings      = (char**) emalloc((pairs_count * 2) * sizeof(char*));
-        *allocated_count        = 0;
-
-        if (!*args_out || !*args_len_out || !*allocated_strings) {
-            if (*args_out)
-                efree(*args_out);
-            if (*args_len_out)
-                efree(*args_len_out);
-            if (*allocated_strings)
-                efree(*allocated_strings);
+        if (args->fv_count != 1 || Z_TYPE(args->field_values[0]) != IS_ARRAY ||
+            zend_hash_num_elements(Z_ARRVAL(args->field_values[0])) == 0) {
             return 0;
         }
 
-        /* First argument: key */
-        (*args_out)[0]     = (uintptr_t) args->key;
-        (*args_len_out)[0] = args->key_len;
+        valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
+        return h_add_field_value_pairs(cmd_args, &args->field_values[0]);
+    }
 
-        /* Process field-value pairs */
-        return process_field_value_pairs(
-            z_array, *args_out, *args_len_out, 1, *allocated_strings, allocated_count);
-    } else {
-        /* Original variadic usage */
-        if (args->fv_count < 2 || args->fv_count % 2 != 0) {
-            return 0;
-        }
+    /* Original variadic usage: alternating fields and values */
+    if (args->fv_count < 2 || args->fv_count % 2 != 0) {
+        return 0;
+    }
 
-        /* Prepare command arguments: key + field/value pairs */
-        unsigned long arg_count = 1 + args->fv_count;
-        *args_out               = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-        *args_len_out           = (unsigned long*) emalloc(arg_count * sizeof(unsigned long));
-        *allocated_strings      = (char**) emalloc(args->fv_count * sizeof(char*));
-        *allocated_count        = 0;
-
-        if (!*args_out || !*args_len_out || !*allocated_strings) {
-            if (*args_out)
-                efree(*args_out);
-            if (*args_len_out)
-                efree(*args_len_out);
-            if (*allocated_strings)
-                efree(*allocated_strings);
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
+    for (int i = 0; i < args->fv_count; i += 2) {
+        if (!valkey_glide_args_add_zval(cmd_args, &args->field_values[i]) ||
+            !valkey_glide_args_add_value(cmd_args, &args->field_values[i + 1])) {
             return 0;
         }
-
-        /* First argument: key */
-        (*args_out)[0]     = (uintptr_t) args->key;
-        (*args_len_out)[0] = args->key_len;
-
-        /* Convert field/value pairs */
-        return convert_zval_array_to_args(args->field_values,
-                                          1,
-                                          *args_out,
-                                          *args_len_out,
-                                          *allocated_strings,
-                                          allocated_count,
-                                          args->fv_count);
     }
+
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for HMSET command
  */
-int prepare_h_mset_args(h_command_args_t* args,
-                        uintptr_t**       args_out,
-                        unsigned long**   args_len_out,
-                        char***           allocated_strings,
-                        int*              allocated_count) {
+int prepare_h_mset_args(h_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->field_values || args->fv_count <= 0) {
         return 0;
     }
 
     /* HMSET expects an associative array */
-    HashTable*    ht          = Z_ARRVAL_P(args->field_values);
-    int           pairs_count = zend_hash_num_elements(ht);
-    unsigned long arg_count   = 1 + (pairs_count * 2);
-
-    *args_out          = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-    *args_len_out      = (unsigned long*) emalloc(arg_count * sizeof(unsigned long));
-    *allocated_strings = (char**) emalloc((pairs_count * 2) * sizeof(char*));
-    *allocated_count   = 0;
-
-    if (!*args_out || !*args_len_out || !*allocated_strings) {
-        if (*args_out)
-            efree(*args_out);
-        if (*args_len_out)
-            efree(*args_len_out);
-        if (*allocated_strings)
-            efree(*allocated_strings);
-        return 0;
-    }
-
-    /* First argument: key */
-    (*args_out)[0]     = (uintptr_t) args->key;
-    (*args_len_out)[0] = args->key_len;
-
-    /* Process field-value pairs */
-    return process_field_value_pairs(
-        args->field_values, *args_out, *args_len_out, 1, *allocated_strings, allocated_count);
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
+    return h_add_field_value_pairs(cmd_args, args->field_values);
 }
 
 /**
  * Prepare arguments for increment commands (HINCRBY, HINCRBYFLOAT)
  */
-int prepare_h_incr_args(h_command_args_t* args,
-                        uintptr_t**       args_out,
-                        unsigned long**   args_len_out,
-                        char***           allocated_strings,
-                        int*              allocated_count) {
+int prepare_h_incr_args(h_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->field) {
         return 0;
     }
 
-    /* Allocate argument arrays */
-    *args_out          = (uintptr_t*) emalloc(3 * sizeof(uintptr_t));
-    *args_len_out      = (unsigned long*) emalloc(3 * sizeof(unsigned long));
-    *allocated_strings = (char**) emalloc(sizeof(char*));
-    *allocated_count   = 0;
-
-    if (!*args_out || !*args_len_out || !*allocated_strings) {
-        if (*args_out)
-            efree(*args_out);
-        if (*args_len_out)
-            efree(*args_len_out);
-        if (*allocated_strings)
-            efree(*allocated_strings);
-        return 0;
-    }
-
-    /* Set key and field arguments */
-    (*args_out)[0]     = (uintptr_t) args->key;
-    (*args_len_out)[0] = args->key_len;
-    (*args_out)[1]     = (uintptr_t) args->field;
-    (*args_len_out)[1] = args->field_len;
-
-    /* Convert increment value to string */
-    char*  incr_str;
-    size_t incr_len;
-
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
+    valkey_glide_args_add(cmd_args, args->field, args->field_len);
     if (args->float_incr != 0.0) {
         /* HINCRBYFLOAT */
-        incr_str = double_to_string(args->float_incr, &incr_len);
+        valkey_glide_args_add_double(cmd_args, args->float_incr);
     } else {
         /* HINCRBY */
-        incr_str = long_to_string(args->increment, &incr_len);
-    }
-
-    if (!incr_str) {
-        efree(*args_out);
-        efree(*args_len_out);
-        efree(*allocated_strings);
-        return 0;
+        valkey_glide_args_add_long(cmd_args, args->increment);
     }
 
-    (*allocated_strings)[0] = incr_str;
-    *allocated_count        = 1;
-
-    (*args_out)[2]     = (uintptr_t) incr_str;
-    (*args_len_out)[2] = incr_len;
-
-    return 3;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for HRANDFIELD command
  */
-int prepare_h_randfield_args(h_command_args_t* args,
-                             uintptr_t**       args_out,
-                             unsigned long**   args_len_out,
-                             char***           allocated_strings,
-                             int*              allocated_count) {
-    /* Calculate argument count */
-    unsigned long arg_count      = 1; /* key */
-    int           need_count_str = 0;
-
-    if (args->count != 1) {
-        arg_count++; /* count */
-        need_count_str = 1;
-    }
-    if (args->withvalues) {
-        arg_count++; /* WITHVALUES */
-        if (need_count_str == 0) {
-            arg_count++; /* count (required with WITHVALUES) */
-            need_count_str = 1;
-        }
-    }
-
-    *args_out          = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-    *args_len_out      = (unsigned long*) emalloc(arg_count * sizeof(unsigned long));
-    *allocated_strings = need_count_str ? (char**) emalloc(sizeof(char*)) : NULL;
-    *allocated_count   = 0;
-
-    if (!*args_out || !*args_len_out || (need_count_str && !*allocated_strings)) {
-        if (*args_out)
-            efree(*args_out);
-        if (*args_len_out)
-            efree(*args_len_out);
-        if (*allocated_strings)
-            efree(*allocated_strings);
-        return 0;
-    }
-
-    /* First argument: key */
-    int arg_idx              = 0;
-    (*args_out)[arg_idx]     = (uintptr_t) args->key;
-    (*args_len_out)[arg_idx] = args->key_len;
-    arg_idx++;
-
-    /* Add count if needed */
-    if (need_count_str) {
-        char* count_str = long_to_string(args->count, &(*args_len_out)[arg_idx]);
-        if (!count_str) {
-            efree(*args_out);
-            efree(*args_len_out);
-            if (*allocated_strings)
-                efree(*allocated_strings);
-            return 0;
-        }
+int prepare_h_randfield_args(h_command_args_t* args, valkey_glide_args* cmd_args) {
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
 
-        (*allocated_strings)[0] = count_str;
-        *allocated_count        = 1;
-
-        (*args_out)[arg_idx] = (uintptr_t) count_str;
-        arg_idx++;
+    /* The count is required with WITHVALUES */
+    if (args->count != 1 || args->withvalues) {
+        valkey_glide_args_add_long(cmd_args, args->count);
     }
-
-    /* Add WITHVALUES if specified */
     if (args->withvalues) {
-        const char* withvalues_str = "WITHVALUES";
-        (*args_out)[arg_idx]       = (uintptr_t) withvalues_str;
-        (*args_len_out)[arg_idx]   = strlen(withvalues_str);
-        arg_idx++;
+        valkey_glide_args_add_literal(cmd_args, "WITHVALUES");
     }
 
-    return arg_count;
+    return cmd_args->count;
 }
 
 /* ====================================================================
@@ -674,7 +405,10 @@ int process_h_mget_result(CommandResult* result, void* output) {
             struct CommandResponse* element = &result->response->array_value[i];
 
             if (element->response_type == String) {
-                ZVAL_STRINGL(&field_value, element->string_value, element->string_value_len);
+                valkey_glide_unserialize(valkey_glide_current_options(),
+                                         element->string_value,
+                                         element->string_value_len,
+                                         &field_value);
             } else if (element->response_type == Null) {
                 ZVAL_FALSE(&field_value);
             } else {
@@ -743,47 +477,15 @@ int process_h_randfield_result(CommandResult* result, void* output) {
         }
         /* Fields with values (associative) */
         else if (args->withvalues) {
-            // ret_val = command_response_to_zval(result->response, return_value,
-            // COMMAND_RESPONSE_ASSOSIATIVE_ARRAY_MAP, false);
-            size_t i;
-            for (i = 0; i < result->response->array_value_len; i++) {
-                ret_val                         = 1;
-                struct CommandResponse* element = &result->response->array_value[i];
-
-                // Each element should be an array with a field and value
-                if (element->response_type == Array && element->array_value_len == 2) {
-                    struct CommandResponse* field = &element->array_value[0];
-                    struct CommandResponse* value = &element->array_value[1];
-
-                    if (field->response_type == String) {
-                        if (value->response_type == String) {
-                            add_assoc_stringl_ex(return_value,
-                                                 field->string_value,
-                                                 field->string_value_len,
-                                                 value->string_value,
-                                                 value->string_value_len);
-                        } else if (value->response_type == Null) {
-                            add_assoc_null_ex(
-                                return_value, field->string_value, field->string_value_len);
-                        } else if (value->response_type == Int) {
-                            add_assoc_long_ex(return_value,
-                                              field->string_value,
-                                              field->string_value_len,
-                                              value->int_value);
-                        } else if (value->response_type == Float) {
-                            add_assoc_double_ex(return_value,
-                                                field->string_value,
-                                                field->string_value_len,
-                                                value->float_value);
-                        } else if (value->response_type == Bool) {
-                            add_assoc_bool_ex(return_value,
-                                              field->string_value,
-                                              field->string_value_len,
-                                              value->bool_value);
-                        }
-                    }
-                }
+            /* A missing key is an empty reply, returned as false */
+            zval_ptr_dtor(return_value);
+            command_response_to_shape_zval(
+                result->response, command_response_shape(HRandField), return_value, false);
+            if (Z_TYPE_P(return_value) != IS_ARRAY) {
+                zval_ptr_dtor(return_value);
+                array_init(return_value);
             }
+            ret_val = zend_hash_num_elements(Z_ARRVAL_P(return_value)) > 0;
         }
     }
 
@@ -835,211 +537,11 @@ int process_h_getall_result(CommandResult* result, void* output) {
     }
 
     /* Convert response to associative array */
-    return command_response_to_zval(
+    int status = command_response_to_zval(
         result->response, return_value, COMMAND_RESPONSE_ASSOSIATIVE_ARRAY_MAP, false);
-}
-
-/* ====================================================================
- * UTILITY FUNCTIONS
- * ==================================================================== */
 
-/**
- * Convert zval array to command arguments with proper string conversion
- */
-int convert_zval_array_to_args(zval*          z_array,
-                               int            start_index,
-                               uintptr_t*     args,
-                               unsigned long* args_len,
-                               char**         allocated_strings,
-                               int*           allocated_count,
-                               int            max_allocations) {
-    int current_arg = start_index;
-
-    for (int i = 0; i < max_allocations; i++) {
-        zval*  value = &z_array[i];
-        size_t str_len;
-        int    need_free;
-
-        char* str_val = zval_to_string_safe(value, &str_len, &need_free);
-        if (!str_val) {
-            return 0;
-        }
-
-        args[current_arg]     = (uintptr_t) str_val;
-        args_len[current_arg] = str_len;
-
-        if (need_free) {
-            allocated_strings[*allocated_count] = str_val;
-            (*allocated_count)++;
-        }
-
-        current_arg++;
-    }
-
-    return current_arg;
-}
-
-/**
- * Process field-value pairs from associative array
- */
-int process_field_value_pairs(zval*          field_values,
-                              uintptr_t*     args,
-                              unsigned long* args_len,
-                              int            start_index,
-                              char**         allocated_strings,
-                              int*           allocated_count) {
-    HashTable*   ht = Z_ARRVAL_P(field_values);
-    zval*        data;
-    zend_string* hash_key;
-    zend_ulong   num_idx;
-    int          arg_idx = start_index;
-
-    ZEND_HASH_FOREACH_KEY_VAL(ht, num_idx, hash_key, data) {
-        /* Add field */
-        if (hash_key) {
-            /* Associative array: key is the field */
-            args[arg_idx]     = (uintptr_t) ZSTR_VAL(hash_key);
-            args_len[arg_idx] = ZSTR_LEN(hash_key);
-        } else {
-            /* Numeric index - convert to string */
-            char* field_str = long_to_string(num_idx, &args_len[arg_idx]);
-            if (!field_str) {
-                return 0;
-            }
-            args[arg_idx]                       = (uintptr_t) field_str;
-            allocated_strings[*allocated_count] = field_str;
-            (*allocated_count)++;
-        }
-        arg_idx++;
-
-        /* Add value with enhanced type handling */
-        size_t str_len;
-        int    need_free;
-        char*  str_val = NULL;
-
-        /* Handle different zval types appropriately */
-        switch (Z_TYPE_P(data)) {
-            case IS_NULL:
-                /* Convert NULL to empty string */
-                str_val   = estrdup("");
-                str_len   = 0;
-                need_free = 1;
-                break;
-
-            case IS_FALSE:
-                /* Convert false to "0" */
-                str_val   = estrdup("0");
-                str_len   = 1;
-                need_free = 1;
-                break;
-
-            case IS_TRUE:
-                /* Convert true to "1" */
-                str_val   = estrdup("1");
-                str_len   = 1;
-                need_free = 1;
-                break;
-
-            case IS_ARRAY:
-                /* Convert array to JSON representation */
-                {
-                    smart_str json_str = {0};
-
-                    {
-                        /* Fallback to "Array" if JSON encoding fails */
-                        str_val   = estrdup("Array");
-                        str_len   = 5;
-                        need_free = 1;
-                        if (json_str.s)
-                            smart_str_free(&json_str);
-                    }
-                }
-                break;
-
-            case IS_OBJECT:
-                /* Try to convert object to string */
-                if (Z_OBJ_HT_P(data)->cast_object) {
-                    zval tmp;
-                    if (Z_OBJ_HT_P(data)->cast_object(Z_OBJ_P(data), &tmp, IS_STRING) == SUCCESS) {
-                        str_val   = estrndup(Z_STRVAL(tmp), Z_STRLEN(tmp));
-                        str_len   = Z_STRLEN(tmp);
-                        need_free = 1;
-                        zval_ptr_dtor(&tmp);
-                    } else {
-                        /* Fallback to object class name */
-                        zend_string* class_name = Z_OBJCE_P(data)->name;
-                        str_val   = estrndup(ZSTR_VAL(class_name), ZSTR_LEN(class_name));
-                        str_len   = ZSTR_LEN(class_name);
-                        need_free = 1;
-                    }
-                } else {
-                    /* No cast_object handler, use class name */
-                    zend_string* class_name = Z_OBJCE_P(data)->name;
-                    str_val                 = estrndup(ZSTR_VAL(class_name), ZSTR_LEN(class_name));
-                    str_len                 = ZSTR_LEN(class_name);
-                    need_free               = 1;
-                }
-                break;
-
-            case IS_RESOURCE:
-                /* Convert resource to string representation */
-                str_val   = estrdup("Resource");
-                str_len   = 8;
-                need_free = 1;
-                break;
-
-            default:
-                /* Use standard conversion for strings, numbers, etc. */
-                str_val = zval_to_string_safe(data, &str_len, &need_free);
-                break;
-        }
-
-        if (!str_val) {
-            /* Final fallback - should not happen with above handling */
-            str_val   = estrdup("unknown");
-            str_len   = 7;
-            need_free = 1;
-        }
-
-        args[arg_idx]     = (uintptr_t) str_val;
-        args_len[arg_idx] = str_len;
-
-        if (need_free) {
-            allocated_strings[*allocated_count] = str_val;
-            (*allocated_count)++;
-        }
-
-        arg_idx++;
-    }
-    ZEND_HASH_FOREACH_END();
-
-    return arg_idx;
-}
-
-/**
- * Safe cleanup for allocated argument strings
- */
-void cleanup_h_command_args(char**         allocated_strings,
-                            int            allocated_count,
-                            uintptr_t*     args,
-                            unsigned long* args_len) {
-    /* Free allocated strings */
-    if (allocated_strings) {
-        for (int i = 0; i < allocated_count; i++) {
-            if (allocated_strings[i]) {
-                efree(allocated_strings[i]);
-            }
-        }
-        efree(allocated_strings);
-    }
-
-    /* Free argument arrays */
-    if (args) {
-        efree(args);
-    }
-    if (args_len) {
-        efree(args_len);
-    }
+    valkey_glide_unserialize_array(valkey_glide_current_options(), return_value);
+    return status;
 }
 
 /* ====================================================================
@@ -1358,7 +860,8 @@ int execute_hget_command(zval* object, int argc, zval* return_value, zend_class_
 
     /* Process the result */
     if (result == 1 && response != NULL) {
-        ZVAL_STRINGL(return_value, response, response_len);
+        valkey_glide_unserialize(
+            valkey_glide_current_options(), response, response_len, return_value);
         efree(response);
         return 1;
     } else if (result == 0) {
@@ -1786,7 +1289,11 @@ int execute_hvals_command(zval* object, int argc, zval* return_value, zend_class
     array_init(return_value);
 
     /* Execute the HVALS command */
-    return execute_h_vals_command(valkey_glide->glide_client, key, key_len, return_value);
+    if (!execute_h_vals_command(valkey_glide->glide_client, key, key_len, return_value)) {
+        return 0;
+    }
+    valkey_glide_unserialize_array(valkey_glide_current_options(), return_value);
+    return 1;
 }
 
 /**
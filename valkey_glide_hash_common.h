@@ -23,6 +23,7 @@
 
 #include "command_response.h"
 #include "include/glide_bindings.h"
+#include "valkey_glide_args.h"
 #include "valkey_glide_commands_common.h"
 
 /* ====================================================================
@@ -67,15 +68,6 @@ typedef struct _h_command_args_t {
  */
 typedef int (*h_result_processor_t)(CommandResult* result, void* output);
 
-/**
- * Argument preparation function type
- */
-typedef int (*h_arg_preparer_t)(h_command_args_t* args,
-                                uintptr_t**       args_out,
-                                unsigned long**   args_len_out,
-                                char***           allocated_strings,
-                                int*              allocated_count);
-
 /* ====================================================================
  * CORE FRAMEWORK FUNCTIONS
  * ==================================================================== */
@@ -105,74 +97,42 @@ int execute_h_simple_command(const void*       glide_client,
 /**
  * Prepare arguments for single-key commands (HLEN)
  */
-int prepare_h_key_only_args(h_command_args_t* args,
-                            uintptr_t**       args_out,
-                            unsigned long**   args_len_out,
-                            char***           allocated_strings,
-                            int*              allocated_count);
+int prepare_h_key_only_args(h_command_args_t* args, valkey_glide_args* cmd_args);
 
 /**
  * Prepare arguments for single-field commands (HGET, HEXISTS, HSTRLEN)
  */
-int prepare_h_single_field_args(h_command_args_t* args,
-                                uintptr_t**       args_out,
-                                unsigned long**   args_len_out,
-                                char***           allocated_strings,
-                                int*              allocated_count);
+int prepare_h_single_field_args(h_command_args_t* args, valkey_glide_args* cmd_args);
 
 /**
  * Prepare arguments for field-value commands (HSETNX)
  */
-int prepare_h_field_value_args(h_command_args_t* args,
-                               uintptr_t**       args_out,
-                               unsigned long**   args_len_out,
-                               char***           allocated_strings,
-                               int*              allocated_count);
+int prepare_h_field_value_args(h_command_args_t* args, valkey_glide_args* cmd_args);
 
 /**
  * Prepare arguments for multi-field commands (HDEL, HMGET)
  */
-int prepare_h_multi_field_args(h_command_args_t* args,
-                               uintptr_t**       args_out,
-                               unsigned long**   args_len_out,
-                               char***           allocated_strings,
-                               int*              allocated_count);
+int prepare_h_multi_field_args(h_command_args_t* args, valkey_glide_args* cmd_args);
 
 /**
  * Prepare arguments for HSET command (handles both formats)
  */
-int prepare_h_set_args(h_command_args_t* args,
-                       uintptr_t**       args_out,
-                       unsigned long**   args_len_out,
-                       char***           allocated_strings,
-                       int*              allocated_count);
+int prepare_h_set_args(h_command_args_t* args, valkey_glide_args* cmd_args);
 
 /**
  * Prepare arguments for HMSET command
  */
-int prepare_h_mset_args(h_command_args_t* args,
-                        uintptr_t**       args_out,
-                        unsigned long**   args_len_out,
-                        char***           allocated_strings,
-                        int*              allocated_count);
+int prepare_h_mset_args(h_command_args_t* args, valkey_glide_args* cmd_args);
 
 /**
  * Prepare arguments for increment commands (HINCRBY, HINCRBYFLOAT)
  */
-int prepare_h_incr_args(h_command_args_t* args,
-                        uintptr_t**       args_out,
-                        unsigned long**   args_len_out,
-                        char***           allocated_strings,
-                        int*              allocated_count);
+int prepare_h_incr_args(h_command_args_t* args, valkey_glide_args* cmd_args);
 
 /**
  * Prepare arguments for HRANDFIELD command
  */
-int prepare_h_randfield_args(h_command_args_t* args,
-                             uintptr_t**       args_out,
-                             unsigned long**   args_len_out,
-                             char***           allocated_strings,
-                             int*              allocated_count);
+int prepare_h_randfield_args(h_command_args_t* args, valkey_glide_args* cmd_args);
 
 /* ====================================================================
  * RESULT PROCESSING FUNCTIONS
@@ -193,39 +153,6 @@ int process_h_randfield_result(CommandResult* result, void* output);
  */
 int process_h_incrbyfloat_result(CommandResult* result, void* output);
 
-/* ====================================================================
- * UTILITY FUNCTIONS
- * ==================================================================== */
-
-/**
- * Convert zval array to command arguments with proper string conversion
- */
-int convert_zval_array_to_args(zval*          z_array,
-                               int            start_index,
-                               uintptr_t*     args,
-                               unsigned long* args_len,
-                               char**         allocated_strings,
-                               int*           allocated_count,
-                               int            max_allocations);
-
-/**
- * Process field-value pairs from associative array
- */
-int process_field_value_pairs(zval*          field_values,
-                              uintptr_t*     args,
-                              unsigned long* args_len,
-                              int            start_index,
-                              char**         allocated_strings,
-                              int*           allocated_count);
-
-/**
- * Safe cleanup for allocated argument strings
- */
-void cleanup_h_command_args(char**         allocated_strings,
-                            int            allocated_count,
-                            uintptr_t*     args,
-                            unsigned long* args_len);
-
 /* ====================================================================
  * RESPONSE TYPE CONSTANTS
  * ==================================================================== */
@@ -16,6 +16,8 @@
 #include "valkey_glide_list_common.h"
 
 #include "common.h"
+#include "valkey_glide_options.h"
+#include "valkey_glide_result.h"
 extern zend_class_entry* ce;
 extern zend_class_entry* get_valkey_glide_exception_ce();
 
@@ -23,34 +25,6 @@ extern zend_class_entry* get_valkey_glide_exception_ce();
  * UTILITY FUNCTIONS
  * ==================================================================== */
 
-/**
- * Allocate command arguments arrays
- */
-int allocate_list_command_args(int count, uintptr_t** args_out, unsigned long** args_len_out) {
-    *args_out     = (uintptr_t*) emalloc(count * sizeof(uintptr_t));
-    *args_len_out = (unsigned long*) emalloc(count * sizeof(unsigned long));
-
-    if (!*args_out || !*args_len_out) {
-        if (*args_out)
-            efree(*args_out);
-        if (*args_len_out)
-            efree(*args_len_out);
-        return 0;
-    }
-
-    return 1;
-}
-
-/**
- * Free command arguments arrays
- */
-void free_list_command_args(uintptr_t* args, unsigned long* args_len) {
-    if (args)
-        efree(args);
-    if (args_len)
-        efree(args_len);
-}
-
 /**
  * Process a blocking result from a command
  */
@@ -79,139 +53,88 @@ int process_list_blocking_result(CommandResult* result, void* output) {
  * ==================================================================== */
 
 /**
- * Generic command execution framework
+ * Build the arguments of a list command. Returns the argument count, 0 on failure.
  */
-int execute_list_generic_command(const void*             glide_client,
-                                 enum RequestType        cmd_type,
-                                 list_command_args_t*    args,
-                                 void*                   result_ptr,
-                                 list_result_processor_t process_result) {
-    uintptr_t*     cmd_args          = NULL;
-    unsigned long* args_len          = NULL;
-    char**         allocated_strings = NULL;
-    int            allocated_count   = 0;
-    int            arg_count         = 0;
-    int            status            = 0;
-
-    /* Prepare arguments based on command type */
+static int prepare_list_args(enum RequestType     cmd_type,
+                             list_command_args_t* args,
+                             valkey_glide_args*   cmd_args) {
     switch (cmd_type) {
         case LLen:
-            arg_count = prepare_list_key_only_args(args, &cmd_args, &args_len);
-            break;
+            return prepare_list_key_only_args(args, cmd_args);
         case LPush:
         case RPush:
         case LPushX:
         case RPushX:
-            arg_count = prepare_list_key_values_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
+            return prepare_list_key_values_args(args, cmd_args);
         case LPop:
         case RPop:
-            arg_count = prepare_list_key_count_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
+            return prepare_list_key_count_args(args, cmd_args);
         case BLPop:
         case BRPop:
-            arg_count = prepare_list_blocking_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
+            return prepare_list_blocking_args(args, cmd_args);
         case LRange:
-            arg_count = prepare_list_range_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
+            return prepare_list_range_args(args, cmd_args);
         case LPos:
-            arg_count = prepare_list_position_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
+            return prepare_list_position_args(args, cmd_args);
         case LInsert:
-            arg_count = prepare_list_insert_args(args, &cmd_args, &args_len);
-            break;
+            return prepare_list_insert_args(args, cmd_args);
         case LIndex:
         case LSet:
-            arg_count = prepare_list_index_set_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
+            return prepare_list_index_set_args(args, cmd_args);
         case LRem:
-            arg_count = prepare_list_rem_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
+            return prepare_list_rem_args(args, cmd_args);
         case LTrim:
-            arg_count = prepare_list_trim_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
+            return prepare_list_trim_args(args, cmd_args);
         case LMove:
         case BLMove:
         case RPopLPush:
         case BRPopLPush:
-            arg_count = prepare_list_move_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
+            return prepare_list_move_args(args, cmd_args);
         case LMPop:
         case BLMPop:
-            arg_count = prepare_list_mpop_args(
-                args, &cmd_args, &args_len, &allocated_strings, &allocated_count);
-            break;
+            return prepare_list_mpop_args(args, cmd_args);
         default:
             return 0;
     }
+}
+
+/**
+ * Generic command execution framework. Keys get OPT_PREFIX as they are added.
+ */
+int execute_list_generic_command(const void*             glide_client,
+                                 enum RequestType        cmd_type,
+                                 list_command_args_t*    args,
+                                 void*                   result_ptr,
+                                 list_result_processor_t process_result) {
+    valkey_glide_args  cmd_args;
+    int                status = 0;
+    valkey_glide_arena arena;
 
-    if (arg_count <= 0) {
-        goto cleanup;
+    if (!args) {
+        return 0;
     }
 
-    /* Execute the command */
-    CommandResult* result = execute_command(glide_client, cmd_type, arg_count, cmd_args, args_len);
+    valkey_glide_arena_enter(&arena);
+    valkey_glide_args_init(&cmd_args);
 
-    /* Process result */
-    if (result) {
-        if (!result->command_error && result->response && process_result) {
-            status = process_result(result, result_ptr);
+    if (prepare_list_args(cmd_type, args, &cmd_args) > 0) {
+        CommandResult* result =
+            valkey_glide_args_execute(glide_client, cmd_type, &cmd_args, NULL);
+
+        /* Process result */
+        if (result) {
+            if (!result->command_error && result->response && process_result) {
+                status = process_result(result, result_ptr);
+            }
+            free_command_result(result);
         }
-        free_command_result(result);
     }
 
-cleanup:
-    /* Free allocated strings */
-    FREE_LIST_ALLOCATED_STRINGS(allocated_strings, allocated_count);
-
-    /* Free command arguments */
-    free_list_command_args(cmd_args, args_len);
-
+    valkey_glide_args_free(&cmd_args);
+    valkey_glide_arena_leave(&arena);
     return status;
 }
 
-/**
- * Allocate a string representation of a long integer
- */
-char* alloc_list_number_string(long value, size_t* len_out) {
-    char   temp[32];
-    size_t len    = snprintf(temp, sizeof(temp), "%ld", value);
-    char*  result = emalloc(len + 1);
-    if (result) {
-        memcpy(result, temp, len);
-        result[len] = '\0';
-        if (len_out)
-            *len_out = len;
-    }
-    return result;
-}
-
-/**
- * Allocate a string representation of a double
- */
-char* alloc_list_double_string(double value, size_t* len_out) {
-    char   temp[64];
-    size_t len    = snprintf(temp, sizeof(temp), "%.6f", value);
-    char*  result = emalloc(len + 1);
-    if (result) {
-        memcpy(result, temp, len);
-        result[len] = '\0';
-        if (len_out)
-            *len_out = len;
-    }
-    return result;
-}
-
 /* ====================================================================
  * OPTION PARSING FUNCTIONS
  * ==================================================================== */
@@ -275,162 +198,64 @@ int parse_list_position_options(zval* options, list_position_options_t* opts) {
 /**
  * Prepare arguments for key-only commands (LLEN)
  */
-int prepare_list_key_only_args(list_command_args_t* args,
-                               uintptr_t**          args_out,
-                               unsigned long**      args_len_out) {
+int prepare_list_key_only_args(list_command_args_t* args, valkey_glide_args* cmd_args) {
     VALIDATE_LIST_CLIENT(args->glide_client);
     VALIDATE_LIST_KEY(args->key, args->key_len);
 
-    if (!allocate_list_command_args(1, args_out, args_len_out)) {
-        return 0;
-    }
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
 
-    (*args_out)[0]     = (uintptr_t) args->key;
-    (*args_len_out)[0] = args->key_len;
+    return cmd_args->count;
+}
 
-    return 1;
+/**
+ * Add a pushed value: through the client's serializer and compressor when one is set,
+ * otherwise only strings and numbers are accepted
+ */
+static bool add_list_value(valkey_glide_args* cmd_args, zval* value) {
+    if (valkey_glide_options_encode_values(valkey_glide_current_options())) {
+        return valkey_glide_args_add_value(cmd_args, value);
+    }
+    if (Z_TYPE_P(value) != IS_STRING && Z_TYPE_P(value) != IS_LONG &&
+        Z_TYPE_P(value) != IS_DOUBLE) {
+        return false;
+    }
+    return valkey_glide_args_add_zval(cmd_args, value);
 }
 
 /**
  * Prepare arguments for key+values commands (LPUSH, RPUSH, etc.)
  */
-int prepare_list_key_values_args(list_command_args_t* args,
-                                 uintptr_t**          args_out,
-                                 unsigned long**      args_len_out,
-                                 char***              allocated_strings,
-                                 int*                 allocated_count) {
+int prepare_list_key_values_args(list_command_args_t* args, valkey_glide_args* cmd_args) {
     VALIDATE_LIST_CLIENT(args->glide_client);
     VALIDATE_LIST_KEY(args->key, args->key_len);
     VALIDATE_LIST_VALUES(args->values, args->value_count);
 
-    /* Handle both simple arrays and nested arrays (like RPUSH) */
-    unsigned long total_args = 1; /* Start with 1 for the key */
-    int           i;
-
-    /* Count all items, including those in nested arrays */
-    for (i = 0; i < args->value_count; i++) {
-        zval* value = &args->values[i];
-        if (Z_TYPE_P(value) == IS_STRING || Z_TYPE_P(value) == IS_LONG ||
-            Z_TYPE_P(value) == IS_DOUBLE) {
-            total_args++;
-        } else if (Z_TYPE_P(value) == IS_ARRAY) {
-            HashTable* ht = Z_ARRVAL_P(value);
-            total_args += zend_hash_num_elements(ht);
-        } else {
-            return 0;
-        }
-    }
-
-    if (!allocate_list_command_args(total_args, args_out, args_len_out)) {
-        return 0;
-    }
-
-    /* Initialize allocated strings tracking */
-    *allocated_strings = (char**) emalloc(total_args * sizeof(char*));
-    if (!*allocated_strings) {
-        free_list_command_args(*args_out, *args_len_out);
-        return 0;
-    }
-    *allocated_count = 0;
-
-    /* First argument: key */
-    (*args_out)[0]     = (uintptr_t) args->key;
-    (*args_len_out)[0] = args->key_len;
-
-    /* Process all values and add to args array */
-    unsigned long arg_idx = 1;
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
 
-    for (i = 0; i < args->value_count; i++) {
+    /* Handle both simple arrays and nested arrays (like RPUSH) */
+    for (int i = 0; i < args->value_count; i++) {
         zval* value = &args->values[i];
+        zval* z_item;
 
-        if (Z_TYPE_P(value) == IS_STRING) {
-            (*args_out)[arg_idx]     = (uintptr_t) Z_STRVAL_P(value);
-            (*args_len_out)[arg_idx] = Z_STRLEN_P(value);
-            arg_idx++;
-        } else if (Z_TYPE_P(value) == IS_LONG) {
-            /* Convert long to string */
-            size_t str_len;
-            char*  str_val = alloc_list_number_string(Z_LVAL_P(value), &str_len);
-            if (!str_val) {
-                FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-                free_list_command_args(*args_out, *args_len_out);
+        if (Z_TYPE_P(value) != IS_ARRAY) {
+            if (Z_TYPE_P(value) != IS_STRING && Z_TYPE_P(value) != IS_LONG &&
+                Z_TYPE_P(value) != IS_DOUBLE) {
                 return 0;
             }
-
-            (*allocated_strings)[*allocated_count] = str_val;
-            (*allocated_count)++;
-
-            (*args_out)[arg_idx]     = (uintptr_t) str_val;
-            (*args_len_out)[arg_idx] = str_len;
-            arg_idx++;
-        } else if (Z_TYPE_P(value) == IS_DOUBLE) {
-            /* Convert double to string */
-            size_t str_len;
-            char*  str_val = alloc_list_double_string(Z_DVAL_P(value), &str_len);
-            if (!str_val) {
-                FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-                free_list_command_args(*args_out, *args_len_out);
+            if (!add_list_value(cmd_args, value)) {
                 return 0;
             }
-
-            (*allocated_strings)[*allocated_count] = str_val;
-            (*allocated_count)++;
-
-            (*args_out)[arg_idx]     = (uintptr_t) str_val;
-            (*args_len_out)[arg_idx] = str_len;
-            arg_idx++;
-        } else if (Z_TYPE_P(value) == IS_ARRAY) {
-            HashTable* ht = Z_ARRVAL_P(value);
-            zval*      z_item;
-
-            ZEND_HASH_FOREACH_VAL(ht, z_item) {
-                if (Z_TYPE_P(z_item) == IS_STRING) {
-                    (*args_out)[arg_idx]     = (uintptr_t) Z_STRVAL_P(z_item);
-                    (*args_len_out)[arg_idx] = Z_STRLEN_P(z_item);
-                    arg_idx++;
-                } else if (Z_TYPE_P(z_item) == IS_LONG) {
-                    /* Convert long to string */
-                    size_t str_len;
-                    char*  str_val = alloc_list_number_string(Z_LVAL_P(z_item), &str_len);
-                    if (!str_val) {
-                        FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-                        free_list_command_args(*args_out, *args_len_out);
-                        return 0;
-                    }
-
-                    (*allocated_strings)[*allocated_count] = str_val;
-                    (*allocated_count)++;
-
-                    (*args_out)[arg_idx]     = (uintptr_t) str_val;
-                    (*args_len_out)[arg_idx] = str_len;
-                    arg_idx++;
-                } else if (Z_TYPE_P(z_item) == IS_DOUBLE) {
-                    /* Convert double to string */
-                    size_t str_len;
-                    char*  str_val = alloc_list_double_string(Z_DVAL_P(z_item), &str_len);
-                    if (!str_val) {
-                        FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-                        free_list_command_args(*args_out, *args_len_out);
-                        return 0;
-                    }
-
-                    (*allocated_strings)[*allocated_count] = str_val;
-                    (*allocated_count)++;
-
-                    (*args_out)[arg_idx]     = (uintptr_t) str_val;
-                    (*args_len_out)[arg_idx] = str_len;
-                    arg_idx++;
-                } else {
-                    FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-                    free_list_command_args(*args_out, *args_len_out);
-                    return 0;
-                }
+            continue;
+        }
+        ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(value), z_item) {
+            if (!add_list_value(cmd_args, z_item)) {
+                return 0;
             }
-            ZEND_HASH_FOREACH_END();
         }
+        ZEND_HASH_FOREACH_END();
     }
 
-    return total_args;
+    return cmd_args->count;
 }
 
 /**
@@ -457,56 +282,16 @@ int process_list_zval_int_result(CommandResult* result, void* output) {
 /**
  * Prepare arguments for key+count commands (LPOP, RPOP)
  */
-int prepare_list_key_count_args(list_command_args_t* args,
-                                uintptr_t**          args_out,
-                                unsigned long**      args_len_out,
-                                char***              allocated_strings,
-                                int*                 allocated_count) {
+int prepare_list_key_count_args(list_command_args_t* args, valkey_glide_args* cmd_args) {
     VALIDATE_LIST_CLIENT(args->glide_client);
     VALIDATE_LIST_KEY(args->key, args->key_len);
 
-    unsigned long arg_count = 1;
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
     if (args->count > 0) {
-        arg_count = 2;
+        valkey_glide_args_add_long(cmd_args, args->count);
     }
 
-    if (!allocate_list_command_args(arg_count, args_out, args_len_out)) {
-        return 0;
-    }
-
-    /* Initialize allocated strings tracking */
-    *allocated_strings = NULL;
-    *allocated_count   = 0;
-
-    /* First argument: key */
-    (*args_out)[0]     = (uintptr_t) args->key;
-    (*args_len_out)[0] = args->key_len;
-
-    /* Add count if provided */
-    if (args->count > 0) {
-        size_t count_len;
-        char*  count_str = alloc_list_number_string(args->count, &count_len);
-        if (!count_str) {
-            free_list_command_args(*args_out, *args_len_out);
-            return 0;
-        }
-
-        /* Track allocated string */
-        *allocated_strings = (char**) emalloc(sizeof(char*));
-        if (!*allocated_strings) {
-            efree(count_str);
-            free_list_command_args(*args_out, *args_len_out);
-            return 0;
-        }
-
-        (*allocated_strings)[0] = count_str;
-        *allocated_count        = 1;
-
-        (*args_out)[1]     = (uintptr_t) count_str;
-        (*args_len_out)[1] = count_len;
-    }
-
-    return arg_count;
+    return cmd_args->count;
 }
 
 /* ====================================================================
@@ -574,9 +359,16 @@ int process_list_array_result(CommandResult* result, void* output) {
     if (!result || !result->response) {
         return 0;
     }
+    if (valkey_glide_result_take(result, true, return_value)) {
+        return 1;
+    }
 
-    return command_response_to_zval(
-        result->response, return_value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false);
+    if (!command_response_to_zval(
+            result->response, return_value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false)) {
+        return 0;
+    }
+    valkey_glide_unserialize_array(valkey_glide_current_options(), return_value);
+    return 1;
 }
 
 /**
@@ -591,13 +383,19 @@ int process_list_pop_result(CommandResult* result, void* output) {
 
     if (result->response->response_type == String) {
         /* Single value returned */
-        ZVAL_STRINGL(
-            return_value, result->response->string_value, result->response->string_value_len);
+        valkey_glide_unserialize(valkey_glide_current_options(),
+                                 result->response->string_value,
+                                 result->response->string_value_len,
+                                 return_value);
         return 1;
     } else if (result->response->response_type == Array) {
         /* Multiple values returned (when count > 1) */
-        return command_response_to_zval(
-            result->response, return_value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false);
+        if (!command_response_to_zval(
+                result->response, return_value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false)) {
+            return 0;
+        }
+        valkey_glide_unserialize_array(valkey_glide_current_options(), return_value);
+        return 1;
     } else if (result->response->response_type == Null) {
         /* No elements in the list */
         ZVAL_FALSE(return_value);
@@ -608,88 +406,47 @@ int process_list_pop_result(CommandResult* result, void* output) {
 }
 
 /**
- * Prepare arguments for blocking commands (BLPOP, BRPOP)
+ * Add the keys of a command taking several: an array of strings, or a single key
  */
-int prepare_list_blocking_args(list_command_args_t* args,
-                               uintptr_t**          args_out,
-                               unsigned long**      args_len_out,
-                               char***              allocated_strings,
-                               int*                 allocated_count) {
-    VALIDATE_LIST_CLIENT(args->glide_client);
+static bool add_list_keys(list_command_args_t* args, valkey_glide_args* cmd_args) {
+    zval* z_key;
 
-    int keys_count = 0;
-
-    /* Check if keys is an array or single key */
-    if (args->keys && Z_TYPE_P(args->keys) == IS_ARRAY) {
-        keys_count = zend_hash_num_elements(Z_ARRVAL_P(args->keys));
-    } else if (args->keys && Z_TYPE_P(args->keys) == IS_STRING) {
-        keys_count = 1;
-    } else if (args->key) {
-        keys_count = 1;
-    }
-
-    if (keys_count <= 0) {
-        return 0;
-    }
-
-    /* Calculate the number of arguments: keys + timeout */
-    unsigned long arg_count = keys_count + 1;
-
-    if (!allocate_list_command_args(arg_count, args_out, args_len_out)) {
-        return 0;
-    }
-
-    /* Initialize allocated strings tracking */
-    *allocated_strings = (char**) emalloc(sizeof(char*));
-    if (!*allocated_strings) {
-        free_list_command_args(*args_out, *args_len_out);
-        return 0;
-    }
-    *allocated_count = 0;
-
-    int arg_idx = 0;
-
-    /* Add keys */
     if (args->keys && Z_TYPE_P(args->keys) == IS_ARRAY) {
-        HashTable* ht = Z_ARRVAL_P(args->keys);
-        zval*      z_key;
-        ZEND_HASH_FOREACH_VAL(ht, z_key) {
+        if (zend_hash_num_elements(Z_ARRVAL_P(args->keys)) == 0) {
+            return false;
+        }
+        ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(args->keys), z_key) {
             if (Z_TYPE_P(z_key) != IS_STRING) {
-                FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-                free_list_command_args(*args_out, *args_len_out);
-                return 0;
+                return false;
             }
-            (*args_out)[arg_idx]     = (uintptr_t) Z_STRVAL_P(z_key);
-            (*args_len_out)[arg_idx] = Z_STRLEN_P(z_key);
-            arg_idx++;
+            valkey_glide_args_add_key(cmd_args, Z_STRVAL_P(z_key), Z_STRLEN_P(z_key));
         }
         ZEND_HASH_FOREACH_END();
-    } else if (args->keys && Z_TYPE_P(args->keys) == IS_STRING) {
-        (*args_out)[arg_idx]     = (uintptr_t) Z_STRVAL_P(args->keys);
-        (*args_len_out)[arg_idx] = Z_STRLEN_P(args->keys);
-        arg_idx++;
-    } else if (args->key) {
-        (*args_out)[arg_idx]     = (uintptr_t) args->key;
-        (*args_len_out)[arg_idx] = args->key_len;
-        arg_idx++;
-    }
-
-    /* Add timeout */
-    size_t timeout_len;
-    char*  timeout_str = alloc_list_double_string(args->blocking_opts.timeout, &timeout_len);
-    if (!timeout_str) {
-        FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-        free_list_command_args(*args_out, *args_len_out);
-        return 0;
+        return true;
+    }
+    if (args->keys && Z_TYPE_P(args->keys) == IS_STRING) {
+        return valkey_glide_args_add_key_zval(cmd_args, args->keys);
+    }
+    if (args->key) {
+        valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
+        return true;
     }
+    return false;
+}
 
-    (*allocated_strings)[*allocated_count] = timeout_str;
-    (*allocated_count)++;
+/**
+ * Prepare arguments for blocking commands (BLPOP, BRPOP)
+ */
+int prepare_list_blocking_args(list_command_args_t* args, valkey_glide_args* cmd_args) {
+    VALIDATE_LIST_CLIENT(args->glide_client);
 
-    (*args_out)[arg_idx]     = (uintptr_t) timeout_str;
-    (*args_len_out)[arg_idx] = timeout_len;
+    /* Keys, then the timeout */
+    if (!add_list_keys(args, cmd_args)) {
+        return 0;
+    }
+    valkey_glide_args_add_double(cmd_args, args->blocking_opts.timeout);
 
-    return arg_count;
+    return cmd_args->count;
 }
 
 /**
@@ -770,7 +527,8 @@ int execute_list_move_command(
         if (result > 0) {
             /* Success with data */
             if (output_value) {
-                ZVAL_STRINGL(return_value, output_value, output_len);
+                valkey_glide_unserialize(
+                    valkey_glide_current_options(), output_value, output_len, return_value);
                 efree(output_value);
                 return 1;
             } else {
@@ -853,71 +611,21 @@ int execute_list_mpop_command(
 /**
  * Prepare arguments for range commands (LRANGE)
  */
-int prepare_list_range_args(list_command_args_t* args,
-                            uintptr_t**          args_out,
-                            unsigned long**      args_len_out,
-                            char***              allocated_strings,
-                            int*                 allocated_count) {
+int prepare_list_range_args(list_command_args_t* args, valkey_glide_args* cmd_args) {
     VALIDATE_LIST_CLIENT(args->glide_client);
     VALIDATE_LIST_KEY(args->key, args->key_len);
 
-    if (!allocate_list_command_args(3, args_out, args_len_out)) {
-        return 0;
-    }
-
-    /* Initialize allocated strings tracking */
-    *allocated_strings = (char**) emalloc(2 * sizeof(char*));
-    if (!*allocated_strings) {
-        free_list_command_args(*args_out, *args_len_out);
-        return 0;
-    }
-    *allocated_count = 0;
-
-    /* First argument: key */
-    (*args_out)[0]     = (uintptr_t) args->key;
-    (*args_len_out)[0] = args->key_len;
-
-    /* Second argument: start */
-    size_t start_len;
-    char*  start_str = alloc_list_number_string(args->start, &start_len);
-    if (!start_str) {
-        FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-        free_list_command_args(*args_out, *args_len_out);
-        return 0;
-    }
-
-    (*allocated_strings)[*allocated_count] = start_str;
-    (*allocated_count)++;
-
-    (*args_out)[1]     = (uintptr_t) start_str;
-    (*args_len_out)[1] = start_len;
-
-    /* Third argument: end */
-    size_t end_len;
-    char*  end_str = alloc_list_number_string(args->end, &end_len);
-    if (!end_str) {
-        FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-        free_list_command_args(*args_out, *args_len_out);
-        return 0;
-    }
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
+    valkey_glide_args_add_long(cmd_args, args->start);
+    valkey_glide_args_add_long(cmd_args, args->end);
 
-    (*allocated_strings)[*allocated_count] = end_str;
-    (*allocated_count)++;
-
-    (*args_out)[2]     = (uintptr_t) end_str;
-    (*args_len_out)[2] = end_len;
-
-    return 3;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for position commands (LPOS)
  */
-int prepare_list_position_args(list_command_args_t* args,
-                               uintptr_t**          args_out,
-                               unsigned long**      args_len_out,
-                               char***              allocated_strings,
-                               int*                 allocated_count) {
+int prepare_list_position_args(list_command_args_t* args, valkey_glide_args* cmd_args) {
     VALIDATE_LIST_CLIENT(args->glide_client);
     VALIDATE_LIST_KEY(args->key, args->key_len);
 
@@ -925,110 +633,30 @@ int prepare_list_position_args(list_command_args_t* args,
         return 0;
     }
 
-    /* Count optional arguments */
-    int opt_count = 0;
-    if (args->position_opts.has_rank)
-        opt_count += 2;
-    if (args->position_opts.has_count)
-        opt_count += 2;
-    if (args->position_opts.has_maxlen)
-        opt_count += 2;
-
-    unsigned long arg_count = 2 + opt_count; /* key + element + options */
-
-    if (!allocate_list_command_args(arg_count, args_out, args_len_out)) {
-        return 0;
-    }
-
-    /* Initialize allocated strings tracking */
-    *allocated_strings = (char**) emalloc(3 * sizeof(char*));
-    if (!*allocated_strings) {
-        free_list_command_args(*args_out, *args_len_out);
-        return 0;
-    }
-    *allocated_count = 0;
-
-    /* Key and element are first two arguments */
-    (*args_out)[0]     = (uintptr_t) args->key;
-    (*args_len_out)[0] = args->key_len;
-    (*args_out)[1]     = (uintptr_t) args->element;
-    (*args_len_out)[1] = args->element_len;
-
-    unsigned int arg_idx = 2;
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
+    valkey_glide_args_add(cmd_args, args->element, args->element_len);
 
     /* Add optional arguments */
     if (args->position_opts.has_rank) {
-        (*args_out)[arg_idx]     = (uintptr_t) "RANK";
-        (*args_len_out)[arg_idx] = 4;
-        arg_idx++;
-
-        size_t rank_len;
-        char*  rank_str = alloc_list_number_string(args->position_opts.rank, &rank_len);
-        if (!rank_str) {
-            FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-            free_list_command_args(*args_out, *args_len_out);
-            return 0;
-        }
-
-        (*allocated_strings)[*allocated_count] = rank_str;
-        (*allocated_count)++;
-
-        (*args_out)[arg_idx]     = (uintptr_t) rank_str;
-        (*args_len_out)[arg_idx] = rank_len;
-        arg_idx++;
+        valkey_glide_args_add_literal(cmd_args, "RANK");
+        valkey_glide_args_add_long(cmd_args, args->position_opts.rank);
     }
-
     if (args->position_opts.has_count) {
-        (*args_out)[arg_idx]     = (uintptr_t) "COUNT";
-        (*args_len_out)[arg_idx] = 5;
-        arg_idx++;
-
-        size_t count_len;
-        char*  count_str = alloc_list_number_string(args->position_opts.count, &count_len);
-        if (!count_str) {
-            FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-            free_list_command_args(*args_out, *args_len_out);
-            return 0;
-        }
-
-        (*allocated_strings)[*allocated_count] = count_str;
-        (*allocated_count)++;
-
-        (*args_out)[arg_idx]     = (uintptr_t) count_str;
-        (*args_len_out)[arg_idx] = count_len;
-        arg_idx++;
+        valkey_glide_args_add_literal(cmd_args, "COUNT");
+        valkey_glide_args_add_long(cmd_args, args->position_opts.count);
     }
-
     if (args->position_opts.has_maxlen) {
-        (*args_out)[arg_idx]     = (uintptr_t) "MAXLEN";
-        (*args_len_out)[arg_idx] = 6;
-        arg_idx++;
-
-        size_t maxlen_len;
-        char*  maxlen_str = alloc_list_number_string(args->position_opts.maxlen, &maxlen_len);
-        if (!maxlen_str) {
-            FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-            free_list_command_args(*args_out, *args_len_out);
-            return 0;
-        }
-
-        (*allocated_strings)[*allocated_count] = maxlen_str;
-        (*allocated_count)++;
-
-        (*args_out)[arg_idx]     = (uintptr_t) maxlen_str;
-        (*args_len_out)[arg_idx] = maxlen_len;
-        arg_idx++;
+        valkey_glide_args_add_literal(cmd_args, "MAXLEN");
+        valkey_glide_args_add_long(cmd_args, args->position_opts.maxlen);
     }
 
-    return arg_count;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for insert commands (LINSERT)
  */
-int prepare_list_insert_args(list_command_args_t* args,
-                             uintptr_t**          args_out,
-                             unsigned long**      args_len_out) {
+int prepare_list_insert_args(list_command_args_t* args, valkey_glide_args* cmd_args) {
     VALIDATE_LIST_CLIENT(args->glide_client);
     VALIDATE_LIST_KEY(args->key, args->key_len);
 
@@ -1038,84 +666,36 @@ int prepare_list_insert_args(list_command_args_t* args,
         return 0;
     }
 
-    if (!allocate_list_command_args(4, args_out, args_len_out)) {
-        return 0;
-    }
-
-    (*args_out)[0]     = (uintptr_t) args->key;
-    (*args_len_out)[0] = args->key_len;
-    (*args_out)[1]     = (uintptr_t) args->position_opts.position;
-    (*args_len_out)[1] = args->position_opts.position_len;
-    (*args_out)[2]     = (uintptr_t) args->position_opts.pivot;
-    (*args_len_out)[2] = args->position_opts.pivot_len;
-    (*args_out)[3]     = (uintptr_t) args->value;
-    (*args_len_out)[3] = args->value_len;
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
+    valkey_glide_args_add(cmd_args, args->position_opts.position, args->position_opts.position_len);
+    valkey_glide_args_add(cmd_args, args->position_opts.pivot, args->position_opts.pivot_len);
+    valkey_glide_args_add(cmd_args, args->value, args->value_len);
 
-    return 4;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for index/set commands (LINDEX, LSET)
  */
-int prepare_list_index_set_args(list_command_args_t* args,
-                                uintptr_t**          args_out,
-                                unsigned long**      args_len_out,
-                                char***              allocated_strings,
-                                int*                 allocated_count) {
+int prepare_list_index_set_args(list_command_args_t* args, valkey_glide_args* cmd_args) {
     VALIDATE_LIST_CLIENT(args->glide_client);
     VALIDATE_LIST_KEY(args->key, args->key_len);
 
-    /* For LSET, we need value as well */
-    unsigned long arg_count = (args->value) ? 3 : 2;
-
-    if (!allocate_list_command_args(arg_count, args_out, args_len_out)) {
-        return 0;
-    }
-
-    /* Initialize allocated strings tracking */
-    *allocated_strings = (char**) emalloc(sizeof(char*));
-    if (!*allocated_strings) {
-        free_list_command_args(*args_out, *args_len_out);
-        return 0;
-    }
-    *allocated_count = 0;
-
-    /* First argument: key */
-    (*args_out)[0]     = (uintptr_t) args->key;
-    (*args_len_out)[0] = args->key_len;
-
-    /* Second argument: index */
-    size_t index_len;
-    char*  index_str = alloc_list_number_string(args->index, &index_len);
-    if (!index_str) {
-        FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-        free_list_command_args(*args_out, *args_len_out);
-        return 0;
-    }
-
-    (*allocated_strings)[*allocated_count] = index_str;
-    (*allocated_count)++;
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
+    valkey_glide_args_add_long(cmd_args, args->index);
 
-    (*args_out)[1]     = (uintptr_t) index_str;
-    (*args_len_out)[1] = index_len;
-
-    /* Third argument: value (for LSET) */
+    /* For LSET, we need value as well */
     if (args->value) {
-        (*args_out)[2]     = (uintptr_t) args->value;
-        (*args_len_out)[2] = args->value_len;
+        valkey_glide_args_add(cmd_args, args->value, args->value_len);
     }
 
-    return arg_count;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for remove commands (LREM)
  */
-int prepare_list_rem_args(list_command_args_t* args,
-                          uintptr_t**          args_out,
-                          unsigned long**      args_len_out,
-                          char***              allocated_strings,
-                          int*                 allocated_count) {
+int prepare_list_rem_args(list_command_args_t* args, valkey_glide_args* cmd_args) {
     VALIDATE_LIST_CLIENT(args->glide_client);
     VALIDATE_LIST_KEY(args->key, args->key_len);
 
@@ -1123,112 +703,31 @@ int prepare_list_rem_args(list_command_args_t* args,
         return 0;
     }
 
-    if (!allocate_list_command_args(3, args_out, args_len_out)) {
-        return 0;
-    }
-
-    /* Initialize allocated strings tracking */
-    *allocated_strings = (char**) emalloc(sizeof(char*));
-    if (!*allocated_strings) {
-        free_list_command_args(*args_out, *args_len_out);
-        return 0;
-    }
-    *allocated_count = 0;
-
-    /* First argument: key */
-    (*args_out)[0]     = (uintptr_t) args->key;
-    (*args_len_out)[0] = args->key_len;
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
+    valkey_glide_args_add_long(cmd_args, args->count);
+    valkey_glide_args_add(cmd_args, args->value, args->value_len);
 
-    /* Second argument: count */
-    size_t count_len;
-    char*  count_str = alloc_list_number_string(args->count, &count_len);
-    if (!count_str) {
-        FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-        free_list_command_args(*args_out, *args_len_out);
-        return 0;
-    }
-
-    (*allocated_strings)[*allocated_count] = count_str;
-    (*allocated_count)++;
-
-    (*args_out)[1]     = (uintptr_t) count_str;
-    (*args_len_out)[1] = count_len;
-
-    /* Third argument: value */
-    (*args_out)[2]     = (uintptr_t) args->value;
-    (*args_len_out)[2] = args->value_len;
-
-    return 3;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for trim commands (LTRIM)
  */
-int prepare_list_trim_args(list_command_args_t* args,
-                           uintptr_t**          args_out,
-                           unsigned long**      args_len_out,
-                           char***              allocated_strings,
-                           int*                 allocated_count) {
+int prepare_list_trim_args(list_command_args_t* args, valkey_glide_args* cmd_args) {
     VALIDATE_LIST_CLIENT(args->glide_client);
     VALIDATE_LIST_KEY(args->key, args->key_len);
 
-    if (!allocate_list_command_args(3, args_out, args_len_out)) {
-        return 0;
-    }
-
-    /* Initialize allocated strings tracking */
-    *allocated_strings = (char**) emalloc(2 * sizeof(char*));
-    if (!*allocated_strings) {
-        free_list_command_args(*args_out, *args_len_out);
-        return 0;
-    }
-    *allocated_count = 0;
-
-    /* First argument: key */
-    (*args_out)[0]     = (uintptr_t) args->key;
-    (*args_len_out)[0] = args->key_len;
-
-    /* Second argument: start */
-    size_t start_len;
-    char*  start_str = alloc_list_number_string(args->start, &start_len);
-    if (!start_str) {
-        FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-        free_list_command_args(*args_out, *args_len_out);
-        return 0;
-    }
-
-    (*allocated_strings)[*allocated_count] = start_str;
-    (*allocated_count)++;
-
-    (*args_out)[1]     = (uintptr_t) start_str;
-    (*args_len_out)[1] = start_len;
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
+    valkey_glide_args_add_long(cmd_args, args->start);
+    valkey_glide_args_add_long(cmd_args, args->end);
 
-    /* Third argument: end */
-    size_t end_len;
-    char*  end_str = alloc_list_number_string(args->end, &end_len);
-    if (!end_str) {
-        FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-        free_list_command_args(*args_out, *args_len_out);
-        return 0;
-    }
-
-    (*allocated_strings)[*allocated_count] = end_str;
-    (*allocated_count)++;
-
-    (*args_out)[2]     = (uintptr_t) end_str;
-    (*args_len_out)[2] = end_len;
-
-    return 3;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for move commands (LMOVE, BLMOVE, RPOPLPUSH, BRPOPLPUSH)
  */
-int prepare_list_move_args(list_command_args_t* args,
-                           uintptr_t**          args_out,
-                           unsigned long**      args_len_out,
-                           char***              allocated_strings,
-                           int*                 allocated_count) {
+int prepare_list_move_args(list_command_args_t* args, valkey_glide_args* cmd_args) {
     VALIDATE_LIST_CLIENT(args->glide_client);
     VALIDATE_LIST_KEY(args->key, args->key_len);
 
@@ -1236,198 +735,53 @@ int prepare_list_move_args(list_command_args_t* args,
         return 0;
     }
 
-    /* For blocking commands, we need timeout. For RPOPLPUSH-style, we only need src and dest keys
-     */
-    unsigned long arg_count = 2; /* src_key, dest_key */
-
-    /* Check if we have direction arguments (LMOVE/BLMOVE style) */
-    if (args->move_opts.source_direction && args->move_opts.dest_direction) {
-        arg_count = 4; /* src_key, dest_key, src_dir, dest_dir */
-    }
-
-    /* Add timeout for blocking commands */
-    if (args->move_opts.has_timeout) {
-        arg_count++;
-    }
-
-    if (!allocate_list_command_args(arg_count, args_out, args_len_out)) {
-        return 0;
-    }
-
-    /* Initialize allocated strings tracking */
-    *allocated_strings = (char**) emalloc(sizeof(char*));
-    if (!*allocated_strings) {
-        free_list_command_args(*args_out, *args_len_out);
-        return 0;
-    }
-    *allocated_count = 0;
-
-    unsigned int arg_idx = 0;
-
-    /* First argument: source key */
-    (*args_out)[arg_idx]     = (uintptr_t) args->key;
-    (*args_len_out)[arg_idx] = args->key_len;
-    arg_idx++;
-
-    /* Second argument: destination key */
-    (*args_out)[arg_idx]     = (uintptr_t) args->move_opts.dest_key;
-    (*args_len_out)[arg_idx] = args->move_opts.dest_key_len;
-    arg_idx++;
+    /* Source and destination keys */
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
+    valkey_glide_args_add_key(cmd_args, args->move_opts.dest_key, args->move_opts.dest_key_len);
 
     /* Add direction arguments if present (LMOVE/BLMOVE style) */
     if (args->move_opts.source_direction && args->move_opts.dest_direction) {
-        (*args_out)[arg_idx]     = (uintptr_t) args->move_opts.source_direction;
-        (*args_len_out)[arg_idx] = args->move_opts.source_direction_len;
-        arg_idx++;
-
-        (*args_out)[arg_idx]     = (uintptr_t) args->move_opts.dest_direction;
-        (*args_len_out)[arg_idx] = args->move_opts.dest_direction_len;
-        arg_idx++;
+        valkey_glide_args_add(cmd_args,
+                              args->move_opts.source_direction,
+                              args->move_opts.source_direction_len);
+        valkey_glide_args_add(
+            cmd_args, args->move_opts.dest_direction, args->move_opts.dest_direction_len);
     }
 
     /* Add timeout for blocking commands */
     if (args->move_opts.has_timeout) {
-        size_t timeout_len;
-        char*  timeout_str = alloc_list_double_string(args->move_opts.timeout, &timeout_len);
-        if (!timeout_str) {
-            FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-            free_list_command_args(*args_out, *args_len_out);
-            return 0;
-        }
-
-        (*allocated_strings)[*allocated_count] = timeout_str;
-        (*allocated_count)++;
-
-        (*args_out)[arg_idx]     = (uintptr_t) timeout_str;
-        (*args_len_out)[arg_idx] = timeout_len;
-        arg_idx++;
+        valkey_glide_args_add_double(cmd_args, args->move_opts.timeout);
     }
 
-    return arg_count;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for MPOP commands (LMPOP, BLMPOP)
  */
-int prepare_list_mpop_args(list_command_args_t* args,
-                           uintptr_t**          args_out,
-                           unsigned long**      args_len_out,
-                           char***              allocated_strings,
-                           int*                 allocated_count) {
+int prepare_list_mpop_args(list_command_args_t* args, valkey_glide_args* cmd_args) {
     VALIDATE_LIST_CLIENT(args->glide_client);
 
-    if (!args->keys || !args->mpop_opts.direction || args->mpop_opts.direction_len <= 0) {
-        return 0;
-    }
-
-    /* Get the number of keys */
-    int keys_count = 0;
-    if (Z_TYPE_P(args->keys) == IS_ARRAY) {
-        keys_count = zend_hash_num_elements(Z_ARRVAL_P(args->keys));
-    }
-
-    if (keys_count <= 0) {
-        return 0;
-    }
-
-    /* Calculate arguments: [timeout] + numkeys + keys + direction + [COUNT + count_value] */
-    unsigned long arg_count = 1 + keys_count + 1; /* numkeys + keys + direction */
-    if (args->mpop_opts.has_timeout)
-        arg_count++; /* timeout for blocking version */
-    if (args->mpop_opts.has_count)
-        arg_count += 2; /* COUNT + value */
-
-    if (!allocate_list_command_args(arg_count, args_out, args_len_out)) {
-        return 0;
-    }
-
-    /* Initialize allocated strings tracking */
-    *allocated_strings = (char**) emalloc(3 * sizeof(char*)); /* timeout, numkeys, count */
-    if (!*allocated_strings) {
-        free_list_command_args(*args_out, *args_len_out);
+    if (!args->keys || Z_TYPE_P(args->keys) != IS_ARRAY || !args->mpop_opts.direction ||
+        args->mpop_opts.direction_len <= 0) {
         return 0;
     }
-    *allocated_count = 0;
 
-    unsigned int arg_idx = 0;
-
-    /* Add timeout for blocking commands (first argument) */
+    /* [timeout] numkeys key... direction [COUNT count] */
     if (args->mpop_opts.has_timeout) {
-        size_t timeout_len;
-        char*  timeout_str = alloc_list_double_string(args->mpop_opts.timeout, &timeout_len);
-        if (!timeout_str) {
-            FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-            free_list_command_args(*args_out, *args_len_out);
-            return 0;
-        }
-
-        (*allocated_strings)[*allocated_count] = timeout_str;
-        (*allocated_count)++;
-
-        (*args_out)[arg_idx]     = (uintptr_t) timeout_str;
-        (*args_len_out)[arg_idx] = timeout_len;
-        arg_idx++;
+        valkey_glide_args_add_double(cmd_args, args->mpop_opts.timeout);
     }
-
-    /* Add numkeys */
-    size_t numkeys_len;
-    char*  numkeys_str = alloc_list_number_string(keys_count, &numkeys_len);
-    if (!numkeys_str) {
-        FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-        free_list_command_args(*args_out, *args_len_out);
+    valkey_glide_args_add_long(cmd_args, zend_hash_num_elements(Z_ARRVAL_P(args->keys)));
+    if (!add_list_keys(args, cmd_args)) {
         return 0;
     }
-
-    (*allocated_strings)[*allocated_count] = numkeys_str;
-    (*allocated_count)++;
-
-    (*args_out)[arg_idx]     = (uintptr_t) numkeys_str;
-    (*args_len_out)[arg_idx] = numkeys_len;
-    arg_idx++;
-
-    /* Add keys */
-    HashTable* ht = Z_ARRVAL_P(args->keys);
-    zval*      z_key;
-    ZEND_HASH_FOREACH_VAL(ht, z_key) {
-        if (Z_TYPE_P(z_key) != IS_STRING) {
-            FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-            free_list_command_args(*args_out, *args_len_out);
-            return 0;
-        }
-        (*args_out)[arg_idx]     = (uintptr_t) Z_STRVAL_P(z_key);
-        (*args_len_out)[arg_idx] = Z_STRLEN_P(z_key);
-        arg_idx++;
-    }
-    ZEND_HASH_FOREACH_END();
-
-    /* Add direction */
-    (*args_out)[arg_idx]     = (uintptr_t) args->mpop_opts.direction;
-    (*args_len_out)[arg_idx] = args->mpop_opts.direction_len;
-    arg_idx++;
-
-    /* Add COUNT if specified */
+    valkey_glide_args_add(cmd_args, args->mpop_opts.direction, args->mpop_opts.direction_len);
     if (args->mpop_opts.has_count) {
-        (*args_out)[arg_idx]     = (uintptr_t) "COUNT";
-        (*args_len_out)[arg_idx] = 5;
-        arg_idx++;
-
-        size_t count_len;
-        char*  count_str = alloc_list_number_string(args->mpop_opts.count, &count_len);
-        if (!count_str) {
-            FREE_LIST_ALLOCATED_STRINGS(*allocated_strings, *allocated_count);
-            free_list_command_args(*args_out, *args_len_out);
-            return 0;
-        }
-
-        (*allocated_strings)[*allocated_count] = count_str;
-        (*allocated_count)++;
-
-        (*args_out)[arg_idx]     = (uintptr_t) count_str;
-        (*args_len_out)[arg_idx] = count_len;
-        arg_idx++;
+        valkey_glide_args_add_literal(cmd_args, "COUNT");
+        valkey_glide_args_add_long(cmd_args, args->mpop_opts.count);
     }
 
-    return arg_count;
+    return cmd_args->count;
 }
 
 /* ====================================================================
@@ -1703,7 +1057,8 @@ int execute_list_index_command(zval* object, int argc, zval* return_value, zend_
         if (result > 0) {
             /* Success with data */
             if (output_value) {
-                ZVAL_STRINGL(return_value, output_value, output_len);
+                valkey_glide_unserialize(
+                    valkey_glide_current_options(), output_value, output_len, return_value);
                 efree(output_value);
                 return 1;
             } else {
@@ -0,0 +1,557 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Client Options                                          |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#include "valkey_glide_options.h"
+
+#include <zend_exceptions.h>
+#include <zend_smart_str.h>
+
+#include <ext/json/php_json.h>
+#include <ext/standard/php_var.h>
+
+#ifdef HAVE_VALKEY_GLIDE_IGBINARY
+#include <ext/igbinary/igbinary.h>
+#endif
+#ifdef HAVE_VALKEY_GLIDE_MSGPACK
+#include <ext/msgpack/php_msgpack.h>
+#endif
+
+#include "command_response.h"
+#include "valkey_glide_batch_template.h"
+#include "valkey_glide_compression.h"
+#include "valkey_glide_cache.h"
+
+/* ====================================================================
+ * CURRENT CLIENT
+ * ==================================================================== */
+
+/* Client a method of another class is running commands for on this thread, see
+ * valkey_glide_delegate() */
+static ZEND_TLS valkey_glide_object* current_delegate = NULL;
+
+valkey_glide_object* valkey_glide_current_object(void) {
+    zend_execute_data* call = EG(current_execute_data);
+    zend_class_entry*  ce;
+
+    if (!call || Z_TYPE(call->This) != IS_OBJECT) {
+        return current_delegate;
+    }
+
+    ce = Z_OBJCE(call->This);
+    if (!instanceof_function(ce, get_valkey_glide_ce()) &&
+        !instanceof_function(ce, get_valkey_glide_cluster_ce())) {
+        return current_delegate;
+    }
+    return VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, &call->This);
+}
+
+valkey_glide_object* valkey_glide_delegate(valkey_glide_object* valkey_glide) {
+    valkey_glide_object* previous = current_delegate;
+
+    current_delegate = valkey_glide;
+    return previous;
+}
+
+const valkey_glide_options_t* valkey_glide_current_options(void) {
+    valkey_glide_object* valkey_glide = valkey_glide_current_object();
+
+    if (!valkey_glide) {
+        return NULL;
+    }
+    if (!valkey_glide_options_encode_values(&valkey_glide->options) &&
+        !valkey_glide->options.prefix && !valkey_glide->options.null_multibulk_as_null &&
+        !valkey_glide->options.lazy_results) {
+        return NULL;
+    }
+    return &valkey_glide->options;
+}
+
+void valkey_glide_options_free(valkey_glide_options_t* options) {
+    if (options->prefix) {
+        zend_string_release(options->prefix);
+        options->prefix = NULL;
+    }
+}
+
+bool valkey_glide_serializer_available(zend_long serializer) {
+    switch (serializer) {
+        case VALKEY_GLIDE_SERIALIZER_NONE:
+        case VALKEY_GLIDE_SERIALIZER_PHP:
+        case VALKEY_GLIDE_SERIALIZER_JSON:
+            return true;
+#ifdef HAVE_VALKEY_GLIDE_IGBINARY
+        case VALKEY_GLIDE_SERIALIZER_IGBINARY:
+            return true;
+#endif
+#ifdef HAVE_VALKEY_GLIDE_MSGPACK
+        case VALKEY_GLIDE_SERIALIZER_MSGPACK:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+/* ====================================================================
+ * SERIALIZATION
+ * ==================================================================== */
+
+/* Hand the buffer of a smart_str over as the owner of the argument */
+static const char* serialized_smart_str(smart_str* buf, size_t* len, char** owner) {
+    zend_string* str = smart_str_extract(buf);
+
+    *len   = ZSTR_LEN(str);
+    *owner = (char*) str; /* A single emalloc'ed block, released with efree() */
+    return ZSTR_VAL(str);
+}
+
+/* Replace the wire form of a value with its compressed form, when it is worth it */
+static const char* compress_value(const valkey_glide_options_t* options,
+                                  const char*                   value,
+                                  size_t*                       len,
+                                  char**                        owner) {
+    size_t compressed_len;
+    char*  compressed;
+
+    if (!value || !options || options->compression == VALKEY_GLIDE_COMPRESSION_NONE ||
+        (zend_long) *len < options->compression_min_size) {
+        return value;
+    }
+
+    compressed = valkey_glide_compress(
+        options->compression, options->compression_level, value, *len, &compressed_len);
+    if (!compressed) {
+        return value;
+    }
+    if (*owner) {
+        efree(*owner);
+    }
+    *owner = compressed;
+    *len   = compressed_len;
+    return compressed;
+}
+
+static const char* serialize_value(const valkey_glide_options_t* options,
+                                   zval*                         value,
+                                   size_t*                       len,
+                                   char**                        owner) {
+    smart_str buf = {0};
+
+    *owner = NULL;
+    ZVAL_DEREF(value);
+
+    switch (options ? options->serializer : VALKEY_GLIDE_SERIALIZER_NONE) {
+        case VALKEY_GLIDE_SERIALIZER_PHP: {
+            php_serialize_data_t var_hash;
+
+            PHP_VAR_SERIALIZE_INIT(var_hash);
+            php_var_serialize(&buf, value, &var_hash);
+            PHP_VAR_SERIALIZE_DESTROY(var_hash);
+            if (EG(exception)) {
+                smart_str_free(&buf);
+                return NULL;
+            }
+            return serialized_smart_str(&buf, len, owner);
+        }
+
+        case VALKEY_GLIDE_SERIALIZER_JSON:
+            if (php_json_encode(&buf, value, 0) == FAILURE) {
+                smart_str_free(&buf);
+                return NULL;
+            }
+            return serialized_smart_str(&buf, len, owner);
+
+#ifdef HAVE_VALKEY_GLIDE_IGBINARY
+        case VALKEY_GLIDE_SERIALIZER_IGBINARY: {
+            uint8_t* out;
+
+            if (igbinary_serialize(&out, len, value) != 0) {
+                return NULL;
+            }
+            *owner = (char*) out;
+            return *owner;
+        }
+#endif
+
+#ifdef HAVE_VALKEY_GLIDE_MSGPACK
+        case VALKEY_GLIDE_SERIALIZER_MSGPACK:
+            php_msgpack_serialize(&buf, value);
+            if (EG(exception)) {
+                smart_str_free(&buf);
+                return NULL;
+            }
+            return serialized_smart_str(&buf, len, owner);
+#endif
+
+        default:
+            break;
+    }
+
+    switch (Z_TYPE_P(value)) {
+        case IS_STRING:
+            *len = Z_STRLEN_P(value);
+            return Z_STRVAL_P(value);
+        case IS_LONG:
+            *owner = long_to_string(Z_LVAL_P(value), len);
+            return *owner;
+        case IS_DOUBLE:
+            *owner = double_to_string(Z_DVAL_P(value), len);
+            return *owner;
+        case IS_TRUE:
+            *len = 1;
+            return "1";
+        case IS_FALSE:
+            *len = 1;
+            return "0";
+        case IS_NULL:
+            *len = 0;
+            return "";
+        default:
+            return NULL;
+    }
+}
+
+/* A placeholder of a batch template cannot be in an encoded value, see
+ * valkey_glide_batch_template_encoded_param() */
+static const char* check_encoded_param(const valkey_glide_options_t* options,
+                                       const char*                   value,
+                                       size_t                        len,
+                                       char**                        owner) {
+    if (valkey_glide_options_encode_values(options) &&
+        valkey_glide_batch_template_encoded_param(value, len)) {
+        if (*owner) {
+            efree(*owner);
+            *owner = NULL;
+        }
+        return NULL;
+    }
+    return value;
+}
+
+const char* valkey_glide_serialize(const valkey_glide_options_t* options,
+                                   zval*                         value,
+                                   size_t*                       len,
+                                   char**                        owner) {
+    const char* serialized = serialize_value(options, value, len, owner);
+
+    if (serialized) {
+        serialized = check_encoded_param(options, serialized, *len, owner);
+    }
+    return compress_value(options, serialized, len, owner);
+}
+
+const char* valkey_glide_serialize_string(const valkey_glide_options_t* options,
+                                          const char*                   value,
+                                          size_t                        value_len,
+                                          size_t*                       len,
+                                          char**                        owner) {
+    zval        str;
+    const char* serialized;
+
+    if (!options || options->serializer == VALKEY_GLIDE_SERIALIZER_NONE) {
+        *owner = NULL;
+        *len   = value_len;
+        value  = check_encoded_param(options, value, value_len, owner);
+        return compress_value(options, value, len, owner);
+    }
+
+    ZVAL_STRINGL(&str, value, value_len);
+    serialized = valkey_glide_serialize(options, &str, len, owner);
+    zval_ptr_dtor(&str);
+    return serialized;
+}
+
+static void unserialize_value(const valkey_glide_options_t* options,
+                              const char*                   value,
+                              size_t                        value_len,
+                              zval*                         output) {
+    switch (options ? options->serializer : VALKEY_GLIDE_SERIALIZER_NONE) {
+        case VALKEY_GLIDE_SERIALIZER_PHP: {
+            const unsigned char*   p = (const unsigned char*) value;
+            php_unserialize_data_t var_hash;
+            bool                   ok;
+
+            ZVAL_UNDEF(output);
+            PHP_VAR_UNSERIALIZE_INIT(var_hash);
+            ok = php_var_unserialize(output, &p, p + value_len, &var_hash);
+            PHP_VAR_UNSERIALIZE_DESTROY(var_hash);
+            if (ok) {
+                return;
+            }
+            zval_ptr_dtor(output);
+            break;
+        }
+
+        case VALKEY_GLIDE_SERIALIZER_JSON:
+            if (php_json_decode_ex(output,
+                                   value,
+                                   value_len,
+                                   PHP_JSON_OBJECT_AS_ARRAY,
+                                   PHP_JSON_PARSER_DEFAULT_DEPTH) == SUCCESS) {
+                return;
+            }
+            break;
+
+#ifdef HAVE_VALKEY_GLIDE_IGBINARY
+        case VALKEY_GLIDE_SERIALIZER_IGBINARY:
+            if (igbinary_unserialize((const uint8_t*) value, value_len, output) == 0) {
+                return;
+            }
+            break;
+#endif
+
+#ifdef HAVE_VALKEY_GLIDE_MSGPACK
+        case VALKEY_GLIDE_SERIALIZER_MSGPACK:
+            php_msgpack_unserialize(output, (char*) value, value_len);
+            if (Z_TYPE_P(output) != IS_UNDEF) {
+                return;
+            }
+            break;
+#endif
+
+        default:
+            break;
+    }
+
+    ZVAL_STRINGL(output, value, value_len);
+}
+
+void valkey_glide_unserialize(const valkey_glide_options_t* options,
+                              const char*                   value,
+                              size_t                        value_len,
+                              zval*                         output) {
+    size_t len;
+    char*  decompressed;
+
+    /* Values without the header were stored before compression was turned on */
+    if (!options || options->compression == VALKEY_GLIDE_COMPRESSION_NONE ||
+        !(decompressed = valkey_glide_decompress(value, value_len, &len))) {
+        unserialize_value(options, value, value_len, output);
+        return;
+    }
+
+    unserialize_value(options, decompressed, len, output);
+    efree(decompressed);
+}
+
+void valkey_glide_unserialize_array(const valkey_glide_options_t* options, zval* array) {
+    zval* element;
+
+    if (!valkey_glide_options_encode_values(options) || Z_TYPE_P(array) != IS_ARRAY) {
+        return;
+    }
+
+    SEPARATE_ARRAY(array);
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(array), element) {
+        if (Z_TYPE_P(element) == IS_STRING) {
+            zend_string* str = Z_STR_P(element);
+
+            valkey_glide_unserialize(options, ZSTR_VAL(str), ZSTR_LEN(str), element);
+            zend_string_release(str);
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+}
+
+/* ====================================================================
+ * KEY PREFIX
+ * ==================================================================== */
+
+const char* valkey_glide_prefix_key(const valkey_glide_options_t* options,
+                                    const char*                   key,
+                                    size_t                        key_len,
+                                    size_t*                       len,
+                                    char**                        owner) {
+    zend_string* prefix = options ? options->prefix : NULL;
+
+    if (!prefix || !key) {
+        *owner = NULL;
+        *len   = key_len;
+        return key;
+    }
+
+    *len   = ZSTR_LEN(prefix) + key_len;
+    *owner = emalloc(*len + 1);
+    memcpy(*owner, ZSTR_VAL(prefix), ZSTR_LEN(prefix));
+    memcpy(*owner + ZSTR_LEN(prefix), key, key_len);
+    (*owner)[*len] = '\0';
+    return *owner;
+}
+
+bool valkey_glide_prefix_key_array(const valkey_glide_options_t* options,
+                                   zval*                         keys,
+                                   bool                          assoc_keys,
+                                   zval*                         prefixed) {
+    zend_string* key;
+    zend_ulong   index;
+    zval*        element;
+
+    if (!options || !options->prefix || Z_TYPE_P(keys) != IS_ARRAY) {
+        return false;
+    }
+
+    array_init_size(prefixed, zend_hash_num_elements(Z_ARRVAL_P(keys)));
+    ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(keys), index, key, element) {
+        zend_string* name = assoc_keys ? (key ? zend_string_copy(key) : zend_long_to_str(index))
+                                       : zval_get_string(element);
+        zend_string* full = zend_string_concat2(
+            ZSTR_VAL(options->prefix), ZSTR_LEN(options->prefix), ZSTR_VAL(name), ZSTR_LEN(name));
+
+        if (assoc_keys) {
+            Z_TRY_ADDREF_P(element);
+            zend_hash_update(Z_ARRVAL_P(prefixed), full, element);
+            zend_string_release(full);
+        } else {
+            add_next_index_str(prefixed, full);
+        }
+        zend_string_release(name);
+    }
+    ZEND_HASH_FOREACH_END();
+    return true;
+}
+
+/* ====================================================================
+ * setOption() / getOption()
+ * ==================================================================== */
+
+int execute_set_option_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    valkey_glide_object* valkey_glide;
+    zend_long            option;
+    zval*                value;
+
+    if (zend_parse_method_parameters(argc, object, "Olz", &object, ce, &option, &value) ==
+        FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+
+    switch (option) {
+        case VALKEY_GLIDE_OPT_SERIALIZER: {
+            zend_long serializer = zval_get_long(value);
+
+            if (!valkey_glide_serializer_available(serializer)) {
+                return 0;
+            }
+            valkey_glide->options.serializer = (int) serializer;
+            break;
+        }
+
+        case VALKEY_GLIDE_OPT_PREFIX:
+            valkey_glide_options_free(&valkey_glide->options);
+            if (Z_TYPE_P(value) != IS_NULL) {
+                zend_string* prefix = zval_get_string(value);
+
+                if (ZSTR_LEN(prefix) > 0) {
+                    valkey_glide->options.prefix = prefix;
+                } else {
+                    zend_string_release(prefix);
+                }
+            }
+            break;
+
+        case VALKEY_GLIDE_OPT_NULL_MULTIBULK_AS_NULL:
+            valkey_glide->options.null_multibulk_as_null = zend_is_true(value);
+            break;
+
+        case VALKEY_GLIDE_OPT_COMPRESSION: {
+            zend_long compression = zval_get_long(value);
+
+            if (!valkey_glide_compression_available(compression)) {
+                return 0;
+            }
+            valkey_glide->options.compression = (int) compression;
+            break;
+        }
+
+        case VALKEY_GLIDE_OPT_COMPRESSION_LEVEL: {
+            zend_long level = zval_get_long(value);
+
+            if (level < 0 || level > INT_MAX) {
+                return 0;
+            }
+            valkey_glide->options.compression_level = (int) level;
+            break;
+        }
+
+        case VALKEY_GLIDE_OPT_COMPRESSION_MIN_SIZE: {
+            zend_long min_size = zval_get_long(value);
+
+            if (min_size < 0) {
+                return 0;
+            }
+            valkey_glide->options.compression_min_size = min_size;
+            break;
+        }
+
+        case VALKEY_GLIDE_OPT_LAZY_RESULTS: {
+            zend_long min_elements = zval_get_long(value);
+
+            if (min_elements < 0) {
+                return 0;
+            }
+            valkey_glide->options.lazy_results = min_elements;
+            break;
+        }
+
+        default:
+            return 0;
+    }
+
+    /* Cached replies were decoded, and keyed, with the previous options */
+    valkey_glide_cache_reset(valkey_glide->cache);
+
+    ZVAL_TRUE(return_value);
+    return 1;
+}
+
+int execute_get_option_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    valkey_glide_object* valkey_glide;
+    zend_long            option;
+
+    if (zend_parse_method_parameters(argc, object, "Ol", &object, ce, &option) == FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+
+    switch (option) {
+        case VALKEY_GLIDE_OPT_SERIALIZER:
+            ZVAL_LONG(return_value, valkey_glide->options.serializer);
+            return 1;
+        case VALKEY_GLIDE_OPT_PREFIX:
+            if (valkey_glide->options.prefix) {
+                ZVAL_STR_COPY(return_value, valkey_glide->options.prefix);
+            } else {
+                ZVAL_NULL(return_value);
+            }
+            return 1;
+        case VALKEY_GLIDE_OPT_NULL_MULTIBULK_AS_NULL:
+            ZVAL_BOOL(return_value, valkey_glide->options.null_multibulk_as_null);
+            return 1;
+        case VALKEY_GLIDE_OPT_COMPRESSION:
+            ZVAL_LONG(return_value, valkey_glide->options.compression);
+            return 1;
+        case VALKEY_GLIDE_OPT_COMPRESSION_LEVEL:
+            ZVAL_LONG(return_value, valkey_glide->options.compression_level);
+            return 1;
+        case VALKEY_GLIDE_OPT_COMPRESSION_MIN_SIZE:
+            ZVAL_LONG(return_value, valkey_glide->options.compression_min_size);
+            return 1;
+        case VALKEY_GLIDE_OPT_LAZY_RESULTS:
+            ZVAL_LONG(return_value, valkey_glide->options.lazy_results);
+            return 1;
+        default:
+            return 0;
+    }
+}
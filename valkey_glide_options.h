@@ -0,0 +1,120 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Client Options                                          |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef VALKEY_GLIDE_OPTIONS_H
+#define VALKEY_GLIDE_OPTIONS_H
+
+#include "common.h"
+#include "php.h"
+
+/*
+ * setOption()/getOption(): the value serializer and compression, the key prefix, how null
+ * multi-bulk replies are returned and which replies are left to a ValkeyGlideResult
+ * (valkey_glide_result.h).
+ *
+ * Values are serialized, then compressed, by the argument preparers, straight into the
+ * argument vector, and replies are decompressed and unserialized by the response converters
+ * from the CommandResponse buffer. Both run inside the method call of the client, so they get
+ * the options from the running call (valkey_glide_current_options()) rather than through every
+ * helper in between.
+ *
+ * Serialized and prefixed arguments come with an owner: NULL when the argument points into
+ * the caller's data, otherwise an allocation the caller releases with efree().
+ */
+
+/* The ValkeyGlide or ValkeyGlideCluster object whose method is running, NULL outside of one */
+valkey_glide_object* valkey_glide_current_object(void);
+
+/* Make the commands a method of another class (ValkeyGlideBatchTemplate) sends use the options
+ * and the last error of this client, until it is called again with the previous one it
+ * returns */
+valkey_glide_object* valkey_glide_delegate(valkey_glide_object* valkey_glide);
+
+/* Options of the ValkeyGlide or ValkeyGlideCluster object whose method is running, NULL when
+ * they are all defaults */
+const valkey_glide_options_t* valkey_glide_current_options(void);
+
+void valkey_glide_options_free(valkey_glide_options_t* options);
+
+/* Whether values go through a serializer or the compressor on their way to the server */
+static inline bool valkey_glide_options_encode_values(const valkey_glide_options_t* options) {
+    return options && (options->serializer != VALKEY_GLIDE_SERIALIZER_NONE ||
+                       options->compression != VALKEY_GLIDE_COMPRESSION_NONE);
+}
+
+/* Whether this build can use a VALKEY_GLIDE_SERIALIZER_* */
+bool valkey_glide_serializer_available(zend_long serializer);
+
+/* Wire form of a value, compressed when OPT_COMPRESSION is set and the value is long enough.
+ * Without a serializer scalars are sent as strings (true as "1", false as "0") and arrays or
+ * objects are rejected: returns NULL. */
+const char* valkey_glide_serialize(const valkey_glide_options_t* options,
+                                   zval*                         value,
+                                   size_t*                       len,
+                                   char**                        owner);
+
+/* Wire form of a value passed to the method as a string */
+const char* valkey_glide_serialize_string(const valkey_glide_options_t* options,
+                                          const char*                   value,
+                                          size_t                        value_len,
+                                          size_t*                       len,
+                                          char**                        owner);
+
+/* PHP value of a reply string, decompressed first when it carries the compression header; the
+ * string itself if it cannot be unserialized */
+void valkey_glide_unserialize(const valkey_glide_options_t* options,
+                              const char*                   value,
+                              size_t                        value_len,
+                              zval*                         output);
+
+/* Unserialize the string elements of a reply array, in place */
+void valkey_glide_unserialize_array(const valkey_glide_options_t* options, zval* array);
+
+/* Key with OPT_PREFIX prepended */
+const char* valkey_glide_prefix_key(const valkey_glide_options_t* options,
+                                    const char*                   key,
+                                    size_t                        key_len,
+                                    size_t*                       len,
+                                    char**                        owner);
+
+/* Fill prefixed with the keys of an array (or its values for a list) with OPT_PREFIX
+ * prepended. Returns false, leaving prefixed untouched, when there is no prefix. */
+bool valkey_glide_prefix_key_array(const valkey_glide_options_t* options,
+                                   zval*                         keys,
+                                   bool                          assoc_keys,
+                                   zval*                         prefixed);
+
+int execute_set_option_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+int execute_get_option_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+
+#define OPTION_METHOD_IMPL_EX(class_name, method_name, execute_fn)                 \
+    PHP_METHOD(class_name, method_name) {                                          \
+        if (execute_fn(getThis(),                                                  \
+                       ZEND_NUM_ARGS(),                                            \
+                       return_value,                                               \
+                       strcmp(#class_name, "ValkeyGlideCluster") == 0              \
+                           ? get_valkey_glide_cluster_ce()                         \
+                           : get_valkey_glide_ce())) {                             \
+            return;                                                                \
+        }                                                                          \
+        zval_dtor(return_value);                                                   \
+        RETURN_FALSE;                                                              \
+    }
+
+#define SETOPTION_METHOD_IMPL(class_name) \
+    OPTION_METHOD_IMPL_EX(class_name, setOption, execute_set_option_command)
+
+#define GETOPTION_METHOD_IMPL(class_name) \
+    OPTION_METHOD_IMPL_EX(class_name, getOption, execute_get_option_command)
+
+#endif /* VALKEY_GLIDE_OPTIONS_H */
@@ -0,0 +1,218 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Persistent Client Pool                                  |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#include "valkey_glide_pool.h"
+
+#include <zend_exceptions.h>
+
+#include "include/glide_bindings.h"
+#include "logger.h"
+#include "valkey_glide_commands_common.h"
+#include "valkey_glide_format.h"
+#include "valkey_glide_pubsub.h"
+
+/*
+ * The pool is keyed on the persistent_id followed by the serialized connection request.
+ * The protobuf encoding is a normalized form of the whole client configuration (addresses,
+ * credentials, TLS, database, cluster mode, timeouts...), so two constructors only share a
+ * client when every connection setting matches, not just the persistent_id.
+ *
+ * Each key holds the clients not lent to any object; there are as many clients per key as
+ * objects of that configuration were alive at once.
+ */
+struct valkey_glide_pool_entry {
+    const void** idle;
+    size_t       idle_count;
+    size_t       idle_capacity;
+    size_t       client_count; /* Idle and lent */
+};
+
+static HashTable valkey_glide_pool;
+static bool      valkey_glide_pool_initialized = false;
+static zend_long valkey_glide_pool_hits        = 0;
+static zend_long valkey_glide_pool_misses      = 0;
+
+#ifdef ZTS
+static MUTEX_T valkey_glide_pool_mutex;
+#define POOL_LOCK() tsrm_mutex_lock(valkey_glide_pool_mutex)
+#define POOL_UNLOCK() tsrm_mutex_unlock(valkey_glide_pool_mutex)
+#else
+#define POOL_LOCK()
+#define POOL_UNLOCK()
+#endif
+
+void valkey_glide_pool_init(void) {
+    zend_hash_init(&valkey_glide_pool, 8, NULL, NULL, 1);
+#ifdef ZTS
+    valkey_glide_pool_mutex = tsrm_mutex_alloc();
+#endif
+    valkey_glide_pool_initialized = true;
+}
+
+void valkey_glide_pool_shutdown(void) {
+    struct valkey_glide_pool_entry* entry;
+
+    if (!valkey_glide_pool_initialized) {
+        return;
+    }
+
+    ZEND_HASH_FOREACH_PTR(&valkey_glide_pool, entry) {
+        for (size_t i = 0; i < entry->idle_count; i++) {
+            close_glide_client(entry->idle[i]);
+        }
+        pefree(entry->idle, 1);
+        pefree(entry, 1);
+    }
+    ZEND_HASH_FOREACH_END();
+
+    zend_hash_destroy(&valkey_glide_pool);
+#ifdef ZTS
+    tsrm_mutex_free(valkey_glide_pool_mutex);
+#endif
+    valkey_glide_pool_initialized = false;
+}
+
+const void* valkey_glide_pool_acquire(const char*                      persistent_id,
+                                      size_t                           persistent_id_len,
+                                      const uint8_t*                   request_bytes,
+                                      size_t                           request_len,
+                                      struct valkey_glide_pool_entry** entry) {
+    const void* glide_client = NULL;
+
+    /* Build the pool key: "<persistent_id>\0<connection request bytes>" */
+    size_t key_len = persistent_id_len + 1 + request_len;
+    char*  key     = emalloc(key_len);
+    memcpy(key, persistent_id, persistent_id_len);
+    key[persistent_id_len] = '\0';
+    memcpy(key + persistent_id_len + 1, request_bytes, request_len);
+
+    POOL_LOCK();
+    *entry = zend_hash_str_find_ptr(&valkey_glide_pool, key, key_len);
+    if (!*entry) {
+        *entry = pecalloc(1, sizeof(struct valkey_glide_pool_entry), 1);
+        zend_hash_str_add_ptr(&valkey_glide_pool, key, key_len, *entry);
+    }
+    if ((*entry)->idle_count > 0) {
+        glide_client = (*entry)->idle[--(*entry)->idle_count];
+        valkey_glide_pool_hits++;
+        POOL_UNLOCK();
+        VALKEY_LOG_DEBUG("persistent_pool", "Reusing pooled client");
+        goto cleanup;
+    }
+    valkey_glide_pool_misses++;
+    (*entry)->client_count++;
+    POOL_UNLOCK();
+
+    /* Miss: connect outside the lock, connection setup can take a while. */
+    const ConnectionResponse* conn_resp =
+        create_glide_client_from_request(request_bytes, request_len);
+    if (!conn_resp) {
+        zend_throw_exception(get_valkey_glide_exception_ce(), "Failed to create client", 0);
+    } else if (conn_resp->connection_error_message) {
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), conn_resp->connection_error_message, 0);
+    } else {
+        glide_client = conn_resp->conn_ptr;
+    }
+    if (conn_resp) {
+        free_connection_response((ConnectionResponse*) conn_resp);
+    }
+
+    if (!glide_client) {
+        POOL_LOCK();
+        (*entry)->client_count--;
+        POOL_UNLOCK();
+    }
+
+cleanup:
+    efree(key);
+    return glide_client;
+}
+
+/* Send a command of the reset, outside of any method call, and tell whether it succeeded */
+static bool pool_reset_command(const void*          glide_client,
+                               enum RequestType     request_type,
+                               unsigned long        arg_count,
+                               const uintptr_t*     args,
+                               const unsigned long* args_len) {
+    CommandResult* result =
+        command(glide_client, 0, request_type, arg_count, args, args_len, NULL, 0, 0);
+    bool ok = result && !result->command_error;
+
+    if (result) {
+        free_command_result(result);
+    }
+    return ok;
+}
+
+/* Undo what the borrower changed on the connection. Returns false when the client could not
+ * be brought back to its configuration. */
+static bool pool_reset_client(valkey_glide_object* valkey_glide) {
+    bool clean = true;
+
+    if (valkey_glide->watching) {
+        clean = pool_reset_command(valkey_glide->glide_client, UnWatch, 0, NULL, NULL) && clean;
+    }
+    if (valkey_glide->selected_database != valkey_glide->database) {
+        char          database[VALKEY_GLIDE_FORMAT_LONG_SIZE];
+        uintptr_t     args[1] = {(uintptr_t) database};
+        unsigned long lens[1] = {valkey_glide_format_long(valkey_glide->database, database)};
+
+        clean = pool_reset_command(valkey_glide->glide_client, Select, 1, args, lens) && clean;
+    }
+    if (valkey_glide->pubsub && !valkey_glide_pubsub_reset(valkey_glide)) {
+        clean = false;
+    }
+    return clean;
+}
+
+void valkey_glide_pool_release(valkey_glide_object* valkey_glide) {
+    struct valkey_glide_pool_entry* entry        = valkey_glide->pool_entry;
+    const void*                     glide_client = valkey_glide->glide_client;
+
+    if (!pool_reset_client(valkey_glide)) {
+        VALKEY_LOG_WARN("persistent_pool", "Closing a pooled client that could not be reset");
+        POOL_LOCK();
+        entry->client_count--;
+        POOL_UNLOCK();
+        close_glide_client(glide_client);
+        return;
+    }
+
+    POOL_LOCK();
+    if (entry->idle_count == entry->idle_capacity) {
+        size_t capacity = MAX(entry->idle_capacity * 2, 4);
+
+        entry->idle          = safe_perealloc(entry->idle, capacity, sizeof(void*), 0, 1);
+        entry->idle_capacity = capacity;
+    }
+    entry->idle[entry->idle_count++] = glide_client;
+    POOL_UNLOCK();
+}
+
+void valkey_glide_pool_stats(zval* return_value) {
+    struct valkey_glide_pool_entry* entry;
+    zend_long                       connections = 0;
+
+    array_init_size(return_value, 3);
+
+    POOL_LOCK();
+    ZEND_HASH_FOREACH_PTR(&valkey_glide_pool, entry) {
+        connections += entry->client_count;
+    }
+    ZEND_HASH_FOREACH_END();
+    add_assoc_long(return_value, "hits", valkey_glide_pool_hits);
+    add_assoc_long(return_value, "misses", valkey_glide_pool_misses);
+    add_assoc_long(return_value, "connections", connections);
+    POOL_UNLOCK();
+}
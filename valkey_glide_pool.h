@@ -0,0 +1,43 @@
+#ifndef VALKEY_GLIDE_POOL_H
+#define VALKEY_GLIDE_POOL_H
+
+#include "common.h"
+#include "php.h"
+
+/*
+ * Process-wide pool of persistent Glide clients.
+ *
+ * Clients created with a persistent_id outlive the PHP request that created them and are
+ * handed back to later requests served by the same worker process when the connection
+ * configuration matches, avoiding a fresh connect/handshake per request under PHP-FPM.
+ *
+ * A pooled client is lent to one object at a time, so objects alive at once never share the
+ * state of a connection. When the object is freed its client is reset to the configuration
+ * it was created with (database, no WATCH, no subscriptions made after connecting) and goes
+ * back to the pool, or is closed if the reset failed. Idle clients are closed at module
+ * shutdown.
+ */
+
+/* Clients of one persistent_id and connection configuration */
+struct valkey_glide_pool_entry;
+
+/* Pool lifecycle, called from MINIT/MSHUTDOWN */
+void valkey_glide_pool_init(void);
+void valkey_glide_pool_shutdown(void);
+
+/* Borrow an idle pooled client for persistent_id and the serialized connection request,
+ * creating one on a miss, and set *entry to the pool it goes back to. Returns NULL and throws
+ * a ValkeyGlideException if the connection could not be created. */
+const void* valkey_glide_pool_acquire(const char*                      persistent_id,
+                                      size_t                           persistent_id_len,
+                                      const uint8_t*                   request_bytes,
+                                      size_t                           request_len,
+                                      struct valkey_glide_pool_entry** entry);
+
+/* Reset the borrowed client of an object being freed and give it back to its pool */
+void valkey_glide_pool_release(valkey_glide_object* valkey_glide);
+
+/* Fill return_value with the pool hit/miss counters */
+void valkey_glide_pool_stats(zval* return_value);
+
+#endif /* VALKEY_GLIDE_POOL_H */
@@ -0,0 +1,1349 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Pub/Sub Commands                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#include "valkey_glide_pubsub.h"
+
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <sys/time.h>
+#include <time.h>
+#include <zend_exceptions.h>
+
+#include "command_response.h"
+#include "logger.h"
+#include "valkey_glide_args.h"
+
+/* A buffered push message: channel, payload and pattern stored back to back */
+typedef struct {
+    enum PushKind kind;
+    size_t        channel_len;
+    size_t        message_len;
+    size_t        pattern_len;
+    char          data[];
+} valkey_glide_pubsub_message;
+
+/* A recorded client-side cache invalidation; key NULL invalidates everything */
+typedef struct {
+    char*  key;
+    size_t key_len;
+    bool   reconnect; /* The connection dropped, tracking has to be enabled again */
+} valkey_glide_pubsub_invalidation;
+
+typedef struct pubsub_producer_slot pubsub_producer_slot;
+
+struct valkey_glide_pubsub_state {
+    uintptr_t client_ptr; /* 0 while the client is still being created */
+    size_t    capacity;   /* Power of two */
+
+    /* Serializes the producers, Glide can deliver the pushes of several connections of a
+     * client at once. Held while a message or an invalidation is written, never by
+     * getMessages(). */
+    pthread_mutex_t       produce_lock;
+    pubsub_producer_slot* producer_slot; /* NULL when the table was full */
+
+    /* Ring buffer, allocated on the first subscription. The producer owns head, the consumer
+     * owns tail; each only reads the other's index. */
+    valkey_glide_pubsub_message** slots;
+    _Atomic size_t                head;
+    _Atomic size_t                tail;
+    _Atomic uint64_t              dropped;
+    uint64_t                      dropped_reported; /* Consumer side */
+
+    /* Channels and patterns subscribed with subscribe() and psubscribe(), undone before a
+     * pooled client is lent again. Consumer side only. */
+    HashTable channels;
+    HashTable patterns;
+
+    /* Shard channels subscribed with ssubscribe(), subscribed again when the server drops them
+     * because their slot moved to another shard. Consumer side only. */
+    HashTable    sharded_channels;
+    _Atomic bool resync_sharded; /* A slot migration notification did not fit in the ring */
+
+    /* Only used when getMessages() is asked to wait for an empty buffer */
+    _Atomic bool    consumer_waiting;
+    pthread_mutex_t wait_lock;
+    pthread_cond_t  wait_cond;
+
+    /* Client-side cache invalidations, recorded once a cache asked for them. The callback
+     * writes under produce_lock; each cache sharing the client replays them from its own
+     * position, so one pooled client can serve several caches. */
+    valkey_glide_pubsub_invalidation* invalidations;
+    _Atomic uint64_t                  invalidation_seq;
+
+    struct valkey_glide_pubsub_state* next;
+};
+
+/* Kinds of subscription, each tracked in a table of the state */
+typedef enum {
+    PUBSUB_CHANNELS,
+    PUBSUB_PATTERNS,
+    PUBSUB_SHARDED,
+} pubsub_subscription_kind;
+
+/*
+ * Registry of every client's state, updated under registry_lock when clients connect and
+ * close. The callback does not use it: it finds the state of the client pointer Glide passes
+ * it in the producer slots below, without taking a lock shared by the clients.
+ */
+static pthread_mutex_t            registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static valkey_glide_pubsub_state* registry      = NULL;
+
+/*
+ * Producer slots, an open addressing table from client pointer to state written under
+ * registry_lock and read by the callback with atomics only. A callback pins the slot it found
+ * by counting itself in users before it reads the state, and removing a client clears the
+ * state then waits for the users to leave, so a state is never freed under a callback.
+ * Clients connected while every slot is taken are looked up in the registry instead.
+ */
+#define PUBSUB_PRODUCER_SLOT_BITS 10
+#define PUBSUB_PRODUCER_SLOTS (1 << PUBSUB_PRODUCER_SLOT_BITS)
+#define PUBSUB_PRODUCER_SLOT_FREED ((uintptr_t) 1) /* Keeps the probe sequences going */
+
+struct pubsub_producer_slot {
+    _Atomic uintptr_t                  client_ptr; /* 0 for a slot never used */
+    valkey_glide_pubsub_state* _Atomic state;
+    _Atomic uint32_t                   users; /* Callbacks using state */
+};
+
+static pubsub_producer_slot producer_slots[PUBSUB_PRODUCER_SLOTS];
+static _Atomic size_t       producer_overflow = 0; /* Registered clients without a slot */
+
+/* The client being created with connect-time subscriptions, client_ptr 0 until its first
+ * message names it */
+static pubsub_producer_slot pending_slot;
+
+/* Concurrent connects with connect-time subscriptions (ZTS) are serialized on connect_lock,
+ * the pending slot holding the state of one of them at a time */
+static pthread_mutex_t connect_lock       = PTHREAD_MUTEX_INITIALIZER;
+static ZEND_TLS bool   holds_connect_lock = false;
+
+static size_t round_up_pow2(zend_long value) {
+    size_t capacity = 1;
+
+    while (capacity < (size_t) value) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+static valkey_glide_pubsub_state* pubsub_state_create(zend_long buffer_size) {
+    valkey_glide_pubsub_state* state = calloc(1, sizeof(valkey_glide_pubsub_state));
+
+    if (!state) {
+        return NULL;
+    }
+
+    state->capacity = round_up_pow2(buffer_size > 0 ? buffer_size
+                                                    : VALKEY_GLIDE_PUBSUB_DEFAULT_BUFFER_SIZE);
+    atomic_init(&state->head, 0);
+    atomic_init(&state->tail, 0);
+    atomic_init(&state->dropped, 0);
+    atomic_init(&state->consumer_waiting, false);
+    atomic_init(&state->resync_sharded, false);
+    atomic_init(&state->invalidation_seq, 0);
+    zend_hash_init(&state->channels, 8, NULL, NULL, 1);
+    zend_hash_init(&state->patterns, 8, NULL, NULL, 1);
+    zend_hash_init(&state->sharded_channels, 8, NULL, NULL, 1);
+    pthread_mutex_init(&state->produce_lock, NULL);
+    pthread_mutex_init(&state->wait_lock, NULL);
+    pthread_cond_init(&state->wait_cond, NULL);
+    return state;
+}
+
+/* Allocate the ring, under produce_lock so the callback sees it consistently */
+static bool pubsub_state_alloc_slots(valkey_glide_pubsub_state* state) {
+    bool allocated;
+
+    pthread_mutex_lock(&state->produce_lock);
+    if (!state->slots) {
+        state->slots = calloc(state->capacity, sizeof(valkey_glide_pubsub_message*));
+    }
+    allocated = state->slots != NULL;
+    pthread_mutex_unlock(&state->produce_lock);
+
+    return allocated;
+}
+
+static void pubsub_state_free(valkey_glide_pubsub_state* state) {
+    if (!state) {
+        return;
+    }
+
+    if (state->slots) {
+        size_t tail = atomic_load(&state->tail);
+        size_t head = atomic_load(&state->head);
+
+        for (; tail != head; tail++) {
+            free(state->slots[tail & (state->capacity - 1)]);
+        }
+        free(state->slots);
+    }
+
+    if (state->invalidations) {
+        for (size_t i = 0; i < VALKEY_GLIDE_INVALIDATION_LOG_SIZE; i++) {
+            free(state->invalidations[i].key);
+        }
+        free(state->invalidations);
+    }
+
+    zend_hash_destroy(&state->channels);
+    zend_hash_destroy(&state->patterns);
+    zend_hash_destroy(&state->sharded_channels);
+    pthread_cond_destroy(&state->wait_cond);
+    pthread_mutex_destroy(&state->wait_lock);
+    pthread_mutex_destroy(&state->produce_lock);
+    free(state);
+}
+
+static valkey_glide_pubsub_state* registry_find(uintptr_t client_ptr) {
+    valkey_glide_pubsub_state* state;
+
+    for (state = registry; state; state = state->next) {
+        if (state->client_ptr == client_ptr) {
+            return state;
+        }
+    }
+    return NULL;
+}
+
+static size_t producer_slot_hash(uintptr_t client_ptr) {
+    return (size_t) (((uint64_t) client_ptr >> 4) * 0x9E3779B97F4A7C15ULL >>
+                     (64 - PUBSUB_PRODUCER_SLOT_BITS));
+}
+
+/* Give a registered state a producer slot. Called with registry_lock held. */
+static void producer_slot_insert(valkey_glide_pubsub_state* state) {
+    size_t start = producer_slot_hash(state->client_ptr);
+
+    for (size_t i = 0; i < PUBSUB_PRODUCER_SLOTS; i++) {
+        pubsub_producer_slot* slot = &producer_slots[(start + i) & (PUBSUB_PRODUCER_SLOTS - 1)];
+        uintptr_t             key  = atomic_load(&slot->client_ptr);
+
+        if (key == 0 || key == PUBSUB_PRODUCER_SLOT_FREED) {
+            /* The key first: a callback reading the state checks the key again after */
+            atomic_store(&slot->client_ptr, state->client_ptr);
+            atomic_store(&slot->state, state);
+            state->producer_slot = slot;
+            return;
+        }
+    }
+    atomic_fetch_add(&producer_overflow, 1);
+}
+
+/* Detach a state from the callback, waiting for the callbacks using it */
+static void producer_slot_clear(pubsub_producer_slot* slot, uintptr_t key) {
+    atomic_store(&slot->state, NULL);
+    while (atomic_load(&slot->users) != 0) {
+        sched_yield();
+    }
+    atomic_store(&slot->client_ptr, key);
+}
+
+/* Called with registry_lock held */
+static void producer_slot_remove(valkey_glide_pubsub_state* state) {
+    if (state->producer_slot) {
+        producer_slot_clear(state->producer_slot, PUBSUB_PRODUCER_SLOT_FREED);
+        state->producer_slot = NULL;
+    } else {
+        atomic_fetch_sub(&producer_overflow, 1);
+    }
+}
+
+/* The state of a slot if it belongs to client_ptr, the slot then pinned */
+static valkey_glide_pubsub_state* producer_slot_pin(pubsub_producer_slot* slot,
+                                                    uintptr_t             client_ptr,
+                                                    bool                  claim) {
+    valkey_glide_pubsub_state* state;
+    uintptr_t                  key;
+
+    atomic_fetch_add(&slot->users, 1);
+    state = atomic_load(&slot->state);
+    key   = atomic_load(&slot->client_ptr);
+    if (state && key == 0 && claim) {
+        /* Connect-time subscription delivering before create_client() returned */
+        if (atomic_compare_exchange_strong(&slot->client_ptr, &key, client_ptr)) {
+            key = client_ptr;
+        }
+    }
+    if (state && key == client_ptr) {
+        return state;
+    }
+    atomic_fetch_sub(&slot->users, 1);
+    return NULL;
+}
+
+/*
+ * Find and pin the state of a client for the callback, or NULL. *pinned is what
+ * producer_unpin() releases: a slot, or NULL when the registry lock is held because the client
+ * had none.
+ */
+static valkey_glide_pubsub_state* producer_pin(uintptr_t              client_ptr,
+                                               bool                   connecting,
+                                               pubsub_producer_slot** pinned) {
+    valkey_glide_pubsub_state* state;
+    size_t                     start = producer_slot_hash(client_ptr);
+
+    for (size_t i = 0; i < PUBSUB_PRODUCER_SLOTS; i++) {
+        pubsub_producer_slot* slot = &producer_slots[(start + i) & (PUBSUB_PRODUCER_SLOTS - 1)];
+        uintptr_t             key  = atomic_load(&slot->client_ptr);
+
+        if (key == 0) {
+            break;
+        }
+        if (key == client_ptr && (state = producer_slot_pin(slot, client_ptr, false)) != NULL) {
+            *pinned = slot;
+            return state;
+        }
+    }
+
+    if (connecting && (state = producer_slot_pin(&pending_slot, client_ptr, true)) != NULL) {
+        *pinned = &pending_slot;
+        return state;
+    }
+
+    if (atomic_load(&producer_overflow) > 0) {
+        pthread_mutex_lock(&registry_lock);
+        state = registry_find(client_ptr);
+        if (state) {
+            *pinned = NULL;
+            return state;
+        }
+        pthread_mutex_unlock(&registry_lock);
+    }
+    return NULL;
+}
+
+static void producer_unpin(pubsub_producer_slot* pinned) {
+    if (pinned) {
+        atomic_fetch_sub(&pinned->users, 1);
+    } else {
+        pthread_mutex_unlock(&registry_lock);
+    }
+}
+
+/* ====================================================================
+ * PRODUCER SIDE (Glide threads)
+ * ==================================================================== */
+
+static void pubsub_ring_push(valkey_glide_pubsub_state* state, valkey_glide_pubsub_message* msg) {
+    size_t head = atomic_load_explicit(&state->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&state->tail, memory_order_acquire);
+
+    if (head - tail >= state->capacity) {
+        /* Full: keep what the consumer has not read yet and drop the newest message. */
+        if (msg->kind == PushSUnsubscribe) {
+            atomic_store(&state->resync_sharded, true);
+        } else {
+            atomic_fetch_add_explicit(&state->dropped, 1, memory_order_relaxed);
+        }
+        free(msg);
+        return;
+    }
+
+    state->slots[head & (state->capacity - 1)] = msg;
+
+    /* Publish the slot. Sequentially consistent so it is ordered against the consumer_waiting
+     * load below; see pubsub_ring_wait(). */
+    atomic_store(&state->head, head + 1);
+
+    if (atomic_load(&state->consumer_waiting)) {
+        pthread_mutex_lock(&state->wait_lock);
+        pthread_cond_signal(&state->wait_cond);
+        pthread_mutex_unlock(&state->wait_lock);
+    }
+}
+
+/* Record a key invalidation (or a dropped connection) for the client-side caches */
+static void pubsub_record_invalidation(uintptr_t      client_ptr,
+                                       const uint8_t* key,
+                                       int64_t        key_len,
+                                       bool           reconnect) {
+    valkey_glide_pubsub_state*        state;
+    valkey_glide_pubsub_invalidation* entry;
+    pubsub_producer_slot*             pinned;
+    char*                             copy = NULL;
+
+    if (key && key_len > 0 && !reconnect) {
+        copy = malloc(key_len);
+        if (!copy) {
+            /* Cannot remember which key, so drop everything */
+            key_len = 0;
+        } else {
+            memcpy(copy, key, key_len);
+        }
+    }
+
+    state = producer_pin(client_ptr, false, &pinned);
+    if (state) {
+        pthread_mutex_lock(&state->produce_lock);
+        if (state->invalidations) {
+            uint64_t seq = atomic_load_explicit(&state->invalidation_seq, memory_order_relaxed);
+
+            entry = &state->invalidations[seq & (VALKEY_GLIDE_INVALIDATION_LOG_SIZE - 1)];
+            free(entry->key);
+            entry->key       = copy;
+            entry->key_len   = copy ? (size_t) key_len : 0;
+            entry->reconnect = reconnect;
+            atomic_store_explicit(&state->invalidation_seq, seq + 1, memory_order_release);
+            copy = NULL;
+        }
+        pthread_mutex_unlock(&state->produce_lock);
+        producer_unpin(pinned);
+    }
+
+    free(copy);
+}
+
+void valkey_glide_pubsub_callback(uintptr_t      client_ptr,
+                                  enum PushKind  kind,
+                                  const uint8_t* message,
+                                  int64_t        message_len,
+                                  const uint8_t* channel,
+                                  int64_t        channel_len,
+                                  const uint8_t* pattern,
+                                  int64_t        pattern_len) {
+    valkey_glide_pubsub_state*   state;
+    valkey_glide_pubsub_message* msg;
+    pubsub_producer_slot*        pinned;
+
+    /* CLIENT TRACKING: the invalidated key is the payload, none means the server flushed */
+    if (kind == PushInvalidate || kind == PushDisconnection) {
+        pubsub_record_invalidation(client_ptr, message, message_len, kind == PushDisconnection);
+        return;
+    }
+
+    /* Subscription confirmations and other pushes carry nothing to deliver. Shard unsubscribe
+     * notifications are queued too: the consumer tells slot migrations from its own
+     * sunsubscribe() calls and re-subscribes. */
+    if (kind != PushMessage && kind != PushPMessage && kind != PushSMessage &&
+        kind != PushSUnsubscribe) {
+        return;
+    }
+
+    if (message_len < 0 || channel_len < 0 || pattern_len < 0) {
+        return;
+    }
+    if (!pattern) {
+        pattern_len = 0;
+    }
+
+    /* Build the message before looking up the client, allocation is the slow part. */
+    msg = malloc(sizeof(valkey_glide_pubsub_message) + channel_len + message_len + pattern_len);
+    if (!msg) {
+        return;
+    }
+    msg->kind        = kind;
+    msg->channel_len = channel_len;
+    msg->message_len = message_len;
+    msg->pattern_len = pattern_len;
+    if (channel_len) {
+        memcpy(msg->data, channel, channel_len);
+    }
+    if (message_len) {
+        memcpy(msg->data + channel_len, message, message_len);
+    }
+    if (pattern_len) {
+        memcpy(msg->data + channel_len + message_len, pattern, pattern_len);
+    }
+
+    state = producer_pin(client_ptr, true, &pinned);
+    if (!state) {
+        free(msg);
+        return;
+    }
+
+    pthread_mutex_lock(&state->produce_lock);
+    if (state->slots) {
+        pubsub_ring_push(state, msg);
+    } else {
+        free(msg);
+    }
+    pthread_mutex_unlock(&state->produce_lock);
+
+    producer_unpin(pinned);
+}
+
+/* ====================================================================
+ * CONSUMER SIDE (PHP thread)
+ * ==================================================================== */
+
+static valkey_glide_pubsub_message* pubsub_ring_pop(valkey_glide_pubsub_state* state) {
+    valkey_glide_pubsub_message* msg;
+    size_t tail = atomic_load_explicit(&state->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&state->head, memory_order_acquire);
+
+    if (tail == head) {
+        return NULL;
+    }
+
+    msg = state->slots[tail & (state->capacity - 1)];
+    atomic_store_explicit(&state->tail, tail + 1, memory_order_release);
+    return msg;
+}
+
+/* Block until the ring is non-empty or the timeout (in seconds) expires */
+static void pubsub_ring_wait(valkey_glide_pubsub_state* state, double timeout) {
+    struct timeval  now;
+    struct timespec deadline;
+    double          whole = floor(timeout);
+
+    gettimeofday(&now, NULL);
+    deadline.tv_sec  = now.tv_sec + (time_t) whole;
+    deadline.tv_nsec = now.tv_usec * 1000 + (long) ((timeout - whole) * 1e9);
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    /* Announce ourselves before re-checking the ring: either the producer sees the flag and
+     * signals, or we see its head update and skip the wait. Holding wait_lock across the check
+     * and the wait means the signal cannot slip in between. */
+    pthread_mutex_lock(&state->wait_lock);
+    atomic_store(&state->consumer_waiting, true);
+    while (atomic_load(&state->head) == atomic_load_explicit(&state->tail, memory_order_relaxed)) {
+        if (pthread_cond_timedwait(&state->wait_cond, &state->wait_lock, &deadline) ==
+            ETIMEDOUT) {
+            break;
+        }
+    }
+    atomic_store(&state->consumer_waiting, false);
+    pthread_mutex_unlock(&state->wait_lock);
+}
+
+static const char* pubsub_kind_name(enum PushKind kind) {
+    switch (kind) {
+        case PushPMessage:
+            return "pmessage";
+        case PushSMessage:
+            return "smessage";
+        default:
+            return "message";
+    }
+}
+
+static void pubsub_message_to_zval(valkey_glide_pubsub_message* msg, zval* output) {
+    array_init_size(output, 4);
+    add_assoc_string(output, "kind", (char*) pubsub_kind_name(msg->kind));
+    add_assoc_stringl(output, "channel", msg->data, msg->channel_len);
+    add_assoc_stringl(output, "message", msg->data + msg->channel_len, msg->message_len);
+    if (msg->kind == PushPMessage) {
+        add_assoc_stringl(
+            output, "pattern", msg->data + msg->channel_len + msg->message_len, msg->pattern_len);
+    } else if (msg->kind == PushSMessage) {
+        /* Shard messages from every node share the buffer; the slot identifies the shard */
+        add_assoc_long(output, "slot", valkey_glide_key_slot(msg->data, msg->channel_len));
+    }
+}
+
+static void pubsub_reattach_sharded(valkey_glide_object* valkey_glide, HashTable* channels);
+
+static void pubsub_drain(valkey_glide_object* valkey_glide, zend_long max, zval* return_value) {
+    valkey_glide_pubsub_state*   state = valkey_glide->pubsub;
+    valkey_glide_pubsub_message* msg;
+    uint64_t                     dropped;
+    HashTable                    moved;
+
+    zend_hash_init(&moved, 0, NULL, NULL, 0);
+
+    while (zend_hash_num_elements(Z_ARRVAL_P(return_value)) < (uint32_t) max &&
+           (msg = pubsub_ring_pop(state)) != NULL) {
+        zval entry;
+
+        if (msg->kind == PushSUnsubscribe) {
+            /* Still tracked, so not requested by sunsubscribe(): the slot moved */
+            if (zend_hash_str_exists(&state->sharded_channels, msg->data, msg->channel_len)) {
+                zend_hash_str_add_empty_element(&moved, msg->data, msg->channel_len);
+            }
+            free(msg);
+            continue;
+        }
+
+        pubsub_message_to_zval(msg, &entry);
+        add_next_index_zval(return_value, &entry);
+        free(msg);
+    }
+
+    if (atomic_exchange(&state->resync_sharded, false)) {
+        /* Lost track of which channels moved, SSUBSCRIBE is idempotent so redo them all */
+        pubsub_reattach_sharded(valkey_glide, &state->sharded_channels);
+    } else {
+        pubsub_reattach_sharded(valkey_glide, &moved);
+    }
+    zend_hash_destroy(&moved);
+
+    dropped = atomic_load_explicit(&state->dropped, memory_order_relaxed);
+    if (dropped != state->dropped_reported) {
+        char buf[128];
+
+        snprintf(buf,
+                 sizeof(buf),
+                 "Message buffer full, dropped %llu messages",
+                 (unsigned long long) (dropped - state->dropped_reported));
+        VALKEY_LOG_WARN("pubsub", buf);
+        state->dropped_reported = dropped;
+    }
+}
+
+/* ====================================================================
+ * LIFECYCLE
+ * ==================================================================== */
+
+void valkey_glide_pubsub_init(void) {
+    registry = NULL;
+}
+
+void valkey_glide_pubsub_shutdown(void) {
+    valkey_glide_pubsub_state* state;
+
+    /* Every client has been closed (and unregistered) by now, except in case of a leak. */
+    pthread_mutex_lock(&registry_lock);
+    while ((state = registry) != NULL) {
+        registry = state->next;
+        producer_slot_remove(state);
+        pubsub_state_free(state);
+    }
+    pthread_mutex_unlock(&registry_lock);
+}
+
+void valkey_glide_pubsub_begin_connect(zend_long buffer_size, bool has_subscriptions) {
+    valkey_glide_pubsub_state* state;
+
+    if (!has_subscriptions) {
+        return;
+    }
+
+    state = pubsub_state_create(buffer_size);
+    if (state && !pubsub_state_alloc_slots(state)) {
+        pubsub_state_free(state);
+        state = NULL;
+    }
+    if (!state) {
+        return;
+    }
+
+    pthread_mutex_lock(&connect_lock);
+    holds_connect_lock = true;
+
+    atomic_store(&pending_slot.state, state);
+}
+
+valkey_glide_pubsub_state* valkey_glide_pubsub_end_connect(const void* glide_client,
+                                                           zend_long   buffer_size) {
+    valkey_glide_pubsub_state* state  = NULL;
+    valkey_glide_pubsub_state* unused =
+        holds_connect_lock ? atomic_load(&pending_slot.state) : NULL;
+
+    pthread_mutex_lock(&registry_lock);
+
+    if (glide_client) {
+        state = registry_find((uintptr_t) glide_client);
+        if (!state) {
+            /* New client: adopt the connect-time buffer, or start without one */
+            state  = unused ? unused : pubsub_state_create(buffer_size);
+            unused = unused == state ? NULL : unused;
+            if (state) {
+                state->client_ptr = (uintptr_t) glide_client;
+                state->next       = registry;
+                registry          = state;
+                producer_slot_insert(state);
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&registry_lock);
+
+    if (holds_connect_lock) {
+        /* After registering, so every message finds one of the slots */
+        producer_slot_clear(&pending_slot, 0);
+        holds_connect_lock = false;
+        pthread_mutex_unlock(&connect_lock);
+    }
+
+    /* Pooled client (already registered) or failed connect */
+    pubsub_state_free(unused);
+    return state;
+}
+
+void valkey_glide_pubsub_unregister(const void* glide_client) {
+    valkey_glide_pubsub_state** link;
+    valkey_glide_pubsub_state*  state = NULL;
+
+    pthread_mutex_lock(&registry_lock);
+    for (link = &registry; *link; link = &(*link)->next) {
+        if ((*link)->client_ptr == (uintptr_t) glide_client) {
+            state = *link;
+            *link = state->next;
+            producer_slot_remove(state);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&registry_lock);
+
+    pubsub_state_free(state);
+}
+
+/* ====================================================================
+ * CLIENT-SIDE CACHE INVALIDATIONS
+ * ==================================================================== */
+
+bool valkey_glide_pubsub_track_invalidations(valkey_glide_pubsub_state* state) {
+    bool tracking;
+
+    pthread_mutex_lock(&state->produce_lock);
+    if (!state->invalidations) {
+        state->invalidations =
+            calloc(VALKEY_GLIDE_INVALIDATION_LOG_SIZE, sizeof(valkey_glide_pubsub_invalidation));
+    }
+    tracking = state->invalidations != NULL;
+    pthread_mutex_unlock(&state->produce_lock);
+
+    return tracking;
+}
+
+uint64_t valkey_glide_pubsub_invalidation_seq(valkey_glide_pubsub_state* state) {
+    return atomic_load_explicit(&state->invalidation_seq, memory_order_acquire);
+}
+
+uint64_t valkey_glide_pubsub_replay_invalidations(valkey_glide_pubsub_state*   state,
+                                                  uint64_t                     from,
+                                                  valkey_glide_invalidation_fn fn,
+                                                  void*                        ctx) {
+    uint64_t seq;
+
+    pthread_mutex_lock(&state->produce_lock);
+    seq = atomic_load_explicit(&state->invalidation_seq, memory_order_relaxed);
+    if (seq - from > VALKEY_GLIDE_INVALIDATION_LOG_SIZE) {
+        /* Overwritten before we got to them; whether a reconnect was among them is unknown */
+        fn(ctx, NULL, 0, true);
+    } else {
+        for (; from != seq; from++) {
+            valkey_glide_pubsub_invalidation* entry =
+                &state->invalidations[from & (VALKEY_GLIDE_INVALIDATION_LOG_SIZE - 1)];
+            fn(ctx, entry->key, entry->key_len, entry->reconnect);
+        }
+    }
+    pthread_mutex_unlock(&state->produce_lock);
+
+    return seq;
+}
+
+/* ====================================================================
+ * CONNECT-TIME SUBSCRIPTIONS
+ * ==================================================================== */
+
+/* The subscription keys accepted in advanced_config['pubsub_subscriptions'] */
+static const struct {
+    const char*                         name;
+    ConnectionRequest__PubSubChannelType type;
+} pubsub_subscription_types[] = {
+    {"channels", CONNECTION_REQUEST__PUB_SUB_CHANNEL_TYPE__Exact},
+    {"patterns", CONNECTION_REQUEST__PUB_SUB_CHANNEL_TYPE__Pattern},
+    {"sharded", CONNECTION_REQUEST__PUB_SUB_CHANNEL_TYPE__Sharded},
+};
+
+#define PUBSUB_SUBSCRIPTION_TYPES \
+    (sizeof(pubsub_subscription_types) / sizeof(pubsub_subscription_types[0]))
+
+/* Protobuf message plus everything it points to, released in one go */
+typedef struct {
+    ConnectionRequest__PubSubSubscriptions message; /* Must stay first */
+    ConnectionRequest__PubSubSubscriptions__ChannelsOrPatternsByTypeEntry
+        entries[PUBSUB_SUBSCRIPTION_TYPES];
+    ConnectionRequest__PubSubSubscriptions__ChannelsOrPatternsByTypeEntry*
+                                                entry_list[PUBSUB_SUBSCRIPTION_TYPES];
+    ConnectionRequest__PubSubChannelsOrPatterns values[PUBSUB_SUBSCRIPTION_TYPES];
+    zend_string**                               names;
+    size_t                                      names_count;
+} pubsub_subscriptions_request;
+
+ConnectionRequest__PubSubSubscriptions* valkey_glide_pubsub_build_subscriptions(
+    HashTable* subscriptions) {
+    pubsub_subscriptions_request* request;
+    size_t                        total = 0;
+    size_t                        i;
+
+    for (i = 0; i < PUBSUB_SUBSCRIPTION_TYPES; i++) {
+        zval* list = zend_hash_str_find(subscriptions,
+                                        pubsub_subscription_types[i].name,
+                                        strlen(pubsub_subscription_types[i].name));
+        if (list && Z_TYPE_P(list) == IS_ARRAY) {
+            total += zend_hash_num_elements(Z_ARRVAL_P(list));
+        }
+    }
+    if (total == 0) {
+        return NULL;
+    }
+
+    request        = ecalloc(1, sizeof(pubsub_subscriptions_request));
+    request->names = ecalloc(total, sizeof(zend_string*));
+
+    ConnectionRequest__PubSubSubscriptions init = CONNECTION_REQUEST__PUB_SUB_SUBSCRIPTIONS__INIT;
+
+    request->message                              = init;
+    request->message.channels_or_patterns_by_type = request->entry_list;
+
+    for (i = 0; i < PUBSUB_SUBSCRIPTION_TYPES; i++) {
+        ConnectionRequest__PubSubSubscriptions__ChannelsOrPatternsByTypeEntry entry_init =
+            CONNECTION_REQUEST__PUB_SUB_SUBSCRIPTIONS__CHANNELS_OR_PATTERNS_BY_TYPE_ENTRY__INIT;
+        ConnectionRequest__PubSubChannelsOrPatterns value_init =
+            CONNECTION_REQUEST__PUB_SUB_CHANNELS_OR_PATTERNS__INIT;
+        size_t n = request->message.n_channels_or_patterns_by_type;
+        zval*  list;
+        zval*  name;
+
+        list = zend_hash_str_find(subscriptions,
+                                  pubsub_subscription_types[i].name,
+                                  strlen(pubsub_subscription_types[i].name));
+        if (!list || Z_TYPE_P(list) != IS_ARRAY || zend_hash_num_elements(Z_ARRVAL_P(list)) == 0) {
+            continue;
+        }
+
+        request->values[n] = value_init;
+        request->values[n].channels_or_patterns =
+            ecalloc(zend_hash_num_elements(Z_ARRVAL_P(list)), sizeof(ProtobufCBinaryData));
+
+        ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(list), name) {
+            zend_string* str = zval_get_string(name);
+            size_t       idx = request->values[n].n_channels_or_patterns++;
+
+            request->names[request->names_count++]            = str;
+            request->values[n].channels_or_patterns[idx].data = (uint8_t*) ZSTR_VAL(str);
+            request->values[n].channels_or_patterns[idx].len  = ZSTR_LEN(str);
+        }
+        ZEND_HASH_FOREACH_END();
+
+        request->entries[n]       = entry_init;
+        request->entries[n].key   = pubsub_subscription_types[i].type;
+        request->entries[n].value = &request->values[n];
+        request->entry_list[n]    = &request->entries[n];
+        request->message.n_channels_or_patterns_by_type++;
+    }
+
+    return &request->message;
+}
+
+void valkey_glide_pubsub_free_subscriptions(
+    ConnectionRequest__PubSubSubscriptions* subscriptions) {
+    pubsub_subscriptions_request* request = (pubsub_subscriptions_request*) subscriptions;
+    size_t                        i;
+
+    if (!request) {
+        return;
+    }
+
+    for (i = 0; i < request->message.n_channels_or_patterns_by_type; i++) {
+        efree(request->values[i].channels_or_patterns);
+    }
+    for (i = 0; i < request->names_count; i++) {
+        zend_string_release(request->names[i]);
+    }
+    efree(request->names);
+    efree(request);
+}
+
+/* ====================================================================
+ * COMMANDS
+ * ==================================================================== */
+
+/* Send "<verb> name..." as a custom command; subscription replies arrive as pushes, so
+ * success only means the server accepted the request. */
+static int pubsub_send_names(const void*   glide_client,
+                             const char*   verb,
+                             zend_string** names,
+                             uint32_t      count) {
+    valkey_glide_args args;
+    int               status = 0;
+
+    valkey_glide_args_init(&args);
+    valkey_glide_args_add(&args, verb, strlen(verb));
+    for (uint32_t i = 0; i < count; i++) {
+        valkey_glide_args_add(&args, ZSTR_VAL(names[i]), ZSTR_LEN(names[i]));
+    }
+
+    CommandResult* result = valkey_glide_args_execute(glide_client, CustomCommand, &args, NULL);
+    valkey_glide_args_free(&args);
+    if (result) {
+        if (result->command_error) {
+            VALKEY_LOG_ERROR(verb, result->command_error->command_error_message);
+        } else {
+            status = 1;
+        }
+        free_command_result(result);
+    }
+
+    efree(args);
+    efree(lens);
+    return status;
+}
+
+typedef struct {
+    uint16_t     slot;
+    zend_string* name;
+} pubsub_slot_name;
+
+static int pubsub_compare_slot(const void* a, const void* b) {
+    return (int) ((const pubsub_slot_name*) a)->slot - (int) ((const pubsub_slot_name*) b)->slot;
+}
+
+/* A cluster only accepts SSUBSCRIBE/SUNSUBSCRIBE for channels of a single slot, so send one
+ * command per slot; each is routed to the shard owning it. */
+static int pubsub_send_names_by_slot(const void*   glide_client,
+                                     const char*   verb,
+                                     zend_string** names,
+                                     uint32_t      count) {
+    pubsub_slot_name* by_slot;
+    zend_string**     run;
+    uint32_t          i, start;
+    int               status = 1;
+
+    if (count < 2) {
+        return pubsub_send_names(glide_client, verb, names, count);
+    }
+
+    by_slot = emalloc(count * sizeof(pubsub_slot_name));
+    run     = emalloc(count * sizeof(zend_string*));
+    for (i = 0; i < count; i++) {
+        by_slot[i].slot = valkey_glide_key_slot(ZSTR_VAL(names[i]), ZSTR_LEN(names[i]));
+        by_slot[i].name = names[i];
+    }
+    qsort(by_slot, count, sizeof(pubsub_slot_name), pubsub_compare_slot);
+
+    for (start = 0; start < count; start = i) {
+        for (i = start; i < count && by_slot[i].slot == by_slot[start].slot; i++) {
+            run[i - start] = by_slot[i].name;
+        }
+        if (!pubsub_send_names(glide_client, verb, run, i - start)) {
+            status = 0;
+        }
+    }
+
+    efree(run);
+    efree(by_slot);
+    return status;
+}
+
+/* Send SSUBSCRIBE again for shard channels the server dropped because their slot moved */
+static void pubsub_reattach_sharded(valkey_glide_object* valkey_glide, HashTable* channels) {
+    uint32_t      count = zend_hash_num_elements(channels);
+    zend_string** names;
+    zend_string*  name;
+    uint32_t      i = 0;
+
+    if (count == 0) {
+        return;
+    }
+
+    VALKEY_LOG_INFO("pubsub", "Re-subscribing shard channels after a slot migration");
+
+    names = emalloc(count * sizeof(zend_string*));
+    ZEND_HASH_FOREACH_STR_KEY(channels, name) {
+        names[i++] = name;
+    }
+    ZEND_HASH_FOREACH_END();
+
+    pubsub_send_names_by_slot(valkey_glide->glide_client, "SSUBSCRIBE", names, i);
+    efree(names);
+}
+
+/* The names of a kind of subscription the client made after connecting */
+static HashTable* pubsub_tracked(valkey_glide_pubsub_state* state, pubsub_subscription_kind kind) {
+    switch (kind) {
+        case PUBSUB_PATTERNS:
+            return &state->patterns;
+        case PUBSUB_SHARDED:
+            return &state->sharded_channels;
+        default:
+            return &state->channels;
+    }
+}
+
+bool valkey_glide_pubsub_reset(valkey_glide_object* valkey_glide) {
+    static const char* verbs[] = {"UNSUBSCRIBE", "PUNSUBSCRIBE", "SUNSUBSCRIBE"};
+    valkey_glide_pubsub_state*   state = valkey_glide->pubsub;
+    valkey_glide_pubsub_message* msg;
+    bool                         clean      = true;
+    bool                         subscribed = false;
+    bool                         is_cluster =
+        instanceof_function(valkey_glide->std.ce, get_valkey_glide_cluster_ce());
+
+    for (int kind = PUBSUB_CHANNELS; kind <= PUBSUB_SHARDED; kind++) {
+        HashTable*    tracked = pubsub_tracked(state, kind);
+        uint32_t      count   = zend_hash_num_elements(tracked);
+        zend_string** names;
+        zend_string*  name;
+        uint32_t      i = 0;
+        int           status;
+
+        if (count == 0) {
+            continue;
+        }
+        subscribed = true;
+
+        names = emalloc(count * sizeof(zend_string*));
+        ZEND_HASH_FOREACH_STR_KEY(tracked, name) {
+            names[i++] = name;
+        }
+        ZEND_HASH_FOREACH_END();
+
+        if (kind == PUBSUB_SHARDED && is_cluster) {
+            status = pubsub_send_names_by_slot(valkey_glide->glide_client, verbs[kind], names, i);
+        } else {
+            status = pubsub_send_names(valkey_glide->glide_client, verbs[kind], names, i);
+        }
+        efree(names);
+        zend_hash_clean(tracked);
+        clean = clean && status;
+    }
+
+    /* Whatever is still buffered may come from those subscriptions, not for the next borrower */
+    if (subscribed && state->slots) {
+        while ((msg = pubsub_ring_pop(state)) != NULL) {
+            free(msg);
+        }
+    }
+    return clean;
+}
+
+static int execute_subscription_command(zval*                    object,
+                                        int                      argc,
+                                        zval*                    return_value,
+                                        zend_class_entry*        ce,
+                                        const char*              verb,
+                                        bool                     subscribing,
+                                        pubsub_subscription_kind kind) {
+    valkey_glide_object*       valkey_glide;
+    valkey_glide_pubsub_state* state;
+    HashTable*                 tracked;
+    bool                       sharded = kind == PUBSUB_SHARDED;
+    HashTable*                 names = NULL;
+    zend_string**              strs  = NULL;
+    uint32_t                   count = 0;
+    zval*                      name;
+    int                        status;
+
+    /* Subscribing needs at least one name, unsubscribing from nothing means "from all" */
+    if (subscribing) {
+        if (zend_parse_method_parameters(argc, object, "Oh", &object, ce, &names) == FAILURE) {
+            return 0;
+        }
+        if (zend_hash_num_elements(names) == 0) {
+            return 0;
+        }
+    } else if (zend_parse_method_parameters(argc, object, "O|h", &object, ce, &names) ==
+               FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (!valkey_glide || !valkey_glide->glide_client || !valkey_glide->pubsub) {
+        return 0;
+    }
+    state   = valkey_glide->pubsub;
+    tracked = pubsub_tracked(state, kind);
+
+    if (subscribing) {
+        /* Messages can arrive as soon as the server processes the request */
+        if (!pubsub_state_alloc_slots(state)) {
+            return 0;
+        }
+    }
+
+    if (names && zend_hash_num_elements(names) > 0) {
+        strs = emalloc(zend_hash_num_elements(names) * sizeof(zend_string*));
+        ZEND_HASH_FOREACH_VAL(names, name) {
+            strs[count++] = zval_get_string(name);
+        }
+        ZEND_HASH_FOREACH_END();
+    } else if (sharded && zend_hash_num_elements(&state->sharded_channels) > 0) {
+        /* Unsubscribing from every shard channel still has to go to each owning shard */
+        zend_string* channel;
+
+        strs = emalloc(zend_hash_num_elements(&state->sharded_channels) * sizeof(zend_string*));
+        ZEND_HASH_FOREACH_STR_KEY(&state->sharded_channels, channel) {
+            strs[count++] = zend_string_init(ZSTR_VAL(channel), ZSTR_LEN(channel), 0);
+        }
+        ZEND_HASH_FOREACH_END();
+    }
+
+    /* Track the names first: an unsubscribe notification for a shard channel that is no longer
+     * tracked is the server confirming it, not a slot migration. */
+    if (!subscribing && count == 0) {
+        zend_hash_clean(tracked);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (subscribing) {
+            zend_hash_str_add_empty_element(tracked, ZSTR_VAL(strs[i]), ZSTR_LEN(strs[i]));
+        } else {
+            zend_hash_str_del(tracked, ZSTR_VAL(strs[i]), ZSTR_LEN(strs[i]));
+        }
+    }
+
+    if (sharded && ce == get_valkey_glide_cluster_ce()) {
+        status = pubsub_send_names_by_slot(valkey_glide->glide_client, verb, strs, count);
+    } else {
+        status = pubsub_send_names(valkey_glide->glide_client, verb, strs, count);
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        zend_string_release(strs[i]);
+    }
+    if (strs) {
+        efree(strs);
+    }
+
+    if (!status) {
+        return 0;
+    }
+
+    ZVAL_TRUE(return_value);
+    return 1;
+}
+
+int execute_subscribe_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    return execute_subscription_command(
+        object, argc, return_value, ce, "SUBSCRIBE", true, PUBSUB_CHANNELS);
+}
+
+int execute_psubscribe_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    return execute_subscription_command(
+        object, argc, return_value, ce, "PSUBSCRIBE", true, PUBSUB_PATTERNS);
+}
+
+int execute_ssubscribe_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    return execute_subscription_command(
+        object, argc, return_value, ce, "SSUBSCRIBE", true, PUBSUB_SHARDED);
+}
+
+int execute_unsubscribe_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    return execute_subscription_command(
+        object, argc, return_value, ce, "UNSUBSCRIBE", false, PUBSUB_CHANNELS);
+}
+
+int execute_punsubscribe_command(zval*             object,
+                                 int               argc,
+                                 zval*             return_value,
+                                 zend_class_entry* ce) {
+    return execute_subscription_command(
+        object, argc, return_value, ce, "PUNSUBSCRIBE", false, PUBSUB_PATTERNS);
+}
+
+int execute_sunsubscribe_command(zval*             object,
+                                 int               argc,
+                                 zval*             return_value,
+                                 zend_class_entry* ce) {
+    return execute_subscription_command(
+        object, argc, return_value, ce, "SUNSUBSCRIBE", false, PUBSUB_SHARDED);
+}
+
+/* PUBLISH and SPUBLISH: send a message, return the number of receivers */
+static int execute_publish_type(zval*             object,
+                                int               argc,
+                                zval*             return_value,
+                                zend_class_entry* ce,
+                                enum RequestType  type) {
+    valkey_glide_object* valkey_glide;
+    char *               channel = NULL, *message = NULL;
+    size_t               channel_len = 0, message_len = 0;
+    long                 receivers   = 0;
+
+    if (zend_parse_method_parameters(
+            argc, object, "Oss", &object, ce, &channel, &channel_len, &message, &message_len) ==
+        FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (!valkey_glide || !valkey_glide->glide_client) {
+        return 0;
+    }
+
+    valkey_glide_args args;
+
+    valkey_glide_args_init(&args);
+    valkey_glide_args_add(&args, channel, channel_len);
+    valkey_glide_args_add(&args, message, message_len);
+
+    CommandResult* result =
+        valkey_glide_args_execute(valkey_glide->glide_client, type, &args, NULL);
+    valkey_glide_args_free(&args);
+    if (!handle_int_response(result, &receivers)) {
+        return 0;
+    }
+
+    ZVAL_LONG(return_value, receivers);
+    return 1;
+}
+
+/* Execute a PUBLISH command using the Valkey Glide client */
+int execute_publish_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    return execute_publish_type(object, argc, return_value, ce, Publish);
+}
+
+/* Execute an SPUBLISH command, routed to the shard owning the channel's slot */
+int execute_spublish_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    return execute_publish_type(object, argc, return_value, ce, SPublish);
+}
+
+/* Turn NUMSUB/SHARDNUMSUB replies into [channel => count], whether they came back as a map or
+ * as flat channel/count pairs. */
+static void pubsub_pairs_to_assoc(zval* pairs, zval* return_value) {
+    zval*    value;
+    zval*    key = NULL;
+    uint32_t i   = 0;
+
+    array_init(return_value);
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(pairs), value) {
+        if (i++ % 2 == 0) {
+            key = value;
+            continue;
+        }
+        if (Z_TYPE_P(key) == IS_STRING) {
+            Z_TRY_ADDREF_P(value);
+            zend_symtable_update(Z_ARRVAL_P(return_value), Z_STR_P(key), value);
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+}
+
+/* Execute a PUBSUB introspection command using the Valkey Glide client */
+int execute_pubsub_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    valkey_glide_object* valkey_glide;
+    zend_string*         keyword;
+    zval*                arg = NULL;
+    enum RequestType     type;
+    bool                 counts = false;
+
+    if (zend_parse_method_parameters(argc, object, "OS|z!", &object, ce, &keyword, &arg) ==
+        FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (!valkey_glide || !valkey_glide->glide_client) {
+        return 0;
+    }
+
+    if (zend_string_equals_literal_ci(keyword, "channels")) {
+        type = PubSubChannels;
+    } else if (zend_string_equals_literal_ci(keyword, "shardchannels")) {
+        type = PubSubShardChannels;
+    } else if (zend_string_equals_literal_ci(keyword, "numpat")) {
+        type = PubSubNumPat;
+        arg  = NULL;
+    } else if (zend_string_equals_literal_ci(keyword, "numsub")) {
+        type   = PubSubNumSub;
+        counts = true;
+    } else if (zend_string_equals_literal_ci(keyword, "shardnumsub")) {
+        type   = PubSubShardNumSub;
+        counts = true;
+    } else {
+        php_error_docref(NULL, E_WARNING, "Unknown PUBSUB subcommand '%s'", ZSTR_VAL(keyword));
+        return 0;
+    }
+
+    /* CHANNELS takes an optional pattern, NUMSUB a list of channels */
+    if (counts && arg && Z_TYPE_P(arg) != IS_ARRAY) {
+        php_error_docref(
+            NULL, E_WARNING, "PUBSUB %s expects an array of channels", ZSTR_VAL(keyword));
+        return 0;
+    }
+    valkey_glide_args args;
+    int               status;
+    zval*             name;
+
+    valkey_glide_args_init(&args);
+    if (arg && Z_TYPE_P(arg) == IS_ARRAY) {
+        ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(arg), name) {
+            valkey_glide_args_add_zval(&args, name);
+        }
+        ZEND_HASH_FOREACH_END();
+    } else if (arg) {
+        valkey_glide_args_add_zval(&args, arg);
+    }
+
+    CommandResult* result =
+        valkey_glide_args_execute(valkey_glide->glide_client, type, &args, NULL);
+    valkey_glide_args_free(&args);
+
+    if (type == PubSubNumPat) {
+        long numpat = 0;
+
+        status = handle_int_response(result, &numpat);
+        if (status) {
+            ZVAL_LONG(return_value, numpat);
+        }
+    } else if (counts) {
+        zval reply;
+
+        status = 0;
+        if (result && !result->command_error && result->response) {
+            if (command_response_to_zval(
+                    result->response, &reply, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false) >= 0 &&
+                Z_TYPE(reply) == IS_ARRAY) {
+                pubsub_pairs_to_assoc(&reply, return_value);
+                status = 1;
+            }
+            zval_ptr_dtor(&reply);
+        }
+        if (result) {
+            free_command_result(result);
+        }
+    } else {
+        status = handle_array_response(result, return_value) > 0;
+    }
+
+    return status;
+}
+
+/* Drain up to max buffered messages, waiting up to timeout seconds if none are buffered yet */
+int execute_get_messages_command(zval*             object,
+                                 int               argc,
+                                 zval*             return_value,
+                                 zend_class_entry* ce) {
+    valkey_glide_object* valkey_glide;
+    zend_long            max     = 100;
+    double               timeout = 0;
+
+    if (zend_parse_method_parameters(argc, object, "O|ld", &object, ce, &max, &timeout) ==
+        FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (!valkey_glide || !valkey_glide->glide_client) {
+        return 0;
+    }
+
+    if (max <= 0) {
+        zend_argument_value_error(1, "must be greater than 0");
+        return 0;
+    }
+
+    array_init(return_value);
+
+    /* Never subscribed: nothing will ever arrive */
+    if (!valkey_glide->pubsub || !valkey_glide->pubsub->slots) {
+        return 1;
+    }
+
+    pubsub_drain(valkey_glide, max, return_value);
+    if (zend_hash_num_elements(Z_ARRVAL_P(return_value)) == 0 && timeout > 0) {
+        pubsub_ring_wait(valkey_glide->pubsub, timeout);
+        pubsub_drain(valkey_glide, max, return_value);
+    }
+
+    return 1;
+}
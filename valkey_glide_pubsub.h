@@ -0,0 +1,173 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Pub/Sub Commands                                        |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef VALKEY_GLIDE_PUBSUB_H
+#define VALKEY_GLIDE_PUBSUB_H
+
+#include "common.h"
+#include "include/glide_bindings.h"
+#include "php.h"
+#include "valkey_glide_commands_common.h"
+
+/*
+ * Push messages are delivered by Glide on one of its own threads. Each client gets a bounded
+ * single-producer/single-consumer ring buffer: the FFI callback is the producer and the PHP
+ * thread draining it with getMessages() the only consumer, which never takes a lock. The
+ * callback finds the buffer of a client without a lock shared by the clients, and takes one of
+ * the client only to serialize its own pushes. Messages arriving while the buffer is full are
+ * dropped and counted.
+ *
+ * In cluster mode Glide delivers the pushes of every node through the same callback, so
+ * messages from all shards merge into the one buffer. Shard channels subscribed dynamically are
+ * tracked so they can be subscribed again when a slot migration makes the server drop them.
+ */
+
+/* Default number of messages buffered per client, rounded up to a power of two */
+#define VALKEY_GLIDE_PUBSUB_DEFAULT_BUFFER_SIZE 4096
+
+/* Pub/Sub state of one Glide client, shared with the FFI callback */
+typedef struct valkey_glide_pubsub_state valkey_glide_pubsub_state;
+
+/* Module lifecycle, called from MINIT/MSHUTDOWN */
+void valkey_glide_pubsub_init(void);
+void valkey_glide_pubsub_shutdown(void);
+
+/* The callback handed to create_client() */
+void valkey_glide_pubsub_callback(uintptr_t      client_ptr,
+                                  enum PushKind  kind,
+                                  const uint8_t* message,
+                                  int64_t        message_len,
+                                  const uint8_t* channel,
+                                  int64_t        channel_len,
+                                  const uint8_t* pattern,
+                                  int64_t        pattern_len);
+
+/* Bracket create_client() so messages for connect-time subscriptions, which can arrive before
+ * create_client() returns, already have a buffer to land in. end_connect() returns the state
+ * registered for glide_client (the existing one for a pooled client), or NULL if glide_client
+ * is NULL. buffer_size is the ring capacity, 0 for the default. */
+void                       valkey_glide_pubsub_begin_connect(zend_long buffer_size,
+                                                             bool      has_subscriptions);
+valkey_glide_pubsub_state* valkey_glide_pubsub_end_connect(const void* glide_client,
+                                                           zend_long   buffer_size);
+
+/* Forget a client before it is closed. Once this returns the callback no longer touches its
+ * state. */
+void valkey_glide_pubsub_unregister(const void* glide_client);
+
+/* Undo the subscriptions a pooled client made with subscribe(), psubscribe() and ssubscribe(),
+ * keeping its connect-time ones, and drop the messages buffered for it, before it is lent to
+ * another object. Returns false if an unsubscribe failed. */
+bool valkey_glide_pubsub_reset(valkey_glide_object* valkey_glide);
+
+/* Client-side cache invalidations. CLIENT TRACKING invalidations arrive through the same
+ * callback; once tracking is requested for a client, the last
+ * VALKEY_GLIDE_INVALIDATION_LOG_SIZE of them are kept for the caches to replay. */
+#define VALKEY_GLIDE_INVALIDATION_LOG_SIZE 1024
+
+/* Called for every invalidation since the caller's position. key is NULL when everything must
+ * be dropped; reconnect is set when tracking has to be enabled again on a new connection. */
+typedef void (*valkey_glide_invalidation_fn)(void*       ctx,
+                                             const char* key,
+                                             size_t      key_len,
+                                             bool        reconnect);
+
+bool     valkey_glide_pubsub_track_invalidations(valkey_glide_pubsub_state* state);
+uint64_t valkey_glide_pubsub_invalidation_seq(valkey_glide_pubsub_state* state);
+/* Replays the invalidations recorded since from and returns the new position. fn runs with the
+ * producer lock of the client held and must not call back into this module. */
+uint64_t valkey_glide_pubsub_replay_invalidations(valkey_glide_pubsub_state*   state,
+                                                  uint64_t                     from,
+                                                  valkey_glide_invalidation_fn fn,
+                                                  void*                        ctx);
+
+/* Add the connect-time subscriptions from advanced_config['pubsub_subscriptions'] to a
+ * connection request. The returned allocation must stay alive until the request is packed and
+ * is released with valkey_glide_pubsub_free_subscriptions(). */
+ConnectionRequest__PubSubSubscriptions* valkey_glide_pubsub_build_subscriptions(
+    HashTable* subscriptions);
+void valkey_glide_pubsub_free_subscriptions(ConnectionRequest__PubSubSubscriptions* subscriptions);
+
+/* ====================================================================
+ * PUB/SUB COMMAND FUNCTIONS
+ * ==================================================================== */
+
+int execute_subscribe_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+int execute_psubscribe_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+int execute_ssubscribe_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+int execute_unsubscribe_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+int execute_punsubscribe_command(zval*             object,
+                                 int               argc,
+                                 zval*             return_value,
+                                 zend_class_entry* ce);
+int execute_sunsubscribe_command(zval*             object,
+                                 int               argc,
+                                 zval*             return_value,
+                                 zend_class_entry* ce);
+int execute_publish_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+int execute_spublish_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+int execute_pubsub_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+int execute_get_messages_command(zval*             object,
+                                 int               argc,
+                                 zval*             return_value,
+                                 zend_class_entry* ce);
+
+/* ====================================================================
+ * PUB/SUB COMMAND MACROS
+ * ==================================================================== */
+
+#define PUBSUB_METHOD_IMPL_EX(class_name, method_name, execute_fn)                 \
+    PHP_METHOD(class_name, method_name) {                                          \
+        if (execute_fn(getThis(),                                                  \
+                       ZEND_NUM_ARGS(),                                            \
+                       return_value,                                               \
+                       strcmp(#class_name, "ValkeyGlideCluster") == 0              \
+                           ? get_valkey_glide_cluster_ce()                         \
+                           : get_valkey_glide_ce())) {                             \
+            return;                                                                \
+        }                                                                          \
+        zval_dtor(return_value);                                                   \
+        RETURN_FALSE;                                                              \
+    }
+
+#define SUBSCRIBE_METHOD_IMPL(class_name) \
+    PUBSUB_METHOD_IMPL_EX(class_name, subscribe, execute_subscribe_command)
+
+#define PSUBSCRIBE_METHOD_IMPL(class_name) \
+    PUBSUB_METHOD_IMPL_EX(class_name, psubscribe, execute_psubscribe_command)
+
+#define SSUBSCRIBE_METHOD_IMPL(class_name) \
+    PUBSUB_METHOD_IMPL_EX(class_name, ssubscribe, execute_ssubscribe_command)
+
+#define UNSUBSCRIBE_METHOD_IMPL(class_name) \
+    PUBSUB_METHOD_IMPL_EX(class_name, unsubscribe, execute_unsubscribe_command)
+
+#define PUNSUBSCRIBE_METHOD_IMPL(class_name) \
+    PUBSUB_METHOD_IMPL_EX(class_name, punsubscribe, execute_punsubscribe_command)
+
+#define SUNSUBSCRIBE_METHOD_IMPL(class_name) \
+    PUBSUB_METHOD_IMPL_EX(class_name, sunsubscribe, execute_sunsubscribe_command)
+
+#define PUBLISH_METHOD_IMPL(class_name) \
+    PUBSUB_METHOD_IMPL_EX(class_name, publish, execute_publish_command)
+
+#define SPUBLISH_METHOD_IMPL(class_name) \
+    PUBSUB_METHOD_IMPL_EX(class_name, spublish, execute_spublish_command)
+
+#define PUBSUB_METHOD_IMPL(class_name) \
+    PUBSUB_METHOD_IMPL_EX(class_name, pubsub, execute_pubsub_command)
+
+#define GETMESSAGES_METHOD_IMPL(class_name) \
+    PUBSUB_METHOD_IMPL_EX(class_name, getMessages, execute_get_messages_command)
+
+#endif /* VALKEY_GLIDE_PUBSUB_H */
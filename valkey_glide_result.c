@@ -0,0 +1,322 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Lazy Results                                            |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#include "valkey_glide_result.h"
+
+#include <zend_exceptions.h>
+#include <zend_interfaces.h>
+
+#include "command_response.h"
+#include "valkey_glide_options.h"
+#include "valkey_glide_result_arginfo.h"
+
+/* Class entry and handlers */
+zend_class_entry*           valkey_glide_result_ce;
+static zend_object_handlers valkey_glide_result_object_handlers;
+
+#define RESULT_ZVAL_GET_OBJECT(zv) VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_result_object, zv)
+
+bool valkey_glide_result_take(CommandResult* result, bool decode, zval* output) {
+    const valkey_glide_options_t* options  = valkey_glide_current_options();
+    CommandResponse*              response = result->response;
+    valkey_glide_result_object*   lazy;
+    zend_long                     count;
+
+    if (!options || !options->lazy_results || !response) {
+        return false;
+    }
+    if (response->response_type == Array) {
+        count = response->array_value_len;
+    } else if (response->response_type == Sets) {
+        count = response->sets_value_len;
+    } else {
+        return false;
+    }
+    if (count < options->lazy_results) {
+        return false;
+    }
+
+    object_init_ex(output, valkey_glide_result_ce);
+    lazy           = RESULT_ZVAL_GET_OBJECT(output);
+    lazy->response = response;
+    lazy->elements =
+        response->response_type == Array ? response->array_value : response->sets_value;
+    lazy->count = count;
+    if (decode && valkey_glide_options_encode_values(options)) {
+        /* The client may change its options, or be gone, before the elements are read */
+        lazy->decode         = true;
+        lazy->options        = *options;
+        lazy->options.prefix = NULL;
+    }
+
+    /* free_command_result() only frees what is still attached to the result */
+    result->response = NULL;
+    return true;
+}
+
+/* Convert element index, as the reply would have been converted as a whole */
+static void result_element(valkey_glide_result_object* lazy, zend_long index, zval* output) {
+    CommandResponse* element = &lazy->elements[index];
+
+    if (lazy->decode && element->response_type == String) {
+        valkey_glide_unserialize(
+            &lazy->options, element->string_value, element->string_value_len, output);
+        return;
+    }
+    command_response_to_zval(element, output, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false);
+}
+
+/* The index an offset names, as a PHP array would read it. False for offsets that are not
+ * an int or a string, with a TypeError thrown; an index out of range is returned as is. */
+static bool result_offset(zval* offset, zend_long* index) {
+    zend_ulong numeric;
+
+    ZVAL_DEREF(offset);
+    switch (Z_TYPE_P(offset)) {
+        case IS_LONG:
+            *index = Z_LVAL_P(offset);
+            return true;
+        case IS_STRING:
+            if (ZEND_HANDLE_NUMERIC_STR(Z_STRVAL_P(offset), Z_STRLEN_P(offset), numeric)) {
+                *index = (zend_long) numeric;
+            } else {
+                *index = -1;
+            }
+            return true;
+        default:
+            zend_type_error("Cannot access offset of type %s on ValkeyGlideResult",
+                            zend_zval_type_name(offset));
+            return false;
+    }
+}
+
+/* ====================================================================
+ * ITERATOR
+ * ==================================================================== */
+
+typedef struct {
+    zend_object_iterator it;
+    zend_long            index;
+    zval                 current; /* Converted on the first read, UNDEF until then */
+} valkey_glide_result_iterator;
+
+static void result_iterator_dtor(zend_object_iterator* iter) {
+    valkey_glide_result_iterator* it = (valkey_glide_result_iterator*) iter;
+
+    zval_ptr_dtor(&it->current);
+    zval_ptr_dtor(&it->it.data);
+}
+
+static int result_iterator_valid(zend_object_iterator* iter) {
+    valkey_glide_result_iterator* it = (valkey_glide_result_iterator*) iter;
+
+    return it->index < RESULT_ZVAL_GET_OBJECT(&iter->data)->count ? SUCCESS : FAILURE;
+}
+
+static zval* result_iterator_current(zend_object_iterator* iter) {
+    valkey_glide_result_iterator* it = (valkey_glide_result_iterator*) iter;
+
+    if (Z_ISUNDEF(it->current)) {
+        result_element(RESULT_ZVAL_GET_OBJECT(&iter->data), it->index, &it->current);
+    }
+    return &it->current;
+}
+
+static void result_iterator_key(zend_object_iterator* iter, zval* key) {
+    ZVAL_LONG(key, ((valkey_glide_result_iterator*) iter)->index);
+}
+
+static void result_iterator_invalidate(zend_object_iterator* iter) {
+    valkey_glide_result_iterator* it = (valkey_glide_result_iterator*) iter;
+
+    zval_ptr_dtor(&it->current);
+    ZVAL_UNDEF(&it->current);
+}
+
+static void result_iterator_forward(zend_object_iterator* iter) {
+    result_iterator_invalidate(iter);
+    ((valkey_glide_result_iterator*) iter)->index++;
+}
+
+static void result_iterator_rewind(zend_object_iterator* iter) {
+    result_iterator_invalidate(iter);
+    ((valkey_glide_result_iterator*) iter)->index = 0;
+}
+
+static const zend_object_iterator_funcs result_iterator_funcs = {
+    .dtor               = result_iterator_dtor,
+    .valid              = result_iterator_valid,
+    .get_current_data   = result_iterator_current,
+    .get_current_key    = result_iterator_key,
+    .move_forward       = result_iterator_forward,
+    .rewind             = result_iterator_rewind,
+    .invalidate_current = result_iterator_invalidate,
+    .get_gc             = NULL,
+};
+
+static zend_object_iterator* result_get_iterator(zend_class_entry* ce, zval* object, int by_ref) {
+    valkey_glide_result_iterator* it;
+
+    if (by_ref) {
+        zend_throw_error(NULL, "An iterator cannot be used with foreach by reference");
+        return NULL;
+    }
+
+    it = emalloc(sizeof(valkey_glide_result_iterator));
+    zend_iterator_init(&it->it);
+    ZVAL_OBJ_COPY(&it->it.data, Z_OBJ_P(object));
+    it->it.funcs = &result_iterator_funcs;
+    it->index    = 0;
+    ZVAL_UNDEF(&it->current);
+
+    return &it->it;
+}
+
+/* ====================================================================
+ * ValkeyGlideResult CLASS
+ * ==================================================================== */
+
+static zend_object* create_valkey_glide_result_object(zend_class_entry* ce) {
+    valkey_glide_result_object* lazy =
+        ecalloc(1, sizeof(valkey_glide_result_object) + zend_object_properties_size(ce));
+
+    zend_object_std_init(&lazy->std, ce);
+    object_properties_init(&lazy->std, ce);
+    lazy->std.handlers = &valkey_glide_result_object_handlers;
+
+    return &lazy->std;
+}
+
+static void free_valkey_glide_result_object(zend_object* object) {
+    valkey_glide_result_object* lazy =
+        VALKEY_GLIDE_PHP_GET_OBJECT(valkey_glide_result_object, object);
+
+    if (lazy->response) {
+        free_command_response(lazy->response);
+    }
+    zend_object_std_dtor(&lazy->std);
+}
+
+PHP_METHOD(ValkeyGlideResult, __construct) {
+    ZEND_PARSE_PARAMETERS_NONE();
+}
+
+PHP_METHOD(ValkeyGlideResult, offsetExists) {
+    valkey_glide_result_object* lazy;
+    zval*                       offset;
+    zend_long                   index;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+    Z_PARAM_ZVAL(offset)
+    ZEND_PARSE_PARAMETERS_END();
+
+    lazy = RESULT_ZVAL_GET_OBJECT(ZEND_THIS);
+    if (!result_offset(offset, &index)) {
+        RETURN_THROWS();
+    }
+    /* isset() is false for null elements, as for an array */
+    RETURN_BOOL(index >= 0 && index < lazy->count && lazy->elements[index].response_type != Null);
+}
+
+PHP_METHOD(ValkeyGlideResult, offsetGet) {
+    valkey_glide_result_object* lazy;
+    zval*                       offset;
+    zend_long                   index;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+    Z_PARAM_ZVAL(offset)
+    ZEND_PARSE_PARAMETERS_END();
+
+    lazy = RESULT_ZVAL_GET_OBJECT(ZEND_THIS);
+    if (!result_offset(offset, &index)) {
+        RETURN_THROWS();
+    }
+    if (index < 0 || index >= lazy->count) {
+        ZVAL_DEREF(offset);
+        if (Z_TYPE_P(offset) == IS_LONG) {
+            zend_error(E_WARNING, "Undefined array key " ZEND_LONG_FMT, Z_LVAL_P(offset));
+        } else {
+            zend_error(E_WARNING, "Undefined array key \"%s\"", Z_STRVAL_P(offset));
+        }
+        RETURN_NULL();
+    }
+    result_element(lazy, index, return_value);
+}
+
+PHP_METHOD(ValkeyGlideResult, offsetSet) {
+    zval *offset, *value;
+
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+    Z_PARAM_ZVAL(offset)
+    Z_PARAM_ZVAL(value)
+    ZEND_PARSE_PARAMETERS_END();
+
+    zend_throw_error(NULL, "Cannot modify a ValkeyGlideResult, copy it with toArray()");
+    RETURN_THROWS();
+}
+
+PHP_METHOD(ValkeyGlideResult, offsetUnset) {
+    zval* offset;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+    Z_PARAM_ZVAL(offset)
+    ZEND_PARSE_PARAMETERS_END();
+
+    zend_throw_error(NULL, "Cannot modify a ValkeyGlideResult, copy it with toArray()");
+    RETURN_THROWS();
+}
+
+PHP_METHOD(ValkeyGlideResult, count) {
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(RESULT_ZVAL_GET_OBJECT(ZEND_THIS)->count);
+}
+
+PHP_METHOD(ValkeyGlideResult, getIterator) {
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    zend_create_internal_iterator_zval(return_value, ZEND_THIS);
+}
+
+PHP_METHOD(ValkeyGlideResult, toArray) {
+    valkey_glide_result_object* lazy;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    lazy = RESULT_ZVAL_GET_OBJECT(ZEND_THIS);
+    if (!lazy->response) {
+        RETURN_EMPTY_ARRAY();
+    }
+    if (!command_response_to_zval(
+            lazy->response, return_value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false) &&
+        EG(exception)) {
+        RETURN_THROWS();
+    }
+    if (lazy->decode) {
+        valkey_glide_unserialize_array(&lazy->options, return_value);
+    }
+}
+
+void register_valkey_glide_result_class(void) {
+    valkey_glide_result_ce =
+        register_class_ValkeyGlideResult(zend_ce_arrayaccess, zend_ce_countable, zend_ce_aggregate);
+    valkey_glide_result_ce->create_object = create_valkey_glide_result_object;
+    /* foreach converts one element at a time rather than going through getIterator() */
+    valkey_glide_result_ce->get_iterator = result_get_iterator;
+    memcpy(&valkey_glide_result_object_handlers,
+           zend_get_std_object_handlers(),
+           sizeof(valkey_glide_result_object_handlers));
+    valkey_glide_result_object_handlers.offset    = XtOffsetOf(valkey_glide_result_object, std);
+    valkey_glide_result_object_handlers.free_obj  = free_valkey_glide_result_object;
+    valkey_glide_result_object_handlers.clone_obj = NULL;
+}
@@ -0,0 +1,55 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Lazy Results                                            |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef VALKEY_GLIDE_RESULT_H
+#define VALKEY_GLIDE_RESULT_H
+
+#include "common.h"
+#include "php.h"
+#include "valkey_glide_commands_common.h"
+
+/*
+ * ValkeyGlideResult: an Array or Sets reply left in the CommandResponse it was received in.
+ *
+ * With OPT_LAZY_RESULTS set, list replies (LRANGE, SMEMBERS, MGET, ...) of at least that many
+ * elements are not converted to a PHP array. The object takes the reply out of its
+ * CommandResult and converts an element when it is read, by index or by foreach, so a loop
+ * over a million element reply holds one element at a time. The reply is given back to the
+ * FFI with free_command_response() when the object is freed.
+ *
+ * Elements are not kept: reading one twice converts it twice. toArray() converts them all.
+ */
+
+/* ValkeyGlideResult object structure */
+typedef struct {
+    CommandResponse*       response; /* The Array or Sets reply, owned */
+    CommandResponse*       elements;
+    zend_long              count;
+    bool                   decode;  /* String elements go through the serializer */
+    valkey_glide_options_t options; /* Serializer and compression when decode, without prefix */
+    zend_object            std;
+} valkey_glide_result_object;
+
+/* Class entry */
+extern zend_class_entry* valkey_glide_result_ce;
+
+/* Class registration function */
+void register_valkey_glide_result_class(void);
+
+/* Put the reply of result in output as a ValkeyGlideResult when OPT_LAZY_RESULTS is set and it
+ * is an Array or Sets reply with at least that many elements. The reply is taken out of
+ * result, which the caller frees as usual. decode unserializes the string elements as they are
+ * read, for replies of stored values. Returns false, leaving both untouched, otherwise. */
+bool valkey_glide_result_take(CommandResult* result, bool decode, zval* output);
+
+#endif /* VALKEY_GLIDE_RESULT_H */
@@ -0,0 +1,90 @@
+<?php
+
+/**
+ * @generate-function-entries
+ * @generate-class-entries
+ */
+
+/**
+ * A list reply that is converted one element at a time.
+ *
+ * With ValkeyGlide::OPT_LAZY_RESULTS set to a number of elements, list replies (lRange,
+ * sMembers, mGet, ...) at least that long are returned as a ValkeyGlideResult rather than an
+ * array. The reply stays in the memory it was received in, and an element becomes a PHP value
+ * only when it is read, so a foreach over a very large reply holds one element at a time. The
+ * reply is freed with the object.
+ *
+ * Elements are not kept: reading one twice converts it twice. toArray() converts them all.
+ *
+ * @example
+ * $valkey_glide->setOption(ValkeyGlide::OPT_LAZY_RESULTS, 10000);
+ * foreach ($valkey_glide->lRange('events', 0, -1) as $i => $event) {
+ *     process($event);
+ * }
+ *
+ * @not-serializable
+ */
+final class ValkeyGlideResult implements ArrayAccess, Countable, IteratorAggregate
+{
+    /**
+     * Results are only created by the client.
+     */
+    private function __construct()
+    {
+    }
+
+    /**
+     * Whether an element exists and is not null.
+     *
+     * @param int|string $offset The index of the element.
+     */
+    public function offsetExists(mixed $offset): bool
+    {
+    }
+
+    /**
+     * Convert an element.
+     *
+     * @param int|string $offset The index of the element.
+     *
+     * @return mixed The element, or null with a warning when there is none at that index.
+     */
+    public function offsetGet(mixed $offset): mixed
+    {
+    }
+
+    /**
+     * Results are read-only: always throws an Error.
+     */
+    public function offsetSet(mixed $offset, mixed $value): void
+    {
+    }
+
+    /**
+     * Results are read-only: always throws an Error.
+     */
+    public function offsetUnset(mixed $offset): void
+    {
+    }
+
+    /**
+     * The number of elements of the reply, without converting them.
+     */
+    public function count(): int
+    {
+    }
+
+    /**
+     * An iterator over the elements, converting each one as it is reached.
+     */
+    public function getIterator(): Iterator
+    {
+    }
+
+    /**
+     * Convert the whole reply to the array it would have been returned as.
+     */
+    public function toArray(): array
+    {
+    }
+}
@@ -0,0 +1,397 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Cluster Routes                                          |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#include "valkey_glide_route.h"
+
+#include <zend_exceptions.h>
+
+#include "include/glide/command_request.pb-c.h"
+#include "valkey_glide_format.h"
+#include "valkey_glide_options.h"
+#include "valkey_glide_route_arginfo.h"
+
+/* Class entry and handlers */
+zend_class_entry*           valkey_glide_route_ce;
+static zend_object_handlers valkey_glide_route_object_handlers;
+
+/* A route parameter, pointing into the zval it was parsed from */
+typedef struct {
+    enum {
+        ROUTE_TYPE_KEY,       /* Route by key */
+        ROUTE_TYPE_HOST_PORT, /* Route by host:port */
+        ROUTE_TYPE_SIMPLE     /* Simple route: "randomNode", "allPrimaries", "allNodes" */
+    } type;
+
+    union {
+        struct {
+            const char* key;
+            size_t      key_len;
+            char        number[VALKEY_GLIDE_FORMAT_LONG_SIZE]; /* Integer keys, formatted */
+        } key_route;
+
+        struct {
+            zend_string* host;
+            zend_long    port;
+        } host_port_route;
+
+        size_t simple_route; /* Index in simple_routes */
+    } data;
+} cluster_route_t;
+
+/* The simple routes, packed in MINIT */
+typedef struct {
+    const char*                  name;
+    size_t                       name_len;
+    CommandRequest__SimpleRoutes route;
+    uint8_t                      bytes[8];
+    size_t                       bytes_len;
+} simple_route_t;
+
+static simple_route_t simple_routes[] = {
+    {"randomNode", sizeof("randomNode") - 1, COMMAND_REQUEST__SIMPLE_ROUTES__Random},
+    {"allPrimaries", sizeof("allPrimaries") - 1, COMMAND_REQUEST__SIMPLE_ROUTES__AllPrimaries},
+    {"allNodes", sizeof("allNodes") - 1, COMMAND_REQUEST__SIMPLE_ROUTES__AllNodes},
+};
+
+/* By-address routes of a client, evicting the least recently used */
+typedef struct {
+    zend_string* host;
+    zend_long    port;
+    uint8_t*     bytes;
+    size_t       bytes_len;
+    uint64_t     used;
+} route_cache_entry_t;
+
+struct valkey_glide_route_cache {
+    route_cache_entry_t entries[VALKEY_GLIDE_ROUTE_CACHE_SIZE];
+    size_t              count;
+    uint64_t            clock;
+};
+
+/* ====================================================================
+ * PARSING AND PACKING
+ * ==================================================================== */
+
+static zend_long route_port(zval* port_zv) {
+    return Z_TYPE_P(port_zv) == IS_LONG ? Z_LVAL_P(port_zv) : zval_get_long(port_zv);
+}
+
+static int route_host_port(zval* host_zv, zval* port_zv, cluster_route_t* route) {
+    if (!host_zv || !port_zv || Z_TYPE_P(host_zv) != IS_STRING) {
+        return 0;
+    }
+    route->type                      = ROUTE_TYPE_HOST_PORT;
+    route->data.host_port_route.host = Z_STR_P(host_zv);
+    route->data.host_port_route.port = route_port(port_zv);
+    return 1;
+}
+
+/* Parse a cluster route parameter from a zval */
+static int parse_cluster_route(zval* route_zval, cluster_route_t* route) {
+    if (Z_TYPE_P(route_zval) == IS_STRING) {
+        const char* route_str = Z_STRVAL_P(route_zval);
+        size_t      route_len = Z_STRLEN_P(route_zval);
+
+        /* Check for special routing keywords */
+        for (size_t i = 0; i < sizeof(simple_routes) / sizeof(simple_routes[0]); i++) {
+            if (route_len == simple_routes[i].name_len &&
+                strncasecmp(route_str, simple_routes[i].name, route_len) == 0) {
+                route->type              = ROUTE_TYPE_SIMPLE;
+                route->data.simple_route = i;
+                return 1;
+            }
+        }
+
+        /* String parameter - use as key */
+        route->type                   = ROUTE_TYPE_KEY;
+        route->data.key_route.key     = route_str;
+        route->data.key_route.key_len = route_len;
+        return 1;
+    } else if (Z_TYPE_P(route_zval) == IS_ARRAY) {
+        HashTable* route_ht = Z_ARRVAL_P(route_zval);
+        zval *     type_zv = NULL, *key_zv = NULL, *host_zv = NULL, *port_zv = NULL;
+
+        /* Check if we have a type-based routing config */
+        type_zv = zend_hash_str_find(route_ht, "type", sizeof("type") - 1);
+        if (type_zv && Z_TYPE_P(type_zv) == IS_STRING) {
+            /* Type-based routing */
+            const char* type_str = Z_STRVAL_P(type_zv);
+
+            if (strcasecmp(type_str, "primarySlotKey") == 0 ||
+                strcasecmp(type_str, "slotKey") == 0) {
+                /* Slot key routing */
+                key_zv = zend_hash_str_find(route_ht, "key", sizeof("key") - 1);
+                if (!key_zv) {
+                    return 0;
+                }
+                route->type = ROUTE_TYPE_KEY;
+                if (Z_TYPE_P(key_zv) == IS_STRING) {
+                    route->data.key_route.key     = Z_STRVAL_P(key_zv);
+                    route->data.key_route.key_len = Z_STRLEN_P(key_zv);
+                    return 1;
+                }
+                if (Z_TYPE_P(key_zv) == IS_LONG) {
+                    route->data.key_route.key_len =
+                        valkey_glide_format_long(Z_LVAL_P(key_zv), route->data.key_route.number);
+                    route->data.key_route.key = route->data.key_route.number;
+                    return 1;
+                }
+            } else if (strcasecmp(type_str, "routeByAddress") == 0) {
+                /* Route by address */
+                host_zv = zend_hash_str_find(route_ht, "host", sizeof("host") - 1);
+                port_zv = zend_hash_str_find(route_ht, "port", sizeof("port") - 1);
+                return route_host_port(host_zv, port_zv, route);
+            }
+
+            return 0; /* Invalid type-based routing */
+        }
+
+        /* Try direct host/port keys */
+        host_zv = zend_hash_str_find(route_ht, "host", sizeof("host") - 1);
+        port_zv = zend_hash_str_find(route_ht, "port", sizeof("port") - 1);
+
+        if (!host_zv || !port_zv) {
+            /* Try numeric keys (indexed array approach) */
+            host_zv = zend_hash_index_find(route_ht, 0);
+            port_zv = zend_hash_index_find(route_ht, 1);
+        }
+
+        return route_host_port(host_zv, port_zv, route);
+    }
+
+    /* Could not parse route properly */
+    return 0;
+}
+
+/* Describe a route as the Routes protobuf, with the sub-messages it points to in storage */
+static void route_message(const cluster_route_t*          route,
+                          CommandRequest__Routes*         routes,
+                          CommandRequest__SlotKeyRoute*   slot_key_route,
+                          CommandRequest__ByAddressRoute* by_address_route) {
+    switch (route->type) {
+        case ROUTE_TYPE_KEY:
+            slot_key_route->slot_type = COMMAND_REQUEST__SLOT_TYPES__Primary;
+            slot_key_route->slot_key  = (char*) route->data.key_route.key;
+            routes->value_case        = COMMAND_REQUEST__ROUTES__VALUE_SLOT_KEY_ROUTE;
+            routes->slot_key_route    = slot_key_route;
+            break;
+
+        case ROUTE_TYPE_HOST_PORT:
+            by_address_route->host   = ZSTR_VAL(route->data.host_port_route.host);
+            by_address_route->port   = (int32_t) route->data.host_port_route.port;
+            routes->value_case       = COMMAND_REQUEST__ROUTES__VALUE_BY_ADDRESS_ROUTE;
+            routes->by_address_route = by_address_route;
+            break;
+
+        case ROUTE_TYPE_SIMPLE:
+            routes->value_case    = COMMAND_REQUEST__ROUTES__VALUE_SIMPLE_ROUTES;
+            routes->simple_routes = simple_routes[route->data.simple_route].route;
+            break;
+    }
+}
+
+/* Pack a route into an emalloc'd buffer, NULL for an empty key */
+static uint8_t* route_pack(const cluster_route_t* route, size_t* bytes_len) {
+    CommandRequest__Routes         routes           = COMMAND_REQUEST__ROUTES__INIT;
+    CommandRequest__SlotKeyRoute   slot_key_route   = COMMAND_REQUEST__SLOT_KEY_ROUTE__INIT;
+    CommandRequest__ByAddressRoute by_address_route = COMMAND_REQUEST__BY_ADDRESS_ROUTE__INIT;
+    uint8_t*                       bytes;
+
+    if (route->type == ROUTE_TYPE_KEY && route->data.key_route.key_len == 0) {
+        return NULL;
+    }
+
+    route_message(route, &routes, &slot_key_route, &by_address_route);
+    *bytes_len = command_request__routes__get_packed_size(&routes);
+    bytes      = emalloc(*bytes_len);
+    command_request__routes__pack(&routes, bytes);
+    return bytes;
+}
+
+/* ====================================================================
+ * BY-ADDRESS ROUTE CACHE
+ * ==================================================================== */
+
+static const uint8_t* route_cache_bytes(const cluster_route_t* route,
+                                        size_t*                bytes_len,
+                                        uint8_t**              owned) {
+    valkey_glide_object*             valkey_glide = valkey_glide_current_object();
+    struct valkey_glide_route_cache* cache;
+    route_cache_entry_t*             entry;
+    zend_string*                     host = route->data.host_port_route.host;
+    zend_long                        port = route->data.host_port_route.port;
+
+    if (!valkey_glide) {
+        *owned = route_pack(route, bytes_len);
+        return *owned;
+    }
+
+    cache = valkey_glide->route_cache;
+    if (!cache) {
+        cache = valkey_glide->route_cache = ecalloc(1, sizeof(*cache));
+    }
+
+    for (size_t i = 0; i < cache->count; i++) {
+        entry = &cache->entries[i];
+        if (entry->port == port && zend_string_equals(entry->host, host)) {
+            entry->used = ++cache->clock;
+            *bytes_len  = entry->bytes_len;
+            return entry->bytes;
+        }
+    }
+
+    if (cache->count < VALKEY_GLIDE_ROUTE_CACHE_SIZE) {
+        entry = &cache->entries[cache->count++];
+    } else {
+        entry = &cache->entries[0];
+        for (size_t i = 1; i < cache->count; i++) {
+            if (cache->entries[i].used < entry->used) {
+                entry = &cache->entries[i];
+            }
+        }
+        zend_string_release(entry->host);
+        efree(entry->bytes);
+    }
+
+    entry->host  = zend_string_copy(host);
+    entry->port  = port;
+    entry->bytes = route_pack(route, &entry->bytes_len);
+    entry->used  = ++cache->clock;
+    *bytes_len   = entry->bytes_len;
+    return entry->bytes;
+}
+
+void valkey_glide_route_cache_free(struct valkey_glide_route_cache* cache) {
+    if (!cache) {
+        return;
+    }
+    for (size_t i = 0; i < cache->count; i++) {
+        zend_string_release(cache->entries[i].host);
+        efree(cache->entries[i].bytes);
+    }
+    efree(cache);
+}
+
+const uint8_t* valkey_glide_route_bytes(zval* route, size_t* bytes_len, uint8_t** owned) {
+    cluster_route_t parsed;
+
+    *owned = NULL;
+    if (Z_TYPE_P(route) == IS_OBJECT && Z_OBJCE_P(route) == valkey_glide_route_ce) {
+        valkey_glide_route_object* object =
+            VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_route_object, route);
+
+        *bytes_len = object->bytes_len;
+        return object->bytes;
+    }
+
+    if (!parse_cluster_route(route, &parsed)) {
+        return NULL;
+    }
+
+    switch (parsed.type) {
+        case ROUTE_TYPE_SIMPLE:
+            *bytes_len = simple_routes[parsed.data.simple_route].bytes_len;
+            return simple_routes[parsed.data.simple_route].bytes;
+        case ROUTE_TYPE_HOST_PORT:
+            return route_cache_bytes(&parsed, bytes_len, owned);
+        default:
+            *owned = route_pack(&parsed, bytes_len);
+            return *owned;
+    }
+}
+
+/* ====================================================================
+ * ValkeyGlideRoute CLASS
+ * ==================================================================== */
+
+static zend_object* create_valkey_glide_route_object(zend_class_entry* ce) {
+    valkey_glide_route_object* object =
+        ecalloc(1, sizeof(valkey_glide_route_object) + zend_object_properties_size(ce));
+
+    zend_object_std_init(&object->std, ce);
+    object_properties_init(&object->std, ce);
+    object->std.handlers = &valkey_glide_route_object_handlers;
+
+    return &object->std;
+}
+
+static void free_valkey_glide_route_object(zend_object* object) {
+    valkey_glide_route_object* route =
+        VALKEY_GLIDE_PHP_GET_OBJECT(valkey_glide_route_object, object);
+
+    if (route->bytes) {
+        efree(route->bytes);
+    }
+    zend_object_std_dtor(&route->std);
+}
+
+PHP_METHOD(ValkeyGlideRoute, __construct) {
+    valkey_glide_route_object* object;
+    zval*                      route;
+    cluster_route_t            parsed;
+    uint8_t*                   bytes = NULL;
+    size_t                     bytes_len;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+    Z_PARAM_ZVAL(route)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (Z_TYPE_P(route) != IS_STRING && Z_TYPE_P(route) != IS_ARRAY) {
+        zend_argument_type_error(
+            1, "must be of type array|string, %s given", zend_zval_type_name(route));
+        RETURN_THROWS();
+    }
+
+    if (parse_cluster_route(route, &parsed)) {
+        if (parsed.type == ROUTE_TYPE_SIMPLE) {
+            bytes_len = simple_routes[parsed.data.simple_route].bytes_len;
+            bytes     = emalloc(bytes_len);
+            memcpy(bytes, simple_routes[parsed.data.simple_route].bytes, bytes_len);
+        } else {
+            bytes = route_pack(&parsed, &bytes_len);
+        }
+    }
+    if (!bytes) {
+        zend_throw_exception(get_valkey_glide_exception_ce(), "Invalid route", 0);
+        RETURN_THROWS();
+    }
+
+    object = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_route_object, ZEND_THIS);
+    if (object->bytes) {
+        efree(object->bytes);
+    }
+    object->bytes     = bytes;
+    object->bytes_len = bytes_len;
+}
+
+void register_valkey_glide_route_class(void) {
+    valkey_glide_route_ce                = register_class_ValkeyGlideRoute();
+    valkey_glide_route_ce->create_object = create_valkey_glide_route_object;
+    memcpy(&valkey_glide_route_object_handlers,
+           zend_get_std_object_handlers(),
+           sizeof(valkey_glide_route_object_handlers));
+    valkey_glide_route_object_handlers.offset    = XtOffsetOf(valkey_glide_route_object, std);
+    valkey_glide_route_object_handlers.free_obj  = free_valkey_glide_route_object;
+    valkey_glide_route_object_handlers.clone_obj = NULL;
+
+    /* A simple route packs to a couple of bytes, the same for every command */
+    for (size_t i = 0; i < sizeof(simple_routes) / sizeof(simple_routes[0]); i++) {
+        CommandRequest__Routes routes = COMMAND_REQUEST__ROUTES__INIT;
+        cluster_route_t        route  = {.type = ROUTE_TYPE_SIMPLE, .data.simple_route = i};
+
+        route_message(&route, &routes, NULL, NULL);
+        ZEND_ASSERT(command_request__routes__get_packed_size(&routes) <=
+                    sizeof(simple_routes[i].bytes));
+        simple_routes[i].bytes_len = command_request__routes__pack(&routes, simple_routes[i].bytes);
+    }
+}
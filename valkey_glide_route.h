@@ -0,0 +1,59 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Cluster Routes                                          |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef VALKEY_GLIDE_ROUTE_H
+#define VALKEY_GLIDE_ROUTE_H
+
+#include "common.h"
+#include "php.h"
+
+/*
+ * Routes of cluster commands, packed as the CommandRequest.Routes protobuf the FFI takes.
+ *
+ * A route parameter is a string ("randomNode", "allPrimaries", "allNodes" or a key), an array
+ * (['type' => 'primarySlotKey', 'key' => ...], ['type' => 'routeByAddress', 'host' => ...,
+ * 'port' => ...] or [host, port]) or a ValkeyGlideRoute. Packing one used to take an emalloc and
+ * a protobuf encode per command, so:
+ *
+ *  - the three simple routes are packed once in MINIT and shared,
+ *  - by-address routes are kept in a small per-client LRU, keyed by host and port,
+ *  - a ValkeyGlideRoute is parsed and packed once, when it is constructed.
+ *
+ * Only key routes are still packed per command, the key being part of the bytes.
+ */
+
+/* By-address routes remembered per client */
+#define VALKEY_GLIDE_ROUTE_CACHE_SIZE 16
+
+/* ValkeyGlideRoute object structure */
+typedef struct {
+    uint8_t*    bytes; /* Packed route, owned */
+    size_t      bytes_len;
+    zend_object std;
+} valkey_glide_route_object;
+
+/* Class entry */
+extern zend_class_entry* valkey_glide_route_ce;
+
+/* Class registration function, also packs the simple routes */
+void register_valkey_glide_route_class(void);
+
+/* Packed bytes of a route parameter, NULL when it is not a valid route. When the bytes had to
+ * be packed for this call *owned is set to them and the caller efree()s it after the command;
+ * otherwise *owned is NULL and the bytes stay valid until the next route of the client. */
+const uint8_t* valkey_glide_route_bytes(zval* route, size_t* bytes_len, uint8_t** owned);
+
+/* Free the by-address routes of a client, from its free_obj handler */
+void valkey_glide_route_cache_free(struct valkey_glide_route_cache* cache);
+
+#endif /* VALKEY_GLIDE_ROUTE_H */
@@ -0,0 +1,39 @@
+<?php
+
+/**
+ * @generate-function-entries
+ * @generate-class-entries
+ */
+
+/**
+ * A cluster route parsed and packed once.
+ *
+ * Any method of ValkeyGlideCluster taking a $route accepts a ValkeyGlideRoute in place of the
+ * string or array it was built from. The route is validated when it is constructed and is not
+ * parsed again by the commands it is passed to, which is worth it for a route by address or by
+ * key used in a loop.
+ *
+ * @example
+ * $node = new ValkeyGlideRoute(['10.0.0.5', 6379]);
+ * foreach ($sections as $section) {
+ *     $info[$section] = $cluster->info($node, $section);
+ * }
+ *
+ * @not-serializable
+ */
+final class ValkeyGlideRoute
+{
+    /**
+     * Parse and pack a route.
+     *
+     * @param string|array $route "randomNode", "allPrimaries", "allNodes", a key for slot-based
+     *                            routing, ['type' => 'primarySlotKey', 'key' => 'keyName'],
+     *                            ['type' => 'routeByAddress', 'host' => 'hostname', 'port' => port]
+     *                            or [host, port].
+     *
+     * @throws ValkeyGlideException When the route is not valid.
+     */
+    public function __construct(string|array $route)
+    {
+    }
+}
@@ -18,409 +18,196 @@
 #include "cluster_scan_cursor.h"
 #include "command_response.h"
 #include "common.h"
+#include "valkey_glide_arena.h"
+#include "valkey_glide_args.h"
+#include "valkey_glide_result.h"
 
 /* Import the string conversion functions from command_response.c */
 extern char* long_to_string(long value, size_t* len);
 extern char* double_to_string(double value, size_t* len);
 
 /* ====================================================================
- * UTILITY FUNCTIONS
+ * ARGUMENT PREPARATION FUNCTIONS
  * ==================================================================== */
 
-/**
- * Allocate command arguments arrays
- */
-int allocate_s_command_args(int count, uintptr_t** args_out, unsigned long** args_len_out) {
-    *args_out     = (uintptr_t*) emalloc(count * sizeof(uintptr_t));
-    *args_len_out = (unsigned long*) emalloc(count * sizeof(unsigned long));
-
-    if (!*args_out || !*args_len_out) {
-        if (*args_out)
-            efree(*args_out);
-        if (*args_len_out)
-            efree(*args_len_out);
-        return 0;
-    }
-
-    return 1;
-}
-
-/**
- * Free command arguments arrays
- */
-void cleanup_s_command_args(uintptr_t* args, unsigned long* args_len) {
-    if (args)
-        efree(args);
-    if (args_len)
-        efree(args_len);
-}
-
-/**
- * Convert array of zvals to string arguments
- */
-int convert_zval_to_string_args(
-    zval* input, int count, uintptr_t** args_out, unsigned long** args_len_out, int offset) {
-    int  i;
-    zval temp;
-
-    for (i = 0; i < count; i++) {
-        zval* element = &input[i];
-
-        if (Z_TYPE_P(element) == IS_STRING) {
-            (*args_out)[offset + i]     = (uintptr_t) Z_STRVAL_P(element);
-            (*args_len_out)[offset + i] = Z_STRLEN_P(element);
-        } else if (Z_TYPE_P(element) == IS_OBJECT) {
-            /* Handle object conversion specially */
-            zval tmp_zval;
-            ZVAL_COPY(&tmp_zval, element);
-            zend_std_cast_object_tostring(&tmp_zval, &tmp_zval, IS_STRING);
-
-            /* Create a permanent copy of the string before freeing the zval */
-            size_t str_len  = Z_STRLEN(tmp_zval);
-            char*  str_copy = emalloc(str_len + 1);
-            memcpy(str_copy, Z_STRVAL(tmp_zval), str_len);
-            str_copy[str_len] = '\0';
-
-            (*args_out)[offset + i]     = (uintptr_t) str_copy;
-            (*args_len_out)[offset + i] = str_len;
-            zval_dtor(&tmp_zval);
-        } else {
-            /* Convert other types to string */
-            ZVAL_COPY(&temp, element);
-            convert_to_string(&temp);
-
-            /* Create a permanent copy of the string before freeing the zval */
-            size_t str_len  = Z_STRLEN(temp);
-            char*  str_copy = emalloc(str_len + 1);
-            memcpy(str_copy, Z_STRVAL(temp), str_len);
-            str_copy[str_len] = '\0';
-
-            (*args_out)[offset + i]     = (uintptr_t) str_copy;
-            (*args_len_out)[offset + i] = str_len;
-            zval_dtor(&temp);
+/* Add the keys of a multi-key command */
+static int add_s_keys(s_command_args_t* args, valkey_glide_args* cmd_args) {
+    for (int i = 0; i < args->keys_count; i++) {
+        if (!valkey_glide_args_add_key_zval(cmd_args, &args->keys[i])) {
+            return 0;
         }
     }
-
     return 1;
 }
 
-/**
- * Allocate a string representation of a long value
- */
-char* alloc_long_string(long value, size_t* len_out) {
-    char   temp[32];
-    size_t len    = snprintf(temp, sizeof(temp), "%ld", value);
-    char*  result = emalloc(len + 1);
-    if (result) {
-        memcpy(result, temp, len);
-        result[len] = '\0';
-        if (len_out)
-            *len_out = len;
-    }
-    return result;
-}
-
-/* ====================================================================
- * ARGUMENT PREPARATION FUNCTIONS
- * ==================================================================== */
-
 /**
  * Prepare arguments for key + members commands (SADD, SREM, SMISMEMBER)
  */
-int prepare_s_key_members_args(s_command_args_t* args,
-                               uintptr_t**       args_out,
-                               unsigned long**   args_len_out) {
+int prepare_s_key_members_args(s_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->glide_client || !args->key || args->key_len == 0 || !args->members ||
         args->members_count <= 0) {
         return 0;
     }
 
-    unsigned long arg_count = 1 + args->members_count; /* key + members */
-
-    if (!allocate_s_command_args(arg_count, args_out, args_len_out)) {
-        return 0;
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
+    for (int i = 0; i < args->members_count; i++) {
+        if (!valkey_glide_args_add_value(cmd_args, &args->members[i])) {
+            return 0;
+        }
     }
 
-    /* Set key as first argument */
-    (*args_out)[0]     = (uintptr_t) args->key;
-    (*args_len_out)[0] = args->key_len;
-
-    /* Convert and set member arguments */
-    convert_zval_to_string_args(args->members, args->members_count, args_out, args_len_out, 1);
-
-    return arg_count;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for key-only commands (SCARD, SMEMBERS)
  */
-int prepare_s_key_only_args(s_command_args_t* args,
-                            uintptr_t**       args_out,
-                            unsigned long**   args_len_out) {
+int prepare_s_key_only_args(s_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->glide_client || !args->key || args->key_len == 0) {
         return 0;
     }
 
-    if (!allocate_s_command_args(1, args_out, args_len_out)) {
-        return 0;
-    }
-
-    (*args_out)[0]     = (uintptr_t) args->key;
-    (*args_len_out)[0] = args->key_len;
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
 
-    return 1;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for key + member commands (SISMEMBER)
  */
-int prepare_s_key_member_args(s_command_args_t* args,
-                              uintptr_t**       args_out,
-                              unsigned long**   args_len_out) {
+int prepare_s_key_member_args(s_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->glide_client || !args->key || args->key_len == 0 || !args->member ||
         args->member_len == 0) {
         return 0;
     }
 
-    if (!allocate_s_command_args(2, args_out, args_len_out)) {
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
+    if (!valkey_glide_args_add_value_string(cmd_args, args->member, args->member_len)) {
         return 0;
     }
 
-    (*args_out)[0]     = (uintptr_t) args->key;
-    (*args_len_out)[0] = args->key_len;
-    (*args_out)[1]     = (uintptr_t) args->member;
-    (*args_len_out)[1] = args->member_len;
-
-    return 2;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for key + count commands (SPOP, SRANDMEMBER)
  */
-int prepare_s_key_count_args(s_command_args_t* args,
-                             uintptr_t**       args_out,
-                             unsigned long**   args_len_out) {
+int prepare_s_key_count_args(s_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->glide_client || !args->key || args->key_len == 0) {
         return 0;
     }
 
-    unsigned long arg_count = args->has_count ? 2 : 1;
-
-    if (!allocate_s_command_args(arg_count, args_out, args_len_out)) {
-        return 0;
-    }
-
-    (*args_out)[0]     = (uintptr_t) args->key;
-    (*args_len_out)[0] = args->key_len;
-
+    valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
     if (args->has_count) {
-        char* count_str = alloc_long_string(args->count, NULL);
-        if (!count_str) {
-            cleanup_s_command_args(*args_out, *args_len_out);
-            return 0;
-        }
-        (*args_out)[1]     = (uintptr_t) count_str;
-        (*args_len_out)[1] = strlen(count_str);
+        valkey_glide_args_add_long(cmd_args, args->count);
     }
 
-    return arg_count;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for multi-key commands (SINTER, SUNION, SDIFF)
  */
-int prepare_s_multi_key_args(s_command_args_t* args,
-                             uintptr_t**       args_out,
-                             unsigned long**   args_len_out) {
+int prepare_s_multi_key_args(s_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->glide_client || !args->keys || args->keys_count <= 0) {
         return 0;
     }
 
-    if (!allocate_s_command_args(args->keys_count, args_out, args_len_out)) {
+    if (!add_s_keys(args, cmd_args)) {
         return 0;
     }
 
-    convert_zval_to_string_args(args->keys, args->keys_count, args_out, args_len_out, 0);
-
-    return args->keys_count;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for multi-key + limit commands (SINTERCARD)
  */
-int prepare_s_multi_key_limit_args(s_command_args_t* args,
-                                   uintptr_t**       args_out,
-                                   unsigned long**   args_len_out) {
+int prepare_s_multi_key_limit_args(s_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->glide_client || !args->keys || args->keys_count <= 0) {
         return 0;
     }
 
-    unsigned long arg_count =
-        1 + args->keys_count + (args->has_limit ? 2 : 0); /* numkeys + keys + [LIMIT value] */
-
-    if (!allocate_s_command_args(arg_count, args_out, args_len_out)) {
-        return 0;
-    }
-
-    /* First argument is the number of keys */
-    char* numkeys_str = alloc_long_string(args->keys_count, NULL);
-    if (!numkeys_str) {
-        cleanup_s_command_args(*args_out, *args_len_out);
+    /* numkeys + keys + [LIMIT value] */
+    valkey_glide_args_add_long(cmd_args, args->keys_count);
+    if (!add_s_keys(args, cmd_args)) {
         return 0;
     }
-    (*args_out)[0]     = (uintptr_t) numkeys_str;
-    (*args_len_out)[0] = strlen(numkeys_str);
-
-    /* Add keys */
-    convert_zval_to_string_args(args->keys, args->keys_count, args_out, args_len_out, 1);
-
-    /* Add LIMIT if specified */
     if (args->has_limit) {
-        (*args_out)[1 + args->keys_count]     = (uintptr_t) "LIMIT";
-        (*args_len_out)[1 + args->keys_count] = 5;
-
-        char* limit_str = alloc_long_string(args->limit, NULL);
-        if (!limit_str) {
-            efree((void*) (*args_out)[0]); /* Free numkeys_str */
-            cleanup_s_command_args(*args_out, *args_len_out);
-            return 0;
-        }
-        (*args_out)[2 + args->keys_count]     = (uintptr_t) limit_str;
-        (*args_len_out)[2 + args->keys_count] = strlen(limit_str);
+        valkey_glide_args_add_literal(cmd_args, "LIMIT");
+        valkey_glide_args_add_long(cmd_args, args->limit);
     }
 
-    return arg_count;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for destination + multi-key commands (SINTERSTORE, SUNIONSTORE, SDIFFSTORE)
  */
-int prepare_s_dst_multi_key_args(s_command_args_t* args,
-                                 uintptr_t**       args_out,
-                                 unsigned long**   args_len_out) {
+int prepare_s_dst_multi_key_args(s_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->glide_client || !args->dst_key || args->dst_key_len == 0 || !args->keys ||
         args->keys_count <= 0) {
         return 0;
     }
 
-    unsigned long arg_count = 1 + args->keys_count; /* destination + keys */
-
-    if (!allocate_s_command_args(arg_count, args_out, args_len_out)) {
+    valkey_glide_args_add_key(cmd_args, args->dst_key, args->dst_key_len);
+    if (!add_s_keys(args, cmd_args)) {
         return 0;
     }
 
-    /* Set destination key */
-    (*args_out)[0]     = (uintptr_t) args->dst_key;
-    (*args_len_out)[0] = args->dst_key_len;
-
-    /* Add source keys */
-    convert_zval_to_string_args(args->keys, args->keys_count, args_out, args_len_out, 1);
-
-    return arg_count;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for two-key + member commands (SMOVE)
  */
-int prepare_s_two_key_member_args(s_command_args_t* args,
-                                  uintptr_t**       args_out,
-                                  unsigned long**   args_len_out) {
+int prepare_s_two_key_member_args(s_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->glide_client || !args->src_key || args->src_key_len == 0 || !args->dst_key ||
         args->dst_key_len == 0 || !args->member || args->member_len == 0) {
         return 0;
     }
 
-    if (!allocate_s_command_args(3, args_out, args_len_out)) {
+    valkey_glide_args_add_key(cmd_args, args->src_key, args->src_key_len);
+    valkey_glide_args_add_key(cmd_args, args->dst_key, args->dst_key_len);
+    if (!valkey_glide_args_add_value_string(cmd_args, args->member, args->member_len)) {
         return 0;
     }
 
-    (*args_out)[0]     = (uintptr_t) args->src_key;
-    (*args_len_out)[0] = args->src_key_len;
-    (*args_out)[1]     = (uintptr_t) args->dst_key;
-    (*args_len_out)[1] = args->dst_key_len;
-    (*args_out)[2]     = (uintptr_t) args->member;
-    (*args_len_out)[2] = args->member_len;
-
-    return 3;
+    return cmd_args->count;
 }
 
 /**
  * Prepare arguments for scan commands (SCAN, SSCAN)
  */
-int prepare_s_scan_args(s_command_args_t* args,
-                        uintptr_t**       args_out,
-                        unsigned long**   args_len_out) {
+int prepare_s_scan_args(s_command_args_t* args, valkey_glide_args* cmd_args) {
     if (!args->glide_client || !args->cursor) {
         return 0;
     }
 
-    int has_pattern = (args->pattern && args->pattern_len > 0);
-    int has_count   = args->has_count;
-    int has_key     = (args->key && args->key_len > 0);                     /* For SSCAN */
-    int has_type    = args->has_type && (args->type && args->type_len > 0); /* For SCAN only */
-
-    unsigned long arg_count =
-        (has_key ? 1 : 0) + 1 + (has_pattern ? 2 : 0) + (has_count ? 2 : 0) + (has_type ? 2 : 0);
-
-    if (!allocate_s_command_args(arg_count, args_out, args_len_out)) {
-        return 0;
+    /* Key for SSCAN, HSCAN and ZSCAN */
+    if (args->key && args->key_len > 0) {
+        valkey_glide_args_add_key(cmd_args, args->key, args->key_len);
     }
 
-    int arg_idx = 0;
+    valkey_glide_args_add(cmd_args, *args->cursor, strlen(*args->cursor));
 
-    /* Add key if this is SSCAN */
-    if (has_key) {
-        (*args_out)[arg_idx]     = (uintptr_t) args->key;
-        (*args_len_out)[arg_idx] = args->key_len;
-        arg_idx++;
+    if (args->pattern && args->pattern_len > 0) {
+        valkey_glide_args_add_literal(cmd_args, "MATCH");
+        valkey_glide_args_add(cmd_args, args->pattern, args->pattern_len);
     }
 
-    /* Add cursor */
-
-    size_t cursor_len = strlen(*args->cursor);
-
-    (*args_out)[arg_idx]     = (uintptr_t) *args->cursor;
-    (*args_len_out)[arg_idx] = cursor_len;
-    arg_idx++;
-
-    /* Add MATCH pattern if provided */
-    if (has_pattern) {
-        (*args_out)[arg_idx]     = (uintptr_t) "MATCH";
-        (*args_len_out)[arg_idx] = 5;
-        arg_idx++;
-        (*args_out)[arg_idx]     = (uintptr_t) args->pattern;
-        (*args_len_out)[arg_idx] = args->pattern_len;
-        arg_idx++;
-    }
-
-    /* Add COUNT if provided */
-    if (has_count) {
-        (*args_out)[arg_idx]     = (uintptr_t) "COUNT";
-        (*args_len_out)[arg_idx] = 5;
-        arg_idx++;
-
-        char* count_str = alloc_long_string(args->count, NULL);
-        if (!count_str) {
-            efree((void*) (*args_out)[has_key ? 1 : 0]); /* Free cursor_str */
-            cleanup_s_command_args(*args_out, *args_len_out);
-            return 0;
-        }
-        (*args_out)[arg_idx]     = (uintptr_t) count_str;
-        (*args_len_out)[arg_idx] = strlen(count_str);
-        arg_idx++;
+    if (args->has_count) {
+        valkey_glide_args_add_literal(cmd_args, "COUNT");
+        valkey_glide_args_add_long(cmd_args, args->count);
     }
 
-    /* Add TYPE if provided (SCAN only) */
-    if (has_type) {
-        (*args_out)[arg_idx]     = (uintptr_t) "TYPE";
-        (*args_len_out)[arg_idx] = 4;
-        arg_idx++;
-        (*args_out)[arg_idx]     = (uintptr_t) args->type;
-        (*args_len_out)[arg_idx] = args->type_len;
-        arg_idx++;
+    /* SCAN only */
+    if (args->has_type && args->type && args->type_len > 0) {
+        valkey_glide_args_add_literal(cmd_args, "TYPE");
+        valkey_glide_args_add(cmd_args, args->type, args->type_len);
     }
 
-    return arg_count;
+    return cmd_args->count;
 }
 
 
@@ -486,8 +273,11 @@ int process_s_set_response(CommandResult* result, s_command_args_t* args, zval*
             ZVAL_NULL(return_value);
             return 0;
         } else if (result->response->response_type == Sets) {
-            return command_response_to_zval(
-                result->response, return_value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false);
+            if (valkey_glide_result_take(result, true, return_value)) {
+                return 1;
+            }
+            return command_response_to_values_zval(
+                result->response, return_value, RESPONSE_SHAPE_VALUES, false);
         }
     }
 
@@ -495,17 +285,38 @@ int process_s_set_response(CommandResult* result, s_command_args_t* args, zval*
 }
 
 /**
- * Process mixed response (string or array)
+ * Process mixed response (a member or an array of them, unserialized)
  */
 int process_s_mixed_response(CommandResult* result, s_command_args_t* args, zval* return_value) {
     if (result && result->response && !result->command_error && return_value) {
-        return command_response_to_zval(
-            result->response, return_value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false);
+        return command_response_to_values_zval(
+            result->response, return_value, RESPONSE_SHAPE_VALUES, false);
     }
     return 0;
 }
 
 
+/* Elements of a SCAN reply: ZSCAN [member => score], HSCAN [field => value] and SSCAN
+ * members, with the members and values unserialized, and the keys of SCAN as a list */
+static int process_s_scan_elements(CommandResponse* elements_resp,
+                                   enum RequestType cmd_type,
+                                   zval*            return_value) {
+    switch (cmd_type) {
+        case ZScan:
+            return command_response_to_values_zval(
+                elements_resp, RESPONSE_SHAPE_FLAT_MEMBERS, return_value, false);
+        case HScan:
+            return command_response_to_values_zval(
+                elements_resp, RESPONSE_SHAPE_FLAT_PAIRS, return_value, false);
+        case SScan:
+            return command_response_to_values_zval(
+                elements_resp, RESPONSE_SHAPE_VALUES, return_value, false);
+        default:
+            return command_response_to_zval(
+                elements_resp, return_value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false);
+    }
+}
+
 /**
  * Process scan response (cursor + array) - Updated for string cursors
  * Refactored to use command_response_to_zval utility for better robustness
@@ -529,10 +340,7 @@ int process_s_scan_response(CommandResult*    result,
     if (cursor_resp->response_type == String) {
         new_cursor_str = cursor_resp->string_value;
     } else {
-        /* Handle unexpected cursor type */
-        fprintf(stderr,
-                "[SCAN_DEBUG] process_s_scan_response: Unexpected cursor type %d\n",
-                cursor_resp->response_type);
+        /* A cursor that is not a string: malformed reply */
         return 0;
     }
 
@@ -554,12 +362,7 @@ int process_s_scan_response(CommandResult*    result,
 
         /* If there are elements in this final batch, return them using robust conversion */
         if (elements_resp->array_value_len > 0) {
-            return command_response_to_zval(elements_resp,
-                                            return_value,
-                                            (cmd_type == HScan || cmd_type == ZScan)
-                                                ? COMMAND_RESPONSE_SCAN_ASSOSIATIVE_ARRAY
-                                                : COMMAND_RESPONSE_NOT_ASSOSIATIVE,
-                                            false);
+            return process_s_scan_elements(elements_resp, cmd_type, return_value);
         } else {
             /* No elements in final batch - return FALSE to terminate loop */
             array_init(return_value);
@@ -579,13 +382,7 @@ int process_s_scan_response(CommandResult*    result,
     (*args->cursor)[cursor_len] = '\0';
 
 
-    /* Use command_response_to_zval for robust element processing */
-    return command_response_to_zval(elements_resp,
-                                    return_value,
-                                    (cmd_type == HScan || cmd_type == ZScan)
-                                        ? COMMAND_RESPONSE_SCAN_ASSOSIATIVE_ARRAY
-                                        : COMMAND_RESPONSE_NOT_ASSOSIATIVE,
-                                    false);
+    return process_s_scan_elements(elements_resp, cmd_type, return_value);
 }
 
 /* ====================================================================
@@ -601,56 +398,59 @@ int execute_s_generic_command(const void*          glide_client,
                               s_response_type_t    response_type,
                               s_command_args_t*    args,
                               zval*                return_value) {
-    uintptr_t*     cmd_args  = NULL;
-    unsigned long* args_len  = NULL;
-    int            arg_count = 0;
-    int            status    = 0;
-    CommandResult* result    = NULL;
+    valkey_glide_args  cmd_args;
+    int                arg_count = 0;
+    int                status    = 0;
+    CommandResult*     result    = NULL;
+    valkey_glide_arena arena;
 
     /* Validate basic parameters */
     if (!glide_client || !args) {
         return 0;
     }
 
+    valkey_glide_arena_enter(&arena);
+    valkey_glide_args_init(&cmd_args);
+
     /* Prepare arguments based on category */
     switch (category) {
         case S_CMD_KEY_MEMBERS:
-            arg_count = prepare_s_key_members_args(args, &cmd_args, &args_len);
+            arg_count = prepare_s_key_members_args(args, &cmd_args);
             break;
         case S_CMD_KEY_ONLY:
-            arg_count = prepare_s_key_only_args(args, &cmd_args, &args_len);
+            arg_count = prepare_s_key_only_args(args, &cmd_args);
             break;
         case S_CMD_KEY_MEMBER:
-            arg_count = prepare_s_key_member_args(args, &cmd_args, &args_len);
+            arg_count = prepare_s_key_member_args(args, &cmd_args);
             break;
         case S_CMD_KEY_COUNT:
-            arg_count = prepare_s_key_count_args(args, &cmd_args, &args_len);
+            arg_count = prepare_s_key_count_args(args, &cmd_args);
             break;
         case S_CMD_MULTI_KEY:
-            arg_count = prepare_s_multi_key_args(args, &cmd_args, &args_len);
+            arg_count = prepare_s_multi_key_args(args, &cmd_args);
             break;
         case S_CMD_MULTI_KEY_LIMIT:
-            arg_count = prepare_s_multi_key_limit_args(args, &cmd_args, &args_len);
+            arg_count = prepare_s_multi_key_limit_args(args, &cmd_args);
             break;
         case S_CMD_DST_MULTI_KEY:
-            arg_count = prepare_s_dst_multi_key_args(args, &cmd_args, &args_len);
+            arg_count = prepare_s_dst_multi_key_args(args, &cmd_args);
             break;
         case S_CMD_TWO_KEY_MEMBER:
-            arg_count = prepare_s_two_key_member_args(args, &cmd_args, &args_len);
+            arg_count = prepare_s_two_key_member_args(args, &cmd_args);
             break;
         case S_CMD_SCAN:
-            arg_count = prepare_s_scan_args(args, &cmd_args, &args_len);
+            arg_count = prepare_s_scan_args(args, &cmd_args);
             break;
         default:
-            return 0;
+            break;
     }
 
-    if (arg_count <= 0 || !cmd_args || !args_len) {
+    if (arg_count <= 0) {
         goto cleanup;
     }
 
     /* Execute the command */
-    result = execute_command(glide_client, cmd_type, arg_count, cmd_args, args_len);
+    result = valkey_glide_args_execute(glide_client, cmd_type, &cmd_args, NULL);
 
     /* Process response based on type */
     if (result) {
@@ -680,63 +480,8 @@ int execute_s_generic_command(const void*          glide_client,
     }
 
 cleanup:
-    /* Clean up allocated strings for specific categories */
-    if (cmd_args && args_len) {
-        if (category == S_CMD_KEY_COUNT && args->has_count && arg_count > 1) {
-            efree((void*) cmd_args[1]); /* Free count string */
-        } else if (category == S_CMD_MULTI_KEY_LIMIT) {
-            efree((void*) cmd_args[0]); /* Free numkeys string */
-            if (args->has_limit && arg_count > 2 + args->keys_count) {
-                efree((void*) cmd_args[2 + args->keys_count]); /* Free limit string */
-            }
-        } else if (category == S_CMD_SCAN) {
-            /* No need to free cursor string anymore - it's directly referenced */
-            if (args->has_count) {
-                /* Find and free count string */
-                int has_key   = (args->key && args->key_len > 0);
-                int count_idx = (has_key ? 1 : 0) + 1 + (args->pattern ? 2 : 0) + 1;
-                if (count_idx < arg_count) {
-                    efree((void*) cmd_args[count_idx]);
-                }
-            }
-        }
-
-        /* Clean up allocated strings from convert_zval_to_string_args for member-based commands */
-        if (category == S_CMD_KEY_MEMBERS || category == S_CMD_MULTI_KEY ||
-            category == S_CMD_DST_MULTI_KEY) {
-            int start_idx = 0, count = 0;
-
-            if (category == S_CMD_KEY_MEMBERS) {
-                start_idx = 1; /* Skip key, clean up member strings */
-                count     = args->members_count;
-            } else if (category == S_CMD_MULTI_KEY) {
-                start_idx = 0; /* Clean up all key strings */
-                count     = args->keys_count;
-            } else if (category == S_CMD_DST_MULTI_KEY) {
-                start_idx = 1; /* Skip destination key, clean up source key strings */
-                count     = args->keys_count;
-            }
-
-            /* Free converted strings - check if they were allocated by our conversion function */
-            for (int i = 0; i < count && (start_idx + i) < arg_count; i++) {
-                /* Only free if it's not pointing to original string data */
-                if (args->members && category == S_CMD_KEY_MEMBERS) {
-                    zval* element = &args->members[i];
-                    if (Z_TYPE_P(element) != IS_STRING && cmd_args[start_idx + i] != 0) {
-                        efree((void*) cmd_args[start_idx + i]);
-                    }
-                } else if (args->keys &&
-                           (category == S_CMD_MULTI_KEY || category == S_CMD_DST_MULTI_KEY)) {
-                    zval* element = &args->keys[i];
-                    if (Z_TYPE_P(element) != IS_STRING && cmd_args[start_idx + i] != 0) {
-                        efree((void*) cmd_args[start_idx + i]);
-                    }
-                }
-            }
-        }
-    }
-
-    cleanup_s_command_args(cmd_args, args_len);
+    valkey_glide_args_free(&cmd_args);
+    valkey_glide_arena_leave(&arena);
     return status;
 }
 
@@ -1983,66 +1728,26 @@ int execute_cluster_scan_command(const void* glide_client,
         return 0;
     }
 
-    /* Build arguments array */
-    /* Count arguments: pattern (MATCH + value), count (COUNT + value), type (TYPE + value) */
-    int arg_count = 0;
-    if (pattern && pattern_len > 0)
-        arg_count += 2; /* MATCH + pattern */
-    if (has_count)
-        arg_count += 2; /* COUNT + count_value */
-    if (has_type && type && type_len > 0)
-        arg_count += 2; /* TYPE + type_value */
-
-    uintptr_t*     args      = NULL;
-    unsigned long* args_len  = NULL;
-    char*          count_str = NULL;
-
-    if (arg_count > 0) {
-        args     = emalloc(arg_count * sizeof(uintptr_t));
-        args_len = emalloc(arg_count * sizeof(unsigned long));
-
-        int idx = 0;
-
-        /* Add MATCH pattern */
-        if (pattern && pattern_len > 0) {
-            args[idx]     = (uintptr_t) "MATCH";
-            args_len[idx] = 5;
-            idx++;
-            args[idx]     = (uintptr_t) pattern;
-            args_len[idx] = pattern_len;
-            idx++;
-        }
+    valkey_glide_args args;
 
-        /* Add COUNT */
-        if (has_count) {
-            count_str = alloc_long_string(count, NULL);
-            if (!count_str) {
-                efree(args);
-                efree(args_len);
-                return 0;
-            }
-            args[idx]     = (uintptr_t) "COUNT";
-            args_len[idx] = 5;
-            idx++;
-            args[idx]     = (uintptr_t) count_str;
-            args_len[idx] = strlen(count_str);
-            idx++;
-        }
-
-        /* Add TYPE (for SCAN only) */
-        if (has_type && type && type_len > 0) {
-            args[idx]     = (uintptr_t) "TYPE";
-            args_len[idx] = 4;
-            idx++;
-            args[idx]     = (uintptr_t) type;
-            args_len[idx] = type_len;
-            idx++;
-        }
+    valkey_glide_args_init(&args);
+    if (pattern && pattern_len > 0) {
+        valkey_glide_args_add_literal(&args, "MATCH");
+        valkey_glide_args_add(&args, pattern, pattern_len);
+    }
+    if (has_count) {
+        valkey_glide_args_add_literal(&args, "COUNT");
+        valkey_glide_args_add_long(&args, count);
+    }
+    /* TYPE is for SCAN only */
+    if (has_type && type && type_len > 0) {
+        valkey_glide_args_add_literal(&args, "TYPE");
+        valkey_glide_args_add(&args, type, type_len);
     }
 
     /* Call request_cluster_scan FFI function directly */
     CommandResult* result =
-        request_cluster_scan(glide_client, 0, *cursor, arg_count, args, args_len);
+        request_cluster_scan(glide_client, 0, *cursor, args.count, args.args, args.lens);
 
     int success = 0;
 
@@ -2062,16 +1767,7 @@ int execute_cluster_scan_command(const void* glide_client,
         free_command_result(result);
     }
 
-    /* Cleanup */
-    if (count_str) {
-        efree(count_str);
-    }
-    if (args) {
-        efree(args);
-    }
-    if (args_len) {
-        efree(args_len);
-    }
+    valkey_glide_args_free(&args);
 
     return success;
 }
@@ -23,6 +23,7 @@
 
 #include "command_response.h"
 #include "include/glide_bindings.h"
+#include "valkey_glide_args.h"
 #include "valkey_glide_commands_common.h"
 
 /* ====================================================================
@@ -131,31 +132,15 @@ int execute_s_generic_command(const void*          glide_client,
                               zval*                return_value);
 
 /* Argument preparation functions */
-int prepare_s_key_members_args(s_command_args_t* args,
-                               uintptr_t**       args_out,
-                               unsigned long**   args_len_out);
-int prepare_s_key_only_args(s_command_args_t* args,
-                            uintptr_t**       args_out,
-                            unsigned long**   args_len_out);
-int prepare_s_key_member_args(s_command_args_t* args,
-                              uintptr_t**       args_out,
-                              unsigned long**   args_len_out);
-int prepare_s_key_count_args(s_command_args_t* args,
-                             uintptr_t**       args_out,
-                             unsigned long**   args_len_out);
-int prepare_s_multi_key_args(s_command_args_t* args,
-                             uintptr_t**       args_out,
-                             unsigned long**   args_len_out);
-int prepare_s_multi_key_limit_args(s_command_args_t* args,
-                                   uintptr_t**       args_out,
-                                   unsigned long**   args_len_out);
-int prepare_s_dst_multi_key_args(s_command_args_t* args,
-                                 uintptr_t**       args_out,
-                                 unsigned long**   args_len_out);
-int prepare_s_two_key_member_args(s_command_args_t* args,
-                                  uintptr_t**       args_out,
-                                  unsigned long**   args_len_out);
-int prepare_s_scan_args(s_command_args_t* args, uintptr_t** args_out, unsigned long** args_len_out);
+int prepare_s_key_members_args(s_command_args_t* args, valkey_glide_args* cmd_args);
+int prepare_s_key_only_args(s_command_args_t* args, valkey_glide_args* cmd_args);
+int prepare_s_key_member_args(s_command_args_t* args, valkey_glide_args* cmd_args);
+int prepare_s_key_count_args(s_command_args_t* args, valkey_glide_args* cmd_args);
+int prepare_s_multi_key_args(s_command_args_t* args, valkey_glide_args* cmd_args);
+int prepare_s_multi_key_limit_args(s_command_args_t* args, valkey_glide_args* cmd_args);
+int prepare_s_dst_multi_key_args(s_command_args_t* args, valkey_glide_args* cmd_args);
+int prepare_s_two_key_member_args(s_command_args_t* args, valkey_glide_args* cmd_args);
+int prepare_s_scan_args(s_command_args_t* args, valkey_glide_args* cmd_args);
 
 /* Response processing functions */
 int process_s_int_response(CommandResult* result, s_command_args_t* args, zval* return_value);
@@ -167,14 +152,6 @@ int process_s_scan_response(CommandResult*    result,
                             s_command_args_t* args,
                             zval*             return_value);
 
-/* Utility functions */
-int  allocate_s_command_args(int count, uintptr_t** args_out, unsigned long** args_len_out);
-void cleanup_s_command_args(uintptr_t* args, unsigned long* args_len);
-int  convert_zval_to_string_args(
-     zval* input, int count, uintptr_t** args_out, unsigned long** args_len_out, int offset);
-
-char* alloc_long_string(long value, size_t* len_out);
-
 /* Specific command implementations */
 int execute_sadd_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
 int execute_scard_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
@@ -0,0 +1,641 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Lua Scripting                                           |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#include "valkey_glide_script.h"
+
+#include <zend_exceptions.h>
+
+#include <ext/standard/sha1.h>
+
+#include "command_response.h"
+#include "include/glide_bindings.h"
+#include "logger.h"
+#include "valkey_glide_args.h"
+#include "valkey_glide_options.h"
+#include "valkey_glide_script_arginfo.h"
+
+/* Class entry and handlers */
+zend_class_entry*           valkey_glide_script_ce;
+static zend_object_handlers valkey_glide_script_object_handlers;
+
+/* ====================================================================
+ * PROCESS-WIDE SHA1 CACHE
+ * ==================================================================== */
+
+/*
+ * Two persistent tables indexing the same entries: body -> SHA1 so eval() hashes a body once,
+ * and SHA1 -> body so evalsha() can still recover from NOSCRIPT for any script this process has
+ * seen. Each string is owned by the table it is a key of; the other table borrows it as a value,
+ * so entries are only ever added and removed in pairs.
+ */
+static HashTable script_by_code;
+static HashTable script_by_sha1;
+static bool      script_cache_initialized = false;
+
+#ifdef ZTS
+static MUTEX_T script_cache_mutex;
+#define SCRIPT_CACHE_LOCK() tsrm_mutex_lock(script_cache_mutex)
+#define SCRIPT_CACHE_UNLOCK() tsrm_mutex_unlock(script_cache_mutex)
+#else
+#define SCRIPT_CACHE_LOCK()
+#define SCRIPT_CACHE_UNLOCK()
+#endif
+
+void valkey_glide_script_cache_init(void) {
+    zend_hash_init(&script_by_code, 16, NULL, NULL, 1);
+    zend_hash_init(&script_by_sha1, 16, NULL, NULL, 1);
+#ifdef ZTS
+    script_cache_mutex = tsrm_mutex_alloc();
+#endif
+    script_cache_initialized = true;
+}
+
+void valkey_glide_script_cache_shutdown(void) {
+    if (!script_cache_initialized) {
+        return;
+    }
+
+    zend_hash_destroy(&script_by_code);
+    zend_hash_destroy(&script_by_sha1);
+#ifdef ZTS
+    tsrm_mutex_free(script_cache_mutex);
+#endif
+    script_cache_initialized = false;
+}
+
+/* Normalize a user supplied SHA1 to the lowercase form used as cache key */
+static bool script_normalize_sha1(const char* sha1, size_t sha1_len, char* out) {
+    if (sha1_len != VALKEY_GLIDE_SCRIPT_SHA1_LEN) {
+        return false;
+    }
+    for (size_t i = 0; i < sha1_len; i++) {
+        out[i] = zend_tolower_ascii(sha1[i]);
+    }
+    out[sha1_len] = '\0';
+    return true;
+}
+
+void valkey_glide_script_sha1(const char* code, size_t code_len, char* sha1) {
+    PHP_SHA1_CTX  context;
+    unsigned char digest[20];
+    zend_string*  cached;
+
+    SCRIPT_CACHE_LOCK();
+    cached = script_cache_initialized ? zend_hash_str_find_ptr(&script_by_code, code, code_len)
+                                      : NULL;
+    if (cached) {
+        memcpy(sha1, ZSTR_VAL(cached), VALKEY_GLIDE_SCRIPT_SHA1_LEN + 1);
+        SCRIPT_CACHE_UNLOCK();
+        return;
+    }
+    SCRIPT_CACHE_UNLOCK();
+
+    PHP_SHA1Init(&context);
+    PHP_SHA1Update(&context, (const unsigned char*) code, code_len);
+    PHP_SHA1Final(digest, &context);
+    make_sha1_digest(sha1, digest);
+
+    if (!script_cache_initialized) {
+        return;
+    }
+
+    SCRIPT_CACHE_LOCK();
+    if (!zend_hash_str_exists(&script_by_code, code, code_len) &&
+        !zend_hash_str_exists(&script_by_sha1, sha1, VALKEY_GLIDE_SCRIPT_SHA1_LEN)) {
+        /* Scripts are few and long lived; a process generating them dynamically just starts
+         * over instead of growing without bound. */
+        if (zend_hash_num_elements(&script_by_sha1) >= VALKEY_GLIDE_SCRIPT_CACHE_MAX) {
+            zend_hash_clean(&script_by_code);
+            zend_hash_clean(&script_by_sha1);
+        }
+
+        zend_string* code_str = zend_string_init(code, code_len, 1);
+        zend_string* sha1_str = zend_string_init(sha1, VALKEY_GLIDE_SCRIPT_SHA1_LEN, 1);
+        zend_hash_add_new_ptr(&script_by_code, code_str, sha1_str);
+        zend_hash_add_new_ptr(&script_by_sha1, sha1_str, code_str);
+        zend_string_release(code_str);
+        zend_string_release(sha1_str);
+    }
+    SCRIPT_CACHE_UNLOCK();
+}
+
+/* Copy of the cached body for a SHA1, or NULL if this process never saw it */
+static zend_string* script_cache_find_code(const char* sha1, size_t sha1_len) {
+    char         key[VALKEY_GLIDE_SCRIPT_SHA1_LEN + 1];
+    zend_string* cached;
+    zend_string* code = NULL;
+
+    if (!script_cache_initialized || !script_normalize_sha1(sha1, sha1_len, key)) {
+        return NULL;
+    }
+
+    SCRIPT_CACHE_LOCK();
+    cached = zend_hash_str_find_ptr(&script_by_sha1, key, VALKEY_GLIDE_SCRIPT_SHA1_LEN);
+    if (cached) {
+        code = zend_string_init(ZSTR_VAL(cached), ZSTR_LEN(cached), 0);
+    }
+    SCRIPT_CACHE_UNLOCK();
+
+    return code;
+}
+
+/* ====================================================================
+ * SCRIPT EXECUTION
+ * ==================================================================== */
+
+static bool script_is_noscript(CommandResult* result) {
+    const char* message;
+
+    if (!result || !result->command_error) {
+        return false;
+    }
+    message = result->command_error->command_error_message;
+    return message && (strstr(message, "NOSCRIPT") || strstr(message, "NoScript"));
+}
+
+/* Append the string form of every element of an array to the argument vector */
+static void script_append_array(zval* array, valkey_glide_args* cmd_args) {
+    zval* value;
+
+    if (!array || Z_TYPE_P(array) != IS_ARRAY) {
+        return;
+    }
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(array), value) {
+        valkey_glide_args_add_zval(cmd_args, value);
+    }
+    ZEND_HASH_FOREACH_END();
+}
+
+/* Send "<verb> <script> <numkeys> [keys...] [args...]" */
+static CommandResult* script_send(const void* glide_client,
+                                  const char* verb,
+                                  const char* script,
+                                  size_t      script_len,
+                                  zval*       keys,
+                                  zval*       args,
+                                  zend_long   num_keys) {
+    valkey_glide_args cmd_args;
+
+    if (keys) {
+        num_keys = zend_hash_num_elements(Z_ARRVAL_P(keys));
+    }
+
+    valkey_glide_args_init(&cmd_args);
+    valkey_glide_args_add(&cmd_args, verb, strlen(verb));
+    valkey_glide_args_add(&cmd_args, script, script_len);
+    valkey_glide_args_add_long(&cmd_args, num_keys);
+    script_append_array(keys, &cmd_args);
+    script_append_array(args, &cmd_args);
+
+    CommandResult* result = valkey_glide_args_execute(glide_client, CustomCommand, &cmd_args, NULL);
+    valkey_glide_args_free(&cmd_args);
+    return result;
+}
+
+/* SCRIPT LOAD on every node of a cluster */
+static bool script_load_all_nodes(const void* glide_client, zend_string* code) {
+    uintptr_t     args[3];
+    unsigned long lens[3];
+    zval          route;
+    bool          loaded;
+
+    args[0] = (uintptr_t) "SCRIPT";
+    lens[0] = 6;
+    args[1] = (uintptr_t) "LOAD";
+    lens[1] = 4;
+    args[2] = (uintptr_t) ZSTR_VAL(code);
+    lens[2] = ZSTR_LEN(code);
+
+    ZVAL_STRINGL(&route, "allNodes", 8);
+    CommandResult* result =
+        execute_command_with_route(glide_client, CustomCommand, 3, args, lens, &route);
+    zval_dtor(&route);
+
+    loaded = result && !result->command_error;
+    if (result) {
+        free_command_result(result);
+    }
+    return loaded;
+}
+
+/* Copy of the EVAL arguments with OPT_PREFIX on the first num_keys, which are the keys */
+static void script_prefix_leading_keys(const valkey_glide_options_t* options,
+                                       zval*                         args,
+                                       zend_long                     num_keys,
+                                       zval*                         prefixed) {
+    zval*     arg;
+    zend_long index = 0;
+
+    array_init_size(prefixed, zend_hash_num_elements(Z_ARRVAL_P(args)));
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(args), arg) {
+        if (index++ < num_keys) {
+            zend_string* key = zval_get_string(arg);
+
+            add_next_index_str(prefixed,
+                               zend_string_concat2(ZSTR_VAL(options->prefix),
+                                                   ZSTR_LEN(options->prefix),
+                                                   ZSTR_VAL(key),
+                                                   ZSTR_LEN(key)));
+            zend_string_release(key);
+        } else {
+            Z_TRY_ADDREF_P(arg);
+            add_next_index_zval(prefixed, arg);
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+}
+
+int valkey_glide_script_run(valkey_glide_object* valkey_glide,
+                            bool                 is_cluster,
+                            zend_string*         code,
+                            const char*          sha1,
+                            size_t               sha1_len,
+                            zval*                keys,
+                            zval*                args,
+                            zend_long            num_keys,
+                            bool                 read_only,
+                            zval*                return_value) {
+    const char*    evalsha = read_only ? "EVALSHA_RO" : "EVALSHA";
+    const char*    eval    = read_only ? "EVAL_RO" : "EVAL";
+    CommandResult* result;
+    int            status = 0;
+    zval           prefixed_keys, prefixed_args;
+
+    if (!valkey_glide->glide_client) {
+        return 0;
+    }
+
+    /* The options of the client, also when run from a ValkeyGlideScript */
+    ZVAL_UNDEF(&prefixed_keys);
+    ZVAL_UNDEF(&prefixed_args);
+    if (valkey_glide->options.prefix) {
+        if (keys && valkey_glide_prefix_key_array(
+                        &valkey_glide->options, keys, false, &prefixed_keys)) {
+            keys = &prefixed_keys;
+        } else if (!keys && args && num_keys > 0) {
+            script_prefix_leading_keys(&valkey_glide->options, args, num_keys, &prefixed_args);
+            args = &prefixed_args;
+        }
+    }
+
+    /* In a batch a NOSCRIPT reply comes back from exec(), too late to send the body: the
+     * body is sent right away when it is known */
+    if (valkey_glide->batch_method) {
+        zend_string* body = code ? zend_string_copy(code) : script_cache_find_code(sha1, sha1_len);
+
+        result = body ? script_send(valkey_glide->glide_client,
+                                    eval,
+                                    ZSTR_VAL(body),
+                                    ZSTR_LEN(body),
+                                    keys,
+                                    args,
+                                    num_keys)
+                      : script_send(valkey_glide->glide_client,
+                                    evalsha,
+                                    sha1,
+                                    sha1_len,
+                                    keys,
+                                    args,
+                                    num_keys);
+        if (body) {
+            zend_string_release(body);
+        }
+        if (result) {
+            free_command_result(result);
+        }
+        zval_ptr_dtor(&prefixed_keys);
+        zval_ptr_dtor(&prefixed_args);
+        return 0;
+    }
+
+    result = script_send(valkey_glide->glide_client, evalsha, sha1, sha1_len, keys, args, num_keys);
+
+    if (script_is_noscript(result)) {
+        zend_string* body = code ? zend_string_copy(code) : script_cache_find_code(sha1, sha1_len);
+
+        if (body) {
+            free_command_result(result);
+            result = NULL;
+
+            /* Load the script everywhere first so later calls routed to other shards hit */
+            if (is_cluster && script_load_all_nodes(valkey_glide->glide_client, body)) {
+                result = script_send(
+                    valkey_glide->glide_client, evalsha, sha1, sha1_len, keys, args, num_keys);
+            }
+            if (!result || script_is_noscript(result)) {
+                if (result) {
+                    free_command_result(result);
+                }
+                result = script_send(valkey_glide->glide_client,
+                                     eval,
+                                     ZSTR_VAL(body),
+                                     ZSTR_LEN(body),
+                                     keys,
+                                     args,
+                                     num_keys);
+            }
+            zend_string_release(body);
+        }
+    }
+
+    if (result) {
+        if (result->command_error) {
+            VALKEY_LOG_ERROR(evalsha, result->command_error->command_error_message);
+        } else if (result->response) {
+            /* Scripts can return various types, nil included */
+            status = command_response_to_zval(
+                result->response, return_value, COMMAND_RESPONSE_ASSOSIATIVE_ARRAY_MAP, false);
+            if (result->response->response_type == Null) {
+                status = 1;
+            }
+        }
+        free_command_result(result);
+    }
+
+    zval_ptr_dtor(&prefixed_keys);
+    zval_ptr_dtor(&prefixed_args);
+    return status;
+}
+
+/* ====================================================================
+ * SCRIPTING COMMANDS
+ * ==================================================================== */
+
+static int execute_eval_command_internal(
+    zval* object, int argc, zval* return_value, zend_class_entry* ce, bool read_only) {
+    valkey_glide_object* valkey_glide;
+    zend_string*         script;
+    zval*                args     = NULL;
+    zend_long            num_keys = 0;
+    char                 sha1[VALKEY_GLIDE_SCRIPT_SHA1_LEN + 1];
+
+    if (zend_parse_method_parameters(
+            argc, object, "OS|al", &object, ce, &script, &args, &num_keys) == FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+
+    valkey_glide_script_sha1(ZSTR_VAL(script), ZSTR_LEN(script), sha1);
+    return valkey_glide_script_run(valkey_glide,
+                                   ce == get_valkey_glide_cluster_ce(),
+                                   script,
+                                   sha1,
+                                   VALKEY_GLIDE_SCRIPT_SHA1_LEN,
+                                   NULL,
+                                   args,
+                                   num_keys,
+                                   read_only,
+                                   return_value);
+}
+
+static int execute_evalsha_command_internal(
+    zval* object, int argc, zval* return_value, zend_class_entry* ce, bool read_only) {
+    valkey_glide_object* valkey_glide;
+    char*                sha1;
+    size_t               sha1_len;
+    zval*                args     = NULL;
+    zend_long            num_keys = 0;
+
+    if (zend_parse_method_parameters(
+            argc, object, "Os|al", &object, ce, &sha1, &sha1_len, &args, &num_keys) == FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+
+    return valkey_glide_script_run(valkey_glide,
+                                   ce == get_valkey_glide_cluster_ce(),
+                                   NULL,
+                                   sha1,
+                                   sha1_len,
+                                   NULL,
+                                   args,
+                                   num_keys,
+                                   read_only,
+                                   return_value);
+}
+
+int execute_eval_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    return execute_eval_command_internal(object, argc, return_value, ce, false);
+}
+
+int execute_eval_ro_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    return execute_eval_command_internal(object, argc, return_value, ce, true);
+}
+
+int execute_evalsha_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    return execute_evalsha_command_internal(object, argc, return_value, ce, false);
+}
+
+int execute_evalsha_ro_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    return execute_evalsha_command_internal(object, argc, return_value, ce, true);
+}
+
+/* SCRIPT <subcommand> [args...]. Cluster clients take a route first. */
+int execute_script_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    valkey_glide_object* valkey_glide;
+    bool                 is_cluster = ce == get_valkey_glide_cluster_ce();
+    zval*                route      = NULL;
+    zval*                z_args     = NULL;
+    int                  args_count = 0;
+    int                  status     = 0;
+
+    if (is_cluster) {
+        if (zend_parse_method_parameters(
+                argc, object, "Oz+", &object, ce, &route, &z_args, &args_count) == FAILURE) {
+            return 0;
+        }
+    } else if (zend_parse_method_parameters(
+                   argc, object, "O+", &object, ce, &z_args, &args_count) == FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (!valkey_glide->glide_client) {
+        return 0;
+    }
+
+    valkey_glide_args cmd_args;
+
+    valkey_glide_args_init(&cmd_args);
+    valkey_glide_args_add_literal(&cmd_args, "SCRIPT");
+    for (int i = 0; i < args_count; i++) {
+        valkey_glide_args_add_zval(&cmd_args, &z_args[i]);
+    }
+
+    bool is_load   = false;
+    bool is_exists = false;
+    if (!cmd_args.failed) {
+        const char* subcommand     = (const char*) cmd_args.args[1];
+        size_t      subcommand_len = cmd_args.lens[1];
+
+        is_load   = zend_binary_strcasecmp(subcommand, subcommand_len, "load", 4) == 0;
+        is_exists = zend_binary_strcasecmp(subcommand, subcommand_len, "exists", 6) == 0;
+    }
+
+    /* Remember loaded bodies so a later NOSCRIPT for their SHA1 can be recovered from */
+    if (is_load && args_count == 2) {
+        char sha1[VALKEY_GLIDE_SCRIPT_SHA1_LEN + 1];
+        valkey_glide_script_sha1((const char*) cmd_args.args[2], cmd_args.lens[2], sha1);
+    }
+
+    CommandResult* result =
+        valkey_glide_args_execute(valkey_glide->glide_client, CustomCommand, &cmd_args, route);
+    valkey_glide_args_free(&cmd_args);
+
+    if (result) {
+        if (result->command_error) {
+            VALKEY_LOG_ERROR("script", result->command_error->command_error_message);
+        } else if (result->response) {
+            status = command_response_to_zval(
+                result->response, return_value, COMMAND_RESPONSE_ASSOSIATIVE_ARRAY_MAP, false);
+
+            /* SCRIPT EXISTS answers 0/1 per script */
+            if (status && is_exists && Z_TYPE_P(return_value) == IS_ARRAY) {
+                zval* value;
+                ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(return_value), value) {
+                    if (Z_TYPE_P(value) == IS_LONG) {
+                        ZVAL_BOOL(value, Z_LVAL_P(value) != 0);
+                    }
+                }
+                ZEND_HASH_FOREACH_END();
+            }
+        }
+        free_command_result(result);
+    }
+
+    return status;
+}
+
+/* ====================================================================
+ * ValkeyGlideScript CLASS
+ * ==================================================================== */
+
+static zend_object* create_valkey_glide_script_object(zend_class_entry* ce) {
+    valkey_glide_script_object* script =
+        ecalloc(1, sizeof(valkey_glide_script_object) + zend_object_properties_size(ce));
+
+    zend_object_std_init(&script->std, ce);
+    object_properties_init(&script->std, ce);
+    script->std.handlers = &valkey_glide_script_object_handlers;
+
+    return &script->std;
+}
+
+static void free_valkey_glide_script_object(zend_object* object) {
+    valkey_glide_script_object* script = VALKEY_GLIDE_PHP_GET_OBJECT(valkey_glide_script_object,
+                                                                     object);
+
+    if (script->code) {
+        zend_string_release(script->code);
+    }
+    zend_object_std_dtor(&script->std);
+}
+
+PHP_METHOD(ValkeyGlideScript, __construct) {
+    valkey_glide_script_object* script;
+    zend_string*                code;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+    Z_PARAM_STR(code)
+    ZEND_PARSE_PARAMETERS_END();
+
+    script = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_script_object, ZEND_THIS);
+    if (script->code) {
+        zend_string_release(script->code);
+    }
+    script->code = zend_string_copy(code);
+    valkey_glide_script_sha1(ZSTR_VAL(code), ZSTR_LEN(code), script->sha1);
+}
+
+PHP_METHOD(ValkeyGlideScript, getCode) {
+    valkey_glide_script_object* script;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    script = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_script_object, ZEND_THIS);
+    if (!script->code) {
+        RETURN_EMPTY_STRING();
+    }
+    RETURN_STR_COPY(script->code);
+}
+
+PHP_METHOD(ValkeyGlideScript, getSha1) {
+    valkey_glide_script_object* script;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    script = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_script_object, ZEND_THIS);
+    RETURN_STRING(script->sha1);
+}
+
+static void valkey_glide_script_run_method(INTERNAL_FUNCTION_PARAMETERS, bool read_only) {
+    valkey_glide_script_object* script;
+    zval*                       client;
+    zval*                       keys = NULL;
+    zval*                       args = NULL;
+    bool                        is_cluster;
+
+    ZEND_PARSE_PARAMETERS_START(1, 3)
+    Z_PARAM_OBJECT(client)
+    Z_PARAM_OPTIONAL
+    Z_PARAM_ARRAY(keys)
+    Z_PARAM_ARRAY(args)
+    ZEND_PARSE_PARAMETERS_END();
+
+    is_cluster = instanceof_function(Z_OBJCE_P(client), get_valkey_glide_cluster_ce());
+    if (!is_cluster && !instanceof_function(Z_OBJCE_P(client), get_valkey_glide_ce())) {
+        zend_argument_type_error(1, "must be of type ValkeyGlide|ValkeyGlideCluster");
+        RETURN_THROWS();
+    }
+
+    script = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_script_object, ZEND_THIS);
+    if (!script->code) {
+        zend_throw_exception(get_valkey_glide_exception_ce(), "Script is not initialized", 0);
+        RETURN_THROWS();
+    }
+
+    if (!valkey_glide_script_run(VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, client),
+                                 is_cluster,
+                                 script->code,
+                                 script->sha1,
+                                 VALKEY_GLIDE_SCRIPT_SHA1_LEN,
+                                 keys,
+                                 args,
+                                 0,
+                                 read_only,
+                                 return_value)) {
+        zval_dtor(return_value);
+        RETURN_FALSE;
+    }
+}
+
+PHP_METHOD(ValkeyGlideScript, run) {
+    valkey_glide_script_run_method(INTERNAL_FUNCTION_PARAM_PASSTHRU, false);
+}
+
+PHP_METHOD(ValkeyGlideScript, runReadOnly) {
+    valkey_glide_script_run_method(INTERNAL_FUNCTION_PARAM_PASSTHRU, true);
+}
+
+void register_valkey_glide_script_class(void) {
+    valkey_glide_script_ce                = register_class_ValkeyGlideScript();
+    valkey_glide_script_ce->create_object = create_valkey_glide_script_object;
+    memcpy(&valkey_glide_script_object_handlers,
+           zend_get_std_object_handlers(),
+           sizeof(valkey_glide_script_object_handlers));
+    valkey_glide_script_object_handlers.offset    = XtOffsetOf(valkey_glide_script_object, std);
+    valkey_glide_script_object_handlers.free_obj  = free_valkey_glide_script_object;
+    valkey_glide_script_object_handlers.clone_obj = NULL;
+}
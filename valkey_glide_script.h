@@ -0,0 +1,120 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Lua Scripting                                           |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef VALKEY_GLIDE_SCRIPT_H
+#define VALKEY_GLIDE_SCRIPT_H
+
+#include "common.h"
+#include "php.h"
+#include "valkey_glide_commands_common.h"
+
+/*
+ * Scripts are always invoked with EVALSHA. The SHA1 of every script body seen by the process
+ * (through eval(), SCRIPT LOAD or ValkeyGlideScript) is kept in a process-wide cache, so the
+ * body is only sent again when a server answers NOSCRIPT: after a restart, a SCRIPT FLUSH or,
+ * in a cluster, the first time a node runs it. Cluster clients then load the script on every
+ * node so the other shards do not each fail once before caching it.
+ */
+
+/* Length of a hex encoded SHA1 digest */
+#define VALKEY_GLIDE_SCRIPT_SHA1_LEN 40
+
+/* Scripts remembered per process before the cache is reset */
+#define VALKEY_GLIDE_SCRIPT_CACHE_MAX 1024
+
+/* ValkeyGlideScript object structure */
+typedef struct {
+    zend_string* code;
+    char         sha1[VALKEY_GLIDE_SCRIPT_SHA1_LEN + 1];
+    zend_object  std;
+} valkey_glide_script_object;
+
+/* Class entry */
+extern zend_class_entry* valkey_glide_script_ce;
+
+/* Class registration function */
+void register_valkey_glide_script_class(void);
+
+/* Module lifecycle of the SHA1 cache, called from MINIT/MSHUTDOWN */
+void valkey_glide_script_cache_init(void);
+void valkey_glide_script_cache_shutdown(void);
+
+/* Hex encoded SHA1 of a script body, from the cache when the body was seen before.
+ * sha1 must hold VALKEY_GLIDE_SCRIPT_SHA1_LEN + 1 bytes. */
+void valkey_glide_script_sha1(const char* code, size_t code_len, char* sha1);
+
+/* Run a script by SHA1, sending code (or the cached body for sha1 when code is NULL) only if
+ * the server does not know the script. When keys is NULL the first num_keys elements of args
+ * are the keys, as with EVAL. Returns 1 on success, 0 on failure. */
+int valkey_glide_script_run(valkey_glide_object* valkey_glide,
+                            bool                 is_cluster,
+                            zend_string*         code,
+                            const char*          sha1,
+                            size_t               sha1_len,
+                            zval*                keys,
+                            zval*                args,
+                            zend_long            num_keys,
+                            bool                 read_only,
+                            zval*                return_value);
+
+/* Class methods */
+PHP_METHOD(ValkeyGlideScript, __construct);
+PHP_METHOD(ValkeyGlideScript, getCode);
+PHP_METHOD(ValkeyGlideScript, getSha1);
+PHP_METHOD(ValkeyGlideScript, run);
+PHP_METHOD(ValkeyGlideScript, runReadOnly);
+
+/* ====================================================================
+ * SCRIPTING COMMAND FUNCTIONS
+ * ==================================================================== */
+
+int execute_eval_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+int execute_eval_ro_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+int execute_evalsha_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+int execute_evalsha_ro_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+int execute_script_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+
+/* ====================================================================
+ * SCRIPTING COMMAND MACROS
+ * ==================================================================== */
+
+#define SCRIPT_METHOD_IMPL_EX(class_name, method_name, execute_fn)                 \
+    PHP_METHOD(class_name, method_name) {                                          \
+        if (execute_fn(getThis(),                                                  \
+                       ZEND_NUM_ARGS(),                                            \
+                       return_value,                                               \
+                       strcmp(#class_name, "ValkeyGlideCluster") == 0              \
+                           ? get_valkey_glide_cluster_ce()                         \
+                           : get_valkey_glide_ce())) {                             \
+            return;                                                                \
+        }                                                                          \
+        zval_dtor(return_value);                                                   \
+        RETURN_FALSE;                                                              \
+    }
+
+#define EVAL_METHOD_IMPL(class_name) \
+    SCRIPT_METHOD_IMPL_EX(class_name, eval, execute_eval_command)
+
+#define EVAL_RO_METHOD_IMPL(class_name) \
+    SCRIPT_METHOD_IMPL_EX(class_name, eval_ro, execute_eval_ro_command)
+
+#define EVALSHA_METHOD_IMPL(class_name) \
+    SCRIPT_METHOD_IMPL_EX(class_name, evalsha, execute_evalsha_command)
+
+#define EVALSHA_RO_METHOD_IMPL(class_name) \
+    SCRIPT_METHOD_IMPL_EX(class_name, evalsha_ro, execute_evalsha_ro_command)
+
+#define SCRIPT_METHOD_IMPL(class_name) \
+    SCRIPT_METHOD_IMPL_EX(class_name, script, execute_script_command)
+
+#endif /* VALKEY_GLIDE_SCRIPT_H */
@@ -0,0 +1,72 @@
+<?php
+
+/**
+ * @generate-function-entries
+ * @generate-class-entries
+ */
+
+/**
+ * A Lua script hashed once and run by SHA1.
+ *
+ * run() always sends EVALSHA and only sends the script body when the server answers NOSCRIPT.
+ * For a ValkeyGlideCluster the script is then loaded on every node, so each shard misses at
+ * most once.
+ *
+ * @example
+ * $limiter = new ValkeyGlideScript(file_get_contents('rate_limit.lua'));
+ * $allowed = $limiter->run($client, ['rl:' . $user], [time(), 100]);
+ */
+final class ValkeyGlideScript
+{
+    /**
+     * Create a script, computing its SHA1.
+     *
+     * @param string $code The Lua source of the script.
+     */
+    public function __construct(string $code)
+    {
+    }
+
+    /**
+     * Get the Lua source of the script.
+     *
+     * @return string The script body.
+     */
+    public function getCode(): string
+    {
+    }
+
+    /**
+     * Get the SHA1 the script is invoked by.
+     *
+     * @return string The lowercase hex encoded SHA1 of the script body.
+     */
+    public function getSha1(): string
+    {
+    }
+
+    /**
+     * Run the script.
+     *
+     * @see https://valkey.io/commands/evalsha/
+     *
+     * @param ValkeyGlide|ValkeyGlideCluster $client The client to run the script with.
+     * @param array                          $keys   The key names the script accesses.
+     * @param array                          $args   The additional arguments.
+     *
+     * @return mixed The script reply, or false on failure.
+     */
+    public function run(ValkeyGlide|ValkeyGlideCluster $client, array $keys = [], array $args = []): mixed
+    {
+    }
+
+    /**
+     * Run the script with EVALSHA_RO, so it may be served by a replica but cannot write.
+     *
+     * @see https://valkey.io/commands/evalsha_ro/
+     * @see ValkeyGlideScript::run()
+     */
+    public function runReadOnly(ValkeyGlide|ValkeyGlideCluster $client, array $keys = [], array $args = []): mixed
+    {
+    }
+}
@@ -0,0 +1,292 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Shared Read Cache                                       |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#include "valkey_glide_shm_cache.h"
+
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <time.h>
+
+#include "logger.h"
+
+typedef struct {
+    _Atomic uint32_t seq; /* Odd while a writer owns the slot */
+    uint32_t         key_len;
+    uint32_t         value_len;
+    uint32_t         reserved;
+    uint64_t         hash; /* 0 for a free slot */
+    uint64_t         ns;
+    uint64_t         generation; /* The segment generation the entry was stored in */
+    int64_t          expires;    /* CLOCK_MONOTONIC milliseconds */
+    char             data[];     /* Key, then value */
+} shm_slot;
+
+#define SHM_SLOT_DATA_SIZE (VALKEY_GLIDE_SHM_CACHE_SLOT_SIZE - sizeof(shm_slot))
+
+typedef struct {
+    uint64_t         slot_mask;
+    _Atomic uint64_t generation; /* Bumped to drop every entry at once */
+} shm_header;
+
+#define SHM_HEADER_SIZE 64
+
+static void*       shm_segment = NULL;
+static size_t      shm_size    = 0;
+static shm_header* shm         = NULL;
+
+/* Per process counters, kept out of the segment so hits do not bounce a shared cache line */
+static zend_long shm_hits   = 0;
+static zend_long shm_misses = 0;
+static zend_long shm_stores = 0;
+
+static inline shm_slot* shm_slot_at(uint64_t index) {
+    return (shm_slot*) ((char*) shm + SHM_HEADER_SIZE +
+                        (index & shm->slot_mask) * VALKEY_GLIDE_SHM_CACHE_SLOT_SIZE);
+}
+
+static inline int64_t shm_now(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static inline uint64_t shm_hash(uint64_t ns, const char* key, size_t key_len) {
+    uint64_t hash = (uint64_t) zend_inline_hash_func(key, key_len) ^ ns;
+
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash ? hash : 1;
+}
+
+/* Take a slot for writing; false when another process has it */
+static inline bool shm_slot_lock(shm_slot* slot, uint32_t* seq) {
+    *seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    if ((*seq & 1) || !atomic_compare_exchange_strong_explicit(
+                          &slot->seq, seq, *seq + 1, memory_order_acquire, memory_order_relaxed)) {
+        return false;
+    }
+    /* Readers must see the odd sequence before any of the writes that follow */
+    atomic_thread_fence(memory_order_release);
+    return true;
+}
+
+static inline void shm_slot_unlock(shm_slot* slot, uint32_t seq) {
+    atomic_store_explicit(&slot->seq, seq + 2, memory_order_release);
+}
+
+/* ====================================================================
+ * LIFECYCLE
+ * ==================================================================== */
+
+void valkey_glide_shm_cache_init(zend_long size) {
+    uint64_t slots;
+
+    if (size <= 0) {
+        return;
+    }
+
+    /* A power of two number of slots, with at least one probe sequence */
+    slots = ((uint64_t) size - SHM_HEADER_SIZE) / VALKEY_GLIDE_SHM_CACHE_SLOT_SIZE;
+    if ((size_t) size <= SHM_HEADER_SIZE || slots < VALKEY_GLIDE_SHM_CACHE_PROBES) {
+        VALKEY_LOG_WARN("shared_cache", "valkey_glide.shared_cache_size is too small, disabled");
+        return;
+    }
+    while (slots & (slots - 1)) {
+        slots &= slots - 1;
+    }
+
+    /* Anonymous shared memory is inherited by the workers forked after MINIT, zero filled */
+    shm_size    = SHM_HEADER_SIZE + slots * VALKEY_GLIDE_SHM_CACHE_SLOT_SIZE;
+    shm_segment = mmap(NULL, shm_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shm_segment == MAP_FAILED) {
+        VALKEY_LOG_ERROR("shared_cache", "Cannot map the shared cache segment, disabled");
+        shm_segment = NULL;
+        shm_size    = 0;
+        return;
+    }
+
+    shm            = shm_segment;
+    shm->slot_mask = slots - 1;
+    atomic_init(&shm->generation, 1);
+}
+
+void valkey_glide_shm_cache_shutdown(void) {
+    if (shm_segment) {
+        munmap(shm_segment, shm_size);
+    }
+    shm_segment = NULL;
+    shm_size    = 0;
+    shm         = NULL;
+}
+
+bool valkey_glide_shm_cache_enabled(void) {
+    return shm != NULL;
+}
+
+uint64_t valkey_glide_shm_cache_namespace(const uint8_t* connection_request, size_t len) {
+    return shm_hash(0, (const char*) connection_request, len);
+}
+
+/* ====================================================================
+ * ENTRIES
+ * ==================================================================== */
+
+zend_string* valkey_glide_shm_cache_get(uint64_t ns, const char* key, size_t key_len) {
+    uint64_t hash, generation;
+    int64_t  now;
+
+    if (!shm || key_len > SHM_SLOT_DATA_SIZE) {
+        return NULL;
+    }
+
+    hash       = shm_hash(ns, key, key_len);
+    generation = atomic_load_explicit(&shm->generation, memory_order_acquire);
+    now        = shm_now();
+
+    for (uint64_t i = 0; i < VALKEY_GLIDE_SHM_CACHE_PROBES; i++) {
+        shm_slot*    slot = shm_slot_at(hash + i);
+        uint32_t     seq  = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        uint32_t     value_len;
+        zend_string* value;
+
+        if ((seq & 1) || slot->hash != hash || slot->ns != ns || slot->key_len != key_len ||
+            memcmp(slot->data, key, key_len) != 0) {
+            continue;
+        }
+
+        /* Every field read here may be torn until the sequence is checked again */
+        value_len = slot->value_len;
+        if (slot->generation != generation || slot->expires <= now ||
+            value_len > SHM_SLOT_DATA_SIZE - key_len) {
+            break;
+        }
+        value = zend_string_alloc(value_len, 0);
+        memcpy(ZSTR_VAL(value), slot->data + key_len, value_len);
+        ZSTR_VAL(value)[value_len] = '\0';
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != seq) {
+            zend_string_efree(value);
+            break;
+        }
+        shm_hits++;
+        return value;
+    }
+
+    shm_misses++;
+    return NULL;
+}
+
+void valkey_glide_shm_cache_set(uint64_t    ns,
+                                const char* key,
+                                size_t      key_len,
+                                const char* value,
+                                size_t      value_len,
+                                zend_long   ttl) {
+    uint64_t  hash, generation;
+    int64_t   now, oldest = INT64_MAX;
+    shm_slot* victim = NULL;
+    uint32_t  seq;
+
+    if (!shm || ttl <= 0 || key_len + value_len > SHM_SLOT_DATA_SIZE) {
+        return;
+    }
+
+    hash       = shm_hash(ns, key, key_len);
+    generation = atomic_load_explicit(&shm->generation, memory_order_acquire);
+    now        = shm_now();
+
+    /* The slot already holding the key, else the free, expired or oldest one. These unlocked
+     * reads only pick the slot; a wrong pick costs an entry, not a wrong reply. */
+    for (uint64_t i = 0; i < VALKEY_GLIDE_SHM_CACHE_PROBES; i++) {
+        shm_slot* slot = shm_slot_at(hash + i);
+        int64_t   expires;
+
+        /* Skipped rather than waited for; this also routes around the slot of a worker that
+         * was killed in the middle of a write */
+        if (atomic_load_explicit(&slot->seq, memory_order_relaxed) & 1) {
+            continue;
+        }
+        if (slot->hash == hash && slot->ns == ns) {
+            victim = slot;
+            break;
+        }
+        expires = (slot->hash == 0 || slot->generation != generation) ? 0 : slot->expires;
+        if (expires < oldest) {
+            oldest = expires;
+            victim = slot;
+        }
+    }
+
+    if (!victim || !shm_slot_lock(victim, &seq)) {
+        return;
+    }
+    victim->hash       = hash;
+    victim->ns         = ns;
+    victim->generation = generation;
+    victim->expires    = now + ttl;
+    victim->key_len    = (uint32_t) key_len;
+    victim->value_len  = (uint32_t) value_len;
+    memcpy(victim->data, key, key_len);
+    memcpy(victim->data + key_len, value, value_len);
+    shm_slot_unlock(victim, seq);
+
+    shm_stores++;
+}
+
+void valkey_glide_shm_cache_invalidate(uint64_t ns, const char* key, size_t key_len) {
+    uint64_t hash;
+
+    if (!shm) {
+        return;
+    }
+
+    hash = shm_hash(ns, key, key_len);
+    for (uint64_t i = 0; i < VALKEY_GLIDE_SHM_CACHE_PROBES; i++) {
+        shm_slot* slot   = shm_slot_at(hash + i);
+        bool      locked = false;
+        uint32_t  seq;
+
+        if (slot->hash != hash || slot->ns != ns) {
+            continue;
+        }
+        /* A writer holds a slot for the length of a memcpy; give up after a while in case it
+         * died there, the TTL still applies */
+        for (int attempt = 0; attempt < 1000 && !locked; attempt++) {
+            locked = shm_slot_lock(slot, &seq);
+        }
+        if (!locked) {
+            continue;
+        }
+        if (slot->hash == hash && slot->ns == ns) {
+            slot->hash = 0;
+        }
+        shm_slot_unlock(slot, seq);
+    }
+}
+
+void valkey_glide_shm_cache_flush(void) {
+    if (shm) {
+        atomic_fetch_add_explicit(&shm->generation, 1, memory_order_release);
+    }
+}
+
+void valkey_glide_shm_cache_stats(zval* return_value) {
+    array_init_size(return_value, 4);
+    add_assoc_long(return_value, "slots", shm ? (zend_long) (shm->slot_mask + 1) : 0);
+    add_assoc_long(return_value, "hits", shm_hits);
+    add_assoc_long(return_value, "misses", shm_misses);
+    add_assoc_long(return_value, "stores", shm_stores);
+}
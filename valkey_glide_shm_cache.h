@@ -0,0 +1,69 @@
+/*
+  +----------------------------------------------------------------------+
+  | Valkey Glide Shared Read Cache                                       |
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef VALKEY_GLIDE_SHM_CACHE_H
+#define VALKEY_GLIDE_SHM_CACHE_H
+
+#include "php.h"
+
+/*
+ * GET replies cached in a memory segment mapped in MINIT, before php-fpm (or Apache prefork)
+ * forks its workers, so every worker of a pool reads the values the others fetched.
+ *
+ * The segment is a fixed open-addressing table of slots, each guarded by a sequence lock: a
+ * writer makes the sequence odd while it copies the value in, and readers retry or give up
+ * when the sequence moved under them. Nothing blocks; a slot another process is writing is a
+ * miss. Entries expire after the TTL of the client that stored them, and are dropped sooner
+ * when a client with a client_side_cache is told by the server that the key changed.
+ *
+ * Sized by the valkey_glide.shared_cache_size INI setting (0 disables it), and used by the
+ * clients created with advanced_config['shared_cache'].
+ */
+
+/* Bytes per slot; longer keys and values are not cached */
+#define VALKEY_GLIDE_SHM_CACHE_SLOT_SIZE 1024
+
+/* Slots looked at for a key before giving up */
+#define VALKEY_GLIDE_SHM_CACHE_PROBES 8
+
+/* Default TTL when shared_cache is true, in milliseconds */
+#define VALKEY_GLIDE_SHM_CACHE_DEFAULT_TTL 1000
+
+/* Module lifecycle, called from MINIT/MSHUTDOWN */
+void valkey_glide_shm_cache_init(zend_long size);
+void valkey_glide_shm_cache_shutdown(void);
+
+bool valkey_glide_shm_cache_enabled(void);
+
+/* Entries of clients with identical connection settings are shared. Never returns 0. */
+uint64_t valkey_glide_shm_cache_namespace(const uint8_t* connection_request, size_t len);
+
+/* The cached value of key, or NULL */
+zend_string* valkey_glide_shm_cache_get(uint64_t ns, const char* key, size_t key_len);
+
+void valkey_glide_shm_cache_set(uint64_t    ns,
+                                const char* key,
+                                size_t      key_len,
+                                const char* value,
+                                size_t      value_len,
+                                zend_long   ttl);
+
+void valkey_glide_shm_cache_invalidate(uint64_t ns, const char* key, size_t key_len);
+
+/* Drop every entry, of every namespace */
+void valkey_glide_shm_cache_flush(void);
+
+/* Add the segment statistics of this process to an array */
+void valkey_glide_shm_cache_stats(zval* return_value);
+
+#endif /* VALKEY_GLIDE_SHM_CACHE_H */
@@ -19,13 +19,10 @@
 
 #include "command_response.h"
 #include "include/glide_bindings.h"
+#include "valkey_glide_args.h"
 #include "valkey_glide_commands_common.h"
 #include "valkey_glide_core_common.h"
 
-/* Import the string conversion functions from command_response.c */
-extern char* long_to_string(long value, size_t* len);
-extern char* double_to_string(double value, size_t* len);
-
 /* Execute a TYPE command using the Valkey Glide client - MIGRATED TO CORE FRAMEWORK */
 int execute_type_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
     valkey_glide_object* valkey_glide;
@@ -152,14 +149,12 @@ int execute_getrange_command(zval* object, int argc, zval* return_value, zend_cl
 }
 
 /* Helper function to build SORT command arguments */
-static void build_sort_args(const char*     key,
-                            size_t          key_len,
-                            zval*           sort_pattern,
-                            zend_bool*      alpha_out,
-                            zend_bool*      desc_out,
-                            uintptr_t**     args_ptr,
-                            unsigned long** args_len_ptr,
-                            unsigned long*  arg_count_ptr) {
+static void build_sort_args(const char*        key,
+                            size_t             key_len,
+                            zval*              sort_pattern,
+                            zend_bool*         alpha_out,
+                            zend_bool*         desc_out,
+                            valkey_glide_args* cmd_args) {
     zend_bool alpha = 0, desc = 0, explicit_asc = 0;
 
     /* Parse sort options from the pattern array first */
@@ -198,62 +193,21 @@ static void build_sort_args(const char*     key,
     if (desc_out)
         *desc_out = desc;
 
-    /* Calculate the maximum number of arguments */
-    unsigned long max_args = 1; /* key */
-    if (sort_pattern && Z_TYPE_P(sort_pattern) == IS_ARRAY) {
-        /* Patterns array can have: BY, LIMIT, GET, STORE */
-        HashTable* ht = Z_ARRVAL_P(sort_pattern);
-        max_args +=
-            2 * zend_hash_num_elements(ht) + 2; /* Extra space for possible LIMIT offset count */
-    }
-    if (alpha)
-        max_args++; /* ALPHA */
-    if (desc)
-        max_args++; /* DESC */
-
-    /* Allocate arrays for arguments */
-    uintptr_t*     args     = (uintptr_t*) emalloc(max_args * sizeof(uintptr_t));
-    unsigned long* args_len = (unsigned long*) emalloc(max_args * sizeof(unsigned long));
-
-    if (!args || !args_len) {
-        if (args)
-            efree(args);
-        if (args_len)
-            efree(args_len);
-        *args_ptr      = NULL;
-        *args_len_ptr  = NULL;
-        *arg_count_ptr = 0;
-        return;
-    }
-
-    /* Current argument index */
-    unsigned long arg_idx = 0;
-
     /* First argument: key */
-    args[arg_idx]     = (uintptr_t) key;
-    args_len[arg_idx] = key_len;
-    arg_idx++;
+    valkey_glide_args_add_key(cmd_args, key, key_len);
 
     /* Add sort patterns if provided */
     if (sort_pattern && Z_TYPE_P(sort_pattern) == IS_ARRAY) {
-        HashTable*   ht = Z_ARRVAL_P(sort_pattern);
-        zval*        z_ele;
-        zend_string* z_key;
-        zend_ulong   num_key;
+        HashTable* ht = Z_ARRVAL_P(sort_pattern);
+        zval*      z_ele;
+        zval *     z_offset = NULL, *z_count = NULL;
 
         /* Check for BY pattern (case-insensitive) */
         if ((z_ele = zend_hash_str_find(ht, "by", sizeof("by") - 1)) != NULL ||
             (z_ele = zend_hash_str_find(ht, "BY", sizeof("BY") - 1)) != NULL) {
             if (Z_TYPE_P(z_ele) == IS_STRING) {
-                /* Add BY keyword */
-                args[arg_idx]     = (uintptr_t) "BY";
-                args_len[arg_idx] = 2;
-                arg_idx++;
-
-                /* Add BY pattern */
-                args[arg_idx]     = (uintptr_t) Z_STRVAL_P(z_ele);
-                args_len[arg_idx] = Z_STRLEN_P(z_ele);
-                arg_idx++;
+                valkey_glide_args_add_literal(cmd_args, "BY");
+                valkey_glide_args_add(cmd_args, Z_STRVAL_P(z_ele), Z_STRLEN_P(z_ele));
             }
         }
 
@@ -261,81 +215,20 @@ static void build_sort_args(const char*     key,
         zval* z_limit = NULL;
         if ((z_limit = zend_hash_str_find(ht, "limit", sizeof("limit") - 1)) != NULL ||
             (z_limit = zend_hash_str_find(ht, "LIMIT", sizeof("LIMIT") - 1)) != NULL) {
-            if (Z_TYPE_P(z_limit) == IS_ARRAY) {
-                HashTable* limit_ht = Z_ARRVAL_P(z_limit);
-                if (zend_hash_num_elements(limit_ht) >= 2) {
-                    zval* z_offset = zend_hash_index_find(limit_ht, 0);
-                    zval* z_count  = zend_hash_index_find(limit_ht, 1);
-
-                    if (z_offset && z_count) {
-                        /* Add LIMIT keyword */
-                        args[arg_idx]     = (uintptr_t) "LIMIT";
-                        args_len[arg_idx] = 5;
-                        arg_idx++;
-
-                        /* Add offset */
-                        char*  offset_str;
-                        size_t offset_len;
-                        long   offset_val = zval_get_long(z_offset);
-                        offset_str        = long_to_string(offset_val, &offset_len);
-                        if (offset_str) {
-                            args[arg_idx]     = (uintptr_t) offset_str;
-                            args_len[arg_idx] = offset_len;
-                            arg_idx++;
-
-                            /* Add count */
-                            char*  count_str;
-                            size_t count_len;
-                            long   count_val = zval_get_long(z_count);
-                            count_str        = long_to_string(count_val, &count_len);
-                            if (count_str) {
-                                args[arg_idx]     = (uintptr_t) count_str;
-                                args_len[arg_idx] = count_len;
-                                arg_idx++;
-                            } else {
-                                efree(offset_str);
-                            }
-                        }
-                    }
-                }
+            if (Z_TYPE_P(z_limit) == IS_ARRAY && zend_hash_num_elements(Z_ARRVAL_P(z_limit)) >= 2) {
+                z_offset = zend_hash_index_find(Z_ARRVAL_P(z_limit), 0);
+                z_count  = zend_hash_index_find(Z_ARRVAL_P(z_limit), 1);
             }
         }
         /* Fallback to old format for backward compatibility */
         else {
-            zval *z_offset, *z_count;
-            if ((z_offset = zend_hash_str_find(ht, "limit_offset", sizeof("limit_offset") - 1)) !=
-                    NULL &&
-                (z_count = zend_hash_str_find(ht, "limit_count", sizeof("limit_count") - 1)) !=
-                    NULL) {
-                /* Add LIMIT keyword */
-                args[arg_idx]     = (uintptr_t) "LIMIT";
-                args_len[arg_idx] = 5;
-                arg_idx++;
-
-                /* Add offset */
-                char*  offset_str;
-                size_t offset_len;
-                long   offset_val = zval_get_long(z_offset);
-                offset_str        = long_to_string(offset_val, &offset_len);
-                if (offset_str) {
-                    args[arg_idx]     = (uintptr_t) offset_str;
-                    args_len[arg_idx] = offset_len;
-                    arg_idx++;
-
-                    /* Add count */
-                    char*  count_str;
-                    size_t count_len;
-                    long   count_val = zval_get_long(z_count);
-                    count_str        = long_to_string(count_val, &count_len);
-                    if (count_str) {
-                        args[arg_idx]     = (uintptr_t) count_str;
-                        args_len[arg_idx] = count_len;
-                        arg_idx++;
-                    } else {
-                        efree(offset_str);
-                    }
-                }
-            }
+            z_offset = zend_hash_str_find(ht, "limit_offset", sizeof("limit_offset") - 1);
+            z_count  = zend_hash_str_find(ht, "limit_count", sizeof("limit_count") - 1);
+        }
+        if (z_offset && z_count) {
+            valkey_glide_args_add_literal(cmd_args, "LIMIT");
+            valkey_glide_args_add_long(cmd_args, zval_get_long(z_offset));
+            valkey_glide_args_add_long(cmd_args, zval_get_long(z_count));
         }
 
         /* Check for GET patterns (case-insensitive) */
@@ -343,31 +236,19 @@ static void build_sort_args(const char*     key,
             (z_ele = zend_hash_str_find(ht, "GET", sizeof("GET") - 1)) != NULL) {
             if (Z_TYPE_P(z_ele) == IS_ARRAY) {
                 /* Handle array of GET patterns: 'get' => ['pattern1', 'pattern2'] */
-                HashTable* get_ht = Z_ARRVAL_P(z_ele);
-                zval*      z_pattern;
-                ZEND_HASH_FOREACH_VAL(get_ht, z_pattern) {
+                zval* z_pattern;
+                ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(z_ele), z_pattern) {
                     if (Z_TYPE_P(z_pattern) == IS_STRING) {
-                        /* Add GET keyword */
-                        args[arg_idx]     = (uintptr_t) "GET";
-                        args_len[arg_idx] = 3;
-                        arg_idx++;
-
-                        /* Add GET pattern */
-                        args[arg_idx]     = (uintptr_t) Z_STRVAL_P(z_pattern);
-                        args_len[arg_idx] = Z_STRLEN_P(z_pattern);
-                        arg_idx++;
+                        valkey_glide_args_add_literal(cmd_args, "GET");
+                        valkey_glide_args_add(
+                            cmd_args, Z_STRVAL_P(z_pattern), Z_STRLEN_P(z_pattern));
                     }
                 }
                 ZEND_HASH_FOREACH_END();
             } else if (Z_TYPE_P(z_ele) == IS_STRING) {
                 /* Handle single GET pattern: 'get' => 'pattern' */
-                args[arg_idx]     = (uintptr_t) "GET";
-                args_len[arg_idx] = 3;
-                arg_idx++;
-
-                args[arg_idx]     = (uintptr_t) Z_STRVAL_P(z_ele);
-                args_len[arg_idx] = Z_STRLEN_P(z_ele);
-                arg_idx++;
+                valkey_glide_args_add_literal(cmd_args, "GET");
+                valkey_glide_args_add(cmd_args, Z_STRVAL_P(z_ele), Z_STRLEN_P(z_ele));
             }
         }
 
@@ -375,65 +256,20 @@ static void build_sort_args(const char*     key,
         if ((z_ele = zend_hash_str_find(ht, "store", sizeof("store") - 1)) != NULL ||
             (z_ele = zend_hash_str_find(ht, "STORE", sizeof("STORE") - 1)) != NULL) {
             if (Z_TYPE_P(z_ele) == IS_STRING) {
-                /* Add STORE keyword */
-                args[arg_idx]     = (uintptr_t) "STORE";
-                args_len[arg_idx] = 5;
-                arg_idx++;
-
-                /* Add STORE destination key */
-                args[arg_idx]     = (uintptr_t) Z_STRVAL_P(z_ele);
-                args_len[arg_idx] = Z_STRLEN_P(z_ele);
-                arg_idx++;
+                valkey_glide_args_add_literal(cmd_args, "STORE");
+                valkey_glide_args_add_key(cmd_args, Z_STRVAL_P(z_ele), Z_STRLEN_P(z_ele));
             }
         }
     }
 
     /* Add sorting options */
     if (alpha) {
-        args[arg_idx]     = (uintptr_t) "ALPHA";
-        args_len[arg_idx] = 5;
-        arg_idx++;
+        valkey_glide_args_add_literal(cmd_args, "ALPHA");
     }
-
     if (desc) {
-        args[arg_idx]     = (uintptr_t) "DESC";
-        args_len[arg_idx] = 4;
-        arg_idx++;
+        valkey_glide_args_add_literal(cmd_args, "DESC");
     } else if (explicit_asc) {
-        args[arg_idx]     = (uintptr_t) "ASC";
-        args_len[arg_idx] = 3;
-        arg_idx++;
-    }
-
-    /* Set output parameters */
-    *args_ptr      = args;
-    *args_len_ptr  = args_len;
-    *arg_count_ptr = arg_idx;
-}
-
-/* Free memory allocated for SORT command arguments */
-static void free_sort_args(uintptr_t* args, unsigned long* args_len, unsigned long arg_count) {
-    if (args && args_len) {
-        /* Free any dynamically allocated argument strings (offset and count) */
-        for (unsigned long i = 0; i < arg_count; i++) {
-            /* Skip key, BY, GET, LIMIT, STORE, ALPHA, DESC, ASC and any string that was
-               directly extracted from a zval (not allocated) */
-            if (strcmp((const char*) args[i], "BY") != 0 &&
-                strcmp((const char*) args[i], "GET") != 0 &&
-                strcmp((const char*) args[i], "LIMIT") != 0 &&
-                strcmp((const char*) args[i], "STORE") != 0 &&
-                strcmp((const char*) args[i], "ALPHA") != 0 &&
-                strcmp((const char*) args[i], "DESC") != 0 &&
-                strcmp((const char*) args[i], "ASC") != 0 && i > 0 && /* Skip key */
-                ((i > 1 && strcmp((const char*) args[i - 1], "LIMIT") ==
-                               0) || /* Only free offset and count */
-                 (i > 2 && strcmp((const char*) args[i - 2], "LIMIT") == 0))) {
-                efree((void*) args[i]);
-            }
-        }
-
-        efree(args);
-        efree(args_len);
+        valkey_glide_args_add_literal(cmd_args, "ASC");
     }
 }
 
@@ -457,29 +293,15 @@ int execute_sort_command(zval* object, int argc, zval* return_value, zend_class_
     /* If we have a Glide client, use it */
     if (valkey_glide->glide_client) {
         /* Build command arguments */
-        uintptr_t*     args      = NULL;
-        unsigned long* args_len  = NULL;
-        unsigned long  arg_count = 0;
-        build_sort_args(key, key_len, z_opts, &alpha, &desc, &args, &args_len, &arg_count);
-
-        if (!args || !args_len || arg_count == 0) {
-            if (args)
-                efree(args);
-            if (args_len)
-                efree(args_len);
-            return 0;
-        }
+        valkey_glide_args args;
 
-        /* Execute the command */
-        CommandResult* cmd_result = execute_command(valkey_glide->glide_client,
-                                                    Sort,      /* command type */
-                                                    arg_count, /* number of arguments */
-                                                    args,      /* arguments */
-                                                    args_len   /* argument lengths */
-        );
+        valkey_glide_args_init(&args);
+        build_sort_args(key, key_len, z_opts, &alpha, &desc, &args);
 
-        /* Free the argument arrays */
-        free_sort_args(args, args_len, arg_count);
+        /* Execute the command */
+        CommandResult* cmd_result =
+            valkey_glide_args_execute(valkey_glide->glide_client, Sort, &args, NULL);
+        valkey_glide_args_free(&args);
 
         /* Check if we have a valid result */
         if (!cmd_result || !cmd_result->response) {
@@ -497,12 +319,11 @@ int execute_sort_command(zval* object, int argc, zval* return_value, zend_class_
             if (z_store && Z_TYPE_P(z_store) == IS_STRING) {
                 /* With STORE option, we get the number of stored elements */
                 long result_value = 0;
+                /* handle_int_response() frees the result */
                 if (handle_int_response(cmd_result, &result_value)) {
                     ZVAL_LONG(return_value, result_value);
-                    free_command_result(cmd_result);
                     return 1;
                 }
-                free_command_result(cmd_result);
                 return 0;
             }
         }
@@ -546,29 +367,15 @@ int execute_sort_ro_command(zval* object, int argc, zval* return_value, zend_cla
     /* If we have a Glide client, use it */
     if (valkey_glide->glide_client) {
         /* Build command arguments */
-        uintptr_t*     args      = NULL;
-        unsigned long* args_len  = NULL;
-        unsigned long  arg_count = 0;
-        build_sort_args(key, key_len, z_opts, &alpha, &desc, &args, &args_len, &arg_count);
-
-        if (!args || !args_len || arg_count == 0) {
-            if (args)
-                efree(args);
-            if (args_len)
-                efree(args_len);
-            return 0;
-        }
+        valkey_glide_args args;
+
+        valkey_glide_args_init(&args);
+        build_sort_args(key, key_len, z_opts, &alpha, &desc, &args);
 
         /* Execute the command */
-        CommandResult* cmd_result = execute_command(valkey_glide->glide_client,
-                                                    SortReadOnly, /* command type */
-                                                    arg_count,    /* number of arguments */
-                                                    args,         /* arguments */
-                                                    args_len      /* argument lengths */
-        );
-
-        /* Free the argument arrays */
-        free_sort_args(args, args_len, arg_count);
+        CommandResult* cmd_result =
+            valkey_glide_args_execute(valkey_glide->glide_client, SortReadOnly, &args, NULL);
+        valkey_glide_args_free(&args);
 
         /* Check if we have a valid result */
         if (!cmd_result || !cmd_result->response) {
@@ -736,10 +736,10 @@ int execute_xread_command(zval* object, int argc, zval* return_value, zend_class
         ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(z_streams_and_ids), stream_key, stream_id) {
             if (stream_key) {
                 add_next_index_str(&z_streams, zend_string_copy(stream_key));
-                if (Z_TYPE_P(stream_id) != IS_STRING) {
-                    convert_to_string(stream_id);
-                }
-                add_next_index_str(&z_ids, zend_string_copy(Z_STR_P(stream_id)));
+                /* Converted to a string by the preparer */
+                ZVAL_DEREF(stream_id);
+                Z_TRY_ADDREF_P(stream_id);
+                add_next_index_zval(&z_ids, stream_id);
             }
         }
         ZEND_HASH_FOREACH_END();
@@ -912,10 +912,10 @@ int execute_xreadgroup_command(zval* object, int argc, zval* return_value, zend_
         ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(z_streams_and_ids), stream_key, stream_id) {
             if (stream_key) {
                 add_next_index_str(&z_streams, zend_string_copy(stream_key));
-                if (Z_TYPE_P(stream_id) != IS_STRING) {
-                    convert_to_string(stream_id);
-                }
-                add_next_index_str(&z_ids, zend_string_copy(Z_STR_P(stream_id)));
+                /* Converted to a string by the preparer */
+                ZVAL_DEREF(stream_id);
+                Z_TRY_ADDREF_P(stream_id);
+                add_next_index_zval(&z_ids, stream_id);
             }
         }
         ZEND_HASH_FOREACH_END();
@@ -19,6 +19,7 @@
 
 #include "command_response.h"
 #include "include/glide_bindings.h"
+#include "valkey_glide_args.h"
 #include "valkey_glide_list_common.h"
 #include "valkey_glide_s_common.h"
 #include "valkey_glide_z_common.h"
@@ -47,10 +48,6 @@
 #include <ext/session/php_session.h>
 #endif
 
-/* Import the string conversion functions from command_response.c */
-extern char* long_to_string(long value, size_t* len);
-extern char* double_to_string(double value, size_t* len);
-
 int execute_zrandmember_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
     char*     key = NULL;
     size_t    key_len;
@@ -240,7 +237,7 @@ int execute_zmscore_command(zval* object, int argc, zval* return_value, zend_cla
             } array_data = {return_value, 0}; /* ZMSCORE doesn't use withscores */
 
             int result = execute_z_generic_command(
-                glide_client, ZMScore, &args, &array_data, process_z_array_result);
+                glide_client, ZMScore, &args, &array_data, process_z_scores_result);
 
             /* Clean up */
             efree(members);
@@ -286,7 +283,7 @@ int execute_zmscore_command(zval* object, int argc, zval* return_value, zend_cla
     } array_data = {return_value, 0}; /* ZMSCORE doesn't use withscores */
 
     int result = execute_z_generic_command(
-        glide_client, ZMScore, &args, &array_data, process_z_array_result);
+        glide_client, ZMScore, &args, &array_data, process_z_scores_result);
 
     if (!result) {
         zval_dtor(return_value);
@@ -1561,173 +1558,6 @@ int execute_zdiff_command(zval* object, int argc, zval* return_value, zend_class
     return 0;
 }
 
-/* Helper function to prepare arguments for MPOP commands */
-int prepare_mpop_arguments(const void*     glide_client,
-                           int             is_blocking,
-                           double          timeout,
-                           zval*           keys,
-                           const char*     from,
-                           size_t          from_len,
-                           long            count,
-                           unsigned long*  arg_count_ptr,
-                           uintptr_t**     args_ptr,
-                           unsigned long** args_len_ptr,
-                           char**          numkeys_str_ptr,
-                           char**          timeout_str_ptr,
-                           char**          count_str_ptr) {
-    /* Get the number of keys */
-    int keys_count = 0;
-    if (Z_TYPE_P(keys) == IS_ARRAY) {
-        keys_count = zend_hash_num_elements(Z_ARRVAL_P(keys));
-    } else {
-        return 0; /* Keys must be an array */
-    }
-
-    /* Check if we have at least one key */
-    if (keys_count <= 0) {
-        return 0;
-    }
-
-    /* Calculate the number of arguments */
-    unsigned long arg_count = keys_count + 2; /* numkeys + keys + direction */
-    if (is_blocking) {
-        arg_count++; /* Add timeout for blocking commands */
-    }
-
-    /* Allocate memory for arguments */
-    uintptr_t*     args     = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-    unsigned long* args_len = (unsigned long*) emalloc(arg_count * sizeof(unsigned long));
-
-    if (!args || !args_len) {
-        if (args)
-            efree(args);
-        if (args_len)
-            efree(args_len);
-        return 0;
-    }
-
-    /* Current argument index */
-    int arg_idx = 0;
-
-    /* Add timeout for blocking commands */
-    if (is_blocking) {
-        /* Convert timeout to string */
-        size_t timeout_len;
-        char*  timeout_str = alloc_list_double_string(timeout, &timeout_len);
-        if (!timeout_str) {
-            efree(args);
-            efree(args_len);
-            return 0;
-        }
-        args[arg_idx]     = (uintptr_t) timeout_str;
-        args_len[arg_idx] = timeout_len;
-        *timeout_str_ptr  = timeout_str;
-        arg_idx++;
-    }
-
-    /* Add numkeys first (this should be the first argument after timeout for blocking commands) */
-    size_t numkeys_len;
-    char*  numkeys_str = alloc_list_number_string(keys_count, &numkeys_len);
-    if (!numkeys_str) {
-        efree(args);
-        efree(args_len);
-        if (is_blocking) {
-            efree(*timeout_str_ptr);
-            *timeout_str_ptr = NULL;
-        }
-        return 0;
-    }
-    /* Debug output to see the value being passed */
-
-    args[arg_idx]     = (uintptr_t) numkeys_str;
-    args_len[arg_idx] = numkeys_len;
-    *numkeys_str_ptr  = numkeys_str;
-    arg_idx++;
-
-    /* Add keys */
-    HashTable* ht = Z_ARRVAL_P(keys);
-    zval*      z_key;
-    ZEND_HASH_FOREACH_VAL(ht, z_key) {
-        if (Z_TYPE_P(z_key) != IS_STRING) {
-            efree(args);
-            efree(args_len);
-            efree(numkeys_str);
-            *numkeys_str_ptr = NULL;
-            if (is_blocking) {
-                efree(*timeout_str_ptr);
-                *timeout_str_ptr = NULL;
-            }
-            return 0;
-        }
-        args[arg_idx]     = (uintptr_t) Z_STRVAL_P(z_key);
-        args_len[arg_idx] = Z_STRLEN_P(z_key);
-        arg_idx++;
-    }
-    ZEND_HASH_FOREACH_END();
-
-    /* Add direction (LEFT or RIGHT) directly */
-    args[arg_idx]     = (uintptr_t) from;
-    args_len[arg_idx] = from_len;
-    arg_idx++;
-
-    /* Add COUNT if count > 1 */
-    if (count > 1) {
-        /* Increase arg_count for COUNT and its value */
-        arg_count += 2;
-
-        /* Reallocate args and args_len arrays */
-        uintptr_t*     new_args = (uintptr_t*) erealloc(args, arg_count * sizeof(uintptr_t));
-        unsigned long* new_args_len =
-            (unsigned long*) erealloc(args_len, arg_count * sizeof(unsigned long));
-
-        if (!new_args || !new_args_len) {
-            efree(args);
-            efree(args_len);
-            efree(numkeys_str);
-            *numkeys_str_ptr = NULL;
-            if (is_blocking) {
-                efree(*timeout_str_ptr);
-                *timeout_str_ptr = NULL;
-            }
-            return 0;
-        }
-
-        args     = new_args;
-        args_len = new_args_len;
-
-        /* Add COUNT keyword */
-        args[arg_idx]     = (uintptr_t) "COUNT";
-        args_len[arg_idx] = 5;
-        arg_idx++;
-
-        /* Add count value */
-        size_t count_len;
-        char*  count_str = alloc_list_number_string(count, &count_len);
-        if (!count_str) {
-            efree(args);
-            efree(args_len);
-            efree(numkeys_str);
-            *numkeys_str_ptr = NULL;
-            if (is_blocking) {
-                efree(*timeout_str_ptr);
-                *timeout_str_ptr = NULL;
-            }
-            return 0;
-        }
-        args[arg_idx]     = (uintptr_t) count_str;
-        args_len[arg_idx] = count_len;
-        *count_str_ptr    = count_str;
-        arg_idx++;
-    }
-
-    /* Set output parameters */
-    *arg_count_ptr = arg_count;
-    *args_ptr      = args;
-    *args_len_ptr  = args_len;
-
-    return keys_count;
-}
-
 /* Execute a ZMPOP or BZMPOP command (for sorted set operations) using the Valkey Glide client */
 int execute_zmpop_command1(const void* glide_client,
                            const char* cmd,
@@ -1742,60 +1572,34 @@ int execute_zmpop_command1(const void* glide_client,
         return 0;
     }
 
+    if (Z_TYPE_P(keys) != IS_ARRAY || zend_hash_num_elements(Z_ARRVAL_P(keys)) == 0) {
+        return 0;
+    }
+
     /* Determine if this is a blocking command */
-    int is_blocking = (strncmp(cmd, "B", 1) == 0);
-
-    /* Prepare for argument construction */
-    unsigned long  arg_count   = 0;
-    uintptr_t*     args        = NULL;
-    unsigned long* args_len    = NULL;
-    char*          numkeys_str = NULL;
-    char*          timeout_str = NULL;
-    char*          count_str   = NULL;
-
-    /* Prepare the arguments */
-    int keys_count = prepare_mpop_arguments(glide_client,
-                                            is_blocking,
-                                            timeout,
-                                            keys,
-                                            from,
-                                            from_len,
-                                            count,
-                                            &arg_count,
-                                            &args,
-                                            &args_len,
-                                            &numkeys_str,
-                                            &timeout_str,
-                                            &count_str);
-
-    if (keys_count < 0) {
-        return 0;
-    }
-
-    /* Determine the command type */
-    enum RequestType cmd_type = is_blocking ? BZMPop : ZMPop;
+    int               is_blocking = (strncmp(cmd, "B", 1) == 0);
+    valkey_glide_args args;
+    zval*             z_key;
 
-    /* Execute the command */
-    CommandResult* cmd_result = command(glide_client,
-                                        0,         /* channel */
-                                        cmd_type,  /* command type */
-                                        arg_count, /* number of arguments */
-                                        args,      /* arguments */
-                                        args_len,  /* argument lengths */
-                                        NULL,      /* route bytes */
-                                        0,         /* route bytes length */
-                                        0          /* span_ptr */
-    );
-
-    /* Free the argument strings */
-    if (numkeys_str)
-        efree(numkeys_str);
-    if (timeout_str)
-        efree(timeout_str);
-    if (count_str)
-        efree(count_str);
-    efree(args);
-    efree(args_len);
+    /* [timeout] numkeys key [key ...] MIN|MAX [COUNT count] */
+    valkey_glide_args_init(&args);
+    if (is_blocking) {
+        valkey_glide_args_add_double(&args, timeout);
+    }
+    valkey_glide_args_add_long(&args, zend_hash_num_elements(Z_ARRVAL_P(keys)));
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(keys), z_key) {
+        valkey_glide_args_add_key_zval(&args, z_key);
+    }
+    ZEND_HASH_FOREACH_END();
+    valkey_glide_args_add(&args, from, from_len);
+    if (count > 1) {
+        valkey_glide_args_add_literal(&args, "COUNT");
+        valkey_glide_args_add_long(&args, count);
+    }
+
+    CommandResult* cmd_result =
+        valkey_glide_args_execute(glide_client, is_blocking ? BZMPop : ZMPop, &args, NULL);
+    valkey_glide_args_free(&args);
 
     /* Check if the command was successful */
     if (!cmd_result) {
@@ -1804,18 +1608,13 @@ int execute_zmpop_command1(const void* glide_client,
 
     /* Check if there was an error */
     if (cmd_result->command_error) {
-        printf("Error executing %s command: %s\n",
-               cmd,
-               cmd_result->command_error->command_error_message);
         free_command_result(cmd_result);
         return 0;
     }
 
-    /* Process the result */
-    /* For ZMPOP, use associative array format for the values */
-    int use_assoc = COMMAND_RESPONSE_ASSOSIATIVE_ARRAY_MAP; /* Always use associative arrays for
-                                                               sorted set responses */
-    int ret_val = command_response_to_zval(cmd_result->response, result, use_assoc, false);
+    /* [key, [member => score]], the members unserialized */
+    int ret_val = command_response_to_values_zval(
+        cmd_result->response, result, RESPONSE_SHAPE_POPPED, false);
 
     /* Free the result */
     free_command_result(cmd_result);
@@ -2031,59 +1830,21 @@ int execute_bzpopmax_command_internal(
         return 0;
     }
 
-    /* Calculate the number of arguments */
-    unsigned long arg_count = keys_count + 1; /* keys + timeout */
-
-    /* Allocate argument arrays */
-    uintptr_t*     args     = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-    unsigned long* args_len = (unsigned long*) emalloc(arg_count * sizeof(unsigned long));
-
-    if (!args || !args_len) {
-        if (args)
-            efree(args);
-        if (args_len)
-            efree(args_len);
-        return 0;
-    }
-
-    /* Add keys as arguments */
-    int i;
-    for (i = 0; i < keys_count; i++) {
-        zval* key = &keys[i];
-        if (Z_TYPE_P(key) != IS_STRING) {
-            efree(args);
-            efree(args_len);
+    /* keys + timeout */
+    valkey_glide_args args;
+    valkey_glide_args_init(&args);
+    for (int i = 0; i < keys_count; i++) {
+        if (Z_TYPE(keys[i]) != IS_STRING) {
+            valkey_glide_args_free(&args);
             return 0;
         }
-        args[i]     = (uintptr_t) Z_STRVAL_P(key);
-        args_len[i] = Z_STRLEN_P(key);
+        valkey_glide_args_add_key(&args, Z_STRVAL(keys[i]), Z_STRLEN(keys[i]));
     }
-
-    /* Add timeout as the last argument */
-    size_t timeout_len;
-    char*  timeout_str = double_to_string(timeout, &timeout_len);
-    if (!timeout_str) {
-        efree(args);
-        efree(args_len);
-        return 0;
-    }
-    args[keys_count]     = (uintptr_t) timeout_str;
-    args_len[keys_count] = timeout_len;
+    valkey_glide_args_add_double(&args, timeout);
 
     /* Execute the command */
-    CommandResult* result = execute_command(glide_client,
-                                            BZPopMax,  /* command type */
-                                            arg_count, /* number of arguments */
-                                            args,      /* arguments */
-                                            args_len   /* argument lengths */
-    );
-
-    /* Free the timeout string */
-    efree(timeout_str);
-
-    /* Free the argument arrays */
-    efree(args);
-    efree(args_len);
+    CommandResult* result = valkey_glide_args_execute(glide_client, BZPopMax, &args, NULL);
+    valkey_glide_args_free(&args);
 
     /* Process the result */
     int status = 0;
@@ -2101,30 +1862,9 @@ int execute_bzpopmax_command_internal(
                 ZVAL_FALSE(return_value);
                 status = 1;
             } else if (result->response->response_type == Array) {
-                /* For BZPOPMIN, need to manually ensure the score is a string */
-                if (result->response->array_value_len == 3 &&
-                    result->response->array_value[2].response_type != String) {
-                    /* Convert the response array to PHP array */
-                    status = command_response_to_zval(
-                        result->response, return_value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false);
-
-                    /* Get the score element (should be index 2) */
-                    zval*      score = NULL;
-                    zval*      arr   = return_value;
-                    HashTable* ht    = Z_ARRVAL_P(arr);
-
-                    /* Convert numeric score to string */
-                    if (ht && zend_hash_index_exists(ht, 2)) {
-                        score = zend_hash_index_find(ht, 2);
-                        if (score && (Z_TYPE_P(score) == IS_LONG || Z_TYPE_P(score) == IS_DOUBLE)) {
-                            convert_to_string(score);
-                        }
-                    }
-                } else {
-                    /* Regular array conversion */
-                    status = command_response_to_zval(
-                        result->response, return_value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false);
-                }
+                /* [key, member, score], the member unserialized and the score a string */
+                status = command_response_to_values_zval(
+                    result->response, return_value, RESPONSE_SHAPE_POPPED, false);
             }
         }
         free_command_result(result);
@@ -2266,59 +2006,21 @@ int execute_bzpopmin_command_internal(
         return 0;
     }
 
-    /* Calculate the number of arguments */
-    unsigned long arg_count = keys_count + 1; /* keys + timeout */
-
-    /* Allocate argument arrays */
-    uintptr_t*     args     = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
-    unsigned long* args_len = (unsigned long*) emalloc(arg_count * sizeof(unsigned long));
-
-    if (!args || !args_len) {
-        if (args)
-            efree(args);
-        if (args_len)
-            efree(args_len);
-        return 0;
-    }
-
-    /* Add keys as arguments */
-    int i;
-    for (i = 0; i < keys_count; i++) {
-        zval* key = &keys[i];
-        if (Z_TYPE_P(key) != IS_STRING) {
-            efree(args);
-            efree(args_len);
+    /* keys + timeout */
+    valkey_glide_args args;
+    valkey_glide_args_init(&args);
+    for (int i = 0; i < keys_count; i++) {
+        if (Z_TYPE(keys[i]) != IS_STRING) {
+            valkey_glide_args_free(&args);
             return 0;
         }
-        args[i]     = (uintptr_t) Z_STRVAL_P(key);
-        args_len[i] = Z_STRLEN_P(key);
-    }
-
-    /* Add timeout as the last argument */
-    size_t timeout_len;
-    char*  timeout_str = double_to_string(timeout, &timeout_len);
-    if (!timeout_str) {
-        efree(args);
-        efree(args_len);
-        return 0;
+        valkey_glide_args_add_key(&args, Z_STRVAL(keys[i]), Z_STRLEN(keys[i]));
     }
-    args[keys_count]     = (uintptr_t) timeout_str;
-    args_len[keys_count] = timeout_len;
+    valkey_glide_args_add_double(&args, timeout);
 
     /* Execute the command */
-    CommandResult* result = execute_command(glide_client,
-                                            BZPopMin,  /* command type */
-                                            arg_count, /* number of arguments */
-                                            args,      /* arguments */
-                                            args_len   /* argument lengths */
-    );
-
-    /* Free the timeout string */
-    efree(timeout_str);
-
-    /* Free the argument arrays */
-    efree(args);
-    efree(args_len);
+    CommandResult* result = valkey_glide_args_execute(glide_client, BZPopMin, &args, NULL);
+    valkey_glide_args_free(&args);
 
     /* Process the result */
     int status = 0;
@@ -2336,30 +2038,9 @@ int execute_bzpopmin_command_internal(
                 ZVAL_FALSE(return_value);
                 status = 1;
             } else if (result->response->response_type == Array) {
-                /* For BZPOPMIN, need to manually ensure the score is a string */
-                if (result->response->array_value_len == 3 &&
-                    result->response->array_value[2].response_type != String) {
-                    /* Convert the response array to PHP array */
-                    status = command_response_to_zval(
-                        result->response, return_value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false);
-
-                    /* Get the score element (should be index 2) */
-                    zval*      score = NULL;
-                    zval*      arr   = return_value;
-                    HashTable* ht    = Z_ARRVAL_P(arr);
-
-                    /* Convert numeric score to string */
-                    if (ht && zend_hash_index_exists(ht, 2)) {
-                        score = zend_hash_index_find(ht, 2);
-                        if (score && (Z_TYPE_P(score) == IS_LONG || Z_TYPE_P(score) == IS_DOUBLE)) {
-                            convert_to_string(score);
-                        }
-                    }
-                } else {
-                    /* Regular array conversion */
-                    status = command_response_to_zval(
-                        result->response, return_value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false);
-                }
+                /* [key, member, score], the member unserialized and the score a string */
+                status = command_response_to_values_zval(
+                    result->response, return_value, RESPONSE_SHAPE_POPPED, false);
             }
         }
         free_command_result(result);
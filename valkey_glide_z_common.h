@@ -19,6 +19,7 @@
 
 #include "common.h"
 #include "include/glide_bindings.h"
+#include "valkey_glide_args.h"
 
 /* ====================================================================
  * STRUCTURE DEFINITIONS
@@ -147,6 +148,11 @@ int process_z_array_result(CommandResult* result, void* output);
 
 int process_z_array_zrand_result(CommandResult* result, void* output);
 
+/**
+ * Process a list of scores (ZMSCORE)
+ */
+int process_z_scores_result(CommandResult* result, void* output);
+
 int process_z_long_to_zval_result(CommandResult* result, void* output);
 
 /**
@@ -166,112 +172,69 @@ int process_z_rank_result(CommandResult* result, void* output);
 /**
  * Prepare basic Z-command arguments (just key)
  */
-int prepare_z_key_args(z_command_args_t* args, uintptr_t** args_out, unsigned long** args_len_out);
+int prepare_z_key_args(z_command_args_t* args, valkey_glide_args* cmd_args);
 
 /**
  * Prepare member-based Z-command arguments (key + member)
  */
-int prepare_z_member_args(z_command_args_t* args,
-                          uintptr_t**       args_out,
-                          unsigned long**   args_len_out);
+int prepare_z_member_args(z_command_args_t* args, valkey_glide_args* cmd_args);
 
 /**
  * Prepare range-based Z-command arguments (key + min + max)
  */
-int prepare_z_range_args(z_command_args_t* args,
-                         uintptr_t**       args_out,
-                         unsigned long**   args_len_out);
+int prepare_z_range_args(z_command_args_t* args, valkey_glide_args* cmd_args);
 
 /**
  * Prepare multi-member Z-command arguments (key + multiple members)
  */
-int prepare_z_members_args(z_command_args_t* args,
-                           uintptr_t**       args_out,
-                           unsigned long**   args_len_out,
-                           char***           allocated_strings,
-                           int*              allocated_count);
+int prepare_z_members_args(z_command_args_t* args, valkey_glide_args* cmd_args);
 
 /**
  * Prepare complex range Z-command arguments with options
  */
-int prepare_z_complex_range_args(z_command_args_t* args,
-                                 uintptr_t**       args_out,
-                                 enum RequestType  cmd_type,
-                                 unsigned long**   args_len_out,
-                                 char***           allocated_strings,
-                                 int*              allocated_count);
+int prepare_z_complex_range_args(z_command_args_t*  args,
+                                 enum RequestType   cmd_type,
+                                 valkey_glide_args* cmd_args);
 
 /**
  * Prepare store command arguments (destination + numkeys + keys + weights + aggregate)
  */
-int prepare_z_store_args(z_command_args_t* args,
-                         uintptr_t**       args_out,
-                         unsigned long**   args_len_out,
-                         char***           allocated_strings,
-                         int*              allocated_count);
+int prepare_z_store_args(z_command_args_t* args, valkey_glide_args* cmd_args);
 
 /**
  * Prepare ZINTERCARD command arguments (numkeys + keys + optional LIMIT)
  */
-int prepare_z_intercard_args(z_command_args_t* args,
-                             uintptr_t**       args_out,
-                             unsigned long**   args_len_out,
-                             char***           allocated_strings,
-                             int*              allocated_count);
+int prepare_z_intercard_args(z_command_args_t* args, valkey_glide_args* cmd_args);
 
 /**
  * Prepare ZUNION command arguments (numkeys + keys + WEIGHTS + AGGREGATE + WITHSCORES)
  */
-int prepare_z_union_args(z_command_args_t* args,
-                         uintptr_t**       args_out,
-                         unsigned long**   args_len_out,
-                         char***           allocated_strings,
-                         int*              allocated_count);
+int prepare_z_union_args(z_command_args_t* args, valkey_glide_args* cmd_args);
 
 /**
  * Prepare ZPOP command arguments (key + optional count)
  */
-int prepare_z_pop_args(z_command_args_t* args,
-                       uintptr_t**       args_out,
-                       unsigned long**   args_len_out,
-                       char***           allocated_strings,
-                       int*              allocated_count);
+int prepare_z_pop_args(z_command_args_t* args, valkey_glide_args* cmd_args);
 
 /**
  * Prepare ZRANGESTORE command arguments (dst + src + start + end + range options)
  */
-int prepare_z_rangestore_args(z_command_args_t* args,
-                              uintptr_t**       args_out,
-                              unsigned long**   args_len_out,
-                              char***           allocated_strings,
-                              int*              allocated_count);
+int prepare_z_rangestore_args(z_command_args_t* args, valkey_glide_args* cmd_args);
 
 /**
  * Prepare ZADD command arguments (key + options + score-member pairs)
  */
-int prepare_z_zadd_args(z_command_args_t* args,
-                        uintptr_t**       args_out,
-                        unsigned long**   args_len_out,
-                        char***           allocated_strings,
-                        int*              allocated_count);
+int prepare_z_zadd_args(z_command_args_t* args, valkey_glide_args* cmd_args);
 
 /**
  * Prepare ZDIFF command arguments (numkeys + keys + optional WITHSCORES)
  */
-int prepare_z_zdiff_args(z_command_args_t* args,
-                         uintptr_t**       args_out,
-                         unsigned long**   args_len_out,
-                         char***           allocated_strings,
-                         int*              allocated_count);
+int prepare_z_zdiff_args(z_command_args_t* args, valkey_glide_args* cmd_args);
 
 /**
  * Prepare ZRANDMEMBER command arguments (key + optional count + optional WITHSCORES)
  */
-int prepare_z_randmember_args(z_command_args_t* args,
-                              uintptr_t**       args_out,
-                              unsigned long**   args_len_out,
-                              char***           allocated_strings,
-                              int*              allocated_count);
+int prepare_z_randmember_args(z_command_args_t* args, valkey_glide_args* cmd_args);
 
 /* ====================================================================
  * OPTIONS PARSING HELPERS
@@ -300,39 +263,10 @@ int parse_store_options(zval* weights, zval* options, store_options_t* opts);
  * ==================================================================== */
 
 /**
- * Create LIMIT arguments (offset, count)
- * Returns number of arguments added (0 or 3)
+ * Add LIMIT arguments (offset, count) when the options have them
  */
-int create_limit_args(range_options_t* opts,
-                      uintptr_t*       args,
-                      unsigned long*   args_len,
-                      int              start_idx,
-                      char**           allocated_strings,
-                      int*             allocated_count);
+void add_limit_args(range_options_t* opts, valkey_glide_args* cmd_args);
 
-/* ====================================================================
- * RESPONSE PROCESSING HELPERS
- * ==================================================================== */
-
-/**
- * Flatten withscores array from [[member, score]] to [member => score]
- * Returns 1 on success, 0 on failure
- */
-int flatten_withscores_array(zval* return_value);
-
-int prepare_mpop_arguments(const void*     glide_client,
-                           int             is_blocking,
-                           double          timeout,
-                           zval*           keys,
-                           const char*     from,
-                           size_t          from_len,
-                           long            count,
-                           unsigned long*  arg_count_ptr,
-                           uintptr_t**     args_ptr,
-                           unsigned long** args_len_ptr,
-                           char**          numkeys_str_ptr,
-                           char**          timeout_str_ptr,
-                           char**          count_str_ptr);
 /* ====================================================================
  * Z COMMAND IMPLEMENTATION FUNCTIONS (THIN WRAPPERS)
  * ==================================================================== */
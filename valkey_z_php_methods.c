@@ -13,11 +13,16 @@
 #include <ext/standard/info.h>
 
 #include "command_response.h" /* Include command_response.h for string conversion functions */
+#include "valkey_glide_cache.h"
 #include "valkey_glide_commands_common.h"
+#include "valkey_glide_errors.h"
 #include "valkey_glide_geo_common.h"
 #include "valkey_glide_hash_common.h" /* Include hash command framework */
 #include "valkey_glide_list_common.h"
+#include "valkey_glide_options.h"
+#include "valkey_glide_pubsub.h"
 #include "valkey_glide_s_common.h"
+#include "valkey_glide_script.h"
 #include "valkey_glide_x_common.h"
 #include "valkey_glide_z_common.h"
 
@@ -619,10 +624,14 @@ MULTI_METHOD_IMPL(ValkeyGlide)
 DISCARD_METHOD_IMPL(ValkeyGlide)
 /* }}} */
 
-/* {{{ proto array ValkeyGlide::exec() */
+/* {{{ proto array ValkeyGlide::exec([array options]) */
 EXEC_METHOD_IMPL(ValkeyGlide)
 /* }}} */
 
+/* {{{ proto ValkeyGlide ValkeyGlide::pipeline([array options]) */
+PIPELINE_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
 /* {{{ proto mixed ValkeyGlide::fcall(string name, int numkeys, mixed ...args) */
 FCALL_METHOD_IMPL(ValkeyGlide)
 /* }}} */
@@ -787,3 +796,83 @@ PFCOUNT_METHOD_IMPL(ValkeyGlide)
 /* {{{ proto bool ValkeyGlide::pfmerge(string dst, array keys) */
 PFMERGE_METHOD_IMPL(ValkeyGlide)
 /* }}} */
+
+/* {{{ proto bool ValkeyGlide::subscribe(array channels) */
+SUBSCRIBE_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto bool ValkeyGlide::psubscribe(array patterns) */
+PSUBSCRIBE_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto bool ValkeyGlide::ssubscribe(array channels) */
+SSUBSCRIBE_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto bool ValkeyGlide::unsubscribe([array channels]) */
+UNSUBSCRIBE_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto bool ValkeyGlide::punsubscribe([array patterns]) */
+PUNSUBSCRIBE_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto bool ValkeyGlide::sunsubscribe([array channels]) */
+SUNSUBSCRIBE_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto long ValkeyGlide::publish(string channel, string message) */
+PUBLISH_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto long ValkeyGlide::spublish(string channel, string message) */
+SPUBLISH_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto mixed ValkeyGlide::pubsub(string command [, mixed arg]) */
+PUBSUB_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto array ValkeyGlide::getMessages([long max, double timeout]) */
+GETMESSAGES_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto mixed ValkeyGlide::eval(string script, [array args, long num_keys]) */
+EVAL_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto mixed ValkeyGlide::eval_ro(string script, [array args, long num_keys]) */
+EVAL_RO_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto mixed ValkeyGlide::evalsha(string sha1, [array args, long num_keys]) */
+EVALSHA_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto mixed ValkeyGlide::evalsha_ro(string sha1, [array args, long num_keys]) */
+EVALSHA_RO_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto mixed ValkeyGlide::script(string command, ...) */
+SCRIPT_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto array ValkeyGlide::getCacheStats() */
+GETCACHESTATS_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto bool ValkeyGlide::setOption(long option, mixed value) */
+SETOPTION_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto mixed ValkeyGlide::getOption(long option) */
+GETOPTION_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto string|null ValkeyGlide::getLastError() */
+GETLASTERROR_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto bool ValkeyGlide::clearLastError() */
+CLEARLASTERROR_METHOD_IMPL(ValkeyGlide)
+/* }}} */